@@ -221,6 +221,129 @@ typename std::iterator_traits<RAI>::difference_type CountIf(
 
 #endif // else DOXYGEN
 
+/**
+ * Counts in parallel the number of elements in a range for which the given
+ * predicate holds, using worker-local counters.
+ *
+ * Behaves like CountIf() but accumulates into one counter per worker thread
+ * (see ReduceLocal()) instead of combining a result per block.
+ *
+ * \return The number of elements for which \c comparison returns true
+ * \throws embb::base::ErrorException if not enough MTAPI tasks can be created
+ *         to satisfy the requirements of the algorithm.
+ * \threadsafe if the elements in the range are not modified by another thread
+ *             while the algorithm is executed.
+ * \see CountIf(), ReduceLocal(), embb::mtapi::ExecutionPolicy
+ * \tparam RAI Random access iterator
+ * \tparam ComparisonFunction Unary predicate with argument of type
+ *         <tt>std::iterator_traits<RAI>::value_type</tt>.
+ */
+template<typename RAI, typename ComparisonFunction>
+typename std::iterator_traits<RAI>::difference_type CountIfLocal(
+  RAI first,
+  /**< [IN] Random access iterator pointing to the first element of the range */
+  RAI last,
+  /**< [IN] Random access iterator pointing to the last plus one element of the
+            range */
+  ComparisonFunction comparison,
+  /**< [IN] Unary predicate used to test the elements in the range. Elements for
+            which \c comparison returns true are counted. */
+  const embb::mtapi::ExecutionPolicy& policy,
+  /**< [IN] embb::mtapi::ExecutionPolicy for the counting algorithm */
+  size_t block_size
+  /**< [IN] Lower bound for partitioning the range of elements into blocks that
+            are treated in parallel. The default value 0 means that the
+            minimum block size is determined automatically depending on the
+            number of elements in the range divided by the number of available
+            cores. */
+  );
+
+/**
+ * Overload of CountIfLocal() using the default execution policy and block
+ * size.
+ */
+template<typename RAI, typename ComparisonFunction>
+typename std::iterator_traits<RAI>::difference_type CountIfLocal(
+  RAI first,
+  RAI last,
+  ComparisonFunction comparison
+  ) {
+  return CountIfLocal(first, last, comparison,
+    embb::mtapi::ExecutionPolicy(), 0);
+}
+
+/**
+ * Overload of CountIfLocal() using the default block size.
+ */
+template<typename RAI, typename ComparisonFunction>
+typename std::iterator_traits<RAI>::difference_type CountIfLocal(
+  RAI first,
+  RAI last,
+  ComparisonFunction comparison,
+  const embb::mtapi::ExecutionPolicy& policy
+  ) {
+  return CountIfLocal(first, last, comparison, policy, 0);
+}
+
+/**
+ * Counts in parallel the number of elements in a range that are equal to
+ * the specified value, using worker-local counters.
+ *
+ * \return The number of elements that are equal to \c value
+ * \throws embb::base::ErrorException if not enough MTAPI tasks can be created
+ *         to satisfy the requirements of the algorithm.
+ * \threadsafe if the elements in the range are not modified by another thread
+ *             while the algorithm is executed.
+ * \see Count(), CountIfLocal(), embb::mtapi::ExecutionPolicy
+ * \tparam RAI Random access iterator
+ * \tparam ValueType Type of \c value that is compared to the elements in the
+ *         range using the \c operator==.
+ */
+template<typename RAI, typename ValueType>
+typename std::iterator_traits<RAI>::difference_type CountLocal(
+  RAI first,
+  /**< [IN] Random access iterator pointing to the first element of the range */
+  RAI last,
+  /**< [IN] Random access iterator pointing to the last plus one element of the
+            range */
+  const ValueType& value,
+  /**< [IN] Value that the elements in the range are compared to using
+            \c operator== */
+  const embb::mtapi::ExecutionPolicy& policy,
+  /**< [IN] embb::mtapi::ExecutionPolicy for the counting algorithm */
+  size_t block_size
+  /**< [IN] Lower bound for partitioning the range of elements into blocks that
+            are treated in parallel. The default value 0 means that the
+            minimum block size is determined automatically depending on the
+            number of elements in the range divided by the number of available
+            cores. */
+  );
+
+/**
+ * Overload of CountLocal() using the default execution policy and block size.
+ */
+template<typename RAI, typename ValueType>
+typename std::iterator_traits<RAI>::difference_type CountLocal(
+  RAI first,
+  RAI last,
+  const ValueType& value
+  ) {
+  return CountLocal(first, last, value, embb::mtapi::ExecutionPolicy(), 0);
+}
+
+/**
+ * Overload of CountLocal() using the default block size.
+ */
+template<typename RAI, typename ValueType>
+typename std::iterator_traits<RAI>::difference_type CountLocal(
+  RAI first,
+  RAI last,
+  const ValueType& value,
+  const embb::mtapi::ExecutionPolicy& policy
+  ) {
+  return CountLocal(first, last, value, policy, 0);
+}
+
 /**
  * \}
  */
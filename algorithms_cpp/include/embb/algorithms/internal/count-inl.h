@@ -79,6 +79,24 @@ class FunctionComparisonFunction{
     const FunctionComparisonFunction& other);
 };
 
+template<typename Difference, typename Comparison>
+class CountAccumulationFunction {
+ public:
+  explicit CountAccumulationFunction(Comparison comparison)
+  : comparison_(comparison) {}
+  CountAccumulationFunction(const CountAccumulationFunction& other)
+  : comparison_(other.comparison_) {}
+
+  template<typename ElementType>
+  void operator()(Difference& count, ElementType element) {
+    count += comparison_(element);
+  }
+ private:
+  Comparison comparison_;
+  CountAccumulationFunction &operator=(
+    const CountAccumulationFunction& other);
+};
+
 }  // namespace internal
 
 template<typename RAI, typename ValueType>
@@ -114,6 +132,30 @@ typename std::iterator_traits<RAI>::difference_type
                 (comparison), policy, block_size);
 }
 
+template<typename RAI, typename ValueType>
+typename std::iterator_traits<RAI>::difference_type
+  CountLocal(RAI first, RAI last, const ValueType& value,
+             const embb::mtapi::ExecutionPolicy& policy, size_t block_size) {
+  typedef typename std::iterator_traits<RAI>::difference_type Difference;
+  typedef internal::ValueComparisonFunction<ValueType> Comparison;
+  return ReduceLocal(first, last, Difference(0),
+                     internal::CountAccumulationFunction<Difference,
+                       Comparison>(Comparison(value)),
+                     std::plus<Difference>(), policy, block_size);
+}
+
+template<typename RAI, typename ComparisonFunction>
+typename std::iterator_traits<RAI>::difference_type
+  CountIfLocal(RAI first, RAI last, ComparisonFunction comparison,
+               const embb::mtapi::ExecutionPolicy& policy, size_t block_size) {
+  typedef typename std::iterator_traits<RAI>::difference_type Difference;
+  typedef internal::FunctionComparisonFunction<ComparisonFunction> Comparison;
+  return ReduceLocal(first, last, Difference(0),
+                     internal::CountAccumulationFunction<Difference,
+                       Comparison>(Comparison(comparison)),
+                     std::plus<Difference>(), policy, block_size);
+}
+
 }  // namespace algorithms
 }  // namespace embb
 
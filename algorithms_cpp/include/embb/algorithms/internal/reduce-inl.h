@@ -179,8 +179,135 @@ ReturnType ReduceIteratorCheck(RAI first, RAI last, ReductionFunction reduction,
                            policy, block_size);
 }
 
+template<typename RAI, typename ReturnType, typename AccumulationFunction>
+class ReduceLocalFunctor {
+ public:
+  ReduceLocalFunctor(size_t chunk_first, size_t chunk_last,
+                     AccumulationFunction accumulation,
+                     const embb::mtapi::ExecutionPolicy& policy,
+                     const BlockSizePartitioner<RAI>& partitioner,
+                     embb::mtapi::WorkerLocal<ReturnType>& locals)
+  : chunk_first_(chunk_first), chunk_last_(chunk_last),
+    accumulation_(accumulation), policy_(policy),
+    partitioner_(partitioner), locals_(locals) {
+  }
+
+  void Action(embb::mtapi::TaskContext&) {
+    if (chunk_first_ == chunk_last_) {
+      // Leaf case, recursed to single chunk. Accumulate into the value of
+      // the worker executing this task:
+      ChunkDescriptor<RAI> chunk = partitioner_[chunk_first_];
+      RAI first = chunk.GetFirst();
+      RAI last  = chunk.GetLast();
+      ReturnType& local = locals_.Local();
+      for (RAI it = first; it != last; ++it) {
+        accumulation_(local, *it);
+      }
+    } else {
+      // Recurse further:
+      size_t chunk_split_index = (chunk_first_ + chunk_last_) / 2;
+      // Split chunks into left / right branches:
+      self_t functor_l(chunk_first_,
+                       chunk_split_index,
+                       accumulation_, policy_,
+                       partitioner_,
+                       locals_);
+      self_t functor_r(chunk_split_index + 1,
+                       chunk_last_,
+                       accumulation_, policy_,
+                       partitioner_,
+                       locals_);
+      embb::mtapi::Task task_l = embb::mtapi::Node::GetInstance().Start(
+        base::MakeFunction(functor_l, &self_t::Action),
+        policy_);
+      embb::mtapi::Task task_r = embb::mtapi::Node::GetInstance().Start(
+        base::MakeFunction(functor_r, &self_t::Action),
+        policy_);
+      task_l.Wait(MTAPI_INFINITE);
+      task_r.Wait(MTAPI_INFINITE);
+    }
+  }
+
+ private:
+  typedef ReduceLocalFunctor<RAI, ReturnType, AccumulationFunction> self_t;
+
+ private:
+  size_t chunk_first_;
+  size_t chunk_last_;
+  AccumulationFunction accumulation_;
+  const embb::mtapi::ExecutionPolicy& policy_;
+  const BlockSizePartitioner<RAI>& partitioner_;
+  embb::mtapi::WorkerLocal<ReturnType>& locals_;
+
+  /**
+   * Disables assignment and copy-construction.
+   */
+  ReduceLocalFunctor& operator=(const ReduceLocalFunctor&);
+  ReduceLocalFunctor(const ReduceLocalFunctor&);
+};
+
+template<typename RAI, typename ReturnType, typename AccumulationFunction,
+         typename CombinationFunction>
+ReturnType ReduceLocalRecursive(RAI first, RAI last, ReturnType neutral,
+                                AccumulationFunction accumulation,
+                                CombinationFunction combination,
+                                const embb::mtapi::ExecutionPolicy& policy,
+                                size_t block_size) {
+  typedef typename std::iterator_traits<RAI>::difference_type difference_type;
+  difference_type distance = std::distance(first, last);
+  if (distance == 0) {
+    return neutral;
+  } else if (distance < 0) {
+    EMBB_THROW(embb::base::ErrorException, "Negative range for ReduceLocal");
+  }
+  unsigned int num_cores = policy.GetCoreCount();
+  if (num_cores == 0) {
+    EMBB_THROW(embb::base::ErrorException, "No cores in execution policy");
+  }
+  embb::mtapi::Node& node = embb::mtapi::Node::GetInstance();
+  // Determine actually used block size
+  if (block_size == 0) {
+    block_size = (static_cast<size_t>(distance) / num_cores);
+    if (block_size == 0) {
+      block_size = 1;
+    }
+  }
+  // Perform check of task number sufficiency
+  if (((distance / block_size) * 2) + 1 > MTAPI_NODE_MAX_TASKS_DEFAULT) {
+    EMBB_THROW(embb::base::ErrorException,
+               "Number of computation tasks required in reduction would "
+               "exceed MTAPI maximum number of tasks");
+  }
+  typedef ReduceLocalFunctor<RAI, ReturnType, AccumulationFunction> Functor;
+  BlockSizePartitioner<RAI> partitioner(first, last, block_size);
+  embb::mtapi::WorkerLocal<ReturnType> locals(neutral);
+  Functor functor(0,
+                  partitioner.Size() - 1,
+                  accumulation,
+                  policy,
+                  partitioner,
+                  locals);
+  embb::mtapi::Task task = node.Start(
+    base::MakeFunction(functor, &Functor::Action),
+    policy);
+  task.Wait(MTAPI_INFINITE);
+  return locals.Combine(combination);
+}
+
 }  // namespace internal
 
+template<typename RAI, typename ReturnType, typename AccumulationFunction,
+         typename CombinationFunction>
+ReturnType ReduceLocal(
+  RAI first, RAI last, ReturnType neutral,
+  AccumulationFunction accumulation,
+  CombinationFunction combination,
+  const embb::mtapi::ExecutionPolicy& policy,
+  size_t block_size) {
+  return internal::ReduceLocalRecursive(first, last, neutral, accumulation,
+                                        combination, policy, block_size);
+}
+
 template<typename RAI, typename ReturnType>
 ReturnType Reduce(RAI first, RAI last, ReturnType neutral,
   embb::mtapi::Job reduction,
@@ -216,6 +216,96 @@ ReturnType Reduce(
 
 #endif // else DOXYGEN
 
+/**
+ * Performs a parallel reduction on a range of elements by accumulating into
+ * worker-local values.
+ *
+ * Each worker thread owns a copy of \c neutral (see
+ * embb::mtapi::WorkerLocal) that is updated in place by \c accumulation for
+ * the elements it processes. Afterwards, the worker-local values are combined
+ * pairwise using \c combination. In contrast to Reduce(), no intermediate
+ * result is created per block, which suits large accumulators such as
+ * histograms.
+ *
+ * \return
+ * <tt>combination(local_0, ..., local_n)</tt> for the worker-local values
+ * that were used, or \c neutral if the range is empty.
+ * \throws embb::base::ErrorException if not enough MTAPI tasks can be created
+ *         to satisfy the requirements of the algorithm.
+ * \threadsafe if the elements in the range are not modified by another thread
+ *             while the algorithm is executed.
+ * \note No guarantee is given on the order in which the elements are
+ *       accumulated or the worker-local values are combined. The
+ *       combination operation must be associative and commutative.
+ * \see embb::mtapi::ExecutionPolicy, embb::mtapi::WorkerLocal, Reduce()
+ * \tparam RAI Random access iterator
+ * \tparam ReturnType Type of result of reduction operation, deduced from
+ *         \c neutral
+ * \tparam AccumulationFunction Function object with signature
+ *         <tt>void AccumulationFunction(ReturnType &, typename
+ *         std::iterator_traits<RAI>::value_type)</tt>
+ * \tparam CombinationFunction Binary function object with signature
+ *         <tt>ReturnType CombinationFunction(const ReturnType &,
+ *         const ReturnType &)</tt>
+ */
+template<typename RAI, typename ReturnType, typename AccumulationFunction,
+         typename CombinationFunction>
+ReturnType ReduceLocal(
+  RAI first,
+  /**< [IN] Random access iterator pointing to the first element of the range */
+  RAI last,
+  /**< [IN] Random access iterator pointing to the last plus one element of the
+            range */
+  ReturnType neutral,
+  /**< [IN] Initial value of each worker-local accumulator */
+  AccumulationFunction accumulation,
+  /**< [IN] Accumulates an element of the range into a worker-local value */
+  CombinationFunction combination,
+  /**< [IN] Combines two worker-local values */
+  const embb::mtapi::ExecutionPolicy& policy,
+  /**< [IN] embb::mtapi::ExecutionPolicy for the reduction computation */
+  size_t block_size
+  /**< [IN] Lower bound for partitioning the range of elements into blocks that
+            are treated in parallel. Partitioning of a block stops if its size
+            is less than or equal to \c block_size. The default value 0 means
+            that the minimum block size is determined automatically depending on
+            the number of elements in the range divided by the number of
+            available cores. */
+  );
+
+/**
+ * Overload of ReduceLocal() using the default execution policy and block size.
+ */
+template<typename RAI, typename ReturnType, typename AccumulationFunction,
+         typename CombinationFunction>
+ReturnType ReduceLocal(
+  RAI first,
+  RAI last,
+  ReturnType neutral,
+  AccumulationFunction accumulation,
+  CombinationFunction combination
+  ) {
+  return ReduceLocal(first, last, neutral, accumulation, combination,
+    embb::mtapi::ExecutionPolicy(), 0);
+}
+
+/**
+ * Overload of ReduceLocal() using the default block size.
+ */
+template<typename RAI, typename ReturnType, typename AccumulationFunction,
+         typename CombinationFunction>
+ReturnType ReduceLocal(
+  RAI first,
+  RAI last,
+  ReturnType neutral,
+  AccumulationFunction accumulation,
+  CombinationFunction combination,
+  const embb::mtapi::ExecutionPolicy& policy
+  ) {
+  return ReduceLocal(first, last, neutral, accumulation, combination,
+    policy, 0);
+}
+
 /**
  * \}
  */
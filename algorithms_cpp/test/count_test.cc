@@ -77,6 +77,7 @@ CountTest::CountTest() {
   CreateUnit("Ranges").Add(&CountTest::TestRanges, this);
   CreateUnit("Block sizes").Add(&CountTest::TestBlockSizes, this);
   CreateUnit("Policies").Add(&CountTest::TestPolicy, this);
+  CreateUnit("Local").Add(&CountTest::TestLocal, this);
   CreateUnit("Stress test").Add(&CountTest::StressTest, this);
 }
 
@@ -164,6 +165,23 @@ void CountTest::TestPolicy() {
                ExecutionPolicy(true, 1)), 3);
 }
 
+void CountTest::TestLocal() {
+  using embb::algorithms::CountLocal;
+  using embb::algorithms::CountIfLocal;
+  const int size = 10;
+  int array[] = { 10, 21, 30, 31, 20, 11, 10, 21, 20, 20 };
+  std::vector<int> vector(array, array + size);
+
+  PT_EXPECT_EQ(CountLocal(array, array + size, 20), 3);
+  PT_EXPECT_EQ(CountLocal(vector.begin(), vector.end(), 21), 2);
+  PT_EXPECT_EQ(CountLocal(vector.begin(), vector.begin(), 21), 0);
+  PT_EXPECT_EQ(CountIfLocal(array, array + size, IsEven()), 6);
+  PT_EXPECT_EQ(CountIfLocal(vector.begin(), vector.end(), &IsEvenFunction),
+    6);
+  PT_EXPECT_EQ(CountIfLocal(array, array + size, IsEven(),
+    embb::mtapi::ExecutionPolicy(), 1), 6);
+}
+
 void CountTest::StressTest() {
   using embb::algorithms::Count;
   size_t count = embb::mtapi::Node::GetInstance().GetCoreCount() * 10;
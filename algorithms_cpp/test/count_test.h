@@ -65,6 +65,11 @@ class CountTest : public partest::TestCase {
    */
   void TestPolicy();
 
+  /**
+   * Tests counting with worker-local counters.
+   */
+  void TestLocal();
+
   /**
    * Stress tests by giving work for all workers.
    */
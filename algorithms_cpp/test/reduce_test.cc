@@ -96,6 +96,29 @@ static void AddActionFunction(
 }
 
 
+/**
+ * Adds an element to a histogram of its value modulo the bucket count.
+ */
+struct HistogramAccumulation {
+  void operator()(std::vector<int>& histogram, int value) const {
+    histogram[static_cast<size_t>(value) % histogram.size()]++;
+  }
+};
+
+/**
+ * Adds two histograms bucket by bucket.
+ */
+struct HistogramCombination {
+  std::vector<int> operator()(const std::vector<int>& lhs,
+                              const std::vector<int>& rhs) const {
+    std::vector<int> result(lhs);
+    for (size_t i = 0; i < result.size(); i++) {
+      result[i] += rhs[i];
+    }
+    return result;
+  }
+};
+
 ReduceTest::ReduceTest() {
   CreateUnit("Different data structures")
       .Add(&ReduceTest::TestDataStructures, this);
@@ -105,6 +128,7 @@ ReduceTest::ReduceTest() {
   CreateUnit("Ranges").Add(&ReduceTest::TestRanges, this);
   CreateUnit("Block sizes").Add(&ReduceTest::TestBlockSizes, this);
   CreateUnit("Policies").Add(&ReduceTest::TestPolicy, this);
+  CreateUnit("Local").Add(&ReduceTest::TestLocal, this);
   CreateUnit("Stress test").Add(&ReduceTest::StressTest, this);
 }
 
@@ -287,6 +311,36 @@ void ReduceTest::TestPolicy() {
 #endif
 }
 
+void ReduceTest::TestLocal() {
+  using embb::algorithms::ReduceLocal;
+  const size_t bucket_count = 16;
+  const size_t count = 1000;
+  std::vector<int> vector(count);
+  std::vector<int> expected(bucket_count, 0);
+  for (size_t i = 0; i < count; i++) {
+    vector[i] = static_cast<int>(i * 7);
+    expected[(i * 7) % bucket_count]++;
+  }
+
+  std::vector<int> histogram = ReduceLocal(vector.begin(), vector.end(),
+    std::vector<int>(bucket_count, 0), HistogramAccumulation(),
+    HistogramCombination());
+  PT_EXPECT(histogram == expected);
+
+  for (size_t block_size = 10; block_size < count; block_size *= 10) {
+    histogram = ReduceLocal(vector.begin(), vector.end(),
+      std::vector<int>(bucket_count, 0), HistogramAccumulation(),
+      HistogramCombination(), embb::mtapi::ExecutionPolicy(), block_size);
+    PT_EXPECT(histogram == expected);
+  }
+
+  // Empty range yields the neutral element
+  histogram = ReduceLocal(vector.begin(), vector.begin(),
+    std::vector<int>(bucket_count, 0), HistogramAccumulation(),
+    HistogramCombination());
+  PT_EXPECT(histogram == std::vector<int>(bucket_count, 0));
+}
+
 void ReduceTest::StressTest() {
   using embb::algorithms::Reduce;
   using embb::mtapi::ExecutionPolicy;
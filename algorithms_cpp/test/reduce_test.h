@@ -75,6 +75,11 @@ class ReduceTest : public partest::TestCase {
    */
   void TestPolicy();
 
+  /**
+   * Tests the reduction into worker-local values.
+   */
+  void TestLocal();
+
   /**
    * Stress tests by giving work for all workers.
    */
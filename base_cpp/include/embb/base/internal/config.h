@@ -30,6 +30,13 @@
 #include <embb/base/internal/cmake_config.h>
 #include <embb/base/c/internal/config.h>
 
+/* Rvalue references and std::move are available. Unlike
+   EMBB_PLATFORM_ARCH_CXX11, this does not depend on the atomics backend. */
+#if (__cplusplus >= 201103L) || \
+  (defined(EMBB_PLATFORM_COMPILER_MSVC) && (_MSC_VER >= 1600))
+#define EMBB_PLATFORM_HAS_RVALUE_REFERENCES
+#endif
+
 /* Disable exceptions in STL of MSVC. Leads to errors when used like this!!! */
 /*#if defined(EMBB_PLATFORM_COMPILER_MSVC) && !defined(EMBB_USE_EXCEPTIONS)
 #define _HAS_EXCEPTIONS 0
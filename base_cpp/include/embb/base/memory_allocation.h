@@ -784,7 +784,7 @@ class AllocatorCacheAligned : public Allocator < Type > {
    */
   template <typename OtherType> struct rebind {
     /** Type to rebind to */
-    typedef Allocator<OtherType> other;
+    typedef AllocatorCacheAligned<OtherType> other;
   };
 
   /**
@@ -0,0 +1,1460 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Measures the throughput of the concurrent containers.
+//
+// For every container, thread count and mix, each thread does the given
+// number of operations, each of which is a removal with the given
+// probability and an insertion otherwise. The container starts half full.
+// With more removals than insertions, the container runs empty and most
+// removals only read it, with fewer it runs full. With a batch size above one,
+// each operation moves that many elements with the batch operations of the
+// container and counts as that many operations. The bounded queue has no
+// batch operations and moves the elements of a batch one at a time.
+//
+// The maps are measured with a mix of lookups and writes instead, half of the
+// writes insert or update a key and half erase one. The keys are drawn
+// uniformly from twice the given capacity, or skewed so that 90 percent of the
+// operations use 10 percent of the keys. The maps start with every other key,
+// and are compared to a std::map protected by a mutex. The ordered maps
+// additionally read ranges of 100 consecutive keys, about 50 of which are
+// contained, and only insert keys that are not contained yet.
+//
+// The value pools are filled to the given occupancy first, then each thread
+// allocates and frees an element in turn, which counts as two operations.
+//
+// The single-producer single-consumer queue always runs with two threads and
+// elements of the given sizes in bytes. When streaming, one thread enqueues
+// and the other dequeues. In the ping-pong runs, the threads pass each
+// element back and forth through a pair of queues, which measures the latency
+// of a hand-over instead of the throughput.
+//
+// The MultiQueues only approximate the order of their elements. For them and
+// the other queues, a shorter second run with the same mix logs every
+// operation with a global time stamp and reports the mean rank error: the
+// number of elements in the queue that should have been dequeued before the
+// dequeued element, zero for a strict FIFO queue. The FIFO queues rank their
+// elements by the time stamps of the insertions, the priority MultiQueue by
+// priorities derived from them.
+//
+// The concurrent priority queue runs the same mixes of insertions and
+// deletions of the smallest key, with keys derived from the elements like the
+// priorities of the MultiQueue. It is compared to a std::priority_queue
+// protected by a mutex. Both are strict, their rank errors only stem from
+// threads that are suspended between an operation and its time stamp.
+//
+// Reports one line of CSV or one JSON object per run.
+
+#include <embb/base/c/internal/thread_index.h>
+#include <embb/base/c/thread.h>
+#include <embb/base/atomic.h>
+#include <embb/base/mutex.h>
+#include <embb/base/thread.h>
+#include <embb/containers/bounded_mpmc_queue.h>
+#include <embb/containers/concurrent_priority_queue.h>
+#include <embb/containers/lock_free_bitmap_value_pool.h>
+#include <embb/containers/lock_free_hash_map.h>
+#include <embb/containers/lock_free_skip_list_map.h>
+#include <embb/containers/lock_free_tree_value_pool.h>
+#include <embb/containers/thread_caching_value_pool.h>
+#include <embb/containers/wait_free_array_value_pool.h>
+#include <embb/containers/lock_free_mpmc_queue.h>
+#include <embb/containers/lock_free_stack.h>
+#include <embb/containers/lock_free_elimination_stack.h>
+#include <embb/containers/multi_queue.h>
+#include <embb/containers/wait_free_spsc_queue.h>
+#include <embb/containers/internal/epoch_reclamation.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct BenchmarkOptions {
+  std::vector<std::string> containers;
+  std::vector<int> threads;
+  std::vector<int> removals;
+  std::vector<int> batches;
+  std::vector<int> reads;
+  std::vector<std::string> keys;
+  std::vector<int> ranges;
+  std::vector<int> occupancies;
+  std::vector<int> element_sizes;
+  int operations;
+  int capacity;
+  int repetitions;
+  bool json;
+};
+
+// the parameters of a run that depend on the kind of container
+struct Workload {
+  // percentage of removals, queues and stacks only
+  int removals;
+  // elements moved per operation, queues and stacks only
+  int batch;
+  // percentage of lookups, maps only
+  int reads;
+  // key distribution, maps only
+  std::string keys;
+  // percentage of range reads, ordered maps only
+  int ranges;
+  // percentage of elements allocated before the run, value pools only
+  int occupancy;
+  // size of the elements in bytes, SPSC queue only
+  int element_size;
+};
+
+struct BenchmarkResult {
+  std::string container;
+  int threads;
+  Workload workload;
+  double operations;
+  double seconds;
+  // mean rank error, queues only
+  double rank_error;
+};
+
+// monotonic wall clock time in microseconds
+static double wall_time() {
+#ifdef _WIN32
+  LARGE_INTEGER frequency;
+  LARGE_INTEGER counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return static_cast<double>(counter.QuadPart) * 1e6 /
+    static_cast<double>(frequency.QuadPart);
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<double>(now.tv_sec) * 1e6 +
+    static_cast<double>(now.tv_nsec) / 1e3;
+#endif
+}
+
+// releases all threads of a run at once, so thread creation is not measured
+class StartGate {
+ public:
+  explicit StartGate(int threads) : waiting(threads), open(false) {}
+
+  void Wait() {
+    waiting--;
+    while (!open) {
+      embb::base::Thread::CurrentYield();
+    }
+  }
+
+  void Open() {
+    while (waiting > 0) {
+      embb::base::Thread::CurrentYield();
+    }
+    open = true;
+  }
+
+ private:
+  embb::base::Atomic<int> waiting;
+  embb::base::Atomic<bool> open;
+};
+
+// queues and stacks name their operations differently
+template<typename Container>
+static bool try_insert(Container * container, int element) {
+  return container->TryEnqueue(element);
+}
+
+template<typename Container>
+static bool try_remove(Container * container, int & element) {
+  return container->TryDequeue(element);
+}
+
+template<typename ValuePool, template<typename> class Reclamation>
+static bool try_insert(
+  embb::containers::LockFreeStack<int, ValuePool, Reclamation> * stack,
+  int element) {
+  return stack->TryPush(element);
+}
+
+template<typename ValuePool, template<typename> class Reclamation>
+static bool try_remove(
+  embb::containers::LockFreeStack<int, ValuePool, Reclamation> * stack,
+  int & element) {
+  return stack->TryPop(element);
+}
+
+template<typename Container>
+static size_t try_insert_batch(Container * container,
+  std::vector<int> const & elements) {
+  return container->TryEnqueueBatch(elements.begin(), elements.end());
+}
+
+template<typename Container>
+static size_t try_remove_batch(Container * container,
+  std::vector<int> & elements) {
+  return container->TryDequeueBatch(elements.begin(), elements.size());
+}
+
+template<typename ValuePool, template<typename> class Reclamation>
+static size_t try_insert_batch(
+  embb::containers::LockFreeStack<int, ValuePool, Reclamation> * stack,
+  std::vector<int> const & elements) {
+  return stack->TryPushBatch(elements.begin(), elements.end());
+}
+
+template<typename ValuePool, template<typename> class Reclamation>
+static size_t try_remove_batch(
+  embb::containers::LockFreeStack<int, ValuePool, Reclamation> * stack,
+  std::vector<int> & elements) {
+  return stack->TryPopBatch(elements.begin(), elements.size());
+}
+
+template<typename ValuePool, template<typename> class Reclamation>
+static bool try_insert(
+  embb::containers::LockFreeEliminationStack<int, ValuePool, Reclamation> *
+    stack,
+  int element) {
+  return stack->TryPush(element);
+}
+
+template<typename ValuePool, template<typename> class Reclamation>
+static bool try_remove(
+  embb::containers::LockFreeEliminationStack<int, ValuePool, Reclamation> *
+    stack,
+  int & element) {
+  return stack->TryPop(element);
+}
+
+template<typename ValuePool, template<typename> class Reclamation>
+static size_t try_insert_batch(
+  embb::containers::LockFreeEliminationStack<int, ValuePool, Reclamation> *
+    stack,
+  std::vector<int> const & elements) {
+  return stack->TryPushBatch(elements.begin(), elements.end());
+}
+
+template<typename ValuePool, template<typename> class Reclamation>
+static size_t try_remove_batch(
+  embb::containers::LockFreeEliminationStack<int, ValuePool, Reclamation> *
+    stack,
+  std::vector<int> & elements) {
+  return stack->TryPopBatch(elements.begin(), elements.size());
+}
+
+static size_t try_insert_batch(
+  embb::containers::BoundedMPMCQueue<int> * queue,
+  std::vector<int> const & elements) {
+  size_t count = 0;
+  while (count < elements.size() && queue->TryEnqueue(elements[count])) {
+    count++;
+  }
+  return count;
+}
+
+static size_t try_remove_batch(
+  embb::containers::BoundedMPMCQueue<int> * queue,
+  std::vector<int> & elements) {
+  size_t count = 0;
+  while (count < elements.size() && queue->TryDequeue(elements[count])) {
+    count++;
+  }
+  return count;
+}
+
+// the priority MultiQueue derives the priorities from the elements
+static int priority_of(int element) {
+  // Fibonacci hashing, spreads consecutive elements over 20 bits
+  return static_cast<int>((static_cast<unsigned int>(element) * 2654435761u)
+    >> 12);
+}
+
+static bool try_insert(
+  embb::containers::PriorityMultiQueue<int, int> * queue, int element) {
+  return queue->TryEnqueue(priority_of(element), element);
+}
+
+static bool try_remove(
+  embb::containers::PriorityMultiQueue<int, int> * queue, int & element) {
+  int priority;
+  return queue->TryDequeue(priority, element);
+}
+
+// the MultiQueues have no batch operations either
+template<typename Type>
+static size_t try_insert_batch(
+  embb::containers::MultiQueue<Type> * queue,
+  std::vector<int> const & elements) {
+  size_t count = 0;
+  while (count < elements.size() && queue->TryEnqueue(elements[count])) {
+    count++;
+  }
+  return count;
+}
+
+template<typename Type>
+static size_t try_remove_batch(
+  embb::containers::MultiQueue<Type> * queue,
+  std::vector<int> & elements) {
+  size_t count = 0;
+  while (count < elements.size() && queue->TryDequeue(elements[count])) {
+    count++;
+  }
+  return count;
+}
+
+static size_t try_insert_batch(
+  embb::containers::PriorityMultiQueue<int, int> * queue,
+  std::vector<int> const & elements) {
+  size_t count = 0;
+  while (count < elements.size() && try_insert(queue, elements[count])) {
+    count++;
+  }
+  return count;
+}
+
+static size_t try_remove_batch(
+  embb::containers::PriorityMultiQueue<int, int> * queue,
+  std::vector<int> & elements) {
+  size_t count = 0;
+  while (count < elements.size() && try_remove(queue, elements[count])) {
+    count++;
+  }
+  return count;
+}
+
+// the baseline for the priority queues
+class MutexPriorityQueue {
+ public:
+  explicit MutexPriorityQueue(size_t capacity) : capacity_(capacity) {}
+
+  bool TryInsert(int key, int value) {
+    embb::base::LockGuard<embb::base::Mutex> guard(mutex_);
+    if (queue_.size() == capacity_) {
+      return false;
+    }
+    queue_.push(std::make_pair(key, value));
+    return true;
+  }
+
+  bool TryDeleteMin(int & key, int & value) {
+    embb::base::LockGuard<embb::base::Mutex> guard(mutex_);
+    if (queue_.empty()) {
+      return false;
+    }
+    key = queue_.top().first;
+    value = queue_.top().second;
+    queue_.pop();
+    return true;
+  }
+
+ private:
+  typedef std::pair<int, int> Element;
+
+  size_t capacity_;
+  embb::base::Mutex mutex_;
+  std::priority_queue<Element, std::vector<Element>, std::greater<Element> >
+    queue_;
+};
+
+// the priority queues take their keys from the elements like the priority
+// MultiQueue, and have no batch operations
+template<typename Key, typename Value, typename Compare, typename ValuePool>
+static bool try_insert(embb::containers::ConcurrentPriorityQueue<Key, Value,
+  Compare, ValuePool> * queue, int element) {
+  return queue->TryInsert(priority_of(element), element);
+}
+
+template<typename Key, typename Value, typename Compare, typename ValuePool>
+static bool try_remove(embb::containers::ConcurrentPriorityQueue<Key, Value,
+  Compare, ValuePool> * queue, int & element) {
+  int key;
+  return queue->TryDeleteMin(key, element);
+}
+
+static bool try_insert(MutexPriorityQueue * queue, int element) {
+  return queue->TryInsert(priority_of(element), element);
+}
+
+static bool try_remove(MutexPriorityQueue * queue, int & element) {
+  int key;
+  return queue->TryDeleteMin(key, element);
+}
+
+template<typename Key, typename Value, typename Compare, typename ValuePool>
+static size_t try_insert_batch(embb::containers::ConcurrentPriorityQueue<Key,
+  Value, Compare, ValuePool> * queue, std::vector<int> const & elements) {
+  size_t count = 0;
+  while (count < elements.size() && try_insert(queue, elements[count])) {
+    count++;
+  }
+  return count;
+}
+
+template<typename Key, typename Value, typename Compare, typename ValuePool>
+static size_t try_remove_batch(embb::containers::ConcurrentPriorityQueue<Key,
+  Value, Compare, ValuePool> * queue, std::vector<int> & elements) {
+  size_t count = 0;
+  while (count < elements.size() && try_remove(queue, elements[count])) {
+    count++;
+  }
+  return count;
+}
+
+static size_t try_insert_batch(MutexPriorityQueue * queue,
+  std::vector<int> const & elements) {
+  size_t count = 0;
+  while (count < elements.size() && try_insert(queue, elements[count])) {
+    count++;
+  }
+  return count;
+}
+
+static size_t try_remove_batch(MutexPriorityQueue * queue,
+  std::vector<int> & elements) {
+  size_t count = 0;
+  while (count < elements.size() && try_remove(queue, elements[count])) {
+    count++;
+  }
+  return count;
+}
+
+// the key by which a queue should order an element, smallest first
+template<typename Container>
+static int rank_key(Container *, int element) {
+  return element;
+}
+
+static int rank_key(
+  embb::containers::PriorityMultiQueue<int, int> *, int element) {
+  return priority_of(element);
+}
+
+template<typename Key, typename Value, typename Compare, typename ValuePool>
+static int rank_key(embb::containers::ConcurrentPriorityQueue<Key, Value,
+  Compare, ValuePool> *, int element) {
+  return priority_of(element);
+}
+
+static int rank_key(MutexPriorityQueue *, int element) {
+  return priority_of(element);
+}
+
+template<typename Container>
+class Worker {
+ public:
+  Worker(Container * container, StartGate * gate, int operations,
+    int removals, int batch, unsigned int seed)
+    : container_(container), gate_(gate), operations_(operations),
+      removals_(removals), batch_(batch), random_(seed) {}
+
+  void operator()() {
+    gate_->Wait();
+    int element = 0;
+    std::vector<int> elements(static_cast<size_t>(batch_));
+    for (int ii = 0; ii < operations_; ii += batch_) {
+      // xorshift, cheap enough not to distort the measurement
+      random_ ^= random_ << 13;
+      random_ ^= random_ >> 17;
+      random_ ^= random_ << 5;
+      bool removal = static_cast<int>(random_ % 100) < removals_;
+      if (1 == batch_) {
+        if (removal) {
+          try_remove(container_, element);
+        } else {
+          try_insert(container_, ii);
+        }
+      } else {
+        if (removal) {
+          try_remove_batch(container_, elements);
+        } else {
+          try_insert_batch(container_, elements);
+        }
+      }
+    }
+  }
+
+ private:
+  Container * container_;
+  StartGate * gate_;
+  int operations_;
+  int removals_;
+  int batch_;
+  unsigned int random_;
+};
+
+// returns the seconds it took the threads to do their operations
+template<typename Container>
+static double run(BenchmarkOptions const & options, int threads,
+  Workload const & workload) {
+  // thread indices are handed out once per thread, start over for every run
+  embb_internal_thread_index_reset();
+  Container container(static_cast<size_t>(options.capacity));
+  for (int ii = 0; ii < options.capacity / 2; ii++) {
+    try_insert(&container, ii);
+  }
+
+  StartGate gate(threads);
+  std::vector<embb::base::Thread*> workers;
+  for (int ii = 0; ii < threads; ii++) {
+    workers.push_back(new embb::base::Thread(
+      Worker<Container>(&container, &gate, options.operations,
+        workload.removals, workload.batch,
+        static_cast<unsigned int>(ii) * 2654435761u + 1)));
+  }
+  gate.Open();
+  double start = wall_time();
+  for (size_t ii = 0; ii < workers.size(); ii++) {
+    workers[ii]->Join();
+    delete workers[ii];
+  }
+  return (wall_time() - start) / 1e6;
+}
+
+// an insertion or removal in the order of the time stamps
+struct RankEvent {
+  int stamp;
+  int element;
+  bool removal;
+
+  bool operator<(RankEvent const & other) const {
+    return stamp < other.stamp;
+  }
+};
+
+// Does the mix of a Worker one element at a time and logs the operations.
+// The elements are the time stamps of their insertions, which are taken
+// before the insertion, while removals are stamped after the removal, so
+// that the log never removes an element before inserting it.
+template<typename Container>
+class RankWorker {
+ public:
+  RankWorker(Container * container, StartGate * gate, int operations,
+    int removals, unsigned int seed, embb::base::Atomic<int> * clock,
+    std::vector<RankEvent> * log)
+    : container_(container), gate_(gate), operations_(operations),
+      removals_(removals), random_(seed), clock_(clock), log_(log) {}
+
+  void operator()() {
+    gate_->Wait();
+    for (int ii = 0; ii < operations_; ii++) {
+      random_ ^= random_ << 13;
+      random_ ^= random_ >> 17;
+      random_ ^= random_ << 5;
+      RankEvent event;
+      event.removal = static_cast<int>(random_ % 100) < removals_;
+      if (event.removal) {
+        if (try_remove(container_, event.element)) {
+          event.stamp = clock_->FetchAndAdd(1);
+          log_->push_back(event);
+        }
+      } else {
+        event.stamp = clock_->FetchAndAdd(1);
+        event.element = event.stamp;
+        if (try_insert(container_, event.element)) {
+          log_->push_back(event);
+        }
+      }
+    }
+  }
+
+ private:
+  Container * container_;
+  StartGate * gate_;
+  int operations_;
+  int removals_;
+  unsigned int random_;
+  embb::base::Atomic<int> * clock_;
+  std::vector<RankEvent> * log_;
+};
+
+// Replays the logged operations in the order of their time stamps and
+// returns the mean number of elements with smaller keys than the removed
+// ones. A Fenwick tree counts the elements in the queue per key.
+template<typename Container>
+static double mean_rank_error(Container * container,
+  std::vector<RankEvent> const & log) {
+  std::vector<int> keys(log.size());
+  int max_key = 0;
+  for (size_t ii = 0; ii < log.size(); ii++) {
+    keys[ii] = rank_key(container, log[ii].element);
+    max_key = std::max(max_key, keys[ii]);
+  }
+  std::vector<int> tree(static_cast<size_t>(max_key) + 2, 0);
+  double ranks = 0;
+  double removals = 0;
+  for (size_t ii = 0; ii < log.size(); ii++) {
+    int delta = 1;
+    if (log[ii].removal) {
+      // elements with keys below keys[ii]
+      for (int kk = keys[ii]; kk > 0; kk -= kk & -kk) {
+        ranks += tree[static_cast<size_t>(kk)];
+      }
+      removals++;
+      delta = -1;
+    }
+    for (int kk = keys[ii] + 1; kk < static_cast<int>(tree.size());
+      kk += kk & -kk) {
+      tree[static_cast<size_t>(kk)] += delta;
+    }
+  }
+  return 0 < removals ? ranks / removals : 0;
+}
+
+// operations per thread of the logged runs, bounds the size of the logs
+static int const rank_operations = 100000;
+
+template<typename Container>
+static double measure_rank_error(BenchmarkOptions const & options,
+  int threads, Workload const & workload) {
+  embb_internal_thread_index_reset();
+  Container container(static_cast<size_t>(options.capacity));
+  embb::base::Atomic<int> clock(0);
+  int operations = std::min(options.operations, rank_operations);
+  std::vector< std::vector<RankEvent> > logs(
+    static_cast<size_t>(threads) + 1);
+  for (int ii = 0; ii < options.capacity / 2; ii++) {
+    RankEvent event = { clock.FetchAndAdd(1), 0, false };
+    event.element = event.stamp;
+    if (try_insert(&container, event.element)) {
+      logs[0].push_back(event);
+    }
+  }
+
+  StartGate gate(threads);
+  std::vector<embb::base::Thread*> workers;
+  for (int ii = 0; ii < threads; ii++) {
+    std::vector<RankEvent> & log = logs[static_cast<size_t>(ii) + 1];
+    log.reserve(static_cast<size_t>(operations));
+    workers.push_back(new embb::base::Thread(
+      RankWorker<Container>(&container, &gate, operations,
+        workload.removals, static_cast<unsigned int>(ii) * 2654435761u + 1,
+        &clock, &log)));
+  }
+  gate.Open();
+  for (size_t ii = 0; ii < workers.size(); ii++) {
+    workers[ii]->Join();
+    delete workers[ii];
+  }
+
+  std::vector<RankEvent> log;
+  for (size_t ii = 0; ii < logs.size(); ii++) {
+    log.insert(log.end(), logs[ii].begin(), logs[ii].end());
+  }
+  std::sort(log.begin(), log.end());
+  return mean_rank_error(&container, log);
+}
+
+// measures the throughput, and the rank error if asked to
+template<typename Container>
+static double run_queue(BenchmarkOptions const & options, int threads,
+  Workload const & workload, double * rank_error) {
+  if (NULL != rank_error) {
+    *rank_error = measure_rank_error<Container>(options, threads, workload);
+  }
+  return run<Container>(options, threads, workload);
+}
+
+// the baseline for the maps
+class MutexMap {
+ public:
+  explicit MutexMap(size_t capacity) : capacity_(capacity) {}
+
+  bool TryGet(int key, int & value) {
+    embb::base::LockGuard<embb::base::Mutex> guard(mutex_);
+    std::map<int, int>::const_iterator it = map_.find(key);
+    if (map_.end() == it) {
+      return false;
+    }
+    value = it->second;
+    return true;
+  }
+
+  bool TryInsert(int key, int value) {
+    embb::base::LockGuard<embb::base::Mutex> guard(mutex_);
+    if (map_.size() == capacity_) {
+      return false;
+    }
+    return map_.insert(std::make_pair(key, value)).second;
+  }
+
+  bool InsertOrUpdate(int key, int value) {
+    embb::base::LockGuard<embb::base::Mutex> guard(mutex_);
+    if (map_.size() == capacity_ && map_.end() == map_.find(key)) {
+      return false;
+    }
+    map_[key] = value;
+    return true;
+  }
+
+  bool TryErase(int key) {
+    embb::base::LockGuard<embb::base::Mutex> guard(mutex_);
+    return 0 < map_.erase(key);
+  }
+
+  template<typename OutputIterator>
+  size_t GetRange(int lower, int upper, OutputIterator out, size_t max) {
+    embb::base::LockGuard<embb::base::Mutex> guard(mutex_);
+    size_t count = 0;
+    std::map<int, int>::const_iterator it = map_.lower_bound(lower);
+    for (; count < max && map_.end() != it && it->first < upper; ++it) {
+      *out = *it;
+      ++out;
+      count++;
+    }
+    return count;
+  }
+
+ private:
+  size_t capacity_;
+  embb::base::Mutex mutex_;
+  std::map<int, int> map_;
+};
+
+template<typename Map>
+class MapWorker {
+ public:
+  MapWorker(Map * map, StartGate * gate, int operations, int reads,
+    int key_count, bool skewed, unsigned int seed)
+    : map_(map), gate_(gate), operations_(operations), reads_(reads),
+      key_count_(key_count), skewed_(skewed), random_(seed) {}
+
+  void operator()() {
+    gate_->Wait();
+    int value = 0;
+    for (int ii = 0; ii < operations_; ii++) {
+      unsigned int random = Next();
+      int key = static_cast<int>(Next() % static_cast<unsigned int>(
+        key_count_));
+      if (skewed_ && random % 10 != 0) {
+        // the hot keys are spread over the key range
+        key -= key % 10;
+      }
+      int choice = static_cast<int>((random / 10) % 200);
+      if (choice < 2 * reads_) {
+        map_->TryGet(key, value);
+      } else if (choice % 2 == 0) {
+        map_->InsertOrUpdate(key, ii);
+      } else {
+        map_->TryErase(key);
+      }
+    }
+  }
+
+ private:
+  // xorshift, as for the other containers
+  unsigned int Next() {
+    random_ ^= random_ << 13;
+    random_ ^= random_ >> 17;
+    random_ ^= random_ << 5;
+    return random_;
+  }
+
+  Map * map_;
+  StartGate * gate_;
+  int operations_;
+  int reads_;
+  int key_count_;
+  bool skewed_;
+  unsigned int random_;
+};
+
+template<typename Map>
+static double run_map(BenchmarkOptions const & options, int threads,
+  Workload const & workload) {
+  embb_internal_thread_index_reset();
+  // the map can hold all keys, so writes do not fail for lack of space
+  int key_count = 2 * options.capacity;
+  Map map(static_cast<size_t>(key_count));
+  for (int ii = 0; ii < key_count; ii += 2) {
+    map.InsertOrUpdate(ii, ii);
+  }
+
+  StartGate gate(threads);
+  std::vector<embb::base::Thread*> workers;
+  for (int ii = 0; ii < threads; ii++) {
+    workers.push_back(new embb::base::Thread(
+      MapWorker<Map>(&map, &gate, options.operations, workload.reads,
+        key_count, "skewed" == workload.keys,
+        static_cast<unsigned int>(ii) * 2654435761u + 1)));
+  }
+  gate.Open();
+  double start = wall_time();
+  for (size_t ii = 0; ii < workers.size(); ii++) {
+    workers[ii]->Join();
+    delete workers[ii];
+  }
+  return (wall_time() - start) / 1e6;
+}
+
+// keys per range read of the ordered maps
+static int const range_keys = 100;
+
+template<typename Map>
+class OrderedMapWorker {
+ public:
+  OrderedMapWorker(Map * map, StartGate * gate, int operations, int reads,
+    int ranges, int key_count, bool skewed, unsigned int seed)
+    : map_(map), gate_(gate), operations_(operations), reads_(reads),
+      ranges_(ranges), key_count_(key_count), skewed_(skewed),
+      random_(seed) {}
+
+  void operator()() {
+    gate_->Wait();
+    int value = 0;
+    std::vector< std::pair<int, int> > range;
+    range.reserve(static_cast<size_t>(range_keys));
+    for (int ii = 0; ii < operations_; ii++) {
+      unsigned int random = Next();
+      int key = static_cast<int>(Next() % static_cast<unsigned int>(
+        key_count_));
+      if (skewed_ && random % 10 != 0) {
+        key -= key % 10;
+      }
+      int choice = static_cast<int>((random / 10) % 200);
+      if (choice < 2 * ranges_) {
+        range.clear();
+        map_->GetRange(key, key + range_keys, std::back_inserter(range),
+          static_cast<size_t>(range_keys));
+      } else if (choice < 2 * (ranges_ + reads_)) {
+        map_->TryGet(key, value);
+      } else if (choice % 2 == 0) {
+        map_->TryInsert(key, ii);
+      } else {
+        map_->TryErase(key);
+      }
+    }
+  }
+
+ private:
+  unsigned int Next() {
+    random_ ^= random_ << 13;
+    random_ ^= random_ >> 17;
+    random_ ^= random_ << 5;
+    return random_;
+  }
+
+  Map * map_;
+  StartGate * gate_;
+  int operations_;
+  int reads_;
+  int ranges_;
+  int key_count_;
+  bool skewed_;
+  unsigned int random_;
+};
+
+template<typename Map>
+static double run_ordered_map(BenchmarkOptions const & options, int threads,
+  Workload const & workload) {
+  embb_internal_thread_index_reset();
+  int key_count = 2 * options.capacity;
+  Map map(static_cast<size_t>(key_count));
+  for (int ii = 0; ii < key_count; ii += 2) {
+    map.TryInsert(ii, ii);
+  }
+
+  StartGate gate(threads);
+  std::vector<embb::base::Thread*> workers;
+  for (int ii = 0; ii < threads; ii++) {
+    workers.push_back(new embb::base::Thread(
+      OrderedMapWorker<Map>(&map, &gate, options.operations, workload.reads,
+        workload.ranges, key_count, "skewed" == workload.keys,
+        static_cast<unsigned int>(ii) * 2654435761u + 1)));
+  }
+  gate.Open();
+  double start = wall_time();
+  for (size_t ii = 0; ii < workers.size(); ii++) {
+    workers[ii]->Join();
+    delete workers[ii];
+  }
+  return (wall_time() - start) / 1e6;
+}
+
+template<typename Pool>
+class PoolWorker {
+ public:
+  PoolWorker(Pool * pool, StartGate * gate, int operations)
+    : pool_(pool), gate_(gate), operations_(operations) {}
+
+  void operator()() {
+    gate_->Wait();
+    int element = 0;
+    for (int ii = 0; ii < operations_; ii += 2) {
+      int index = pool_->Allocate(element);
+      if (index >= 0) {
+        pool_->Free(element, index);
+      }
+    }
+  }
+
+ private:
+  Pool * pool_;
+  StartGate * gate_;
+  int operations_;
+};
+
+template<typename Pool>
+static double run_pool(BenchmarkOptions const & options, int threads,
+  Workload const & workload) {
+  embb_internal_thread_index_reset();
+  std::vector<int> elements(static_cast<size_t>(options.capacity), 0);
+  Pool pool(elements.begin(), elements.end());
+  int element;
+  for (int ii = 0; ii < options.capacity * workload.occupancy / 100; ii++) {
+    pool.Allocate(element);
+  }
+
+  StartGate gate(threads);
+  std::vector<embb::base::Thread*> workers;
+  for (int ii = 0; ii < threads; ii++) {
+    workers.push_back(new embb::base::Thread(
+      PoolWorker<Pool>(&pool, &gate, options.operations)));
+  }
+  gate.Open();
+  double start = wall_time();
+  for (size_t ii = 0; ii < workers.size(); ii++) {
+    workers[ii]->Join();
+    delete workers[ii];
+  }
+  return (wall_time() - start) / 1e6;
+}
+
+// the elements passed through the SPSC queue
+template<int Size>
+struct Payload {
+  char bytes[Size];
+};
+
+// Sends elements to the other thread, receives elements from it, or both in
+// turn. Sending and receiving count as one operation each.
+template<typename Element>
+class SPSCWorker {
+ public:
+  typedef embb::containers::WaitFreeSPSCQueue<Element> Queue;
+
+
+  SPSCWorker(Queue * send, Queue * receive, bool sends_first,
+    StartGate * gate, int operations)
+    : send_(send), receive_(receive), sends_first_(sends_first),
+      gate_(gate), operations_(operations) {}
+
+  void operator()() {
+    gate_->Wait();
+    Element element;
+    memset(&element, 0, sizeof(element));
+    int ii = 0;
+    while (ii < operations_) {
+      if (sends_first_ && NULL != send_) {
+        Send(element, ii++);
+      }
+      if (NULL != receive_) {
+        while (!receive_->TryDequeue(element)) {
+          embb::base::Thread::CurrentYield();
+        }
+        ii++;
+      }
+      if (!sends_first_ && NULL != send_) {
+        Send(element, ii++);
+      }
+    }
+  }
+
+ private:
+  void Send(Element & element, int sequence) {
+    element.bytes[0] = static_cast<char>(sequence);
+    while (!send_->TryEnqueue(element)) {
+      embb::base::Thread::CurrentYield();
+    }
+  }
+
+  Queue * send_;
+  Queue * receive_;
+  bool sends_first_;
+  StartGate * gate_;
+  int operations_;
+};
+
+template<int Size>
+static double run_spsc(BenchmarkOptions const & options, bool ping_pong) {
+  typedef typename SPSCWorker< Payload<Size> >::Queue Queue;
+  Queue forward(static_cast<size_t>(options.capacity));
+  Queue backward(static_cast<size_t>(options.capacity));
+
+  StartGate gate(2);
+  std::vector<embb::base::Thread*> workers;
+  workers.push_back(new embb::base::Thread(SPSCWorker< Payload<Size> >(
+    &forward, ping_pong ? &backward : NULL, true, &gate,
+    options.operations)));
+  workers.push_back(new embb::base::Thread(SPSCWorker< Payload<Size> >(
+    ping_pong ? &backward : NULL, &forward, false, &gate,
+    options.operations)));
+  gate.Open();
+  double start = wall_time();
+  for (size_t ii = 0; ii < workers.size(); ii++) {
+    workers[ii]->Join();
+    delete workers[ii];
+  }
+  return (wall_time() - start) / 1e6;
+}
+
+// the element sizes --element-size accepts
+static bool is_element_size(int size) {
+  return 4 <= size && size <= 1024 && 0 == (size & (size - 1));
+}
+
+static double run_spsc(BenchmarkOptions const & options, bool ping_pong,
+  int element_size) {
+  switch (element_size) {
+  case 4: return run_spsc<4>(options, ping_pong);
+  case 8: return run_spsc<8>(options, ping_pong);
+  case 16: return run_spsc<16>(options, ping_pong);
+  case 32: return run_spsc<32>(options, ping_pong);
+  case 64: return run_spsc<64>(options, ping_pong);
+  case 128: return run_spsc<128>(options, ping_pong);
+  case 256: return run_spsc<256>(options, ping_pong);
+  case 512: return run_spsc<512>(options, ping_pong);
+  default: return run_spsc<1024>(options, ping_pong);
+  }
+}
+
+static bool is_spsc(std::string const & container) {
+  return "wait_free_spsc_queue" == container ||
+    "wait_free_spsc_queue_ping_pong" == container;
+}
+
+static bool is_queue(std::string const & container) {
+  return "bounded_mpmc_queue" == container ||
+    "lock_free_mpmc_queue" == container ||
+    "lock_free_mpmc_queue_epoch" == container ||
+    "lock_free_mpmc_queue_magazine" == container ||
+    "multi_queue" == container ||
+    "priority_multi_queue" == container ||
+    "concurrent_priority_queue" == container ||
+    "mutex_priority_queue" == container;
+}
+
+static bool is_pool(std::string const & container) {
+  return "wait_free_array_value_pool" == container ||
+    "lock_free_tree_value_pool" == container ||
+    "lock_free_bitmap_value_pool" == container ||
+    "thread_caching_value_pool" == container;
+}
+
+static bool is_ordered_map(std::string const & container) {
+  return "lock_free_skip_list_map" == container ||
+    "mutex_ordered_map" == container;
+}
+
+static bool is_map(std::string const & container) {
+  return "lock_free_hash_map" == container || "mutex_map" == container ||
+    is_ordered_map(container);
+}
+
+static bool run_container(
+  BenchmarkOptions const & options,
+  std::string const & container,
+  int threads,
+  Workload const & workload,
+  double * seconds,
+  double * rank_error) {
+  typedef embb::containers::LockFreeTreeValuePool<bool, false> ValuePool;
+  typedef embb::containers::ThreadCachingValuePool<bool, false>
+    CachingValuePool;
+  if ("bounded_mpmc_queue" == container) {
+    *seconds = run_queue< embb::containers::BoundedMPMCQueue<int> >(
+      options, threads, workload, rank_error);
+  } else if ("lock_free_mpmc_queue" == container) {
+    *seconds = run_queue< embb::containers::LockFreeMPMCQueue<int> >(
+      options, threads, workload, rank_error);
+  } else if ("lock_free_mpmc_queue_epoch" == container) {
+    *seconds = run_queue< embb::containers::LockFreeMPMCQueue<int, ValuePool,
+      embb::containers::internal::EpochReclamation> >(
+      options, threads, workload, rank_error);
+  } else if ("lock_free_mpmc_queue_magazine" == container) {
+    *seconds = run_queue< embb::containers::LockFreeMPMCQueue<int,
+      CachingValuePool> >(options, threads, workload, rank_error);
+  } else if ("multi_queue" == container) {
+    *seconds = run_queue< embb::containers::MultiQueue<int> >(
+      options, threads, workload, rank_error);
+  } else if ("priority_multi_queue" == container) {
+    *seconds = run_queue< embb::containers::PriorityMultiQueue<int, int> >(
+      options, threads, workload, rank_error);
+  } else if ("concurrent_priority_queue" == container) {
+    *seconds = run_queue< embb::containers::ConcurrentPriorityQueue<int,
+      int> >(options, threads, workload, rank_error);
+  } else if ("mutex_priority_queue" == container) {
+    *seconds = run_queue< MutexPriorityQueue >(
+      options, threads, workload, rank_error);
+  } else if ("lock_free_stack" == container) {
+    *seconds = run< embb::containers::LockFreeStack<int> >(
+      options, threads, workload);
+  } else if ("lock_free_stack_epoch" == container) {
+    *seconds = run< embb::containers::LockFreeStack<int, ValuePool,
+      embb::containers::internal::EpochReclamation> >(
+      options, threads, workload);
+  } else if ("lock_free_stack_magazine" == container) {
+    *seconds = run< embb::containers::LockFreeStack<int, CachingValuePool> >(
+      options, threads, workload);
+  } else if ("lock_free_elimination_stack" == container) {
+    *seconds = run< embb::containers::LockFreeEliminationStack<int> >(
+      options, threads, workload);
+  } else if ("wait_free_spsc_queue" == container) {
+    *seconds = run_spsc(options, false, workload.element_size);
+  } else if ("wait_free_spsc_queue_ping_pong" == container) {
+    *seconds = run_spsc(options, true, workload.element_size);
+  } else if ("lock_free_hash_map" == container) {
+    *seconds = run_map< embb::containers::LockFreeHashMap<int, int> >(
+      options, threads, workload);
+  } else if ("mutex_map" == container) {
+    *seconds = run_map< MutexMap >(options, threads, workload);
+  } else if ("lock_free_skip_list_map" == container) {
+    *seconds = run_ordered_map< embb::containers::LockFreeSkipListMap<int,
+      int> >(options, threads, workload);
+  } else if ("mutex_ordered_map" == container) {
+    *seconds = run_ordered_map< MutexMap >(options, threads, workload);
+  } else if ("wait_free_array_value_pool" == container) {
+    *seconds = run_pool< embb::containers::WaitFreeArrayValuePool<int, -1> >(
+      options, threads, workload);
+  } else if ("lock_free_tree_value_pool" == container) {
+    *seconds = run_pool< embb::containers::LockFreeTreeValuePool<int, -1> >(
+      options, threads, workload);
+  } else if ("lock_free_bitmap_value_pool" == container) {
+    *seconds = run_pool< embb::containers::LockFreeBitmapValuePool<int, -1> >(
+      options, threads, workload);
+  } else if ("thread_caching_value_pool" == container) {
+    *seconds = run_pool< embb::containers::ThreadCachingValuePool<int, -1> >(
+      options, threads, workload);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+static bool parse_list(char const * text, std::vector<int> * list,
+  int min = 1, int max = 0x7fffffff) {
+  list->clear();
+  while (*text) {
+    char * end;
+    long value = strtol(text, &end, 10);
+    if (end == text || value < min || value > max) {
+      return false;
+    }
+    list->push_back(static_cast<int>(value));
+    text = (',' == *end) ? end + 1 : end;
+  }
+  return !list->empty();
+}
+
+static bool parse_names(char const * text, std::vector<std::string> * list) {
+  list->clear();
+  std::string names = text;
+  size_t begin = 0;
+  while (begin <= names.size()) {
+    size_t end = names.find(',', begin);
+    if (std::string::npos == end) {
+      end = names.size();
+    }
+    if (end == begin) {
+      return false;
+    }
+    list->push_back(names.substr(begin, end - begin));
+    begin = end + 1;
+  }
+  return !list->empty();
+}
+
+// the default for --containers
+static char const * const all_containers =
+  "bounded_mpmc_queue,lock_free_mpmc_queue,lock_free_mpmc_queue_epoch,"
+  "lock_free_mpmc_queue_magazine,multi_queue,priority_multi_queue,"
+  "concurrent_priority_queue,mutex_priority_queue,"
+  "lock_free_stack,lock_free_stack_epoch,"
+  "lock_free_stack_magazine,lock_free_elimination_stack,wait_free_spsc_queue,"
+  "wait_free_spsc_queue_ping_pong,lock_free_hash_map,mutex_map,"
+  "lock_free_skip_list_map,mutex_ordered_map,"
+  "wait_free_array_value_pool,lock_free_tree_value_pool,"
+  "lock_free_bitmap_value_pool,thread_caching_value_pool";
+
+static void usage(char const * name) {
+  fprintf(stderr,
+    "usage: %s [options]\n"
+    "  --containers LIST   containers to measure, out of\n"
+    "                      %s\n"
+    "  --threads LIST      thread counts (1,2,4,8,16,32,64)\n"
+    "  --removals LIST     percentages of removals (50)\n"
+    "  --batch LIST        elements per operation on queues and stacks,\n"
+    "                      up to 256 (1)\n"
+    "  --reads LIST        percentages of lookups in maps (90)\n"
+    "  --keys LIST         key distributions of maps, uniform or skewed\n"
+    "                      (uniform,skewed)\n"
+    "  --ranges LIST       percentages of range reads in ordered maps (0,10)\n"
+    "  --occupancy LIST    percentages of value pools allocated (50,90)\n"
+    "  --element-size LIST sizes of SPSC queue elements in bytes, powers of\n"
+    "                      two from 4 to 1024 (8,64,256,1024)\n"
+    "  --operations N      operations per thread (1000000)\n"
+    "  --capacity N        capacity of the containers (1024)\n"
+    "  --repetitions N     runs per configuration, the fastest counts (3)\n"
+    "  --json              print JSON instead of CSV\n",
+    name, all_containers);
+}
+
+static bool parse_options(int argc, char ** argv, BenchmarkOptions * options) {
+  parse_names(all_containers, &options->containers);
+  parse_list("1,2,4,8,16,32,64", &options->threads);
+  parse_list("50", &options->removals);
+  parse_list("1", &options->batches);
+  parse_list("90", &options->reads);
+  parse_names("uniform,skewed", &options->keys);
+  parse_list("0,10", &options->ranges, 0, 100);
+  parse_list("50,90", &options->occupancies);
+  parse_list("8,64,256,1024", &options->element_sizes);
+  options->operations = 1000000;
+  options->capacity = 1024;
+  options->repetitions = 3;
+  options->json = false;
+
+  for (int ii = 1; ii < argc; ii++) {
+    std::string option = argv[ii];
+    char const * value = (ii + 1 < argc) ? argv[ii + 1] : NULL;
+    bool ok = true;
+    if ("--json" == option) {
+      options->json = true;
+      continue;
+    } else if (NULL == value) {
+      ok = false;
+    } else if ("--containers" == option) {
+      ok = parse_names(value, &options->containers);
+    } else if ("--threads" == option) {
+      ok = parse_list(value, &options->threads);
+    } else if ("--removals" == option) {
+      ok = parse_list(value, &options->removals, 0, 100);
+    } else if ("--batch" == option) {
+      ok = parse_list(value, &options->batches, 1, 256);
+    } else if ("--reads" == option) {
+      ok = parse_list(value, &options->reads, 0, 100);
+    } else if ("--keys" == option) {
+      ok = parse_names(value, &options->keys);
+      for (size_t jj = 0; ok && jj < options->keys.size(); jj++) {
+        ok = "uniform" == options->keys[jj] || "skewed" == options->keys[jj];
+      }
+    } else if ("--ranges" == option) {
+      ok = parse_list(value, &options->ranges, 0, 100);
+    } else if ("--occupancy" == option) {
+      ok = parse_list(value, &options->occupancies, 0, 100);
+    } else if ("--element-size" == option) {
+      ok = parse_list(value, &options->element_sizes);
+      for (size_t jj = 0; ok && jj < options->element_sizes.size(); jj++) {
+        ok = is_element_size(options->element_sizes[jj]);
+      }
+    } else if ("--operations" == option) {
+      options->operations = atoi(value);
+    } else if ("--capacity" == option) {
+      options->capacity = atoi(value);
+    } else if ("--repetitions" == option) {
+      options->repetitions = atoi(value);
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      return false;
+    }
+    ii++;
+  }
+
+  return 0 < options->operations && 0 < options->capacity &&
+    0 < options->repetitions;
+}
+
+static void print_result(
+  BenchmarkOptions const & options,
+  BenchmarkResult const & result,
+  bool first) {
+  double operations_per_second = result.operations / result.seconds;
+  bool map = is_map(result.container);
+  bool pool = is_pool(result.container);
+  bool spsc = is_spsc(result.container);
+  bool queue = is_queue(result.container);
+
+  if (options.json) {
+    printf("%s\n  {\"container\": \"%s\", \"threads\": %d, ",
+      first ? "[" : ",", result.container.c_str(), result.threads);
+    if (map) {
+      printf("\"read_percent\": %d, \"keys\": \"%s\", ",
+        result.workload.reads, result.workload.keys.c_str());
+      if (is_ordered_map(result.container)) {
+        printf("\"range_percent\": %d, ", result.workload.ranges);
+      }
+    } else if (pool) {
+      printf("\"occupancy_percent\": %d, ", result.workload.occupancy);
+    } else if (spsc) {
+      printf("\"element_size\": %d, ", result.workload.element_size);
+    } else {
+      printf("\"removal_percent\": %d, \"batch_size\": %d, ",
+        result.workload.removals, result.workload.batch);
+    }
+    printf("\"operations\": %.0f, \"seconds\": %.6f, "
+      "\"operations_per_second\": %.1f",
+      result.operations, result.seconds, operations_per_second);
+    if (queue) {
+      printf(", \"mean_rank_error\": %.2f", result.rank_error);
+    }
+    printf("}");
+  } else {
+    if (first) {
+      printf("container,threads,removal_percent,batch_size,read_percent,keys,"
+        "range_percent,occupancy_percent,element_size,operations,seconds,"
+        "operations_per_second,mean_rank_error\n");
+    }
+    // the columns that do not apply to the container stay empty
+    printf("%s,%d,", result.container.c_str(), result.threads);
+    if (map) {
+      printf(",,%d,%s,", result.workload.reads,
+        result.workload.keys.c_str());
+      if (is_ordered_map(result.container)) {
+        printf("%d", result.workload.ranges);
+      }
+      printf(",,,");
+    } else if (pool) {
+      printf(",,,,,%d,,", result.workload.occupancy);
+    } else if (spsc) {
+      printf(",,,,,,%d,", result.workload.element_size);
+    } else {
+      printf("%d,%d,,,,,,", result.workload.removals, result.workload.batch);
+    }
+    printf("%.0f,%.6f,%.1f,",
+      result.operations, result.seconds, operations_per_second);
+    if (queue) {
+      printf("%.2f", result.rank_error);
+    }
+    printf("\n");
+  }
+  fflush(stdout);
+}
+
+int main(int argc, char ** argv) {
+  BenchmarkOptions options;
+
+  if (!parse_options(argc, argv, &options)) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  // the workers and the main thread, which fills the containers
+  int max_threads = *std::max_element(
+    options.threads.begin(), options.threads.end());
+  embb_thread_set_max_count(
+    static_cast<unsigned int>(std::max(max_threads, 2) + 1));
+
+  bool first = true;
+  for (size_t ii = 0; ii < options.containers.size(); ii++) {
+    std::string const & container = options.containers[ii];
+    std::vector<Workload> workloads;
+    if (is_map(container)) {
+      // only the ordered maps read ranges
+      std::vector<int> ranges = options.ranges;
+      if (!is_ordered_map(container)) {
+        ranges.assign(1, 0);
+      }
+      for (size_t jj = 0; jj < options.reads.size(); jj++) {
+        for (size_t kk = 0; kk < options.keys.size(); kk++) {
+          for (size_t ll = 0; ll < ranges.size(); ll++) {
+            Workload workload = { 0, 0, options.reads[jj], options.keys[kk],
+              ranges[ll], 0, 0 };
+            workloads.push_back(workload);
+          }
+        }
+      }
+    } else if (is_pool(container)) {
+      for (size_t jj = 0; jj < options.occupancies.size(); jj++) {
+        Workload workload = { 0, 0, 0, "", 0, options.occupancies[jj], 0 };
+        workloads.push_back(workload);
+      }
+    } else if (is_spsc(container)) {
+      for (size_t jj = 0; jj < options.element_sizes.size(); jj++) {
+        Workload workload =
+          { 0, 0, 0, "", 0, 0, options.element_sizes[jj] };
+        workloads.push_back(workload);
+      }
+    } else {
+      for (size_t jj = 0; jj < options.removals.size(); jj++) {
+        for (size_t kk = 0; kk < options.batches.size(); kk++) {
+          Workload workload =
+            { options.removals[jj], options.batches[kk], 0, "", 0, 0, 0 };
+          workloads.push_back(workload);
+        }
+      }
+    }
+    // the SPSC queue has exactly one producer and one consumer
+    std::vector<int> threads = options.threads;
+    if (is_spsc(container)) {
+      threads.assign(1, 2);
+    }
+    for (size_t jj = 0; jj < threads.size(); jj++) {
+      for (size_t ll = 0; ll < workloads.size(); ll++) {
+        BenchmarkResult result;
+        result.container = container;
+        result.threads = threads[jj];
+        result.workload = workloads[ll];
+        result.operations = static_cast<double>(options.operations) *
+          static_cast<double>(result.threads);
+        result.seconds = 0;
+        result.rank_error = 0;
+        for (int kk = 0; kk < options.repetitions; kk++) {
+          double seconds;
+          // the rank error does not depend on the speed, measure it once
+          double * rank_error = (0 == kk && is_queue(container)) ?
+            &result.rank_error : NULL;
+          if (!run_container(options, container, result.threads,
+            result.workload, &seconds, rank_error)) {
+            fprintf(stderr, "unknown container %s\n", container.c_str());
+            return 1;
+          }
+          if (0 == kk || seconds < result.seconds) {
+            result.seconds = seconds;
+          }
+        }
+        print_result(options, result, first);
+        first = false;
+      }
+    }
+  }
+  if (options.json && !first) {
+    printf("\n]\n");
+  }
+
+  return 0;
+}
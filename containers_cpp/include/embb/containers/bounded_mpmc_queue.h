@@ -0,0 +1,218 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EMBB_CONTAINERS_BOUNDED_MPMC_QUEUE_H_
+#define EMBB_CONTAINERS_BOUNDED_MPMC_QUEUE_H_
+
+#include <embb/base/c/internal/config.h>
+#include <embb/base/atomic.h>
+#include <embb/base/memory_allocation.h>
+
+#include <stddef.h>
+
+namespace embb {
+namespace containers {
+namespace internal {
+/**
+ * Cell of the ring buffer of a BoundedMPMCQueue
+ *
+ * The sequence number tells producers and consumers whether the cell is free
+ * or holds an element for the current round through the ring.
+ *
+ * \tparam Type Element type
+ */
+template< typename Type >
+class BoundedMPMCQueueCell {
+ public:
+  /**
+   * Sequence number of the cell
+   */
+  embb::base::Atomic< size_t > sequence;
+
+  /**
+   * The stored element
+   */
+  Type element;
+
+  /**
+   * Creates a cell with the given sequence number
+   */
+  explicit BoundedMPMCQueueCell(
+    size_t sequence
+    /**< [IN] Initial sequence number */);
+};
+} // namespace internal
+
+/**
+ * Bounded lock-free queue for multiple producers and multiple consumers
+ *
+ * The elements are stored in a ring buffer of cells, each with its own
+ * sequence number. In contrast to LockFreeMPMCQueue, enqueueing and
+ * dequeueing neither allocate nodes nor need memory reclamation, and an
+ * operation only touches the shared head or tail index and one cell.
+ *
+ * \concept{CPP_CONCEPTS_QUEUE}
+ *
+ * \ingroup CPP_CONTAINERS_QUEUES
+ *
+ * \see LockFreeMPMCQueue, WaitFreeSPSCQueue
+ *
+ * \tparam Type Type of the queue elements
+ * \tparam Allocator Allocator type for allocating the cells of the ring
+ *         buffer. Rebound to the cell type.
+ */
+template< typename Type,
+  class Allocator = embb::base::AllocatorCacheAligned< Type > >
+class BoundedMPMCQueue {
+ private:
+  /**
+   * Cell type of the ring buffer
+   */
+  typedef internal::BoundedMPMCQueueCell< Type > Cell;
+
+  /**
+   * Allocator for allocating the cells
+   */
+  typename Allocator::template rebind< Cell >::other allocator;
+
+  /**
+   * Capacity of the queue, a power of two
+   */
+  size_t capacity;
+
+  /**
+   * <tt>capacity - 1</tt>, maps positions to cells
+   */
+  size_t mask;
+
+  /**
+   * Array holding the cells
+   */
+  Cell* cells;
+
+  /**
+   * Keeps the tail index away from the fields above
+   */
+  char padding0[EMBB_PLATFORM_CACHE_LINE_SIZE];
+
+  /**
+   * Position of the next enqueue
+   */
+  embb::base::Atomic< size_t > tail_index;
+
+  /**
+   * Keeps head and tail index on separate cache lines
+   */
+  char padding1[EMBB_PLATFORM_CACHE_LINE_SIZE];
+
+  /**
+   * Position of the next dequeue
+   */
+  embb::base::Atomic< size_t > head_index;
+
+  /**
+   * Keeps the head index away from whatever follows the queue
+   */
+  char padding2[EMBB_PLATFORM_CACHE_LINE_SIZE];
+
+  /**
+   * Align capacity to the next power of two, at least two
+   */
+  static size_t AlignCapacityToPowerOfTwo(size_t capacity);
+
+  /**
+   * Disable copy construction and assignment.
+   */
+  BoundedMPMCQueue(const BoundedMPMCQueue&);
+  BoundedMPMCQueue& operator=(const BoundedMPMCQueue&);
+
+ public:
+  /**
+   * Creates a queue with at least the specified capacity.
+   *
+   * \memory Allocates \c 2^k cells holding an element of type \c Type and a
+   * sequence number, where \c k is the smallest number such that
+   * <tt>capacity <= 2^k</tt> and <tt>2 <= 2^k</tt> hold.
+   *
+   * \notthreadsafe
+   *
+   * \see CPP_CONCEPTS_QUEUE
+   */
+  explicit BoundedMPMCQueue(
+    size_t capacity
+    /**< [IN] Capacity of the queue */);
+
+  /**
+   * Destroys the queue.
+   *
+   * \notthreadsafe
+   */
+  ~BoundedMPMCQueue();
+
+  /**
+   * Returns the capacity of the queue.
+   *
+   * \return Number of elements the queue can hold.
+   *
+   * \waitfree
+   */
+  size_t GetCapacity();
+
+  /**
+   * Tries to enqueue an element into the queue.
+   *
+   * \return \c true if the element could be enqueued, \c false if the queue is
+   * full.
+   *
+   * \lockfree
+   *
+   * \see CPP_CONCEPTS_QUEUE
+   */
+  bool TryEnqueue(
+    Type const & element
+    /**< [IN] Const reference to the element that shall be enqueued */);
+
+  /**
+   * Tries to dequeue an element from the queue.
+   *
+   * \return \c true if an element could be dequeued, \c false if the queue is
+   * empty.
+   *
+   * \lockfree
+   *
+   * \see CPP_CONCEPTS_QUEUE
+   */
+  bool TryDequeue(
+    Type & element
+    /**< [IN,OUT] Reference to the dequeued element. Unchanged, if the
+                  operation was not successful. */);
+};
+} // namespace containers
+} // namespace embb
+
+#include <embb/containers/internal/bounded_mpmc_queue-inl.h>
+
+#endif  // EMBB_CONTAINERS_BOUNDED_MPMC_QUEUE_H_
@@ -0,0 +1,443 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EMBB_CONTAINERS_CONCURRENT_PRIORITY_QUEUE_H_
+#define EMBB_CONTAINERS_CONCURRENT_PRIORITY_QUEUE_H_
+
+#include <embb/base/atomic.h>
+#include <embb/base/function.h>
+#include <embb/containers/object_pool.h>
+#include <embb/containers/lock_free_tree_value_pool.h>
+#include <embb/containers/internal/epoch_reclamation.h>
+
+#include <stddef.h>
+#include <functional>
+
+// forward declaration for white-box test, used in friend declaration of
+// ConcurrentPriorityQueue class.
+namespace embb {
+namespace containers {
+namespace test {
+class PriorityQueueTest;
+} // namespace test
+} // namespace containers
+} // namespace embb
+
+namespace embb {
+namespace containers {
+namespace internal {
+template< typename Key, typename Value >
+class ConcurrentPriorityQueueNode;
+
+/**
+ * Links of a ConcurrentPriorityQueueNode above the lowest level
+ *
+ * Only a quarter of the nodes is linked into more than one level, so these
+ * links are kept apart from the nodes, in a pool of their own.
+ *
+ * \tparam Key Key type
+ * \tparam Value Value type
+ */
+template< typename Key, typename Value >
+class ConcurrentPriorityQueueTower {
+ public:
+  /**
+   * Maximum number of levels of a node, including the lowest one
+   */
+  static const int MAX_HEIGHT = 10;
+
+  /**
+   * The links to the successors on the levels 1 to <tt>MAX_HEIGHT - 1</tt>
+   */
+  embb::base::Atomic< ConcurrentPriorityQueueNode< Key, Value >* >
+    links[MAX_HEIGHT - 1];
+};
+
+/**
+ * Node of a ConcurrentPriorityQueue
+ *
+ * The lowest bit of the link on the lowest level marks the successor of the
+ * node as deleted. Key and value are not changed while the node is in the
+ * queue.
+ *
+ * \tparam Key Key type
+ * \tparam Value Value type
+ */
+template< typename Key, typename Value >
+class ConcurrentPriorityQueueNode {
+ public:
+  typedef ConcurrentPriorityQueueTower< Key, Value > Tower;
+
+  /**
+   * The key of the node
+   */
+  Key key;
+
+  /**
+   * The value stored with the key
+   */
+  Value value;
+
+  /**
+   * Number of levels the node is linked into
+   */
+  int height;
+
+  /**
+   * Set until the node is linked into all of its levels. Nodes behind a node
+   * that is still being inserted are not reused.
+   */
+  embb::base::Atomic<bool> inserting;
+
+  /**
+   * The link to the successor on the lowest level
+   */
+  embb::base::Atomic< ConcurrentPriorityQueueNode< Key, Value >* > next;
+
+  /**
+   * The links on the levels above, \c NULL if the node has only one level
+   */
+  Tower* tower;
+
+  /**
+   * If the node is the first of a batch of deleted nodes retired together,
+   * the node following the last one of the batch
+   */
+  ConcurrentPriorityQueueNode< Key, Value >* retired_until;
+
+  /**
+   * Creates a node holding the given key and value
+   */
+  ConcurrentPriorityQueueNode(
+    Key const & key,
+    /**< [IN] The key */
+    Value const & value,
+    /**< [IN] The value */
+    int height,
+    /**< [IN] The number of levels */
+    Tower* tower
+    /**< [IN] The links above the lowest level, or \c NULL if \c height is
+              one */);
+};
+} // namespace internal
+
+/**
+ * Lock-free priority queue based on a skip list
+ *
+ * Holds elements ordered by their keys. Insertions are spread over the whole
+ * skip list, deletions take the first element. Deleting an element only
+ * marks the link of its predecessor on the lowest level, so the deleted
+ * elements form a prefix of the list. Only once this prefix has grown long
+ * enough, one of the deleting threads unlinks it with a single
+ * compare-and-swap, instead of every deletion updating the first links of
+ * the skip list. Equal keys are deleted in no particular order.
+ *
+ * The queue is bounded: nodes are taken from object pools that are allocated
+ * at construction, so the queue does not allocate memory afterwards. Deleted
+ * nodes are reclaimed batch-wise using epochs.
+ *
+ * For a description of the algorithm, see Jonatan Lind&eacute;n and Bengt
+ * Jonsson. "A Skiplist-Based Concurrent Priority Queue with Minimal Memory
+ * Contention." OPODIS 2013.
+ *
+ * \ingroup CPP_CONTAINERS_QUEUES
+ *
+ * \see PriorityMultiQueue
+ *
+ * \tparam Key Type of the keys. Must be copyable.
+ * \tparam Value Type of the values. Must be copyable.
+ * \tparam Compare Ordering of the keys. Elements whose keys come first are
+ *         deleted first.
+ * \tparam ValuePool Type of the value pools underlying the object pools of
+ *         the nodes
+ */
+template< typename Key, typename Value,
+  typename Compare = std::less<Key>,
+  typename ValuePool = embb::containers::LockFreeTreeValuePool< bool, false > >
+class ConcurrentPriorityQueue {
+ private:
+  /**
+   * PriorityQueueTest walks the levels of the queue after deletions that
+   * overlapped with insertions, so declaring it as friend.
+   */
+  friend class embb::containers::test::PriorityQueueTest;
+
+  /**
+   * Node type of the skip list
+   */
+  typedef internal::ConcurrentPriorityQueueNode< Key, Value > Node;
+
+  /**
+   * Links of a node above the lowest level
+   */
+  typedef typename Node::Tower Tower;
+
+  /**
+   * Maximum number of levels
+   */
+  static const int MAX_HEIGHT = Tower::MAX_HEIGHT;
+
+  /**
+   * Number of deleted nodes a deletion has to pass before it unlinks them
+   */
+  static const int BOUND_OFFSET = 32;
+
+  /**
+   * Number of batches a thread may retire per epoch. A thread retires at
+   * most one batch per deletion, and about every \c BOUND_OFFSET deletions
+   * overall, so waiting for the next epoch in between is rare. This bounds
+   * the retired batches independently of the number of threads accessing
+   * the reclamation, whose bound is meant for single nodes.
+   */
+  static const int RETIRED_BATCHES_PER_EPOCH = 1;
+
+  /**
+   * Distance of the random states of two threads, keeps them on separate
+   * cache lines
+   */
+  static const unsigned int RANDOM_STRIDE =
+    EMBB_PLATFORM_CACHE_LINE_SIZE / sizeof(unsigned int);
+
+  /**
+   * The capacity of the queue. It is guaranteed that the queue can hold at
+   * least as many elements, maybe more.
+   */
+  size_t capacity;
+
+  /**
+   * Number of levels in use, enough for every node of the pool
+   */
+  int height;
+
+  /**
+   * The ordering of the keys
+   */
+  Compare compare;
+
+  /**
+   * Links to the first node of each level. The lowest bit of the link on the
+   * lowest level marks the first node as deleted.
+   */
+  embb::base::Atomic< Node* > head[MAX_HEIGHT];
+
+  /**
+   * Number of threads with a random state
+   */
+  unsigned int random_count;
+
+  /**
+   * States of the random number generators choosing the heights of new
+   * nodes, one every \c RANDOM_STRIDE entries
+   */
+  unsigned int* random_states;
+
+  /**
+   * If set, insertions yield before linking their node into an upper level.
+   * Only set by tests, so that deletions pass nodes still being inserted on
+   * a single core, too.
+   */
+  bool yield_while_linking;
+
+  /**
+   * Callback to the method that is called by the reclamation if a batch of
+   * nodes is not accessed anymore, i.e., can safely be reused.
+   */
+  embb::base::Function< void, Node* > delete_pointer_callback;
+
+  /**
+   * The pool of the nodes.
+   *
+   * The pools have to be declared before the reclamation object, which might
+   * return nodes to them in its destructor.
+   */
+  ObjectPool< Node, ValuePool > node_pool;
+
+  /**
+   * The pool of the links above the lowest level
+   */
+  ObjectPool< Tower, ValuePool > tower_pool;
+
+  /**
+   * The epoch reclamation object, used for memory management. Each retired
+   * object is the first node of a batch of deleted nodes.
+   */
+  internal::EpochReclamation< Node* > reclamation;
+
+  /**
+   * The callback function, used to cleanup batches of nodes no longer
+   * accessed.
+   * \see delete_pointer_callback
+   */
+  void DeletePointerCallback(Node* to_delete);
+
+  /**
+   * Returns a node and its links to the pools
+   */
+  void FreeNode(Node* node);
+
+  /**
+   * Returns \c node with the deletion mark set
+   */
+  static Node* Mark(Node* node);
+
+  /**
+   * Returns \c node with the deletion mark cleared
+   */
+  static Node* Unmark(Node* node);
+
+  /**
+   * Returns whether the deletion mark of \c node is set
+   */
+  static bool IsMarked(Node* node);
+
+  /**
+   * Returns the link to the successor of \c node on the given level, or the
+   * head of the level if \c node is \c NULL
+   */
+  embb::base::Atomic< Node* >& Link(
+    Node* node,
+    /**< [IN] The node, or \c NULL for the head */
+    int level
+    /**< [IN] The level, less than the height of \c node */);
+
+  /**
+   * Draws the height of a new node, each level with a quarter of the
+   * probability of the one below
+   */
+  int RandomHeight();
+
+  /**
+   * Searches the position of a key on every level, skipping deleted nodes.
+   * Has to be called inside a critical section.
+   *
+   * \return The last deleted node passed on the lowest level, or \c NULL
+   */
+  Node* Search(
+    Key const & key,
+    /**< [IN] Key to search for */
+    Node** predecessors,
+    /**< [OUT] Last node before the position per level, \c NULL for the
+               head */
+    Node** successors
+    /**< [OUT] First node after the position per level, or \c NULL */);
+
+  /**
+   * Follows the upper levels as long as the nodes are followed by deleted
+   * nodes. Has to be called inside a critical section.
+   *
+   * \return The last node found this way, which is deleted, or \c NULL
+   */
+  Node* SkipDeleted();
+
+  /**
+   * Lets the heads of the upper levels skip the deleted nodes. Has to be
+   * called inside a critical section.
+   */
+  void Restructure();
+
+  /**
+   * Disable copy construction and assignment.
+   */
+  ConcurrentPriorityQueue(const ConcurrentPriorityQueue&);
+  ConcurrentPriorityQueue& operator=(const ConcurrentPriorityQueue&);
+
+ public:
+  /**
+   * Creates a priority queue with the specified capacity.
+   *
+   * \memory
+   * Let \c t be the maximum number of threads and <tt>n = capacity +
+   * (3*t + 1) * (32 + 2*t) + t</tt>. Deleted nodes are unlinked in batches
+   * of at most <tt>32 + 2*t</tt> nodes and retired as a whole. Each thread
+   * has at most three retired batches not eligible for reuse yet, one per
+   * epoch, and one batch may be deleted but not unlinked yet. Allocates \c n
+   * nodes holding a key, a value, and one link, and <tt>n/2 + 1</tt> sets of
+   * nine further links for the nodes higher than one level. Additionally
+   * allocates one cache line per thread for drawing the heights, and the
+   * retired lists of the epoch reclamation, one pointer per batch.
+   *
+   * \notthreadsafe
+   */
+  explicit ConcurrentPriorityQueue(
+    size_t capacity
+    /**< [IN] Capacity of the queue */);
+
+  /**
+   * Destroys the priority queue.
+   *
+   * \notthreadsafe
+   */
+  ~ConcurrentPriorityQueue();
+
+  /**
+   * Returns the capacity of the queue.
+   *
+   * \return Number of elements the queue can hold at least.
+   *
+   * \waitfree
+   */
+  size_t GetCapacity();
+
+  /**
+   * Tries to insert an element with the given key.
+   *
+   * \return \c true if the element was inserted, \c false if the queue is
+   * full.
+   *
+   * \note The queue can only be guaranteed to hold \c capacity elements if
+   * no insertion is suspended for long while linking its node into the upper
+   * levels, as deleted nodes behind such a node are not reused.
+   *
+   * \lockfree
+   */
+  bool TryInsert(
+    Key const & key,
+    /**< [IN] Key of the element */
+    Value const & value
+    /**< [IN] Value of the element */);
+
+  /**
+   * Tries to delete an element with the smallest key.
+   *
+   * \return \c true if an element was deleted, \c false if the queue is
+   * empty.
+   *
+   * \lockfree
+   */
+  bool TryDeleteMin(
+    Key & key,
+    /**< [OUT] Key of the deleted element. Unchanged, if the operation was
+                not successful. */
+    Value & value
+    /**< [OUT] Value of the deleted element. Unchanged, if the operation was
+                not successful. */);
+};
+} // namespace containers
+} // namespace embb
+
+#include <embb/containers/internal/concurrent_priority_queue-inl.h>
+
+#endif  // EMBB_CONTAINERS_CONCURRENT_PRIORITY_QUEUE_H_
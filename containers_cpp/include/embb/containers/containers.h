@@ -33,10 +33,18 @@
  * Concurrent data structures, mainly containers
  */
 
+#include <embb/containers/bounded_mpmc_queue.h>
+#include <embb/containers/concurrent_priority_queue.h>
+#include <embb/containers/lock_free_bitmap_value_pool.h>
+#include <embb/containers/lock_free_elimination_stack.h>
+#include <embb/containers/lock_free_hash_map.h>
 #include <embb/containers/lock_free_mpmc_queue.h>
+#include <embb/containers/lock_free_skip_list_map.h>
 #include <embb/containers/lock_free_stack.h>
 #include <embb/containers/lock_free_tree_value_pool.h>
+#include <embb/containers/multi_queue.h>
 #include <embb/containers/object_pool.h>
+#include <embb/containers/thread_caching_value_pool.h>
 #include <embb/containers/wait_free_array_value_pool.h>
 #include <embb/containers/wait_free_spsc_queue.h>
 
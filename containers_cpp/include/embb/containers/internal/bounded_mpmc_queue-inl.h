@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EMBB_CONTAINERS_INTERNAL_BOUNDED_MPMC_QUEUE_INL_H_
+#define EMBB_CONTAINERS_INTERNAL_BOUNDED_MPMC_QUEUE_INL_H_
+
+#include <new>
+
+/*
+ * The following algorithm is described in:
+ * Dmitry Vyukov. "Bounded MPMC queue."
+ * http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+ *
+ * A cell at position p is free for the enqueue at p if its sequence number is
+ * p, and holds the element for the dequeue at p if it is p+1. The dequeue
+ * hands the cell to the enqueue one round later by setting it to p+capacity.
+ */
+
+namespace embb {
+namespace containers {
+namespace internal {
+template< typename Type >
+BoundedMPMCQueueCell< Type >::BoundedMPMCQueueCell(size_t sequence)
+  : sequence(sequence), element() {
+}
+} // namespace internal
+
+template< typename Type, class Allocator >
+size_t BoundedMPMCQueue< Type, Allocator >::
+AlignCapacityToPowerOfTwo(size_t capacity) {
+  // with a single cell, an enqueue could not tell a full cell from a free one
+  size_t result = 2;
+  while (result < capacity) result <<= 1;
+  return result;
+}
+
+template< typename Type, class Allocator >
+BoundedMPMCQueue< Type, Allocator >::BoundedMPMCQueue(size_t capacity)
+  : capacity(AlignCapacityToPowerOfTwo(capacity)),
+    mask(this->capacity - 1),
+    tail_index(0),
+    head_index(0) {
+  cells = allocator.allocate(this->capacity);
+  for (size_t i = 0; i < this->capacity; ++i) {
+    new (&cells[i]) Cell(i);
+  }
+}
+
+template< typename Type, class Allocator >
+BoundedMPMCQueue< Type, Allocator >::~BoundedMPMCQueue() {
+  for (size_t i = 0; i < capacity; ++i) {
+    cells[i].~Cell();
+  }
+  allocator.deallocate(cells, capacity);
+}
+
+template< typename Type, class Allocator >
+size_t BoundedMPMCQueue< Type, Allocator >::GetCapacity() {
+  return capacity;
+}
+
+template< typename Type, class Allocator >
+bool BoundedMPMCQueue< Type, Allocator >::TryEnqueue(Type const & element) {
+  size_t position = tail_index.Load();
+  Cell* cell;
+  for (;;) {
+    cell = &cells[position & mask];
+    size_t sequence = cell->sequence.Load();
+    if (sequence == position) {
+      // the cell is free, claim it
+      if (tail_index.CompareAndSwap(position, position + 1))
+        break;
+      // CompareAndSwap reloaded position
+    } else if (static_cast<ptrdiff_t>(sequence - position) < 0) {
+      // the cell still holds the element of the previous round
+      return false;
+    } else {
+      // another producer claimed the cell first
+      position = tail_index.Load();
+    }
+  }
+  cell->element = element;
+  cell->sequence.Store(position + 1);
+  return true;
+}
+
+template< typename Type, class Allocator >
+bool BoundedMPMCQueue< Type, Allocator >::TryDequeue(Type & element) {
+  size_t position = head_index.Load();
+  Cell* cell;
+  for (;;) {
+    cell = &cells[position & mask];
+    size_t sequence = cell->sequence.Load();
+    if (sequence == position + 1) {
+      // the cell holds an element, claim it
+      if (head_index.CompareAndSwap(position, position + 1))
+        break;
+    } else if (static_cast<ptrdiff_t>(sequence - (position + 1)) < 0) {
+      // the element of this round has not been enqueued yet
+      return false;
+    } else {
+      // another consumer claimed the cell first
+      position = head_index.Load();
+    }
+  }
+  element = cell->element;
+  cell->sequence.Store(position + capacity);
+  return true;
+}
+} // namespace containers
+} // namespace embb
+
+#endif  // EMBB_CONTAINERS_INTERNAL_BOUNDED_MPMC_QUEUE_INL_H_
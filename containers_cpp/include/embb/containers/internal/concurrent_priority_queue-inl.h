@@ -0,0 +1,428 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EMBB_CONTAINERS_INTERNAL_CONCURRENT_PRIORITY_QUEUE_INL_H_
+#define EMBB_CONTAINERS_INTERNAL_CONCURRENT_PRIORITY_QUEUE_INL_H_
+
+#include <embb/base/internal/config.h>
+#include <embb/base/c/internal/thread_index.h>
+#include <embb/base/memory_allocation.h>
+#include <embb/base/thread.h>
+
+/*
+ * The following algorithm is described in:
+ * Jonatan Linden and Bengt Jonsson. "A Skiplist-Based Concurrent Priority
+ * Queue with Minimal Memory Contention." OPODIS 2013.
+ *
+ * A node is deleted once the link of its predecessor on the lowest level is
+ * marked. A deletion walks the lowest level from the head and marks the
+ * first unmarked link it finds, so the deleted nodes always form a prefix of
+ * the list. Insertions skip this prefix, they link a node behind the last
+ * deleted node at the earliest. A deletion that passed at least BOUND_OFFSET
+ * deleted nodes swings the head of the lowest level to the last of them,
+ * lets the heads of the upper levels skip the prefix, and retires the
+ * unlinked nodes as one batch. Only the first node of a batch is handed to
+ * the reclamation, the others follow on the lowest level, where their links
+ * do not change anymore.
+ *
+ * A node still being linked into its upper levels may be linked to nodes
+ * behind it that get deleted meanwhile. Therefore, the batch ends at the
+ * first such node the deletion passed, and the nodes behind it are unlinked
+ * by a later deletion. If the insertion is delayed, the prefix behind the
+ * node keeps growing. A deletion that passed such a node cannot unlink the
+ * nodes behind it anyway, so it skips over the prefix on the upper levels
+ * instead of walking all of it on the lowest level.
+ */
+
+namespace embb {
+namespace containers {
+namespace internal {
+template< typename Key, typename Value >
+ConcurrentPriorityQueueNode< Key, Value >::ConcurrentPriorityQueueNode(
+  Key const & key, Value const & value, int height, Tower* tower)
+  : key(key), value(value), height(height), inserting(true), next(NULL),
+    tower(tower), retired_until(NULL) {
+}
+} // namespace internal
+
+template< typename Key, typename Value, typename Compare,
+  typename ValuePool >
+void ConcurrentPriorityQueue< Key, Value, Compare, ValuePool >::
+DeletePointerCallback(Node* to_delete) {
+  Node* end = to_delete->retired_until;
+  while (to_delete != end) {
+    Node* next = Unmark(to_delete->next);
+    FreeNode(to_delete);
+    to_delete = next;
+  }
+}
+
+template< typename Key, typename Value, typename Compare,
+  typename ValuePool >
+void ConcurrentPriorityQueue< Key, Value, Compare, ValuePool >::FreeNode(
+  Node* node) {
+  if (node->tower != NULL) {
+    tower_pool.Free(node->tower);
+  }
+  node_pool.Free(node);
+}
+
+template< typename Key, typename Value, typename Compare,
+  typename ValuePool >
+typename ConcurrentPriorityQueue< Key, Value, Compare, ValuePool >::Node*
+ConcurrentPriorityQueue< Key, Value, Compare, ValuePool >::Mark(Node* node) {
+  return reinterpret_cast<Node*>(reinterpret_cast<size_t>(node) | 1);
+}
+
+template< typename Key, typename Value, typename Compare,
+  typename ValuePool >
+typename ConcurrentPriorityQueue< Key, Value, Compare, ValuePool >::Node*
+ConcurrentPriorityQueue< Key, Value, Compare, ValuePool >::Unmark(
+  Node* node) {
+  return reinterpret_cast<Node*>(
+    reinterpret_cast<size_t>(node) & ~static_cast<size_t>(1));
+}
+
+template< typename Key, typename Value, typename Compare,
+  typename ValuePool >
+bool ConcurrentPriorityQueue< Key, Value, Compare, ValuePool >::IsMarked(
+  Node* node) {
+  return (reinterpret_cast<size_t>(node) & 1) != 0;
+}
+
+template< typename Key, typename Value, typename Compare,
+  typename ValuePool >
+ConcurrentPriorityQueue< Key, Value, Compare, ValuePool >::
+ConcurrentPriorityQueue(size_t capacity) :
+  capacity(capacity),
+  height(1),
+  random_count(embb::base::Thread::GetThreadsMaxCount()),
+  random_states(NULL),
+  yield_while_linking(false),
+// Disable "this is used in base member initializer" warning.
+// We explicitly want this.
+#ifdef EMBB_PLATFORM_COMPILER_MSVC
+#pragma warning(push)
+#pragma warning(disable:4355)
+#endif
+  delete_pointer_callback(*this,
+    &ConcurrentPriorityQueue::DeletePointerCallback),
+#ifdef EMBB_PLATFORM_COMPILER_MSVC
+#pragma warning(pop)
+#endif
+  // Node pool, size with respect to the deleted nodes not unlinked yet, the
+  // batches of retired nodes not eligible for reuse, and one node per thread
+  // allocated for an insertion not yet linked into the queue. A deletion
+  // passes at most BOUND_OFFSET + t deleted nodes before it unlinks them,
+  // and other threads may delete t more meanwhile. The number of retired
+  // batches is bounded by the retired lists of the reclamation, which hold
+  // RETIRED_BATCHES_PER_EPOCH batches per thread and epoch.
+  node_pool(
+    (internal::EpochReclamation< Node* >::
+      ComputeMaximumRetiredObjectCount(1, -1, RETIRED_BATCHES_PER_EPOCH) +
+      1) *
+    (BOUND_OFFSET + 2 * embb::base::Thread::GetThreadsMaxCount()) +
+    embb::base::Thread::GetThreadsMaxCount() +
+    capacity),
+  // A quarter of the nodes is expected to be higher than one level, the
+  // pool holds links for twice as many. If it is exhausted, new nodes are
+  // linked into the lowest level only.
+  tower_pool(node_pool.GetCapacity() / 2 + 1),
+  reclamation(delete_pointer_callback, NULL, 1, -1,
+    RETIRED_BATCHES_PER_EPOCH) {
+  // Enough levels to find a key in logarithmic time, even if the queue
+  // holds an element in every node, which is more than its capacity
+  while (height < MAX_HEIGHT &&
+    (static_cast<size_t>(1) << (2 * height)) < node_pool.GetCapacity()) {
+    ++height;
+  }
+  for (int level = 0; level != MAX_HEIGHT; ++level) {
+    head[level] = NULL;
+  }
+  random_states = static_cast<unsigned int*>(
+    embb::base::Allocation::AllocateCacheAligned(
+    sizeof(unsigned int) * RANDOM_STRIDE * random_count));
+  for (unsigned int thread = 0; thread != random_count; ++thread) {
+    // xorshift needs a nonzero state
+    random_states[thread * RANDOM_STRIDE] = thread * 2654435761u + 1;
+  }
+}
+
+template< typename Key, typename Value, typename Compare,
+  typename ValuePool >
+ConcurrentPriorityQueue< Key, Value, Compare, ValuePool >::
+~ConcurrentPriorityQueue() {
+  // The nodes still linked, deleted or not, are returned to the pools here,
+  // the retired ones by the reclamation
+  Node* node = Unmark(head[0]);
+  while (node != NULL) {
+    Node* next = Unmark(node->next);
+    FreeNode(node);
+    node = next;
+  }
+  embb::base::Allocation::FreeAligned(random_states);
+}
+
+template< typename Key, typename Value, typename Compare,
+  typename ValuePool >
+size_t ConcurrentPriorityQueue< Key, Value, Compare, ValuePool >::
+GetCapacity() {
+  return capacity;
+}
+
+template< typename Key, typename Value, typename Compare,
+  typename ValuePool >
+embb::base::Atomic< typename ConcurrentPriorityQueue< Key, Value, Compare,
+  ValuePool >::Node* >&
+ConcurrentPriorityQueue< Key, Value, Compare, ValuePool >::Link(
+  Node* node, int level) {
+  if (node == NULL) {
+    return head[level];
+  }
+  return level == 0 ? node->next : node->tower->links[level - 1];
+}
+
+template< typename Key, typename Value, typename Compare,
+  typename ValuePool >
+int ConcurrentPriorityQueue< Key, Value, Compare, ValuePool >::
+RandomHeight() {
+  unsigned int thread_index;
+  if (embb_internal_thread_index(&thread_index) != EMBB_SUCCESS ||
+    thread_index >= random_count) {
+    return 1;
+  }
+  // xorshift, only the calling thread uses its state
+  unsigned int& random = random_states[thread_index * RANDOM_STRIDE];
+  random ^= random << 13;
+  random ^= random >> 17;
+  random ^= random << 5;
+  // One more level for every two trailing one bits. Compared to one level
+  // per bit, searches take as many steps, but nodes need fewer links.
+  int result = 1;
+  for (unsigned int bits = random; result < height && (bits & 3) == 3;
+    bits >>= 2) {
+    ++result;
+  }
+  return result;
+}
+
+template< typename Key, typename Value, typename Compare,
+  typename ValuePool >
+typename ConcurrentPriorityQueue< Key, Value, Compare, ValuePool >::Node*
+ConcurrentPriorityQueue< Key, Value, Compare, ValuePool >::Search(
+  Key const & key, Node** predecessors, Node** successors) {
+  Node* predecessor = NULL;
+  Node* last_deleted = NULL;
+  for (int level = height - 1; level >= 0; --level) {
+    Node* current = Unmark(Link(predecessor, level));
+    bool deleted = IsMarked(Link(predecessor, 0));
+    // Skip the nodes with smaller keys and the deleted prefix. A node whose
+    // successor is deleted is deleted itself. On the lowest level, the
+    // successor of a marked link is deleted as well.
+    while (current != NULL && (compare(current->key, key) ||
+      IsMarked(current->next) || (level == 0 && deleted))) {
+      if (level == 0 && deleted) {
+        last_deleted = current;
+      }
+      predecessor = current;
+      current = Unmark(Link(predecessor, level));
+      deleted = IsMarked(predecessor->next);
+    }
+    predecessors[level] = predecessor;
+    successors[level] = current;
+  }
+  return last_deleted;
+}
+
+template< typename Key, typename Value, typename Compare,
+  typename ValuePool >
+typename ConcurrentPriorityQueue< Key, Value, Compare, ValuePool >::Node*
+ConcurrentPriorityQueue< Key, Value, Compare, ValuePool >::SkipDeleted() {
+  Node* predecessor = NULL;
+  for (int level = height - 1; level > 0; --level) {
+    Node* current = Link(predecessor, level);
+    while (current != NULL && IsMarked(current->next)) {
+      predecessor = current;
+      current = Link(predecessor, level);
+    }
+  }
+  return predecessor;
+}
+
+template< typename Key, typename Value, typename Compare,
+  typename ValuePool >
+void ConcurrentPriorityQueue< Key, Value, Compare, ValuePool >::
+Restructure() {
+  Node* predecessor = NULL;
+  int level = height - 1;
+  while (level > 0) {
+    Node* first = head[level];
+    if (first == NULL || !IsMarked(first->next)) {
+      // The first node of this level is not followed by deleted nodes
+      --level;
+      continue;
+    }
+    Node* current = Link(predecessor, level);
+    while (current != NULL && IsMarked(current->next)) {
+      predecessor = current;
+      current = Link(predecessor, level);
+    }
+    // Retry this level if an insertion changed the head meanwhile
+    if (head[level].CompareAndSwap(first, current)) {
+      --level;
+    }
+  }
+}
+
+template< typename Key, typename Value, typename Compare,
+  typename ValuePool >
+bool ConcurrentPriorityQueue< Key, Value, Compare, ValuePool >::TryInsert(
+  Key const & key, Value const & value) {
+  Node* predecessors[MAX_HEIGHT];
+  Node* successors[MAX_HEIGHT];
+  int node_height = RandomHeight();
+  Tower* tower = NULL;
+  if (node_height > 1) {
+    tower = tower_pool.Allocate();
+    if (tower == NULL) {
+      node_height = 1;
+    }
+  }
+  Node* node = node_pool.Allocate(key, value, node_height, tower);
+  // Queue full, cannot insert
+  if (node == NULL) {
+    if (tower != NULL) {
+      tower_pool.Free(tower);
+    }
+    return false;
+  }
+
+  reclamation.EnterCriticalSection();
+  Node* last_deleted;
+  for (;;) {
+    last_deleted = Search(key, predecessors, successors);
+    node->next = successors[0];
+    Node* expected = successors[0];
+    if (Link(predecessors[0], 0).CompareAndSwap(expected, node)) {
+      break;
+    }
+  }
+  // The element is in the queue, the upper levels only speed up searches.
+  // Stop as soon as the node or its successor is deleted.
+  for (int level = 1; level < node_height;) {
+    Node* successor = successors[level];
+    Link(node, level) = successor;
+    if (IsMarked(node->next) ||
+      (successor != NULL && IsMarked(successor->next)) ||
+      (successor != NULL && successor == last_deleted)) {
+      break;
+    }
+    if (yield_while_linking) {
+      embb::base::Thread::CurrentYield();
+    }
+    if (Link(predecessors[level], level).CompareAndSwap(successor, node)) {
+      ++level;
+    } else {
+      last_deleted = Search(key, predecessors, successors);
+      if (successors[0] != node) {
+        break;
+      }
+    }
+  }
+  node->inserting = false;
+  reclamation.LeaveCriticalSection();
+  return true;
+}
+
+template< typename Key, typename Value, typename Compare,
+  typename ValuePool >
+bool ConcurrentPriorityQueue< Key, Value, Compare, ValuePool >::TryDeleteMin(
+  Key & key, Value & value) {
+  reclamation.EnterCriticalSection();
+  Node* observed_head = head[0];
+  Node* new_head = NULL;
+  Node* current = NULL;
+  int offset = 0;
+  bool skipped = false;
+  for (;;) {
+    Node* next = Link(current, 0);
+    if (Unmark(next) == NULL) {
+      // Every node is deleted
+      reclamation.LeaveCriticalSection();
+      return false;
+    }
+    // The batch must not reach beyond a node still being inserted
+    if (new_head == NULL && current != NULL && current->inserting) {
+      new_head = current;
+    }
+    // Mark the link to delete its successor, unless another deletion did
+    bool deleted = false;
+    while (!IsMarked(next)) {
+      if (Link(current, 0).CompareAndSwap(next, Mark(next))) {
+        deleted = true;
+        break;
+      }
+    }
+    ++offset;
+    current = Unmark(next);
+    if (deleted) {
+      break;
+    }
+    // Behind a node still being inserted, the rest of the walk only looks
+    // for the end of the prefix
+    if (new_head != NULL && !skipped && offset >= BOUND_OFFSET) {
+      skipped = true;
+      Node* last_skipped = SkipDeleted();
+      if (last_skipped != NULL) {
+        current = last_skipped;
+      }
+    }
+  }
+  key = current->key;
+  value = current->value;
+
+  if (offset >= BOUND_OFFSET) {
+    // Unlink the deleted nodes up to the one deleted here, or up to the
+    // first node still being inserted
+    if (new_head == NULL) {
+      new_head = current;
+    }
+    if (head[0].CompareAndSwap(observed_head, Mark(new_head))) {
+      Restructure();
+      Node* first = Unmark(observed_head);
+      if (first != new_head) {
+        first->retired_until = new_head;
+        reclamation.EnqueueForDeletion(first);
+      }
+    }
+  }
+  reclamation.LeaveCriticalSection();
+  return true;
+}
+} // namespace containers
+} // namespace embb
+
+#endif  // EMBB_CONTAINERS_INTERNAL_CONCURRENT_PRIORITY_QUEUE_INL_H_
@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EMBB_CONTAINERS_INTERNAL_EPOCH_RECLAMATION_INL_H_
+#define EMBB_CONTAINERS_INTERNAL_EPOCH_RECLAMATION_INL_H_
+
+#include <embb/base/c/internal/thread_index.h>
+#include <embb/base/exceptions.h>
+
+#include <cassert>
+#include <new>
+
+namespace embb {
+namespace containers {
+namespace internal {
+template< typename GuardType >
+size_t EpochReclamation< GuardType >::ComputeMaximumRetiredObjectCount(
+  size_t guardsPerThread, int accessors, int retiredListSize) {
+  unsigned int accessorCount = (accessors == -1 ?
+    embb::base::Thread::GetThreadsMaxCount() :
+    accessors);
+  size_t listSize = (retiredListSize == -1 ?
+    guardsPerThread * accessorCount :
+    static_cast<size_t>(retiredListSize));
+
+  return static_cast<size_t>(RETIRED_LIST_COUNT *
+    listSize * accessorCount);
+}
+
+template< typename GuardType >
+EpochReclamation< GuardType >::EpochReclamation(
+  embb::base::Function<void, GuardType> free_guard_callback,
+  GuardType undefined_guard, int guards_per_thread, int accessors,
+  int retired_list_size) :
+  max_accessors_count_(accessors < 0 ?
+    embb::base::Thread::GetThreadsMaxCount() : accessors),
+  undefined_guard_(undefined_guard),
+  retired_list_size_(retired_list_size < 0 ?
+    guards_per_thread * max_accessors_count_ :
+    static_cast<unsigned int>(retired_list_size)),
+  release_object_callback_(free_guard_callback),
+  thread_id_mapping_size_(embb::base::Thread::GetThreadsMaxCount()),
+  next_thread_id_(0),
+  global_epoch_(0),
+  thread_state_size_(
+    ((sizeof(ThreadState) + EMBB_PLATFORM_CACHE_LINE_SIZE - 1) /
+    EMBB_PLATFORM_CACHE_LINE_SIZE) * EMBB_PLATFORM_CACHE_LINE_SIZE) {
+  thread_id_mapping_ = static_cast<embb::base::Atomic<int>*>(
+    embb::base::Allocation::Allocate(sizeof(embb::base::Atomic<int>)
+    *thread_id_mapping_size_));
+
+  for (unsigned int i = 0; i != thread_id_mapping_size_; ++i) {
+    //in-place new for each cell
+    new (&thread_id_mapping_[i]) embb::base::Atomic < int >(-1);
+  }
+
+  thread_states_ = static_cast<char*>(
+    embb::base::Allocation::AllocateCacheAligned(
+    thread_state_size_ * max_accessors_count_));
+
+  for (unsigned int i = 0; i != max_accessors_count_; ++i) {
+    ThreadState* state = new (thread_states_ + i * thread_state_size_)
+      ThreadState;
+    state->announced_epoch.Store(0);
+    for (unsigned int list = 0; list != RETIRED_LIST_COUNT; ++list) {
+      state->retired_epochs[list] = 0;
+      state->retired_counts[list] = 0;
+    }
+  }
+
+  const unsigned int count_ret_elements =
+    RETIRED_LIST_COUNT * retired_list_size_ * max_accessors_count_;
+
+  retired_lists_ = static_cast<GuardType*>(
+    embb::base::Allocation::Allocate(sizeof(GuardType) * count_ret_elements));
+
+  for (unsigned int i = 0; i != count_ret_elements; ++i) {
+    //in-place new for each cell
+    new (&retired_lists_[i]) GuardType(undefined_guard);
+  }
+}
+
+template< typename GuardType >
+EpochReclamation< GuardType >::~EpochReclamation() {
+  // Release all retired objects. As for HazardPointer, the data structure
+  // using this class has to be destructed after this object.
+  for (unsigned int i = 0; i != max_accessors_count_; ++i) {
+    for (unsigned int list = 0; list != RETIRED_LIST_COUNT; ++list) {
+      ReleaseRetiredList(i, list);
+    }
+    GetThreadState(i).~ThreadState();
+  }
+
+  const unsigned int count_ret_elements =
+    RETIRED_LIST_COUNT * retired_list_size_ * max_accessors_count_;
+
+  for (unsigned int i = 0; i != count_ret_elements; ++i) {
+    retired_lists_[i].~GuardType();
+  }
+
+  embb::base::Allocation::Free(retired_lists_);
+
+  embb::base::Allocation::FreeAligned(thread_states_);
+
+  for (unsigned int i = 0; i != thread_id_mapping_size_; ++i) {
+    thread_id_mapping_[i].~Atomic();
+  }
+
+  embb::base::Allocation::Free(thread_id_mapping_);
+}
+
+template< typename GuardType >
+typename EpochReclamation< GuardType >::ThreadState &
+EpochReclamation< GuardType >::GetThreadState(unsigned int thread_id) {
+  return *reinterpret_cast<ThreadState*>(
+    thread_states_ + thread_id * thread_state_size_);
+}
+
+// Visual Studio is complaining that the return in the last line of this
+// function is not reachable, see HazardPointer.
+#ifdef EMBB_PLATFORM_COMPILER_MSVC
+#pragma warning(push)
+#pragma warning(disable:4702)
+#endif
+template< typename GuardType >
+unsigned int EpochReclamation< GuardType >::GetObjectLocalThreadIndex() {
+  unsigned int embb_thread_index;
+
+  int return_val = embb_internal_thread_index(&embb_thread_index);
+
+  if (return_val != EMBB_SUCCESS) {
+    EMBB_THROW(embb::base::ErrorException, "Could not get thread id");
+  }
+
+  if (embb_thread_index >= thread_id_mapping_size_) {
+    EMBB_THROW(embb::base::ErrorException, "Invalid thread id");
+  }
+
+  // only the thread itself writes its mapping
+  int mapping = thread_id_mapping_[embb_thread_index].Load();
+  if (mapping != -1) {
+    return static_cast<unsigned int>(mapping);
+  }
+
+  unsigned int my_thread_id = next_thread_id_.FetchAndAdd(1);
+  if (my_thread_id < max_accessors_count_) {
+    thread_id_mapping_[embb_thread_index].Store(
+      static_cast<int>(my_thread_id));
+    return my_thread_id;
+  }
+
+  EMBB_THROW(embb::base::ErrorException, "Too many accessors");
+
+  return 0;
+}
+#ifdef EMBB_PLATFORM_COMPILER_MSVC
+#pragma warning(pop)
+#endif
+
+template< typename GuardType >
+unsigned int EpochReclamation< GuardType >::EpochDistance(
+  unsigned int from, unsigned int to) {
+  return (to - from) & EPOCH_MASK;
+}
+
+template< typename GuardType >
+void EpochReclamation< GuardType >::ReleaseRetiredList(
+  unsigned int thread_id, unsigned int list) {
+  ThreadState& state = GetThreadState(thread_id);
+  GuardType* retired_list = &retired_lists_[
+    (thread_id * RETIRED_LIST_COUNT + list) * retired_list_size_];
+
+  for (unsigned int i = 0; i != state.retired_counts[list]; ++i) {
+    release_object_callback_(retired_list[i]);
+    retired_list[i] = undefined_guard_;
+  }
+  state.retired_counts[list] = 0;
+}
+
+template< typename GuardType >
+void EpochReclamation< GuardType >::TryAdvanceEpoch(unsigned int epoch) {
+  unsigned int accessor_count = next_thread_id_.Load();
+  if (accessor_count > max_accessors_count_) {
+    accessor_count = max_accessors_count_;
+  }
+
+  for (unsigned int i = 0; i != accessor_count; ++i) {
+    unsigned int announced = GetThreadState(i).announced_epoch.Load();
+    // a thread inside a critical section of an older epoch might still
+    // access objects retired in the previous epoch
+    if ((announced & 1) != 0 && (announced >> 1) != epoch) {
+      return;
+    }
+  }
+
+  // fails if another thread advanced the epoch in the meantime
+  global_epoch_.CompareAndSwap(epoch, (epoch + 1) & EPOCH_MASK);
+}
+
+template< typename GuardType >
+void EpochReclamation< GuardType >::EnterCriticalSection() {
+  const unsigned int my_thread_id = GetObjectLocalThreadIndex();
+  ThreadState& state = GetThreadState(my_thread_id);
+
+  unsigned int epoch;
+  for (;;) {
+    epoch = global_epoch_.Load();
+
+    // objects retired two epochs ago cannot be accessed anymore
+    bool full = false;
+    for (unsigned int list = 0; list != RETIRED_LIST_COUNT; ++list) {
+      if (state.retired_counts[list] == 0)
+        continue;
+      if (EpochDistance(state.retired_epochs[list], epoch) >= 2) {
+        ReleaseRetiredList(my_thread_id, list);
+      } else if (state.retired_epochs[list] == epoch &&
+        state.retired_counts[list] == retired_list_size_) {
+        full = true;
+      }
+    }
+
+    // make sure there is room to retire one object in this critical section
+    if (!full)
+      break;
+
+    TryAdvanceEpoch(epoch);
+    if (global_epoch_.Load() == epoch) {
+      embb::base::Thread::CurrentYield();
+    }
+  }
+
+  state.announced_epoch.Store((epoch << 1) | 1);
+}
+
+template< typename GuardType >
+void EpochReclamation< GuardType >::LeaveCriticalSection() {
+  const unsigned int my_thread_id = GetObjectLocalThreadIndex();
+  ThreadState& state = GetThreadState(my_thread_id);
+
+  state.announced_epoch.Store(state.announced_epoch.Load() & ~1u);
+}
+
+template< typename GuardType >
+void EpochReclamation< GuardType >::Guard(int, GuardType) {
+}
+
+template< typename GuardType >
+void EpochReclamation< GuardType >::RemoveGuard(int) {
+}
+
+template< typename GuardType >
+void EpochReclamation< GuardType >::EnqueueForDeletion(GuardType to_retire) {
+  const unsigned int my_thread_id = GetObjectLocalThreadIndex();
+  ThreadState& state = GetThreadState(my_thread_id);
+
+  // the object is unlinked already, so threads entering from now on cannot
+  // reach it
+  const unsigned int epoch = global_epoch_.Load();
+
+  // Find the list of the current epoch, or an empty one. At most the lists
+  // of the current and the previous epoch are not reclaimable, so there is
+  // always one.
+  unsigned int target = RETIRED_LIST_COUNT;
+  unsigned int empty = RETIRED_LIST_COUNT;
+  for (unsigned int list = 0; list != RETIRED_LIST_COUNT; ++list) {
+    if (state.retired_counts[list] != 0 &&
+      state.retired_epochs[list] == epoch) {
+      target = list;
+    } else if (state.retired_counts[list] == 0 ||
+      EpochDistance(state.retired_epochs[list], epoch) >= 2) {
+      ReleaseRetiredList(my_thread_id, list);
+      empty = list;
+    }
+  }
+  if (target == RETIRED_LIST_COUNT) {
+    assert(empty != RETIRED_LIST_COUNT);
+    target = empty;
+    state.retired_epochs[target] = epoch;
+  }
+
+  // EnterCriticalSection made room for one object
+  assert(state.retired_counts[target] < retired_list_size_);
+  retired_lists_[(my_thread_id * RETIRED_LIST_COUNT + target) *
+    retired_list_size_ + state.retired_counts[target]] = to_retire;
+  state.retired_counts[target]++;
+}
+} // namespace internal
+} // namespace containers
+} // namespace embb
+
+#endif  // EMBB_CONTAINERS_INTERNAL_EPOCH_RECLAMATION_INL_H_
@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EMBB_CONTAINERS_INTERNAL_EPOCH_RECLAMATION_H_
+#define EMBB_CONTAINERS_INTERNAL_EPOCH_RECLAMATION_H_
+
+#include <embb/base/atomic.h>
+#include <embb/base/thread.h>
+#include <embb/base/function.h>
+#include <embb/base/memory_allocation.h>
+#include <embb/base/c/internal/config.h>
+
+namespace embb {
+namespace containers {
+namespace internal {
+/**
+ * This class contains an epoch-based reclamation scheme following
+ * publication:
+ *
+ * Keir Fraser. "Practical lock-freedom." PhD thesis, University of Cambridge,
+ * 2004. (Section 5.2.3)
+ *
+ * Instead of guarding every object before accessing it, threads announce
+ * that they access the data structure by entering a critical section, which
+ * costs a single fence per operation, no matter how many objects are
+ * accessed. Objects are retired together with the global epoch at the time
+ * of retirement. The global epoch only advances if all threads inside a
+ * critical section have announced the current epoch, so an object retired in
+ * epoch \c e cannot be accessed anymore once the global epoch reached
+ * <tt>e+2</tt>.
+ *
+ * The class provides the same interface as HazardPointer, so that data
+ * structures can be parameterized with either of them. \c Guard and
+ * \c RemoveGuard do nothing, while \c EnterCriticalSection and
+ * \c LeaveCriticalSection have to enclose every access to the data structure.
+ *
+ * As for HazardPointer, the memory consumption is fixed: Each thread has
+ * three retired lists, one per epoch that may not be reclaimable yet, each
+ * holding guardsPerThread * accessors objects, unless a smaller size is
+ * given. If the list for the current
+ * epoch is full when a thread enters a critical section, it waits until the
+ * global epoch advances. Thus, a thread that stalls inside a critical section
+ * prevents the other threads from retiring objects and makes them wait, in
+ * contrast to hazard pointers. A critical section may retire at most one
+ * object and must not be nested.
+ *
+ * \tparam GuardType the type of the retired objects. Usually the pointer type
+ *         of some object to protect.
+ */
+template< typename GuardType >
+class EpochReclamation {
+ public:
+  /**
+   * Computes the number of objects that might be retired but not released
+   * yet. The user of this class has to provide that many objects on top of
+   * the guaranteed count, see HazardPointer::ComputeMaximumRetiredObjectCount.
+   * The size sum of all retired lists is 3 * guardsPerThread * accessorCount
+   * * accessorCount, or 3 * retiredListSize * accessorCount if a list size
+   * is given.
+   *
+   * \waitfree
+   */
+  static size_t ComputeMaximumRetiredObjectCount(
+    size_t guardsPerThread,
+    /**<[IN] the count of guards per thread*/
+    int accessors = -1,
+    /**<[IN] Number of accessors. Determines, how many threads will access
+              the reclamation object. Default value -1 will allow the
+              maximum amount of threads as defined with
+              \c embb::base::Thread::GetThreadsMaxCount()*/
+    int retiredListSize = -1
+    /**<[IN] Number of objects a thread may retire per epoch. Default value
+              -1 will allow guardsPerThread * accessors objects.*/
+    );
+
+  /**
+   * Initializes the reclamation object
+   *
+   * \notthreadsafe
+   *
+   * \memory We dynamically allocate the following:
+   *
+   * (sizeof(Atomic<int>) * max_threads) + (cache_line_size * accessors) +
+   * (3*sizeof(GuardType) * retired_list_size * accessors), where
+   * \c max_threads is the maximum number of EMBB threads and
+   * \c retired_list_size is <tt>guards_per_thread * accessors</tt> by
+   * default
+   */
+  EpochReclamation(
+    embb::base::Function<void, GuardType> free_guard_callback,
+    /**<[IN] Callback to the function that shall be called when a retired
+             object can be deleted */
+    GuardType undefined_guard,
+    /**<[IN] The guard value denoting "no object"*/
+    int guards_per_thread,
+    /**<[IN] Number of guards per thread, determines the size of the retired
+             lists*/
+    int accessors = -1,
+    /**<[IN] Number of accessors. Determines, how many threads will access
+              this reclamation object. Default value -1 will allow the
+              maximum amount of threads as defined with
+              \c embb::base::Thread::GetThreadsMaxCount()*/
+    int retired_list_size = -1
+    /**<[IN] Number of objects a thread may retire per epoch. If its list is
+              full, the thread waits in EnterCriticalSection for the next
+              epoch. Default value -1 will allow guards_per_thread *
+              accessors objects.*/
+    );
+
+  /**
+   * Deallocates internal data structures. Additionally releases all objects
+   * currently held in the retired lists, using the release functor passed in
+   * the constructor.
+   *
+   * \notthreadsafe
+   */
+  ~EpochReclamation();
+
+  /**
+   * Announces that the current thread starts accessing the data structure.
+   * Releases the objects of the current thread that became safe to release.
+   * Waits for the global epoch to advance if the current retired list is
+   * full.
+   */
+  void EnterCriticalSection();
+
+  /**
+   * Announces that the current thread stopped accessing the data structure.
+   *
+   * \waitfree
+   */
+  void LeaveCriticalSection();
+
+  /**
+   * Does nothing, objects are protected by the critical section.
+   *
+   * \waitfree
+   */
+  void Guard(
+    int guard_position,
+    /**<[IN] position to place guard*/
+    GuardType to_guard
+    /**<[IN] element to guard*/
+    );
+
+  /**
+   * Does nothing, objects are protected by the critical section.
+   *
+   * \waitfree
+   */
+  void RemoveGuard(int guard_position);
+
+  /**
+   * Enqueue element for deletion. The element is added to the retired list
+   * of the current epoch and released once the global epoch advanced twice.
+   * Must be called inside a critical section.
+   *
+   * \waitfree
+   */
+  void EnqueueForDeletion(
+    GuardType to_retire
+    /**<[IN] element to logically delete*/
+    );
+
+ private:
+  /**
+   * Number of retired lists per thread
+   */
+  static const unsigned int RETIRED_LIST_COUNT = 3;
+
+  /**
+   * Epochs wrap around at this mask, as the announced epoch needs one bit
+   * for the activity flag
+   */
+  static const unsigned int EPOCH_MASK = 0x7fffffff;
+
+  /**
+   * Per thread state, placed on its own cache line(s)
+   */
+  struct ThreadState {
+    /**
+     * The epoch announced by the thread shifted left by one, the lowest bit
+     * is set while the thread is inside a critical section.
+     */
+    embb::base::Atomic<unsigned int> announced_epoch;
+
+    /**
+     * Epoch of the objects in each retired list
+     */
+    unsigned int retired_epochs[RETIRED_LIST_COUNT];
+
+    /**
+     * Number of objects in each retired list
+     */
+    unsigned int retired_counts[RETIRED_LIST_COUNT];
+  };
+
+  /**
+   * This number determines the amount of maximal accessors (threads) that
+   * will access this reclamation object, see HazardPointer.
+   */
+  unsigned int max_accessors_count_;
+
+  /**
+   * The guard value denoting "no object"
+   */
+  GuardType undefined_guard_;
+
+  /**
+   * The number of objects a single retired list can hold
+   */
+  unsigned int retired_list_size_;
+
+  /**
+   * The functor that is called to release an object.
+   */
+  embb::base::Function<void, GuardType> release_object_callback_;
+
+  /**
+   * Mapping from EMBB thread index to thread index of this object, -1 if the
+   * thread has not accessed this object yet.
+   */
+  embb::base::Atomic<int>* thread_id_mapping_;
+
+  /**
+   * The size of \c thread_id_mapping_, i.e., the maximum number of EMBB
+   * threads.
+   */
+  unsigned int thread_id_mapping_size_;
+
+  /**
+   * The thread index handed out next
+   */
+  embb::base::Atomic<unsigned int> next_thread_id_;
+
+  /**
+   * Keeps the global epoch away from the fields above
+   */
+  char padding0_[EMBB_PLATFORM_CACHE_LINE_SIZE];
+
+  /**
+   * The global epoch
+   */
+  embb::base::Atomic<unsigned int> global_epoch_;
+
+  /**
+   * Keeps the global epoch away from the fields below
+   */
+  char padding1_[EMBB_PLATFORM_CACHE_LINE_SIZE];
+
+  /**
+   * Distance of the states of two threads in bytes, a multiple of the cache
+   * line size
+   */
+  size_t thread_state_size_;
+
+  /**
+   * The states of all threads
+   */
+  char* thread_states_;
+
+  /**
+   * The retired lists of all threads, represented as single array. Each
+   * thread has RETIRED_LIST_COUNT lists of retired_list_size_ objects.
+   */
+  GuardType* retired_lists_;
+
+  /**
+   * Disable copy construction and assignment.
+   */
+  EpochReclamation(const EpochReclamation&);
+  EpochReclamation& operator=(const EpochReclamation&);
+
+  /**
+   * Returns the state of the thread with the given index.
+   */
+  ThreadState& GetThreadState(unsigned int thread_id);
+
+  /**
+   * Returns the thread index of the current thread, see HazardPointer.
+   */
+  unsigned int GetObjectLocalThreadIndex();
+
+  /**
+   * Returns the distance from epoch \c from to epoch \c to.
+   */
+  static unsigned int EpochDistance(
+    unsigned int from,
+    /**<[IN] the older epoch*/
+    unsigned int to
+    /**<[IN] the newer epoch*/
+    );
+
+  /**
+   * Releases the objects in the given retired list of the given thread.
+   */
+  void ReleaseRetiredList(
+    unsigned int thread_id,
+    /**<[IN] thread index of the list owner*/
+    unsigned int list
+    /**<[IN] index of the list*/
+    );
+
+  /**
+   * Advances the global epoch from \c epoch if all threads inside a critical
+   * section have announced it.
+   */
+  void TryAdvanceEpoch(
+    unsigned int epoch
+    /**<[IN] the global epoch observed by the caller*/
+    );
+};
+} // namespace internal
+} // namespace containers
+} // namespace embb
+
+#include "./epoch_reclamation-inl.h"
+
+#endif  // EMBB_CONTAINERS_INTERNAL_EPOCH_RECLAMATION_H_
@@ -49,23 +49,21 @@ namespace internal {
       EMBB_THROW(embb::base::ErrorException, "Could not get thread id");
     }
 
-    // iterate over the mappings array
-    for (unsigned int i = 0; i != max_accessors_count_; ++i) {
-      // end of mappings? then we need to write our id
-      if (thread_id_mapping_[i] == -1) {
-        // try to CAS the initial value with out thread id
-        int expected = -1;
-        if (thread_id_mapping_[i].CompareAndSwap(expected,
-          static_cast<int>(embb_thread_index))) {
-          //successful, return our mapping
-          return i;
-        }
-      }
+    if (embb_thread_index >= thread_id_mapping_size_) {
+      EMBB_THROW(embb::base::ErrorException, "Invalid thread id");
+    }
 
-      if (thread_id_mapping_[i] == static_cast<int>(embb_thread_index)) {
-        // found our mapping!
-        return i;
-      }
+    // only the thread itself writes its mapping
+    int mapping = thread_id_mapping_[embb_thread_index].Load();
+    if (mapping != -1) {
+      return static_cast<unsigned int>(mapping);
+    }
+
+    unsigned int my_thread_id = next_thread_id_.FetchAndAdd(1);
+    if (my_thread_id < max_accessors_count_) {
+      thread_id_mapping_[embb_thread_index].Store(
+        static_cast<int>(my_thread_id));
+      return my_thread_id;
     }
 
     // when we reach this point, we have too many accessors
@@ -100,14 +98,13 @@ namespace internal {
     undefined_guard_(undefined_guard),
     max_guards_per_thread_(guardsPerThread),
     release_object_callback_(freeGuardCallback),
-    thread_id_mapping_(static_cast<embb::base::Atomic<int>*>(
-      embb::base::Allocation::Allocate(sizeof(embb::base::Atomic<int>)
-      *max_accessors_count_))),
+    thread_id_mapping_size_(embb::base::Thread::GetThreadsMaxCount()),
+    next_thread_id_(0),
     guards_(static_cast<embb::base::Atomic< GuardType >*>
       (embb::base::Allocation::Allocate(
       sizeof(embb::base::Atomic< GuardType >) * max_guards_per_thread_ *
       max_accessors_count_))),
-    thread_local_retired_lists_temp_(static_cast<GuardType*>
+    thread_local_hazards_(static_cast<GuardType*>
       (embb::base::Allocation::Allocate(
       sizeof(GuardType) * max_guards_per_thread_ * max_accessors_count_ *
       max_accessors_count_
@@ -116,14 +113,21 @@ namespace internal {
       (embb::base::Allocation::Allocate(
       sizeof(GuardType) * max_guards_per_thread_ * max_accessors_count_ *
       max_accessors_count_
-      ))) {
+      ))),
+    thread_local_retired_counts_(static_cast<unsigned int*>
+      (embb::base::Allocation::AllocateCacheAligned(
+      sizeof(unsigned int) * RETIRED_COUNT_STRIDE * max_accessors_count_))) {
     const unsigned int count_guards =
       max_guards_per_thread_ * max_accessors_count_;
 
     const unsigned int count_ret_elements =
       count_guards * max_accessors_count_;
 
-    for (unsigned int i = 0; i != max_accessors_count_; ++i) {
+    thread_id_mapping_ = static_cast<embb::base::Atomic<int>*>(
+      embb::base::Allocation::Allocate(sizeof(embb::base::Atomic<int>)
+      *thread_id_mapping_size_));
+
+    for (unsigned int i = 0; i != thread_id_mapping_size_; ++i) {
       //in-place new for each cell
       new (&thread_id_mapping_[i]) embb::base::Atomic < int >(-1);
     }
@@ -135,13 +139,17 @@ namespace internal {
 
     for (unsigned int i = 0; i != count_ret_elements; ++i) {
       //in-place new for each cell
-      new (&thread_local_retired_lists_temp_[i]) GuardType(undefined_guard);
+      new (&thread_local_hazards_[i]) GuardType(undefined_guard);
     }
 
     for (unsigned int i = 0; i != count_ret_elements; ++i) {
       //in-place new for each cell
       new (&thread_local_retired_lists_[i]) GuardType(undefined_guard);
     }
+
+    for (unsigned int i = 0; i != max_accessors_count_; ++i) {
+      thread_local_retired_counts_[i * RETIRED_COUNT_STRIDE] = 0;
+    }
   }
 
   template< typename GuardType >
@@ -157,16 +165,16 @@ namespace internal {
     // first, the hazard pointer class shall be destructed, then the memory
     // management class (e.g. some pool). Otherwise, the hazard pointer class
     // would try to return memory to an already destructed memory manager.
-    for (unsigned int i = 0; i != count_ret_elements; ++i) {
-      GuardType pointerToFree =
-          thread_local_retired_lists_[i];
-      if (pointerToFree == undefined_guard_) {
-        break;
+    for (unsigned int i = 0; i != max_accessors_count_; ++i) {
+      const unsigned int retired_count =
+        thread_local_retired_counts_[i * RETIRED_COUNT_STRIDE];
+      for (unsigned int ii = 0; ii != retired_count; ++ii) {
+        release_object_callback_(
+          thread_local_retired_lists_[i * count_guards + ii]);
       }
-      release_object_callback_(pointerToFree);
     }
 
-    for (unsigned int i = 0; i != max_accessors_count_; ++i) {
+    for (unsigned int i = 0; i != thread_id_mapping_size_; ++i) {
       thread_id_mapping_[i].~Atomic();
     }
 
@@ -179,16 +187,26 @@ namespace internal {
     embb::base::Allocation::Free(guards_);
 
     for (unsigned int i = 0; i != count_ret_elements; ++i) {
-      thread_local_retired_lists_temp_[i].~GuardType();
+      thread_local_hazards_[i].~GuardType();
     }
 
-    embb::base::Allocation::Free(thread_local_retired_lists_temp_);
+    embb::base::Allocation::Free(thread_local_hazards_);
 
     for (unsigned int i = 0; i != count_ret_elements; ++i) {
       thread_local_retired_lists_[i].~GuardType();
     }
 
     embb::base::Allocation::Free(thread_local_retired_lists_);
+
+    embb::base::Allocation::FreeAligned(thread_local_retired_counts_);
+  }
+
+  template< typename GuardType >
+  void HazardPointer< GuardType >::EnterCriticalSection() {
+  }
+
+  template< typename GuardType >
+  void HazardPointer< GuardType >::LeaveCriticalSection() {
   }
 
   template< typename GuardType >
@@ -215,103 +233,9 @@ namespace internal {
         guardsPerThread * accessorCount * accessorCount);
   }
 
-  /**
-   * Remark: it might be faster to just swap pointers for temp retired list and
-   * retired list. However, with the current implementation (one array for all
-   * retired and retired temp lists, respectively) this is not possible. This is
-   * not changed until this copying accounts for a performance problem. The
-   * copying is not the bottleneck currently.
-   */
   template< typename GuardType >
-  void HazardPointer< GuardType >::CopyRetiredList(GuardType* sourceList,
-    GuardType* targetList, unsigned int retiredListSize,
-    GuardType undefinedGuard) {
-    bool done = false;
-    for (unsigned int ii = 0; ii != retiredListSize; ++ii) {
-      if (!done) {
-        GuardType guardToCopy = sourceList[ii];
-
-        if (guardToCopy == undefinedGuard) {
-          done = true;
-
-          if (targetList[ii] == undefinedGuard) {
-            // end of target list
-            break;
-          }
-        }
-        targetList[ii] = guardToCopy;
-      } else {
-        // we copied the whole source list, remaining values in the target
-        // have to be zeroed.
-        if (targetList[ii] == undefinedGuard) {
-          // end of target list
-          break;
-        } else {
-          targetList[ii] = undefinedGuard;
-        }
-      }
-    }
-  }
-
-  template< typename GuardType >
-  void HazardPointer< GuardType >::UpdateRetiredList(GuardType* retired_list,
-    GuardType* updated_retired_list, unsigned int retired_list_size,
-    GuardType guarded_element, GuardType considered_hazard,
-    GuardType undefined_guard) {
-    // no hazard set here
-    if (considered_hazard == undefined_guard)
-        return;
-
-    // if this hazard is currently in the union of
-    // threadLocalRetiredLists and pointerToRetire, but not yet in
-    // threadLocalRetiredListsTemp, add it to that list
-    bool contained_in_union = false;
-
-    // first iterate over our retired list
-    for (unsigned int i = 0; i != retired_list_size; ++i) {
-      // when reaching 0, we can stop iterating (end of the "list")
-      if (retired_list[i] == 0)
-          break;
-
-      // the hazard is contained in the retired list... it shall go
-      // into the temp list, if not already there
-      if (retired_list[i] == considered_hazard) {
-        contained_in_union = true;
-        break;
-      }
-    }
-
-    // the union also contains pointerToRetire
-    if (!contained_in_union) {
-      contained_in_union = (considered_hazard == guarded_element);
-    }
-
-    // add the pointer to temp. retired list, if not already there
-    if (contained_in_union) {
-      for (unsigned int ii = 0; ii != retired_list_size; ++ii) {
-        // is it already there?
-        if (updated_retired_list[ii] == considered_hazard)
-            break;
-
-        // end of the list
-        if (updated_retired_list[ii] == undefined_guard) {
-          // add hazard
-          updated_retired_list[ii] = considered_hazard;
-
-          // we are done here...
-          break;
-        }
-      }
-    }
-  }
-
-  template< typename GuardType >
-  void HazardPointer< GuardType >::EnqueueForDeletion(GuardType toRetire) {
-    unsigned int my_thread_id = GetObjectLocalThreadIndex();
-
-    // check for invariant
-    assert(my_thread_id < max_accessors_count_);
-
+  void HazardPointer< GuardType >::Scan(unsigned int my_thread_id,
+    GuardType to_retire) {
     const unsigned int retired_list_size = max_accessors_count_ *
       max_guards_per_thread_;
 
@@ -321,68 +245,80 @@ namespace internal {
     GuardType* retired_list =
       &thread_local_retired_lists_[my_thread_id * retired_list_size];
 
-    GuardType* retired_list_temp =
-      &thread_local_retired_lists_temp_[my_thread_id * retired_list_size];
-
-    // wipe my temp. retired list...
-    for (unsigned int i = 0; i < retired_list_size; ++i) {
-      // the list is filled always from left to right, so occurring the first
-      // undefinedGuard, the remaining ones are also undefinedGuard...
-      if (retired_list_temp[i] == undefined_guard_)
-          break;
+    GuardType* hazards =
+      &thread_local_hazards_[my_thread_id * retired_list_size];
 
-      retired_list_temp[i] = undefined_guard_;
-    }
+    unsigned int& retired_count =
+      thread_local_retired_counts_[my_thread_id * RETIRED_COUNT_STRIDE];
 
-    // we test each hazard if it is in the union of retiredList and
-    // guardedElement. If it is, it goes into the new retired list...
+    // take a snapshot of all currently active guards and sort it, so each
+    // retired element can be looked up in logarithmic time
+    unsigned int hazard_count = 0;
     for (unsigned int i = 0; i != count_guards; ++i) {
-      // consider each current active guard
       GuardType considered_hazard = guards_[i].Load();
-      UpdateRetiredList(retired_list, retired_list_temp, retired_list_size,
-        toRetire, considered_hazard, undefined_guard_);
+      if (considered_hazard != undefined_guard_) {
+        hazards[hazard_count++] = considered_hazard;
+      }
+    }
+    std::sort(hazards, hazards + hazard_count, std::less<GuardType>());
+
+    // keep the guarded elements at the front of the retired list and free the
+    // others
+    unsigned int kept_count = 0;
+    for (unsigned int i = 0; i != retired_count; ++i) {
+      GuardType retired = retired_list[i];
+      if (std::binary_search(hazards, hazards + hazard_count, retired,
+        std::less<GuardType>())) {
+        retired_list[kept_count++] = retired;
+      } else {
+        this->release_object_callback_(retired);
+      }
     }
 
-    int retired_list_size_signed = static_cast<int>(retired_list_size);
-    assert(retired_list_size_signed >= 0);
-
-    // now we created a a new retired list... the elements that are "removed"
-    // from the old retired list can be safely deleted now...
-    for (int i = -1; i != retired_list_size_signed; ++i) {
-      // we iterate over the current retired list... -1 is used as dummy element
-      // in the iteration, to also iterate over the pointerToRetire, which is
-      // logically also part of the current retired list...
+    if (to_retire != undefined_guard_) {
+      if (std::binary_search(hazards, hazards + hazard_count, to_retire,
+        std::less<GuardType>())) {
+        // the kept elements and to_retire are distinct and all guarded, so
+        // there are not more of them than guards
+        assert(kept_count < retired_list_size);
+        retired_list[kept_count++] = to_retire;
+      } else {
+        this->release_object_callback_(to_retire);
+      }
+    }
 
-      // end of the list, stop iterating
-      if (i >= 0 && retired_list[i] == undefined_guard_)
-          break;
+    // the list is filled always from left to right, wipe the rest
+    for (unsigned int i = kept_count; i < retired_count; ++i) {
+      retired_list[i] = undefined_guard_;
+    }
+    retired_count = kept_count;
+  }
 
-      GuardType to_check_if_in_new_list = undefined_guard_;
+  template< typename GuardType >
+  void HazardPointer< GuardType >::EnqueueForDeletion(GuardType toRetire) {
+    unsigned int my_thread_id = GetObjectLocalThreadIndex();
 
-      to_check_if_in_new_list = (i == -1 ? toRetire : retired_list[i]);
+    // check for invariant
+    assert(my_thread_id < max_accessors_count_);
 
-      // still in the new retired list?
-      bool still_in_list = false;
-      for (unsigned int ii = 0; ii != retired_list_size; ++ii) {
-        // end of list
-        if (retired_list_temp[ii] == undefined_guard_)
-            break;
+    const unsigned int retired_list_size = max_accessors_count_ *
+      max_guards_per_thread_;
 
-        if (to_check_if_in_new_list == retired_list_temp[ii]) {
-          // still in list, cannot delete element!
-          still_in_list = true;
-          break;
-        }
-      }
+    unsigned int& retired_count =
+      thread_local_retired_counts_[my_thread_id * RETIRED_COUNT_STRIDE];
 
-      if (!still_in_list) {
-        this->release_object_callback_(to_check_if_in_new_list);
+    if (retired_count < retired_list_size) {
+      thread_local_retired_lists_[my_thread_id * retired_list_size +
+        retired_count] = toRetire;
+      retired_count++;
+      // scan only once the list is full
+      if (retired_count == retired_list_size) {
+        Scan(my_thread_id, undefined_guard_);
       }
+    } else {
+      // all elements in the list were guarded during the last scan
+      Scan(my_thread_id, toRetire);
     }
-
-    // copy the updated retired list (temp) to the retired list...
-    CopyRetiredList(retired_list_temp, retired_list, retired_list_size,
-      undefined_guard_);
   }
 } // namespace internal
 } // namespace containers
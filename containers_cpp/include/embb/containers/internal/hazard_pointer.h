@@ -32,7 +32,9 @@
 #include <embb/base/thread.h>
 #include <embb/containers/wait_free_array_value_pool.h>
 #include <embb/base/function.h>
+#include <embb/base/c/internal/config.h>
 #include <algorithm>
+#include <functional>
 
 #if defined(EMBB_PLATFORM_COMPILER_MSVC)
 #define EMBB_CONTAINERS_CPP_DEPENDANT_TYPENAME
@@ -102,11 +104,13 @@ namespace internal {
  * end, it is still guaranteed that all memory is properly returned (in the
  * destructor).
  *
- * Additionally, the original implementation holds a threshold, which determines
- * when objects shall be freed. In this implementation, we free whenever it is
- * possibly to do so, as we want to keep the memory footprint as low as
- * possible. We also don't see a performance drop in the current algorithms that
- * are using hazard pointers, when not using a threshold.
+ * As in the original implementation, retired objects are collected in a
+ * thread local retired list and only freed in a scan once the list is full.
+ * The scan takes a sorted snapshot of all guards and frees every retired
+ * object not found in it by binary search. To keep the memory footprint
+ * fixed, the threshold is the size of the retired list, i.e., the total
+ * number of guards. As usually only few retired objects are guarded, most
+ * retires then only append to the list.
  *
  * \tparam GuardType the type of the guards. Usually the pointer type of some
  *         object to protect.
@@ -145,9 +149,10 @@ class HazardPointer  {
    *
    * \memory We dynamically allocate the following:
    *
-   * (sizeof(Atomic<int>) * accessors) + (sizeof(Atomic<GuardType>) *
+   * (sizeof(Atomic<int>) * max_threads) + (sizeof(Atomic<GuardType>) *
    * guards_per_thread * accessors) + (2*sizeof(GuardType) *
-   * guards_per_thread * accessors^2)
+   * guards_per_thread * accessors^2) + (cache_line_size * accessors),
+   * where \c max_threads is the maximum number of EMBB threads
    *
    * The last addend is the dominant one, as accessorCount accounts
    * quadratically for it.
@@ -176,6 +181,22 @@ class HazardPointer  {
    */
   ~HazardPointer();
 
+  /**
+   * Does nothing, guards protect the accessed objects. Together with
+   * \c LeaveCriticalSection, allows data structures to use this class and
+   * EpochReclamation interchangeably.
+   *
+   * \waitfree
+   */
+  void EnterCriticalSection();
+
+  /**
+   * Does nothing, see \c EnterCriticalSection.
+   *
+   * \waitfree
+   */
+  void LeaveCriticalSection();
+
   /**
    * Guards \c to_guard. If the guarded_element is passed to \c EnqueueForDeletion
    * it is prevented from release from now on. The user must have a check that
@@ -192,10 +213,10 @@ class HazardPointer  {
     );
 
   /**
-   * Enqueue guarded element for deletion. If not guarded, it is deleted
-   * immediately. If it is guarded, it is added to a thread local retired list,
-   * and deleted in a subsequent call to \c EnqueueForDeletion, when no guard is
-   * placed on it anymore.
+   * Enqueue guarded element for deletion. The element is added to a thread
+   * local retired list. Once the list is full, all elements in it that are not
+   * guarded are deleted. The others stay in the list until a subsequent scan
+   * finds no guard placed on them anymore.
    */
   void EnqueueForDeletion(
     GuardType guarded_element
@@ -243,12 +264,23 @@ class HazardPointer  {
   embb::base::Function<void, GuardType> release_object_callback_;
 
   /**
-   * Mapping from EMBB thread id to hazard pointer thread ids. Hazard pointer
-   * thread ids are in range [0;accesor_count-1]. The position of an EMBB thread
-   * id in that array determines the respective hazard pointer thread id.
+   * Mapping from EMBB thread index to hazard pointer thread index, -1 if the
+   * thread has not accessed this object yet. Hazard pointer thread indices are
+   * in range [0;accessor_count-1] and handed out in order of first access.
    */
   embb::base::Atomic<int>* thread_id_mapping_;
 
+  /**
+   * The size of \c thread_id_mapping_, i.e., the maximum number of EMBB
+   * threads.
+   */
+  unsigned int thread_id_mapping_size_;
+
+  /**
+   * The hazard pointer thread index handed out next
+   */
+  embb::base::Atomic<unsigned int> next_thread_id_;
+
   /**
    * The hazard pointer guards, represented as array. Each thread has a fixed
    * set of slots (guardsPerThread) within this array.
@@ -256,17 +288,32 @@ class HazardPointer  {
   embb::base::Atomic<GuardType>* guards_;
 
   /**
-   * \see threadLocalRetiredLists documentation
+   * Per thread array taking the sorted snapshot of all guards during a scan,
+   * represented as single array like \c thread_local_retired_lists_.
    */
-  GuardType* thread_local_retired_lists_temp_;
+  GuardType* thread_local_hazards_;
 
   /**
    * A list of lists, represented as single array. Each thread maintains a list
    * of retired pointers that are objects that are logically released but not
-   * released because some thread placed a guard on it.
+   * yet freed, either because some thread placed a guard on it or because the
+   * list has not been scanned since. Unused entries are undefined guards.
    */
   GuardType* thread_local_retired_lists_;
 
+  /**
+   * Number of entries in the retired list of each thread. The count of a
+   * thread is placed on its own cache line.
+   */
+  unsigned int* thread_local_retired_counts_;
+
+  /**
+   * Distance of the retired counts of two threads in
+   * \c thread_local_retired_counts_
+   */
+  static const unsigned int RETIRED_COUNT_STRIDE =
+    EMBB_PLATFORM_CACHE_LINE_SIZE / sizeof(unsigned int);
+
   /**
    * Each thread is assigned a thread index (starting with 0). Get the index of
    * the current thread. Note that this is not the global index, but an hazard
@@ -281,32 +328,15 @@ class HazardPointer  {
   unsigned int GetObjectLocalThreadIndex();
 
   /**
-   * Copy retired list \c sourceList to retired list \c targetList
+   * Frees all objects in the retired list of the current thread that are not
+   * guarded. \c to_retire is retired as part of the scan, it is freed right
+   * away if not guarded.
    */
-  static void CopyRetiredList(
-    GuardType* source_list,
-    /**<[IN] the source retired list*/
-    GuardType* target_list,
-    /**<[IN] the target retired list*/
-    unsigned int single_retired_list_size,
-    /**<[IN] the size of a thread local retired list*/
-    GuardType undefined_guard
-    /**<[IN] the undefined guard (usually the NULL pointer)*/
-    );
-
-  static void UpdateRetiredList(
-    GuardType* retired_list,
-    /**<[IN] the old retired list*/
-    GuardType* updated_retired_list,
-    /**<[IN] the updated retired list*/
-    unsigned int retired_list_size,
-    /**<[IN] the size of a thread local retired list*/
-    GuardType to_retire,
-    /**<[IN] the element to retire*/
-    GuardType considered_hazard,
-    /**<[IN] the currently considered hazard*/
-    GuardType undefined_guard
-    /**<[IN] the undefined guard (usually the NULL pointer)*/
+  void Scan(
+    unsigned int my_thread_id,
+    /**<[IN] the hazard pointer thread index of the current thread*/
+    GuardType to_retire
+    /**<[IN] the element to retire, or the undefined guard*/
     );
 };
 } // namespace internal
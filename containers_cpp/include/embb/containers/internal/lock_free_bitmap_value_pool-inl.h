@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EMBB_CONTAINERS_INTERNAL_LOCK_FREE_BITMAP_VALUE_POOL_INL_H_
+#define EMBB_CONTAINERS_INTERNAL_LOCK_FREE_BITMAP_VALUE_POOL_INL_H_
+
+#include <embb/base/c/internal/config.h>
+#include <embb/base/c/internal/thread_index.h>
+#include <embb/base/thread.h>
+
+#include <cassert>
+#include <new>
+#include <utility>
+
+#ifdef EMBB_PLATFORM_COMPILER_MSVC
+#include <intrin.h>
+#endif
+
+namespace embb {
+namespace containers {
+
+template<typename Type, Type Undefined, class PoolAllocator,
+  class BitmapAllocator >
+LockFreeBitmapValuePool<Type, Undefined, PoolAllocator, BitmapAllocator>::
+Iterator::Iterator()
+  : pool_(NULL)
+  , index_(0) {
+  // empty
+}
+
+template<typename Type, Type Undefined, class PoolAllocator,
+  class BitmapAllocator >
+LockFreeBitmapValuePool<Type, Undefined, PoolAllocator, BitmapAllocator>::
+Iterator::Iterator(LockFreeBitmapValuePool * pool)
+  : pool_(pool)
+  , index_(0) {
+  Advance();
+}
+
+template<typename Type, Type Undefined, class PoolAllocator,
+  class BitmapAllocator >
+LockFreeBitmapValuePool<Type, Undefined, PoolAllocator, BitmapAllocator>::
+Iterator::Iterator(LockFreeBitmapValuePool * pool, int index)
+  : pool_(pool)
+  , index_(index) {
+  Advance();
+}
+
+template<typename Type, Type Undefined, class PoolAllocator,
+  class BitmapAllocator >
+LockFreeBitmapValuePool<Type, Undefined, PoolAllocator, BitmapAllocator>::
+Iterator::Iterator(Iterator const & other)
+  : pool_(other.pool_)
+  , index_(other.index_) {
+  // empty
+}
+
+template<typename Type, Type Undefined, class PoolAllocator,
+  class BitmapAllocator >
+typename LockFreeBitmapValuePool<Type, Undefined, PoolAllocator,
+  BitmapAllocator>::Iterator &
+LockFreeBitmapValuePool<Type, Undefined, PoolAllocator, BitmapAllocator>::
+Iterator::operator =(Iterator const & other) {
+  pool_ = other.pool_;
+  index_ = other.index_;
+  return *this;
+}
+
+template<typename Type, Type Undefined, class PoolAllocator,
+  class BitmapAllocator >
+void
+LockFreeBitmapValuePool<Type, Undefined, PoolAllocator, BitmapAllocator>::
+Iterator::Advance() {
+  if (NULL != pool_) {
+    while (index_ < pool_->size_ && pool_->IsInPool(index_)) {
+      index_++;
+    }
+  } else {
+    index_ = 0;
+  }
+}
+
+template<typename Type, Type Undefined, class PoolAllocator,
+  class BitmapAllocator >
+typename LockFreeBitmapValuePool<Type, Undefined, PoolAllocator,
+  BitmapAllocator>::Iterator &
+LockFreeBitmapValuePool<Type, Undefined, PoolAllocator, BitmapAllocator>::
+Iterator::operator ++() {
+  index_++;
+  Advance();
+  return *this;
+}
+
+template<typename Type, Type Undefined, class PoolAllocator,
+  class BitmapAllocator >
+typename LockFreeBitmapValuePool<Type, Undefined, PoolAllocator,
+  BitmapAllocator>::Iterator
+LockFreeBitmapValuePool<Type, Undefined, PoolAllocator, BitmapAllocator>::
+Iterator::operator ++(int) {
+  Iterator tmp(*this);
+  operator++();
+  return tmp;
+}
+
+template<typename Type, Type Undefined, class PoolAllocator,
+  class BitmapAllocator >
+std::pair<int, Type>
+LockFreeBitmapValuePool<Type, Undefined, PoolAllocator, BitmapAllocator>::
+Iterator::operator *() {
+  return std::make_pair(index_, pool_->pool_array_[index_]);
+}
+
+template<typename Type, Type Undefined, class PoolAllocator,
+  class BitmapAllocator >
+bool
+LockFreeBitmapValuePool<Type, Undefined, PoolAllocator, BitmapAllocator>::
+Iterator::operator ==(Iterator const & rhs) {
+  return (pool_ == rhs.pool_) && (index_ == rhs.index_);
+}
+
+template<typename Type, Type Undefined, class PoolAllocator,
+  class BitmapAllocator >
+bool
+LockFreeBitmapValuePool<Type, Undefined, PoolAllocator, BitmapAllocator>::
+Iterator::operator !=(Iterator const & rhs) {
+  return (pool_ != rhs.pool_) || (index_ != rhs.index_);
+}
+
+template<typename Type, Type Undefined, class PoolAllocator,
+  class BitmapAllocator >
+typename LockFreeBitmapValuePool<Type, Undefined, PoolAllocator,
+  BitmapAllocator>::Iterator
+LockFreeBitmapValuePool<Type, Undefined, PoolAllocator, BitmapAllocator>::
+Begin() {
+  return Iterator(this);
+}
+
+template<typename Type, Type Undefined, class PoolAllocator,
+  class BitmapAllocator >
+typename LockFreeBitmapValuePool<Type, Undefined, PoolAllocator,
+  BitmapAllocator>::Iterator
+LockFreeBitmapValuePool<Type, Undefined, PoolAllocator, BitmapAllocator>::
+End() {
+  return Iterator(this, size_);
+}
+
+template<typename Type, Type Undefined, class PoolAllocator,
+  class BitmapAllocator >
+unsigned int* LockFreeBitmapValuePool<Type, Undefined, PoolAllocator,
+  BitmapAllocator>::GetHint() {
+  unsigned int thread_index;
+  if (embb_internal_thread_index(&thread_index) != EMBB_SUCCESS ||
+    thread_index >= hint_count_) {
+    return NULL;
+  }
+  return &hints_[thread_index * HINT_STRIDE];
+}
+
+template<typename Type, Type Undefined, class PoolAllocator,
+  class BitmapAllocator >
+unsigned int LockFreeBitmapValuePool<Type, Undefined, PoolAllocator,
+  BitmapAllocator>::FindFirstSet(unsigned int word) {
+  assert(word != 0);
+#if defined(EMBB_PLATFORM_COMPILER_GNUC)
+  return static_cast<unsigned int>(__builtin_ctz(word));
+#elif defined(EMBB_PLATFORM_COMPILER_MSVC)
+  unsigned long index;
+  _BitScanForward(&index, static_cast<unsigned long>(word));
+  return static_cast<unsigned int>(index);
+#else
+  unsigned int index = 0;
+  while ((word & 1u) == 0) {
+    word >>= 1;
+    index++;
+  }
+  return index;
+#endif
+}
+
+template<typename Type, Type Undefined, class PoolAllocator,
+  class BitmapAllocator >
+bool LockFreeBitmapValuePool<Type, Undefined, PoolAllocator,
+  BitmapAllocator>::IsInPool(int index) {
+  unsigned int position = static_cast<unsigned int>(index);
+  return (bitmap_[position / BITS_PER_WORD].Load() &
+    (1u << (position % BITS_PER_WORD))) != 0;
+}
+
+template<typename Type, Type Undefined, class PoolAllocator,
+  class BitmapAllocator >
+void LockFreeBitmapValuePool<Type, Undefined, PoolAllocator,
+  BitmapAllocator>::Free(Type element, int index) {
+  assert(element != Undefined);
+  assert(!IsInPool(index));
+
+  unsigned int position = static_cast<unsigned int>(index);
+  // Only the owner writes the element, setting the bit publishes it
+  pool_array_[index] = element;
+  bitmap_[position / BITS_PER_WORD] |= 1u << (position % BITS_PER_WORD);
+
+  // The next allocation of this thread finds the element right away
+  unsigned int* hint = GetHint();
+  if (hint != NULL) {
+    *hint = position / BITS_PER_WORD;
+  }
+}
+
+template<typename Type, Type Undefined, class PoolAllocator,
+  class BitmapAllocator >
+int LockFreeBitmapValuePool<Type, Undefined, PoolAllocator,
+  BitmapAllocator>::Allocate(Type & element) {
+  unsigned int* hint = GetHint();
+  unsigned int word_index = (hint != NULL) ? *hint : 0;
+
+  // Visit every word once, starting at the hint
+  for (unsigned int i = 0; i != word_count_; ++i) {
+    embb::base::Atomic<unsigned int>& word = bitmap_[word_index];
+    unsigned int bits = word.Load();
+    while (bits != 0) {
+      unsigned int bit = FindFirstSet(bits);
+      // On failure, bits holds the current word, another thread allocated or
+      // freed an element of it
+      if (word.CompareAndSwap(bits, bits & ~(1u << bit))) {
+        if (hint != NULL) {
+          *hint = word_index;
+        }
+        int index = static_cast<int>(word_index * BITS_PER_WORD + bit);
+        element = pool_array_[index];
+        return index;
+      }
+    }
+    if (++word_index == word_count_) {
+      word_index = 0;
+    }
+  }
+  element = Type();
+  return -1;
+}
+
+template<typename Type, Type Undefined, class PoolAllocator,
+  class BitmapAllocator >
+template<typename ForwardIterator>
+LockFreeBitmapValuePool<Type, Undefined, PoolAllocator, BitmapAllocator>::
+LockFreeBitmapValuePool(ForwardIterator first, ForwardIterator last) {
+  size_t dist = static_cast<size_t>(std::distance(first, last));
+
+  size_ = static_cast<int>(dist);
+
+  // conversion may result in negative number. check!
+  assert(size_ >= 0);
+
+  // At least one word, so that there is always a word to start at
+  word_count_ = static_cast<unsigned int>(
+    (dist + BITS_PER_WORD - 1) / BITS_PER_WORD);
+  if (word_count_ == 0) {
+    word_count_ = 1;
+  }
+
+  pool_array_ = pool_allocator_.allocate(dist);
+  bitmap_ = bitmap_allocator_.allocate(word_count_);
+
+  // invoke inplace new for each pool element and word
+  int i = 0;
+  for (ForwardIterator curIter(first); curIter != last; ++curIter) {
+    new (&pool_array_[i++]) Type(*curIter);
+  }
+  for (unsigned int word = 0; word != word_count_; ++word) {
+    new (&bitmap_[word]) embb::base::Atomic<unsigned int>(0);
+  }
+
+  // All elements are in the pool, the bits past the last element stay unset
+  for (unsigned int index = 0; index != dist; ++index) {
+    bitmap_[index / BITS_PER_WORD] |= 1u << (index % BITS_PER_WORD);
+  }
+
+  // Spread the threads over the bitmap
+  hint_count_ = embb::base::Thread::GetThreadsMaxCount();
+  hints_ = static_cast<unsigned int*>(
+    embb::base::Allocation::AllocateCacheAligned(
+    sizeof(unsigned int) * HINT_STRIDE * hint_count_));
+  for (unsigned int thread = 0; thread != hint_count_; ++thread) {
+    hints_[thread * HINT_STRIDE] = static_cast<unsigned int>(
+      (static_cast<size_t>(thread) * word_count_) / hint_count_);
+  }
+}
+
+template<typename Type, Type Undefined, class PoolAllocator,
+  class BitmapAllocator >
+LockFreeBitmapValuePool<Type, Undefined, PoolAllocator, BitmapAllocator>::
+~LockFreeBitmapValuePool() {
+  embb::base::Allocation::FreeAligned(hints_);
+
+  // invoke destructor for each pool element and word
+  for (unsigned int word = 0; word != word_count_; ++word) {
+    bitmap_[word].~Atomic();
+  }
+  for (int i = 0; i != size_; ++i) {
+    pool_array_[i].~Type();
+  }
+
+  // free memory
+  bitmap_allocator_.deallocate(bitmap_, word_count_);
+  pool_allocator_.deallocate(pool_array_, static_cast<size_t>(size_));
+}
+
+template<typename Type, Type Undefined, class PoolAllocator,
+  class BitmapAllocator >
+size_t LockFreeBitmapValuePool<Type, Undefined, PoolAllocator,
+  BitmapAllocator>::
+GetMinimumElementCountForGuaranteedCapacity(size_t capacity) {
+  // as for the array pool, every element in the pool can be allocated
+  return capacity;
+}
+
+} // namespace containers
+} // namespace embb
+
+#endif  // EMBB_CONTAINERS_INTERNAL_LOCK_FREE_BITMAP_VALUE_POOL_INL_H_
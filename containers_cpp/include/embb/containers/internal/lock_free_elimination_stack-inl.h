@@ -0,0 +1,383 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EMBB_CONTAINERS_INTERNAL_LOCK_FREE_ELIMINATION_STACK_INL_H_
+#define EMBB_CONTAINERS_INTERNAL_LOCK_FREE_ELIMINATION_STACK_INL_H_
+
+#include <embb/base/internal/config.h>
+#include <embb/base/c/internal/thread_index.h>
+#include <embb/base/memory_allocation.h>
+#include <embb/base/thread.h>
+
+/*
+ * The following algorithm is a Treiber stack with hazard pointers (or
+ * epochs), extended by the elimination backoff described in
+ * Danny Hendler, Nir Shavit, and Lena Yerushalmi. "A scalable lock-free stack
+ * algorithm". Proceedings of the sixteenth annual ACM symposium on
+ * parallelism in algorithms and architectures. ACM, 2004.
+ *
+ * A slot of the elimination array goes through the following states:
+ * - A push installs its node in an empty slot and waits. A pop that finds the
+ *   node replaces it by "taken", which only the push resets to empty.
+ * - A pop installs "waiting pop" in an empty slot and waits. A push that
+ *   finds it replaces it by its marked node, which only the pop resets.
+ * A waiting operation that finds its slot unchanged withdraws by resetting
+ * it to empty. As only the waiting operation leaves these states, a slot
+ * cannot be reused while an operation still waits in it, and the usual ABA
+ * problem of recycled nodes does not arise.
+ *
+ * Eliminated nodes never become reachable from the top of the stack. The pop
+ * that takes such a node owns it exclusively and returns it to the pool
+ * without going through the memory reclamation.
+ */
+
+namespace embb {
+namespace containers {
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+void LockFreeEliminationStack< Type, ValuePool, Reclamation >::
+DeletePointerCallback(Node* to_delete) {
+  objectPool.Free(to_delete);
+}
+
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+typename LockFreeEliminationStack< Type, ValuePool, Reclamation >::Node*
+LockFreeEliminationStack< Type, ValuePool, Reclamation >::EmptySlot() {
+  return NULL;
+}
+
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+typename LockFreeEliminationStack< Type, ValuePool, Reclamation >::Node*
+LockFreeEliminationStack< Type, ValuePool, Reclamation >::WaitingPop() {
+  // Nodes contain a pointer and are aligned accordingly, so neither this nor
+  // TakenNode() can be the address of a node, marked or not.
+  return reinterpret_cast<Node*>(static_cast<size_t>(2));
+}
+
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+typename LockFreeEliminationStack< Type, ValuePool, Reclamation >::Node*
+LockFreeEliminationStack< Type, ValuePool, Reclamation >::TakenNode() {
+  return reinterpret_cast<Node*>(static_cast<size_t>(4));
+}
+
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+typename LockFreeEliminationStack< Type, ValuePool, Reclamation >::Node*
+LockFreeEliminationStack< Type, ValuePool, Reclamation >::Mark(Node* node) {
+  return reinterpret_cast<Node*>(reinterpret_cast<size_t>(node) | 1);
+}
+
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+typename LockFreeEliminationStack< Type, ValuePool, Reclamation >::Node*
+LockFreeEliminationStack< Type, ValuePool, Reclamation >::Unmark(Node* node) {
+  return reinterpret_cast<Node*>(
+    reinterpret_cast<size_t>(node) & ~static_cast<size_t>(1));
+}
+
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+bool LockFreeEliminationStack< Type, ValuePool, Reclamation >::
+IsMarked(Node* node) {
+  return (reinterpret_cast<size_t>(node) & 1) != 0;
+}
+
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+LockFreeEliminationStack< Type, ValuePool, Reclamation >::
+LockFreeEliminationStack(size_t capacity, unsigned int slot_count) :
+capacity(capacity),
+// Disable "this is used in base member initializer" warning.
+// We explicitly want this.
+#ifdef EMBB_PLATFORM_COMPILER_MSVC
+#pragma warning(push)
+#pragma warning(disable:4355)
+#endif
+  delete_pointer_callback(*this,
+    &LockFreeEliminationStack::DeletePointerCallback),
+#ifdef EMBB_PLATFORM_COMPILER_MSVC
+#pragma warning(pop)
+#endif
+  // Object pool, size with respect to the maximum number of retired nodes not
+  // eligible for reuse. Nodes waiting in the elimination array belong to
+  // pushes in progress and are covered by the capacity.
+  objectPool(
+  StackNodeHazardPointer_t::ComputeMaximumRetiredObjectCount(1) +
+  capacity),
+  hazardPointer(delete_pointer_callback, NULL, 1),
+  top(NULL),
+  slot_count(slot_count) {
+  unsigned int thread_count = embb::base::Thread::GetThreadsMaxCount();
+
+  // One slot per two threads, so that pairs of threads can meet
+  if (this->slot_count == 0) {
+    this->slot_count = thread_count / 2 > 0 ? thread_count / 2 : 1;
+  }
+  slots = static_cast<embb::base::Atomic<Node*>*>(
+    embb::base::Allocation::AllocateCacheAligned(
+    sizeof(embb::base::Atomic<Node*>) * SLOT_STRIDE * this->slot_count));
+  for (unsigned int slot = 0; slot != this->slot_count; ++slot) {
+    new (&slots[slot * SLOT_STRIDE]) embb::base::Atomic<Node*>(EmptySlot());
+  }
+
+  random_count = thread_count;
+  random_states = static_cast<unsigned int*>(
+    embb::base::Allocation::AllocateCacheAligned(
+    sizeof(unsigned int) * RANDOM_STRIDE * random_count));
+  for (unsigned int thread = 0; thread != random_count; ++thread) {
+    // xorshift needs a nonzero state
+    random_states[thread * RANDOM_STRIDE] = thread * 2654435761u + 1;
+  }
+}
+
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+size_t LockFreeEliminationStack< Type, ValuePool, Reclamation >::
+GetCapacity() {
+  return capacity;
+}
+
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+LockFreeEliminationStack< Type, ValuePool, Reclamation >::
+~LockFreeEliminationStack() {
+  embb::base::Allocation::FreeAligned(random_states);
+  for (unsigned int slot = 0; slot != slot_count; ++slot) {
+    slots[slot * SLOT_STRIDE].~Atomic();
+  }
+  embb::base::Allocation::FreeAligned(slots);
+}
+
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+embb::base::Atomic<typename LockFreeEliminationStack< Type, ValuePool,
+  Reclamation >::Node*>&
+LockFreeEliminationStack< Type, ValuePool, Reclamation >::ChooseSlot() {
+  unsigned int thread_index;
+  if (slot_count == 1 ||
+    embb_internal_thread_index(&thread_index) != EMBB_SUCCESS ||
+    thread_index >= random_count) {
+    return slots[0];
+  }
+  // xorshift, only the calling thread uses its state
+  unsigned int& random = random_states[thread_index * RANDOM_STRIDE];
+  random ^= random << 13;
+  random ^= random >> 17;
+  random ^= random << 5;
+  return slots[(random % slot_count) * SLOT_STRIDE];
+}
+
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+bool LockFreeEliminationStack< Type, ValuePool, Reclamation >::
+TryEliminatePush(Node* node, unsigned int spins) {
+  embb::base::Atomic<Node*>& slot = ChooseSlot();
+  Node* expected = slot;
+
+  if (expected == WaitingPop()) {
+    // A pop waits, hand our node over
+    return slot.CompareAndSwap(expected, Mark(node));
+  }
+  if (expected != EmptySlot() || !slot.CompareAndSwap(expected, node)) {
+    // Another operation uses the slot
+    return false;
+  }
+
+  // Wait for a pop to take our node
+  for (unsigned int spin = 0; spin != spins && slot == node; ++spin) {
+  }
+
+  // Withdraw, unless a pop took our node in the meantime
+  expected = node;
+  if (slot.CompareAndSwap(expected, EmptySlot())) {
+    return false;
+  }
+  slot = EmptySlot();
+  return true;
+}
+
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+typename LockFreeEliminationStack< Type, ValuePool, Reclamation >::Node*
+LockFreeEliminationStack< Type, ValuePool, Reclamation >::
+TryEliminatePop(unsigned int spins) {
+  embb::base::Atomic<Node*>& slot = ChooseSlot();
+  Node* expected = slot;
+
+  if (expected != EmptySlot() && expected != WaitingPop() &&
+    expected != TakenNode() && !IsMarked(expected)) {
+    // A push waits, take its node
+    Node* node = expected;
+    return slot.CompareAndSwap(expected, TakenNode()) ? node : NULL;
+  }
+  if (expected != EmptySlot() || !slot.CompareAndSwap(expected, WaitingPop())) {
+    // Another operation uses the slot
+    return NULL;
+  }
+
+  // Wait for a push to hand over its node
+  for (unsigned int spin = 0; spin != spins && slot == WaitingPop(); ++spin) {
+  }
+
+  // Withdraw, unless a push handed over its node in the meantime
+  expected = WaitingPop();
+  if (slot.CompareAndSwap(expected, EmptySlot())) {
+    return NULL;
+  }
+  slot = EmptySlot();
+  return Unmark(expected);
+}
+
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+bool LockFreeEliminationStack< Type, ValuePool, Reclamation >::TryPush(
+  Type const& element) {
+  Node* newNode = objectPool.Allocate(element);
+
+  // Stack full, cannot push
+  if (newNode == NULL)
+    return false;
+
+  unsigned int spins = MIN_SPINS;
+  for (;;) {
+    Node* top_cached = top;
+    newNode->SetNext(top_cached);
+    if (top.CompareAndSwap(top_cached, newNode))
+      return true;
+
+    // Contention on the top, try to meet a pop instead
+    if (TryEliminatePush(newNode, spins))
+      return true;
+    if (spins < MAX_SPINS)
+      spins *= 2;
+  }
+}
+
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+bool LockFreeEliminationStack< Type, ValuePool, Reclamation >::TryPop(
+  Type & element) {
+  Node* top_cached;
+  unsigned int spins = MIN_SPINS;
+  hazardPointer.EnterCriticalSection();
+  for (;;) {
+    top_cached = top;
+
+    // Stack empty, cannot pop
+    if (top_cached == NULL) {
+      hazardPointer.LeaveCriticalSection();
+      element = Type();
+      return false;
+    }
+
+    // Guard top_cached and check that it has not been retired before
+    // guarding took effect, see LockFreeStack::TryPop
+    hazardPointer.Guard(0, top_cached);
+    if (top != top_cached)
+      continue;
+
+    if (top.CompareAndSwap(top_cached, top_cached->GetNext()))
+      break;
+    hazardPointer.Guard(0, NULL);
+
+    // Contention on the top, try to meet a push instead
+    Node* node = TryEliminatePop(spins);
+    if (node != NULL) {
+      hazardPointer.LeaveCriticalSection();
+      element = node->GetElement();
+      objectPool.Free(node);
+      return true;
+    }
+    if (spins < MAX_SPINS)
+      spins *= 2;
+  }
+
+  Type data = top_cached->GetElement();
+
+  // We don't need to read from this reference anymore, unguard it
+  hazardPointer.Guard(0, NULL);
+
+  hazardPointer.EnqueueForDeletion(top_cached);
+  hazardPointer.LeaveCriticalSection();
+
+  element = data;
+  return true;
+}
+
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+template< typename ForwardIterator >
+size_t LockFreeEliminationStack< Type, ValuePool, Reclamation >::TryPushBatch(
+  ForwardIterator first, ForwardIterator last) {
+  // Link the new nodes to a segment whose top is the last element of the
+  // range. The segment is not yet reachable by other threads.
+  Node* segment_top = NULL;
+  Node* segment_bottom = NULL;
+  size_t count = 0;
+  for (; first != last; ++first) {
+    Node* newNode = objectPool.Allocate(*first);
+    // Stack full, push what we have so far
+    if (newNode == NULL)
+      break;
+    newNode->SetNext(segment_top);
+    if (segment_bottom == NULL) {
+      segment_bottom = newNode;
+    }
+    segment_top = newNode;
+    ++count;
+  }
+  if (count == 0)
+    return 0;
+
+  for (;;) {
+    Node* top_cached = top;
+    segment_bottom->SetNext(top_cached);
+    if (top.CompareAndSwap(top_cached, segment_top))
+      return count;
+  }
+}
+
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+template< typename OutputIterator >
+size_t LockFreeEliminationStack< Type, ValuePool, Reclamation >::TryPopBatch(
+  OutputIterator out, size_t max) {
+  size_t count = 0;
+  Type element;
+  while (count != max && TryPop(element)) {
+    *out = element;
+    ++out;
+    ++count;
+  }
+  return count;
+}
+} // namespace containers
+} // namespace embb
+
+#endif  // EMBB_CONTAINERS_INTERNAL_LOCK_FREE_ELIMINATION_STACK_INL_H_
@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EMBB_CONTAINERS_INTERNAL_LOCK_FREE_HASH_MAP_INL_H_
+#define EMBB_CONTAINERS_INTERNAL_LOCK_FREE_HASH_MAP_INL_H_
+
+#include <embb/base/internal/config.h>
+#include <embb/base/memory_allocation.h>
+#include <embb/base/thread.h>
+
+#include <new>
+
+namespace embb {
+namespace containers {
+namespace internal {
+template< typename Key >
+size_t LockFreeHashMapHash< Key >::operator()(Key const & key) const {
+  // Finalizer of a 32 bit integer hash, each output bit depends on all input
+  // bits of the lower word
+  size_t hash = static_cast<size_t>(key);
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3b;
+  hash ^= hash >> 16;
+  hash *= 0x45d9f3b;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+template< typename Key >
+size_t LockFreeHashMapHash< Key* >::operator()(Key* const & key) const {
+  return LockFreeHashMapHash< size_t >()(reinterpret_cast<size_t>(key));
+}
+
+template< typename Key, typename Value >
+LockFreeHashMapNode< Key, Value >::LockFreeHashMapNode(
+  Key const & key, Value const & value)
+  : next(NULL), key(key), value(value) {
+}
+} // namespace internal
+
+template< typename Key, typename Value, typename Hash, typename ValuePool >
+void LockFreeHashMap< Key, Value, Hash, ValuePool >::
+DeletePointerCallback(Node* to_delete) {
+  object_pool.Free(to_delete);
+}
+
+template< typename Key, typename Value, typename Hash, typename ValuePool >
+typename LockFreeHashMap< Key, Value, Hash, ValuePool >::Node*
+LockFreeHashMap< Key, Value, Hash, ValuePool >::Mark(Node* node) {
+  return reinterpret_cast<Node*>(reinterpret_cast<size_t>(node) | 1);
+}
+
+template< typename Key, typename Value, typename Hash, typename ValuePool >
+typename LockFreeHashMap< Key, Value, Hash, ValuePool >::Node*
+LockFreeHashMap< Key, Value, Hash, ValuePool >::Unmark(Node* node) {
+  return reinterpret_cast<Node*>(
+    reinterpret_cast<size_t>(node) & ~static_cast<size_t>(1));
+}
+
+template< typename Key, typename Value, typename Hash, typename ValuePool >
+bool LockFreeHashMap< Key, Value, Hash, ValuePool >::IsMarked(Node* node) {
+  return (reinterpret_cast<size_t>(node) & 1) != 0;
+}
+
+template< typename Key, typename Value, typename Hash, typename ValuePool >
+size_t LockFreeHashMap< Key, Value, Hash, ValuePool >::
+AlignBucketCountToPowerOfTwo(size_t bucket_count) {
+  size_t result = 1;
+  while (result < bucket_count) result <<= 1;
+  return result;
+}
+
+template< typename Key, typename Value, typename Hash, typename ValuePool >
+LockFreeHashMap< Key, Value, Hash, ValuePool >::LockFreeHashMap(
+  size_t capacity, size_t bucket_count) :
+  capacity(capacity),
+  bucket_count(AlignBucketCountToPowerOfTwo(
+    bucket_count == 0 ? capacity : bucket_count)),
+  buckets(NULL),
+  hash(),
+// Disable "this is used in base member initializer" warning.
+// We explicitly want this.
+#ifdef EMBB_PLATFORM_COMPILER_MSVC
+#pragma warning(push)
+#pragma warning(disable:4355)
+#endif
+  delete_pointer_callback(*this, &LockFreeHashMap::DeletePointerCallback),
+#ifdef EMBB_PLATFORM_COMPILER_MSVC
+#pragma warning(pop)
+#endif
+  // Object pool, size with respect to the maximum number of retired nodes not
+  // eligible for reuse, and one node per thread allocated for an insertion or
+  // update not yet linked into the map:
+  object_pool(
+    internal::HazardPointer< Node* >::ComputeMaximumRetiredObjectCount(
+      GUARD_COUNT) +
+    embb::base::Thread::GetThreadsMaxCount() +
+    capacity),
+  hazard_pointer(delete_pointer_callback, NULL, GUARD_COUNT) {
+  buckets = static_cast< embb::base::Atomic< Node* >* >(
+    embb::base::Allocation::Allocate(
+      sizeof(embb::base::Atomic< Node* >) * this->bucket_count));
+  for (size_t i = 0; i != this->bucket_count; ++i) {
+    new (&buckets[i]) embb::base::Atomic< Node* >(NULL);
+  }
+}
+
+template< typename Key, typename Value, typename Hash, typename ValuePool >
+LockFreeHashMap< Key, Value, Hash, ValuePool >::~LockFreeHashMap() {
+  // The nodes still in the map are destroyed by the object pool
+  for (size_t i = 0; i != bucket_count; ++i) {
+    buckets[i].~Atomic();
+  }
+  embb::base::Allocation::Free(buckets);
+}
+
+template< typename Key, typename Value, typename Hash, typename ValuePool >
+size_t LockFreeHashMap< Key, Value, Hash, ValuePool >::GetCapacity() {
+  return capacity;
+}
+
+template< typename Key, typename Value, typename Hash, typename ValuePool >
+void LockFreeHashMap< Key, Value, Hash, ValuePool >::ClearGuards() {
+  hazard_pointer.Guard(GUARD_NEXT, NULL);
+  hazard_pointer.Guard(GUARD_CURRENT, NULL);
+  hazard_pointer.Guard(GUARD_PREVIOUS, NULL);
+}
+
+template< typename Key, typename Value, typename Hash, typename ValuePool >
+bool LockFreeHashMap< Key, Value, Hash, ValuePool >::Find(
+  Key const & key, Position & position) {
+  embb::base::Atomic< Node* >* bucket =
+    &buckets[hash(key) & (bucket_count - 1)];
+  for (;;) {
+    position.previous = bucket;
+    position.current = *bucket;
+    for (;;) {
+      if (position.current == NULL) {
+        position.next = NULL;
+        return false;
+      }
+      hazard_pointer.Guard(GUARD_CURRENT, position.current);
+      // If the link still points to the current node, neither node has been
+      // removed, and the current node cannot have been reused before it was
+      // guarded.
+      if (*position.previous != position.current)
+        break;
+      Node* next = position.current->next;
+      hazard_pointer.Guard(GUARD_NEXT, Unmark(next));
+      if (position.current->next != next)
+        break;
+      position.next = Unmark(next);
+      if (!IsMarked(next)) {
+        if (!(position.current->key < key)) {
+          return !(key < position.current->key);
+        }
+        // Move on, the current node now holds the link
+        hazard_pointer.Guard(GUARD_PREVIOUS, position.current);
+        position.previous = &position.current->next;
+      } else {
+        // The current node has been removed, help unlinking it. Whoever
+        // unlinks the node retires it.
+        Node* expected = position.current;
+        if (!position.previous->CompareAndSwap(expected, position.next))
+          break;
+        hazard_pointer.EnqueueForDeletion(position.current);
+      }
+      // The next node stays guarded until guarded as current node
+      position.current = position.next;
+    }
+  }
+}
+
+template< typename Key, typename Value, typename Hash, typename ValuePool >
+bool LockFreeHashMap< Key, Value, Hash, ValuePool >::TryInsert(
+  Key const & key, Value const & value) {
+  Node* node = NULL;
+  Position position;
+  for (;;) {
+    if (Find(key, position)) {
+      // Key already contained, the node was never visible to others
+      if (node != NULL)
+        object_pool.Free(node);
+      ClearGuards();
+      return false;
+    }
+    if (node == NULL) {
+      node = object_pool.Allocate(key, value);
+      // Map full, cannot insert
+      if (node == NULL) {
+        ClearGuards();
+        return false;
+      }
+    }
+    node->next = position.current;
+    Node* expected = position.current;
+    if (position.previous->CompareAndSwap(expected, node)) {
+      ClearGuards();
+      return true;
+    }
+  }
+}
+
+template< typename Key, typename Value, typename Hash, typename ValuePool >
+bool LockFreeHashMap< Key, Value, Hash, ValuePool >::InsertOrUpdate(
+  Key const & key, Value const & value) {
+  Node* node = NULL;
+  Position position;
+  for (;;) {
+    bool found = Find(key, position);
+    if (node == NULL) {
+      node = object_pool.Allocate(key, value);
+      // Map full, cannot insert. An update never fails this way, as the pool
+      // holds a spare node per thread.
+      if (node == NULL) {
+        ClearGuards();
+        return false;
+      }
+    }
+    if (!found) {
+      node->next = position.current;
+      Node* expected = position.current;
+      if (position.previous->CompareAndSwap(expected, node)) {
+        ClearGuards();
+        return true;
+      }
+    } else {
+      // Replace the current node: marking it and linking the new node as its
+      // successor in one step removes the old value and makes the new one
+      // visible at the same time.
+      node->next = position.next;
+      Node* expected = position.next;
+      if (position.current->next.CompareAndSwap(expected, Mark(node))) {
+        expected = position.current;
+        if (position.previous->CompareAndSwap(expected, node)) {
+          hazard_pointer.EnqueueForDeletion(position.current);
+        } else {
+          // Someone else changed the link, let a search unlink the old node
+          Find(key, position);
+        }
+        ClearGuards();
+        return true;
+      }
+    }
+  }
+}
+
+template< typename Key, typename Value, typename Hash, typename ValuePool >
+bool LockFreeHashMap< Key, Value, Hash, ValuePool >::TryGet(
+  Key const & key, Value & value) {
+  Position position;
+  bool found = Find(key, position);
+  if (found) {
+    // Values of nodes in the map are not changed, and the node is guarded
+    value = position.current->value;
+  }
+  ClearGuards();
+  return found;
+}
+
+template< typename Key, typename Value, typename Hash, typename ValuePool >
+bool LockFreeHashMap< Key, Value, Hash, ValuePool >::TryErase(
+  Key const & key) {
+  Position position;
+  for (;;) {
+    if (!Find(key, position)) {
+      ClearGuards();
+      return false;
+    }
+    // Mark the current node as removed, this fails if its successor changed
+    // or someone else removed or replaced it
+    Node* expected = position.next;
+    if (!position.current->next.CompareAndSwap(expected, Mark(position.next)))
+      continue;
+    expected = position.current;
+    if (position.previous->CompareAndSwap(expected, position.next)) {
+      hazard_pointer.EnqueueForDeletion(position.current);
+    } else {
+      // Someone else changed the link, let a search unlink the node
+      Find(key, position);
+    }
+    ClearGuards();
+    return true;
+  }
+}
+} // namespace containers
+} // namespace embb
+
+#endif  // EMBB_CONTAINERS_INTERNAL_LOCK_FREE_HASH_MAP_INL_H_
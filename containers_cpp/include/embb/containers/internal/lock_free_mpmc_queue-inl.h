@@ -30,8 +30,9 @@
 #include <embb/base/internal/config.h>
 
 /*
- * The following algorithm uses hazard pointers and a lock-free value pool for
- * memory management. For a description of the algorithm, see
+ * The following algorithm uses hazard pointers (or epochs, depending on the
+ * reclamation policy) and a lock-free value pool for memory management. For
+ * a description of the algorithm, see
  * Maged M. Michael and Michael L. Scott. "Simple, fast, and practical
  * non-blocking and blocking concurrent queue algorithms". Proceedings of the
  * fifteenth annual ACM symposium on principles of distributed computing.
@@ -64,19 +65,23 @@ T LockFreeMPMCQueueNode<T>::GetElement() {
 }
 } // namespace internal
 
-template< typename Type, typename ValuePool >
-void LockFreeMPMCQueue<Type, ValuePool>::
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+void LockFreeMPMCQueue<Type, ValuePool, Reclamation>::
 DeletePointerCallback(internal::LockFreeMPMCQueueNode<Type>* to_delete) {
   objectPool.Free(to_delete);
 }
 
-template< typename Type, typename ValuePool >
-LockFreeMPMCQueue<Type, ValuePool>::~LockFreeMPMCQueue() {
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+LockFreeMPMCQueue<Type, ValuePool, Reclamation>::~LockFreeMPMCQueue() {
   // Nothing to do here, did not allocate anything.
 }
 
-template< typename Type, typename ValuePool >
-LockFreeMPMCQueue<Type, ValuePool>::LockFreeMPMCQueue(size_t capacity) :
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+LockFreeMPMCQueue<Type, ValuePool, Reclamation>::LockFreeMPMCQueue(
+  size_t capacity) :
   capacity(capacity),
   // Object pool, size with respect to the maximum number of retired nodes not
   // eligible for reuse. +1 for dummy node.
@@ -90,7 +95,7 @@ LockFreeMPMCQueue<Type, ValuePool>::LockFreeMPMCQueue(size_t capacity) :
 #pragma warning(disable:4355)
 #endif
 delete_pointer_callback(*this,
-  &LockFreeMPMCQueue<Type>::DeletePointerCallback),
+  &LockFreeMPMCQueue::DeletePointerCallback),
 #ifdef EMBB_PLATFORM_COMPILER_MSVC
 #pragma warning(pop)
 #endif
@@ -102,13 +107,16 @@ delete_pointer_callback(*this,
   tail = dummyNode;
 }
 
-template< typename Type, typename ValuePool >
-size_t LockFreeMPMCQueue<Type, ValuePool>::GetCapacity() {
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+size_t LockFreeMPMCQueue<Type, ValuePool, Reclamation>::GetCapacity() {
   return capacity;
 }
 
-template< typename Type, typename ValuePool >
-bool LockFreeMPMCQueue<Type, ValuePool>::TryEnqueue(Type const& element) {
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+bool LockFreeMPMCQueue<Type, ValuePool, Reclamation>::TryEnqueue(
+  Type const& element) {
   // Get node from the pool containing element to enqueue.
   internal::LockFreeMPMCQueueNode<Type>* node = objectPool.Allocate(element);
 
@@ -116,6 +124,7 @@ bool LockFreeMPMCQueue<Type, ValuePool>::TryEnqueue(Type const& element) {
   if (node == NULL)
     return false;
   internal::LockFreeMPMCQueueNode<Type>* my_tail;
+  hazardPointer.EnterCriticalSection();
   for (;;) {
     my_tail = tail;
 
@@ -149,17 +158,21 @@ bool LockFreeMPMCQueue<Type, ValuePool>::TryEnqueue(Type const& element) {
   // We added our node. Try to update tail pointer. Need not succeed, if we
   // fail, another thread will help us.
   tail.CompareAndSwap(my_tail, node);
+  hazardPointer.LeaveCriticalSection();
 
   return true;
 }
 
-template< typename Type, typename ValuePool >
-bool LockFreeMPMCQueue<Type, ValuePool>::TryDequeue(Type & element) {
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+bool LockFreeMPMCQueue<Type, ValuePool, Reclamation>::TryDequeue(
+  Type & element) {
   internal::LockFreeMPMCQueueNode<Type>* my_head;
   internal::LockFreeMPMCQueueNode<Type>* my_tail;
   internal::LockFreeMPMCQueueNode<Type>* my_next;
   internal::LockFreeMPMCQueueNode<Type>* expected;
   Type data;
+  hazardPointer.EnterCriticalSection();
   for (;;) {
     my_head = head;
     hazardPointer.Guard(0, my_head);
@@ -170,8 +183,10 @@ bool LockFreeMPMCQueue<Type, ValuePool>::TryDequeue(Type & element) {
     hazardPointer.Guard(1, my_next);
     if (head != my_head) continue;
 
-    if (my_next == NULL)
+    if (my_next == NULL) {
+      hazardPointer.LeaveCriticalSection();
       return false;
+    }
 
     if (my_head == my_tail) {
       expected = my_tail;
@@ -187,9 +202,83 @@ bool LockFreeMPMCQueue<Type, ValuePool>::TryDequeue(Type & element) {
   }
 
   hazardPointer.EnqueueForDeletion(my_head);
+  hazardPointer.LeaveCriticalSection();
   element = data;
   return true;
 }
+
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+template< typename ForwardIterator >
+size_t LockFreeMPMCQueue<Type, ValuePool, Reclamation>::TryEnqueueBatch(
+  ForwardIterator first, ForwardIterator last) {
+  // Take as many nodes from the pool as are available and link them to a
+  // chain. The chain is not yet reachable by other threads.
+  internal::LockFreeMPMCQueueNode<Type>* chain_first = NULL;
+  internal::LockFreeMPMCQueueNode<Type>* chain_last = NULL;
+  size_t count = 0;
+  for (; first != last; ++first) {
+    internal::LockFreeMPMCQueueNode<Type>* node = objectPool.Allocate(*first);
+    // Queue full, enqueue what we have so far
+    if (node == NULL)
+      break;
+    if (chain_last == NULL) {
+      chain_first = node;
+    } else {
+      chain_last->GetNext() = node;
+    }
+    chain_last = node;
+    ++count;
+  }
+  if (count == 0)
+    return 0;
+
+  // Splice the chain in as if it was a single node. Until tail has been moved
+  // to the end of the chain, other threads advance it node by node.
+  internal::LockFreeMPMCQueueNode<Type>* my_tail;
+  hazardPointer.EnterCriticalSection();
+  for (;;) {
+    my_tail = tail;
+    hazardPointer.Guard(0, my_tail);
+    if (my_tail != tail) {
+      continue;
+    }
+
+    internal::LockFreeMPMCQueueNode<Type>* my_tail_next = my_tail->GetNext();
+
+    if (my_tail == tail) {
+      if (my_tail_next == NULL) {
+        internal::LockFreeMPMCQueueNode<Type>* expected = NULL;
+        if (my_tail->GetNext().CompareAndSwap(expected, chain_first))
+          break;
+      } else {
+        tail.CompareAndSwap(my_tail, my_tail_next);
+      }
+    }
+  }
+  tail.CompareAndSwap(my_tail, chain_last);
+  hazardPointer.LeaveCriticalSection();
+
+  return count;
+}
+
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+template< typename OutputIterator >
+size_t LockFreeMPMCQueue<Type, ValuePool, Reclamation>::TryDequeueBatch(
+  OutputIterator out, size_t max) {
+  // Every removed node has to be retired separately, and epoch-based
+  // reclamation permits only one retirement per critical section. Hence,
+  // elements are dequeued one by one.
+  size_t count = 0;
+  Type element;
+  while (count != max && TryDequeue(element)) {
+    *out = element;
+    ++out;
+    ++count;
+  }
+  return count;
+}
 } // namespace containers
 } // namespace embb
 
@@ -0,0 +1,456 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EMBB_CONTAINERS_INTERNAL_LOCK_FREE_SKIP_LIST_MAP_INL_H_
+#define EMBB_CONTAINERS_INTERNAL_LOCK_FREE_SKIP_LIST_MAP_INL_H_
+
+#include <embb/base/internal/config.h>
+#include <embb/base/c/internal/thread_index.h>
+#include <embb/base/memory_allocation.h>
+#include <embb/base/thread.h>
+
+#include <algorithm>
+#include <new>
+#include <vector>
+
+/*
+ * The following algorithm is described in:
+ * Keir Fraser. "Practical lock-freedom." PhD thesis, University of Cambridge,
+ * 2004. (Section 4.3)
+ *
+ * A key is contained in the map if its node is linked into the lowest level
+ * and not marked there. An insertion links the node into the lowest level
+ * first, then into the levels above. An erase marks the links of the node
+ * from the top down, the one that marks the lowest link erased the key. Then
+ * it searches the key, which unlinks the marked node from every level.
+ *
+ * An erase may overlap with the insertion of the same node into the upper
+ * levels. The insertion stops at the first marked link, but may already have
+ * linked the node on a level after the search of the erase passed it. Hence,
+ * an insertion that finds its node erased searches the key once more. Until
+ * then, threads entering a critical section may still reach the node, so the
+ * erase must not retire it on its own. Instead, the insertion and the erase
+ * both release the node when they are done with it, and the second one
+ * retires it. At that point, both searches have unlinked the node and the
+ * insertion does not link it anymore.
+ */
+
+namespace embb {
+namespace containers {
+namespace internal {
+template< typename Key, typename Value >
+LockFreeSkipListMapNode< Key, Value >::LockFreeSkipListMapNode(
+  embb::base::Atomic< LockFreeSkipListMapNode< Key, Value >* >* next,
+  Key const & key, Value const & value, int height, int size_class)
+  : next(next), key(key), value(value), height(height),
+    size_class(size_class), pending_releases(2) {
+}
+
+template< typename Key, typename Value, typename ValuePool >
+LockFreeSkipListMapNodePool< Key, Value, ValuePool >::
+LockFreeSkipListMapNodePool(size_t capacity) {
+  typedef embb::base::Atomic< Node* > Link;
+  // The padding in front of a member following a char is its alignment
+  struct NodeAlignment { char padding; Node node; };
+  struct LinkAlignment { char padding; Link link; };
+  size_t alignment = std::max(sizeof(NodeAlignment) - sizeof(Node),
+    sizeof(LinkAlignment) - sizeof(Link));
+  links_offset = (sizeof(Node) + alignment - 1) / alignment * alignment;
+
+  for (int size_class = 0; size_class != SIZE_CLASS_COUNT; ++size_class) {
+    // Nodes higher than 2^(c-1) levels need class c. Half of the nodes are
+    // higher than one level, a quarter higher than two, and so on. The
+    // classes hold twice as many nodes as expected, the class of the lowest
+    // nodes holds all of them.
+    size_t count = capacity;
+    if (size_class > 0) {
+      count >>= (1 << (size_class - 1)) - 1;
+    }
+    node_counts[size_class] =
+      ValuePool::GetMinimumElementCountForGuaranteedCapacity(
+        count > 0 ? count : 1);
+    node_sizes[size_class] = (links_offset +
+      (sizeof(Link) << size_class) + alignment - 1) / alignment * alignment;
+    nodes[size_class] = static_cast<char*>(
+      embb::base::Allocation::AllocateCacheAligned(
+        node_sizes[size_class] * node_counts[size_class]));
+    std::vector<bool> free_nodes(node_counts[size_class], true);
+    value_pools[size_class] = embb::base::Allocation::New<ValuePool>(
+      free_nodes.begin(), free_nodes.end());
+  }
+}
+
+template< typename Key, typename Value, typename ValuePool >
+LockFreeSkipListMapNodePool< Key, Value, ValuePool >::
+~LockFreeSkipListMapNodePool() {
+  for (int size_class = 0; size_class != SIZE_CLASS_COUNT; ++size_class) {
+    embb::base::Allocation::Delete(value_pools[size_class]);
+    embb::base::Allocation::FreeAligned(nodes[size_class]);
+  }
+}
+
+template< typename Key, typename Value, typename ValuePool >
+typename LockFreeSkipListMapNodePool< Key, Value, ValuePool >::Node*
+LockFreeSkipListMapNodePool< Key, Value, ValuePool >::Allocate(
+  Key const & key, Value const & value, int height) {
+  int size_class = 0;
+  while ((1 << size_class) < height) {
+    ++size_class;
+  }
+  // Lower the node if its class is exhausted
+  for (; size_class >= 0; --size_class) {
+    bool free_node;
+    int index = value_pools[size_class]->Allocate(free_node);
+    if (index == -1) {
+      continue;
+    }
+    char* memory = nodes[size_class] +
+      node_sizes[size_class] * static_cast<size_t>(index);
+    embb::base::Atomic< Node* >* next =
+      reinterpret_cast< embb::base::Atomic< Node* >* >(memory + links_offset);
+    height = std::min(height, 1 << size_class);
+    for (int level = 0; level != height; ++level) {
+      new (&next[level]) embb::base::Atomic< Node* >(NULL);
+    }
+    return new (memory) Node(next, key, value, height, size_class);
+  }
+  return NULL;
+}
+
+template< typename Key, typename Value, typename ValuePool >
+void LockFreeSkipListMapNodePool< Key, Value, ValuePool >::Free(Node* node) {
+  int size_class = node->size_class;
+  size_t index = static_cast<size_t>(
+    reinterpret_cast<char*>(node) - nodes[size_class]) /
+    node_sizes[size_class];
+  for (int level = 0; level != node->height; ++level) {
+    node->next[level].~Atomic();
+  }
+  node->~Node();
+  value_pools[size_class]->Free(true, static_cast<int>(index));
+}
+} // namespace internal
+
+template< typename Key, typename Value, typename ValuePool >
+void LockFreeSkipListMap< Key, Value, ValuePool >::
+DeletePointerCallback(Node* to_delete) {
+  node_pool.Free(to_delete);
+}
+
+template< typename Key, typename Value, typename ValuePool >
+typename LockFreeSkipListMap< Key, Value, ValuePool >::Node*
+LockFreeSkipListMap< Key, Value, ValuePool >::Mark(Node* node) {
+  return reinterpret_cast<Node*>(reinterpret_cast<size_t>(node) | 1);
+}
+
+template< typename Key, typename Value, typename ValuePool >
+typename LockFreeSkipListMap< Key, Value, ValuePool >::Node*
+LockFreeSkipListMap< Key, Value, ValuePool >::Unmark(Node* node) {
+  return reinterpret_cast<Node*>(
+    reinterpret_cast<size_t>(node) & ~static_cast<size_t>(1));
+}
+
+template< typename Key, typename Value, typename ValuePool >
+bool LockFreeSkipListMap< Key, Value, ValuePool >::IsMarked(Node* node) {
+  return (reinterpret_cast<size_t>(node) & 1) != 0;
+}
+
+template< typename Key, typename Value, typename ValuePool >
+LockFreeSkipListMap< Key, Value, ValuePool >::LockFreeSkipListMap(
+  size_t capacity) :
+  capacity(capacity),
+  height(1),
+  random_count(embb::base::Thread::GetThreadsMaxCount()),
+  random_states(NULL),
+  yield_while_linking(false),
+// Disable "this is used in base member initializer" warning.
+// We explicitly want this.
+#ifdef EMBB_PLATFORM_COMPILER_MSVC
+#pragma warning(push)
+#pragma warning(disable:4355)
+#endif
+  delete_pointer_callback(*this, &LockFreeSkipListMap::DeletePointerCallback),
+#ifdef EMBB_PLATFORM_COMPILER_MSVC
+#pragma warning(pop)
+#endif
+  // Node pool, size with respect to the maximum number of retired nodes not
+  // eligible for reuse, and one node per thread allocated for an insertion
+  // not yet done with linking it into the map:
+  node_pool(
+    internal::EpochReclamation< Node* >::ComputeMaximumRetiredObjectCount(1) +
+    embb::base::Thread::GetThreadsMaxCount() +
+    capacity),
+  reclamation(delete_pointer_callback, NULL, 1) {
+  // Enough levels to find a key in a full map in logarithmic time
+  while (height < MAX_HEIGHT &&
+    (static_cast<size_t>(1) << height) < capacity) {
+    ++height;
+  }
+  for (int level = 0; level != MAX_HEIGHT; ++level) {
+    head[level] = NULL;
+  }
+  random_states = static_cast<unsigned int*>(
+    embb::base::Allocation::AllocateCacheAligned(
+    sizeof(unsigned int) * RANDOM_STRIDE * random_count));
+  for (unsigned int thread = 0; thread != random_count; ++thread) {
+    // xorshift needs a nonzero state
+    random_states[thread * RANDOM_STRIDE] = thread * 2654435761u + 1;
+  }
+}
+
+template< typename Key, typename Value, typename ValuePool >
+LockFreeSkipListMap< Key, Value, ValuePool >::~LockFreeSkipListMap() {
+  // The nodes still in the map are returned to the pool here, the retired
+  // ones by the reclamation
+  Node* node = head[0];
+  while (node != NULL) {
+    Node* next = Unmark(node->next[0]);
+    node_pool.Free(node);
+    node = next;
+  }
+  embb::base::Allocation::FreeAligned(random_states);
+}
+
+template< typename Key, typename Value, typename ValuePool >
+size_t LockFreeSkipListMap< Key, Value, ValuePool >::GetCapacity() {
+  return capacity;
+}
+
+template< typename Key, typename Value, typename ValuePool >
+embb::base::Atomic< typename LockFreeSkipListMap< Key, Value,
+  ValuePool >::Node* >&
+LockFreeSkipListMap< Key, Value, ValuePool >::Link(Node* node, int level) {
+  return node == NULL ? head[level] : node->next[level];
+}
+
+template< typename Key, typename Value, typename ValuePool >
+int LockFreeSkipListMap< Key, Value, ValuePool >::RandomHeight() {
+  unsigned int thread_index;
+  if (embb_internal_thread_index(&thread_index) != EMBB_SUCCESS ||
+    thread_index >= random_count) {
+    return 1;
+  }
+  // xorshift, only the calling thread uses its state
+  unsigned int& random = random_states[thread_index * RANDOM_STRIDE];
+  random ^= random << 13;
+  random ^= random >> 17;
+  random ^= random << 5;
+  // One more level for every trailing one bit
+  int result = 1;
+  for (unsigned int bits = random; result < height && (bits & 1) != 0;
+    bits >>= 1) {
+    ++result;
+  }
+  return result;
+}
+
+template< typename Key, typename Value, typename ValuePool >
+bool LockFreeSkipListMap< Key, Value, ValuePool >::Search(
+  Key const & key, Node** predecessors, Node** successors) {
+  for (;;) {
+    Node* predecessor = NULL;
+    bool retry = false;
+    for (int level = height - 1; level >= 0 && !retry; --level) {
+      Node* current = Unmark(Link(predecessor, level));
+      while (current != NULL) {
+        Node* next = current->next[level];
+        if (IsMarked(next)) {
+          // The current node has been removed from this level, help
+          // unlinking it. Fails if the predecessor has been removed, too,
+          // then start over.
+          Node* expected = current;
+          if (!Link(predecessor, level).CompareAndSwap(expected,
+            Unmark(next))) {
+            retry = true;
+            break;
+          }
+          current = Unmark(next);
+        } else if (current->key < key) {
+          predecessor = current;
+          current = next;
+        } else {
+          break;
+        }
+      }
+      predecessors[level] = predecessor;
+      successors[level] = current;
+    }
+    if (!retry) {
+      return successors[0] != NULL && !(key < successors[0]->key);
+    }
+  }
+}
+
+template< typename Key, typename Value, typename ValuePool >
+void LockFreeSkipListMap< Key, Value, ValuePool >::Release(Node* node) {
+  if (node->pending_releases.FetchAndSub(1) == 1) {
+    reclamation.EnqueueForDeletion(node);
+  }
+}
+
+template< typename Key, typename Value, typename ValuePool >
+bool LockFreeSkipListMap< Key, Value, ValuePool >::TryInsert(
+  Key const & key, Value const & value) {
+  Node* predecessors[MAX_HEIGHT];
+  Node* successors[MAX_HEIGHT];
+  Node* node = NULL;
+  reclamation.EnterCriticalSection();
+  for (;;) {
+    if (Search(key, predecessors, successors)) {
+      // Key already contained, the node was never visible to others
+      if (node != NULL)
+        node_pool.Free(node);
+      reclamation.LeaveCriticalSection();
+      return false;
+    }
+    if (node == NULL) {
+      node = node_pool.Allocate(key, value, RandomHeight());
+      // Map full, cannot insert
+      if (node == NULL) {
+        reclamation.LeaveCriticalSection();
+        return false;
+      }
+    }
+    for (int level = 0; level != node->height; ++level) {
+      node->next[level] = successors[level];
+    }
+    Node* expected = successors[0];
+    if (Link(predecessors[0], 0).CompareAndSwap(expected, node))
+      break;
+  }
+
+  // The key is inserted, link the node into the upper levels. Until it is,
+  // only an erase changes the links of the node on a level, by marking them.
+  bool erased = false;
+  for (int level = 1; level < node->height && !erased; ++level) {
+    for (;;) {
+      Node* next = node->next[level];
+      if (next != successors[level] &&
+        (IsMarked(next) ||
+        !node->next[level].CompareAndSwap(next, successors[level]))) {
+        erased = true;
+        break;
+      }
+      if (yield_while_linking) {
+        embb::base::Thread::CurrentYield();
+      }
+      Node* expected = successors[level];
+      if (Link(predecessors[level], level).CompareAndSwap(expected, node))
+        break;
+      // Someone else changed the link, search the new position
+      Search(key, predecessors, successors);
+    }
+  }
+  if (IsMarked(node->next[0])) {
+    // The node has been erased meanwhile, and may have been linked into a
+    // level after the erase unlinked it there
+    Search(key, predecessors, successors);
+  }
+  Release(node);
+  reclamation.LeaveCriticalSection();
+  return true;
+}
+
+template< typename Key, typename Value, typename ValuePool >
+bool LockFreeSkipListMap< Key, Value, ValuePool >::TryGet(
+  Key const & key, Value & value) {
+  Node* predecessors[MAX_HEIGHT];
+  Node* successors[MAX_HEIGHT];
+  reclamation.EnterCriticalSection();
+  bool found = Search(key, predecessors, successors);
+  if (found) {
+    // Values of nodes in the map are not changed
+    value = successors[0]->value;
+  }
+  reclamation.LeaveCriticalSection();
+  return found;
+}
+
+template< typename Key, typename Value, typename ValuePool >
+bool LockFreeSkipListMap< Key, Value, ValuePool >::TryErase(
+  Key const & key) {
+  Node* predecessors[MAX_HEIGHT];
+  Node* successors[MAX_HEIGHT];
+  reclamation.EnterCriticalSection();
+  if (!Search(key, predecessors, successors)) {
+    reclamation.LeaveCriticalSection();
+    return false;
+  }
+  Node* node = successors[0];
+  // Mark the upper levels from the top down, so that an insertion still
+  // linking the node notices
+  for (int level = node->height - 1; level > 0; --level) {
+    Node* next = node->next[level];
+    while (!IsMarked(next) &&
+      !node->next[level].CompareAndSwap(next, Mark(next))) {
+    }
+  }
+  // Marking the lowest level erases the key, only one thread succeeds
+  Node* next = node->next[0];
+  for (;;) {
+    if (IsMarked(next)) {
+      reclamation.LeaveCriticalSection();
+      return false;
+    }
+    if (node->next[0].CompareAndSwap(next, Mark(next)))
+      break;
+  }
+  // Unlink the node from every level, an insertion still linking it
+  // unlinks it again
+  Search(key, predecessors, successors);
+  Release(node);
+  reclamation.LeaveCriticalSection();
+  return true;
+}
+
+template< typename Key, typename Value, typename ValuePool >
+template< typename OutputIterator >
+size_t LockFreeSkipListMap< Key, Value, ValuePool >::GetRange(
+  Key const & lower, Key const & upper, OutputIterator out, size_t max) {
+  Node* predecessors[MAX_HEIGHT];
+  Node* successors[MAX_HEIGHT];
+  size_t count = 0;
+  reclamation.EnterCriticalSection();
+  Search(lower, predecessors, successors);
+  Node* node = successors[0];
+  while (count < max && node != NULL && node->key < upper) {
+    // The links of erased nodes still lead to nodes that were their
+    // successors when they were erased
+    Node* next = node->next[0];
+    if (!IsMarked(next)) {
+      *out = std::pair<Key, Value>(node->key, node->value);
+      ++out;
+      ++count;
+    }
+    node = Unmark(next);
+  }
+  reclamation.LeaveCriticalSection();
+  return count;
+}
+} // namespace containers
+} // namespace embb
+
+#endif  // EMBB_CONTAINERS_INTERNAL_LOCK_FREE_SKIP_LIST_MAP_INL_H_
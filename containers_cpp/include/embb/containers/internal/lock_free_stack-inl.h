@@ -30,8 +30,9 @@
 #include <embb/base/internal/config.h>
 
 /*
- * The following algorithm uses hazard pointers and a lock-free value pool for
- * memory management. For a description of the algorithm, see
+ * The following algorithm uses hazard pointers (or epochs, depending on the
+ * reclamation policy) and a lock-free value pool for memory management. For
+ * a description of the algorithm, see
  * Maged M. Michael. "Hazard pointers: Safe memory reclamation for lock-free
  * objects". IEEE Transactions on Parallel and Distributed Systems, 15.6 (2004):
  * 491-504.
@@ -61,14 +62,16 @@ namespace internal {
   }
 } // namespace internal
 
-template< typename Type, typename ValuePool >
-void LockFreeStack< Type, ValuePool >::
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+void LockFreeStack< Type, ValuePool, Reclamation >::
 DeletePointerCallback(internal::LockFreeStackNode<Type>* to_delete) {
   objectPool.Free(to_delete);
 }
 
-template< typename Type, typename ValuePool >
-LockFreeStack< Type, ValuePool >::LockFreeStack(size_t capacity) :
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+LockFreeStack< Type, ValuePool, Reclamation >::LockFreeStack(size_t capacity) :
 capacity(capacity),
 // Disable "this is used in base member initializer" warning.
 // We explicitly want this.
@@ -77,7 +80,7 @@ capacity(capacity),
 #pragma warning(disable:4355)
 #endif
   delete_pointer_callback(*this,
-    &LockFreeStack<Type>::DeletePointerCallback),
+    &LockFreeStack::DeletePointerCallback),
 #ifdef EMBB_PLATFORM_COMPILER_MSVC
 #pragma warning(pop)
 #endif
@@ -89,18 +92,22 @@ capacity(capacity),
   hazardPointer(delete_pointer_callback, NULL, 1) {
 }
 
-template< typename Type, typename ValuePool >
-size_t LockFreeStack< Type, ValuePool >::GetCapacity() {
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+size_t LockFreeStack< Type, ValuePool, Reclamation >::GetCapacity() {
   return capacity;
 }
 
-template< typename Type, typename ValuePool >
-LockFreeStack< Type, ValuePool >::~LockFreeStack() {
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+LockFreeStack< Type, ValuePool, Reclamation >::~LockFreeStack() {
   // Nothing to do here, did not allocate anything.
 }
 
-template< typename Type, typename ValuePool >
-bool LockFreeStack< Type, ValuePool >::TryPush(Type const& element) {
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+bool LockFreeStack< Type, ValuePool, Reclamation >::TryPush(
+  Type const& element) {
   internal::LockFreeStackNode<Type>* newNode =
     objectPool.Allocate(element);
 
@@ -116,14 +123,17 @@ bool LockFreeStack< Type, ValuePool >::TryPush(Type const& element) {
   }
 }
 
-template< typename Type, typename ValuePool >
-bool LockFreeStack< Type, ValuePool >::TryPop(Type & element) {
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+bool LockFreeStack< Type, ValuePool, Reclamation >::TryPop(Type & element) {
   internal::LockFreeStackNode<Type>* top_cached = top;
+  hazardPointer.EnterCriticalSection();
   for (;;) {
     top_cached = top;
 
     // Stack empty, cannot pop
     if (top_cached == NULL) {
+      hazardPointer.LeaveCriticalSection();
       element = Type();
       return false;
     }
@@ -155,10 +165,63 @@ bool LockFreeStack< Type, ValuePool >::TryPop(Type & element) {
   hazardPointer.Guard(0, NULL);
 
   hazardPointer.EnqueueForDeletion(top_cached);
+  hazardPointer.LeaveCriticalSection();
 
   element = data;
   return true;
 }
+
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+template< typename ForwardIterator >
+size_t LockFreeStack< Type, ValuePool, Reclamation >::TryPushBatch(
+  ForwardIterator first, ForwardIterator last) {
+  // Link the new nodes to a segment whose top is the last element of the
+  // range. The segment is not yet reachable by other threads.
+  internal::LockFreeStackNode<Type>* segment_top = NULL;
+  internal::LockFreeStackNode<Type>* segment_bottom = NULL;
+  size_t count = 0;
+  for (; first != last; ++first) {
+    internal::LockFreeStackNode<Type>* newNode =
+      objectPool.Allocate(*first);
+    // Stack full, push what we have so far
+    if (newNode == NULL)
+      break;
+    newNode->SetNext(segment_top);
+    if (segment_bottom == NULL) {
+      segment_bottom = newNode;
+    }
+    segment_top = newNode;
+    ++count;
+  }
+  if (count == 0)
+    return 0;
+
+  for (;;) {
+    internal::LockFreeStackNode<Type>* top_cached = top;
+    segment_bottom->SetNext(top_cached);
+    if (top.CompareAndSwap(top_cached, segment_top))
+      return count;
+  }
+}
+
+template< typename Type, typename ValuePool,
+  template< typename > class Reclamation >
+template< typename OutputIterator >
+size_t LockFreeStack< Type, ValuePool, Reclamation >::TryPopBatch(
+  OutputIterator out, size_t max) {
+  // Every removed node has to be retired separately, and epoch-based
+  // reclamation permits only one retirement per critical section. Hence,
+  // elements are popped one by one.
+  size_t count = 0;
+  Type element;
+  while (count != max && TryPop(element)) {
+    *out = element;
+    ++out;
+    ++count;
+  }
+  return count;
+}
 } // namespace containers
 } // namespace embb
 
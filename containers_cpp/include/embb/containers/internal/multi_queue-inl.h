@@ -0,0 +1,319 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EMBB_CONTAINERS_INTERNAL_MULTI_QUEUE_INL_H_
+#define EMBB_CONTAINERS_INTERNAL_MULTI_QUEUE_INL_H_
+
+#include <embb/base/c/internal/thread_index.h>
+#include <embb/base/memory_allocation.h>
+#include <embb/base/thread.h>
+
+/*
+ * The following algorithm is described in:
+ * Hamza Rihani, Peter Sanders, and Roman Dementiev. "MultiQueues: Simple
+ * relaxed concurrent priority queues". Proceedings of the 27th ACM symposium
+ * on parallelism in algorithms and architectures. ACM, 2015.
+ *
+ * Every sub-queue is a sequential binary heap behind a spinlock. Its size and
+ * the priority of its top entry are republished after every change, so that
+ * a dequeue can compare two sub-queues without taking their locks. The
+ * comparison may be outdated when the lock is taken, which only affects the
+ * quality of the choice, not its correctness: the sub-queue is checked again
+ * under the lock.
+ *
+ * An operation that keeps finding locked (or full, or empty) sub-queues gives
+ * up choosing at random after as many attempts as there are sub-queues, and
+ * visits all sub-queues in turn. Hence, enqueues only fail if all sub-queues
+ * are full, and dequeues only fail if all sub-queues were found empty.
+ */
+
+namespace embb {
+namespace containers {
+namespace internal {
+template< typename Priority, typename Type, typename Compare >
+MultiQueueSubQueue< Priority, Type, Compare >::
+MultiQueueSubQueue(size_t capacity) :
+  size(0),
+  top(Priority()),
+  capacity(capacity) {
+  entries = static_cast<Entry*>(
+    embb::base::Allocation::Allocate(sizeof(Entry) * capacity));
+  for (size_t i = 0; i != capacity; ++i) {
+    new (&entries[i]) Entry();
+  }
+}
+
+template< typename Priority, typename Type, typename Compare >
+MultiQueueSubQueue< Priority, Type, Compare >::~MultiQueueSubQueue() {
+  for (size_t i = 0; i != capacity; ++i) {
+    entries[i].~Entry();
+  }
+  embb::base::Allocation::Free(entries);
+}
+
+template< typename Priority, typename Type, typename Compare >
+bool MultiQueueSubQueue< Priority, Type, Compare >::Push(
+  Priority const& priority, Type const& element) {
+  size_t count = size.Load();
+  if (count == capacity) {
+    return false;
+  }
+  entries[count].priority = priority;
+  entries[count].element = element;
+  SiftUp(count);
+  top.Store(entries[0].priority);
+  size.Store(count + 1);
+  return true;
+}
+
+template< typename Priority, typename Type, typename Compare >
+void MultiQueueSubQueue< Priority, Type, Compare >::Pop(
+  Priority & priority, Type & element) {
+  size_t count = size.Load() - 1;
+  priority = entries[0].priority;
+  element = entries[0].element;
+  if (count > 0) {
+    entries[0] = entries[count];
+  }
+  // The last entry now lives on at the top or was popped, do not keep its
+  // element alive in the freed slot
+  entries[count] = Entry();
+  if (count > 0) {
+    SiftDown(0, count);
+    top.Store(entries[0].priority);
+  }
+  size.Store(count);
+}
+
+template< typename Priority, typename Type, typename Compare >
+void MultiQueueSubQueue< Priority, Type, Compare >::SiftUp(size_t index) {
+  Entry entry = entries[index];
+  while (index > 0) {
+    size_t parent = (index - 1) / 2;
+    if (!compare(entry.priority, entries[parent].priority)) {
+      break;
+    }
+    entries[index] = entries[parent];
+    index = parent;
+  }
+  entries[index] = entry;
+}
+
+template< typename Priority, typename Type, typename Compare >
+void MultiQueueSubQueue< Priority, Type, Compare >::SiftDown(
+  size_t index, size_t count) {
+  Entry entry = entries[index];
+  for (;;) {
+    size_t child = 2 * index + 1;
+    if (child >= count) {
+      break;
+    }
+    if (child + 1 < count &&
+      compare(entries[child + 1].priority, entries[child].priority)) {
+      ++child;
+    }
+    if (!compare(entries[child].priority, entry.priority)) {
+      break;
+    }
+    entries[index] = entries[child];
+    index = child;
+  }
+  entries[index] = entry;
+}
+
+template< typename Priority, typename Type, typename Compare >
+MultiQueueImpl< Priority, Type, Compare >::MultiQueueImpl(
+  size_t capacity, unsigned int queues_per_thread) :
+  capacity(capacity) {
+  unsigned int thread_count = embb::base::Thread::GetThreadsMaxCount();
+
+  queue_count = thread_count * (queues_per_thread > 0 ? queues_per_thread : 1);
+  size_t queue_capacity = (capacity + queue_count - 1) / queue_count;
+  queue_size = ((sizeof(SubQueue) + EMBB_PLATFORM_CACHE_LINE_SIZE - 1) /
+    EMBB_PLATFORM_CACHE_LINE_SIZE) * EMBB_PLATFORM_CACHE_LINE_SIZE;
+  queues = static_cast<char*>(
+    embb::base::Allocation::AllocateCacheAligned(queue_size * queue_count));
+  for (unsigned int i = 0; i != queue_count; ++i) {
+    new (queues + i * queue_size) SubQueue(queue_capacity);
+  }
+
+  random_count = thread_count;
+  random_states = static_cast<unsigned int*>(
+    embb::base::Allocation::AllocateCacheAligned(
+    sizeof(unsigned int) * RANDOM_STRIDE * random_count));
+  for (unsigned int thread = 0; thread != random_count; ++thread) {
+    // xorshift needs a nonzero state
+    random_states[thread * RANDOM_STRIDE] = thread * 2654435761u + 1;
+  }
+}
+
+template< typename Priority, typename Type, typename Compare >
+MultiQueueImpl< Priority, Type, Compare >::~MultiQueueImpl() {
+  embb::base::Allocation::FreeAligned(random_states);
+  for (unsigned int i = 0; i != queue_count; ++i) {
+    GetSubQueue(i).~SubQueue();
+  }
+  embb::base::Allocation::FreeAligned(queues);
+}
+
+template< typename Priority, typename Type, typename Compare >
+size_t MultiQueueImpl< Priority, Type, Compare >::GetCapacity() {
+  return capacity;
+}
+
+template< typename Priority, typename Type, typename Compare >
+typename MultiQueueImpl< Priority, Type, Compare >::SubQueue&
+MultiQueueImpl< Priority, Type, Compare >::GetSubQueue(unsigned int index) {
+  return *reinterpret_cast<SubQueue*>(queues + index * queue_size);
+}
+
+template< typename Priority, typename Type, typename Compare >
+unsigned int MultiQueueImpl< Priority, Type, Compare >::ChooseSubQueue() {
+  unsigned int thread_index;
+  if (embb_internal_thread_index(&thread_index) != EMBB_SUCCESS ||
+    thread_index >= random_count) {
+    return 0;
+  }
+  // xorshift, only the calling thread uses its state
+  unsigned int& random = random_states[thread_index * RANDOM_STRIDE];
+  random ^= random << 13;
+  random ^= random >> 17;
+  random ^= random << 5;
+  return random % queue_count;
+}
+
+template< typename Priority, typename Type, typename Compare >
+bool MultiQueueImpl< Priority, Type, Compare >::TryEnqueue(
+  Priority const& priority, Type const& element) {
+  for (unsigned int attempt = 0; attempt != queue_count; ++attempt) {
+    SubQueue& queue = GetSubQueue(ChooseSubQueue());
+    if (queue.lock.TryLock()) {
+      bool pushed = queue.Push(priority, element);
+      queue.lock.Unlock();
+      if (pushed) {
+        return true;
+      }
+    }
+  }
+  for (unsigned int i = 0; i != queue_count; ++i) {
+    SubQueue& queue = GetSubQueue(i);
+    queue.lock.Lock();
+    bool pushed = queue.Push(priority, element);
+    queue.lock.Unlock();
+    if (pushed) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template< typename Priority, typename Type, typename Compare >
+bool MultiQueueImpl< Priority, Type, Compare >::TryDequeue(
+  Priority & priority, Type & element) {
+  for (unsigned int attempt = 0; attempt != queue_count; ++attempt) {
+    SubQueue* queue = &GetSubQueue(ChooseSubQueue());
+    SubQueue* other = &GetSubQueue(ChooseSubQueue());
+    if (queue->size.Load() == 0 ||
+      (other->size.Load() != 0 &&
+      compare(other->top.Load(), queue->top.Load()))) {
+      queue = other;
+    }
+    if (queue->size.Load() == 0 || !queue->lock.TryLock()) {
+      continue;
+    }
+    if (queue->size.Load() != 0) {
+      queue->Pop(priority, element);
+      queue->lock.Unlock();
+      return true;
+    }
+    queue->lock.Unlock();
+  }
+  for (unsigned int i = 0; i != queue_count; ++i) {
+    SubQueue& queue = GetSubQueue(i);
+    if (queue.size.Load() == 0) {
+      continue;
+    }
+    queue.lock.Lock();
+    if (queue.size.Load() != 0) {
+      queue.Pop(priority, element);
+      queue.lock.Unlock();
+      return true;
+    }
+    queue.lock.Unlock();
+  }
+  return false;
+}
+} // namespace internal
+
+template< typename Type >
+MultiQueue< Type >::MultiQueue(size_t capacity,
+  unsigned int queues_per_thread) :
+  impl(capacity, queues_per_thread),
+  next_ticket(0) {
+}
+
+template< typename Type >
+size_t MultiQueue< Type >::GetCapacity() {
+  return impl.GetCapacity();
+}
+
+template< typename Type >
+bool MultiQueue< Type >::TryEnqueue(Type const& element) {
+  return impl.TryEnqueue(next_ticket.FetchAndAdd(1), element);
+}
+
+template< typename Type >
+bool MultiQueue< Type >::TryDequeue(Type & element) {
+  size_t ticket;
+  return impl.TryDequeue(ticket, element);
+}
+
+template< typename Priority, typename Type, typename Compare >
+PriorityMultiQueue< Priority, Type, Compare >::PriorityMultiQueue(
+  size_t capacity, unsigned int queues_per_thread) :
+  impl(capacity, queues_per_thread) {
+}
+
+template< typename Priority, typename Type, typename Compare >
+size_t PriorityMultiQueue< Priority, Type, Compare >::GetCapacity() {
+  return impl.GetCapacity();
+}
+
+template< typename Priority, typename Type, typename Compare >
+bool PriorityMultiQueue< Priority, Type, Compare >::TryEnqueue(
+  Priority const& priority, Type const& element) {
+  return impl.TryEnqueue(priority, element);
+}
+
+template< typename Priority, typename Type, typename Compare >
+bool PriorityMultiQueue< Priority, Type, Compare >::TryDequeue(
+  Priority & priority, Type & element) {
+  return impl.TryDequeue(priority, element);
+}
+} // namespace containers
+} // namespace embb
+
+#endif  // EMBB_CONTAINERS_INTERNAL_MULTI_QUEUE_INL_H_
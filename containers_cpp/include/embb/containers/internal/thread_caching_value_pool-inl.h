@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EMBB_CONTAINERS_INTERNAL_THREAD_CACHING_VALUE_POOL_INL_H_
+#define EMBB_CONTAINERS_INTERNAL_THREAD_CACHING_VALUE_POOL_INL_H_
+
+#include <embb/base/c/internal/thread_index.h>
+#include <embb/base/memory_allocation.h>
+#include <embb/base/thread.h>
+
+#include <cassert>
+#include <new>
+
+namespace embb {
+namespace containers {
+namespace internal {
+template<typename Type, unsigned int Size>
+ThreadCachingValuePoolMagazine<Type, Size>::ThreadCachingValuePoolMagazine()
+  : count(0) {
+}
+} // namespace internal
+
+template<typename Type, Type Undefined, class ValuePool,
+  unsigned int MagazineSize >
+typename ThreadCachingValuePool<Type, Undefined, ValuePool,
+  MagazineSize>::Magazine*
+ThreadCachingValuePool<Type, Undefined, ValuePool, MagazineSize>::
+GetMagazine() {
+  unsigned int thread_index;
+  if (embb_internal_thread_index(&thread_index) != EMBB_SUCCESS ||
+    thread_index >= magazine_count_) {
+    return NULL;
+  }
+  return &GetMagazine(thread_index);
+}
+
+template<typename Type, Type Undefined, class ValuePool,
+  unsigned int MagazineSize >
+typename ThreadCachingValuePool<Type, Undefined, ValuePool,
+  MagazineSize>::Magazine &
+ThreadCachingValuePool<Type, Undefined, ValuePool, MagazineSize>::
+GetMagazine(unsigned int thread_index) {
+  return *reinterpret_cast<Magazine*>(
+    magazines_ + thread_index * magazine_size_);
+}
+
+template<typename Type, Type Undefined, class ValuePool,
+  unsigned int MagazineSize >
+void ThreadCachingValuePool<Type, Undefined, ValuePool, MagazineSize>::
+ReturnCachedElements() {
+  for (unsigned int i = 0; i != magazine_count_; ++i) {
+    Magazine& magazine = GetMagazine(i);
+    while (magazine.count > 0) {
+      magazine.count--;
+      value_pool_.Free(magazine.elements[magazine.count],
+        magazine.indices[magazine.count]);
+    }
+  }
+}
+
+template<typename Type, Type Undefined, class ValuePool,
+  unsigned int MagazineSize >
+typename ThreadCachingValuePool<Type, Undefined, ValuePool,
+  MagazineSize>::Iterator
+ThreadCachingValuePool<Type, Undefined, ValuePool, MagazineSize>::Begin() {
+  ReturnCachedElements();
+  return value_pool_.Begin();
+}
+
+template<typename Type, Type Undefined, class ValuePool,
+  unsigned int MagazineSize >
+typename ThreadCachingValuePool<Type, Undefined, ValuePool,
+  MagazineSize>::Iterator
+ThreadCachingValuePool<Type, Undefined, ValuePool, MagazineSize>::End() {
+  return value_pool_.End();
+}
+
+template<typename Type, Type Undefined, class ValuePool,
+  unsigned int MagazineSize >
+template<typename ForwardIterator>
+ThreadCachingValuePool<Type, Undefined, ValuePool, MagazineSize>::
+ThreadCachingValuePool(ForwardIterator first, ForwardIterator last) :
+  value_pool_(first, last),
+  magazine_count_(embb::base::Thread::GetThreadsMaxCount()),
+  magazine_size_(
+    ((sizeof(Magazine) + EMBB_PLATFORM_CACHE_LINE_SIZE - 1) /
+    EMBB_PLATFORM_CACHE_LINE_SIZE) * EMBB_PLATFORM_CACHE_LINE_SIZE) {
+  magazines_ = static_cast<char*>(
+    embb::base::Allocation::AllocateCacheAligned(
+    magazine_size_ * magazine_count_));
+  for (unsigned int i = 0; i != magazine_count_; ++i) {
+    // in-place new for each magazine
+    new (magazines_ + i * magazine_size_) Magazine;
+  }
+}
+
+template<typename Type, Type Undefined, class ValuePool,
+  unsigned int MagazineSize >
+ThreadCachingValuePool<Type, Undefined, ValuePool, MagazineSize>::
+~ThreadCachingValuePool() {
+  for (unsigned int i = 0; i != magazine_count_; ++i) {
+    GetMagazine(i).~Magazine();
+  }
+  embb::base::Allocation::FreeAligned(magazines_);
+}
+
+template<typename Type, Type Undefined, class ValuePool,
+  unsigned int MagazineSize >
+size_t ThreadCachingValuePool<Type, Undefined, ValuePool, MagazineSize>::
+GetMinimumElementCountForGuaranteedCapacity(size_t capacity) {
+  // the elements cached by the threads are not available to others
+  return ValuePool::GetMinimumElementCountForGuaranteedCapacity(capacity +
+    2 * MagazineSize * embb::base::Thread::GetThreadsMaxCount());
+}
+
+template<typename Type, Type Undefined, class ValuePool,
+  unsigned int MagazineSize >
+int ThreadCachingValuePool<Type, Undefined, ValuePool, MagazineSize>::
+Allocate(Type & element) {
+  Magazine* magazine = GetMagazine();
+  if (magazine == NULL) {
+    int index = value_pool_.Allocate(element);
+    if (index == -1) {
+      element = Type();
+    }
+    return index;
+  }
+
+  if (magazine->count == 0) {
+    // Refill half of the magazine, keeping room for elements freed next
+    while (magazine->count != MagazineSize) {
+      Type refill;
+      int index = value_pool_.Allocate(refill);
+      if (index == -1)
+        break;
+      magazine->elements[magazine->count] = refill;
+      magazine->indices[magazine->count] = index;
+      magazine->count++;
+    }
+    if (magazine->count == 0) {
+      element = Type();
+      return -1;
+    }
+  }
+
+  magazine->count--;
+  element = magazine->elements[magazine->count];
+  return magazine->indices[magazine->count];
+}
+
+template<typename Type, Type Undefined, class ValuePool,
+  unsigned int MagazineSize >
+void ThreadCachingValuePool<Type, Undefined, ValuePool, MagazineSize>::
+Free(Type element, int index) {
+  assert(element != Undefined);
+
+  Magazine* magazine = GetMagazine();
+  if (magazine == NULL) {
+    value_pool_.Free(element, index);
+    return;
+  }
+
+  if (magazine->count == 2 * MagazineSize) {
+    // Return the older half, the recently freed elements are still cached
+    for (unsigned int i = 0; i != MagazineSize; ++i) {
+      value_pool_.Free(magazine->elements[i], magazine->indices[i]);
+    }
+    for (unsigned int i = 0; i != MagazineSize; ++i) {
+      magazine->elements[i] = magazine->elements[i + MagazineSize];
+      magazine->indices[i] = magazine->indices[i + MagazineSize];
+    }
+    magazine->count = MagazineSize;
+  }
+
+  magazine->elements[magazine->count] = element;
+  magazine->indices[magazine->count] = index;
+  magazine->count++;
+}
+
+} // namespace containers
+} // namespace embb
+
+#endif  // EMBB_CONTAINERS_INTERNAL_THREAD_CACHING_VALUE_POOL_INL_H_
@@ -32,8 +32,18 @@
  * Maurice Herlihy and Nir Shavit. "The Art of Multiprocessor Programming."
  * Page 46. Morgan Kaufmann, 2008. (original: L. Lamport. "Specifying concurrent
  * programs").
+ *
+ * Producer and consumer each keep a copy of the other side's index and only
+ * read the shared index again when their copy makes the queue look full or
+ * empty, respectively. Together with the padding between the fields of the
+ * producer and the consumer, this keeps the cache lines of the two sides from
+ * bouncing back and forth while the queue is neither full nor empty.
  */
 
+#ifdef EMBB_PLATFORM_HAS_RVALUE_REFERENCES
+#include <utility>
+#endif
+
 namespace embb {
 namespace containers {
 template<typename Type, class Allocator>
@@ -47,8 +57,11 @@ AlignCapacityToPowerOfTwo(size_t capacity) {
 template<typename Type, class Allocator>
 WaitFreeSPSCQueue<Type, Allocator>::WaitFreeSPSCQueue(size_t capacity)
     : capacity(AlignCapacityToPowerOfTwo(capacity)),
+      mask(this->capacity - 1),
+      tail_index(0),
+      cached_head_index(0),
       head_index(0),
-      tail_index(0) {
+      cached_tail_index(0) {
   queue_array = allocator.allocate(this->capacity);
 }
 
@@ -59,25 +72,101 @@ size_t WaitFreeSPSCQueue<Type, Allocator>::GetCapacity() {
 
 template<typename Type, class Allocator>
 bool WaitFreeSPSCQueue<Type, Allocator>::TryEnqueue(Type const & element) {
-  if (tail_index - head_index == capacity)
-    return false;
+  size_t tail = tail_index.Load();
+  if (tail - cached_head_index == capacity) {
+    cached_head_index = head_index.Load();
+    if (tail - cached_head_index == capacity)
+      return false;
+  }
+
+  queue_array[tail & mask] = element;
+  tail_index.Store(tail + 1);
+  return true;
+}
+
+#ifdef EMBB_PLATFORM_HAS_RVALUE_REFERENCES
+template<typename Type, class Allocator>
+bool WaitFreeSPSCQueue<Type, Allocator>::TryEnqueue(Type && element) {
+  size_t tail = tail_index.Load();
+  if (tail - cached_head_index == capacity) {
+    cached_head_index = head_index.Load();
+    if (tail - cached_head_index == capacity)
+      return false;
+  }
 
-  queue_array[tail_index % capacity] = element;
-  this->tail_index++;
+  queue_array[tail & mask] = std::move(element);
+  tail_index.Store(tail + 1);
   return true;
 }
+#endif
 
 template<typename Type, class Allocator>
 bool WaitFreeSPSCQueue<Type, Allocator>::TryDequeue(Type & element) {
-  if (tail_index - head_index == 0)
-    return false;
+  size_t head = head_index.Load();
+  if (cached_tail_index == head) {
+    cached_tail_index = tail_index.Load();
+    if (cached_tail_index == head)
+      return false;
+  }
 
-  Type x = queue_array[head_index % capacity];
-  this->head_index++;
-  element = x;
+#ifdef EMBB_PLATFORM_HAS_RVALUE_REFERENCES
+  element = std::move(queue_array[head & mask]);
+#else
+  element = queue_array[head & mask];
+#endif
+  head_index.Store(head + 1);
   return true;
 }
 
+template<typename Type, class Allocator>
+template<typename ForwardIterator>
+size_t WaitFreeSPSCQueue<Type, Allocator>::TryEnqueueBatch(
+  ForwardIterator first, ForwardIterator last) {
+  // Only the producer writes tail_index, so it is read once and published
+  // after all elements of the batch have been written.
+  size_t tail = tail_index.Load();
+  size_t free_slots = capacity - (tail - cached_head_index);
+  size_t count = 0;
+  for (; first != last; ++first, ++count) {
+    if (count == free_slots) {
+      cached_head_index = head_index.Load();
+      free_slots = capacity - (tail - cached_head_index);
+      if (count == free_slots)
+        break;
+    }
+    queue_array[(tail + count) & mask] = *first;
+  }
+  if (count > 0) {
+    tail_index.Store(tail + count);
+  }
+  return count;
+}
+
+template<typename Type, class Allocator>
+template<typename OutputIterator>
+size_t WaitFreeSPSCQueue<Type, Allocator>::TryDequeueBatch(
+  OutputIterator out, size_t max) {
+  size_t head = head_index.Load();
+  if (cached_tail_index - head < max) {
+    cached_tail_index = tail_index.Load();
+  }
+  size_t available = cached_tail_index - head;
+  if (available > max) {
+    available = max;
+  }
+  for (size_t i = 0; i != available; ++i, ++out) {
+#ifdef EMBB_PLATFORM_HAS_RVALUE_REFERENCES
+    *out = std::move(queue_array[(head + i) & mask]);
+#else
+    *out = queue_array[(head + i) & mask];
+#endif
+  }
+  if (available > 0) {
+    head_index.Store(head + available);
+  }
+  return available;
+}
+
 template<typename Type, class Allocator>
 WaitFreeSPSCQueue<Type, Allocator>::~WaitFreeSPSCQueue() {
   allocator.deallocate(queue_array, capacity);
@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EMBB_CONTAINERS_LOCK_FREE_BITMAP_VALUE_POOL_H_
+#define EMBB_CONTAINERS_LOCK_FREE_BITMAP_VALUE_POOL_H_
+
+#include <embb/base/atomic.h>
+#include <embb/base/memory_allocation.h>
+#include <iterator>
+#include <utility>
+
+namespace embb {
+namespace containers {
+/**
+ * Lock-free value pool using a bitmap of free elements
+ *
+ * Every element has a bit telling whether it is in the pool, 32 elements
+ * share an atomic word. An allocation claims the lowest set bit of a word
+ * with a single compare-and-swap. Each thread starts searching at the word of
+ * its last allocation or deallocation, so threads mostly work on different
+ * words and pairs of allocations and deallocations do not scan the pool.
+ *
+ * \concept{CPP_CONCEPTS_VALUE_POOL}
+ *
+ * \ingroup CPP_CONTAINERS_POOLS
+ *
+ * \see WaitFreeArrayValuePool, LockFreeTreeValuePool
+ *
+ * \tparam Type Element type
+ * \tparam Undefined Bottom element (cannot be stored in the pool)
+ * \tparam PoolAllocator Allocator used to allocate the element array
+ * \tparam BitmapAllocator Allocator used to allocate the bitmap
+ */
+template<typename Type,
+  Type Undefined,
+  class PoolAllocator = embb::base::Allocator< Type >,
+  class BitmapAllocator =
+    embb::base::Allocator< embb::base::Atomic<unsigned int> > >
+class LockFreeBitmapValuePool {
+ private:
+  /**
+   * Number of elements per word of the bitmap
+   */
+  static const unsigned int BITS_PER_WORD = 32;
+
+  /**
+   * Distance of the hints of two threads in the hint array, keeps them on
+   * separate cache lines
+   */
+  static const unsigned int HINT_STRIDE =
+    EMBB_PLATFORM_CACHE_LINE_SIZE / sizeof(unsigned int);
+
+  int size_;
+  unsigned int word_count_;
+  Type* pool_array_;
+  embb::base::Atomic<unsigned int>* bitmap_;
+  unsigned int hint_count_;
+  unsigned int* hints_;
+  PoolAllocator pool_allocator_;
+  BitmapAllocator bitmap_allocator_;
+
+  LockFreeBitmapValuePool();
+
+  // Prevent copy-construction
+  LockFreeBitmapValuePool(const LockFreeBitmapValuePool&);
+
+  // Prevent assignment
+  LockFreeBitmapValuePool& operator=(const LockFreeBitmapValuePool&);
+
+  /**
+   * Returns the word to start the next search of the calling thread at, or
+   * \c NULL if the thread has no index.
+   */
+  unsigned int* GetHint();
+
+  /**
+   * Returns the index of the lowest set bit of a non-zero word
+   */
+  static unsigned int FindFirstSet(unsigned int word);
+
+  /**
+   * Returns whether the element at the given index is in the pool
+   */
+  bool IsInPool(int index);
+
+ public:
+  /**
+   * Forward iterator to iterate over the allocated elements of the pool.
+   * \note Iterators are invalidated by any change to the pool
+   *       (Allocate and Free calls).
+   */
+  class Iterator : public std::iterator<
+    std::forward_iterator_tag, std::pair<int, Type> > {
+   private:
+    explicit Iterator(LockFreeBitmapValuePool * pool);
+    Iterator(LockFreeBitmapValuePool * pool, int index);
+    void Advance();
+
+    LockFreeBitmapValuePool * pool_;
+    int index_;
+
+    friend class LockFreeBitmapValuePool;
+
+   public:
+    /**
+     * Constructs an invalid iterator.
+     * \waitfree
+     */
+    Iterator();
+
+    /**
+     * Copies an iterator.
+     * \waitfree
+     */
+    Iterator(
+      Iterator const & other           /**< [IN] Iterator to copy. */
+    );
+
+    /**
+     * Copies an iterator.
+     *
+     * \returns Reference to this iterator.
+     * \waitfree
+     */
+    Iterator & operator =(
+      Iterator const & other           /**< [IN] Iterator to copy. */
+    );
+
+    /**
+     * Pre-increments an iterator.
+     *
+     * \returns Reference to this iterator.
+     * \notthreadsafe
+     */
+    Iterator & operator ++();
+
+    /**
+     * Post-increments an iterator.
+     *
+     * \returns Copy of this iterator before increment.
+     * \notthreadsafe
+     */
+    Iterator operator ++(int);
+
+    /**
+     * Compares two iterators for equality.
+     *
+     * \returns \c true, if the two iterators are equal,
+     *          \c false otherwise.
+     * \waitfree
+     */
+    bool operator ==(
+      Iterator const & rhs             /**< [IN] Iterator to compare to. */
+    );
+
+    /**
+     * Compares two iterators for inequality.
+     *
+     * \returns \c true, if the two iterators are not equal,
+     *          \c false otherwise.
+     * \waitfree
+     */
+    bool operator !=(
+      Iterator const & rhs             /**< [IN] Iterator to compare to. */
+    );
+
+    /**
+     * Dereferences the iterator.
+     *
+     * \returns A pair consisting of index and value of the element pointed to.
+     * \waitfree
+     */
+    std::pair<int, Type> operator *();
+  };
+
+  /**
+   * Gets a forward iterator to the first allocated element in the pool.
+   *
+   * \returns a forward iterator pointing to the first allocated element.
+   * \waitfree
+   */
+  Iterator Begin();
+
+  /**
+   * Gets a forward iterator pointing after the last allocated element in
+   * the pool.
+   *
+   * \returns a forward iterator pointing after the last allocated element.
+   * \waitfree
+   */
+  Iterator End();
+
+  /**
+   * Constructs a pool and fills it with the elements in the specified range.
+   *
+   * \memory Dynamically allocates <tt>n*sizeof(Type)</tt> bytes for the
+   *         elements and <tt>ceil(n/32)*sizeof(embb::base::Atomic<unsigned
+   *         int>)</tt> bytes for the bitmap, where
+   *         <tt>n = std::distance(first, last)</tt> is the number of pool
+   *         elements. Additionally allocates a cache line per thread for the
+   *         search hints.
+   *
+   * \notthreadsafe
+   *
+   * \see CPP_CONCEPTS_VALUE_POOL
+   */
+  template<typename ForwardIterator>
+  LockFreeBitmapValuePool(
+    ForwardIterator first,
+    /**< [IN] Iterator pointing to the first element of the range the pool is
+              filled with */
+    ForwardIterator last
+    /**< [IN] Iterator pointing to the last plus one element of the range the
+              pool is filled with */
+  );
+
+  /**
+   * Due to concurrency effects, a pool might provide less elements than managed
+   * by it. However, usually one wants to guarantee a minimal capacity. The
+   * count of elements that must be given to the pool when to guarantee \c
+   * capacity elements is computed using this function.
+   *
+   * \return count of indices the pool has to be initialized with
+   */
+  static size_t GetMinimumElementCountForGuaranteedCapacity(
+    size_t capacity
+    /**< [IN] count of indices that shall be guaranteed */);
+
+  /**
+   * Destructs the pool.
+   *
+   * \notthreadsafe
+   */
+  ~LockFreeBitmapValuePool();
+
+  /**
+   * Allocates an element from the pool.
+   *
+   * \return Index of the element if the pool is not empty, otherwise \c -1.
+   *
+   * \lockfree
+   *
+   * \see CPP_CONCEPTS_VALUE_POOL
+   */
+  int Allocate(
+    Type & element
+    /**< [IN,OUT] Reference to the allocated element. Unchanged, if the
+                  operation was not successful. */
+  );
+
+  /**
+   * Returns an element to the pool.
+   *
+   * \note The element must have been allocated with Allocate().
+   *
+   * \waitfree
+   *
+   * \see CPP_CONCEPTS_VALUE_POOL
+   */
+  void Free(
+    Type element,
+    /**< [IN] Element to be returned to the pool */
+    int index
+    /**< [IN] Index of the element as obtained by Allocate() */
+  );
+};
+} // namespace containers
+} // namespace embb
+
+#include <embb/containers/internal/lock_free_bitmap_value_pool-inl.h>
+
+#endif  // EMBB_CONTAINERS_LOCK_FREE_BITMAP_VALUE_POOL_H_
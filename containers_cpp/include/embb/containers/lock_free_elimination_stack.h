@@ -0,0 +1,353 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EMBB_CONTAINERS_LOCK_FREE_ELIMINATION_STACK_H_
+#define EMBB_CONTAINERS_LOCK_FREE_ELIMINATION_STACK_H_
+
+#include <embb/base/c/internal/config.h>
+#include <embb/base/atomic.h>
+#include <embb/base/function.h>
+#include <embb/containers/object_pool.h>
+#include <embb/containers/lock_free_stack.h>
+#include <embb/containers/lock_free_tree_value_pool.h>
+#include <embb/containers/internal/hazard_pointer.h>
+#include <embb/containers/internal/epoch_reclamation.h>
+
+// forward declaration for white-box test, used in friend declaration of
+// LockFreeEliminationStack class.
+namespace embb {
+namespace containers {
+namespace test {
+class EliminationStackTest;
+}
+}
+}
+
+namespace embb {
+namespace containers {
+/**
+ * Lock-free stack with elimination backoff
+ *
+ * A push or pop whose compare-and-swap on the top of the stack fails backs
+ * off to a randomly chosen slot of an elimination array instead of retrying
+ * right away. A push and a pop that meet in a slot cancel each other out:
+ * the pop takes the element of the push, and neither of them touches the top
+ * of the stack. Under contention, this turns the top of the stack from a
+ * sequential bottleneck into a source of parallelism. Without contention,
+ * the stack behaves like LockFreeStack.
+ *
+ * \concept{CPP_CONCEPTS_STACK}
+ *
+ * \ingroup CPP_CONTAINERS_STACKS
+ *
+ * \see LockFreeStack
+ *
+ * \tparam Type Type of the stack elements
+ * \tparam ValuePool Type of the value pool used as basis for the ObjectPool
+ *         which stores the elements.
+ * \tparam Reclamation Memory reclamation scheme for popped nodes, either
+ *         internal::HazardPointer or internal::EpochReclamation, see
+ *         LockFreeStack.
+ */
+template< typename Type,
+typename ValuePool = embb::containers::LockFreeTreeValuePool < bool, false >,
+template< typename > class Reclamation = internal::HazardPointer >
+class LockFreeEliminationStack {
+ private:
+  /**
+   * EliminationStackTest is a white-box test that makes pushes and pops meet
+   * in the elimination array, so declaring it as friend.
+   */
+  friend class embb::containers::test::EliminationStackTest;
+
+  typedef internal::LockFreeStackNode<Type> Node;
+
+  /**
+   * Distance of two slots in the elimination array, keeps them on separate
+   * cache lines
+   */
+  static const unsigned int SLOT_STRIDE =
+    EMBB_PLATFORM_CACHE_LINE_SIZE / sizeof(embb::base::Atomic<Node*>) > 0 ?
+    EMBB_PLATFORM_CACHE_LINE_SIZE / sizeof(embb::base::Atomic<Node*>) : 1;
+
+  /**
+   * Distance of the random states of two threads, keeps them on separate
+   * cache lines
+   */
+  static const unsigned int RANDOM_STRIDE =
+    EMBB_PLATFORM_CACHE_LINE_SIZE / sizeof(unsigned int);
+
+  /**
+   * Number of times an operation looks for a partner in its slot at the
+   * first elimination attempt. Doubled after every failed attempt, up to
+   * \c MAX_SPINS.
+   */
+  static const unsigned int MIN_SPINS = 16;
+
+  /**
+   * Upper bound for the time an operation waits for a partner
+   */
+  static const unsigned int MAX_SPINS = 1024;
+
+  /**
+   * The capacity of the stack. It is guaranteed that the stack can hold at
+   * least as many elements, maybe more.
+   */
+  size_t capacity;
+
+  /**
+   * Callback to the method that is called by hazard pointers if a pointer is
+   * not hazardous anymore, i.e., can safely be reused.
+   */
+  embb::base::Function<void, Node*> delete_pointer_callback;
+
+  /**
+   * The callback function, used to cleanup non-hazardous pointers.
+   * \see delete_pointer_callback
+   */
+  void DeletePointerCallback(Node* to_delete);
+
+  /**
+   * The object pool, used for lock-free memory allocation. Has to be
+   * initialized before \c hazardPointer, see LockFreeStack.
+   */
+  ObjectPool< Node, ValuePool > objectPool;
+
+  /**
+   * Definition of the used hazard pointer type
+   */
+  typedef Reclamation< Node* > StackNodeHazardPointer_t;
+
+  /**
+   * The hazard pointer object, used for memory management. Depending on
+   * \c Reclamation, this is an epoch-based reclamation object instead.
+   */
+  StackNodeHazardPointer_t hazardPointer;
+
+  /**
+   * Atomic pointer to the top node of the stack (element that is popped next)
+   */
+  embb::base::Atomic<Node*> top;
+
+  /**
+   * Number of slots in the elimination array
+   */
+  unsigned int slot_count;
+
+  /**
+   * The elimination array, one slot every \c SLOT_STRIDE entries. A slot is
+   * empty, holds the node of a waiting push, the mark of a waiting pop, or,
+   * once a pop has taken the node of a push or a push has handed its node to
+   * a pop, a state only the waiting operation leaves again.
+   */
+  embb::base::Atomic<Node*>* slots;
+
+  /**
+   * Number of threads with a random state
+   */
+  unsigned int random_count;
+
+  /**
+   * States of the random number generators choosing the slots, one every
+   * \c RANDOM_STRIDE entries
+   */
+  unsigned int* random_states;
+
+  /**
+   * Slot contents besides nodes: empty, a pop waits, a pop took the node of
+   * a push
+   */
+  static Node* EmptySlot();
+  static Node* WaitingPop();
+  static Node* TakenNode();
+
+  /**
+   * A node handed to a waiting pop is marked, so that other pops do not
+   * mistake it for the node of a waiting push.
+   */
+  static Node* Mark(Node* node);
+  static Node* Unmark(Node* node);
+  static bool IsMarked(Node* node);
+
+  /**
+   * Returns the slot of the elimination array for the next attempt of the
+   * calling thread.
+   */
+  embb::base::Atomic<Node*>& ChooseSlot();
+
+  /**
+   * Tries to hand \c node to a pop in the elimination array.
+   *
+   * \return \c true if a pop took the node
+   */
+  bool TryEliminatePush(
+    Node* node,
+    /**< [IN] Node of the element to push */
+    unsigned int spins
+    /**< [IN] Number of times to look for a partner */
+  );
+
+  /**
+   * Tries to take the node of a push from the elimination array.
+   *
+   * \return The taken node, or \c NULL if no push came along
+   */
+  Node* TryEliminatePop(
+    unsigned int spins
+    /**< [IN] Number of times to look for a partner */
+  );
+
+  /**
+   * Disable copy construction and assignment.
+   */
+  LockFreeEliminationStack(const LockFreeEliminationStack&);
+  LockFreeEliminationStack& operator=(const LockFreeEliminationStack&);
+
+ public:
+  /**
+   * Creates a stack with the specified capacity.
+   *
+   * \memory
+   * Allocates the same memory as LockFreeStack, plus one cache line per slot
+   * of the elimination array and one cache line per thread for choosing
+   * slots at random.
+   *
+   * \notthreadsafe
+   *
+   * \see CPP_CONCEPTS_STACK
+   */
+  explicit LockFreeEliminationStack(
+    size_t capacity,
+    /**< [IN] Capacity of the stack */
+    unsigned int slot_count = 0
+    /**< [IN] Number of slots in the elimination array. The default of 0 uses
+              one slot per two threads, so that pairs of threads can meet. */
+  );
+
+  /**
+   * Returns the capacity of the stack.
+   *
+   * \return Number of elements the stack can hold.
+   *
+   * \waitfree
+   */
+  size_t GetCapacity();
+
+  /**
+   * Destroys the stack.
+   *
+   * \notthreadsafe
+   */
+  ~LockFreeEliminationStack();
+
+  /**
+   * Tries to push an element onto the stack.
+   *
+   * \return \c true if the element could be pushed, \c false if the stack is
+   * full.
+   *
+   * \lockfree
+   *
+   * \note It might be possible to push more elements onto the stack than its
+   * capacity permits.
+   *
+   * \see CPP_CONCEPTS_STACK
+   */
+  bool TryPush(
+    Type const& element
+    /**< [IN] Const reference to the element that shall be pushed */
+  );
+
+  /**
+   * Tries to pop an element from the stack.
+   *
+   * \return \c true if an element could be popped, \c false if the stack is
+   * empty.
+   *
+   * \lockfree
+   *
+   * \see CPP_CONCEPTS_STACK
+   */
+  bool TryPop(
+    Type & element
+    /**< [IN,OUT] Reference to the popped element. Set to \c Type(), if the
+                  operation was not successful. */
+  );
+
+  /**
+   * Tries to push the elements in the range <tt>[first, last)</tt> onto the
+   * stack.
+   *
+   * Pushes as many elements from the beginning of the range as there are
+   * free nodes, with a single compare-and-swap operation on the top of the
+   * stack, see LockFreeStack::TryPushBatch. Batches do not take part in the
+   * elimination.
+   *
+   * \return Number of elements that were pushed. Less than the size of the
+   * range if the stack became full.
+   *
+   * \lockfree
+   *
+   * \see TryPush
+   *
+   * \tparam ForwardIterator Forward iterator with value type \c Type
+   */
+  template< typename ForwardIterator >
+  size_t TryPushBatch(
+    ForwardIterator first,
+    /**< [IN] Iterator pointing to the first element to push */
+    ForwardIterator last
+    /**< [IN] Iterator pointing beyond the last element to push */
+  );
+
+  /**
+   * Tries to pop up to \c max elements from the stack.
+   *
+   * The popped elements are written to \c out, starting with the top
+   * element. Elements are removed one at a time by TryPop.
+   *
+   * \return Number of elements that were popped. Zero if the stack is empty.
+   *
+   * \lockfree
+   *
+   * \see TryPop
+   *
+   * \tparam OutputIterator Output iterator accepting values of type \c Type
+   */
+  template< typename OutputIterator >
+  size_t TryPopBatch(
+    OutputIterator out,
+    /**< [OUT] Iterator the popped elements are written to */
+    size_t max
+    /**< [IN] Maximum number of elements to pop */
+  );
+};
+} // namespace containers
+} // namespace embb
+
+#include <embb/containers/internal/lock_free_elimination_stack-inl.h>
+
+#endif  // EMBB_CONTAINERS_LOCK_FREE_ELIMINATION_STACK_H_
@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EMBB_CONTAINERS_LOCK_FREE_HASH_MAP_H_
+#define EMBB_CONTAINERS_LOCK_FREE_HASH_MAP_H_
+
+#include <embb/base/atomic.h>
+#include <embb/base/function.h>
+#include <embb/containers/object_pool.h>
+#include <embb/containers/lock_free_tree_value_pool.h>
+#include <embb/containers/internal/hazard_pointer.h>
+
+#include <stddef.h>
+
+/**
+ * \defgroup CPP_CONTAINERS_MAPS Maps
+ * Concurrent associative containers
+ *
+ * \ingroup CPP_CONTAINERS
+ */
+
+namespace embb {
+namespace containers {
+namespace internal {
+/**
+ * Default hash function of LockFreeHashMap
+ *
+ * Converts the key to \c size_t and mixes its bits, so that consecutive keys
+ * are spread over the buckets. Works for integral and enumeration types,
+ * other key types need their own hash function.
+ *
+ * \tparam Key Key type
+ */
+template< typename Key >
+class LockFreeHashMapHash {
+ public:
+  /**
+   * Computes the hash value of a key
+   *
+   * \return Hash value of \c key
+   */
+  size_t operator()(
+    Key const & key
+    /**< [IN] Key to hash */) const;
+};
+
+/**
+ * Default hash function of LockFreeHashMap for pointer keys
+ *
+ * \tparam Key Type the keys point to
+ */
+template< typename Key >
+class LockFreeHashMapHash< Key* > {
+ public:
+  /**
+   * Computes the hash value of a key
+   *
+   * \return Hash value of \c key
+   */
+  size_t operator()(
+    Key* const & key
+    /**< [IN] Key to hash */) const;
+};
+
+/**
+ * Node of a bucket list of a LockFreeHashMap
+ *
+ * Key and value are not changed while the node is in the map, an update
+ * replaces the node. The lowest bit of \c next marks the node as removed.
+ *
+ * \tparam Key Key type
+ * \tparam Value Value type
+ */
+template< typename Key, typename Value >
+class LockFreeHashMapNode {
+ public:
+  /**
+   * Pointer to the next node in the bucket, marked if this node is removed
+   */
+  embb::base::Atomic< LockFreeHashMapNode< Key, Value >* > next;
+
+  /**
+   * The key of the node
+   */
+  Key key;
+
+  /**
+   * The value stored for the key
+   */
+  Value value;
+
+  /**
+   * Creates a node holding the given key and value
+   */
+  LockFreeHashMapNode(
+    Key const & key,
+    /**< [IN] The key */
+    Value const & value
+    /**< [IN] The value */);
+};
+} // namespace internal
+
+/**
+ * Lock-free hash map
+ *
+ * Maps keys to values. Every bucket holds a list of nodes sorted by key,
+ * which is modified with a single compare-and-swap per operation. The number
+ * of buckets is fixed on construction, as is the capacity. Nodes are taken
+ * from an ObjectPool and reclaimed using hazard pointers.
+ *
+ * For a description of the algorithm, see Maged M. Michael. "High
+ * performance dynamic lock-free hash tables and list-based sets". Proceedings
+ * of the 14th ACM Symposium on Parallel Algorithms and Architectures (2002):
+ * 73-82.
+ *
+ * \ingroup CPP_CONTAINERS_MAPS
+ *
+ * \tparam Key Type of the keys. Must be copyable and ordered by
+ *         <tt>operator<</tt>.
+ * \tparam Value Type of the values. Must be copyable.
+ * \tparam Hash Function object computing a \c size_t hash value of a key
+ * \tparam ValuePool Type of the value pool used as basis for the ObjectPool
+ *         which stores the nodes.
+ */
+template< typename Key, typename Value,
+  typename Hash = internal::LockFreeHashMapHash< Key >,
+  typename ValuePool = embb::containers::LockFreeTreeValuePool< bool, false > >
+class LockFreeHashMap {
+ private:
+  /**
+   * Node type of the bucket lists
+   */
+  typedef internal::LockFreeHashMapNode< Key, Value > Node;
+
+  /**
+   * Guard positions of the hazard pointers, following the algorithm: the
+   * successor of the current node, the current node, and the node holding
+   * the link to the current node.
+   */
+  enum {
+    GUARD_NEXT = 0,
+    GUARD_CURRENT = 1,
+    GUARD_PREVIOUS = 2,
+    GUARD_COUNT = 3
+  };
+
+  /**
+   * Position in a bucket list found by Find()
+   */
+  struct Position {
+    /**
+     * Link to the current node, a bucket or the \c next field of a node
+     */
+    embb::base::Atomic< Node* >* previous;
+
+    /**
+     * First node with a key not less than the one searched for, or \c NULL
+     */
+    Node* current;
+
+    /**
+     * Successor of the current node, unmarked
+     */
+    Node* next;
+  };
+
+  /**
+   * The capacity of the map. It is guaranteed that the map can hold at least
+   * as many elements, maybe more.
+   */
+  size_t capacity;
+
+  /**
+   * Number of buckets, a power of two
+   */
+  size_t bucket_count;
+
+  /**
+   * Array holding the heads of the bucket lists
+   */
+  embb::base::Atomic< Node* >* buckets;
+
+  /**
+   * Hash function
+   */
+  Hash hash;
+
+  /**
+   * Callback to the method that is called by hazard pointers if a pointer is
+   * not hazardous anymore, i.e., can safely be reused.
+   */
+  embb::base::Function< void, Node* > delete_pointer_callback;
+
+  /**
+   * The object pool, used for lock-free memory allocation.
+   *
+   * Has to be declared before the hazard pointer object, which might return
+   * nodes to the pool in its destructor.
+   */
+  ObjectPool< Node, ValuePool > object_pool;
+
+  /**
+   * The hazard pointer object, used for memory management
+   */
+  internal::HazardPointer< Node* > hazard_pointer;
+
+  /**
+   * The callback function, used to cleanup non-hazardous pointers.
+   * \see delete_pointer_callback
+   */
+  void DeletePointerCallback(Node* to_delete);
+
+  /**
+   * Returns \c node with the removal mark set
+   */
+  static Node* Mark(Node* node);
+
+  /**
+   * Returns \c node with the removal mark cleared
+   */
+  static Node* Unmark(Node* node);
+
+  /**
+   * Returns whether the removal mark of \c node is set
+   */
+  static bool IsMarked(Node* node);
+
+  /**
+   * Align the number of buckets to the next power of two, at least one
+   */
+  static size_t AlignBucketCountToPowerOfTwo(size_t bucket_count);
+
+  /**
+   * Searches the bucket list of a key and unlinks removed nodes on the way.
+   * Leaves the current node and its neighbors guarded.
+   *
+   * \return \c true if the current node holds \c key
+   */
+  bool Find(
+    Key const & key,
+    /**< [IN] Key to search for */
+    Position & position
+    /**< [OUT] Position of the key in its bucket list */);
+
+  /**
+   * Removes all guards of the calling thread
+   */
+  void ClearGuards();
+
+  /**
+   * Disable copy construction and assignment.
+   */
+  LockFreeHashMap(const LockFreeHashMap&);
+  LockFreeHashMap& operator=(const LockFreeHashMap&);
+
+ public:
+  /**
+   * Creates a hash map with the specified capacity.
+   *
+   * \memory
+   * Let \c t be the maximum number of threads. Allocates the bucket array of
+   * \c 2^k pointers, where \c k is the smallest number such that
+   * <tt>bucket_count <= 2^k</tt> holds, and <tt>capacity + 3*t*t + t</tt>
+   * nodes holding a key, a value and a pointer. Additionally allocates
+   * memory for hazard pointers with three guards per thread.
+   *
+   * \notthreadsafe
+   */
+  explicit LockFreeHashMap(
+    size_t capacity,
+    /**< [IN] Capacity of the map */
+    size_t bucket_count = 0
+    /**< [IN] Number of buckets. The default of 0 uses the capacity, which
+              keeps the lists short as long as the hash function spreads the
+              keys well. */);
+
+  /**
+   * Destroys the hash map.
+   *
+   * \notthreadsafe
+   */
+  ~LockFreeHashMap();
+
+  /**
+   * Returns the capacity of the map.
+   *
+   * \return Number of elements the map can hold.
+   *
+   * \waitfree
+   */
+  size_t GetCapacity();
+
+  /**
+   * Tries to insert a key and its value into the map.
+   *
+   * \return \c true if the key was inserted, \c false if it is already
+   * contained in the map or the map is full.
+   *
+   * \lockfree
+   */
+  bool TryInsert(
+    Key const & key,
+    /**< [IN] Key to insert */
+    Value const & value
+    /**< [IN] Value to store for the key */);
+
+  /**
+   * Inserts a key and its value into the map, or replaces the value if the
+   * key is already contained.
+   *
+   * \return \c true if the value was stored, \c false if the key is not
+   * contained and the map is full.
+   *
+   * \lockfree
+   */
+  bool InsertOrUpdate(
+    Key const & key,
+    /**< [IN] Key to insert or update */
+    Value const & value
+    /**< [IN] Value to store for the key */);
+
+  /**
+   * Tries to get the value stored for a key.
+   *
+   * \return \c true if the key is contained in the map, \c false otherwise.
+   *
+   * \lockfree
+   */
+  bool TryGet(
+    Key const & key,
+    /**< [IN] Key to look up */
+    Value & value
+    /**< [IN,OUT] Reference to the value of the key. Unchanged, if the key is
+                  not contained. */);
+
+  /**
+   * Tries to erase a key and its value from the map.
+   *
+   * \return \c true if the key was erased, \c false if it is not contained.
+   *
+   * \lockfree
+   */
+  bool TryErase(
+    Key const & key
+    /**< [IN] Key to erase */);
+};
+} // namespace containers
+} // namespace embb
+
+#include <embb/containers/internal/lock_free_hash_map-inl.h>
+
+#endif  // EMBB_CONTAINERS_LOCK_FREE_HASH_MAP_H_
@@ -33,6 +33,7 @@
 #include <embb/containers/lock_free_tree_value_pool.h>
 #include <embb/containers/object_pool.h>
 #include <embb/containers/internal/hazard_pointer.h>
+#include <embb/containers/internal/epoch_reclamation.h>
 
 #include <limits>
 #include <stdexcept>
@@ -102,9 +103,14 @@ class LockFreeMPMCQueueNode {
  * \tparam Type Type of the queue elements
  * \tparam ValuePool Type of the value pool used as basis for the ObjectPool
  *         which stores the elements.
+ * \tparam Reclamation Memory reclamation scheme for dequeued nodes, either
+ *         internal::HazardPointer (bounded memory, lock-free) or
+ *         internal::EpochReclamation (cheaper operations, but operations may
+ *         wait for threads stalled inside an operation).
  */
 template< typename Type,
-  typename ValuePool = embb::containers::LockFreeTreeValuePool < bool, false >
+  typename ValuePool = embb::containers::LockFreeTreeValuePool < bool, false >,
+  template< typename > class Reclamation = internal::HazardPointer
 >
 class LockFreeMPMCQueue {
  private:
@@ -135,12 +141,12 @@ class LockFreeMPMCQueue {
   /**
    * Definition of the used hazard pointer type
    */
-  typedef embb::containers::internal::HazardPointer
-    < internal::LockFreeMPMCQueueNode<Type>* >
+  typedef Reclamation< internal::LockFreeMPMCQueueNode<Type>* >
     MPMCQueueNodeHazardPointer_t;
 
   /**
-   * The hazard pointer object, used for memory management.
+   * The hazard pointer object, used for memory management. Depending on
+   * \c Reclamation, this is an epoch-based reclamation object instead.
    */
   MPMCQueueNodeHazardPointer_t hazardPointer;
 
@@ -170,6 +176,8 @@ class LockFreeMPMCQueue {
    * Then, <tt>x*(3*t+1)</tt> elements of size <tt>sizeof(void*)</tt>, \c x
    * elements of size <tt>sizeof(Type)</tt>, and \c capacity+1 elements of size
    * <tt>sizeof(Type)</tt> are allocated.
+   * With internal::EpochReclamation, the retired nodes account for three times
+   * as much memory.
    *
    * \notthreadsafe
    *
@@ -227,6 +235,54 @@ class LockFreeMPMCQueue {
     /**< [IN, OUT] Reference to the dequeued element.
                    Unchanged, if the operation
                    was not successful. */);
+
+  /**
+   * Tries to enqueue the elements in the range <tt>[first, last)</tt>.
+   *
+   * Enqueues as many elements from the beginning of the range as there are
+   * free nodes. The nodes are linked to a chain in advance, which is then
+   * appended to the queue with a single compare-and-swap operation. The
+   * enqueued elements keep their relative order and are not interleaved with
+   * elements of other producers.
+   *
+   * \return Number of elements that were enqueued. Less than the size of the
+   * range if the queue became full.
+   *
+   * \lockfree
+   *
+   * \see TryEnqueue
+   *
+   * \tparam ForwardIterator Forward iterator with value type \c Type
+   */
+  template< typename ForwardIterator >
+  size_t TryEnqueueBatch(
+    ForwardIterator first,
+    /**< [IN] Iterator pointing to the first element to enqueue */
+    ForwardIterator last
+    /**< [IN] Iterator pointing beyond the last element to enqueue */);
+
+  /**
+   * Tries to dequeue up to \c max elements from the queue.
+   *
+   * The dequeued elements are written to \c out in queue order. Elements
+   * are removed one at a time, so elements dequeued by other consumers may
+   * be interleaved.
+   *
+   * \return Number of elements that were dequeued. Zero if the queue is
+   * empty.
+   *
+   * \lockfree
+   *
+   * \see TryDequeue
+   *
+   * \tparam OutputIterator Output iterator accepting values of type \c Type
+   */
+  template< typename OutputIterator >
+  size_t TryDequeueBatch(
+    OutputIterator out,
+    /**< [OUT] Iterator the dequeued elements are written to */
+    size_t max
+    /**< [IN] Maximum number of elements to dequeue */);
 };
 } // namespace containers
 } // namespace embb
@@ -0,0 +1,511 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EMBB_CONTAINERS_LOCK_FREE_SKIP_LIST_MAP_H_
+#define EMBB_CONTAINERS_LOCK_FREE_SKIP_LIST_MAP_H_
+
+#include <embb/base/atomic.h>
+#include <embb/base/function.h>
+#include <embb/containers/lock_free_tree_value_pool.h>
+#include <embb/containers/internal/epoch_reclamation.h>
+
+#include <stddef.h>
+#include <utility>
+
+// forward declaration for white-box test, used in friend declaration of
+// LockFreeSkipListMap class.
+namespace embb {
+namespace containers {
+namespace test {
+template<typename Map_t>
+class SkipListMapTest;
+class SkipListMapMemoryTest;
+} // namespace test
+} // namespace containers
+} // namespace embb
+
+namespace embb {
+namespace containers {
+namespace internal {
+/**
+ * Node of a LockFreeSkipListMap
+ *
+ * Key and value are not changed while the node is in the map. The node links
+ * to its successors on \c height levels, the lowest bit of a link marks the
+ * node as removed from that level. The links are stored behind the node, in
+ * the memory of its size class.
+ *
+ * \tparam Key Key type
+ * \tparam Value Value type
+ */
+template< typename Key, typename Value >
+class LockFreeSkipListMapNode {
+ public:
+  /**
+   * The links to the successors, one per level
+   */
+  embb::base::Atomic< LockFreeSkipListMapNode< Key, Value >* >* next;
+
+  /**
+   * The key of the node
+   */
+  Key key;
+
+  /**
+   * The value stored for the key
+   */
+  Value value;
+
+  /**
+   * Number of levels the node is linked into
+   */
+  int height;
+
+  /**
+   * Size class the node was allocated from
+   */
+  int size_class;
+
+  /**
+   * Number of operations that have not yet released the node: the insertion
+   * until it has linked the node into the upper levels, and the erase once
+   * it has unlinked the node. The last one retires the node.
+   */
+  embb::base::Atomic< int > pending_releases;
+
+  /**
+   * Creates a node holding the given key and value
+   */
+  LockFreeSkipListMapNode(
+    embb::base::Atomic< LockFreeSkipListMapNode< Key, Value >* >* next,
+    /**< [IN] The links, \c height of them */
+    Key const & key,
+    /**< [IN] The key */
+    Value const & value,
+    /**< [IN] The value */
+    int height,
+    /**< [IN] The number of levels */
+    int size_class
+    /**< [IN] The size class */);
+};
+
+/**
+ * Pool of the nodes of a LockFreeSkipListMap
+ *
+ * Most nodes of a skip list are linked into one or two levels only, so
+ * reserving the links of the highest possible node for every node wastes
+ * most of the memory. Instead, the pool holds nodes with room for 1, 2, 4,
+ * ..., \c MAX_HEIGHT links in separate size classes, each of them a value
+ * pool of indices into an array of nodes. The classes are sized for the
+ * expected distribution of the heights. If the class of a node is exhausted,
+ * the node is lowered to fit into the next smaller class, which only makes
+ * the skip list a little less balanced. The class of nodes with one link can
+ * hold all nodes, so allocations only fail if the pool is full.
+ *
+ * \tparam Key Key type
+ * \tparam Value Value type
+ * \tparam ValuePool Type of the value pools holding the free indices of each
+ *         size class
+ */
+template< typename Key, typename Value, typename ValuePool >
+class LockFreeSkipListMapNodePool {
+ public:
+  typedef LockFreeSkipListMapNode< Key, Value > Node;
+
+  /**
+   * Number of size classes
+   */
+  static const int SIZE_CLASS_COUNT = 6;
+
+  /**
+   * Links of the nodes in the largest size class
+   */
+  static const int MAX_HEIGHT = 1 << (SIZE_CLASS_COUNT - 1);
+
+  /**
+   * Creates a pool for the given number of nodes
+   */
+  explicit LockFreeSkipListMapNodePool(
+    size_t capacity
+    /**< [IN] Number of nodes the pool can hold */);
+
+  /**
+   * Destroys the pool. Nodes still allocated are not destroyed.
+   */
+  ~LockFreeSkipListMapNodePool();
+
+  /**
+   * Allocates a node of the given height, or lower if the size class of the
+   * height is exhausted.
+   *
+   * \return The node, or \c NULL if the pool is full
+   */
+  Node* Allocate(
+    Key const & key,
+    /**< [IN] The key */
+    Value const & value,
+    /**< [IN] The value */
+    int height
+    /**< [IN] The desired number of levels, at most \c MAX_HEIGHT */);
+
+  /**
+   * Destroys a node and returns it to the pool
+   */
+  void Free(
+    Node* node
+    /**< [IN] Node allocated from this pool */);
+
+ private:
+  /**
+   * The value pools holding the free node indices of each size class
+   */
+  ValuePool* value_pools[SIZE_CLASS_COUNT];
+
+  /**
+   * Number of nodes of each size class
+   */
+  size_t node_counts[SIZE_CLASS_COUNT];
+
+  /**
+   * Bytes per node of each size class, including the links
+   */
+  size_t node_sizes[SIZE_CLASS_COUNT];
+
+  /**
+   * Offset of the links from the node
+   */
+  size_t links_offset;
+
+  /**
+   * The nodes of each size class
+   */
+  char* nodes[SIZE_CLASS_COUNT];
+
+  /**
+   * Disable copy construction and assignment.
+   */
+  LockFreeSkipListMapNodePool(const LockFreeSkipListMapNodePool&);
+  LockFreeSkipListMapNodePool& operator=(const LockFreeSkipListMapNodePool&);
+};
+} // namespace internal
+
+/**
+ * Lock-free ordered map based on a skip list
+ *
+ * Maps keys to values and keeps the keys in ascending order, so that ranges
+ * of keys can be read. The nodes form a sorted list on the lowest level,
+ * which is linearly searched, and a random subset of them forms sparser
+ * lists on the levels above, which are searched first. Inserting or erasing
+ * a key takes effect with a single compare-and-swap on the lowest level,
+ * the other levels are updated afterwards.
+ *
+ * Nodes are taken from a pool with size classes for the different node
+ * heights and reclaimed using epochs. Hazard pointers would have to guard
+ * every node on the way down, and could not cope with nodes that are still
+ * being linked into upper levels when they are erased.
+ *
+ * For a description of the algorithm, see Keir Fraser. "Practical
+ * lock-freedom." PhD thesis, University of Cambridge, 2004. (Section 4.3)
+ *
+ * \ingroup CPP_CONTAINERS_MAPS
+ *
+ * \see LockFreeHashMap
+ *
+ * \tparam Key Type of the keys. Must be copyable and ordered by
+ *         <tt>operator<</tt>.
+ * \tparam Value Type of the values. Must be copyable.
+ * \tparam ValuePool Type of the value pools holding the free nodes of each
+ *         size class
+ */
+template< typename Key, typename Value,
+  typename ValuePool = embb::containers::LockFreeTreeValuePool< bool, false > >
+class LockFreeSkipListMap {
+ private:
+  /**
+   * SkipListMapTest walks the levels of the map after concurrent inserts and
+   * erases, so declaring it as friend.
+   */
+  template<typename Map_t>
+  friend class embb::containers::test::SkipListMapTest;
+
+  /**
+   * SkipListMapMemoryTest makes insertions yield while linking, like
+   * SkipListMapTest, so declaring it as friend.
+   */
+  friend class embb::containers::test::SkipListMapMemoryTest;
+
+  /**
+   * The pool of the nodes
+   */
+  typedef internal::LockFreeSkipListMapNodePool< Key, Value, ValuePool >
+    NodePool;
+
+  /**
+   * Node type of the skip list
+   */
+  typedef typename NodePool::Node Node;
+
+  /**
+   * Maximum number of levels
+   */
+  static const int MAX_HEIGHT = NodePool::MAX_HEIGHT;
+
+  /**
+   * Distance of the random states of two threads, keeps them on separate
+   * cache lines
+   */
+  static const unsigned int RANDOM_STRIDE =
+    EMBB_PLATFORM_CACHE_LINE_SIZE / sizeof(unsigned int);
+
+  /**
+   * The capacity of the map. It is guaranteed that the map can hold at least
+   * as many elements, maybe more.
+   */
+  size_t capacity;
+
+  /**
+   * Number of levels in use, enough for the capacity
+   */
+  int height;
+
+  /**
+   * Links to the first node of each level
+   */
+  embb::base::Atomic< Node* > head[MAX_HEIGHT];
+
+  /**
+   * Number of threads with a random state
+   */
+  unsigned int random_count;
+
+  /**
+   * States of the random number generators choosing the heights of new
+   * nodes, one every \c RANDOM_STRIDE entries
+   */
+  unsigned int* random_states;
+
+  /**
+   * If set, insertions yield before linking their node into an upper level.
+   * Only set by tests, which could hardly make an erase overlap with the
+   * linking otherwise.
+   */
+  bool yield_while_linking;
+
+  /**
+   * Callback to the method that is called by the reclamation if a node is
+   * not accessed anymore, i.e., can safely be reused.
+   */
+  embb::base::Function< void, Node* > delete_pointer_callback;
+
+  /**
+   * The pool of the nodes.
+   *
+   * Has to be declared before the reclamation object, which might return
+   * nodes to the pool in its destructor.
+   */
+  NodePool node_pool;
+
+  /**
+   * The epoch reclamation object, used for memory management
+   */
+  internal::EpochReclamation< Node* > reclamation;
+
+  /**
+   * The callback function, used to cleanup nodes no longer accessed.
+   * \see delete_pointer_callback
+   */
+  void DeletePointerCallback(Node* to_delete);
+
+  /**
+   * Returns \c node with the removal mark set
+   */
+  static Node* Mark(Node* node);
+
+  /**
+   * Returns \c node with the removal mark cleared
+   */
+  static Node* Unmark(Node* node);
+
+  /**
+   * Returns whether the removal mark of \c node is set
+   */
+  static bool IsMarked(Node* node);
+
+  /**
+   * Returns the link to the successor of \c node on the given level, or the
+   * head of the level if \c node is \c NULL
+   */
+  embb::base::Atomic< Node* >& Link(
+    Node* node,
+    /**< [IN] The node, or \c NULL for the head */
+    int level
+    /**< [IN] The level */);
+
+  /**
+   * Draws the height of a new node, each level with half the probability of
+   * the one below
+   */
+  int RandomHeight();
+
+  /**
+   * Searches the position of a key on every level and unlinks removed nodes
+   * on the way. Has to be called inside a critical section.
+   *
+   * \return \c true if the successor on the lowest level holds \c key
+   */
+  bool Search(
+    Key const & key,
+    /**< [IN] Key to search for */
+    Node** predecessors,
+    /**< [OUT] Last node with a key less than \c key per level, \c NULL for
+               the head */
+    Node** successors
+    /**< [OUT] First node with a key not less than \c key per level, or
+               \c NULL */);
+
+  /**
+   * Releases \c node for the insertion or the erase. Has to be called inside
+   * a critical section. The node is retired by the second call, when it is
+   * neither linked anymore nor about to be linked again.
+   */
+  void Release(
+    Node* node
+    /**< [IN] The erased node, or the node inserted by the caller */);
+
+  /**
+   * Disable copy construction and assignment.
+   */
+  LockFreeSkipListMap(const LockFreeSkipListMap&);
+  LockFreeSkipListMap& operator=(const LockFreeSkipListMap&);
+
+ public:
+  /**
+   * Creates a skip list map with the specified capacity.
+   *
+   * \memory
+   * Let \c t be the maximum number of threads and <tt>n = capacity +
+   * 3*t*t + t</tt>. Allocates nodes holding a key, a value, and their links:
+   * \c n nodes with one link, \c n nodes with two, <tt>n/2</tt> nodes with
+   * four, <tt>n/8</tt> with eight, <tt>n/128</tt> with 16, and
+   * <tt>n/32768</tt> with 32 links. Additionally allocates one cache line per
+   * thread for drawing the heights, and the retired lists of the epoch
+   * reclamation.
+   *
+   * \notthreadsafe
+   */
+  explicit LockFreeSkipListMap(
+    size_t capacity
+    /**< [IN] Capacity of the map */);
+
+  /**
+   * Destroys the skip list map.
+   *
+   * \notthreadsafe
+   */
+  ~LockFreeSkipListMap();
+
+  /**
+   * Returns the capacity of the map.
+   *
+   * \return Number of elements the map can hold.
+   *
+   * \waitfree
+   */
+  size_t GetCapacity();
+
+  /**
+   * Tries to insert a key and its value into the map.
+   *
+   * \return \c true if the key was inserted, \c false if it is already
+   * contained in the map or the map is full.
+   *
+   * \lockfree
+   */
+  bool TryInsert(
+    Key const & key,
+    /**< [IN] Key to insert */
+    Value const & value
+    /**< [IN] Value to store for the key */);
+
+  /**
+   * Tries to get the value stored for a key.
+   *
+   * \return \c true if the key is contained in the map, \c false otherwise.
+   *
+   * \lockfree
+   */
+  bool TryGet(
+    Key const & key,
+    /**< [IN] Key to look up */
+    Value & value
+    /**< [IN,OUT] Reference to the value of the key. Unchanged, if the key is
+                  not contained. */);
+
+  /**
+   * Tries to erase a key and its value from the map.
+   *
+   * \return \c true if the key was erased, \c false if it is not contained.
+   *
+   * \lockfree
+   */
+  bool TryErase(
+    Key const & key
+    /**< [IN] Key to erase */);
+
+  /**
+   * Reads the keys in the range <tt>[lower, upper)</tt> and their values in
+   * ascending order.
+   *
+   * The range is read while other threads may modify it, so it is not a
+   * snapshot: Every key returned was contained in the map at some point
+   * during the call, and every key contained during the whole call is
+   * returned, unless \c max keys were returned before. Keys inserted or
+   * erased during the call may or may not be returned.
+   *
+   * \return Number of keys written to \c out, at most \c max
+   *
+   * \lockfree
+   *
+   * \tparam OutputIterator Output iterator accepting values of type
+   *         <tt>std::pair<Key, Value></tt>
+   */
+  template< typename OutputIterator >
+  size_t GetRange(
+    Key const & lower,
+    /**< [IN] Smallest key to read */
+    Key const & upper,
+    /**< [IN] Key beyond the range, not read */
+    OutputIterator out,
+    /**< [OUT] Iterator the keys and values are written to */
+    size_t max
+    /**< [IN] Maximum number of keys to read */);
+};
+} // namespace containers
+} // namespace embb
+
+#include <embb/containers/internal/lock_free_skip_list_map-inl.h>
+
+#endif  // EMBB_CONTAINERS_LOCK_FREE_SKIP_LIST_MAP_H_
@@ -31,6 +31,7 @@
 #include <embb/base/atomic.h>
 #include <embb/base/function.h>
 #include <embb/containers/internal/hazard_pointer.h>
+#include <embb/containers/internal/epoch_reclamation.h>
 #include <embb/containers/lock_free_tree_value_pool.h>
 
 /**
@@ -168,9 +169,14 @@ class LockFreeStackNode {
  * \tparam Type Type of the stack elements
  * \tparam ValuePool Type of the value pool used as basis for the ObjectPool
  *         which stores the elements.
+ * \tparam Reclamation Memory reclamation scheme for popped nodes, either
+ *         internal::HazardPointer (bounded memory, lock-free) or
+ *         internal::EpochReclamation (cheaper operations, but operations may
+ *         wait for threads stalled inside an operation).
  */
 template< typename Type,
-typename ValuePool = embb::containers::LockFreeTreeValuePool < bool, false > >
+typename ValuePool = embb::containers::LockFreeTreeValuePool < bool, false >,
+template< typename > class Reclamation = internal::HazardPointer >
 class LockFreeStack {
  private:
   /**
@@ -206,11 +212,12 @@ class LockFreeStack {
   /**
    * Definition of the used hazard pointer type
    */
-  typedef internal::HazardPointer < internal::LockFreeStackNode<Type>* >
+  typedef Reclamation < internal::LockFreeStackNode<Type>* >
     StackNodeHazardPointer_t;
 
   /**
-   * The hazard pointer object, used for memory management.
+   * The hazard pointer object, used for memory management. Depending on
+   * \c Reclamation, this is an epoch-based reclamation object instead.
    */
   StackNodeHazardPointer_t hazardPointer;
 
@@ -228,6 +235,8 @@ class LockFreeStack {
    * Then, <tt>x*(3*t+1)</tt> elements of size <tt>sizeof(void*)</tt>, \c x
    * elements of size <tt>sizeof(Type)</tt>, and \c capacity elements of size
    * <tt>sizeof(Type)</tt> are allocated.
+   * With internal::EpochReclamation, the retired nodes account for three times
+   * as much memory.
    *
    * \notthreadsafe
    *
@@ -287,6 +296,56 @@ class LockFreeStack {
     /**< [IN,OUT] Reference to the popped element. Unchanged, if the operation
                   was not successful. */
   );
+
+  /**
+   * Tries to push the elements in the range <tt>[first, last)</tt> onto the
+   * stack.
+   *
+   * Pushes as many elements from the beginning of the range as there are
+   * free nodes. The nodes are linked to a segment in advance, which is then
+   * put on top of the stack with a single compare-and-swap operation. The
+   * result is the same as pushing the elements one after another, i.e., the
+   * last pushed element is on top.
+   *
+   * \return Number of elements that were pushed. Less than the size of the
+   * range if the stack became full.
+   *
+   * \lockfree
+   *
+   * \see TryPush
+   *
+   * \tparam ForwardIterator Forward iterator with value type \c Type
+   */
+  template< typename ForwardIterator >
+  size_t TryPushBatch(
+    ForwardIterator first,
+    /**< [IN] Iterator pointing to the first element to push */
+    ForwardIterator last
+    /**< [IN] Iterator pointing beyond the last element to push */
+  );
+
+  /**
+   * Tries to pop up to \c max elements from the stack.
+   *
+   * The popped elements are written to \c out, starting with the top
+   * element. Elements are removed one at a time, so elements popped by other
+   * threads may be interleaved.
+   *
+   * \return Number of elements that were popped. Zero if the stack is empty.
+   *
+   * \lockfree
+   *
+   * \see TryPop
+   *
+   * \tparam OutputIterator Output iterator accepting values of type \c Type
+   */
+  template< typename OutputIterator >
+  size_t TryPopBatch(
+    OutputIterator out,
+    /**< [OUT] Iterator the popped elements are written to */
+    size_t max
+    /**< [IN] Maximum number of elements to pop */
+  );
 };
 
 } // namespace containers
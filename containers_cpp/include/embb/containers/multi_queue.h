@@ -0,0 +1,452 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EMBB_CONTAINERS_MULTI_QUEUE_H_
+#define EMBB_CONTAINERS_MULTI_QUEUE_H_
+
+#include <embb/base/c/internal/config.h>
+#include <embb/base/atomic.h>
+#include <embb/base/mutex.h>
+
+#include <functional>
+#include <stddef.h>
+
+namespace embb {
+namespace containers {
+namespace internal {
+/**
+ * Sub-queue of a MultiQueue
+ *
+ * Binary heap of bounded capacity, protected by a spinlock. The size and the
+ * priority of the top entry are published through atomics, so that other
+ * threads can compare sub-queues without locking them.
+ *
+ * \tparam Priority Priority type, has to be supported by embb::base::Atomic
+ * \tparam Type Element type
+ * \tparam Compare Ordering of the priorities, the smallest entry is on top
+ */
+template< typename Priority, typename Type, typename Compare >
+class MultiQueueSubQueue {
+ public:
+  /**
+   * Creates an empty sub-queue that can hold \c capacity entries
+   */
+  explicit MultiQueueSubQueue(
+    size_t capacity
+    /**< [IN] Maximum number of entries */
+  );
+
+  /**
+   * Destroys the sub-queue and its entries
+   */
+  ~MultiQueueSubQueue();
+
+  /**
+   * Inserts an entry. The lock has to be held.
+   *
+   * \return \c false if the sub-queue is full
+   */
+  bool Push(
+    Priority const& priority,
+    /**< [IN] Priority of the entry */
+    Type const& element
+    /**< [IN] Element of the entry */
+  );
+
+  /**
+   * Removes the top entry. The lock has to be held and the sub-queue must not
+   * be empty.
+   */
+  void Pop(
+    Priority & priority,
+    /**< [OUT] Priority of the removed entry */
+    Type & element
+    /**< [OUT] Element of the removed entry */
+  );
+
+  /**
+   * Protects the heap
+   */
+  embb::base::Spinlock lock;
+
+  /**
+   * Number of entries, written with the lock held
+   */
+  embb::base::Atomic<size_t> size;
+
+  /**
+   * Priority of the top entry, valid if \c size is not zero
+   */
+  embb::base::Atomic<Priority> top;
+
+ private:
+  /**
+   * Entry of the heap
+   */
+  struct Entry {
+    Priority priority;
+    Type element;
+  };
+
+  /**
+   * Moves the entry at \c index up until the heap property holds
+   */
+  void SiftUp(size_t index);
+
+  /**
+   * Moves the entry at \c index down until the heap property holds for the
+   * first \c count entries
+   */
+  void SiftDown(size_t index, size_t count);
+
+  /**
+   * Maximum number of entries
+   */
+  size_t capacity;
+
+  /**
+   * The heap, \c capacity entries
+   */
+  Entry* entries;
+
+  /**
+   * Ordering of the priorities
+   */
+  Compare compare;
+
+  /**
+   * Disable copy construction and assignment.
+   */
+  MultiQueueSubQueue(const MultiQueueSubQueue&);
+  MultiQueueSubQueue& operator=(const MultiQueueSubQueue&);
+};
+
+/**
+ * Implementation of MultiQueue and PriorityMultiQueue
+ *
+ * \tparam Priority Priority type, has to be supported by embb::base::Atomic
+ * \tparam Type Element type
+ * \tparam Compare Ordering of the priorities
+ */
+template< typename Priority, typename Type, typename Compare >
+class MultiQueueImpl {
+ public:
+  /**
+   * Creates the sub-queues, see MultiQueue::MultiQueue
+   */
+  MultiQueueImpl(
+    size_t capacity,
+    /**< [IN] Guaranteed capacity */
+    unsigned int queues_per_thread
+    /**< [IN] Number of sub-queues per thread */
+  );
+
+  /**
+   * Destroys the sub-queues
+   */
+  ~MultiQueueImpl();
+
+  /**
+   * Returns the guaranteed capacity
+   */
+  size_t GetCapacity();
+
+  /**
+   * Inserts an entry into a random sub-queue
+   *
+   * \return \c false if all sub-queues are full
+   */
+  bool TryEnqueue(
+    Priority const& priority,
+    /**< [IN] Priority of the entry */
+    Type const& element
+    /**< [IN] Element of the entry */
+  );
+
+  /**
+   * Removes the top entry of the better of two random sub-queues
+   *
+   * \return \c false if all sub-queues were empty when they were inspected
+   */
+  bool TryDequeue(
+    Priority & priority,
+    /**< [OUT] Priority of the removed entry */
+    Type & element
+    /**< [OUT] Element of the removed entry */
+  );
+
+ private:
+  typedef MultiQueueSubQueue< Priority, Type, Compare > SubQueue;
+
+  /**
+   * Distance of the random states of two threads, keeps them on separate
+   * cache lines
+   */
+  static const unsigned int RANDOM_STRIDE =
+    EMBB_PLATFORM_CACHE_LINE_SIZE / sizeof(unsigned int);
+
+  /**
+   * Returns the sub-queue with the given index
+   */
+  SubQueue& GetSubQueue(unsigned int index);
+
+  /**
+   * Returns the index of a random sub-queue
+   */
+  unsigned int ChooseSubQueue();
+
+  /**
+   * Guaranteed capacity
+   */
+  size_t capacity;
+
+  /**
+   * Number of sub-queues
+   */
+  unsigned int queue_count;
+
+  /**
+   * Size of a sub-queue, padded to whole cache lines
+   */
+  size_t queue_size;
+
+  /**
+   * The sub-queues
+   */
+  char* queues;
+
+  /**
+   * Number of threads with a random state
+   */
+  unsigned int random_count;
+
+  /**
+   * States of the random number generators choosing the sub-queues, one
+   * every \c RANDOM_STRIDE entries
+   */
+  unsigned int* random_states;
+
+  /**
+   * Ordering of the priorities
+   */
+  Compare compare;
+
+  /**
+   * Disable copy construction and assignment.
+   */
+  MultiQueueImpl(const MultiQueueImpl&);
+  MultiQueueImpl& operator=(const MultiQueueImpl&);
+};
+} // namespace internal
+
+/**
+ * Relaxed FIFO queue for many producers and consumers
+ *
+ * The MultiQueue of Rihani, Sanders, and Dementiev spreads its elements over
+ * <tt>c*p</tt> sub-queues, where \c p is the maximum number of threads and
+ * \c c the number of sub-queues per thread. An element is enqueued into a
+ * random sub-queue. A dequeue looks at the oldest elements of two random
+ * sub-queues and takes the older one. Threads rarely compete for the same
+ * sub-queue, so the queue scales with the number of threads, unlike queues
+ * with a single head and tail.
+ *
+ * In return, the queue does not preserve the order of the elements exactly:
+ * a dequeue may return an element that is not the oldest one, but the rank
+ * of the returned element among all elements in the queue is small on
+ * average. Use it to distribute work where the order does not matter much.
+ *
+ * The sub-queues are protected by spinlocks. Operations only wait for a lock
+ * if they did not find a free sub-queue in a number of random attempts.
+ * Elements are ordered by tickets from a shared counter, which takes one
+ * fetch-and-add per enqueue.
+ *
+ * \ingroup CPP_CONTAINERS_QUEUES
+ *
+ * \see PriorityMultiQueue, LockFreeMPMCQueue
+ *
+ * \tparam Type Type of the queue elements, has to be default constructible
+ *         and assignable
+ */
+template< typename Type >
+class MultiQueue {
+ public:
+  /**
+   * Creates a queue with at least the specified capacity.
+   *
+   * \memory Allocates <tt>c*p</tt> sub-queues, each padded to whole cache
+   * lines and holding <tt>capacity/(c*p)</tt> (rounded up) elements and
+   * tickets, where \c p is the maximum number of threads and \c c is
+   * \c queues_per_thread. Additionally, one cache line per thread is
+   * allocated for choosing sub-queues at random.
+   *
+   * \notthreadsafe
+   */
+  MultiQueue(
+    size_t capacity,
+    /**< [IN] Capacity of the queue */
+    unsigned int queues_per_thread = 2
+    /**< [IN] Number of sub-queues per thread. More sub-queues reduce
+              contention, but increase the rank of dequeued elements. */
+  );
+
+  /**
+   * Returns the capacity of the queue.
+   *
+   * \return Number of elements the queue can hold at least.
+   *
+   * \waitfree
+   */
+  size_t GetCapacity();
+
+  /**
+   * Tries to enqueue an element into the queue.
+   *
+   * \return \c true if the element could be enqueued, \c false if the queue
+   * is full.
+   *
+   * \threadsafe
+   */
+  bool TryEnqueue(
+    Type const& element
+    /**< [IN] Const reference to the element that shall be enqueued */
+  );
+
+  /**
+   * Tries to dequeue an element from the queue. The dequeued element is one
+   * of the oldest elements, but not necessarily the oldest one.
+   *
+   * \return \c true if an element could be dequeued, \c false if every
+   * sub-queue was empty when it was inspected.
+   *
+   * \threadsafe
+   */
+  bool TryDequeue(
+    Type & element
+    /**< [IN,OUT] Reference to the dequeued element. Unchanged, if the
+                  operation was not successful. */
+  );
+
+ private:
+  /**
+   * The sub-queues, ordered by ticket
+   */
+  internal::MultiQueueImpl< size_t, Type, std::less<size_t> > impl;
+
+  /**
+   * Source of the tickets
+   */
+  embb::base::Atomic<size_t> next_ticket;
+};
+
+/**
+ * Relaxed priority queue for many producers and consumers
+ *
+ * MultiQueue with a priority per element instead of a ticket. A dequeue
+ * returns one of the elements with the smallest priorities, but not
+ * necessarily the smallest one.
+ *
+ * \ingroup CPP_CONTAINERS_QUEUES
+ *
+ * \see MultiQueue
+ *
+ * \tparam Priority Type of the priorities, has to be supported by
+ *         embb::base::Atomic, e.g., an integer type
+ * \tparam Type Type of the queue elements, has to be default constructible
+ *         and assignable
+ * \tparam Compare Ordering of the priorities. Elements whose priorities come
+ *         first are dequeued first.
+ */
+template< typename Priority, typename Type,
+  typename Compare = std::less<Priority> >
+class PriorityMultiQueue {
+ public:
+  /**
+   * Creates a queue with at least the specified capacity.
+   *
+   * \memory See MultiQueue::MultiQueue, with priorities instead of tickets.
+   *
+   * \notthreadsafe
+   */
+  PriorityMultiQueue(
+    size_t capacity,
+    /**< [IN] Capacity of the queue */
+    unsigned int queues_per_thread = 2
+    /**< [IN] Number of sub-queues per thread */
+  );
+
+  /**
+   * Returns the capacity of the queue.
+   *
+   * \return Number of elements the queue can hold at least.
+   *
+   * \waitfree
+   */
+  size_t GetCapacity();
+
+  /**
+   * Tries to enqueue an element with the given priority.
+   *
+   * \return \c true if the element could be enqueued, \c false if the queue
+   * is full.
+   *
+   * \threadsafe
+   */
+  bool TryEnqueue(
+    Priority const& priority,
+    /**< [IN] Priority of the element */
+    Type const& element
+    /**< [IN] Const reference to the element that shall be enqueued */
+  );
+
+  /**
+   * Tries to dequeue one of the elements with the smallest priorities.
+   *
+   * \return \c true if an element could be dequeued, \c false if every
+   * sub-queue was empty when it was inspected.
+   *
+   * \threadsafe
+   */
+  bool TryDequeue(
+    Priority & priority,
+    /**< [IN,OUT] Priority of the dequeued element. Unchanged, if the
+                  operation was not successful. */
+    Type & element
+    /**< [IN,OUT] Reference to the dequeued element. Unchanged, if the
+                  operation was not successful. */
+  );
+
+ private:
+  /**
+   * The sub-queues
+   */
+  internal::MultiQueueImpl< Priority, Type, Compare > impl;
+};
+} // namespace containers
+} // namespace embb
+
+#include <embb/containers/internal/multi_queue-inl.h>
+
+#endif  // EMBB_CONTAINERS_MULTI_QUEUE_H_
@@ -49,7 +49,9 @@ namespace containers {
  *
  * \tparam Type Element type
  * \tparam ValuePool Type of the underlying value pool, determines whether
- *         the object pool is wait-free or lock-free
+ *         the object pool is wait-free or lock-free. With
+ *         ThreadCachingValuePool, each thread caches free objects, so that
+ *         freeing and allocating objects in turn does not touch shared state.
  * \tparam ObjectAllocator Type of allocator used to allocate objects
  */
 template<class Type,
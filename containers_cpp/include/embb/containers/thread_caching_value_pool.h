@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EMBB_CONTAINERS_THREAD_CACHING_VALUE_POOL_H_
+#define EMBB_CONTAINERS_THREAD_CACHING_VALUE_POOL_H_
+
+#include <embb/base/c/internal/config.h>
+#include <embb/containers/lock_free_tree_value_pool.h>
+
+#include <stddef.h>
+
+namespace embb {
+namespace containers {
+namespace internal {
+/**
+ * Per-thread cache of free elements of a ThreadCachingValuePool
+ *
+ * \tparam Type Element type
+ * \tparam Size Maximum number of cached elements
+ */
+template<typename Type, unsigned int Size>
+class ThreadCachingValuePoolMagazine {
+ public:
+  /**
+   * Number of cached elements
+   */
+  unsigned int count;
+
+  /**
+   * Indices of the cached elements
+   */
+  int indices[Size];
+
+  /**
+   * The cached elements
+   */
+  Type elements[Size];
+
+  /**
+   * Creates an empty magazine
+   */
+  ThreadCachingValuePoolMagazine();
+};
+} // namespace internal
+
+/**
+ * Value pool caching free elements per thread
+ *
+ * Puts a magazine layer in front of another value pool: every thread keeps
+ * up to <tt>2*MagazineSize</tt> free elements of its own. Allocations take
+ * from and deallocations return to the calling thread's magazine, so a thread
+ * that frees and allocates elements in turn does not touch the underlying
+ * pool at all. An empty magazine is refilled with \c MagazineSize elements
+ * from the underlying pool, a full one gives \c MagazineSize elements back.
+ *
+ * Can be used wherever a value pool is expected, for example as \c ValuePool
+ * of ObjectPool and of the containers built on it. The pool is wait-free or
+ * lock-free if the underlying pool is.
+ *
+ * \concept{CPP_CONCEPTS_VALUE_POOL}
+ *
+ * \ingroup CPP_CONTAINERS_POOLS
+ *
+ * \see LockFreeTreeValuePool, WaitFreeArrayValuePool
+ *
+ * \tparam Type Element type
+ * \tparam Undefined Bottom element (cannot be stored in the pool)
+ * \tparam ValuePool Underlying value pool holding the elements not cached
+ * \tparam MagazineSize Number of elements exchanged with the underlying pool
+ *         at once
+ */
+template<typename Type,
+  Type Undefined,
+  class ValuePool = embb::containers::LockFreeTreeValuePool< Type, Undefined >,
+  unsigned int MagazineSize = 16 >
+class ThreadCachingValuePool {
+ private:
+  /**
+   * Magazine type, holds up to two batches of elements
+   */
+  typedef internal::ThreadCachingValuePoolMagazine< Type, 2 * MagazineSize >
+    Magazine;
+
+  /**
+   * The pool holding all elements not cached by a thread
+   */
+  ValuePool value_pool_;
+
+  /**
+   * Number of magazines, the maximum number of threads
+   */
+  unsigned int magazine_count_;
+
+  /**
+   * Size of a magazine, padded to whole cache lines
+   */
+  size_t magazine_size_;
+
+  /**
+   * The magazines, one per thread
+   */
+  char* magazines_;
+
+  ThreadCachingValuePool();
+
+  // Prevent copy-construction
+  ThreadCachingValuePool(const ThreadCachingValuePool&);
+
+  // Prevent assignment
+  ThreadCachingValuePool& operator=(const ThreadCachingValuePool&);
+
+  /**
+   * Returns the magazine of the calling thread, or \c NULL if the thread has
+   * no index.
+   */
+  Magazine* GetMagazine();
+
+  /**
+   * Returns the magazine of the given thread
+   */
+  Magazine& GetMagazine(unsigned int thread_index);
+
+  /**
+   * Returns all cached elements to the underlying pool
+   */
+  void ReturnCachedElements();
+
+ public:
+  /**
+   * Forward iterator to iterate over the allocated elements of the pool.
+   * \note Iterators are invalidated by any change to the pool
+   *       (Allocate and Free calls).
+   */
+  typedef typename ValuePool::Iterator Iterator;
+
+  /**
+   * Gets a forward iterator to the first allocated element in the pool.
+   *
+   * Returns the elements cached by the threads to the underlying pool first,
+   * so that they are not iterated over.
+   *
+   * \returns a forward iterator pointing to the first allocated element.
+   * \notthreadsafe
+   */
+  Iterator Begin();
+
+  /**
+   * Gets a forward iterator pointing after the last allocated element in
+   * the pool.
+   *
+   * \returns a forward iterator pointing after the last allocated element.
+   * \waitfree
+   */
+  Iterator End();
+
+  /**
+   * Constructs a pool and fills it with the elements in the specified range.
+   *
+   * \memory Allocates the underlying pool and, per thread, a magazine of
+   *         <tt>2*MagazineSize</tt> elements and indices, padded to whole
+   *         cache lines.
+   *
+   * \notthreadsafe
+   *
+   * \see CPP_CONCEPTS_VALUE_POOL
+   */
+  template<typename ForwardIterator>
+  ThreadCachingValuePool(
+    ForwardIterator first,
+    /**< [IN] Iterator pointing to the first element of the range the pool is
+              filled with */
+    ForwardIterator last
+    /**< [IN] Iterator pointing to the last plus one element of the range the
+              pool is filled with */
+  );
+
+  /**
+   * Due to concurrency effects, a pool might provide less elements than managed
+   * by it. However, usually one wants to guarantee a minimal capacity. The
+   * count of elements that must be given to the pool when to guarantee \c
+   * capacity elements is computed using this function.
+   *
+   * As every thread may cache up to <tt>2*MagazineSize</tt> elements, this is
+   * the count of the underlying pool for <tt>capacity + 2*MagazineSize*t</tt>
+   * elements, where \c t is the maximum number of threads.
+   *
+   * \return count of indices the pool has to be initialized with
+   */
+  static size_t GetMinimumElementCountForGuaranteedCapacity(
+    size_t capacity
+    /**< [IN] count of indices that shall be guaranteed */);
+
+  /**
+   * Destructs the pool.
+   *
+   * \notthreadsafe
+   */
+  ~ThreadCachingValuePool();
+
+  /**
+   * Allocates an element from the pool.
+   *
+   * \return Index of the element if the pool is not empty, otherwise \c -1.
+   *
+   * \see CPP_CONCEPTS_VALUE_POOL
+   */
+  int Allocate(
+    Type & element
+    /**< [IN,OUT] Reference to the allocated element. Set to \c Type(), if
+                  the operation was not successful. */
+  );
+
+  /**
+   * Returns an element to the pool.
+   *
+   * \note The element must have been allocated with Allocate().
+   *
+   * \see CPP_CONCEPTS_VALUE_POOL
+   */
+  void Free(
+    Type element,
+    /**< [IN] Element to be returned to the pool */
+    int index
+    /**< [IN] Index of the element as obtained by Allocate() */
+  );
+};
+} // namespace containers
+} // namespace embb
+
+#include <embb/containers/internal/thread_caching_value_pool-inl.h>
+
+#endif  // EMBB_CONTAINERS_THREAD_CACHING_VALUE_POOL_H_
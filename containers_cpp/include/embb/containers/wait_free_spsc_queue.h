@@ -27,7 +27,9 @@
 #ifndef EMBB_CONTAINERS_WAIT_FREE_SPSC_QUEUE_H_
 #define EMBB_CONTAINERS_WAIT_FREE_SPSC_QUEUE_H_
 
+#include <embb/base/internal/config.h>
 #include <embb/base/atomic.h>
+#include <embb/base/memory_allocation.h>
 
 #include <iostream>
 #include <stdexcept>
@@ -126,25 +128,58 @@ class WaitFreeSPSCQueue {
   Allocator allocator;
 
   /**
-   * Capacity of the queue
+   * Capacity of the queue, a power of two
    */
   size_t capacity;
 
+  /**
+   * <tt>capacity - 1</tt>, maps indices to positions in \c queue_array
+   */
+  size_t mask;
+
   /**
    * Array holding the queue elements
    */
   Type* queue_array;
 
   /**
-   * Index of the head in the \c queue_array
+   * Keeps the tail index away from the fields above
    */
-  embb::base::Atomic<size_t> head_index;
+  char padding0[EMBB_PLATFORM_CACHE_LINE_SIZE];
 
   /**
-   * Index of the tail in the \c queue_array
+   * Index of the tail in the \c queue_array, written by the producer only
    */
   embb::base::Atomic<size_t> tail_index;
 
+  /**
+   * Copy of \c head_index last read by the producer. The head index is only
+   * read again when this copy makes the queue look full.
+   */
+  size_t cached_head_index;
+
+  /**
+   * Keeps the fields of the producer and the consumer on separate cache
+   * lines
+   */
+  char padding1[EMBB_PLATFORM_CACHE_LINE_SIZE];
+
+  /**
+   * Index of the head in the \c queue_array, written by the consumer only
+   */
+  embb::base::Atomic<size_t> head_index;
+
+  /**
+   * Copy of \c tail_index last read by the consumer. The tail index is only
+   * read again when this copy makes the queue look empty.
+   */
+  size_t cached_tail_index;
+
+  /**
+   * Keeps the fields of the consumer away from whatever follows the queue
+   */
+  char padding2[EMBB_PLATFORM_CACHE_LINE_SIZE];
+
   /**
    * Align capacity to the next smallest power of two
    */
@@ -200,6 +235,26 @@ class WaitFreeSPSCQueue {
     /**< [IN] Const reference to the element that shall be enqueued */
   );
 
+#ifdef EMBB_PLATFORM_HAS_RVALUE_REFERENCES
+  /**
+   * Tries to enqueue an element into the queue by moving it.
+   *
+   * \return \c true if the element could be enqueued, \c false if the queue is
+   * full. In the latter case, \c element is left unchanged.
+   *
+   * \waitfree
+   *
+   * \note Concurrently enqueueing elements by multiple producers leads to
+   * undefined behavior.
+   *
+   * \see CPP_CONCEPTS_QUEUE
+   */
+  bool TryEnqueue(
+    Type && element
+    /**< [IN] Rvalue reference to the element that shall be enqueued */
+  );
+#endif
+
   /**
    * Tries to dequeue an element from the queue.
    *
@@ -218,6 +273,59 @@ class WaitFreeSPSCQueue {
     /**< [IN,OUT] Reference to the dequeued element. Unchanged, if the
                   operation was not successful. */
   );
+
+  /**
+   * Tries to enqueue the elements in the range <tt>[first, last)</tt>.
+   *
+   * Enqueues as many elements from the beginning of the range as fit into
+   * the queue. The new tail is published once for the whole batch, so the
+   * consumer observes either none or all of the enqueued elements.
+   *
+   * \return Number of elements that were enqueued. Less than the size of the
+   * range if the queue became full.
+   *
+   * \waitfree
+   *
+   * \note Concurrently enqueueing elements by multiple producers leads to
+   * undefined behavior.
+   *
+   * \see TryEnqueue
+   *
+   * \tparam ForwardIterator Forward iterator with value type \c Type
+   */
+  template<typename ForwardIterator>
+  size_t TryEnqueueBatch(
+    ForwardIterator first,
+    /**< [IN] Iterator pointing to the first element to enqueue */
+    ForwardIterator last
+    /**< [IN] Iterator pointing beyond the last element to enqueue */
+  );
+
+  /**
+   * Tries to dequeue up to \c max elements from the queue.
+   *
+   * The dequeued elements are written to \c out in queue order. The new head
+   * is published once for the whole batch.
+   *
+   * \return Number of elements that were dequeued. Zero if the queue is
+   * empty.
+   *
+   * \waitfree
+   *
+   * \note Concurrently dequeueing elements by multiple consumers leads to
+   * undefined behavior.
+   *
+   * \see TryDequeue
+   *
+   * \tparam OutputIterator Output iterator accepting values of type \c Type
+   */
+  template<typename OutputIterator>
+  size_t TryDequeueBatch(
+    OutputIterator out,
+    /**< [OUT] Iterator the dequeued elements are written to */
+    size_t max
+    /**< [IN] Maximum number of elements to dequeue */
+  );
 };
 } // namespace containers
 } // namespace embb
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "./elimination_stack_test.h"
+
+#include <embb/base/c/internal/thread_index.h>
+#include <embb/base/thread.h>
+
+namespace embb {
+namespace containers {
+namespace test {
+EliminationStackTest::EliminationStackTest() :
+  // every meeting costs a time slice on a single core
+  n_iterations_(100),
+  stack_(NULL) {
+  // A pop waits in the slot, a push hands over its node. The pop owns the
+  // node afterwards and returns it to the pool.
+  CreateUnit("EliminationStackTestPushMeetsWaitingPop").
+    Pre(&EliminationStackTest::EliminationStackTestPre, this).
+    Add(&EliminationStackTest::EliminationStackTestPushMeetsWaitingPop,
+    this, 2).
+    Post(&EliminationStackTest::EliminationStackTestPost, this);
+  // A push waits in the slot, a pop takes its node.
+  CreateUnit("EliminationStackTestPopMeetsWaitingPush").
+    Pre(&EliminationStackTest::EliminationStackTestPre, this).
+    Add(&EliminationStackTest::EliminationStackTestPopMeetsWaitingPush,
+    this, 2).
+    Post(&EliminationStackTest::EliminationStackTestPost, this);
+  // Nobody comes along, both operations leave the slot empty again.
+  CreateUnit("EliminationStackTestWithdraw").
+    Pre(&EliminationStackTest::EliminationStackTestPre, this).
+    Add(&EliminationStackTest::EliminationStackTestWithdraw, this).
+    Post(&EliminationStackTest::EliminationStackTestPost, this);
+}
+
+unsigned int EliminationStackTest::GetRole() {
+  unsigned int thread_index = 0;
+  embb_internal_thread_index(&thread_index);
+  return thread_index % 2;
+}
+
+void EliminationStackTest::EliminationStackTestPre() {
+  embb_internal_thread_index_reset();
+  // room for the node that changes hands and the next one, which the push
+  // may allocate before the pop has freed the first, and a single slot, so
+  // that both threads meet there
+  stack_ = embb::base::Allocation::New<Stack>(2, 1u);
+}
+
+void EliminationStackTest::EliminationStackTestPost() {
+  // eliminated nodes never reach the stack, and all of them went back to the
+  // pool, so the stack is empty but can still hold an element. A failed pop
+  // resets the element, like the one of LockFreeStack.
+  int element = 1;
+  PT_ASSERT(stack_->slots[0].Load() == Stack::EmptySlot());
+  PT_ASSERT(!stack_->TryPop(element));
+  PT_ASSERT_EQ(element, 0);
+  PT_ASSERT(stack_->TryPush(42));
+  PT_ASSERT(stack_->TryPop(element));
+  PT_ASSERT_EQ(element, 42);
+
+  embb::base::Allocation::Delete(stack_);
+  stack_ = NULL;
+}
+
+void EliminationStackTest::EliminationStackTestPushMeetsWaitingPop() {
+  embb::base::Atomic<Node*>& slot = stack_->slots[0];
+  if (GetRole() == 0) {
+    for (int i = 0; i != n_iterations_; ++i) {
+      Node* node = stack_->TryEliminatePop(PATIENT_SPINS);
+      PT_ASSERT_MSG(node != NULL, "no push came along");
+      PT_ASSERT_EQ(node->GetElement(), i);
+      stack_->objectPool.Free(node);
+    }
+  } else {
+    for (int i = 0; i != n_iterations_; ++i) {
+      while (slot.Load() != Stack::WaitingPop()) {
+        embb::base::Thread::CurrentYield();
+      }
+      Node* node = stack_->objectPool.Allocate(i);
+      PT_ASSERT(node != NULL);
+      PT_ASSERT_MSG(stack_->TryEliminatePush(node, 0),
+        "waiting pop did not take the node");
+    }
+  }
+}
+
+void EliminationStackTest::EliminationStackTestPopMeetsWaitingPush() {
+  embb::base::Atomic<Node*>& slot = stack_->slots[0];
+  if (GetRole() == 0) {
+    for (int i = 0; i != n_iterations_; ++i) {
+      Node* node = stack_->objectPool.Allocate(i);
+      PT_ASSERT(node != NULL);
+      PT_ASSERT_MSG(stack_->TryEliminatePush(node, PATIENT_SPINS),
+        "no pop came along");
+    }
+  } else {
+    for (int i = 0; i != n_iterations_; ++i) {
+      // the slot stays taken until the push has noticed
+      Node* waiting = slot.Load();
+      while (waiting == Stack::EmptySlot() || waiting == Stack::TakenNode()) {
+        embb::base::Thread::CurrentYield();
+        waiting = slot.Load();
+      }
+      Node* node = stack_->TryEliminatePop(0);
+      PT_ASSERT(node == waiting);
+      PT_ASSERT_EQ(node->GetElement(), i);
+      stack_->objectPool.Free(node);
+    }
+  }
+}
+
+void EliminationStackTest::EliminationStackTestWithdraw() {
+  Node* node = stack_->objectPool.Allocate(1);
+  PT_ASSERT(node != NULL);
+  PT_ASSERT(!stack_->TryEliminatePush(node, Stack::MIN_SPINS));
+  PT_ASSERT(stack_->slots[0].Load() == Stack::EmptySlot());
+  stack_->objectPool.Free(node);
+
+  PT_ASSERT(stack_->TryEliminatePop(Stack::MIN_SPINS) == NULL);
+  PT_ASSERT(stack_->slots[0].Load() == Stack::EmptySlot());
+}
+} // namespace test
+} // namespace containers
+} // namespace embb
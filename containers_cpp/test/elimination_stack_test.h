@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CONTAINERS_CPP_TEST_ELIMINATION_STACK_TEST_H_
+#define CONTAINERS_CPP_TEST_ELIMINATION_STACK_TEST_H_
+
+#include <partest/partest.h>
+#include <embb/containers/lock_free_elimination_stack.h>
+
+namespace embb {
+namespace containers {
+namespace test {
+/**
+ * White-box test of the elimination array. Under contention, whether a push
+ * and a pop meet there is a matter of timing, so the stack tests hardly ever
+ * get there. Here, one thread waits in the slot and the other one only comes
+ * along once it sees the first one waiting.
+ */
+class EliminationStackTest : public partest::TestCase {
+ public:
+  /**
+   * Adds test methods.
+   */
+  EliminationStackTest();
+
+ private:
+  typedef embb::containers::LockFreeEliminationStack<int> Stack;
+  typedef Stack::Node Node;
+
+  // long enough for the partner to be scheduled, even on a single core
+  static const unsigned int PATIENT_SPINS = 0xffffffffu;
+
+  int n_iterations_;
+  Stack* stack_;
+
+  // returns the role of the calling thread, 0 waits in the slot
+  static unsigned int GetRole();
+
+  void EliminationStackTestPre();
+  void EliminationStackTestPost();
+  void EliminationStackTestPushMeetsWaitingPop();
+  void EliminationStackTestPopMeetsWaitingPush();
+  void EliminationStackTestWithdraw();
+};
+} // namespace test
+} // namespace containers
+} // namespace embb
+
+#endif  // CONTAINERS_CPP_TEST_ELIMINATION_STACK_TEST_H_
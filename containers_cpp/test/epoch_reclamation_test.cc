@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "./epoch_reclamation_test.h"
+
+#include <embb/base/internal/config.h>
+
+namespace embb {
+namespace containers {
+namespace test {
+EpochReclamationTest::EpochReclamationTest() :
+  n_threads_(static_cast<int>(partest::TestSuite::GetDefaultNumThreads())),
+  n_slots_(4),
+  n_iterations_(static_cast<int>(
+    partest::TestSuite::GetDefaultNumIterations() * 10000)),
+#ifdef EMBB_PLATFORM_COMPILER_MSVC
+#pragma warning(push)
+#pragma warning(disable:4355)
+#endif
+  delete_pointer_callback_(*this,
+    &EpochReclamationTest::DeletePointerCallback),
+#ifdef EMBB_PLATFORM_COMPILER_MSVC
+#pragma warning(pop)
+#endif
+  test_pool_(NULL),
+  slots_(NULL),
+  next_value_(0),
+  reclamation_(NULL) {
+  // every thread holds at most one object not published in a slot yet
+  pool_size_ = static_cast<unsigned int>(n_slots_ + n_threads_ +
+    embb::containers::internal::EpochReclamation<int*>::
+    ComputeMaximumRetiredObjectCount(1, n_threads_));
+
+  // Readers check that the objects they reach inside a critical section are
+  // not released, while writers replace and retire them concurrently. Also
+  // checks that the retired objects never exhaust the pool.
+  CreateUnit("EpochReclamationTestThatCriticalSectionsProtect").
+    Pre(&EpochReclamationTest::EpochReclamationTest1Pre, this).
+    Add(&EpochReclamationTest::EpochReclamationTest1ThreadMethod,
+    this, static_cast<size_t>(n_threads_)).
+    Post(&EpochReclamationTest::EpochReclamationTest1Post, this);
+}
+
+void EpochReclamationTest::DeletePointerCallback(int* to_delete) {
+  *to_delete = RELEASED_MARKER;
+  test_pool_->Release(to_delete);
+}
+
+void EpochReclamationTest::EpochReclamationTest1Pre() {
+  embb_internal_thread_index_reset();
+
+  test_pool_ = embb::base::Allocation::New<IntObjectTestPool>(pool_size_);
+
+  reclamation_ = embb::base::Allocation::New<
+    embb::containers::internal::EpochReclamation<int*> >(
+    delete_pointer_callback_, static_cast<int*>(NULL), 1, n_threads_);
+
+  slots_ = static_cast<embb::base::Atomic<int*>*>(
+    embb::base::Allocation::Allocate(sizeof(embb::base::Atomic<int*>) *
+    static_cast<size_t>(n_slots_)));
+  for (int i = 0; i != n_slots_; ++i) {
+    int* object = test_pool_->Allocate();
+    *object = next_value_++;
+    // in-place new for each array cell
+    new (&slots_[i]) embb::base::Atomic<int*>(object);
+  }
+}
+
+void EpochReclamationTest::EpochReclamationTest1Post() {
+  for (int i = 0; i != n_slots_; ++i) {
+    test_pool_->Release(slots_[i].Load());
+    slots_[i].~Atomic();
+  }
+  embb::base::Allocation::Free(slots_);
+
+  // all retired objects have to be returned to the pool now
+  embb::base::Allocation::Delete(reclamation_);
+
+  unsigned int allocated = 0;
+  while (test_pool_->Allocate() != NULL) {
+    allocated++;
+  }
+  PT_ASSERT_EQ(allocated, pool_size_);
+
+  embb::base::Allocation::Delete(test_pool_);
+}
+
+void EpochReclamationTest::EpochReclamationTest1ThreadMethod() {
+  unsigned int thread_index;
+  embb_internal_thread_index(&thread_index);
+
+  for (int i = 0; i != n_iterations_; ++i) {
+    reclamation_->EnterCriticalSection();
+
+    embb::base::Atomic<int*>& slot = slots_[(i + thread_index) % n_slots_];
+    int* object = slot.Load();
+    int value = *object;
+    PT_ASSERT_NE_MSG(value, RELEASED_MARKER, "object released too early");
+
+    // every other thread only reads
+    if (thread_index % 2 == 0) {
+      int* replacement = test_pool_->Allocate();
+      PT_ASSERT_MSG(replacement != NULL, "pool exhausted");
+      *replacement = next_value_++;
+      // the expected value is overwritten if the swap fails, but the object
+      // has to be checked again below
+      int* expected = object;
+      if (slot.CompareAndSwap(expected, replacement)) {
+        reclamation_->EnqueueForDeletion(object);
+      } else {
+        test_pool_->Release(replacement);
+      }
+    } else {
+      embb::base::Thread::CurrentYield();
+    }
+    PT_ASSERT_EQ_MSG(*object, value, "object released too early");
+
+    reclamation_->LeaveCriticalSection();
+  }
+}
+} // namespace test
+} // namespace containers
+} // namespace embb
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CONTAINERS_CPP_TEST_EPOCH_RECLAMATION_TEST_H_
+#define CONTAINERS_CPP_TEST_EPOCH_RECLAMATION_TEST_H_
+
+#include <partest/partest.h>
+#include <embb/containers/internal/epoch_reclamation.h>
+
+#include "./hazard_pointer_test.h"
+
+namespace embb {
+namespace containers {
+namespace test {
+class EpochReclamationTest : public partest::TestCase {
+ public:
+  /**
+   * Adds test methods.
+   */
+  EpochReclamationTest();
+
+ private:
+  static const int RELEASED_MARKER = -1;
+
+  int n_threads_;
+  int n_slots_;
+  int n_iterations_;
+  unsigned int pool_size_;
+
+  embb::base::Function<void, int*> delete_pointer_callback_;
+
+  // objects come from here, the pool size is the guaranteed count plus the
+  // maximum number of retired objects
+  IntObjectTestPool* test_pool_;
+
+  // the threads replace the objects in these slots and retire the old ones
+  embb::base::Atomic<int*>* slots_;
+
+  // every object published in a slot gets a new value, so a reader notices
+  // if its object is released and reused
+  embb::base::Atomic<int> next_value_;
+
+  embb::containers::internal::EpochReclamation<int*>* reclamation_;
+
+  void DeletePointerCallback(int* to_delete);
+
+  void EpochReclamationTest1Pre();
+  void EpochReclamationTest1Post();
+  void EpochReclamationTest1ThreadMethod();
+};
+} // namespace test
+} // namespace containers
+} // namespace embb
+
+#endif  // CONTAINERS_CPP_TEST_EPOCH_RECLAMATION_TEST_H_
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CONTAINERS_CPP_TEST_HASH_MAP_TEST_INL_H_
+#define CONTAINERS_CPP_TEST_HASH_MAP_TEST_INL_H_
+
+#include <embb/base/c/internal/thread_index.h>
+
+namespace embb {
+namespace containers {
+namespace test {
+template<typename Map_t>
+HashMapTest<Map_t>::HashMapTest() :
+  n_threads(static_cast<int>
+    (partest::TestSuite::GetDefaultNumThreads())),
+#ifdef EMBB_THREADING_ANALYSIS_MODE
+  n_iterations(10),
+#else
+  n_iterations(100),
+#endif
+  n_keys_per_thread(50),
+  map(static_cast<size_t>(n_keys_per_thread * n_threads + 2 * N_SHARED_KEYS),
+    N_BUCKETS),
+  shared_key_balance(NULL) {
+  CreateUnit("HashMapTestSequential").
+  Add(&HashMapTest::HashMapTestSequential, this);
+  CreateUnit("HashMapTestThreadsInsertUpdateEraseOwnKeys").
+  Pre(&HashMapTest::HashMapTestOwnKeys_Pre, this).
+  Add(&HashMapTest::HashMapTestOwnKeys_ThreadMethod, this,
+    static_cast<size_t>(n_threads),
+    static_cast<size_t>(n_iterations)).
+  Post(&HashMapTest::HashMapTestOwnKeys_Post, this);
+  CreateUnit("HashMapTestThreadsInsertUpdateEraseSharedKeys").
+  Pre(&HashMapTest::HashMapTestSharedKeys_Pre, this).
+  Add(&HashMapTest::HashMapTestSharedKeys_ThreadMethod, this,
+    static_cast<size_t>(n_threads),
+    static_cast<size_t>(n_iterations)).
+  Post(&HashMapTest::HashMapTestSharedKeys_Post, this);
+}
+
+template<typename Map_t>
+int HashMapTest<Map_t>::ValueOf(int key, int thread_index) {
+  // the key can be recovered from the value, so a value stored under the
+  // wrong key is detected
+  return key * 1000 + thread_index;
+}
+
+template<typename Map_t>
+void HashMapTest<Map_t>::HashMapTestSequential() {
+  embb_internal_thread_index_reset();
+  int capacity = static_cast<int>(map.GetCapacity());
+  int value = -1;
+
+  PT_EXPECT(!map.TryGet(0, value));
+  PT_EXPECT_EQ(value, -1);
+  PT_EXPECT(!map.TryErase(0));
+
+  // fill the map in an order that does not match the order in the lists
+  for (int key = capacity - 1; key >= 0; --key) {
+    PT_EXPECT(map.TryInsert(key, ValueOf(key, 0)));
+  }
+  for (int key = 0; key != capacity; ++key) {
+    PT_EXPECT(!map.TryInsert(key, ValueOf(key, 1)));
+    PT_EXPECT(map.TryGet(key, value));
+    PT_EXPECT_EQ(value, ValueOf(key, 0));
+  }
+
+  // updates replace the value, also when the map is full
+  for (int key = 0; key != capacity; key += 2) {
+    PT_EXPECT(map.InsertOrUpdate(key, ValueOf(key, 2)));
+  }
+  for (int key = 0; key != capacity; ++key) {
+    PT_EXPECT(map.TryGet(key, value));
+    PT_EXPECT_EQ(value, ValueOf(key, key % 2 == 0 ? 2 : 0));
+  }
+
+  for (int key = 1; key < capacity; key += 2) {
+    PT_EXPECT(map.TryErase(key));
+    PT_EXPECT(!map.TryErase(key));
+  }
+  for (int key = 0; key != capacity; ++key) {
+    value = -1;
+    PT_EXPECT_EQ(map.TryGet(key, value), key % 2 == 0);
+    PT_EXPECT_EQ(value, key % 2 == 0 ? ValueOf(key, 2) : -1);
+  }
+
+  // erased keys can be inserted again
+  for (int key = 1; key < capacity; key += 2) {
+    PT_EXPECT(map.InsertOrUpdate(key, ValueOf(key, 3)));
+  }
+  for (int key = 0; key != capacity; ++key) {
+    PT_EXPECT(map.TryGet(key, value));
+    PT_EXPECT_EQ(value, ValueOf(key, key % 2 == 0 ? 2 : 3));
+    PT_EXPECT(map.TryErase(key));
+  }
+  for (int key = 0; key != capacity; ++key) {
+    PT_EXPECT(!map.TryGet(key, value));
+  }
+}
+
+template<typename Map_t>
+void HashMapTest<Map_t>::HashMapTestOwnKeys_Pre() {
+  embb_internal_thread_index_reset();
+}
+
+template<typename Map_t>
+void HashMapTest<Map_t>::HashMapTestOwnKeys_ThreadMethod() {
+  unsigned int thread_index;
+  int return_val = embb_internal_thread_index(&thread_index);
+  PT_ASSERT(EMBB_SUCCESS == return_val);
+
+  // interleave the keys of all threads, so that they share the lists
+  int const first_key = static_cast<int>(thread_index);
+  int const key_stride = n_threads;
+  int const last_key = first_key + key_stride * n_keys_per_thread;
+  int value = -1;
+
+  for (int key = first_key; key != last_key; key += key_stride) {
+    PT_ASSERT(map.TryInsert(key, ValueOf(key, 0)));
+  }
+  for (int key = first_key; key != last_key; key += key_stride) {
+    PT_ASSERT(map.TryGet(key, value));
+    PT_ASSERT_EQ(value, ValueOf(key, 0));
+    PT_ASSERT(map.InsertOrUpdate(key, ValueOf(key, 1)));
+  }
+  for (int key = first_key; key != last_key; key += key_stride) {
+    PT_ASSERT(map.TryGet(key, value));
+    PT_ASSERT_EQ(value, ValueOf(key, 1));
+    PT_ASSERT(map.TryErase(key));
+  }
+  for (int key = first_key; key != last_key; key += key_stride) {
+    PT_ASSERT(!map.TryGet(key, value));
+  }
+}
+
+template<typename Map_t>
+void HashMapTest<Map_t>::HashMapTestOwnKeys_Post() {
+  int value = -1;
+  for (int key = 0; key != n_threads * n_keys_per_thread; ++key) {
+    PT_ASSERT(!map.TryGet(key, value));
+  }
+}
+
+template<typename Map_t>
+void HashMapTest<Map_t>::HashMapTestSharedKeys_Pre() {
+  embb_internal_thread_index_reset();
+  shared_key_balance = new embb::base::Atomic<int>[
+    static_cast<unsigned int>(n_threads)];
+  for (int i = 0; i != n_threads; ++i) {
+    shared_key_balance[i] = 0;
+  }
+}
+
+template<typename Map_t>
+void HashMapTest<Map_t>::HashMapTestSharedKeys_ThreadMethod() {
+  unsigned int thread_index;
+  int return_val = embb_internal_thread_index(&thread_index);
+  PT_ASSERT(EMBB_SUCCESS == return_val);
+
+  int const me = static_cast<int>(thread_index);
+  int balance = 0;
+  int value = -1;
+  for (int i = 0; i != N_SHARED_KEYS; ++i) {
+    // every thread walks the keys with its own offset and operation
+    int const key = (i + me) % N_SHARED_KEYS;
+    switch ((i + me) % 3) {
+    case 0:
+      if (map.TryInsert(key, ValueOf(key, me))) balance++;
+      break;
+    case 1:
+      if (map.TryErase(key)) balance--;
+      break;
+    default:
+      if (map.TryGet(key, value)) {
+        PT_ASSERT_EQ(value / 1000, key);
+      }
+      break;
+    }
+    // the second half of the keys is only updated, never erased
+    int const updated_key = key + N_SHARED_KEYS;
+    PT_ASSERT(map.InsertOrUpdate(updated_key, ValueOf(updated_key, me)));
+    PT_ASSERT(map.TryGet(updated_key, value));
+    PT_ASSERT_EQ(value / 1000, updated_key);
+  }
+  shared_key_balance[me] += balance;
+}
+
+template<typename Map_t>
+void HashMapTest<Map_t>::HashMapTestSharedKeys_Post() {
+  int expected = 0;
+  for (int i = 0; i != n_threads; ++i) {
+    expected += shared_key_balance[i];
+  }
+  delete[] shared_key_balance;
+
+  int contained = 0;
+  int value = -1;
+  for (int key = 0; key != N_SHARED_KEYS; ++key) {
+    if (map.TryGet(key, value)) {
+      PT_ASSERT_EQ(value / 1000, key);
+      PT_ASSERT(map.TryErase(key));
+      contained++;
+    }
+  }
+  PT_ASSERT_EQ(contained, expected);
+
+  for (int key = N_SHARED_KEYS; key != 2 * N_SHARED_KEYS; ++key) {
+    PT_ASSERT(map.TryGet(key, value));
+    PT_ASSERT_EQ(value / 1000, key);
+    PT_ASSERT_LT(value % 1000, n_threads);
+    PT_ASSERT(map.TryErase(key));
+  }
+}
+} // namespace test
+} // namespace containers
+} // namespace embb
+
+#endif  // CONTAINERS_CPP_TEST_HASH_MAP_TEST_INL_H_
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CONTAINERS_CPP_TEST_HASH_MAP_TEST_H_
+#define CONTAINERS_CPP_TEST_HASH_MAP_TEST_H_
+
+#include <partest/partest.h>
+#include <embb/base/atomic.h>
+
+namespace embb {
+namespace containers {
+namespace test {
+template<typename Map_t>
+class HashMapTest : public partest::TestCase {
+ private:
+  // few buckets, so that the threads work on the same lists
+  static const size_t N_BUCKETS = 16;
+  // keys used by all threads in the contended test, twice as many are used
+  static const int N_SHARED_KEYS = 32;
+
+  int n_threads;
+  int n_iterations;
+  int n_keys_per_thread;
+  Map_t map;
+  // per thread count of shared keys inserted minus shared keys erased
+  embb::base::Atomic<int>* shared_key_balance;
+
+  static int ValueOf(int key, int thread_index);
+
+ public:
+  HashMapTest();
+
+  void HashMapTestSequential();
+
+  void HashMapTestOwnKeys_Pre();
+  void HashMapTestOwnKeys_ThreadMethod();
+  void HashMapTestOwnKeys_Post();
+
+  void HashMapTestSharedKeys_Pre();
+  void HashMapTestSharedKeys_ThreadMethod();
+  void HashMapTestSharedKeys_Post();
+};
+} // namespace test
+} // namespace containers
+} // namespace embb
+
+#include "./hash_map_test-inl.h"
+
+#endif  // CONTAINERS_CPP_TEST_HASH_MAP_TEST_H_
@@ -35,10 +35,18 @@
 
 #include <embb/containers/lock_free_tree_value_pool.h>
 #include <embb/containers/wait_free_array_value_pool.h>
+#include <embb/containers/lock_free_bitmap_value_pool.h>
 #include <embb/containers/wait_free_spsc_queue.h>
 #include <embb/containers/object_pool.h>
+#include <embb/containers/thread_caching_value_pool.h>
 #include <embb/containers/lock_free_stack.h>
+#include <embb/containers/lock_free_elimination_stack.h>
 #include <embb/containers/lock_free_mpmc_queue.h>
+#include <embb/containers/bounded_mpmc_queue.h>
+#include <embb/containers/lock_free_hash_map.h>
+#include <embb/containers/lock_free_skip_list_map.h>
+#include <embb/containers/multi_queue.h>
+#include <embb/containers/concurrent_priority_queue.h>
 #include <embb/base/c/atomic.h>
 
 #ifdef EMBB_PLATFORM_COMPILER_MSVC
@@ -50,25 +58,50 @@
 
 #include "./pool_test.h"
 #include "./queue_test.h"
+#include "./queue_batch_test.h"
+#include "./spsc_queue_move_test.h"
+#include "./multi_queue_test.h"
+#include "./priority_queue_test.h"
 #include "./stack_test.h"
+#include "./elimination_stack_test.h"
+#include "./hash_map_test.h"
+#include "./skip_list_map_test.h"
+#include "./skip_list_map_memory_test.h"
 #include "./hazard_pointer_test.h"
+#include "./epoch_reclamation_test.h"
 #include "./object_pool_test.h"
 
 #define COMMA ,
 
 using embb::containers::WaitFreeArrayValuePool;
+using embb::containers::LockFreeBitmapValuePool;
+using embb::containers::ThreadCachingValuePool;
 using embb::containers::LockFreeTreeValuePool;
 using embb::containers::WaitFreeSPSCQueue;
 using embb::containers::LockFreeMPMCQueue;
+using embb::containers::BoundedMPMCQueue;
 using embb::containers::LockFreeStack;
+using embb::containers::LockFreeEliminationStack;
+using embb::containers::LockFreeHashMap;
+using embb::containers::LockFreeSkipListMap;
 using embb::containers::LockFreeTreeValuePool;
 using embb::containers::WaitFreeArrayValuePool;
 using embb::containers::test::PoolTest;
 using embb::containers::test::HazardPointerTest;
 using embb::containers::test::QueueTest;
+using embb::containers::test::QueueBatchTest;
+using embb::containers::test::SPSCQueueMoveTest;
+using embb::containers::test::MultiQueueTest;
+using embb::containers::test::PriorityQueueTest;
 using embb::containers::test::StackTest;
+using embb::containers::test::EliminationStackTest;
+using embb::containers::test::HashMapTest;
+using embb::containers::test::SkipListMapTest;
+using embb::containers::test::SkipListMapMemoryTest;
 using embb::containers::test::ObjectPoolTest;
 using embb::containers::test::HazardPointerTest2;
+using embb::containers::test::EpochReclamationTest;
+using embb::containers::internal::EpochReclamation;
 
 PT_MAIN("Data Structures C++") {
   unsigned int max_threads = static_cast<unsigned int>(
@@ -77,14 +110,52 @@ PT_MAIN("Data Structures C++") {
 
   PT_RUN(PoolTest< WaitFreeArrayValuePool<int COMMA -1> >);
   PT_RUN(PoolTest< LockFreeTreeValuePool<int COMMA -1> >);
+  PT_RUN(PoolTest< LockFreeBitmapValuePool<int COMMA -1> >);
   PT_RUN(HazardPointerTest);
   PT_RUN(HazardPointerTest2);
+  PT_RUN(EpochReclamationTest);
   PT_RUN(QueueTest< WaitFreeSPSCQueue< ::std::pair<size_t COMMA int> > >);
   PT_RUN(QueueTest< LockFreeMPMCQueue< ::std::pair<size_t COMMA int> >
     COMMA true COMMA true >);
+  PT_RUN(QueueTest< LockFreeMPMCQueue< ::std::pair<size_t COMMA int>
+    COMMA LockFreeTreeValuePool<bool COMMA false> COMMA EpochReclamation >
+    COMMA true COMMA true >);
+  PT_RUN(QueueTest< LockFreeMPMCQueue< ::std::pair<size_t COMMA int>
+    COMMA ThreadCachingValuePool<bool COMMA false> > COMMA true COMMA true >);
+  PT_RUN(QueueTest< BoundedMPMCQueue< ::std::pair<size_t COMMA int> >
+    COMMA true COMMA true >);
+  PT_RUN(QueueBatchTest< WaitFreeSPSCQueue< ::std::pair<size_t COMMA int> > >);
+  PT_RUN(QueueBatchTest< LockFreeMPMCQueue< ::std::pair<size_t COMMA int> >
+    COMMA true >);
+  PT_RUN(QueueBatchTest< LockFreeMPMCQueue< ::std::pair<size_t COMMA int>
+    COMMA LockFreeTreeValuePool<bool COMMA false> COMMA EpochReclamation >
+    COMMA true >);
+  PT_RUN(SPSCQueueMoveTest);
+  PT_RUN(MultiQueueTest);
+  PT_RUN(PriorityQueueTest);
   PT_RUN(StackTest< LockFreeStack<int> >);
+  PT_RUN(StackTest< LockFreeStack<int COMMA
+    LockFreeTreeValuePool<bool COMMA false> COMMA EpochReclamation> >);
+  PT_RUN(StackTest< LockFreeStack<int COMMA
+    LockFreeBitmapValuePool<bool COMMA false> > >);
+  PT_RUN(StackTest< LockFreeStack<int COMMA
+    ThreadCachingValuePool<bool COMMA false> > >);
+  PT_RUN(StackTest< LockFreeEliminationStack<int> >);
+  PT_RUN(StackTest< LockFreeEliminationStack<int COMMA
+    LockFreeTreeValuePool<bool COMMA false> COMMA EpochReclamation> >);
+  PT_RUN(EliminationStackTest);
+  PT_RUN(HashMapTest< LockFreeHashMap<int COMMA int> >);
+  PT_RUN(HashMapTest< LockFreeHashMap<int COMMA int COMMA
+    embb::containers::internal::LockFreeHashMapHash<int> COMMA
+    WaitFreeArrayValuePool<bool COMMA false> > >);
+  PT_RUN(SkipListMapTest< LockFreeSkipListMap<int COMMA int> >);
+  PT_RUN(SkipListMapTest< LockFreeSkipListMap<int COMMA int COMMA
+    LockFreeBitmapValuePool<bool COMMA false> > >);
+  PT_RUN(SkipListMapMemoryTest);
   PT_RUN(ObjectPoolTest< LockFreeTreeValuePool<bool COMMA false > >);
   PT_RUN(ObjectPoolTest< WaitFreeArrayValuePool<bool COMMA false> >);
+  PT_RUN(ObjectPoolTest< LockFreeBitmapValuePool<bool COMMA false> >);
+  PT_RUN(ObjectPoolTest< ThreadCachingValuePool<bool COMMA false> >);
 
   PT_EXPECT(embb_get_bytes_allocated() == 0);
 }
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CONTAINERS_CPP_TEST_MULTI_QUEUE_TEST_INL_H_
+#define CONTAINERS_CPP_TEST_MULTI_QUEUE_TEST_INL_H_
+
+#include <embb/base/thread.h>
+#include <vector>
+
+namespace embb {
+namespace containers {
+namespace test {
+inline MultiQueueTest::MultiQueueTest() :
+  n_threads(static_cast<int>(partest::TestSuite::GetDefaultNumThreads())),
+  n_queue_size(
+    static_cast<int>(partest::TestSuite::GetDefaultNumIterations()) *
+    MIN_QUEUE_SIZE),
+  n_thread_elements(
+    static_cast<int>(partest::TestSuite::GetDefaultNumIterations()) *
+    MIN_THREAD_ELEMENTS),
+  next_thread_id(0),
+  dequeue_counts(NULL),
+  queue(NULL) {
+  CreateUnit("MultiQueueTestSingleThread").
+  Add(&MultiQueueTest::MultiQueueTestSingleThread_ThreadMethod, this);
+  CreateUnit("PriorityMultiQueueTestSingleThread").
+  Add(&MultiQueueTest::PriorityMultiQueueTestSingleThread_ThreadMethod, this);
+  CreateUnit("PriorityMultiQueueTestSubQueueOrder").
+  Add(&MultiQueueTest::PriorityMultiQueueTestSubQueueOrder_ThreadMethod, this);
+  CreateUnit("MultiQueueTestMultipleThreads").
+  Pre(&MultiQueueTest::MultiQueueTestMultipleThreads_Pre, this).
+  Add(&MultiQueueTest::MultiQueueTestMultipleThreads_ThreadMethod, this,
+    static_cast<size_t>(n_threads), 1).
+  Post(&MultiQueueTest::MultiQueueTestMultipleThreads_Post, this);
+}
+
+inline void MultiQueueTest::MultiQueueTestSingleThread_ThreadMethod() {
+  MultiQueue<int> multi_queue(static_cast<size_t>(n_queue_size));
+  PT_ASSERT_EQ(multi_queue.GetCapacity(), static_cast<size_t>(n_queue_size));
+
+  // The queue holds at least its capacity
+  int enqueued = 0;
+  while (multi_queue.TryEnqueue(enqueued)) {
+    ++enqueued;
+  }
+  PT_ASSERT(enqueued >= n_queue_size);
+
+  ::std::vector<int> counts(static_cast<size_t>(enqueued), 0);
+  int element;
+  for (int i = 0; i != enqueued; ++i) {
+    PT_ASSERT(multi_queue.TryDequeue(element) == true);
+    PT_ASSERT(element >= 0 && element < enqueued);
+    ++counts[static_cast<size_t>(element)];
+  }
+  PT_ASSERT(multi_queue.TryDequeue(element) == false);
+  for (int i = 0; i != enqueued; ++i) {
+    PT_ASSERT_EQ_MSG(counts[static_cast<size_t>(i)], 1,
+      "element not dequeued exactly once");
+  }
+}
+
+inline void MultiQueueTest::PriorityMultiQueueTestSingleThread_ThreadMethod() {
+  PriorityMultiQueue<int, int> multi_queue(static_cast<size_t>(n_queue_size));
+
+  // Priorities in scrambled order, some of them repeated
+  ::std::vector<int> counts(static_cast<size_t>(n_queue_size), 0);
+  for (int i = 0; i != n_queue_size; ++i) {
+    int priority = static_cast<int>(
+      (static_cast<unsigned int>(i) * 7919u) %
+      static_cast<unsigned int>(n_queue_size / 2 + 1));
+    PT_ASSERT(multi_queue.TryEnqueue(priority, -priority) == true);
+    ++counts[static_cast<size_t>(priority)];
+  }
+
+  int priority;
+  int element;
+  for (int i = 0; i != n_queue_size; ++i) {
+    PT_ASSERT(multi_queue.TryDequeue(priority, element) == true);
+    PT_ASSERT(priority >= 0 && priority < n_queue_size);
+    PT_ASSERT_EQ_MSG(element, -priority, "element and priority mixed up");
+    --counts[static_cast<size_t>(priority)];
+  }
+  PT_ASSERT(multi_queue.TryDequeue(priority, element) == false);
+  for (int i = 0; i != n_queue_size; ++i) {
+    PT_ASSERT_EQ_MSG(counts[static_cast<size_t>(i)], 0,
+      "priority not dequeued as often as enqueued");
+  }
+}
+
+inline void MultiQueueTest::PriorityMultiQueueTestSubQueueOrder_ThreadMethod() {
+  // A queue with a single sub-queue is an exact priority queue, so this checks
+  // the order the tests of the whole queue cannot check. No other thread uses
+  // the sub-queue, so its lock is not taken.
+  internal::MultiQueueSubQueue<int, int, ::std::less<int> > sub_queue(
+    static_cast<size_t>(n_queue_size));
+
+  // Priorities in scrambled order, some of them repeated
+  for (int i = 0; i != n_queue_size; ++i) {
+    int priority = static_cast<int>(
+      (static_cast<unsigned int>(i) * 7919u) %
+      static_cast<unsigned int>(n_queue_size / 2 + 1));
+    PT_ASSERT(sub_queue.Push(priority, -priority) == true);
+  }
+  PT_ASSERT(sub_queue.Push(0, 0) == false);
+
+  int previous = 0;
+  int priority;
+  int element;
+  for (int i = 0; i != n_queue_size; ++i) {
+    PT_ASSERT(sub_queue.size.Load() != 0);
+    int top = sub_queue.top.Load();
+    sub_queue.Pop(priority, element);
+    PT_ASSERT_EQ_MSG(priority, top, "published top not dequeued");
+    PT_ASSERT_MSG(priority >= previous, "priorities dequeued out of order");
+    PT_ASSERT_EQ_MSG(element, -priority, "element and priority mixed up");
+    previous = priority;
+  }
+  PT_ASSERT_EQ(sub_queue.size.Load(), static_cast<size_t>(0));
+}
+
+inline void MultiQueueTest::MultiQueueTestMultipleThreads_Pre() {
+  embb_internal_thread_index_reset();
+  next_thread_id = 0;
+  int element_count = n_threads * n_thread_elements;
+  queue = new MultiQueue<int>(static_cast<size_t>(element_count));
+  dequeue_counts = new embb::base::Atomic<int>[element_count];
+  for (int i = 0; i != element_count; ++i) {
+    dequeue_counts[i] = 0;
+  }
+}
+
+inline void MultiQueueTest::MultiQueueTestMultipleThreads_Post() {
+  // Dequeue what the threads left over
+  int element;
+  while (queue->TryDequeue(element)) {
+    dequeue_counts[element].FetchAndAdd(1);
+  }
+  delete queue;
+  for (int i = 0; i != n_threads * n_thread_elements; ++i) {
+    PT_ASSERT_EQ_MSG(dequeue_counts[i].Load(), 1,
+      "element not dequeued exactly once");
+  }
+  delete[] dequeue_counts;
+}
+
+inline void MultiQueueTest::MultiQueueTestMultipleThreads_ThreadMethod() {
+  int thread_id = next_thread_id.FetchAndAdd(1);
+  int element;
+  // Every thread enqueues its own elements and dequeues whatever it finds
+  for (int i = 0; i != n_thread_elements; ++i) {
+    PT_ASSERT(queue->TryEnqueue(thread_id * n_thread_elements + i) == true);
+    if (i % 3 != 0 && queue->TryDequeue(element)) {
+      PT_ASSERT(element >= 0 && element < n_threads * n_thread_elements);
+      dequeue_counts[element].FetchAndAdd(1);
+    }
+  }
+}
+}  // namespace test
+}  // namespace containers
+}  // namespace embb
+
+#endif  // CONTAINERS_CPP_TEST_MULTI_QUEUE_TEST_INL_H_
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CONTAINERS_CPP_TEST_MULTI_QUEUE_TEST_H_
+#define CONTAINERS_CPP_TEST_MULTI_QUEUE_TEST_H_
+
+#include <partest/partest.h>
+#include <embb/base/atomic.h>
+#include <embb/containers/multi_queue.h>
+#include <vector>
+
+namespace embb {
+namespace containers {
+namespace test {
+/**
+ * Tests MultiQueue and PriorityMultiQueue. As these queues only approximate
+ * the order of the elements, the tests check that every element is dequeued
+ * exactly once, together with its priority, instead of checking the order.
+ * Only a single sub-queue is checked for order.
+ */
+class MultiQueueTest : public partest::TestCase {
+ private:
+#ifdef EMBB_THREADING_ANALYSIS_MODE
+  static const int MIN_QUEUE_SIZE = 100;
+  static const int MIN_THREAD_ELEMENTS = 24;
+#else
+  static const int MIN_QUEUE_SIZE = 1000;
+  static const int MIN_THREAD_ELEMENTS = 500;
+#endif
+
+  int n_threads;
+  int n_queue_size;
+  int n_thread_elements;
+  embb::base::Atomic<int> next_thread_id;
+  embb::base::Atomic<int>* dequeue_counts;
+  MultiQueue<int>* queue;
+
+  void MultiQueueTestSingleThread_ThreadMethod();
+  void PriorityMultiQueueTestSingleThread_ThreadMethod();
+  void PriorityMultiQueueTestSubQueueOrder_ThreadMethod();
+  void MultiQueueTestMultipleThreads_Pre();
+  void MultiQueueTestMultipleThreads_Post();
+  void MultiQueueTestMultipleThreads_ThreadMethod();
+
+ public:
+  MultiQueueTest();
+};
+}  // namespace test
+}  // namespace containers
+}  // namespace embb
+
+#include "./multi_queue_test-inl.h"
+
+#endif  // CONTAINERS_CPP_TEST_MULTI_QUEUE_TEST_H_
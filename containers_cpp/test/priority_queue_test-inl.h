@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CONTAINERS_CPP_TEST_PRIORITY_QUEUE_TEST_INL_H_
+#define CONTAINERS_CPP_TEST_PRIORITY_QUEUE_TEST_INL_H_
+
+#include <embb/base/thread.h>
+#include <functional>
+#include <set>
+#include <vector>
+
+namespace embb {
+namespace containers {
+namespace test {
+inline PriorityQueueTest::PriorityQueueTest() :
+  n_threads(static_cast<int>(partest::TestSuite::GetDefaultNumThreads())),
+  n_queue_size(
+    static_cast<int>(partest::TestSuite::GetDefaultNumIterations()) *
+    MIN_QUEUE_SIZE),
+  n_thread_elements(
+    static_cast<int>(partest::TestSuite::GetDefaultNumIterations()) *
+    MIN_THREAD_ELEMENTS),
+  next_thread_id(0),
+  delete_counts(NULL),
+  phase_arrivals(0),
+  phase(0),
+  queue(NULL) {
+  CreateUnit("PriorityQueueTestSingleThread").
+  Add(&PriorityQueueTest::PriorityQueueTestSingleThread_ThreadMethod, this);
+  CreateUnit("PriorityQueueTestMixed").
+  Add(&PriorityQueueTest::PriorityQueueTestMixed_ThreadMethod, this);
+  CreateUnit("PriorityQueueTestMultipleThreads").
+  Pre(&PriorityQueueTest::PriorityQueueTestMultipleThreads_Pre, this).
+  Add(&PriorityQueueTest::PriorityQueueTestMultipleThreads_ThreadMethod, this,
+    static_cast<size_t>(n_threads), 1).
+  Post(&PriorityQueueTest::PriorityQueueTestMultipleThreads_Post, this);
+  // Two threads insert ascending keys, so that their nodes end up right
+  // behind the deleted prefix and behind each other, a third one deletes
+  // them
+  CreateUnit("PriorityQueueTestDeleteBehindInsert").
+  Pre(&PriorityQueueTest::PriorityQueueTestDeleteBehindInsert_Pre, this).
+  Add(&PriorityQueueTest::PriorityQueueTestDeleteBehindInsert_ThreadMethod,
+    this, 3, 1).
+  Post(&PriorityQueueTest::PriorityQueueTestDeleteBehindInsert_Post, this);
+}
+
+inline int PriorityQueueTest::KeyOf(int element, int key_count) {
+  return static_cast<int>((static_cast<unsigned int>(element) * 7919u) %
+    static_cast<unsigned int>(key_count));
+}
+
+inline void PriorityQueueTest::PriorityQueueTestSingleThread_ThreadMethod() {
+  embb_internal_thread_index_reset();
+  ConcurrentPriorityQueue<int, int> priority_queue(
+    static_cast<size_t>(n_queue_size));
+  PT_ASSERT_EQ(priority_queue.GetCapacity(),
+    static_cast<size_t>(n_queue_size));
+
+  // The queue holds at least its capacity
+  int key_count = n_queue_size / 2 + 1;
+  int inserted = n_queue_size;
+  for (int i = 0; i != inserted; ++i) {
+    PT_ASSERT(priority_queue.TryInsert(KeyOf(i, key_count), i) == true);
+  }
+
+  ::std::vector<int> counts(static_cast<size_t>(inserted), 0);
+  int key;
+  int element;
+  int previous_key = -1;
+  for (int i = 0; i != inserted; ++i) {
+    PT_ASSERT(priority_queue.TryDeleteMin(key, element) == true);
+    PT_ASSERT(element >= 0 && element < inserted);
+    PT_ASSERT_EQ_MSG(key, KeyOf(element, key_count),
+      "element and key mixed up");
+    PT_ASSERT_MSG(key >= previous_key, "keys not deleted in order");
+    previous_key = key;
+    ++counts[static_cast<size_t>(element)];
+  }
+  PT_ASSERT(priority_queue.TryDeleteMin(key, element) == false);
+  for (int i = 0; i != inserted; ++i) {
+    PT_ASSERT_EQ_MSG(counts[static_cast<size_t>(i)], 1,
+      "element not deleted exactly once");
+  }
+
+  // Reusable after being drained
+  PT_ASSERT(priority_queue.TryInsert(1, 1) == true);
+  PT_ASSERT(priority_queue.TryInsert(0, 0) == true);
+  PT_ASSERT(priority_queue.TryDeleteMin(key, element) == true);
+  PT_ASSERT_EQ(key, 0);
+  PT_ASSERT(priority_queue.TryDeleteMin(key, element) == true);
+  PT_ASSERT_EQ(key, 1);
+  PT_ASSERT(priority_queue.TryDeleteMin(key, element) == false);
+}
+
+inline void PriorityQueueTest::PriorityQueueTestMixed_ThreadMethod() {
+  embb_internal_thread_index_reset();
+  // Largest keys first, compared to a sorted reference
+  ConcurrentPriorityQueue<int, int, ::std::greater<int> > priority_queue(
+    static_cast<size_t>(n_queue_size));
+  ::std::multiset<int, ::std::greater<int> > reference;
+
+  int key_count = n_queue_size / 4 + 1;
+  int key;
+  int element;
+  for (int i = 0; i != 4 * n_queue_size; ++i) {
+    // Grow the queue in the first half, shrink it in the second
+    bool insert = (i < 2 * n_queue_size) ? (i % 3 != 0) : (i % 3 == 0);
+    if (insert && reference.size() < static_cast<size_t>(n_queue_size)) {
+      PT_ASSERT(priority_queue.TryInsert(KeyOf(i, key_count), i) == true);
+      reference.insert(KeyOf(i, key_count));
+    } else if (reference.empty()) {
+      PT_ASSERT(priority_queue.TryDeleteMin(key, element) == false);
+    } else {
+      PT_ASSERT(priority_queue.TryDeleteMin(key, element) == true);
+      PT_ASSERT_EQ_MSG(key, *reference.begin(), "key not the largest");
+      PT_ASSERT_EQ_MSG(key, KeyOf(element, key_count),
+        "element and key mixed up");
+      reference.erase(reference.begin());
+    }
+  }
+}
+
+inline void PriorityQueueTest::PriorityQueueTestMultipleThreads_Pre() {
+  embb_internal_thread_index_reset();
+  next_thread_id = 0;
+  int element_count = n_threads * n_thread_elements;
+  queue = new ConcurrentPriorityQueue<int, int>(
+    static_cast<size_t>(element_count));
+  delete_counts = new embb::base::Atomic<int>[element_count];
+  for (int i = 0; i != element_count; ++i) {
+    delete_counts[i] = 0;
+  }
+}
+
+inline void PriorityQueueTest::PriorityQueueTestMultipleThreads_Post() {
+  int element_count = n_threads * n_thread_elements;
+  // Delete what the threads left over, now in order
+  int key;
+  int element;
+  int previous_key = -1;
+  while (queue->TryDeleteMin(key, element)) {
+    PT_ASSERT(element >= 0 && element < element_count);
+    PT_ASSERT_EQ_MSG(key, KeyOf(element, element_count),
+      "element and key mixed up");
+    PT_ASSERT_MSG(key >= previous_key, "keys not deleted in order");
+    previous_key = key;
+    delete_counts[element].FetchAndAdd(1);
+  }
+  delete queue;
+  for (int i = 0; i != element_count; ++i) {
+    PT_ASSERT_EQ_MSG(delete_counts[i].Load(), 1,
+      "element not deleted exactly once");
+  }
+  delete[] delete_counts;
+}
+
+inline void PriorityQueueTest::PriorityQueueTestMultipleThreads_ThreadMethod() {
+  int thread_id = next_thread_id.FetchAndAdd(1);
+  int element_count = n_threads * n_thread_elements;
+  int key;
+  int element;
+  // Every thread inserts its own elements and deletes whatever it finds
+  for (int i = 0; i != n_thread_elements; ++i) {
+    int inserted = thread_id * n_thread_elements + i;
+    PT_ASSERT(queue->TryInsert(KeyOf(inserted, element_count), inserted) ==
+      true);
+    if (i % 3 != 0 && queue->TryDeleteMin(key, element)) {
+      PT_ASSERT(element >= 0 && element < element_count);
+      PT_ASSERT_EQ_MSG(key, KeyOf(element, element_count),
+        "element and key mixed up");
+      delete_counts[element].FetchAndAdd(1);
+    }
+  }
+}
+
+inline void PriorityQueueTest::PriorityQueueTestDeleteBehindInsert_Pre() {
+  embb_internal_thread_index_reset();
+  next_thread_id = 0;
+  phase_arrivals = 0;
+  phase = 0;
+  queue = new ConcurrentPriorityQueue<int, int>(
+    static_cast<size_t>(SMALL_QUEUE_SIZE));
+  // let the deletions pass the insertions on a single core, too
+  queue->yield_while_linking = true;
+  int element_count = 2 * n_thread_elements;
+  delete_counts = new embb::base::Atomic<int>[element_count];
+  for (int i = 0; i != element_count; ++i) {
+    delete_counts[i] = 0;
+  }
+}
+
+inline void PriorityQueueTest::PriorityQueueTestDeleteBehindInsert_Post() {
+  int key;
+  int element;
+  queue->yield_while_linking = false;
+  PT_ASSERT(queue->TryDeleteMin(key, element) == false);
+  CheckLevels();
+  delete queue;
+  for (int i = 0; i != 2 * n_thread_elements; ++i) {
+    PT_ASSERT_EQ_MSG(delete_counts[i].Load(), 1,
+      "element not deleted exactly once");
+  }
+  delete[] delete_counts;
+}
+
+inline void
+PriorityQueueTest::PriorityQueueTestDeleteBehindInsert_ThreadMethod() {
+  int thread_id = next_thread_id.FetchAndAdd(1);
+  int element_count = 2 * n_thread_elements;
+  int current_phase = 0;
+  int key;
+  int element;
+  int deleted = 0;
+  for (int first = 0; first < element_count;
+    first += 2 * PHASE_ELEMENTS) {
+    int last = first + 2 * PHASE_ELEMENTS;
+    if (last > element_count) {
+      last = element_count;
+    }
+    if (thread_id != 0) {
+      // The elements of both inserting threads alternate
+      for (int i = first + thread_id - 1; i < last; i += 2) {
+        // Full until the deleted nodes are reused
+        while (!queue->TryInsert(i, i)) {
+          embb::base::Thread::CurrentYield();
+        }
+      }
+    } else {
+      while (deleted != last) {
+        if (queue->TryDeleteMin(key, element)) {
+          PT_ASSERT(element >= 0 && element < element_count);
+          PT_ASSERT_EQ_MSG(key, element, "element and key mixed up");
+          delete_counts[element].FetchAndAdd(1);
+          ++deleted;
+        } else {
+          embb::base::Thread::CurrentYield();
+        }
+      }
+    }
+    // A node linked into an upper level after its batch was retired stays
+    // there only until the next batch is unlinked, check the levels before
+    FinishPhase(3, current_phase);
+    if (thread_id == 0) {
+      CheckLevels();
+    }
+    FinishPhase(3, current_phase);
+  }
+}
+
+inline void PriorityQueueTest::FinishPhase(int thread_count,
+  int & current_phase) {
+  if (phase_arrivals.FetchAndAdd(1) == thread_count - 1) {
+    phase_arrivals = 0;
+    phase = current_phase + 1;
+  } else {
+    while (phase.Load() == current_phase) {
+      embb::base::Thread::CurrentYield();
+    }
+  }
+  ++current_phase;
+}
+
+inline void PriorityQueueTest::CheckLevels() {
+  typedef ConcurrentPriorityQueue<int, int> Queue;
+  typedef Queue::Node Node;
+  // The lowest level holds every node not retired yet, deleted or not, and
+  // the upper levels hold some of them in the same order. A node that an
+  // insertion linked into an upper level after the batch of the node was
+  // retired is missing on the lowest level, or reused elsewhere.
+  ::std::vector<Node*> lowest;
+  for (Node* node = Queue::Unmark(queue->head[0]); node != NULL;
+    node = Queue::Unmark(node->next)) {
+    PT_ASSERT_MSG(!node->inserting, "insertion not finished");
+    lowest.push_back(node);
+  }
+  for (int level = 1; level != queue->height; ++level) {
+    size_t position = 0;
+    for (Node* node = queue->head[level]; node != NULL;
+      node = queue->Link(node, level)) {
+      PT_ASSERT_MSG(level < node->height, "node linked above its height");
+      while (position != lowest.size() && lowest[position] != node) {
+        ++position;
+      }
+      PT_ASSERT_MSG(position != lowest.size(),
+        "node linked on an upper level but not on the lowest one");
+    }
+  }
+}
+}  // namespace test
+}  // namespace containers
+}  // namespace embb
+
+#endif  // CONTAINERS_CPP_TEST_PRIORITY_QUEUE_TEST_INL_H_
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CONTAINERS_CPP_TEST_PRIORITY_QUEUE_TEST_H_
+#define CONTAINERS_CPP_TEST_PRIORITY_QUEUE_TEST_H_
+
+#include <partest/partest.h>
+#include <embb/base/atomic.h>
+#include <embb/containers/concurrent_priority_queue.h>
+#include <vector>
+
+namespace embb {
+namespace containers {
+namespace test {
+/**
+ * Tests ConcurrentPriorityQueue. Single-threaded, the queue has to delete
+ * the elements in the order of their keys. With several threads, the tests
+ * check that every element is deleted exactly once, and that the elements
+ * left over are deleted in order. Deletions passing nodes that are still
+ * being inserted must not unlink the nodes behind them, which the levels of
+ * the queue show afterwards.
+ */
+class PriorityQueueTest : public partest::TestCase {
+ private:
+#ifdef EMBB_THREADING_ANALYSIS_MODE
+  static const int MIN_QUEUE_SIZE = 100;
+  static const int MIN_THREAD_ELEMENTS = 24;
+#else
+  static const int MIN_QUEUE_SIZE = 1000;
+  static const int MIN_THREAD_ELEMENTS = 500;
+#endif
+  // capacity of the queue deleting behind insertions, small so that the
+  // nodes are reused many times
+  static const int SMALL_QUEUE_SIZE = 64;
+  // elements inserted by each thread between two checks of the levels
+  static const int PHASE_ELEMENTS = 8;
+
+  int n_threads;
+  int n_queue_size;
+  int n_thread_elements;
+  embb::base::Atomic<int> next_thread_id;
+  embb::base::Atomic<int>* delete_counts;
+  // threads arrived at the end of the current phase, and the phase
+  embb::base::Atomic<int> phase_arrivals;
+  embb::base::Atomic<int> phase;
+  ConcurrentPriorityQueue<int, int>* queue;
+
+  // scrambled key of an element, some keys are repeated
+  static int KeyOf(int element, int key_count);
+
+  void PriorityQueueTestSingleThread_ThreadMethod();
+  void PriorityQueueTestMixed_ThreadMethod();
+  void PriorityQueueTestMultipleThreads_Pre();
+  void PriorityQueueTestMultipleThreads_Post();
+  void PriorityQueueTestMultipleThreads_ThreadMethod();
+  void PriorityQueueTestDeleteBehindInsert_Pre();
+  void PriorityQueueTestDeleteBehindInsert_Post();
+  void PriorityQueueTestDeleteBehindInsert_ThreadMethod();
+
+  // waits until all threads of the unit finished the given phase
+  void FinishPhase(int thread_count, int & current_phase);
+
+  // walks all levels of the queue, which must not be modified meanwhile
+  void CheckLevels();
+
+ public:
+  PriorityQueueTest();
+};
+}  // namespace test
+}  // namespace containers
+}  // namespace embb
+
+#include "./priority_queue_test-inl.h"
+
+#endif  // CONTAINERS_CPP_TEST_PRIORITY_QUEUE_TEST_H_
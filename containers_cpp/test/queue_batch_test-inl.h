@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CONTAINERS_CPP_TEST_QUEUE_BATCH_TEST_INL_H_
+#define CONTAINERS_CPP_TEST_QUEUE_BATCH_TEST_INL_H_
+
+#include <embb/base/thread.h>
+#include <iterator>
+#include <vector>
+
+namespace embb {
+namespace containers {
+namespace test {
+template<typename Queue_t, bool MultipleProducers>
+QueueBatchTest<Queue_t, MultipleProducers>::QueueBatchTest() :
+  n_threads(static_cast<int>(partest::TestSuite::GetDefaultNumThreads())),
+  n_queue_size(
+    static_cast<int>(partest::TestSuite::GetDefaultNumIterations()) *
+    MIN_QUEUE_SIZE),
+  n_producers(1),
+  n_producer_elements(
+    static_cast<int>(partest::TestSuite::GetDefaultNumIterations()) *
+    MIN_ENQ_ELEMENTS),
+  next_producer_id(0),
+  queue(NULL) {
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4127)
+#endif
+  if (MultipleProducers == true && n_threads > 2) {
+    n_producers = n_threads - 1;
+  }
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+  CreateUnit("QueueBatchTestSingleThread").
+  Pre(&QueueBatchTest::QueueBatchTestSingleThread_Pre, this).
+  Add(&QueueBatchTest::QueueBatchTestSingleThread_ThreadMethod, this).
+  Post(&QueueBatchTest::QueueBatchTestSingleThread_Post, this);
+  CreateUnit("QueueBatchTestProducerConsumer").
+  Pre(&QueueBatchTest::QueueBatchTestProducerConsumer_Pre, this).
+  Add(&QueueBatchTest::QueueBatchTestProducerConsumer_ConsumerThreadMethod,
+    this, 1, 1).
+  Add(&QueueBatchTest::QueueBatchTestProducerConsumer_ProducerThreadMethod,
+    this, static_cast<size_t>(n_producers), 1).
+  Post(&QueueBatchTest::QueueBatchTestProducerConsumer_Post, this);
+}
+
+template<typename Queue_t, bool MultipleProducers>
+void QueueBatchTest<Queue_t, MultipleProducers>::
+QueueBatchTestSingleThread_Pre() {
+  queue = new Queue_t(static_cast<size_t>(n_queue_size));
+}
+
+template<typename Queue_t, bool MultipleProducers>
+void QueueBatchTest<Queue_t, MultipleProducers>::
+QueueBatchTestSingleThread_Post() {
+  delete queue;
+}
+
+template<typename Queue_t, bool MultipleProducers>
+void QueueBatchTest<Queue_t, MultipleProducers>::
+QueueBatchTestSingleThread_ThreadMethod() {
+  ::std::vector<element_t> batch;
+  int enqueued = 0;
+  int batch_size = 1;
+  // Enqueue batches until the queue is full
+  for (;;) {
+    batch.clear();
+    for (int i = 0; i != batch_size; ++i) {
+      batch.push_back(element_t(0, enqueued + i));
+    }
+    size_t count = queue->TryEnqueueBatch(batch.begin(), batch.end());
+    PT_ASSERT(count <= batch.size());
+    enqueued += static_cast<int>(count);
+    if (count < batch.size()) {
+      break;
+    }
+    batch_size = batch_size % MAX_BATCH_SIZE + 1;
+  }
+  PT_ASSERT(enqueued >= n_queue_size);
+  PT_ASSERT(queue->TryEnqueue(element_t(0, enqueued)) == false);
+  PT_ASSERT_EQ(queue->TryEnqueueBatch(batch.begin(), batch.end()),
+    static_cast<size_t>(0));
+
+  // Dequeue batches until the queue is empty
+  ::std::vector<element_t> dequeued;
+  batch_size = 1;
+  for (;;) {
+    size_t count = queue->TryDequeueBatch(::std::back_inserter(dequeued),
+      static_cast<size_t>(batch_size));
+    PT_ASSERT(count <= static_cast<size_t>(batch_size));
+    if (count == 0) {
+      break;
+    }
+    batch_size = batch_size % MAX_BATCH_SIZE + 1;
+  }
+  PT_ASSERT_EQ(dequeued.size(), static_cast<size_t>(enqueued));
+  for (int i = 0; i != enqueued; ++i) {
+    PT_ASSERT(dequeued[static_cast<size_t>(i)].second == i);
+  }
+
+  // Single elements and batches can be mixed
+  PT_ASSERT(queue->TryEnqueue(element_t(0, 0)) == true);
+  batch.clear();
+  batch.push_back(element_t(0, 1));
+  batch.push_back(element_t(0, 2));
+  PT_ASSERT_EQ(queue->TryEnqueueBatch(batch.begin(), batch.end()),
+    static_cast<size_t>(2));
+  element_t element;
+  PT_ASSERT(queue->TryDequeue(element) == true);
+  PT_ASSERT(element.second == 0);
+  PT_ASSERT_EQ(queue->TryDequeueBatch(batch.begin(), 5),
+    static_cast<size_t>(2));
+  PT_ASSERT(batch[0].second == 1);
+  PT_ASSERT(batch[1].second == 2);
+}
+
+template<typename Queue_t, bool MultipleProducers>
+void QueueBatchTest<Queue_t, MultipleProducers>::
+QueueBatchTestProducerConsumer_Pre() {
+  queue = new Queue_t(static_cast<size_t>(PRODUCER_CONSUMER_QUEUE_SIZE));
+  embb_internal_thread_index_reset();
+  next_producer_id = 0;
+  sequence_number.assign(static_cast<size_t>(n_producers), -1);
+}
+
+template<typename Queue_t, bool MultipleProducers>
+void QueueBatchTest<Queue_t, MultipleProducers>::
+QueueBatchTestProducerConsumer_Post() {
+  delete queue;
+  for (size_t p = 0; p != sequence_number.size(); ++p) {
+    PT_ASSERT_EQ_MSG(sequence_number[p], n_producer_elements - 1,
+      "missing dequeued elements");
+  }
+}
+
+template<typename Queue_t, bool MultipleProducers>
+void QueueBatchTest<Queue_t, MultipleProducers>::
+QueueBatchTestProducerConsumer_ProducerThreadMethod() {
+  size_t producer_id = next_producer_id.FetchAndAdd(1);
+  ::std::vector<element_t> batch;
+  int batch_size = static_cast<int>(producer_id) % MAX_BATCH_SIZE + 1;
+  int i = 0;
+  while (i < n_producer_elements) {
+    batch.clear();
+    for (; i < n_producer_elements &&
+      static_cast<int>(batch.size()) < batch_size; ++i) {
+      batch.push_back(element_t(producer_id, i));
+    }
+    // Enqueue the remainder of the batch until the queue took all of it
+    typename ::std::vector<element_t>::iterator first = batch.begin();
+    while (first != batch.end()) {
+      size_t count = queue->TryEnqueueBatch(first, batch.end());
+      if (count == 0) {
+        embb::base::Thread::CurrentYield();
+      }
+      first += static_cast<ptrdiff_t>(count);
+    }
+    batch_size = batch_size % MAX_BATCH_SIZE + 1;
+  }
+}
+
+template<typename Queue_t, bool MultipleProducers>
+void QueueBatchTest<Queue_t, MultipleProducers>::
+QueueBatchTestProducerConsumer_ConsumerThreadMethod() {
+  ::std::vector<element_t> batch(static_cast<size_t>(MAX_BATCH_SIZE));
+  int remaining = n_producers * n_producer_elements;
+  size_t batch_size = 1;
+  while (remaining > 0) {
+    size_t count = queue->TryDequeueBatch(batch.begin(), batch_size);
+    if (count == 0) {
+      embb::base::Thread::CurrentYield();
+    }
+    for (size_t i = 0; i != count; ++i) {
+      size_t producer_id = batch[i].first;
+      PT_ASSERT_LT_MSG(producer_id, static_cast<size_t>(n_producers),
+        "Invalid producer id in dequeue");
+      PT_ASSERT_EQ_MSG(sequence_number[producer_id] + 1, batch[i].second,
+        "Invalid element sequence");
+      sequence_number[producer_id] = batch[i].second;
+    }
+    remaining -= static_cast<int>(count);
+    batch_size = batch_size % static_cast<size_t>(MAX_BATCH_SIZE) + 1;
+  }
+}
+} // namespace test
+} // namespace containers
+} // namespace embb
+
+#endif  // CONTAINERS_CPP_TEST_QUEUE_BATCH_TEST_INL_H_
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CONTAINERS_CPP_TEST_QUEUE_BATCH_TEST_H_
+#define CONTAINERS_CPP_TEST_QUEUE_BATCH_TEST_H_
+
+#include <partest/partest.h>
+#include <embb/base/atomic.h>
+#include <vector>
+#include <utility>
+
+namespace embb {
+namespace containers {
+namespace test {
+/**
+ * Tests TryEnqueueBatch and TryDequeueBatch of a queue. With multiple
+ * producers, every producer enqueues its elements in batches of varying size
+ * while a single consumer checks that the elements of each producer arrive
+ * in order.
+ */
+template<typename Queue_t, bool MultipleProducers = false>
+class QueueBatchTest : public partest::TestCase {
+ public:
+  typedef ::std::pair<size_t, int> element_t;
+
+ private:
+  /// Batches cycle through the sizes 1 to MAX_BATCH_SIZE
+  static const int MAX_BATCH_SIZE = 17;
+  /// Capacity of the queue in the producer/consumer test, small enough
+  /// to make producers run into a full queue
+  static const int PRODUCER_CONSUMER_QUEUE_SIZE = 64;
+#ifdef EMBB_THREADING_ANALYSIS_MODE
+  static const int MIN_ENQ_ELEMENTS = 24;
+  static const int MIN_QUEUE_SIZE = 100;
+#else
+  static const int MIN_ENQ_ELEMENTS = 500;
+  static const int MIN_QUEUE_SIZE = 1000;
+#endif
+
+  int n_threads;
+  int n_queue_size;
+  int n_producers;
+  int n_producer_elements;
+  embb::base::Atomic<size_t> next_producer_id;
+  ::std::vector<int> sequence_number;
+  Queue_t* queue;
+
+  void QueueBatchTestSingleThread_Pre();
+  void QueueBatchTestSingleThread_Post();
+  void QueueBatchTestSingleThread_ThreadMethod();
+  void QueueBatchTestProducerConsumer_Pre();
+  void QueueBatchTestProducerConsumer_Post();
+  void QueueBatchTestProducerConsumer_ProducerThreadMethod();
+  void QueueBatchTestProducerConsumer_ConsumerThreadMethod();
+
+ public:
+  QueueBatchTest();
+};
+}  // namespace test
+}  // namespace containers
+}  // namespace embb
+
+#include "./queue_batch_test-inl.h"
+
+#endif  // CONTAINERS_CPP_TEST_QUEUE_BATCH_TEST_H_
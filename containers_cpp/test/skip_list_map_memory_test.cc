@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "./skip_list_map_memory_test.h"
+
+#include <embb/base/c/internal/thread_index.h>
+#include <embb/base/thread.h>
+
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace embb {
+namespace containers {
+namespace test {
+embb::base::Atomic<int> SkipListMapMemoryTest::CheckedValue::live(0);
+embb::base::Atomic<int> SkipListMapMemoryTest::CheckedValue::poisoned_reads(0);
+
+SkipListMapMemoryTest::CheckedValue::CheckedValue() :
+  value_(0), state_(ALIVE) {
+  live.FetchAndAdd(1);
+}
+
+SkipListMapMemoryTest::CheckedValue::CheckedValue(int value) :
+  value_(value), state_(ALIVE) {
+  live.FetchAndAdd(1);
+}
+
+SkipListMapMemoryTest::CheckedValue::CheckedValue(
+  CheckedValue const & other) :
+  value_(other.Get()), state_(ALIVE) {
+  live.FetchAndAdd(1);
+}
+
+SkipListMapMemoryTest::CheckedValue &
+SkipListMapMemoryTest::CheckedValue::operator=(CheckedValue const & other) {
+  value_ = other.Get();
+  return *this;
+}
+
+SkipListMapMemoryTest::CheckedValue::~CheckedValue() {
+  state_ = POISONED;
+  live.FetchAndSub(1);
+}
+
+int SkipListMapMemoryTest::CheckedValue::Get() const {
+  if (state_ != ALIVE) {
+    poisoned_reads.FetchAndAdd(1);
+  }
+  return value_;
+}
+
+SkipListMapMemoryTest::SkipListMapMemoryTest() :
+#ifdef EMBB_THREADING_ANALYSIS_MODE
+  n_iterations_(10),
+#else
+  n_iterations_(100),
+#endif
+  n_keys_(8),
+  map_(NULL),
+  erased_rounds_(0) {
+  // One thread inserts keys, the second one erases each of them while the
+  // insertion is still linking the node into the upper levels, and the
+  // third one reads all keys meanwhile.
+  CreateUnit("SkipListMapMemoryTestTowerRacesErase").
+    Pre(&SkipListMapMemoryTest::SkipListMapMemoryTestPre, this).
+    Add(&SkipListMapMemoryTest::SkipListMapMemoryTestTowerRacesErase,
+    this, 3).
+    Post(&SkipListMapMemoryTest::SkipListMapMemoryTestPost, this);
+}
+
+void SkipListMapMemoryTest::SkipListMapMemoryTestPre() {
+  embb_internal_thread_index_reset();
+  erased_rounds_ = 0;
+  CheckedValue::poisoned_reads = 0;
+  PT_ASSERT_EQ(CheckedValue::live.Load(), 0);
+  map_ = embb::base::Allocation::New<Map>(static_cast<size_t>(n_keys_));
+  // let the erase and the reads come in between on a single core, too
+  map_->yield_while_linking = true;
+}
+
+void SkipListMapMemoryTest::SkipListMapMemoryTestPost() {
+  map_->yield_while_linking = false;
+  PT_ASSERT_EQ(erased_rounds_.Load(), n_iterations_);
+  PT_ASSERT_EQ_MSG(CheckedValue::poisoned_reads.Load(), 0,
+    "node read after it went back to the pool");
+
+  // the map returns the nodes still in it and the retired ones to the pool,
+  // a node returned twice or never shows up in the count
+  embb::base::Allocation::Delete(map_);
+  map_ = NULL;
+  PT_ASSERT_EQ_MSG(CheckedValue::live.Load(), 0,
+    "node not returned to the pool exactly once");
+}
+
+void SkipListMapMemoryTest::SkipListMapMemoryTestTowerRacesErase() {
+  unsigned int thread_index;
+  int return_val = embb_internal_thread_index(&thread_index);
+  PT_ASSERT(EMBB_SUCCESS == return_val);
+
+  unsigned int const role = thread_index % 3;
+  CheckedValue value;
+  if (role == 0) {
+    for (int round = 0; round != n_iterations_; ++round) {
+      int const key = round % n_keys_;
+      PT_ASSERT(map_->TryInsert(key, CheckedValue(key)));
+      while (erased_rounds_.Load() == round) {
+        embb::base::Thread::CurrentYield();
+      }
+    }
+  } else if (role == 1) {
+    for (int round = 0; round != n_iterations_; ++round) {
+      int const key = round % n_keys_;
+      // the insertion yields after linking the lowest level
+      while (!map_->TryGet(key, value)) {
+        embb::base::Thread::CurrentYield();
+      }
+      PT_ASSERT_EQ(value.Get(), key);
+      PT_ASSERT(map_->TryErase(key));
+      erased_rounds_ = round + 1;
+    }
+  } else {
+    std::vector< std::pair<int, CheckedValue> > range;
+    while (erased_rounds_.Load() != n_iterations_) {
+      for (int key = 0; key != n_keys_; ++key) {
+        if (map_->TryGet(key, value)) {
+          PT_ASSERT_EQ(value.Get(), key);
+        }
+      }
+      range.clear();
+      map_->GetRange(0, n_keys_, std::back_inserter(range),
+        static_cast<size_t>(n_keys_));
+      embb::base::Thread::CurrentYield();
+    }
+  }
+}
+} // namespace test
+} // namespace containers
+} // namespace embb
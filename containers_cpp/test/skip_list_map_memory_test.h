@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CONTAINERS_CPP_TEST_SKIP_LIST_MAP_MEMORY_TEST_H_
+#define CONTAINERS_CPP_TEST_SKIP_LIST_MAP_MEMORY_TEST_H_
+
+#include <partest/partest.h>
+#include <embb/base/atomic.h>
+#include <embb/containers/lock_free_skip_list_map.h>
+
+namespace embb {
+namespace containers {
+namespace test {
+/**
+ * Checks that LockFreeSkipListMap returns every node to its pool exactly
+ * once. An insertion still linking its node into the upper levels races an
+ * erase of the key, while a third thread reads the map. Both the insertion
+ * and the erase are done with the node then, and only one of them may retire
+ * it. The values count their instances, so that a node returned twice or
+ * never shows up, and poison themselves when they are destroyed, so that
+ * reading a value after it went back to the pool shows up.
+ */
+class SkipListMapMemoryTest : public partest::TestCase {
+ public:
+  /**
+   * Adds test methods.
+   */
+  SkipListMapMemoryTest();
+
+ private:
+  class CheckedValue {
+   public:
+    CheckedValue();
+    explicit CheckedValue(int value);
+    CheckedValue(CheckedValue const & other);
+    CheckedValue & operator=(CheckedValue const & other);
+    ~CheckedValue();
+
+    // returns the value, counts the read if the value has been destroyed
+    int Get() const;
+
+    // number of values not yet destroyed
+    static embb::base::Atomic<int> live;
+    // number of reads of destroyed values
+    static embb::base::Atomic<int> poisoned_reads;
+
+   private:
+    static const unsigned int ALIVE = 0x600dcafeu;
+    static const unsigned int POISONED = 0xdeadbeefu;
+
+    int value_;
+    unsigned int state_;
+  };
+
+  typedef embb::containers::LockFreeSkipListMap<int, CheckedValue> Map;
+
+  int n_iterations_;
+  int n_keys_;
+  Map* map_;
+  // rounds in which the key has been erased
+  embb::base::Atomic<int> erased_rounds_;
+
+  void SkipListMapMemoryTestPre();
+  void SkipListMapMemoryTestPost();
+  void SkipListMapMemoryTestTowerRacesErase();
+};
+} // namespace test
+} // namespace containers
+} // namespace embb
+
+#endif  // CONTAINERS_CPP_TEST_SKIP_LIST_MAP_MEMORY_TEST_H_
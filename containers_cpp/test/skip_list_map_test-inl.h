@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CONTAINERS_CPP_TEST_SKIP_LIST_MAP_TEST_INL_H_
+#define CONTAINERS_CPP_TEST_SKIP_LIST_MAP_TEST_INL_H_
+
+#include <embb/base/c/internal/thread_index.h>
+
+#include <iterator>
+
+namespace embb {
+namespace containers {
+namespace test {
+template<typename Map_t>
+SkipListMapTest<Map_t>::SkipListMapTest() :
+  n_threads(static_cast<int>
+    (partest::TestSuite::GetDefaultNumThreads())),
+#ifdef EMBB_THREADING_ANALYSIS_MODE
+  n_iterations(10),
+#else
+  n_iterations(100),
+#endif
+  n_keys_per_thread(50),
+  map(static_cast<size_t>(n_keys_per_thread * n_threads)),
+  erased_rounds(0),
+  checked_rounds(0) {
+  CreateUnit("SkipListMapTestSequential").
+  Add(&SkipListMapTest::SkipListMapTestSequential, this);
+  // every thread inserts, reads, and erases its own keys, interleaved with
+  // the keys of the others
+  CreateUnit("SkipListMapTestOwnKeys").
+  Pre(&SkipListMapTest::SkipListMapTestOwnKeys_Pre, this).
+  Add(&SkipListMapTest::SkipListMapTestOwnKeys_ThreadMethod, this,
+    static_cast<size_t>(n_threads),
+    static_cast<size_t>(n_iterations)).
+  Post(&SkipListMapTest::SkipListMapTestOwnKeys_Post, this);
+  // one thread inserts keys, the other one erases each of them while the
+  // insertion is still linking the node into the upper levels
+  CreateUnit("SkipListMapTestTowerRacesErase").
+  Pre(&SkipListMapTest::SkipListMapTestTowerRacesErase_Pre, this).
+  Add(&SkipListMapTest::SkipListMapTestTowerRacesErase_ThreadMethod, this,
+    2).
+  Post(&SkipListMapTest::SkipListMapTestTowerRacesErase_Post, this);
+}
+
+template<typename Map_t>
+int SkipListMapTest<Map_t>::ValueOf(int key, int thread_index) {
+  return key * 1000 + thread_index;
+}
+
+template<typename Map_t>
+bool SkipListMapTest<Map_t>::IsSorted(range_t const & range) {
+  for (size_t i = 0; i != range.size(); ++i) {
+    if (range[i].second / 1000 != range[i].first) {
+      return false;
+    }
+    if (i > 0 && !(range[i - 1].first < range[i].first)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template<typename Map_t>
+int SkipListMapTest<Map_t>::CheckLevels() {
+  // Every level ascends and holds no removed node, and every node on a level
+  // is on the level below, too. A node left behind by an insertion that
+  // raced an erase shows up on an upper level only.
+  std::vector<Node*> below;
+  int key_count = 0;
+  for (int level = 0; level != map.height; ++level) {
+    std::vector<Node*> nodes;
+    size_t position = 0;
+    Node* node = map.head[level];
+    while (node != NULL) {
+      PT_ASSERT_MSG(!Map_t::IsMarked(node), "removed node still linked");
+      PT_ASSERT_MSG(level < node->height, "node linked above its height");
+      PT_ASSERT_MSG(nodes.empty() || nodes.back()->key < node->key,
+        "keys of a level not ascending");
+      if (level > 0) {
+        while (position != below.size() && below[position] != node) {
+          ++position;
+        }
+        PT_ASSERT_MSG(position != below.size(),
+          "node linked on a level but not on the level below");
+      }
+      nodes.push_back(node);
+      node = node->next[level];
+    }
+    if (level == 0) {
+      key_count = static_cast<int>(nodes.size());
+    }
+    below.swap(nodes);
+  }
+  return key_count;
+}
+
+template<typename Map_t>
+void SkipListMapTest<Map_t>::SkipListMapTestSequential() {
+  embb_internal_thread_index_reset();
+  int capacity = static_cast<int>(map.GetCapacity());
+  int value = -1;
+  range_t range;
+
+  PT_EXPECT(!map.TryGet(0, value));
+  PT_EXPECT_EQ(value, -1);
+  PT_EXPECT(!map.TryErase(0));
+  PT_EXPECT_EQ(map.GetRange(0, capacity, std::back_inserter(range),
+    static_cast<size_t>(capacity)), static_cast<size_t>(0));
+
+  // fill the map in descending order
+  for (int key = capacity - 1; key >= 0; --key) {
+    PT_EXPECT(map.TryInsert(key, ValueOf(key, 0)));
+  }
+  for (int key = 0; key != capacity; ++key) {
+    PT_EXPECT(!map.TryInsert(key, ValueOf(key, 1)));
+    PT_EXPECT(map.TryGet(key, value));
+    PT_EXPECT_EQ(value, ValueOf(key, 0));
+  }
+
+  // ranges are read in ascending order, up to the given number of keys
+  PT_EXPECT_EQ(map.GetRange(0, capacity, std::back_inserter(range),
+    static_cast<size_t>(capacity) + 1), static_cast<size_t>(capacity));
+  PT_EXPECT_EQ(range.size(), static_cast<size_t>(capacity));
+  for (int key = 0; key != capacity && key != static_cast<int>(range.size());
+    ++key) {
+    PT_EXPECT_EQ(range[static_cast<size_t>(key)].first, key);
+    PT_EXPECT_EQ(range[static_cast<size_t>(key)].second, ValueOf(key, 0));
+  }
+  range.clear();
+  PT_EXPECT_EQ(map.GetRange(10, 20, std::back_inserter(range), 5),
+    static_cast<size_t>(5));
+  PT_EXPECT_EQ(range.size(), static_cast<size_t>(5));
+  PT_EXPECT(range.size() == 0 || range.front().first == 10);
+  PT_EXPECT(range.size() == 0 || range.back().first == 14);
+  range.clear();
+  PT_EXPECT_EQ(map.GetRange(20, 10, std::back_inserter(range), 5),
+    static_cast<size_t>(0));
+
+  for (int key = 1; key < capacity; key += 2) {
+    PT_EXPECT(map.TryErase(key));
+    PT_EXPECT(!map.TryErase(key));
+  }
+  for (int key = 0; key != capacity; ++key) {
+    value = -1;
+    PT_EXPECT_EQ(map.TryGet(key, value), key % 2 == 0);
+    PT_EXPECT_EQ(value, key % 2 == 0 ? ValueOf(key, 0) : -1);
+  }
+  range.clear();
+  map.GetRange(0, capacity, std::back_inserter(range),
+    static_cast<size_t>(capacity));
+  PT_EXPECT_EQ(range.size(), static_cast<size_t>((capacity + 1) / 2));
+  PT_EXPECT(IsSorted(range));
+  PT_EXPECT_EQ(CheckLevels(), (capacity + 1) / 2);
+  for (size_t i = 0; i != range.size(); ++i) {
+    PT_EXPECT_EQ(range[i].first % 2, 0);
+  }
+
+  // erased keys can be inserted again
+  for (int key = 1; key < capacity; key += 2) {
+    PT_EXPECT(map.TryInsert(key, ValueOf(key, 3)));
+  }
+  for (int key = 0; key != capacity; ++key) {
+    PT_EXPECT(map.TryGet(key, value));
+    PT_EXPECT_EQ(value, ValueOf(key, key % 2 == 0 ? 0 : 3));
+    PT_EXPECT(map.TryErase(key));
+  }
+  for (int key = 0; key != capacity; ++key) {
+    PT_EXPECT(!map.TryGet(key, value));
+  }
+}
+
+template<typename Map_t>
+void SkipListMapTest<Map_t>::SkipListMapTestOwnKeys_Pre() {
+  embb_internal_thread_index_reset();
+}
+
+template<typename Map_t>
+void SkipListMapTest<Map_t>::SkipListMapTestOwnKeys_ThreadMethod() {
+  unsigned int thread_index;
+  int return_val = embb_internal_thread_index(&thread_index);
+  PT_ASSERT(EMBB_SUCCESS == return_val);
+
+  // interleave the keys of all threads, so that they share the levels
+  int const first_key = static_cast<int>(thread_index);
+  int const key_stride = n_threads;
+  int const last_key = first_key + key_stride * n_keys_per_thread;
+  int value = -1;
+  range_t range;
+
+  for (int key = first_key; key != last_key; key += key_stride) {
+    PT_ASSERT(map.TryInsert(key, ValueOf(key, 0)));
+  }
+  for (int key = first_key; key != last_key; key += key_stride) {
+    PT_ASSERT(map.TryGet(key, value));
+    PT_ASSERT_EQ(value, ValueOf(key, 0));
+  }
+
+  // the own keys are contained during the whole read, the others may be
+  map.GetRange(first_key, last_key, std::back_inserter(range),
+    static_cast<size_t>(n_threads * n_keys_per_thread));
+  PT_ASSERT(IsSorted(range));
+  int own_keys = 0;
+  for (size_t i = 0; i != range.size(); ++i) {
+    if (range[i].first % key_stride == first_key) {
+      PT_ASSERT_EQ(range[i].first, first_key + own_keys * key_stride);
+      own_keys++;
+    }
+  }
+  PT_ASSERT_EQ(own_keys, n_keys_per_thread);
+
+  for (int key = first_key; key != last_key; key += key_stride) {
+    PT_ASSERT(map.TryErase(key));
+  }
+  for (int key = first_key; key != last_key; key += key_stride) {
+    PT_ASSERT(!map.TryGet(key, value));
+  }
+}
+
+template<typename Map_t>
+void SkipListMapTest<Map_t>::SkipListMapTestOwnKeys_Post() {
+  int value = -1;
+  range_t range;
+  for (int key = 0; key != n_threads * n_keys_per_thread; ++key) {
+    PT_ASSERT(!map.TryGet(key, value));
+  }
+  PT_ASSERT_EQ(map.GetRange(0, n_threads * n_keys_per_thread,
+    std::back_inserter(range), 1), static_cast<size_t>(0));
+  PT_ASSERT_EQ(CheckLevels(), 0);
+}
+
+template<typename Map_t>
+void SkipListMapTest<Map_t>::SkipListMapTestTowerRacesErase_Pre() {
+  embb_internal_thread_index_reset();
+  erased_rounds = 0;
+  checked_rounds = 0;
+  // let the erase come in between on a single core, too
+  map.yield_while_linking = true;
+}
+
+template<typename Map_t>
+void SkipListMapTest<Map_t>::SkipListMapTestTowerRacesErase_ThreadMethod() {
+  unsigned int thread_index;
+  int return_val = embb_internal_thread_index(&thread_index);
+  PT_ASSERT(EMBB_SUCCESS == return_val);
+
+  int const me = static_cast<int>(thread_index);
+  int value = -1;
+  for (int round = 0; round != n_iterations; ++round) {
+    int const key = round % n_keys_per_thread;
+    if (me % 2 == 0) {
+      PT_ASSERT(map.TryInsert(key, ValueOf(key, me)));
+      while (erased_rounds.Load() == round) {
+        embb::base::Thread::CurrentYield();
+      }
+      // Nobody searches before the levels are checked, a search would
+      // unlink a node left behind by the insertion
+      PT_ASSERT_EQ(CheckLevels(), 0);
+      checked_rounds = round + 1;
+    } else {
+      while (checked_rounds.Load() != round) {
+        embb::base::Thread::CurrentYield();
+      }
+      // the insertion yields after linking the lowest level
+      while (!map.TryGet(key, value)) {
+        embb::base::Thread::CurrentYield();
+      }
+      PT_ASSERT_EQ(value / 1000, key);
+      PT_ASSERT(map.TryErase(key));
+      erased_rounds = round + 1;
+    }
+  }
+}
+
+template<typename Map_t>
+void SkipListMapTest<Map_t>::SkipListMapTestTowerRacesErase_Post() {
+  map.yield_while_linking = false;
+  PT_ASSERT_EQ(checked_rounds.Load(), n_iterations);
+  PT_ASSERT_EQ(CheckLevels(), 0);
+}
+} // namespace test
+} // namespace containers
+} // namespace embb
+
+#endif  // CONTAINERS_CPP_TEST_SKIP_LIST_MAP_TEST_INL_H_
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef CONTAINERS_CPP_TEST_SKIP_LIST_MAP_TEST_H_
+#define CONTAINERS_CPP_TEST_SKIP_LIST_MAP_TEST_H_
+
+#include <partest/partest.h>
+#include <embb/base/atomic.h>
+
+#include <utility>
+#include <vector>
+
+namespace embb {
+namespace containers {
+namespace test {
+/**
+ * Tests LockFreeSkipListMap. Besides the map operations, the concurrent units
+ * check the levels of the map afterwards: an insertion still linking its node
+ * into the upper levels while the key is erased must not leave the node
+ * behind on any of them.
+ */
+template<typename Map_t>
+class SkipListMapTest : public partest::TestCase {
+ private:
+
+  typedef std::vector< std::pair<int, int> > range_t;
+  typedef typename Map_t::Node Node;
+
+  int n_threads;
+  int n_iterations;
+  int n_keys_per_thread;
+  Map_t map;
+  // rounds of the tower test in which the key has been erased, and in which
+  // the levels have been checked afterwards
+  embb::base::Atomic<int> erased_rounds;
+  embb::base::Atomic<int> checked_rounds;
+
+  // value stored for key by a thread, the key is the value divided by 1000
+  static int ValueOf(int key, int thread_index);
+
+  // checks that the keys of a range ascend and match their values
+  static bool IsSorted(range_t const & range);
+
+  // walks all levels of the map, which must not be modified meanwhile, and
+  // returns the number of keys
+  int CheckLevels();
+
+  void SkipListMapTestSequential();
+
+  void SkipListMapTestOwnKeys_Pre();
+  void SkipListMapTestOwnKeys_ThreadMethod();
+  void SkipListMapTestOwnKeys_Post();
+
+  void SkipListMapTestTowerRacesErase_Pre();
+  void SkipListMapTestTowerRacesErase_ThreadMethod();
+  void SkipListMapTestTowerRacesErase_Post();
+
+ public:
+  SkipListMapTest();
+};
+} // namespace test
+} // namespace containers
+} // namespace embb
+
+#include "./skip_list_map_test-inl.h"
+
+#endif  // CONTAINERS_CPP_TEST_SKIP_LIST_MAP_TEST_H_
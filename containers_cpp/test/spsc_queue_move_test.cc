@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "./spsc_queue_move_test.h"
+
+#include <embb/containers/wait_free_spsc_queue.h>
+
+namespace embb {
+namespace containers {
+namespace test {
+int SPSCQueueMoveTest::MoveCounting::copies = 0;
+int SPSCQueueMoveTest::MoveCounting::moves = 0;
+
+SPSCQueueMoveTest::SPSCQueueMoveTest() {
+#ifdef EMBB_PLATFORM_HAS_RVALUE_REFERENCES
+  // A temporary is moved into its slot and out again, never copied.
+  CreateUnit("SPSCQueueMoveTestEnqueueRvalue").
+    Add(&SPSCQueueMoveTest::SPSCQueueMoveTestEnqueueRvalue, this);
+#endif
+  // A named element stays with the caller, so it is copied into the slot.
+  CreateUnit("SPSCQueueMoveTestEnqueueLvalue").
+    Add(&SPSCQueueMoveTest::SPSCQueueMoveTestEnqueueLvalue, this);
+}
+
+void SPSCQueueMoveTest::SPSCQueueMoveTestEnqueueRvalue() {
+#ifdef EMBB_PLATFORM_HAS_RVALUE_REFERENCES
+  embb::containers::WaitFreeSPSCQueue<MoveCounting> queue(4);
+  MoveCounting::copies = 0;
+  MoveCounting::moves = 0;
+
+  PT_ASSERT(queue.TryEnqueue(MoveCounting(42)));
+  PT_EXPECT_EQ(MoveCounting::copies, 0);
+  PT_EXPECT_EQ(MoveCounting::moves, 1);
+
+  MoveCounting element;
+  PT_ASSERT(queue.TryDequeue(element));
+  PT_EXPECT_EQ(element.GetValue(), 42);
+  PT_EXPECT_EQ(MoveCounting::copies, 0);
+  PT_EXPECT_EQ(MoveCounting::moves, 2);
+#endif
+}
+
+void SPSCQueueMoveTest::SPSCQueueMoveTestEnqueueLvalue() {
+  embb::containers::WaitFreeSPSCQueue<MoveCounting> queue(4);
+  MoveCounting::copies = 0;
+  MoveCounting::moves = 0;
+
+  MoveCounting original(7);
+  PT_ASSERT(queue.TryEnqueue(original));
+  PT_EXPECT_EQ(original.GetValue(), 7);
+  PT_EXPECT_EQ(MoveCounting::copies, 1);
+
+  MoveCounting element;
+  PT_ASSERT(queue.TryDequeue(element));
+  PT_EXPECT_EQ(element.GetValue(), 7);
+}
+} // namespace test
+} // namespace containers
+} // namespace embb
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef CONTAINERS_CPP_TEST_SPSC_QUEUE_MOVE_TEST_H_
+#define CONTAINERS_CPP_TEST_SPSC_QUEUE_MOVE_TEST_H_
+
+#include <partest/partest.h>
+#include <embb/base/internal/config.h>
+
+namespace embb {
+namespace containers {
+namespace test {
+/**
+ * Checks that the wait-free SPSC queue moves rvalues in and out instead of
+ * copying them.
+ */
+class SPSCQueueMoveTest : public partest::TestCase {
+ public:
+  /**
+   * Adds test methods.
+   */
+  SPSCQueueMoveTest();
+
+ private:
+  // counts how often any instance was copied or moved
+  class MoveCounting {
+   public:
+    MoveCounting() : value_(0) {}
+    explicit MoveCounting(int value) : value_(value) {}
+    MoveCounting(const MoveCounting & other) : value_(other.value_) {
+      ++copies;
+    }
+    MoveCounting & operator=(const MoveCounting & other) {
+      value_ = other.value_;
+      ++copies;
+      return *this;
+    }
+#ifdef EMBB_PLATFORM_HAS_RVALUE_REFERENCES
+    MoveCounting(MoveCounting && other) : value_(other.value_) {
+      other.value_ = 0;
+      ++moves;
+    }
+    MoveCounting & operator=(MoveCounting && other) {
+      value_ = other.value_;
+      other.value_ = 0;
+      ++moves;
+      return *this;
+    }
+#endif
+    int GetValue() const { return value_; }
+
+    static int copies;
+    static int moves;
+
+   private:
+    int value_;
+  };
+
+  void SPSCQueueMoveTestEnqueueRvalue();
+  void SPSCQueueMoveTestEnqueueLvalue();
+};
+} // namespace test
+} // namespace containers
+} // namespace embb
+
+#endif  // CONTAINERS_CPP_TEST_SPSC_QUEUE_MOVE_TEST_H_
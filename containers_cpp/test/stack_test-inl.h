@@ -29,6 +29,7 @@
 
 #include <vector>
 #include <algorithm>
+#include <iterator>
 
 namespace embb {
 namespace containers {
@@ -53,11 +54,18 @@ n_threads(static_cast<int>
   static_cast<size_t>(n_threads),
   static_cast<size_t>(n_iterations)).
   Post(&StackTest::StackTest1_Post, this);
+  CreateUnit("StackTestThreadsPushAndPopBatchesToGlobalStack").
+  Pre(&StackTest::StackTest1_Pre, this).
+  Add(&StackTest::StackTestBatch_ThreadMethod, this,
+  static_cast<size_t>(n_threads),
+  static_cast<size_t>(n_iterations)).
+  Post(&StackTest::StackTest1_Post, this);
 }
 
 template<typename Stack_t>
 void StackTest<Stack_t>::StackTest1_Pre() {
   embb_internal_thread_index_reset();
+  expected_stack_elements.clear();
   thread_local_vectors =
     new std::vector<int>[static_cast<unsigned int>(n_threads)];
 
@@ -122,6 +130,43 @@ void StackTest<Stack_t>::StackTest1_ThreadMethod() {
     my_elements.push_back(return_elem);
   }
 }
+
+template<typename Stack_t>
+void StackTest<Stack_t>::StackTestBatch_ThreadMethod() {
+  unsigned int thread_index;
+  int return_val = embb_internal_thread_index(&thread_index);
+
+  PT_ASSERT(EMBB_SUCCESS == return_val);
+
+  std::vector<int>& my_elements = thread_local_vectors[thread_index];
+
+  // Push the elements in batches of growing size
+  size_t batch_size = 1;
+  for (std::vector<int>::iterator it = my_elements.begin();
+    it != my_elements.end();) {
+    std::vector<int>::iterator batch_end = it +
+      static_cast<std::ptrdiff_t>(std::min(batch_size,
+        static_cast<size_t>(my_elements.end() - it)));
+    size_t pushed = stack.TryPushBatch(it, batch_end);
+    PT_ASSERT(pushed == static_cast<size_t>(batch_end - it));
+    it = batch_end;
+    ++batch_size;
+  }
+
+  my_elements.clear();
+
+  // Pop the same number of elements in batches of shrinking size
+  size_t remaining = static_cast<size_t>(n_stack_elements_per_thread);
+  batch_size = remaining;
+  while (remaining > 0) {
+    batch_size = std::min(batch_size, remaining);
+    size_t popped = stack.TryPopBatch(std::back_inserter(my_elements),
+      batch_size);
+    PT_ASSERT(popped == batch_size);
+    remaining -= popped;
+    batch_size = batch_size / 2 + 1;
+  }
+}
 } // namespace test
 } // namespace containers
 } // namespace embb
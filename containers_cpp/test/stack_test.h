@@ -53,6 +53,8 @@ class StackTest : public partest::TestCase {
   void StackTest1_Post();
 
   void StackTest1_ThreadMethod();
+
+  void StackTestBatch_ThreadMethod();
 };
 } // namespace test
 } // namespace containers
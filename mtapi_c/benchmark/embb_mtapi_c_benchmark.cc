@@ -0,0 +1,576 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Measures the MTAPI scheduler.
+//
+// The fork-join run builds a binary tree of tasks of the given depth, every
+// inner task starts two children and waits for them. It runs once with tasks
+// executed on the worker stacks, where a waiting task executes other tasks
+// recursively, and once with tasks executed on fibers, where a waiting task
+// is suspended. Besides the time, every run reports the largest number of
+// task frames that were alive on one worker at the same time and the stack
+// memory they took: the distance between the outermost and the innermost
+// frame on the worker stack, or one fiber stack per frame with fibers. Deep
+// trees overflow the worker stack without fibers.
+//
+// The throttling run (--benchmark throttle) starts tasks that use a shared
+// resource, interleaved with the same number of independent tasks. The
+// resource serves up to the given limit of users at full speed, each further
+// user adds the duration of one use for everybody inside. The resource tasks
+// either enter without limit ("unlimited"), wait inside the action on a
+// semaphore that admits the limit ("blocking"), or are throttled by the
+// scheduler with MTAPI_ACTION_MAX_CONCURRENCY ("throttled"). Blocked tasks
+// occupy their worker, throttled tasks leave it to the independent tasks.
+//
+// Reports one line of CSV or one JSON object per run.
+
+#include <embb/mtapi/c/mtapi.h>
+#include <embb/base/c/atomic.h>
+#include <embb/base/c/condition_variable.h>
+#include <embb/base/c/core_set.h>
+#include <embb/base/c/internal/thread_index.h>
+#include <embb/base/c/mutex.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#define BENCHMARK_DOMAIN 1
+#define BENCHMARK_NODE 1
+#define BENCHMARK_FORK_JOIN_JOB 1
+#define BENCHMARK_RESOURCE_JOB 2
+#define BENCHMARK_INDEPENDENT_JOB 3
+
+struct BenchmarkOptions {
+  std::string benchmark;
+  std::vector<int> depths;
+  int fibers;
+  int stack_size;
+  int repetitions;
+  std::vector<int> limits;
+  int tasks;
+  int work;
+  bool json;
+};
+
+struct BenchmarkResult {
+  char const * run;
+  int depth;
+  int tasks;
+  double seconds;
+  int max_frames;
+  double stack_bytes;
+};
+
+// task frames of one worker, only touched by the worker itself
+struct WorkerFrames {
+  int frames;
+  int max_frames;
+  uintptr_t outermost;
+  uintptr_t innermost;
+};
+
+static std::vector<WorkerFrames> worker_frames;
+
+struct ThrottleResult {
+  char const * run;
+  int limit;
+  int tasks;
+  double seconds;
+};
+
+// a resource that slows down for everybody beyond the given number of users
+struct Resource {
+  int limit;
+  // duration of a use in microseconds
+  int work;
+  bool is_blocking;
+  embb_atomic_int users;
+  // semaphore of the blocking run
+  embb_mutex_t mutex;
+  embb_condition_t available;
+  int available_count;
+};
+
+static Resource resource;
+
+static void fork_join(
+  void const * arguments,
+  mtapi_size_t /*arguments_size*/,
+  void * /*result_buffer*/,
+  mtapi_size_t /*result_buffer_size*/,
+  void const * /*node_local_data*/,
+  mtapi_size_t /*node_local_data_size*/,
+  mtapi_task_context_t * context) {
+  mtapi_status_t status;
+  int depth = *static_cast<int const *>(arguments);
+  WorkerFrames & worker =
+    worker_frames[mtapi_context_corenum_get(context, &status)];
+  uintptr_t frame = reinterpret_cast<uintptr_t>(&depth);
+
+  if (0 == worker.frames) {
+    worker.outermost = frame;
+    worker.innermost = frame;
+  }
+  worker.innermost = std::min(worker.innermost, frame);
+  worker.frames++;
+  worker.max_frames = std::max(worker.max_frames, worker.frames);
+
+  if (0 < depth) {
+    mtapi_job_hndl_t job =
+      mtapi_job_get(BENCHMARK_FORK_JOIN_JOB, BENCHMARK_DOMAIN, &status);
+    int child_depth = depth - 1;
+    mtapi_task_hndl_t left = mtapi_task_start(MTAPI_TASK_ID_NONE, job,
+      &child_depth, sizeof(child_depth), MTAPI_NULL, 0,
+      MTAPI_DEFAULT_TASK_ATTRIBUTES, MTAPI_GROUP_NONE, &status);
+    mtapi_task_hndl_t right = mtapi_task_start(MTAPI_TASK_ID_NONE, job,
+      &child_depth, sizeof(child_depth), MTAPI_NULL, 0,
+      MTAPI_DEFAULT_TASK_ATTRIBUTES, MTAPI_GROUP_NONE, &status);
+    mtapi_task_wait(left, MTAPI_INFINITE, &status);
+    mtapi_task_wait(right, MTAPI_INFINITE, &status);
+    if (MTAPI_SUCCESS != status) {
+      mtapi_context_status_set(context, MTAPI_ERR_ACTION_FAILED, MTAPI_NULL);
+    }
+  }
+
+  worker.frames--;
+}
+
+// monotonic wall clock time in microseconds
+static double wall_time() {
+#ifdef _WIN32
+  LARGE_INTEGER frequency;
+  LARGE_INTEGER counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return static_cast<double>(counter.QuadPart) * 1e6 /
+    static_cast<double>(frequency.QuadPart);
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<double>(now.tv_sec) * 1e6 +
+    static_cast<double>(now.tv_nsec) / 1e3;
+#endif
+}
+
+// keeps the worker busy for the given number of microseconds
+static void spin(double microseconds) {
+  double end = wall_time() + microseconds;
+  while (wall_time() < end) {
+  }
+}
+
+static void use_resource(
+  void const * /*arguments*/,
+  mtapi_size_t /*arguments_size*/,
+  void * /*result_buffer*/,
+  mtapi_size_t /*result_buffer_size*/,
+  void const * /*node_local_data*/,
+  mtapi_size_t /*node_local_data_size*/,
+  mtapi_task_context_t * /*context*/) {
+  if (resource.is_blocking) {
+    embb_mutex_lock(&resource.mutex);
+    while (0 == resource.available_count) {
+      embb_condition_wait(&resource.available, &resource.mutex);
+    }
+    resource.available_count--;
+    embb_mutex_unlock(&resource.mutex);
+  }
+
+  int users = embb_atomic_fetch_and_add_int(&resource.users, 1) + 1;
+  spin(static_cast<double>(resource.work) *
+    (1 + std::max(0, users - resource.limit)));
+  embb_atomic_fetch_and_add_int(&resource.users, -1);
+
+  if (resource.is_blocking) {
+    embb_mutex_lock(&resource.mutex);
+    resource.available_count++;
+    embb_condition_notify_one(&resource.available);
+    embb_mutex_unlock(&resource.mutex);
+  }
+}
+
+static void independent(
+  void const * /*arguments*/,
+  mtapi_size_t /*arguments_size*/,
+  void * /*result_buffer*/,
+  mtapi_size_t /*result_buffer_size*/,
+  void const * /*node_local_data*/,
+  mtapi_size_t /*node_local_data_size*/,
+  mtapi_task_context_t * /*context*/) {
+  spin(static_cast<double>(resource.work));
+}
+
+static bool parse_list(char const * text, std::vector<int> * list) {
+  list->clear();
+  while (*text) {
+    char * end;
+    long value = strtol(text, &end, 10);
+    if (end == text || value < 0) {
+      return false;
+    }
+    list->push_back(static_cast<int>(value));
+    text = (',' == *end) ? end + 1 : end;
+  }
+  return !list->empty();
+}
+
+static void usage(char const * name) {
+  fprintf(stderr,
+    "usage: %s [options]\n"
+    "  --benchmark NAME    fork_join or throttle (fork_join)\n"
+    "  --depths LIST       depths of the fork-join trees (8,10,12)\n"
+    "  --fibers N          fibers per worker in the fiber runs (4096)\n"
+    "  --stack-size N      stack size of a fiber in bytes (65536)\n"
+    "  --repetitions N     trees built per run (3)\n"
+    "  --limits LIST       users the resource serves at full speed (1,2)\n"
+    "  --tasks N           resource tasks per throttling run (2000)\n"
+    "  --work N            microseconds per task (20)\n"
+    "  --json              print JSON instead of CSV\n",
+    name);
+}
+
+static bool parse_options(int argc, char ** argv, BenchmarkOptions * options) {
+  options->benchmark = "fork_join";
+  parse_list("8,10,12", &options->depths);
+  options->fibers = 4096;
+  options->stack_size = 65536;
+  options->repetitions = 3;
+  parse_list("1,2", &options->limits);
+  options->tasks = 2000;
+  options->work = 20;
+  options->json = false;
+
+  for (int ii = 1; ii < argc; ii++) {
+    std::string option = argv[ii];
+    char const * value = (ii + 1 < argc) ? argv[ii + 1] : NULL;
+    bool ok = true;
+    if ("--json" == option) {
+      options->json = true;
+      continue;
+    } else if (NULL == value) {
+      ok = false;
+    } else if ("--benchmark" == option) {
+      options->benchmark = value;
+      ok = ("fork_join" == options->benchmark ||
+        "throttle" == options->benchmark);
+    } else if ("--depths" == option) {
+      ok = parse_list(value, &options->depths);
+    } else if ("--fibers" == option) {
+      options->fibers = atoi(value);
+    } else if ("--stack-size" == option) {
+      options->stack_size = atoi(value);
+    } else if ("--repetitions" == option) {
+      options->repetitions = atoi(value);
+    } else if ("--limits" == option) {
+      ok = parse_list(value, &options->limits);
+    } else if ("--tasks" == option) {
+      options->tasks = atoi(value);
+    } else if ("--work" == option) {
+      options->work = atoi(value);
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      return false;
+    }
+    ii++;
+  }
+
+  return 0 < options->fibers && 0 < options->stack_size &&
+    0 < options->repetitions && 0 < options->tasks && 0 < options->work &&
+    *std::max_element(options->depths.begin(), options->depths.end()) < 24;
+}
+
+static bool run_fork_join(
+  BenchmarkOptions const & options,
+  int depth,
+  mtapi_uint_t fibers,
+  BenchmarkResult * result) {
+  mtapi_status_t status;
+  mtapi_node_attributes_t node_attr;
+  mtapi_uint_t stack_size = static_cast<mtapi_uint_t>(options.stack_size);
+  // every task of a tree may be outstanding at the same time
+  mtapi_uint_t max_tasks = (2u << depth) + 16u;
+  bool ok = true;
+
+  worker_frames.assign(embb_core_count_available(), WorkerFrames());
+
+  // the workers of every node take new thread indices
+  embb_internal_thread_index_reset();
+  mtapi_nodeattr_init(&node_attr, &status);
+  mtapi_nodeattr_set(&node_attr, MTAPI_NODE_MAX_TASKS,
+    &max_tasks, MTAPI_NODE_MAX_TASKS_SIZE, &status);
+  mtapi_nodeattr_set(&node_attr, MTAPI_NODE_QUEUE_LIMIT,
+    &max_tasks, MTAPI_NODE_QUEUE_LIMIT_SIZE, &status);
+  // the main thread never runs tasks on fibers, so it only waits here
+  mtapi_nodeattr_set(&node_attr, MTAPI_NODE_REUSE_MAIN_THREAD,
+    MTAPI_ATTRIBUTE_VALUE(MTAPI_FALSE), MTAPI_ATTRIBUTE_POINTER_AS_VALUE,
+    &status);
+  mtapi_nodeattr_set(&node_attr, MTAPI_NODE_MAX_FIBERS,
+    &fibers, MTAPI_NODE_MAX_FIBERS_SIZE, &status);
+  mtapi_nodeattr_set(&node_attr, MTAPI_NODE_FIBER_STACK_SIZE,
+    &stack_size, MTAPI_NODE_FIBER_STACK_SIZE_SIZE, &status);
+  mtapi_initialize(BENCHMARK_DOMAIN, BENCHMARK_NODE, &node_attr, MTAPI_NULL,
+    &status);
+  if (MTAPI_SUCCESS != status) {
+    fprintf(stderr, "could not initialize MTAPI\n");
+    return false;
+  }
+
+  mtapi_action_hndl_t action = mtapi_action_create(BENCHMARK_FORK_JOIN_JOB,
+    fork_join, MTAPI_NULL, 0, MTAPI_DEFAULT_ACTION_ATTRIBUTES, &status);
+  mtapi_job_hndl_t job =
+    mtapi_job_get(BENCHMARK_FORK_JOIN_JOB, BENCHMARK_DOMAIN, &status);
+  ok = (MTAPI_SUCCESS == status);
+
+  double start = wall_time();
+  for (int ii = 0; ok && ii < options.repetitions; ii++) {
+    mtapi_task_hndl_t root = mtapi_task_start(MTAPI_TASK_ID_NONE, job,
+      &depth, sizeof(depth), MTAPI_NULL, 0,
+      MTAPI_DEFAULT_TASK_ATTRIBUTES, MTAPI_GROUP_NONE, &status);
+    if (MTAPI_SUCCESS == status) {
+      mtapi_task_wait(root, MTAPI_INFINITE, &status);
+    }
+    ok = (MTAPI_SUCCESS == status);
+  }
+  double wall = wall_time() - start;
+
+  mtapi_action_delete(action, MTAPI_INFINITE, &status);
+  mtapi_finalize(&status);
+  if (!ok) {
+    fprintf(stderr, "tasks failed\n");
+    return false;
+  }
+
+  result->run = (0 < fibers) ? "fibers" : "stack";
+  result->depth = depth;
+  result->tasks = ((2 << depth) - 1) * options.repetitions;
+  result->seconds = wall / 1e6;
+  result->max_frames = 0;
+  result->stack_bytes = 0.0;
+  for (size_t ii = 0; ii < worker_frames.size(); ii++) {
+    WorkerFrames const & worker = worker_frames[ii];
+    double bytes = (0 < fibers) ?
+      static_cast<double>(worker.max_frames) * options.stack_size :
+      static_cast<double>(worker.outermost - worker.innermost);
+    result->max_frames = std::max(result->max_frames, worker.max_frames);
+    result->stack_bytes = std::max(result->stack_bytes, bytes);
+  }
+  return true;
+}
+
+static bool run_throttle(
+  BenchmarkOptions const & options,
+  int limit,
+  char const * run,
+  ThrottleResult * result) {
+  mtapi_status_t status;
+  mtapi_node_attributes_t node_attr;
+  mtapi_action_attributes_t action_attr;
+  // all tasks are started before the first one is waited for
+  mtapi_uint_t max_tasks = 2u * static_cast<mtapi_uint_t>(options.tasks) + 16u;
+  mtapi_uint_t max_concurrency = static_cast<mtapi_uint_t>(limit);
+  bool is_throttled = (std::string("throttled") == run);
+  std::vector<mtapi_task_hndl_t> tasks;
+  bool ok = true;
+
+  resource.limit = limit;
+  resource.work = options.work;
+  resource.is_blocking = (std::string("blocking") == run);
+  resource.available_count = limit;
+
+  embb_internal_thread_index_reset();
+  mtapi_nodeattr_init(&node_attr, &status);
+  mtapi_nodeattr_set(&node_attr, MTAPI_NODE_MAX_TASKS,
+    &max_tasks, MTAPI_NODE_MAX_TASKS_SIZE, &status);
+  mtapi_nodeattr_set(&node_attr, MTAPI_NODE_QUEUE_LIMIT,
+    &max_tasks, MTAPI_NODE_QUEUE_LIMIT_SIZE, &status);
+  mtapi_nodeattr_set(&node_attr, MTAPI_NODE_REUSE_MAIN_THREAD,
+    MTAPI_ATTRIBUTE_VALUE(MTAPI_FALSE), MTAPI_ATTRIBUTE_POINTER_AS_VALUE,
+    &status);
+  mtapi_initialize(BENCHMARK_DOMAIN, BENCHMARK_NODE, &node_attr, MTAPI_NULL,
+    &status);
+  if (MTAPI_SUCCESS != status) {
+    fprintf(stderr, "could not initialize MTAPI\n");
+    return false;
+  }
+
+  mtapi_actionattr_init(&action_attr, &status);
+  if (is_throttled) {
+    mtapi_actionattr_set(&action_attr, MTAPI_ACTION_MAX_CONCURRENCY,
+      &max_concurrency, MTAPI_ACTION_MAX_CONCURRENCY_SIZE, &status);
+  }
+  mtapi_action_hndl_t resource_action = mtapi_action_create(
+    BENCHMARK_RESOURCE_JOB, use_resource, MTAPI_NULL, 0, &action_attr,
+    &status);
+  ok = (MTAPI_SUCCESS == status);
+  mtapi_action_hndl_t independent_action = mtapi_action_create(
+    BENCHMARK_INDEPENDENT_JOB, independent, MTAPI_NULL, 0,
+    MTAPI_DEFAULT_ACTION_ATTRIBUTES, &status);
+  ok = ok && (MTAPI_SUCCESS == status);
+  mtapi_job_hndl_t resource_job =
+    mtapi_job_get(BENCHMARK_RESOURCE_JOB, BENCHMARK_DOMAIN, &status);
+  ok = ok && (MTAPI_SUCCESS == status);
+  mtapi_job_hndl_t independent_job =
+    mtapi_job_get(BENCHMARK_INDEPENDENT_JOB, BENCHMARK_DOMAIN, &status);
+  ok = ok && (MTAPI_SUCCESS == status);
+
+  double start = wall_time();
+  for (int ii = 0; ok && ii < 2 * options.tasks; ii++) {
+    tasks.push_back(mtapi_task_start(MTAPI_TASK_ID_NONE,
+      (0 == ii % 2) ? resource_job : independent_job,
+      MTAPI_NULL, 0, MTAPI_NULL, 0,
+      MTAPI_DEFAULT_TASK_ATTRIBUTES, MTAPI_GROUP_NONE, &status));
+    ok = (MTAPI_SUCCESS == status);
+  }
+  for (size_t ii = 0; ii < tasks.size(); ii++) {
+    mtapi_task_wait(tasks[ii], MTAPI_INFINITE, &status);
+    ok = ok && (MTAPI_SUCCESS == status);
+  }
+  double wall = wall_time() - start;
+
+  mtapi_action_delete(independent_action, MTAPI_INFINITE, &status);
+  mtapi_action_delete(resource_action, MTAPI_INFINITE, &status);
+  mtapi_finalize(&status);
+  if (!ok) {
+    fprintf(stderr, "tasks failed\n");
+    return false;
+  }
+
+  result->run = run;
+  result->limit = limit;
+  result->tasks = 2 * options.tasks;
+  result->seconds = wall / 1e6;
+  return true;
+}
+
+static void print_throttle_result(
+  BenchmarkOptions const & options,
+  ThrottleResult const & result,
+  bool first) {
+  double tasks_per_second = result.tasks / result.seconds;
+
+  if (options.json) {
+    printf("%s\n  {\"run\": \"%s\", \"limit\": %d, \"tasks\": %d, "
+      "\"seconds\": %.6f, \"tasks_per_second\": %.1f}",
+      first ? "[" : ",", result.run, result.limit, result.tasks,
+      result.seconds, tasks_per_second);
+  } else {
+    if (first) {
+      printf("run,limit,tasks,seconds,tasks_per_second\n");
+    }
+    printf("%s,%d,%d,%.6f,%.1f\n", result.run, result.limit, result.tasks,
+      result.seconds, tasks_per_second);
+  }
+  fflush(stdout);
+}
+
+static void print_result(
+  BenchmarkOptions const & options,
+  BenchmarkResult const & result,
+  bool first) {
+  double tasks_per_second = result.tasks / result.seconds;
+
+  if (options.json) {
+    printf("%s\n  {\"run\": \"%s\", \"depth\": %d, \"tasks\": %d, "
+      "\"seconds\": %.6f, \"tasks_per_second\": %.1f, "
+      "\"max_frames\": %d, \"stack_bytes\": %.0f}",
+      first ? "[" : ",", result.run, result.depth, result.tasks,
+      result.seconds, tasks_per_second, result.max_frames,
+      result.stack_bytes);
+  } else {
+    if (first) {
+      printf("run,depth,tasks,seconds,tasks_per_second,max_frames,"
+        "stack_bytes\n");
+    }
+    printf("%s,%d,%d,%.6f,%.1f,%d,%.0f\n",
+      result.run, result.depth, result.tasks, result.seconds,
+      tasks_per_second, result.max_frames, result.stack_bytes);
+  }
+  fflush(stdout);
+}
+
+int main(int argc, char ** argv) {
+  BenchmarkOptions options;
+  bool ok = true;
+  bool first = true;
+
+  if (!parse_options(argc, argv, &options)) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  if ("throttle" == options.benchmark) {
+    char const * const runs[] = { "unlimited", "blocking", "throttled" };
+    embb_atomic_init_int(&resource.users, 0);
+    embb_mutex_init(&resource.mutex, EMBB_MUTEX_PLAIN);
+    embb_condition_init(&resource.available);
+    for (size_t ii = 0; ok && ii < options.limits.size(); ii++) {
+      for (int jj = 0; ok && jj < 3; jj++) {
+        ThrottleResult result;
+        ok = run_throttle(options, options.limits[ii], runs[jj], &result);
+        if (ok) {
+          print_throttle_result(options, result, first);
+          first = false;
+        }
+      }
+    }
+    embb_condition_destroy(&resource.available);
+    embb_mutex_destroy(&resource.mutex);
+    embb_atomic_destroy_int(&resource.users);
+  }
+
+  for (size_t ii = 0;
+    ok && "fork_join" == options.benchmark && ii < options.depths.size();
+    ii++) {
+    for (int with_fibers = 0; ok && with_fibers < 2; with_fibers++) {
+      BenchmarkResult result;
+      ok = run_fork_join(options, options.depths[ii],
+        with_fibers ? static_cast<mtapi_uint_t>(options.fibers) : 0u,
+        &result);
+      if (ok) {
+        print_result(options, result, first);
+        first = false;
+      }
+    }
+  }
+  if (options.json && !first) {
+    printf("\n]\n");
+  }
+
+  return ok ? 0 : 1;
+}
@@ -649,7 +649,10 @@ enum mtapi_node_attributes_enum {
   MTAPI_NODE_MAX_PRIORITIES,           /**< maximum number of priorities
                                             allowed by the node */
   MTAPI_NODE_REUSE_MAIN_THREAD,        /**< reuse main thread as worker */
-  MTAPI_NODE_WORKER_PRIORITIES         /**< set worker priorites */
+  MTAPI_NODE_WORKER_PRIORITIES,        /**< set worker priorites */
+  MTAPI_NODE_MAX_FIBERS,               /**< maximum number of fibers per
+                                            worker, 0 disables fibers */
+  MTAPI_NODE_FIBER_STACK_SIZE          /**< stack size of a fiber in bytes */
 };
 /** size of the \a MTAPI_NODE_CORE_AFFINITY attribute */
 #define MTAPI_NODE_CORE_AFFINITY_SIZE sizeof(embb_core_set_t)
@@ -677,6 +680,10 @@ enum mtapi_node_attributes_enum {
 #define MTAPI_NODE_REUSE_MAIN_THREAD_SIZE sizeof(mtapi_boolean_t)
 /** size of the \a MTAPI_NODE_WORKER_PRIORITIES attribute */
 #define MTAPI_NODE_WORKER_PRIORITIES_SIZE 0
+/** size of the \a MTAPI_NODE_MAX_FIBERS attribute */
+#define MTAPI_NODE_MAX_FIBERS_SIZE sizeof(mtapi_uint_t)
+/** size of the \a MTAPI_NODE_FIBER_STACK_SIZE attribute */
+#define MTAPI_NODE_FIBER_STACK_SIZE_SIZE sizeof(mtapi_uint_t)
 
 /* example attribute value */
 #define MTAPI_NODE_TYPE_SMP 1
@@ -739,8 +746,10 @@ enum mtapi_action_attributes_enum {
                                             action */
   MTAPI_ACTION_AFFINITY,               /**< the affinity of tasks using the
                                             action */
-  MTAPI_ACTION_DOMAIN_SHARED           /**< indicates domain wide visibility of
+  MTAPI_ACTION_DOMAIN_SHARED,          /**< indicates domain wide visibility of
                                             the action */
+  MTAPI_ACTION_MAX_CONCURRENCY         /**< maximum number of tasks executing
+                                            the action at the same time */
 };
 /** size of the \a MTAPI_ACTION_GLOBAL attribute */
 #define MTAPI_ACTION_GLOBAL_SIZE sizeof(mtapi_boolean_t)
@@ -748,6 +757,8 @@ enum mtapi_action_attributes_enum {
 #define MTAPI_ACTION_AFFINITY_SIZE sizeof(mtapi_affinity_t)
 /** size of the \a MTAPI_ACTION_DOMAIN_SHARED attribute */
 #define MTAPI_ACTION_DOMAIN_SHARED_SIZE sizeof(mtapi_boolean_t)
+/** size of the \a MTAPI_ACTION_MAX_CONCURRENCY attribute */
+#define MTAPI_ACTION_MAX_CONCURRENCY_SIZE sizeof(mtapi_uint_t)
 
 
 /**
@@ -808,6 +819,9 @@ struct mtapi_node_attributes_struct {
   mtapi_worker_priority_entry_t * worker_priorities;
                                        /**< stores
                                             MTAPI_NODE_WORKER_PRIORITIES */
+  mtapi_uint_t max_fibers;             /**< stores MTAPI_NODE_MAX_FIBERS */
+  mtapi_uint_t fiber_stack_size;       /**< stores
+                                            MTAPI_NODE_FIBER_STACK_SIZE */
 };
 
 /**
@@ -818,6 +832,8 @@ struct mtapi_action_attributes_struct {
   mtapi_boolean_t global;              /**< stores MTAPI_ACTION_GLOBAL */
   mtapi_affinity_t affinity;           /**< stores MTAPI_ACTION_AFFINITY */
   mtapi_boolean_t domain_shared;       /**< stores MTAPI_ACTION_DOMAIN_SHARED*/
+  mtapi_uint_t max_concurrency;        /**< stores
+                                            MTAPI_ACTION_MAX_CONCURRENCY */
 };
 
 /**
@@ -1058,6 +1074,9 @@ extern mtapi_group_hndl_t MTAPI_GROUP_NONE;
 #define MTAPI_NODE_MAX_JOBS_DEFAULT 256
 #define MTAPI_NODE_MAX_ACTIONS_PER_JOB_DEFAULT 4
 #define MTAPI_NODE_MAX_PRIORITIES_DEFAULT 4
+/** fibers are disabled by default */
+#define MTAPI_NODE_MAX_FIBERS_DEFAULT 0
+#define MTAPI_NODE_FIBER_STACK_SIZE_DEFAULT (128 * 1024)
 
 #define MTAPI_JOB_ID_INVALID 0
 #define MTAPI_DOMAIN_ID_INVALID 0
@@ -1464,6 +1483,15 @@ void mtapi_actionattr_init(
  *     <td>mtapi_boolean_t</td>
  *     <td>MTAPI_TRUE</td>
  *   </tr>
+ *   <tr>
+ *     <td>MTAPI_ACTION_MAX_CONCURRENCY</td>
+ *     <td>Maximum number of tasks executing the action at the same time.
+ *         Further tasks are held back without occupying a worker thread
+ *         until a running task returns. Has no effect on plugin
+ *         actions.</td>
+ *     <td>mtapi_uint_t</td>
+ *     <td>0 (0 stands for 'unlimited')</td>
+ *   </tr>
  * </table>
  *
  * On success, \c *status is set to \c MTAPI_SUCCESS. On error, \c *status is
@@ -261,6 +261,8 @@ void mtapi_ext_job_set_attribute(
 
 /**
  * This function yields execution to the MTAPI scheduler for at most one task.
+ * If called from a task running on a fiber (see \a MTAPI_NODE_MAX_FIBERS),
+ * the task is suspended and resumed later by the same worker.
  * \notthreadsafe
  * \ingroup C_MTAPI_EXT
  */
@@ -60,6 +60,8 @@ void embb_mtapi_action_initialize(embb_mtapi_action_t* that) {
   that->node_local_data_size = 0;
   that->plugin_data = MTAPI_NULL;
   embb_atomic_init_int(&that->num_tasks, 0);
+  embb_atomic_init_int(&that->num_running, 0);
+  embb_mtapi_task_queue_initialize(&that->pending_tasks);
 }
 
 void embb_mtapi_action_finalize(embb_mtapi_action_t* that) {
@@ -78,6 +80,63 @@ void embb_mtapi_action_finalize(embb_mtapi_action_t* that) {
   that->node_local_data_size = 0;
   that->plugin_data = MTAPI_NULL;
   embb_atomic_destroy_int(&that->num_tasks);
+  embb_atomic_destroy_int(&that->num_running);
+  embb_mtapi_task_queue_finalize(&that->pending_tasks);
+}
+
+int embb_mtapi_action_task_start(embb_mtapi_action_t* that) {
+  int max_concurrency = (int)that->attributes.max_concurrency;
+  int running;
+
+  assert(MTAPI_NULL != that);
+
+  if (0 == max_concurrency) {
+    /* unlimited */
+    return 1;
+  }
+
+  running = embb_atomic_load_int(&that->num_running);
+  while (running < max_concurrency) {
+    if (embb_atomic_compare_and_swap_int(
+      &that->num_running, &running, running + 1)) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+void embb_mtapi_action_task_finish(embb_mtapi_action_t* that) {
+  assert(MTAPI_NULL != that);
+
+  if (0 < that->attributes.max_concurrency) {
+    embb_atomic_fetch_and_add_int(&that->num_running, -1);
+  }
+}
+
+embb_mtapi_task_t * embb_mtapi_action_get_pending_task(
+  embb_mtapi_action_t* that) {
+  assert(MTAPI_NULL != that);
+
+  if (embb_atomic_load_int(&that->num_running) <
+    (int)that->attributes.max_concurrency) {
+    return embb_mtapi_task_queue_pop_front(&that->pending_tasks);
+  }
+  return MTAPI_NULL;
+}
+
+static void embb_mtapi_action_cancel_pending_tasks(
+  embb_mtapi_action_t * action,
+  embb_mtapi_node_t * node,
+  mtapi_status_t error_code) {
+  embb_mtapi_task_t * task =
+    embb_mtapi_task_queue_pop_front(&action->pending_tasks);
+
+  /* held back tasks are in no worker queue, so they are finalized here */
+  while (MTAPI_NULL != task) {
+    task->error_code = error_code;
+    embb_mtapi_scheduler_finalize_task(task, node, MTAPI_TASK_CANCELLED);
+    task = embb_mtapi_task_queue_pop_front(&action->pending_tasks);
+  }
 }
 
 static mtapi_boolean_t embb_mtapi_action_delete_visitor(
@@ -151,6 +210,8 @@ mtapi_action_hndl_t mtapi_action_create(
         new_action->enabled = MTAPI_TRUE;
         new_action->is_plugin_action = MTAPI_FALSE;
         embb_atomic_init_int(&new_action->num_tasks, 0);
+        embb_atomic_init_int(&new_action->num_running, 0);
+        embb_mtapi_task_queue_initialize(&new_action->pending_tasks);
 
         new_action->action_function = action_function;
 
@@ -264,6 +325,12 @@ void mtapi_action_get_attribute(
             attribute_size);
           break;
 
+        case MTAPI_ACTION_MAX_CONCURRENCY:
+          local_status = embb_mtapi_attr_get_mtapi_uint_t(
+            &local_action->attributes.max_concurrency,
+            attribute, attribute_size);
+          break;
+
         default:
           /* attribute unknown */
           local_status = MTAPI_ERR_ATTR_NUM;
@@ -312,6 +379,8 @@ void mtapi_action_delete(
       /* cancel all tasks */
       embb_mtapi_scheduler_process_tasks(
         node->scheduler, embb_mtapi_action_delete_visitor, local_action);
+      embb_mtapi_action_cancel_pending_tasks(
+        local_action, node, MTAPI_ERR_ACTION_DELETED);
 
       /* find out on which thread we are */
       context = embb_mtapi_scheduler_get_current_thread_context(
@@ -335,6 +404,11 @@ void mtapi_action_delete(
           }
         }
 
+        /* a worker might still hold back a task it fetched before the
+           tasks were cancelled */
+        embb_mtapi_action_cancel_pending_tasks(
+          local_action, node, MTAPI_ERR_ACTION_DELETED);
+
         /* do other work if applicable */
         embb_mtapi_scheduler_execute_task_or_yield(
           node->scheduler,
@@ -394,6 +468,8 @@ void mtapi_action_disable(
       /* cancel all tasks */
       embb_mtapi_scheduler_process_tasks(
         node->scheduler, embb_mtapi_action_disable_visitor, local_action);
+      embb_mtapi_action_cancel_pending_tasks(
+        local_action, node, MTAPI_ERR_ACTION_DISABLED);
 
       /* find out on which thread we are */
       context = embb_mtapi_scheduler_get_current_thread_context(
@@ -417,6 +493,11 @@ void mtapi_action_disable(
           }
         }
 
+        /* a worker might still hold back a task it fetched before the
+           tasks were cancelled */
+        embb_mtapi_action_cancel_pending_tasks(
+          local_action, node, MTAPI_ERR_ACTION_DISABLED);
+
         /* do other work if applicable */
         embb_mtapi_scheduler_execute_task_or_yield(
           node->scheduler,
@@ -31,6 +31,7 @@
 #include <embb/base/c/atomic.h>
 
 #include <embb_mtapi_pool_template.h>
+#include <embb_mtapi_task_queue_t.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -64,6 +65,9 @@ struct embb_mtapi_action_struct {
   mtapi_ext_plugin_action_finalize_function_t plugin_action_finalize_function;
 
   embb_atomic_int num_tasks;
+
+  embb_atomic_int num_running;
+  embb_mtapi_task_queue_t pending_tasks;
 };
 
 #include <embb_mtapi_action_t_fwd.h>
@@ -80,6 +84,27 @@ void embb_mtapi_action_initialize(embb_mtapi_action_t* that);
  */
 void embb_mtapi_action_finalize(embb_mtapi_action_t* that);
 
+/**
+ * Start a task executing the action, returns 0 if the maximum concurrency
+ * of the action is reached.
+ * \memberof embb_mtapi_action_struct
+ */
+int embb_mtapi_action_task_start(embb_mtapi_action_t* that);
+
+/**
+ * Finish a task executing the action.
+ * \memberof embb_mtapi_action_struct
+ */
+void embb_mtapi_action_task_finish(embb_mtapi_action_t* that);
+
+/**
+ * Fetch a task that has been held back due to the maximum concurrency of the
+ * action if there is a free execution slot. Returns MTAPI_NULL otherwise.
+ * \memberof embb_mtapi_action_struct
+ */
+embb_mtapi_task_t * embb_mtapi_action_get_pending_task(
+  embb_mtapi_action_t* that);
+
 
 /* ---- POOL DECLARATION --------------------------------------------------- */
 
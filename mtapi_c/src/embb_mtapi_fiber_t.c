@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <assert.h>
+#include <stdint.h>
+
+#include <embb/mtapi/c/mtapi.h>
+
+#include <embb_mtapi_log.h>
+#include <embb_mtapi_alloc.h>
+#include <embb_mtapi_fiber_t.h>
+
+
+/* ---- CLASS MEMBERS ------------------------------------------------------ */
+
+#ifdef EMBB_PLATFORM_THREADING_WINTHREADS
+
+static VOID CALLBACK embb_mtapi_fiber_entry(LPVOID arg) {
+  embb_mtapi_fiber_t * that = (embb_mtapi_fiber_t*)arg;
+  for (;;) {
+    that->function(that);
+    embb_mtapi_fiber_suspend(that);
+  }
+}
+
+mtapi_boolean_t embb_mtapi_fiber_initialize(
+  embb_mtapi_fiber_t * that,
+  mtapi_uint_t stack_size,
+  embb_mtapi_fiber_function_t * function,
+  embb_mtapi_thread_context_t * thread_context) {
+  assert(MTAPI_NULL != that);
+  assert(MTAPI_NULL != function);
+
+  that->function = function;
+  that->thread_context = thread_context;
+  that->task = MTAPI_NULL;
+  that->wait_task = MTAPI_NULL;
+  that->next = MTAPI_NULL;
+  that->caller = NULL;
+  that->handle = CreateFiber(stack_size, embb_mtapi_fiber_entry, that);
+  that->is_initialized = (NULL != that->handle) ? MTAPI_TRUE : MTAPI_FALSE;
+
+  return that->is_initialized;
+}
+
+void embb_mtapi_fiber_finalize(embb_mtapi_fiber_t * that) {
+  assert(MTAPI_NULL != that);
+
+  if (that->is_initialized) {
+    DeleteFiber(that->handle);
+    that->handle = NULL;
+    that->is_initialized = MTAPI_FALSE;
+  }
+}
+
+void embb_mtapi_fiber_resume(embb_mtapi_fiber_t * that) {
+  assert(MTAPI_NULL != that);
+  assert(that->is_initialized);
+
+  if (!IsThreadAFiber()) {
+    ConvertThreadToFiber(NULL);
+  }
+  that->caller = GetCurrentFiber();
+  SwitchToFiber(that->handle);
+}
+
+void embb_mtapi_fiber_suspend(embb_mtapi_fiber_t * that) {
+  assert(MTAPI_NULL != that);
+
+  SwitchToFiber(that->caller);
+}
+
+#else
+
+/* makecontext only passes int arguments, so the pointer is split in two */
+static void embb_mtapi_fiber_entry(unsigned int high, unsigned int low) {
+  embb_mtapi_fiber_t * that = (embb_mtapi_fiber_t*)(
+    (((uintptr_t)high << 16) << 16) | (uintptr_t)low);
+  for (;;) {
+    that->function(that);
+    embb_mtapi_fiber_suspend(that);
+  }
+}
+
+mtapi_boolean_t embb_mtapi_fiber_initialize(
+  embb_mtapi_fiber_t * that,
+  mtapi_uint_t stack_size,
+  embb_mtapi_fiber_function_t * function,
+  embb_mtapi_thread_context_t * thread_context) {
+  uintptr_t address = (uintptr_t)that;
+
+  assert(MTAPI_NULL != that);
+  assert(MTAPI_NULL != function);
+
+  that->function = function;
+  that->thread_context = thread_context;
+  that->task = MTAPI_NULL;
+  that->wait_task = MTAPI_NULL;
+  that->next = MTAPI_NULL;
+  that->is_initialized = MTAPI_FALSE;
+
+  that->stack = embb_mtapi_alloc_allocate(stack_size);
+  if (NULL == that->stack) {
+    return MTAPI_FALSE;
+  }
+  if (0 != getcontext(&that->context)) {
+    embb_mtapi_alloc_deallocate(that->stack);
+    that->stack = NULL;
+    return MTAPI_FALSE;
+  }
+  that->context.uc_stack.ss_sp = that->stack;
+  that->context.uc_stack.ss_size = stack_size;
+  that->context.uc_link = NULL;
+  makecontext(&that->context, (void(*)(void))embb_mtapi_fiber_entry, 2,
+    (unsigned int)((address >> 16) >> 16), (unsigned int)address);
+  that->is_initialized = MTAPI_TRUE;
+
+  return MTAPI_TRUE;
+}
+
+void embb_mtapi_fiber_finalize(embb_mtapi_fiber_t * that) {
+  assert(MTAPI_NULL != that);
+
+  if (that->is_initialized) {
+    embb_mtapi_alloc_deallocate(that->stack);
+    that->stack = NULL;
+    that->is_initialized = MTAPI_FALSE;
+  }
+}
+
+void embb_mtapi_fiber_resume(embb_mtapi_fiber_t * that) {
+  assert(MTAPI_NULL != that);
+  assert(that->is_initialized);
+
+  if (0 != swapcontext(&that->caller, &that->context)) {
+    embb_mtapi_log_error("embb_mtapi_fiber_resume() failed\n");
+  }
+}
+
+void embb_mtapi_fiber_suspend(embb_mtapi_fiber_t * that) {
+  assert(MTAPI_NULL != that);
+
+  if (0 != swapcontext(&that->context, &that->caller)) {
+    embb_mtapi_log_error("embb_mtapi_fiber_suspend() failed\n");
+  }
+}
+
+#endif
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MTAPI_C_SRC_EMBB_MTAPI_FIBER_T_H_
+#define MTAPI_C_SRC_EMBB_MTAPI_FIBER_T_H_
+
+#include <embb/mtapi/c/mtapi.h>
+#include <embb/base/c/internal/platform.h>
+
+#ifdef EMBB_PLATFORM_THREADING_POSIXTHREADS
+#include <ucontext.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* ---- FORWARD DECLARATIONS ----------------------------------------------- */
+
+#include <embb_mtapi_fiber_t_fwd.h>
+#include <embb_mtapi_task_t_fwd.h>
+#include <embb_mtapi_thread_context_t_fwd.h>
+
+/**
+ * Function executed by a fiber each time it is started.
+ */
+typedef void embb_mtapi_fiber_function_t(embb_mtapi_fiber_t * fiber);
+
+
+/* ---- CLASS DECLARATION -------------------------------------------------- */
+
+/**
+ * \internal
+ * Fiber class. A fiber owns a stack of its own and is switched to and from
+ * explicitly by the worker it belongs to. This allows a task to be suspended
+ * while waiting without blocking or growing the worker's stack.
+ *
+ * \ingroup INTERNAL
+ */
+struct embb_mtapi_fiber_struct {
+#ifdef EMBB_PLATFORM_THREADING_WINTHREADS
+  LPVOID handle;
+  LPVOID caller;
+#else
+  ucontext_t context;
+  ucontext_t caller;
+  void * stack;
+#endif
+  embb_mtapi_fiber_function_t * function;
+  embb_mtapi_thread_context_t * thread_context;
+  embb_mtapi_task_t * task;
+  embb_mtapi_task_t * wait_task;
+  embb_mtapi_fiber_t * next;
+  mtapi_boolean_t is_initialized;
+};
+
+/**
+ * Constructor. Allocates the stack of the fiber, \a function is executed
+ * each time the fiber is resumed after it has run to completion.
+ * \memberof embb_mtapi_fiber_struct
+ * \returns MTAPI_TRUE if successful, MTAPI_FALSE on error
+ */
+mtapi_boolean_t embb_mtapi_fiber_initialize(
+  embb_mtapi_fiber_t * that,
+  mtapi_uint_t stack_size,
+  embb_mtapi_fiber_function_t * function,
+  embb_mtapi_thread_context_t * thread_context);
+
+/**
+ * Destructor. The fiber must not be running.
+ * \memberof embb_mtapi_fiber_struct
+ */
+void embb_mtapi_fiber_finalize(embb_mtapi_fiber_t * that);
+
+/**
+ * Switches from the calling thread to the fiber. Returns as soon as the
+ * fiber suspends itself or its function has returned.
+ * \memberof embb_mtapi_fiber_struct
+ */
+void embb_mtapi_fiber_resume(embb_mtapi_fiber_t * that);
+
+/**
+ * Switches from the fiber back to the code that resumed it. Must be called
+ * on the fiber itself.
+ * \memberof embb_mtapi_fiber_struct
+ */
+void embb_mtapi_fiber_suspend(embb_mtapi_fiber_t * that);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MTAPI_C_SRC_EMBB_MTAPI_FIBER_T_H_
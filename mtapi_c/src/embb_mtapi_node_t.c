@@ -289,6 +289,17 @@ void mtapi_node_get_attribute(
             &local_node->attributes.max_priorities, attribute, attribute_size);
           break;
 
+        case MTAPI_NODE_MAX_FIBERS:
+          local_status = embb_mtapi_attr_get_mtapi_uint_t(
+            &local_node->attributes.max_fibers, attribute, attribute_size);
+          break;
+
+        case MTAPI_NODE_FIBER_STACK_SIZE:
+          local_status = embb_mtapi_attr_get_mtapi_uint_t(
+            &local_node->attributes.fiber_stack_size, attribute,
+            attribute_size);
+          break;
+
         default:
           local_status = MTAPI_ERR_ATTR_NUM;
           break;
@@ -41,6 +41,7 @@
 #include <embb_mtapi_alloc.h>
 #include <embb_mtapi_queue_t.h>
 #include <embb_mtapi_group_t.h>
+#include <embb_mtapi_fiber_t.h>
 
 
 /* ---- CLASS MEMBERS ------------------------------------------------------ */
@@ -266,6 +267,40 @@ void embb_mtapi_scheduler_finalize_task(
   if (MTAPI_NULL != action) {
     embb_atomic_fetch_and_add_int(&action->num_tasks, -num_instances);
   }
+
+  /* fibers waiting for this task, its group or its action may resume */
+  if (MTAPI_NULL != node->scheduler) {
+    embb_mtapi_scheduler_wake_suspended_fibers(node->scheduler);
+  }
+}
+
+static void embb_mtapi_scheduler_schedule_pending_task(
+  embb_mtapi_node_t * node,
+  embb_mtapi_action_t * action) {
+  embb_mtapi_task_t * pending_task =
+    embb_mtapi_action_get_pending_task(action);
+  while (MTAPI_NULL != pending_task) {
+    mtapi_task_state_t task_state =
+      (mtapi_task_state_t)embb_atomic_load_int(&pending_task->state);
+    if (MTAPI_TASK_SCHEDULED == task_state ||
+      MTAPI_TASK_RUNNING == task_state) {
+      /* the task competes for the free slot again */
+      embb_mtapi_scheduler_schedule_task(node->scheduler, pending_task);
+      return;
+    }
+    /* the task was cancelled while it was held back, it does not take the
+       free slot, so the next pending task has to be fetched */
+    embb_mtapi_scheduler_finalize_task(
+      pending_task, node, MTAPI_TASK_CANCELLED);
+    pending_task = embb_mtapi_action_get_pending_task(action);
+  }
+}
+
+static void embb_mtapi_scheduler_finish_action_task(
+  embb_mtapi_node_t * node,
+  embb_mtapi_action_t * action) {
+  embb_mtapi_action_task_finish(action);
+  embb_mtapi_scheduler_schedule_pending_task(node, action);
 }
 
 mtapi_boolean_t embb_mtapi_scheduler_execute_task(
@@ -275,10 +310,32 @@ mtapi_boolean_t embb_mtapi_scheduler_execute_task(
   embb_mtapi_task_context_t task_context;
   mtapi_boolean_t result = MTAPI_FALSE;
   embb_mtapi_queue_t * local_queue = MTAPI_NULL;
+  embb_mtapi_action_t * local_action = MTAPI_NULL;
   mtapi_task_state_t next_task_state = MTAPI_TASK_INTENTIONALLY_UNUSED;
+  mtapi_task_state_t task_state =
+    (mtapi_task_state_t)embb_atomic_load_int(&task->state);
   embb_mtapi_task_t * ordered_task = MTAPI_NULL;
   mtapi_uint_t ordered_priority = 0;
 
+  /* throttled action and task about to execute it? */
+  if ((MTAPI_TASK_SCHEDULED == task_state ||
+    MTAPI_TASK_RUNNING == task_state) &&
+    embb_mtapi_action_pool_is_handle_valid(
+    node->action_pool, task->action)) {
+    local_action =
+      embb_mtapi_action_pool_get_storage_for_handle(
+        node->action_pool, task->action);
+
+    /* try to get action execution slot */
+    if (!embb_mtapi_action_task_start(local_action)) {
+      /* action is busy, keep task back without occupying this worker */
+      embb_mtapi_task_queue_push_back(&local_action->pending_tasks, task);
+      /* a slot might have been freed before the task was kept back */
+      embb_mtapi_scheduler_schedule_pending_task(node, local_action);
+      return MTAPI_FALSE;
+    }
+  }
+
   /* is task associated with a queue? */
   if (embb_mtapi_queue_pool_is_handle_valid(
     node->queue_pool, task->queue)) {
@@ -292,13 +349,16 @@ mtapi_boolean_t embb_mtapi_scheduler_execute_task(
       if (!embb_mtapi_queue_ordered_task_start(local_queue)) {
         /* some task is already execution, keep task back in the queue */
         embb_mtapi_task_queue_push_back(&local_queue->ordered_tasks, task);
+        if (MTAPI_NULL != local_action) {
+          embb_mtapi_scheduler_finish_action_task(node, local_action);
+        }
         /* return and let other tasks execute first */
         return MTAPI_FALSE;
       }
     }
   }
 
-  switch (embb_atomic_load_int(&task->state)) {
+  switch (task_state) {
   case MTAPI_TASK_SCHEDULED:
     /* multi-instance task, another instance might be running */
   case MTAPI_TASK_RUNNING:
@@ -306,6 +366,9 @@ mtapi_boolean_t embb_mtapi_scheduler_execute_task(
     embb_mtapi_task_context_initialize_with_thread_context_and_task(
       &task_context, thread_context, task);
     if (embb_mtapi_task_execute(task, &task_context, &next_task_state)) {
+      if (MTAPI_NULL != local_action) {
+        embb_mtapi_scheduler_finish_action_task(node, local_action);
+      }
       if (MTAPI_NULL != local_queue) {
         if (local_queue->attributes.ordered) {
           /* fetch task that has been kept back */
@@ -316,6 +379,9 @@ mtapi_boolean_t embb_mtapi_scheduler_execute_task(
       }
       embb_mtapi_scheduler_finalize_task(task, node, next_task_state);
     } else {
+      if (MTAPI_NULL != local_action) {
+        embb_mtapi_scheduler_finish_action_task(node, local_action);
+      }
       embb_mtapi_scheduler_schedule_task(node->scheduler, task);
     }
     if (MTAPI_NULL != ordered_task) {
@@ -349,6 +415,200 @@ mtapi_boolean_t embb_mtapi_scheduler_execute_task(
   return result;
 }
 
+static void embb_mtapi_scheduler_fiber_function(embb_mtapi_fiber_t * fiber) {
+  embb_mtapi_thread_context_t * thread_context = fiber->thread_context;
+
+  embb_mtapi_scheduler_execute_task(
+    fiber->task, thread_context->node, thread_context);
+  /* signal that the fiber may be reused */
+  fiber->task = MTAPI_NULL;
+}
+
+static embb_mtapi_fiber_t * embb_mtapi_scheduler_get_free_fiber(
+  embb_mtapi_thread_context_t * thread_context) {
+  embb_mtapi_fiber_t * fiber = thread_context->free_fibers;
+
+  if (MTAPI_NULL != fiber) {
+    thread_context->free_fibers = fiber->next;
+    fiber->next = MTAPI_NULL;
+  } else if (thread_context->num_fibers < thread_context->max_fibers) {
+    fiber = &thread_context->fibers[thread_context->num_fibers];
+    if (embb_mtapi_fiber_initialize(fiber,
+      thread_context->node->attributes.fiber_stack_size,
+      embb_mtapi_scheduler_fiber_function, thread_context)) {
+      thread_context->num_fibers++;
+    } else {
+      fiber = MTAPI_NULL;
+    }
+  }
+
+  return fiber;
+}
+
+static void embb_mtapi_scheduler_switch_to_fiber(
+  embb_mtapi_thread_context_t * thread_context,
+  embb_mtapi_fiber_t * fiber) {
+  thread_context->current_fiber = fiber;
+  embb_mtapi_fiber_resume(fiber);
+  thread_context->current_fiber = MTAPI_NULL;
+
+  if (MTAPI_NULL == fiber->task) {
+    /* task is done, fiber can be reused */
+    fiber->next = thread_context->free_fibers;
+    thread_context->free_fibers = fiber;
+  } else {
+    /* task is waiting, resume it later */
+    fiber->next = MTAPI_NULL;
+    if (MTAPI_NULL == thread_context->suspended_fibers_back) {
+      thread_context->suspended_fibers_front = fiber;
+    } else {
+      thread_context->suspended_fibers_back->next = fiber;
+    }
+    thread_context->suspended_fibers_back = fiber;
+    embb_atomic_fetch_and_add_int(&thread_context->num_suspended_fibers, 1);
+    embb_atomic_fetch_and_add_int(
+      &thread_context->node->scheduler->suspended_fiber_count, 1);
+  }
+}
+
+static embb_mtapi_fiber_t * embb_mtapi_scheduler_pop_suspended_fiber(
+  embb_mtapi_thread_context_t * thread_context,
+  embb_mtapi_fiber_t * previous,
+  embb_mtapi_fiber_t * fiber) {
+  if (MTAPI_NULL == previous) {
+    thread_context->suspended_fibers_front = fiber->next;
+  } else {
+    previous->next = fiber->next;
+  }
+  if (thread_context->suspended_fibers_back == fiber) {
+    thread_context->suspended_fibers_back = previous;
+  }
+  fiber->next = MTAPI_NULL;
+  embb_atomic_fetch_and_add_int(&thread_context->num_suspended_fibers, -1);
+  embb_atomic_fetch_and_add_int(
+    &thread_context->node->scheduler->suspended_fiber_count, -1);
+  return fiber;
+}
+
+static mtapi_boolean_t embb_mtapi_scheduler_fiber_is_ready(
+  embb_mtapi_fiber_t * fiber,
+  mtapi_boolean_t resume_polling) {
+  mtapi_task_state_t task_state;
+
+  if (MTAPI_NULL == fiber->wait_task) {
+    /* fiber has to check its wait condition itself */
+    return resume_polling;
+  }
+  task_state =
+    (mtapi_task_state_t)embb_atomic_load_int(&fiber->wait_task->state);
+  return ((MTAPI_TASK_SCHEDULED != task_state) &&
+    (MTAPI_TASK_RUNNING != task_state)) ? MTAPI_TRUE : MTAPI_FALSE;
+}
+
+static mtapi_boolean_t embb_mtapi_scheduler_has_ready_fiber(
+  embb_mtapi_thread_context_t * thread_context) {
+  embb_mtapi_fiber_t * fiber = thread_context->suspended_fibers_front;
+
+  while (MTAPI_NULL != fiber) {
+    if (embb_mtapi_scheduler_fiber_is_ready(fiber, MTAPI_FALSE)) {
+      return MTAPI_TRUE;
+    }
+    fiber = fiber->next;
+  }
+
+  return MTAPI_FALSE;
+}
+
+static mtapi_boolean_t embb_mtapi_scheduler_resume_fiber(
+  embb_mtapi_thread_context_t * thread_context,
+  mtapi_boolean_t resume_polling) {
+  embb_mtapi_fiber_t * previous = MTAPI_NULL;
+  embb_mtapi_fiber_t * fiber = thread_context->suspended_fibers_front;
+
+  while (MTAPI_NULL != fiber) {
+    if (embb_mtapi_scheduler_fiber_is_ready(fiber, resume_polling)) {
+      embb_mtapi_scheduler_switch_to_fiber(thread_context,
+        embb_mtapi_scheduler_pop_suspended_fiber(
+          thread_context, previous, fiber));
+      return MTAPI_TRUE;
+    }
+    previous = fiber;
+    fiber = fiber->next;
+  }
+
+  return MTAPI_FALSE;
+}
+
+static void embb_mtapi_scheduler_cancel_suspended_fibers(
+  embb_mtapi_node_t * node,
+  embb_mtapi_thread_context_t * thread_context) {
+  while (MTAPI_NULL != thread_context->suspended_fibers_front) {
+    embb_mtapi_fiber_t * fiber = embb_mtapi_scheduler_pop_suspended_fiber(
+      thread_context, MTAPI_NULL, thread_context->suspended_fibers_front);
+    embb_mtapi_task_t * task = fiber->task;
+
+    /* the fiber is never resumed again, so its task would stay outstanding
+       forever. release what the task holds and complete it as cancelled.
+       the frames on the fiber stack are abandoned without unwinding, so
+       the stack is released right away instead of being recycled. */
+    if (embb_mtapi_action_pool_is_handle_valid(
+      node->action_pool, task->action)) {
+      embb_mtapi_scheduler_finish_action_task(node,
+        embb_mtapi_action_pool_get_storage_for_handle(
+          node->action_pool, task->action));
+    }
+    task->error_code = MTAPI_ERR_ACTION_CANCELLED;
+    embb_mtapi_scheduler_finalize_task(task, node, MTAPI_TASK_CANCELLED);
+
+    fiber->task = MTAPI_NULL;
+    fiber->wait_task = MTAPI_NULL;
+    embb_mtapi_fiber_finalize(fiber);
+  }
+}
+
+static mtapi_boolean_t embb_mtapi_scheduler_execute_task_on_fiber(
+  embb_mtapi_task_t * task,
+  embb_mtapi_node_t * node,
+  embb_mtapi_thread_context_t * thread_context) {
+  embb_mtapi_fiber_t * fiber = MTAPI_NULL;
+
+  if (0 < thread_context->max_fibers) {
+    fiber = embb_mtapi_scheduler_get_free_fiber(thread_context);
+  }
+  if (MTAPI_NULL == fiber) {
+    /* no fibers or all fibers in use, execute on the current stack */
+    return embb_mtapi_scheduler_execute_task(task, node, thread_context);
+  }
+
+  fiber->task = task;
+  embb_mtapi_scheduler_switch_to_fiber(thread_context, fiber);
+  return MTAPI_TRUE;
+}
+
+static mtapi_boolean_t embb_mtapi_scheduler_do_work(
+  embb_mtapi_scheduler_t * that,
+  embb_mtapi_node_t * node,
+  embb_mtapi_thread_context_t * thread_context) {
+  embb_mtapi_task_t * task;
+
+  /* fibers whose awaited task has finished come first */
+  if (embb_mtapi_scheduler_resume_fiber(thread_context, MTAPI_FALSE)) {
+    return MTAPI_TRUE;
+  }
+
+  /* then new work */
+  task = embb_mtapi_scheduler_get_next_task(that, node, thread_context);
+  if (MTAPI_NULL != task) {
+    return embb_mtapi_scheduler_execute_task_on_fiber(
+      task, node, thread_context);
+  }
+
+  /* finally fibers that poll for their wait condition, this is not counted
+     as work so that the worker still goes to sleep eventually */
+  embb_mtapi_scheduler_resume_fiber(thread_context, MTAPI_TRUE);
+  return MTAPI_FALSE;
+}
+
 void embb_mtapi_scheduler_execute_task_or_yield(
   embb_mtapi_scheduler_t * that,
   embb_mtapi_node_t * node,
@@ -357,12 +617,10 @@ void embb_mtapi_scheduler_execute_task_or_yield(
   assert(MTAPI_NULL != node);
 
   if (NULL != thread_context) {
-    embb_mtapi_task_t* new_task = embb_mtapi_scheduler_get_next_task(
-      that, node, thread_context);
-    /* if there was work, execute it */
-    if (MTAPI_NULL != new_task) {
-      embb_mtapi_scheduler_execute_task(new_task, node, thread_context);
-    } else {
+    if (MTAPI_NULL != thread_context->current_fiber) {
+      /* running on a fiber, give control back to the worker */
+      embb_mtapi_fiber_suspend(thread_context->current_fiber);
+    } else if (!embb_mtapi_scheduler_do_work(that, node, thread_context)) {
       embb_thread_yield();
     }
   } else {
@@ -420,31 +678,32 @@ int embb_mtapi_scheduler_worker(void * arg) {
 
   /* do work while not requested to stop */
   while (embb_atomic_load_int(&thread_context->run)) {
-    /* try to get work */
-    embb_mtapi_task_t * task = embb_mtapi_scheduler_get_next_task(
-      node->scheduler, node, thread_context);
-    /* check if there was work */
-    if (MTAPI_NULL != task) {
-      if (embb_mtapi_scheduler_execute_task(task, node, thread_context)) {
-        counter = 0;
-      }
+    /* try to get work and check if there was work */
+    if (embb_mtapi_scheduler_do_work(
+      node->scheduler, node, thread_context)) {
+      counter = 0;
     } else if (counter < 1024) {
       /* spin and yield for a while before going to sleep */
       embb_thread_yield();
       counter++;
     } else {
-      /* no work, go to sleep */
-      embb_atomic_store_int(&thread_context->is_sleeping, 1);
+      /* no work, go to sleep. suspended fibers are checked after announcing
+         the sleep, a task finishing afterwards wakes the worker up */
       embb_mutex_lock(&thread_context->work_available_mutex);
-      embb_condition_wait_for(
-        &thread_context->work_available,
-        &thread_context->work_available_mutex,
-        &sleep_duration);
-      embb_mutex_unlock(&thread_context->work_available_mutex);
+      embb_atomic_store_int(&thread_context->is_sleeping, 1);
+      if (!embb_mtapi_scheduler_has_ready_fiber(thread_context)) {
+        embb_condition_wait_for(
+          &thread_context->work_available,
+          &thread_context->work_available_mutex,
+          &sleep_duration);
+      }
       embb_atomic_store_int(&thread_context->is_sleeping, 0);
+      embb_mutex_unlock(&thread_context->work_available_mutex);
     }
   }
 
+  embb_mtapi_scheduler_cancel_suspended_fibers(node, thread_context);
+
   embb_tss_delete(&(thread_context->tss_id));
 
   return MTAPI_TRUE;
@@ -493,12 +752,22 @@ mtapi_boolean_t embb_mtapi_scheduler_wait_for_task(
       }
     }
 
+    /* a suspended fiber only needs to be resumed once the task is done */
+    if ((NULL != context) && (MTAPI_NULL != context->current_fiber) &&
+      (MTAPI_INFINITE == timeout)) {
+      context->current_fiber->wait_task = task;
+    }
+
     /* do other work if applicable */
     embb_mtapi_scheduler_execute_task_or_yield(
       node->scheduler,
       node,
       context);
 
+    if ((NULL != context) && (MTAPI_NULL != context->current_fiber)) {
+      context->current_fiber->wait_task = MTAPI_NULL;
+    }
+
     task_state = (mtapi_task_state_t)embb_atomic_load_int(&task->state);
   }
 
@@ -522,6 +791,7 @@ mtapi_boolean_t embb_mtapi_scheduler_initialize_with_mode(
   assert(MTAPI_NULL != node);
 
   embb_atomic_init_int(&that->affine_task_counter, 0);
+  embb_atomic_init_int(&that->suspended_fiber_count, 0);
 
   /* Paranoia sanitizing of scheduler mode */
   if (mode >= NUM_SCHEDULER_MODES) {
@@ -604,6 +874,7 @@ void embb_mtapi_scheduler_finalize(embb_mtapi_scheduler_t * that) {
     that->worker_contexts = MTAPI_NULL;
   }
 
+  embb_atomic_destroy_int(&that->suspended_fiber_count);
   embb_atomic_destroy_int(&that->affine_task_counter);
 }
 
@@ -613,8 +884,7 @@ embb_mtapi_scheduler_t * embb_mtapi_scheduler_new() {
       sizeof(embb_mtapi_scheduler_t));
   if (MTAPI_NULL != that) {
     if (MTAPI_FALSE == embb_mtapi_scheduler_initialize(that)) {
-      /* on error delete and return MTAPI_NULL */
-      embb_mtapi_scheduler_finalize(that);
+      /* on error delete and return MTAPI_NULL, delete also finalizes */
       embb_mtapi_scheduler_delete(that);
       return MTAPI_NULL;
     }
@@ -719,6 +989,27 @@ mtapi_boolean_t embb_mtapi_scheduler_schedule_task(
   return pushed;
 }
 
+void embb_mtapi_scheduler_wake_suspended_fibers(
+  embb_mtapi_scheduler_t * that) {
+  mtapi_uint_t ii;
+
+  assert(MTAPI_NULL != that);
+
+  if (0 < embb_atomic_load_int(&that->suspended_fiber_count)) {
+    for (ii = 0; ii < that->worker_count; ii++) {
+      embb_mtapi_thread_context_t * context = &that->worker_contexts[ii];
+      if ((0 < embb_atomic_load_int(&context->num_suspended_fibers)) &&
+        embb_atomic_load_int(&context->is_sleeping)) {
+        /* taking the mutex ensures the worker is either waiting already or
+           has not yet checked its fibers */
+        embb_mutex_lock(&context->work_available_mutex);
+        embb_condition_notify_one(&context->work_available);
+        embb_mutex_unlock(&context->work_available_mutex);
+      }
+    }
+  }
+}
+
 void mtapi_ext_yield() {
   embb_mtapi_node_t* node = embb_mtapi_node_get_instance();
   embb_mtapi_thread_context_t * context =
@@ -86,6 +86,7 @@ struct embb_mtapi_scheduler_struct {
   embb_mtapi_scheduler_mode_t mode;
 
   embb_atomic_int affine_task_counter;
+  embb_atomic_int suspended_fiber_count;
 };
 
 #include <embb_mtapi_scheduler_t_fwd.h>
@@ -114,6 +115,14 @@ mtapi_boolean_t embb_mtapi_scheduler_wait_for_task(
   embb_mtapi_task_t * task,
   mtapi_timeout_t timeout);
 
+/**
+ * Wake sleeping workers owning suspended fibers, called whenever a task has
+ * finished so the fibers can check their wait condition.
+ * \memberof embb_mtapi_scheduler_struct
+ */
+void embb_mtapi_scheduler_wake_suspended_fibers(
+  embb_mtapi_scheduler_t * that);
+
 /**
  * Get a task from any of the available queues.
  * \memberof embb_mtapi_scheduler_struct
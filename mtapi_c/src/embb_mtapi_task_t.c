@@ -529,6 +529,8 @@ void mtapi_task_cancel(
         embb_mtapi_task_set_state(local_task, MTAPI_TASK_CANCELLED);
         local_status = MTAPI_SUCCESS;
       }
+      /* fibers waiting for the task may resume */
+      embb_mtapi_scheduler_wake_suspended_fibers(node->scheduler);
     } else {
       local_status = MTAPI_ERR_TASK_INVALID;
     }
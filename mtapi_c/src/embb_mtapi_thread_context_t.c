@@ -34,6 +34,7 @@
 #include <embb_mtapi_scheduler_t.h>
 #include <embb_mtapi_node_t.h>
 #include <embb_mtapi_thread_context_t.h>
+#include <embb_mtapi_fiber_t.h>
 
 
 /* ---- CLASS MEMBERS ------------------------------------------------------ */
@@ -61,11 +62,36 @@ mtapi_boolean_t embb_mtapi_thread_context_initialize(
 
   embb_atomic_init_int(&that->run, 0);
   embb_atomic_init_int(&that->is_sleeping, 0);
+  embb_atomic_init_int(&that->num_suspended_fibers, 0);
+
+  /* fiber stacks are allocated on first use by the scheduler, the main
+     thread does not return to a worker loop and thus cannot resume
+     suspended fibers */
+  that->max_fibers = that->is_main_thread ? 0 : node->attributes.max_fibers;
+  that->num_fibers = 0;
+  that->free_fibers = MTAPI_NULL;
+  that->suspended_fibers_front = MTAPI_NULL;
+  that->suspended_fibers_back = MTAPI_NULL;
+  that->current_fiber = MTAPI_NULL;
+  that->fibers = MTAPI_NULL;
+  that->queue = MTAPI_NULL;
+  that->private_queue = MTAPI_NULL;
+
+  /* on failure everything created so far is released right away, the
+     context is then left finalized */
+  if (0 < that->max_fibers) {
+    that->fibers = (embb_mtapi_fiber_t*)embb_mtapi_alloc_allocate(
+      sizeof(embb_mtapi_fiber_t)*that->max_fibers);
+    if (that->fibers == NULL) {
+      embb_mtapi_thread_context_finalize(that);
+      return MTAPI_FALSE;
+    }
+  }
 
   that->queue = (embb_mtapi_task_queue_t**)embb_mtapi_alloc_allocate(
     sizeof(embb_mtapi_task_queue_t*)*that->priorities);
   if (that->queue == NULL) {
-    that->private_queue = NULL;
+    embb_mtapi_thread_context_finalize(that);
     return MTAPI_FALSE;
   }
   for (ii = 0; ii < that->priorities; ii++) {
@@ -78,12 +104,14 @@ mtapi_boolean_t embb_mtapi_thread_context_initialize(
     }
   }
   if (!result) {
+    embb_mtapi_thread_context_finalize(that);
     return MTAPI_FALSE;
   }
 
   that->private_queue = (embb_mtapi_task_queue_t**)embb_mtapi_alloc_allocate(
     sizeof(embb_mtapi_task_queue_t*)*that->priorities);
   if (that->private_queue == NULL) {
+    embb_mtapi_thread_context_finalize(that);
     return MTAPI_FALSE;
   }
   for (ii = 0; ii < that->priorities; ii++) {
@@ -96,6 +124,7 @@ mtapi_boolean_t embb_mtapi_thread_context_initialize(
     }
   }
   if (!result) {
+    embb_mtapi_thread_context_finalize(that);
     return MTAPI_FALSE;
   }
 
@@ -159,6 +188,10 @@ mtapi_boolean_t embb_mtapi_thread_context_start(
 
 void embb_mtapi_thread_context_stop(embb_mtapi_thread_context_t* that) {
   int result;
+  if (MTAPI_NULL == that->node) {
+    /* already finalized */
+    return;
+  }
   if (0 < embb_atomic_load_int(&that->run)) {
     embb_atomic_store_int(&that->run, 0);
     embb_condition_notify_one(&that->work_available);
@@ -175,6 +208,11 @@ void embb_mtapi_thread_context_finalize(embb_mtapi_thread_context_t* that) {
 
   embb_mtapi_log_trace("embb_mtapi_thread_context_finalize() called\n");
 
+  if (MTAPI_NULL == that->node) {
+    /* already finalized, e.g. by a failed initialize */
+    return;
+  }
+
   if (that->is_initialized) {
     if (that->is_main_thread) {
       embb_tss_delete(&that->tss_id);
@@ -207,6 +245,16 @@ void embb_mtapi_thread_context_finalize(embb_mtapi_thread_context_t* that) {
     that->private_queue = MTAPI_NULL;
   }
 
+  if (that->fibers != NULL) {
+    for (ii = 0; ii < that->num_fibers; ii++) {
+      embb_mtapi_fiber_finalize(&that->fibers[ii]);
+    }
+    embb_mtapi_alloc_deallocate(that->fibers);
+    that->fibers = MTAPI_NULL;
+    that->num_fibers = 0;
+  }
+
+  embb_atomic_destroy_int(&that->num_suspended_fibers);
   embb_atomic_destroy_int(&that->is_sleeping);
   embb_atomic_destroy_int(&that->run);
 
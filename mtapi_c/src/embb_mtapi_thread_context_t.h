@@ -42,6 +42,7 @@ extern "C" {
 #include <embb_mtapi_task_queue_t_fwd.h>
 #include <embb_mtapi_node_t_fwd.h>
 #include <embb_mtapi_scheduler_t_fwd.h>
+#include <embb_mtapi_fiber_t_fwd.h>
 
 /* ---- CLASS DECLARATION -------------------------------------------------- */
 
@@ -71,6 +72,17 @@ struct embb_mtapi_thread_context_struct {
   mtapi_boolean_t is_main_thread;
 
   embb_thread_priority_t thread_priority;
+
+  /* fibers are only ever touched by the thread owning the context */
+  embb_mtapi_fiber_t * fibers;
+  mtapi_uint_t max_fibers;
+  mtapi_uint_t num_fibers;
+  embb_mtapi_fiber_t * free_fibers;
+  embb_mtapi_fiber_t * suspended_fibers_front;
+  embb_mtapi_fiber_t * suspended_fibers_back;
+  embb_mtapi_fiber_t * current_fiber;
+  /* read by other threads to decide whether to wake the worker */
+  embb_atomic_int num_suspended_fibers;
 };
 
 #include <embb_mtapi_thread_context_t_fwd.h>
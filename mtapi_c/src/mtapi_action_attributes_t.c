@@ -45,6 +45,7 @@ void mtapi_actionattr_init(
   if (MTAPI_NULL != attributes) {
     attributes->domain_shared = MTAPI_TRUE;
     attributes->global = MTAPI_TRUE;
+    attributes->max_concurrency = 0;
     mtapi_affinity_init(&attributes->affinity, MTAPI_TRUE, &local_status);
   } else {
     local_status = MTAPI_ERR_PARAMETER;
@@ -84,6 +85,11 @@ void mtapi_actionattr_set(
           &attributes->domain_shared, attribute, attribute_size);
         break;
 
+      case MTAPI_ACTION_MAX_CONCURRENCY:
+        local_status = embb_mtapi_attr_set_mtapi_uint_t(
+          &attributes->max_concurrency, attribute, attribute_size);
+        break;
+
       default:
         /* attribute unknown */
         local_status = MTAPI_ERR_ATTR_NUM;
@@ -54,6 +54,8 @@ void mtapi_nodeattr_init(
     attributes->max_priorities = MTAPI_NODE_MAX_PRIORITIES_DEFAULT;
     attributes->reuse_main_thread = MTAPI_TRUE;
     attributes->worker_priorities = NULL;
+    attributes->max_fibers = MTAPI_NODE_MAX_FIBERS_DEFAULT;
+    attributes->fiber_stack_size = MTAPI_NODE_FIBER_STACK_SIZE_DEFAULT;
 
     embb_core_set_init(&attributes->core_affinity, 1);
     attributes->num_cores = embb_core_set_count(&attributes->core_affinity);
@@ -156,6 +158,16 @@ void mtapi_nodeattr_set(
           (mtapi_worker_priority_entry_t*)attribute;
         break;
 
+      case MTAPI_NODE_MAX_FIBERS:
+        local_status = embb_mtapi_attr_set_mtapi_uint_t(
+          &attributes->max_fibers, attribute, attribute_size);
+        break;
+
+      case MTAPI_NODE_FIBER_STACK_SIZE:
+        local_status = embb_mtapi_attr_set_mtapi_uint_t(
+          &attributes->fiber_stack_size, attribute, attribute_size);
+        break;
+
       default:
         /* attribute unknown */
         local_status = MTAPI_ERR_ATTR_NUM;
@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <embb_mtapi_test_config.h>
+#include <embb_mtapi_test_fiber.h>
+
+#include <embb/base/c/memory_allocation.h>
+#include <embb/base/c/atomic.h>
+
+#define JOB_TEST_FIBER 47
+#define FIBER_TEST_MAX_FIBERS 128u
+#define FIBER_TEST_STACK_SIZE (64u * 1024u)
+
+static void testFiberFibonacciAction(
+  const void* args,
+  mtapi_size_t /*arg_size*/,
+  void* result_buffer,
+  mtapi_size_t /*result_buffer_size*/,
+  const void* /*node_local_data*/,
+  mtapi_size_t /*node_local_data_size*/,
+  mtapi_task_context_t* /*task_context*/) {
+  mtapi_status_t status;
+  int n = *reinterpret_cast<const int*>(args);
+  int* result = reinterpret_cast<int*>(result_buffer);
+
+  if (n < 2) {
+    *result = n;
+    return;
+  }
+
+  mtapi_job_hndl_t job = mtapi_job_get(JOB_TEST_FIBER, THIS_DOMAIN_ID, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  /* both subtasks are waited for, on a fiber this suspends the task instead
+     of executing other tasks recursively on the worker's stack */
+  int a = n - 1;
+  int b = n - 2;
+  int x = 0;
+  int y = 0;
+  mtapi_task_hndl_t task_a = mtapi_task_start(MTAPI_TASK_ID_NONE, job,
+    &a, sizeof(a), &x, sizeof(x),
+    MTAPI_DEFAULT_TASK_ATTRIBUTES, MTAPI_GROUP_NONE, &status);
+  MTAPI_CHECK_STATUS(status);
+  mtapi_task_hndl_t task_b = mtapi_task_start(MTAPI_TASK_ID_NONE, job,
+    &b, sizeof(b), &y, sizeof(y),
+    MTAPI_DEFAULT_TASK_ATTRIBUTES, MTAPI_GROUP_NONE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  mtapi_task_wait(task_a, MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+  mtapi_task_wait(task_b, MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  *result = x + y;
+}
+
+static mtapi_task_hndl_t testFiberSelfTask;
+static embb_atomic_int testFiberSelfTaskReady;
+static embb_atomic_int testFiberSelfTaskCompleted;
+
+static void testFiberSelfWaitAction(
+  const void* /*args*/,
+  mtapi_size_t /*arg_size*/,
+  void* /*result_buffer*/,
+  mtapi_size_t /*result_buffer_size*/,
+  const void* /*node_local_data*/,
+  mtapi_size_t /*node_local_data_size*/,
+  mtapi_task_context_t* /*task_context*/) {
+  mtapi_status_t status;
+
+  while (0 == embb_atomic_load_int(&testFiberSelfTaskReady)) {
+    mtapi_ext_yield();
+  }
+  /* the task waits for itself, so its fiber is never resumed */
+  mtapi_task_wait(testFiberSelfTask, MTAPI_INFINITE, &status);
+}
+
+static void testFiberSelfWaitComplete(
+  mtapi_task_hndl_t /*task*/,
+  mtapi_status_t* /*status*/) {
+  embb_atomic_fetch_and_add_int(&testFiberSelfTaskCompleted, 1);
+}
+
+static void testFiberInitialize() {
+  mtapi_node_attributes_t node_attr;
+  mtapi_info_t info;
+  mtapi_status_t status;
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_nodeattr_init(&node_attr, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_nodeattr_set(
+    &node_attr,
+    MTAPI_NODE_MAX_TASKS,
+    MTAPI_ATTRIBUTE_VALUE(2048u),
+    MTAPI_ATTRIBUTE_POINTER_AS_VALUE,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  /* the main thread does not run tasks on fibers, and waiting on it would
+     block the self waiting task of the shutdown test on its stack */
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_nodeattr_set(
+    &node_attr,
+    MTAPI_NODE_REUSE_MAIN_THREAD,
+    MTAPI_ATTRIBUTE_VALUE(MTAPI_FALSE),
+    MTAPI_ATTRIBUTE_POINTER_AS_VALUE,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_nodeattr_set(
+    &node_attr,
+    MTAPI_NODE_MAX_FIBERS,
+    MTAPI_ATTRIBUTE_VALUE(FIBER_TEST_MAX_FIBERS),
+    MTAPI_ATTRIBUTE_POINTER_AS_VALUE,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_nodeattr_set(
+    &node_attr,
+    MTAPI_NODE_FIBER_STACK_SIZE,
+    MTAPI_ATTRIBUTE_VALUE(FIBER_TEST_STACK_SIZE),
+    MTAPI_ATTRIBUTE_POINTER_AS_VALUE,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_initialize(
+    THIS_DOMAIN_ID,
+    THIS_NODE_ID,
+    &node_attr,
+    &info,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+}
+
+FiberTest::FiberTest() {
+  CreateUnit("mtapi fiber test").Add(&FiberTest::TestRecursive, this);
+  CreateUnit("mtapi fiber shutdown test").Add(&FiberTest::TestShutdown, this);
+}
+
+void FiberTest::TestRecursive() {
+  mtapi_status_t status;
+  mtapi_uint_t max_fibers = 0;
+
+  embb_mtapi_log_info("running testFiber...\n");
+
+  testFiberInitialize();
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_node_get_attribute(THIS_NODE_ID, MTAPI_NODE_MAX_FIBERS,
+    &max_fibers, MTAPI_NODE_MAX_FIBERS_SIZE, &status);
+  MTAPI_CHECK_STATUS(status);
+  PT_EXPECT_EQ(max_fibers, FIBER_TEST_MAX_FIBERS);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_action_hndl_t action = mtapi_action_create(
+    JOB_TEST_FIBER,
+    testFiberFibonacciAction,
+    MTAPI_NULL,
+    0,
+    MTAPI_DEFAULT_ACTION_ATTRIBUTES,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_job_hndl_t job = mtapi_job_get(JOB_TEST_FIBER, THIS_DOMAIN_ID, &status);
+  MTAPI_CHECK_STATUS(status);
+
+#ifdef EMBB_THREADING_ANALYSIS_MODE
+  const int iterations(1);
+#else
+  const int iterations(10);
+#endif
+  for (int ii = 0; ii < iterations; ii++) {
+    int n = 13;
+    int result = 0;
+
+    status = MTAPI_ERR_UNKNOWN;
+    mtapi_task_hndl_t task = mtapi_task_start(MTAPI_TASK_ID_NONE, job,
+      &n, sizeof(n), &result, sizeof(result),
+      MTAPI_DEFAULT_TASK_ATTRIBUTES, MTAPI_GROUP_NONE, &status);
+    MTAPI_CHECK_STATUS(status);
+
+    status = MTAPI_ERR_UNKNOWN;
+    mtapi_task_wait(task, MTAPI_INFINITE, &status);
+    MTAPI_CHECK_STATUS(status);
+
+    PT_EXPECT_EQ(result, 233);
+  }
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_action_delete(action, MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_finalize(&status);
+  MTAPI_CHECK_STATUS(status);
+
+  PT_EXPECT_EQ(embb_get_bytes_allocated(), 0u);
+
+  embb_mtapi_log_info("...done\n\n");
+}
+
+void FiberTest::TestShutdown() {
+  mtapi_status_t status;
+
+  embb_mtapi_log_info("running testFiberShutdown...\n");
+
+  embb_atomic_init_int(&testFiberSelfTaskReady, 0);
+  embb_atomic_init_int(&testFiberSelfTaskCompleted, 0);
+
+  testFiberInitialize();
+
+  /* the action is deleted by mtapi_finalize, it cannot be deleted before
+     because its task never finishes */
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_action_create(
+    JOB_TEST_FIBER,
+    testFiberSelfWaitAction,
+    MTAPI_NULL,
+    0,
+    MTAPI_DEFAULT_ACTION_ATTRIBUTES,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_job_hndl_t job = mtapi_job_get(JOB_TEST_FIBER, THIS_DOMAIN_ID, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  mtapi_task_attributes_t task_attr;
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_taskattr_init(&task_attr, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_taskattr_set(&task_attr, MTAPI_TASK_COMPLETE_FUNCTION,
+    reinterpret_cast<void*>(testFiberSelfWaitComplete),
+    MTAPI_ATTRIBUTE_POINTER_AS_VALUE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  testFiberSelfTask = mtapi_task_start(MTAPI_TASK_ID_NONE, job,
+    MTAPI_NULL, 0, MTAPI_NULL, 0, &task_attr, MTAPI_GROUP_NONE, &status);
+  MTAPI_CHECK_STATUS(status);
+  embb_atomic_store_int(&testFiberSelfTaskReady, 1);
+
+  /* the task is suspended on its fiber and never finishes by itself */
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_task_wait(testFiberSelfTask, 100, &status);
+  PT_EXPECT_EQ(status, MTAPI_TIMEOUT);
+  PT_EXPECT_EQ(embb_atomic_load_int(&testFiberSelfTaskCompleted), 0);
+
+  /* shutting down cancels the task before the fiber stack is freed */
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_finalize(&status);
+  MTAPI_CHECK_STATUS(status);
+  PT_EXPECT_EQ(embb_atomic_load_int(&testFiberSelfTaskCompleted), 1);
+
+  PT_EXPECT_EQ(embb_get_bytes_allocated(), 0u);
+
+  embb_atomic_destroy_int(&testFiberSelfTaskCompleted);
+  embb_atomic_destroy_int(&testFiberSelfTaskReady);
+
+  embb_mtapi_log_info("...done\n\n");
+}
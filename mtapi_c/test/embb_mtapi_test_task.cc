@@ -30,11 +30,15 @@
 #include <embb_mtapi_test_task.h>
 
 #include <embb/base/c/memory_allocation.h>
+#include <embb/base/c/atomic.h>
+#include <embb/base/c/thread.h>
 #include <embb/base/c/internal/unused.h>
 
 #define JOB_TEST_TASK 42
 #define JOB_TEST_MULTIINSTANCE_TASK 43
 #define JOB_TEST_DETACHED_TASK 44
+#define JOB_TEST_THROTTLED_TASK 45
+#define JOB_TEST_PENDING_TASK 46
 #define TASK_TEST_ID 23
 
 static void testTaskAction(
@@ -101,12 +105,58 @@ void testMultiInstanceTaskAction(
   result[this_instance] = this_instance;
 }
 
+static embb_atomic_int throttled_running;
+static embb_atomic_int throttled_max_running;
+
+static void testThrottledTaskAction(
+  const void* /*args*/,
+  mtapi_size_t /*arg_size*/,
+  void* /*result_buffer*/,
+  mtapi_size_t /*result_buffer_size*/,
+  const void* /*node_local_data*/,
+  mtapi_size_t /*node_local_data_size*/,
+  mtapi_task_context_t* /*task_context*/) {
+  int running = embb_atomic_fetch_and_add_int(&throttled_running, 1) + 1;
+  int max_running = embb_atomic_load_int(&throttled_max_running);
+  while (running > max_running) {
+    if (embb_atomic_compare_and_swap_int(
+      &throttled_max_running, &max_running, running)) {
+      break;
+    }
+  }
+  /* give other tasks the chance to run concurrently */
+  embb_thread_yield();
+  embb_atomic_fetch_and_add_int(&throttled_running, -1);
+}
+
+static embb_atomic_int pending_blocker_running;
+static embb_atomic_int pending_blocker_release;
+
+static void testPendingTaskAction(
+  const void* args,
+  mtapi_size_t /*arg_size*/,
+  void* /*result_buffer*/,
+  mtapi_size_t /*result_buffer_size*/,
+  const void* /*node_local_data*/,
+  mtapi_size_t /*node_local_data_size*/,
+  mtapi_task_context_t* /*task_context*/) {
+  if (MTAPI_NULL != args) {
+    /* occupy the only slot of the action until released, tasks fetched in
+       the meantime are held back */
+    embb_atomic_store_int(&pending_blocker_running, 1);
+    while (0 == embb_atomic_load_int(&pending_blocker_release)) {
+      mtapi_ext_yield();
+    }
+  }
+}
 
 static void testDoSomethingElse() {
 }
 
 TaskTest::TaskTest() {
   CreateUnit("mtapi task test").Add(&TaskTest::TestBasic, this);
+  CreateUnit("mtapi task throttled pending test")
+    .Add(&TaskTest::TestThrottledPending, this);
 }
 
 void TaskTest::TrySimple() {
@@ -317,6 +367,86 @@ void TaskTest::TryMultiInstance() {
   MTAPI_CHECK_STATUS(status);
 }
 
+void TaskTest::TryThrottled() {
+  mtapi_status_t status;
+  mtapi_action_attributes_t action_attr;
+  const mtapi_uint_t kMaxConcurrency = 2;
+  const int kTasks = 4;
+  const mtapi_uint_t kTaskInstances = 3;
+  mtapi_task_hndl_t task[kTasks];
+  mtapi_uint_t max_concurrency = 0;
+
+  embb_atomic_init_int(&throttled_running, 0);
+  embb_atomic_init_int(&throttled_max_running, 0);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_actionattr_init(&action_attr, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_actionattr_set(&action_attr, MTAPI_ACTION_MAX_CONCURRENCY,
+    &kMaxConcurrency, MTAPI_ACTION_MAX_CONCURRENCY_SIZE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_action_hndl_t throttled_action = mtapi_action_create(
+    JOB_TEST_THROTTLED_TASK,
+    testThrottledTaskAction,
+    MTAPI_NULL,
+    0,
+    &action_attr,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_action_get_attribute(throttled_action, MTAPI_ACTION_MAX_CONCURRENCY,
+    &max_concurrency, MTAPI_ACTION_MAX_CONCURRENCY_SIZE, &status);
+  MTAPI_CHECK_STATUS(status);
+  PT_EXPECT_EQ(max_concurrency, kMaxConcurrency);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_job_hndl_t throttled_job = mtapi_job_get(
+    JOB_TEST_THROTTLED_TASK, THIS_DOMAIN_ID, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  /* multiple instances are throttled individually */
+  mtapi_task_attributes_t task_attr;
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_taskattr_init(&task_attr, &status);
+  MTAPI_CHECK_STATUS(status);
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_taskattr_set(&task_attr, MTAPI_TASK_INSTANCES,
+    &kTaskInstances, sizeof(mtapi_uint_t), &status);
+  MTAPI_CHECK_STATUS(status);
+
+  for (int ii = 0; ii < kTasks; ii++) {
+    status = MTAPI_ERR_UNKNOWN;
+    task[ii] = mtapi_task_start(MTAPI_TASK_ID_NONE, throttled_job,
+      MTAPI_NULL, 0, MTAPI_NULL, 0,
+      (0 == ii) ? &task_attr : MTAPI_DEFAULT_TASK_ATTRIBUTES,
+      MTAPI_GROUP_NONE,
+      &status);
+    MTAPI_CHECK_STATUS(status);
+  }
+
+  for (int ii = 0; ii < kTasks; ii++) {
+    status = MTAPI_ERR_UNKNOWN;
+    mtapi_task_wait(task[ii], MTAPI_INFINITE, &status);
+    MTAPI_CHECK_STATUS(status);
+  }
+
+  PT_EXPECT_LE(embb_atomic_load_int(&throttled_max_running),
+    static_cast<int>(kMaxConcurrency));
+  PT_EXPECT_EQ(embb_atomic_load_int(&throttled_running), 0);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_action_delete(throttled_action, MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  embb_atomic_destroy_int(&throttled_max_running);
+  embb_atomic_destroy_int(&throttled_running);
+}
+
 void TaskTest::TestBasic() {
   mtapi_node_attributes_t node_attr;
   mtapi_info_t info;
@@ -369,7 +499,147 @@ void TaskTest::TestBasic() {
     TryDetached();
     TrySimple();
     TryMultiInstance();
+    TryThrottled();
+  }
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_finalize(&status);
+  MTAPI_CHECK_STATUS(status);
+
+  PT_EXPECT_EQ(embb_get_bytes_allocated(), 0u);
+
+  embb_mtapi_log_info("...done\n\n");
+}
+
+void TaskTest::TestThrottledPending() {
+  mtapi_node_attributes_t node_attr;
+  mtapi_action_attributes_t action_attr;
+  mtapi_status_t status;
+  const mtapi_uint_t kMaxConcurrency = 1;
+  const int kBlocking = 1;
+  const int kTasks = 3;
+  mtapi_task_hndl_t task[kTasks];
+
+  embb_mtapi_log_info("running testThrottledPending...\n");
+
+  /* the blocking task must run on a worker thread, not in a wait of the
+     main thread */
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_nodeattr_init(&node_attr, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_nodeattr_set(&node_attr, MTAPI_NODE_REUSE_MAIN_THREAD,
+    MTAPI_ATTRIBUTE_VALUE(MTAPI_FALSE), MTAPI_ATTRIBUTE_POINTER_AS_VALUE,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_initialize(THIS_DOMAIN_ID, THIS_NODE_ID, &node_attr, MTAPI_NULL,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_actionattr_init(&action_attr, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_actionattr_set(&action_attr, MTAPI_ACTION_MAX_CONCURRENCY,
+    &kMaxConcurrency, MTAPI_ACTION_MAX_CONCURRENCY_SIZE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_action_hndl_t action = mtapi_action_create(
+    JOB_TEST_PENDING_TASK, testPendingTaskAction, MTAPI_NULL, 0,
+    &action_attr, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_job_hndl_t job = mtapi_job_get(
+    JOB_TEST_PENDING_TASK, THIS_DOMAIN_ID, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  /* a task cancelled while held back must not keep the next one from
+     running */
+  embb_atomic_init_int(&pending_blocker_running, 0);
+  embb_atomic_init_int(&pending_blocker_release, 0);
+
+  for (int ii = 0; ii < kTasks; ii++) {
+    status = MTAPI_ERR_UNKNOWN;
+    task[ii] = mtapi_task_start(MTAPI_TASK_ID_NONE, job,
+      (0 == ii) ? &kBlocking : MTAPI_NULL, 0, MTAPI_NULL, 0,
+      MTAPI_DEFAULT_TASK_ATTRIBUTES, MTAPI_GROUP_NONE, &status);
+    MTAPI_CHECK_STATUS(status);
   }
+  while (0 == embb_atomic_load_int(&pending_blocker_running)) {
+    embb_thread_yield();
+  }
+
+  /* the remaining tasks are fetched and held back while the first one runs */
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_task_wait(task[1], 50, &status);
+  PT_EXPECT_EQ(status, MTAPI_TIMEOUT);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_task_cancel(task[1], &status);
+  MTAPI_CHECK_STATUS(status);
+
+  embb_atomic_store_int(&pending_blocker_release, 1);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_task_wait(task[0], MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_task_wait(task[1], 10000, &status);
+  PT_EXPECT_EQ(status, MTAPI_ERR_ACTION_CANCELLED);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_task_wait(task[2], 10000, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  /* deleting the action finalizes held back tasks, only the running one is
+     waited for */
+  embb_atomic_store_int(&pending_blocker_running, 0);
+  embb_atomic_store_int(&pending_blocker_release, 0);
+
+  for (int ii = 0; ii < kTasks; ii++) {
+    status = MTAPI_ERR_UNKNOWN;
+    task[ii] = mtapi_task_start(MTAPI_TASK_ID_NONE, job,
+      (0 == ii) ? &kBlocking : MTAPI_NULL, 0, MTAPI_NULL, 0,
+      MTAPI_DEFAULT_TASK_ATTRIBUTES, MTAPI_GROUP_NONE, &status);
+    MTAPI_CHECK_STATUS(status);
+  }
+  while (0 == embb_atomic_load_int(&pending_blocker_running)) {
+    embb_thread_yield();
+  }
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_task_wait(task[1], 50, &status);
+  PT_EXPECT_EQ(status, MTAPI_TIMEOUT);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_action_delete(action, 50, &status);
+  PT_EXPECT_EQ(status, MTAPI_TIMEOUT);
+
+  for (int ii = 1; ii < kTasks; ii++) {
+    status = MTAPI_ERR_UNKNOWN;
+    mtapi_task_wait(task[ii], 10000, &status);
+    PT_EXPECT_EQ(status, MTAPI_ERR_ACTION_DELETED);
+  }
+
+  embb_atomic_store_int(&pending_blocker_release, 1);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_action_delete(action, MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  mtapi_task_wait(task[0], MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  embb_atomic_destroy_int(&pending_blocker_release);
+  embb_atomic_destroy_int(&pending_blocker_running);
 
   status = MTAPI_ERR_UNKNOWN;
   mtapi_finalize(&status);
@@ -35,10 +35,12 @@ class TaskTest : public partest::TestCase {
 
  private:
   void TestBasic();
+  void TestThrottledPending();
 
   void TrySimple();
   void TryDetached();
   void TryMultiInstance();
+  void TryThrottled();
 };
 
 #endif // MTAPI_C_TEST_EMBB_MTAPI_TEST_TASK_H_
@@ -38,6 +38,7 @@
 #include <embb_mtapi_test_queue.h>
 #include <embb_mtapi_test_error.h>
 #include <embb_mtapi_test_id_pool.h>
+#include <embb_mtapi_test_fiber.h>
 
 #include <embb/base/c/memory_allocation.h>
 #include <embb/base/c/atomic.h>
@@ -53,6 +54,7 @@ PT_MAIN("MTAPI C") {
   PT_RUN(GroupTest);
   PT_RUN(QueueTest);
   PT_RUN(IdPoolTest);
+  PT_RUN(FiberTest);
 
   PT_EXPECT(embb_get_bytes_allocated() == 0);
 }
@@ -0,0 +1,366 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Measures worker-local accumulation against shared atomic counters.
+//
+// Each run sorts the given number of elements into a histogram. The elements
+// are split evenly among the given number of MTAPI tasks. In the "atomic"
+// runs, all tasks increment a shared array of atomic counters. In the
+// "worker_local" runs, each task increments the histogram of its worker in a
+// WorkerLocal and the histograms are combined after all tasks are done. The
+// combination is part of the measured time. Fewer buckets mean more
+// contention on the atomic counters. Every run is repeated and the fastest
+// repetition is reported.
+//
+// Reports one line of CSV or one JSON object per run.
+
+#include <embb/base/atomic.h>
+#include <embb/base/function.h>
+#include <embb/mtapi/mtapi.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#define BENCHMARK_DOMAIN 1
+#define BENCHMARK_NODE 1
+
+typedef std::vector<size_t> Histogram;
+
+struct BenchmarkOptions {
+  std::vector<int> buckets;
+  int elements;
+  int tasks;
+  int repetitions;
+  bool json;
+};
+
+struct BenchmarkResult {
+  char const * run;
+  int buckets;
+  int elements;
+  int tasks;
+  double seconds;
+};
+
+// monotonic wall clock time in microseconds
+static double wall_time() {
+#ifdef _WIN32
+  LARGE_INTEGER frequency;
+  LARGE_INTEGER counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return static_cast<double>(counter.QuadPart) * 1e6 /
+    static_cast<double>(frequency.QuadPart);
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<double>(now.tv_sec) * 1e6 +
+    static_cast<double>(now.tv_nsec) / 1e3;
+#endif
+}
+
+// sorts a range of elements into shared atomic counters
+class AtomicHistogramTask {
+ public:
+  AtomicHistogramTask(
+    std::vector<unsigned int> const & elements,
+    size_t begin, size_t end,
+    embb::base::Atomic<size_t> * counts)
+    : elements_(&elements), begin_(begin), end_(end), counts_(counts) {
+    // empty
+  }
+
+  void Action(embb::mtapi::TaskContext & /*context*/) {
+    for (size_t ii = begin_; ii < end_; ii++) {
+      counts_[(*elements_)[ii]].FetchAndAdd(1);
+    }
+  }
+
+ private:
+  std::vector<unsigned int> const * elements_;
+  size_t begin_;
+  size_t end_;
+  embb::base::Atomic<size_t> * counts_;
+};
+
+// sorts a range of elements into the histogram of the executing worker
+class WorkerLocalHistogramTask {
+ public:
+  WorkerLocalHistogramTask(
+    std::vector<unsigned int> const & elements,
+    size_t begin, size_t end,
+    embb::mtapi::WorkerLocal<Histogram> & histograms)
+    : elements_(&elements), begin_(begin), end_(end),
+      histograms_(&histograms) {
+    // empty
+  }
+
+  void Action(embb::mtapi::TaskContext & /*context*/) {
+    Histogram & histogram = histograms_->Local();
+    for (size_t ii = begin_; ii < end_; ii++) {
+      histogram[(*elements_)[ii]]++;
+    }
+  }
+
+ private:
+  std::vector<unsigned int> const * elements_;
+  size_t begin_;
+  size_t end_;
+  embb::mtapi::WorkerLocal<Histogram> * histograms_;
+};
+
+// adds the histograms of two workers
+static Histogram add_histograms(Histogram const & lhs, Histogram const & rhs) {
+  Histogram sum(lhs);
+  for (size_t ii = 0; ii < sum.size(); ii++) {
+    sum[ii] += rhs[ii];
+  }
+  return sum;
+}
+
+static size_t task_begin(BenchmarkOptions const & options, int task) {
+  return static_cast<size_t>(options.elements) *
+    static_cast<size_t>(task) / static_cast<size_t>(options.tasks);
+}
+
+static double run_atomic(
+  BenchmarkOptions const & options,
+  std::vector<unsigned int> const & elements,
+  int buckets,
+  bool * ok) {
+  embb::mtapi::Node & node = embb::mtapi::Node::GetInstance();
+  embb::base::Atomic<size_t> * counts =
+    new embb::base::Atomic<size_t>[buckets];
+  std::vector<AtomicHistogramTask> actions;
+  std::vector<embb::mtapi::Task> tasks(static_cast<size_t>(options.tasks));
+
+  for (int ii = 0; ii < options.tasks; ii++) {
+    actions.push_back(AtomicHistogramTask(elements,
+      task_begin(options, ii), task_begin(options, ii + 1), counts));
+  }
+
+  double start = wall_time();
+  for (int ii = 0; ii < options.tasks; ii++) {
+    tasks[ii] = node.Start(embb::base::MakeFunction(
+      actions[ii], &AtomicHistogramTask::Action));
+  }
+  for (int ii = 0; ii < options.tasks; ii++) {
+    tasks[ii].Wait();
+  }
+  double seconds = (wall_time() - start) / 1e6;
+
+  size_t total = 0;
+  for (int ii = 0; ii < buckets; ii++) {
+    total += counts[ii].Load();
+  }
+  delete[] counts;
+  *ok = (total == elements.size());
+  return seconds;
+}
+
+static double run_worker_local(
+  BenchmarkOptions const & options,
+  std::vector<unsigned int> const & elements,
+  int buckets,
+  bool * ok) {
+  embb::mtapi::Node & node = embb::mtapi::Node::GetInstance();
+  embb::mtapi::WorkerLocal<Histogram> histograms(
+    Histogram(static_cast<size_t>(buckets), 0));
+  std::vector<WorkerLocalHistogramTask> actions;
+  std::vector<embb::mtapi::Task> tasks(static_cast<size_t>(options.tasks));
+
+  for (int ii = 0; ii < options.tasks; ii++) {
+    actions.push_back(WorkerLocalHistogramTask(elements,
+      task_begin(options, ii), task_begin(options, ii + 1), histograms));
+  }
+
+  double start = wall_time();
+  for (int ii = 0; ii < options.tasks; ii++) {
+    tasks[ii] = node.Start(embb::base::MakeFunction(
+      actions[ii], &WorkerLocalHistogramTask::Action));
+  }
+  for (int ii = 0; ii < options.tasks; ii++) {
+    tasks[ii].Wait();
+  }
+  Histogram histogram = histograms.Combine(add_histograms);
+  double seconds = (wall_time() - start) / 1e6;
+
+  size_t total = 0;
+  for (int ii = 0; ii < buckets; ii++) {
+    total += histogram[ii];
+  }
+  *ok = (total == elements.size());
+  return seconds;
+}
+
+static bool parse_list(char const * text, std::vector<int> * list) {
+  list->clear();
+  while (*text) {
+    char * end;
+    long value = strtol(text, &end, 10);
+    if (end == text || value <= 0) {
+      return false;
+    }
+    list->push_back(static_cast<int>(value));
+    text = (',' == *end) ? end + 1 : end;
+  }
+  return !list->empty();
+}
+
+static void usage(char const * name) {
+  fprintf(stderr,
+    "usage: %s [options]\n"
+    "  --buckets LIST      histogram buckets (16,1024)\n"
+    "  --elements N        elements per run (4194304)\n"
+    "  --tasks N           tasks per run (64)\n"
+    "  --repetitions N     repetitions per run, the fastest counts (5)\n"
+    "  --json              print JSON instead of CSV\n",
+    name);
+}
+
+static bool parse_options(int argc, char ** argv, BenchmarkOptions * options) {
+  parse_list("16,1024", &options->buckets);
+  options->elements = 4194304;
+  options->tasks = 64;
+  options->repetitions = 5;
+  options->json = false;
+
+  for (int ii = 1; ii < argc; ii++) {
+    std::string option = argv[ii];
+    char const * value = (ii + 1 < argc) ? argv[ii + 1] : NULL;
+    bool ok = true;
+    if ("--json" == option) {
+      options->json = true;
+      continue;
+    } else if (NULL == value) {
+      ok = false;
+    } else if ("--buckets" == option) {
+      ok = parse_list(value, &options->buckets);
+    } else if ("--elements" == option) {
+      options->elements = atoi(value);
+    } else if ("--tasks" == option) {
+      options->tasks = atoi(value);
+    } else if ("--repetitions" == option) {
+      options->repetitions = atoi(value);
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      return false;
+    }
+    ii++;
+  }
+
+  // all tasks of a run are started at once
+  return 0 < options->elements && 0 < options->tasks &&
+    static_cast<unsigned int>(options->tasks) <= MTAPI_NODE_MAX_TASKS_DEFAULT &&
+    0 < options->repetitions;
+}
+
+static void print_result(
+  BenchmarkOptions const & options,
+  BenchmarkResult const & result,
+  bool first) {
+  double elements_per_second = result.elements / result.seconds;
+
+  if (options.json) {
+    printf("%s\n  {\"run\": \"%s\", \"buckets\": %d, \"elements\": %d, "
+      "\"tasks\": %d, \"seconds\": %.6f, \"elements_per_second\": %.1f}",
+      first ? "[" : ",", result.run, result.buckets, result.elements,
+      result.tasks, result.seconds, elements_per_second);
+  } else {
+    if (first) {
+      printf("run,buckets,elements,tasks,seconds,elements_per_second\n");
+    }
+    printf("%s,%d,%d,%d,%.6f,%.1f\n", result.run, result.buckets,
+      result.elements, result.tasks, result.seconds, elements_per_second);
+  }
+  fflush(stdout);
+}
+
+int main(int argc, char ** argv) {
+  BenchmarkOptions options;
+  bool ok = true;
+  bool first = true;
+
+  if (!parse_options(argc, argv, &options)) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  embb::mtapi::Node::Initialize(BENCHMARK_DOMAIN, BENCHMARK_NODE);
+
+  for (size_t ii = 0; ok && ii < options.buckets.size(); ii++) {
+    int buckets = options.buckets[ii];
+    // scattered over all buckets, so neighboring elements rarely share one
+    std::vector<unsigned int> elements(static_cast<size_t>(options.elements));
+    unsigned int state = 1;
+    for (size_t jj = 0; jj < elements.size(); jj++) {
+      state = state * 1103515245u + 12345u;
+      elements[jj] = (state >> 16) % static_cast<unsigned int>(buckets);
+    }
+
+    for (int worker_local = 0; ok && worker_local < 2; worker_local++) {
+      BenchmarkResult result;
+      result.run = worker_local ? "worker_local" : "atomic";
+      result.buckets = buckets;
+      result.elements = options.elements;
+      result.tasks = options.tasks;
+      result.seconds = 0.0;
+      for (int jj = 0; ok && jj < options.repetitions; jj++) {
+        double seconds = worker_local ?
+          run_worker_local(options, elements, buckets, &ok) :
+          run_atomic(options, elements, buckets, &ok);
+        if (0 == jj || seconds < result.seconds) {
+          result.seconds = seconds;
+        }
+      }
+      if (!ok) {
+        fprintf(stderr, "histogram of %s run is incomplete\n", result.run);
+      } else {
+        print_result(options, result, first);
+        first = false;
+      }
+    }
+  }
+  if (options.json && !first) {
+    printf("\n]\n");
+  }
+
+  embb::mtapi::Node::Finalize();
+
+  return ok ? 0 : 1;
+}
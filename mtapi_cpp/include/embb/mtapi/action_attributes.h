@@ -104,6 +104,24 @@ class ActionAttributes {
     return *this;
   }
 
+  /**
+   * Sets the maximum number of Tasks executing an Action at the same time.
+   * Further Tasks are held back by the scheduler until a running Task
+   * returns. 0 stands for unlimited, which is the default.
+   *
+   * \returns Reference to this object.
+   * \waitfree
+   */
+  ActionAttributes & SetMaxConcurrency(
+    mtapi_uint_t max_concurrency       /**< The maximum concurrency to set */
+    ) {
+    mtapi_status_t status;
+    mtapi_actionattr_set(&attributes_, MTAPI_ACTION_MAX_CONCURRENCY,
+      &max_concurrency, sizeof(max_concurrency), &status);
+    internal::CheckStatus(status);
+    return *this;
+  }
+
   /**
    * Returns the internal representation of this object.
    * Allows for interoperability with the C interface.
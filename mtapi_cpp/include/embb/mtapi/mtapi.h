@@ -43,5 +43,6 @@
 #include <embb/mtapi/task.h>
 #include <embb/mtapi/task_context.h>
 #include <embb/mtapi/node.h>
+#include <embb/mtapi/worker_local.h>
 
 #endif // EMBB_MTAPI_MTAPI_H_
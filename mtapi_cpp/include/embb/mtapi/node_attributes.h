@@ -251,6 +251,40 @@ class NodeAttributes {
     return *this;
   }
 
+  /**
+   * Sets the maximum number of fibers per worker. Tasks running on a fiber
+   * are suspended instead of blocking their worker when waiting. A value of
+   * 0 disables fibers.
+   *
+   * \returns Reference to this object.
+   * \notthreadsafe
+   */
+  NodeAttributes & SetMaxFibers(
+    mtapi_uint_t value                 /**< The value to set. */
+    ) {
+    mtapi_status_t status;
+    mtapi_nodeattr_set(&attributes_, MTAPI_NODE_MAX_FIBERS,
+      &value, sizeof(value), &status);
+    internal::CheckStatus(status);
+    return *this;
+  }
+
+  /**
+   * Sets the stack size of a fiber in bytes.
+   *
+   * \returns Reference to this object.
+   * \notthreadsafe
+   */
+  NodeAttributes & SetFiberStackSize(
+    mtapi_uint_t value                 /**< The value to set. */
+    ) {
+    mtapi_status_t status;
+    mtapi_nodeattr_set(&attributes_, MTAPI_NODE_FIBER_STACK_SIZE,
+      &value, sizeof(value), &status);
+    internal::CheckStatus(status);
+    return *this;
+  }
+
   /**
    * Returns the internal representation of this object.
    * Allows for interoperability with the C interface.
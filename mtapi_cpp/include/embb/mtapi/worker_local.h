@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EMBB_MTAPI_WORKER_LOCAL_H_
+#define EMBB_MTAPI_WORKER_LOCAL_H_
+
+#include <embb/base/c/internal/config.h>
+#include <embb/base/c/internal/thread_index.h>
+#include <embb/base/exceptions.h>
+#include <embb/base/memory_allocation.h>
+
+#include <new>
+
+namespace embb {
+namespace mtapi {
+
+/**
+ * Provides each worker thread and each external thread with a private,
+ * cache-line-padded copy of a value.
+ *
+ * Tasks accumulate into the value returned by Local() without any
+ * synchronization. Once all tasks are done, the values of all threads that
+ * used the object are folded using Combine() or visited using CombineEach().
+ * Slots are indexed by the EMBB thread index, so the maximum number of
+ * threads (embb::base::Thread::GetThreadsMaxCount()) determines the number of
+ * slots.
+ *
+ * \tparam Type Type of the thread-local values, needs to be copy
+ *         constructible and assignable
+ * \ingroup CPP_MTAPI
+ */
+template <typename Type>
+class WorkerLocal {
+ public:
+  /**
+   * Constructs a WorkerLocal with default constructed values.
+   *
+   * \throws embb::base::NoMemoryException if not enough memory is available
+   * \memory Dynamically allocates one cache line aligned slot per thread
+   * \notthreadsafe
+   */
+  WorkerLocal()
+    : initial_() {
+    Prepare();
+  }
+
+  /**
+   * Constructs a WorkerLocal where each value is a copy of \c initial.
+   *
+   * \throws embb::base::NoMemoryException if not enough memory is available
+   * \memory Dynamically allocates one cache line aligned slot per thread
+   * \notthreadsafe
+   */
+  explicit WorkerLocal(
+    Type const & initial               /**< [in] Initial value of each slot */
+    )
+    : initial_(initial) {
+    Prepare();
+  }
+
+  /**
+   * Destroys the WorkerLocal and all thread-local values.
+   * \notthreadsafe
+   */
+  ~WorkerLocal() {
+    for (unsigned int ii = 0; ii < slot_count_; ii++) {
+      GetSlot(ii)->~Slot();
+    }
+    embb::base::Allocation::FreeAligned(slots_);
+  }
+
+  /**
+   * Returns the value of the calling thread.
+   *
+   * \return Reference to the value of the calling thread
+   * \throws embb::base::ErrorException if the maximum number of threads has
+   *         been exceeded
+   * \lockfree
+   */
+  Type & Local() {
+    unsigned int index = 0;
+    if (EMBB_SUCCESS != embb_internal_thread_index(&index) ||
+      index >= slot_count_) {
+      EMBB_THROW(embb::base::ErrorException,
+        "No thread index could be obtained");
+    }
+    Slot * slot = GetSlot(index);
+    if (!slot->is_used) {
+      slot->is_used = true;
+    }
+    return slot->value;
+  }
+
+  /**
+   * Folds the values of all threads that called Local() using \c function.
+   *
+   * \return <tt>function(...function(value_0, value_1)..., value_n)</tt>
+   *         for all used values or a copy of the initial value if no thread
+   *         called Local()
+   * \notthreadsafe
+   * \note Must not be called concurrently with Local().
+   * \tparam BinaryFunction Function object with signature
+   *         <tt>Type BinaryFunction(Type const &, Type const &)</tt>
+   */
+  template <typename BinaryFunction>
+  Type Combine(
+    BinaryFunction function            /**< [in] Combination function */
+    ) const {
+    Type result(initial_);
+    bool is_first = true;
+    for (unsigned int ii = 0; ii < slot_count_; ii++) {
+      Slot const * slot = GetSlot(ii);
+      if (slot->is_used) {
+        if (is_first) {
+          result = slot->value;
+          is_first = false;
+        } else {
+          result = function(result, slot->value);
+        }
+      }
+    }
+    return result;
+  }
+
+  /**
+   * Calls \c function for the values of all threads that called Local().
+   *
+   * \notthreadsafe
+   * \note Must not be called concurrently with Local().
+   * \tparam UnaryFunction Function object with signature
+   *         <tt>void UnaryFunction(Type const &)</tt>
+   */
+  template <typename UnaryFunction>
+  void CombineEach(
+    UnaryFunction function             /**< [in] Function to call */
+    ) const {
+    for (unsigned int ii = 0; ii < slot_count_; ii++) {
+      Slot const * slot = GetSlot(ii);
+      if (slot->is_used) {
+        function(slot->value);
+      }
+    }
+  }
+
+  /**
+   * Resets the values of all threads to the initial value.
+   *
+   * \notthreadsafe
+   * \note Must not be called concurrently with Local().
+   */
+  void Clear() {
+    for (unsigned int ii = 0; ii < slot_count_; ii++) {
+      Slot * slot = GetSlot(ii);
+      if (slot->is_used) {
+        slot->value = initial_;
+        slot->is_used = false;
+      }
+    }
+  }
+
+ private:
+  struct Slot {
+    explicit Slot(Type const & initial)
+      : value(initial), is_used(false) {
+      // empty
+    }
+
+    Type value;
+    bool is_used;
+  };
+
+  // destroys the slots constructed so far and frees the storage unless
+  // dismissed, so that a throwing copy constructor of Type leaks nothing
+  class PrepareGuard {
+   public:
+    explicit PrepareGuard(WorkerLocal & local)
+      : local_(local), constructed_(0), dismissed_(false) {
+      // empty
+    }
+
+    ~PrepareGuard() {
+      if (!dismissed_) {
+        for (unsigned int ii = 0; ii < constructed_; ii++) {
+          local_.GetSlot(ii)->~Slot();
+        }
+        embb::base::Allocation::FreeAligned(local_.slots_);
+        local_.slots_ = NULL;
+      }
+    }
+
+    void Constructed() {
+      constructed_++;
+    }
+
+    void Dismiss() {
+      dismissed_ = true;
+    }
+
+   private:
+    PrepareGuard(PrepareGuard const & other);
+    PrepareGuard & operator=(PrepareGuard const & other);
+
+    WorkerLocal & local_;
+    unsigned int constructed_;
+    bool dismissed_;
+  };
+
+  void Prepare() {
+    slot_count_ = static_cast<unsigned int>(embb_internal_thread_index_max());
+    // pad slots to whole cache lines to avoid false sharing
+    slot_size_ = ((sizeof(Slot) + EMBB_PLATFORM_CACHE_LINE_SIZE - 1) /
+      EMBB_PLATFORM_CACHE_LINE_SIZE) * EMBB_PLATFORM_CACHE_LINE_SIZE;
+    slots_ = static_cast<char*>(
+      embb::base::Allocation::AllocateCacheAligned(slot_size_ * slot_count_));
+    PrepareGuard guard(*this);
+    for (unsigned int ii = 0; ii < slot_count_; ii++) {
+      new (slots_ + ii * slot_size_) Slot(initial_);
+      guard.Constructed();
+    }
+    guard.Dismiss();
+  }
+
+  Slot * GetSlot(unsigned int index) {
+    return reinterpret_cast<Slot*>(slots_ + index * slot_size_);
+  }
+
+  Slot const * GetSlot(unsigned int index) const {
+    return reinterpret_cast<Slot const *>(slots_ + index * slot_size_);
+  }
+
+  // not copyable
+  WorkerLocal(WorkerLocal const & other);
+  WorkerLocal & operator=(WorkerLocal const & other);
+
+  Type initial_;
+  unsigned int slot_count_;
+  size_t slot_size_;
+  char * slots_;
+};
+
+} // namespace mtapi
+} // namespace embb
+
+#endif // EMBB_MTAPI_WORKER_LOCAL_H_
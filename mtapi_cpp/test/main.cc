@@ -33,6 +33,7 @@
 #include <mtapi_cpp_test_task.h>
 #include <mtapi_cpp_test_group.h>
 #include <mtapi_cpp_test_queue.h>
+#include <mtapi_cpp_test_worker_local.h>
 
 
 PT_MAIN("MTAPI C++") {
@@ -42,4 +43,5 @@ PT_MAIN("MTAPI C++") {
   PT_RUN(TaskTest);
   PT_RUN(GroupTest);
   PT_RUN(QueueTest);
+  PT_RUN(WorkerLocalTest);
 }
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <functional>
+
+#include <mtapi_cpp_test_config.h>
+#include <mtapi_cpp_test_worker_local.h>
+
+#include <embb/base/c/memory_allocation.h>
+
+#define TASK_COUNT 64
+#define ITERATIONS 1000
+
+namespace {
+
+class Accumulator {
+ public:
+  explicit Accumulator(embb::mtapi::WorkerLocal<int> & locals)
+    : locals_(locals) {
+    // empty
+  }
+
+  void Action(embb::mtapi::TaskContext & /*context*/) {
+    int & local = locals_.Local();
+    for (int ii = 0; ii < ITERATIONS; ii++) {
+      local++;
+    }
+  }
+
+ private:
+  embb::mtapi::WorkerLocal<int> & locals_;
+};
+
+class Summation {
+ public:
+  explicit Summation(int & sum)
+    : sum_(sum) {
+    // empty
+  }
+
+  void operator()(int const & value) {
+    sum_ += value;
+  }
+
+ private:
+  int & sum_;
+};
+
+// counts its instances and throws on the copy after the given number
+class ThrowingCopy {
+ public:
+  ThrowingCopy() {
+    instances++;
+  }
+
+  ThrowingCopy(ThrowingCopy const & /*other*/) {
+    if (0 == copies_left) {
+      EMBB_THROW(embb::base::ErrorException, "Copy failed");
+    }
+    copies_left--;
+    instances++;
+  }
+
+  ~ThrowingCopy() {
+    instances--;
+  }
+
+  ThrowingCopy & operator=(ThrowingCopy const & /*other*/) {
+    return *this;
+  }
+
+  static int instances;
+  static int copies_left;
+};
+
+int ThrowingCopy::instances = 0;
+int ThrowingCopy::copies_left = 0;
+
+} // namespace
+
+WorkerLocalTest::WorkerLocalTest() {
+  CreateUnit("mtapi_cpp worker local test")
+    .Add(&WorkerLocalTest::TestBasic, this);
+  CreateUnit("mtapi_cpp worker local throwing copy test")
+    .Add(&WorkerLocalTest::TestThrowingCopy, this);
+}
+
+void WorkerLocalTest::TestBasic() {
+  embb::mtapi::Node::Initialize(THIS_DOMAIN_ID, THIS_NODE_ID);
+  embb::mtapi::Node & node = embb::mtapi::Node::GetInstance();
+
+  {
+    embb::mtapi::WorkerLocal<int> locals(0);
+
+    // nothing used yet, combination yields the initial value
+    PT_EXPECT_EQ(locals.Combine(std::plus<int>()), 0);
+
+    Accumulator accumulator(locals);
+    embb::mtapi::Task tasks[TASK_COUNT];
+    for (int ii = 0; ii < TASK_COUNT; ii++) {
+      tasks[ii] = node.Start(
+        embb::base::MakeFunction(accumulator, &Accumulator::Action));
+    }
+    for (int ii = 0; ii < TASK_COUNT; ii++) {
+      PT_EXPECT_EQ(tasks[ii].Wait(), MTAPI_SUCCESS);
+    }
+
+    // the calling thread gets a slot of its own
+    locals.Local() += 1;
+
+    PT_EXPECT_EQ(locals.Combine(std::plus<int>()),
+      TASK_COUNT * ITERATIONS + 1);
+
+    int sum = 0;
+    locals.CombineEach(Summation(sum));
+    PT_EXPECT_EQ(sum, TASK_COUNT * ITERATIONS + 1);
+
+    locals.Clear();
+    PT_EXPECT_EQ(locals.Combine(std::plus<int>()), 0);
+  }
+
+  embb::mtapi::Node::Finalize();
+
+  PT_EXPECT_EQ(embb_get_bytes_allocated(), 0u);
+}
+
+void WorkerLocalTest::TestThrowingCopy() {
+#ifdef EMBB_USE_EXCEPTIONS
+  {
+    ThrowingCopy initial;
+    // the initial value and two slots are copied, the third slot throws
+    ThrowingCopy::copies_left = 3;
+    bool thrown = false;
+    try {
+      embb::mtapi::WorkerLocal<ThrowingCopy> locals(initial);
+    } catch (embb::base::ErrorException &) {
+      thrown = true;
+    }
+    PT_EXPECT(thrown);
+    PT_EXPECT_EQ(ThrowingCopy::instances, 1);
+  }
+  PT_EXPECT_EQ(ThrowingCopy::instances, 0);
+  PT_EXPECT_EQ(embb_get_bytes_allocated(), 0u);
+#endif
+}
@@ -0,0 +1,545 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Measures the MTAPI I/O plugin with a loopback echo server.
+//
+// A client on the main thread keeps one message in flight on every
+// connection and sends the next one as soon as the echo came back. The
+// server side runs in MTAPI tasks, either one task per connection that
+// blocks in recv until the next message arrives ("blocking"), or one I/O task
+// per message whose continuation echoes the message and starts the I/O task
+// for the next one ("io"). Besides the throughput, every run reports the
+// share of worker time that server tasks occupied, including the time they
+// were blocked, and the share of one core the process used.
+//
+// Reports one line of CSV or one JSON object per run.
+
+#include <embb/mtapi/c/mtapi.h>
+#include <embb/mtapi/c/mtapi_io.h>
+#include <embb/base/c/core_set.h>
+#include <embb/base/c/condition_variable.h>
+#include <embb/base/c/mutex.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#define BENCHMARK_DOMAIN 1
+#define BENCHMARK_NODE 1
+#define BENCHMARK_BLOCKING_JOB 1
+#define BENCHMARK_IO_JOB 2
+#define BENCHMARK_ECHO_JOB 3
+
+struct BenchmarkOptions {
+  std::vector<int> connections;
+  int messages;
+  int size;
+  int reactors;
+  bool json;
+};
+
+struct BenchmarkResult {
+  char const * run;
+  int connections;
+  int messages;
+  double seconds;
+  double worker_busy;
+  double cpu;
+};
+
+// server side of one connection
+struct Connection {
+  int fd;
+  int messages_left;
+};
+
+// state shared by the server tasks of a run
+struct Server {
+  int size;
+  std::vector<Connection> connections;
+  // busy time per worker in microseconds, only touched by the worker itself
+  std::vector<double> worker_busy;
+  embb_mutex_t mutex;
+  embb_condition_t done;
+  int connections_left;
+  bool failed;
+};
+
+static Server server;
+
+// monotonic wall clock time in microseconds
+static double wall_time() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<double>(now.tv_sec) * 1e6 +
+    static_cast<double>(now.tv_nsec) / 1e3;
+}
+
+// user and system time used by this process in microseconds
+static double cpu_time() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) *
+    1e6 + static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+}
+
+static bool echo_message(int fd, std::vector<char> * buffer) {
+  ssize_t size = static_cast<ssize_t>(buffer->size());
+  return size == recv(fd, &(*buffer)[0], buffer->size(), MSG_WAITALL) &&
+    size == send(fd, &(*buffer)[0], buffer->size(), 0);
+}
+
+static void connection_done(bool ok) {
+  embb_mutex_lock(&server.mutex);
+  server.failed = server.failed || !ok;
+  if (0 == --server.connections_left) {
+    embb_condition_notify_all(&server.done);
+  }
+  embb_mutex_unlock(&server.mutex);
+}
+
+// serves all messages of a connection, blocking the worker in between
+static void serve_blocking(
+  void const * arguments,
+  mtapi_size_t /*arguments_size*/,
+  void * /*result_buffer*/,
+  mtapi_size_t /*result_buffer_size*/,
+  void const * /*node_local_data*/,
+  mtapi_size_t /*node_local_data_size*/,
+  mtapi_task_context_t * context) {
+  mtapi_status_t status;
+  double start = wall_time();
+  Connection & connection =
+    server.connections[*static_cast<size_t const *>(arguments)];
+  std::vector<char> buffer(static_cast<size_t>(server.size));
+  bool ok = true;
+
+  for (; ok && 0 < connection.messages_left; connection.messages_left--) {
+    ok = echo_message(connection.fd, &buffer);
+  }
+  server.worker_busy[mtapi_context_corenum_get(context, &status)] +=
+    wall_time() - start;
+  connection_done(ok);
+}
+
+static bool start_io_task(int fd) {
+  mtapi_status_t status;
+  mtapi_task_attributes_t attr;
+  mtapi_boolean_t detached = MTAPI_TRUE;
+  mtapi_io_request_t request;
+  request.fd = fd;
+  request.events = MTAPI_IO_READABLE;
+
+  // nobody waits for the I/O tasks, the last continuation reports the end
+  // of the connection
+  mtapi_taskattr_init(&attr, &status);
+  mtapi_taskattr_set(&attr, MTAPI_TASK_DETACHED,
+    &detached, sizeof(detached), &status);
+  mtapi_job_hndl_t job =
+    mtapi_job_get(BENCHMARK_IO_JOB, BENCHMARK_DOMAIN, &status);
+  if (MTAPI_SUCCESS == status) {
+    // the plugin copies the request when the task starts
+    mtapi_task_start(MTAPI_TASK_ID_NONE, job,
+      &request, sizeof(request), MTAPI_NULL, 0,
+      &attr, MTAPI_GROUP_NONE, &status);
+  }
+  return MTAPI_SUCCESS == status;
+}
+
+// continuation of an I/O task, echoes one message and waits for the next
+static void serve_io(
+  void const * arguments,
+  mtapi_size_t /*arguments_size*/,
+  void * /*result_buffer*/,
+  mtapi_size_t /*result_buffer_size*/,
+  void const * /*node_local_data*/,
+  mtapi_size_t /*node_local_data_size*/,
+  mtapi_task_context_t * context) {
+  mtapi_status_t status;
+  double start = wall_time();
+  mtapi_io_request_t const * request =
+    static_cast<mtapi_io_request_t const *>(arguments);
+  Connection * connection = MTAPI_NULL;
+  for (size_t ii = 0; ii < server.connections.size(); ii++) {
+    if (server.connections[ii].fd == request->fd) {
+      connection = &server.connections[ii];
+    }
+  }
+  std::vector<char> buffer(static_cast<size_t>(server.size));
+
+  bool ok = MTAPI_NULL != connection &&
+    0 != (request->events & MTAPI_IO_READABLE) &&
+    echo_message(request->fd, &buffer);
+  bool last = !ok || 0 == --connection->messages_left;
+  if (!last) {
+    ok = start_io_task(request->fd);
+    last = !ok;
+  }
+  server.worker_busy[mtapi_context_corenum_get(context, &status)] +=
+    wall_time() - start;
+  if (last) {
+    connection_done(ok);
+  }
+}
+
+static bool parse_list(char const * text, std::vector<int> * list) {
+  list->clear();
+  while (*text) {
+    char * end;
+    long value = strtol(text, &end, 10);
+    if (end == text || value <= 0) {
+      return false;
+    }
+    list->push_back(static_cast<int>(value));
+    text = (',' == *end) ? end + 1 : end;
+  }
+  return !list->empty();
+}
+
+static void usage(char const * name) {
+  fprintf(stderr,
+    "usage: %s [options]\n"
+    "  --connections LIST  client connections (1,16,64)\n"
+    "  --messages N        round trips per connection (1000)\n"
+    "  --size N            message size in bytes (64)\n"
+    "  --reactors N        reactor threads of the plugin (1)\n"
+    "  --json              print JSON instead of CSV\n",
+    name);
+}
+
+static bool parse_options(int argc, char ** argv, BenchmarkOptions * options) {
+  parse_list("1,16,64", &options->connections);
+  options->messages = 1000;
+  options->size = 64;
+  options->reactors = 1;
+  options->json = false;
+
+  for (int ii = 1; ii < argc; ii++) {
+    std::string option = argv[ii];
+    char const * value = (ii + 1 < argc) ? argv[ii + 1] : NULL;
+    bool ok = true;
+    if ("--json" == option) {
+      options->json = true;
+      continue;
+    } else if (NULL == value) {
+      ok = false;
+    } else if ("--connections" == option) {
+      ok = parse_list(value, &options->connections);
+    } else if ("--messages" == option) {
+      options->messages = atoi(value);
+    } else if ("--size" == option) {
+      options->size = atoi(value);
+    } else if ("--reactors" == option) {
+      options->reactors = atoi(value);
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      return false;
+    }
+    ii++;
+  }
+
+  return 0 < options->messages && 0 < options->size && 0 < options->reactors;
+}
+
+// opens count loopback connections, the client ends are returned in
+// clients and the server ends in servers
+static bool connect_loopback(
+  int count,
+  std::vector<int> * clients,
+  std::vector<int> * servers) {
+  struct sockaddr_in address;
+  socklen_t length = sizeof(address);
+  int one = 1;
+  bool ok = true;
+
+  int listener = socket(AF_INET, SOCK_STREAM, 0);
+  memset(&address, 0, sizeof(address));
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = 0;
+  ok = 0 <= listener &&
+    0 == bind(listener, reinterpret_cast<struct sockaddr *>(&address),
+      sizeof(address)) &&
+    0 == listen(listener, count) &&
+    0 == getsockname(listener, reinterpret_cast<struct sockaddr *>(&address),
+      &length);
+
+  for (int ii = 0; ok && ii < count; ii++) {
+    int client = socket(AF_INET, SOCK_STREAM, 0);
+    ok = 0 <= client &&
+      0 == connect(client, reinterpret_cast<struct sockaddr *>(&address),
+        sizeof(address));
+    int accepted = ok ? accept(listener, NULL, NULL) : -1;
+    ok = ok && 0 <= accepted;
+    if (0 <= client) {
+      setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+      clients->push_back(client);
+    }
+    if (0 <= accepted) {
+      setsockopt(accepted, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+      servers->push_back(accepted);
+    }
+  }
+
+  if (0 <= listener) {
+    close(listener);
+  }
+  return ok;
+}
+
+// keeps one message in flight per connection until all round trips are done
+static bool run_client(
+  BenchmarkOptions const & options,
+  std::vector<int> const & clients) {
+  std::vector<char> buffer(static_cast<size_t>(options.size), 'x');
+  std::vector<struct pollfd> fds(clients.size());
+  std::vector<int> messages_left(clients.size(), options.messages);
+  ssize_t size = static_cast<ssize_t>(buffer.size());
+  size_t open = clients.size();
+  bool ok = true;
+
+  for (size_t ii = 0; ok && ii < clients.size(); ii++) {
+    fds[ii].fd = clients[ii];
+    fds[ii].events = POLLIN;
+    ok = size == send(clients[ii], &buffer[0], buffer.size(), 0);
+  }
+  while (ok && 0 < open) {
+    ok = 0 < poll(&fds[0], fds.size(), -1);
+    for (size_t ii = 0; ok && ii < fds.size(); ii++) {
+      if (0 == (fds[ii].revents & (POLLIN | POLLERR | POLLHUP))) {
+        continue;
+      }
+      ok = size == recv(fds[ii].fd, &buffer[0], buffer.size(), MSG_WAITALL);
+      if (ok && 0 < --messages_left[ii]) {
+        ok = size == send(fds[ii].fd, &buffer[0], buffer.size(), 0);
+      } else {
+        // negative descriptors are ignored by poll
+        fds[ii].fd = -1;
+        open--;
+      }
+    }
+  }
+  return ok;
+}
+
+static bool run_echo(
+  BenchmarkOptions const & options,
+  int connections,
+  bool io,
+  BenchmarkResult * result) {
+  mtapi_status_t status;
+  std::vector<int> clients;
+  std::vector<int> servers;
+  std::vector<size_t> indices(static_cast<size_t>(connections));
+  std::vector<mtapi_task_hndl_t> tasks;
+  bool ok = connect_loopback(connections, &clients, &servers);
+
+  server.size = options.size;
+  server.connections.resize(servers.size());
+  for (size_t ii = 0; ii < servers.size(); ii++) {
+    server.connections[ii].fd = servers[ii];
+    server.connections[ii].messages_left = options.messages;
+  }
+  server.worker_busy.assign(embb_core_count_available(), 0.0);
+  server.connections_left = connections;
+  server.failed = false;
+
+  double wall_start = wall_time();
+  double cpu_start = cpu_time();
+  if (ok && io) {
+    for (size_t ii = 0; ok && ii < servers.size(); ii++) {
+      ok = start_io_task(servers[ii]);
+    }
+  } else if (ok) {
+    mtapi_job_hndl_t job =
+      mtapi_job_get(BENCHMARK_BLOCKING_JOB, BENCHMARK_DOMAIN, &status);
+    ok = (MTAPI_SUCCESS == status);
+    for (size_t ii = 0; ok && ii < servers.size(); ii++) {
+      indices[ii] = ii;
+      tasks.push_back(mtapi_task_start(MTAPI_TASK_ID_NONE, job,
+        &indices[ii], sizeof(size_t), MTAPI_NULL, 0,
+        MTAPI_DEFAULT_TASK_ATTRIBUTES, MTAPI_GROUP_NONE, &status));
+      ok = (MTAPI_SUCCESS == status);
+    }
+  }
+  ok = ok && run_client(options, clients);
+
+  // all server tasks have to be done before the sockets are closed
+  if (ok) {
+    embb_mutex_lock(&server.mutex);
+    while (0 < server.connections_left) {
+      embb_condition_wait(&server.done, &server.mutex);
+    }
+    ok = !server.failed;
+    embb_mutex_unlock(&server.mutex);
+  }
+  double cpu = cpu_time() - cpu_start;
+  double wall = wall_time() - wall_start;
+  for (size_t ii = 0; ii < tasks.size(); ii++) {
+    mtapi_task_wait(tasks[ii], MTAPI_INFINITE, &status);
+  }
+
+  for (size_t ii = 0; ii < clients.size(); ii++) {
+    close(clients[ii]);
+  }
+  for (size_t ii = 0; ii < servers.size(); ii++) {
+    close(servers[ii]);
+  }
+  if (!ok) {
+    fprintf(stderr, "echo failed\n");
+    return false;
+  }
+
+  double busy = 0.0;
+  for (size_t ii = 0; ii < server.worker_busy.size(); ii++) {
+    busy += server.worker_busy[ii];
+  }
+  result->run = io ? "io" : "blocking";
+  result->connections = connections;
+  result->messages = connections * options.messages;
+  result->seconds = wall / 1e6;
+  result->worker_busy =
+    busy / (wall * static_cast<double>(server.worker_busy.size()));
+  result->cpu = cpu / wall;
+  return true;
+}
+
+static void print_result(
+  BenchmarkOptions const & options,
+  BenchmarkResult const & result,
+  bool first) {
+  double messages_per_second = result.messages / result.seconds;
+
+  if (options.json) {
+    printf("%s\n  {\"run\": \"%s\", \"connections\": %d, \"messages\": %d, "
+      "\"seconds\": %.6f, \"messages_per_second\": %.1f, "
+      "\"worker_busy\": %.3f, \"cpu\": %.3f}",
+      first ? "[" : ",", result.run, result.connections, result.messages,
+      result.seconds, messages_per_second, result.worker_busy, result.cpu);
+  } else {
+    if (first) {
+      printf("run,connections,messages,seconds,messages_per_second,"
+        "worker_busy,cpu\n");
+    }
+    printf("%s,%d,%d,%.6f,%.1f,%.3f,%.3f\n",
+      result.run, result.connections, result.messages, result.seconds,
+      messages_per_second, result.worker_busy, result.cpu);
+  }
+  fflush(stdout);
+}
+
+int main(int argc, char ** argv) {
+  BenchmarkOptions options;
+  mtapi_status_t status;
+  mtapi_node_attributes_t node_attr;
+  mtapi_action_hndl_t actions[3];
+  bool ok = true;
+  bool first = true;
+
+  if (!parse_options(argc, argv, &options)) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  int max_connections = *std::max_element(
+    options.connections.begin(), options.connections.end());
+  // an I/O task and its continuation per connection, the main thread is the
+  // client and must not run tasks
+  mtapi_uint_t max_tasks =
+    static_cast<mtapi_uint_t>(std::max(1024, 4 * max_connections));
+  mtapi_nodeattr_init(&node_attr, &status);
+  mtapi_nodeattr_set(&node_attr, MTAPI_NODE_MAX_TASKS,
+    &max_tasks, MTAPI_NODE_MAX_TASKS_SIZE, &status);
+  mtapi_nodeattr_set(&node_attr, MTAPI_NODE_QUEUE_LIMIT,
+    &max_tasks, MTAPI_NODE_QUEUE_LIMIT_SIZE, &status);
+  mtapi_nodeattr_set(&node_attr, MTAPI_NODE_REUSE_MAIN_THREAD,
+    MTAPI_ATTRIBUTE_VALUE(MTAPI_FALSE), MTAPI_ATTRIBUTE_POINTER_AS_VALUE,
+    &status);
+  mtapi_initialize(BENCHMARK_DOMAIN, BENCHMARK_NODE, &node_attr, MTAPI_NULL,
+    &status);
+  if (MTAPI_SUCCESS != status) {
+    fprintf(stderr, "could not initialize MTAPI\n");
+    return 1;
+  }
+  mtapi_io_plugin_initialize(static_cast<mtapi_uint_t>(options.reactors),
+    64, &status);
+  if (MTAPI_SUCCESS != status) {
+    fprintf(stderr, "could not initialize the I/O plugin\n");
+    mtapi_finalize(MTAPI_NULL);
+    return 1;
+  }
+
+  embb_mutex_init(&server.mutex, EMBB_MUTEX_PLAIN);
+  embb_condition_init(&server.done);
+  actions[0] = mtapi_action_create(BENCHMARK_BLOCKING_JOB, serve_blocking,
+    MTAPI_NULL, 0, MTAPI_DEFAULT_ACTION_ATTRIBUTES, &status);
+  ok = ok && (MTAPI_SUCCESS == status);
+  actions[1] = mtapi_action_create(BENCHMARK_ECHO_JOB, serve_io,
+    MTAPI_NULL, 0, MTAPI_DEFAULT_ACTION_ATTRIBUTES, &status);
+  ok = ok && (MTAPI_SUCCESS == status);
+  actions[2] = mtapi_io_action_create(BENCHMARK_IO_JOB, BENCHMARK_ECHO_JOB,
+    &status);
+  ok = ok && (MTAPI_SUCCESS == status);
+
+  for (size_t ii = 0; ok && ii < options.connections.size(); ii++) {
+    for (int io = 0; ok && io < 2; io++) {
+      BenchmarkResult result;
+      ok = run_echo(options, options.connections[ii], 0 != io, &result);
+      if (ok) {
+        print_result(options, result, first);
+        first = false;
+      }
+    }
+  }
+  if (options.json && !first) {
+    printf("\n]\n");
+  }
+
+  for (int ii = 2; ii >= 0; ii--) {
+    mtapi_action_delete(actions[ii], MTAPI_INFINITE, &status);
+  }
+  embb_condition_destroy(&server.done);
+  embb_mutex_destroy(&server.mutex);
+  mtapi_io_plugin_finalize(&status);
+  mtapi_finalize(&status);
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EMBB_MTAPI_C_MTAPI_IO_H_
+#define EMBB_MTAPI_C_MTAPI_IO_H_
+
+
+#include <embb/mtapi/c/mtapi_ext.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * \defgroup C_MTAPI_IO MTAPI I/O Plugin
+ *
+ * \ingroup C_MTAPI_EXT
+ *
+ * Provides functionality to let tasks wait for file descriptors to become
+ * ready without blocking a worker thread.
+ *
+ * Tasks started on an I/O action take an \c mtapi_io_request_t as argument
+ * and complete as soon as the given file descriptor becomes ready for the
+ * requested operations. Readiness is detected by one or more reactor threads
+ * that are driven by \c epoll. If the action was created with a continuation
+ * job, a task of that job is started as soon as the descriptor becomes ready
+ * and the I/O task completes together with this continuation task.
+ */
+
+
+/** Wait until the file descriptor is readable. */
+#define MTAPI_IO_READABLE 0x1u
+/** Wait until the file descriptor is writable. */
+#define MTAPI_IO_WRITABLE 0x2u
+/** Reported if an error condition occurred on the file descriptor. */
+#define MTAPI_IO_ERROR 0x4u
+/** Reported if the peer closed the connection. */
+#define MTAPI_IO_HANGUP 0x8u
+
+/** Passed as continuation job if no continuation shall be started. */
+#define MTAPI_IO_CONTINUATION_NONE 0
+
+/**
+ * I/O request, passed as argument to tasks started on an I/O action.
+ *
+ * \ingroup C_MTAPI_IO
+ */
+struct mtapi_io_request_struct {
+  int fd;                              /**< File descriptor to wait for */
+  mtapi_uint_t events;                 /**< Combination of
+                                            \c MTAPI_IO_READABLE and
+                                            \c MTAPI_IO_WRITABLE. When passed
+                                            to a continuation task, this
+                                            contains the events that
+                                            actually occurred. */
+};
+
+/**
+ * I/O request type.
+ * \memberof mtapi_io_request_struct
+ */
+typedef struct mtapi_io_request_struct mtapi_io_request_t;
+
+
+/**
+ * Initializes the MTAPI I/O environment on a previously initialized MTAPI
+ * node.
+ *
+ * It must be called before any I/O action is created. It is an error to call
+ * mtapi_io_plugin_initialize() multiple times from a given node, unless
+ * mtapi_io_plugin_finalize() is called in between.
+ *
+ * File descriptors are assigned to reactor threads by their numeric value, so
+ * a file descriptor is always watched by the same reactor. Only one task may
+ * wait for a given file descriptor at a time.
+ *
+ * On success, \c *status is set to \c MTAPI_SUCCESS. On error, \c *status is
+ * set to the appropriate error defined below.
+ * Error code                  | Description
+ * --------------------------- | ----------------------------------------------
+ * \c MTAPI_ERR_NODE_NOTINIT   | The calling node is not initialized.
+ * \c MTAPI_ERR_PARAMETER      | Invalid number of reactors or events.
+ * \c MTAPI_ERR_UNKNOWN        | MTAPI I/O couldn't be initialized.
+ *
+ * \see mtapi_io_plugin_finalize()
+ *
+ * \notthreadsafe
+ * \ingroup C_MTAPI_IO
+ */
+void mtapi_io_plugin_initialize(
+  MTAPI_IN mtapi_uint_t num_reactors,  /**< [in] Number of reactor threads
+                                            polling for readiness */
+  MTAPI_IN mtapi_uint_t max_events,    /**< [in] Maximum number of readiness
+                                            events a reactor handles per
+                                            wakeup */
+  MTAPI_OUT mtapi_status_t* status     /**< [out] Pointer to error code,
+                                            may be \c MTAPI_NULL */
+);
+
+/**
+ * Finalizes the MTAPI I/O environment on the local MTAPI node.
+ *
+ * All I/O actions have to be deleted before mtapi_io_plugin_finalize() is
+ * called. The reactor threads are stopped and all resources are released.
+ *
+ * On success, \c *status is set to \c MTAPI_SUCCESS. On error, \c *status is
+ * set to the appropriate error defined below.
+ * Error code                    | Description
+ * ----------------------------- | --------------------------------------------
+ * \c MTAPI_ERR_UNKNOWN          | MTAPI I/O couldn't be finalized.
+ *
+ * \see mtapi_io_plugin_initialize()
+ *
+ * \notthreadsafe
+ * \ingroup C_MTAPI_IO
+ */
+void mtapi_io_plugin_finalize(
+  MTAPI_OUT mtapi_status_t* status     /**< [out] Pointer to error code,
+                                            may be \c MTAPI_NULL */
+);
+
+/**
+ * This function creates an I/O action.
+ *
+ * Tasks started on the job of an I/O action do not occupy a worker thread
+ * while waiting. Their argument must be a single \c mtapi_io_request_t. If
+ * no continuation job is given, the task completes as soon as the file
+ * descriptor becomes ready and, if the result buffer has the size of an
+ * \c mtapi_uint_t, the events that occurred are stored there.
+ *
+ * If \c continuation_job_id is not \c MTAPI_IO_CONTINUATION_NONE, a task of
+ * that job is started once the file descriptor becomes ready. It receives a
+ * copy of the request (with \c events set to the events that occurred) as
+ * argument and the result buffer of the I/O task as result buffer. The I/O
+ * task completes with the status of the continuation task.
+ *
+ * Canceling a waiting I/O task removes its file descriptor from the reactor.
+ *
+ * On success, an action handle is returned and \c *status is set to
+ * \c MTAPI_SUCCESS. On error, \c *status is set to the appropriate error
+ * defined below.
+ * Error code                  | Description
+ * --------------------------- | ----------------------------------------------
+ * \c MTAPI_ERR_JOB_INVALID    | The \c job_id is not a valid job ID.
+ * \c MTAPI_ERR_ACTION_LIMIT   | Exceeded maximum number of actions allowed.
+ * \c MTAPI_ERR_NODE_NOTINIT   | The calling node is not initialized.
+ * \c MTAPI_ERR_UNKNOWN        | The I/O plugin is not initialized.
+ *
+ * \see mtapi_action_delete(), mtapi_finalize()
+ *
+ * \returns Handle to newly created I/O action, invalid handle on error
+ * \threadsafe
+ * \ingroup C_MTAPI_IO
+ */
+mtapi_action_hndl_t mtapi_io_action_create(
+  MTAPI_IN mtapi_job_id_t job_id,      /**< [in] Job id */
+  MTAPI_IN mtapi_job_id_t continuation_job_id,
+                                       /**< [in] Job started when the file
+                                            descriptor becomes ready, or
+                                            \c MTAPI_IO_CONTINUATION_NONE */
+  MTAPI_OUT mtapi_status_t* status     /**< [out] Pointer to error code,
+                                            may be \c MTAPI_NULL */
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // EMBB_MTAPI_C_MTAPI_IO_H_
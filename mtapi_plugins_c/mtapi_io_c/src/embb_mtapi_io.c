@@ -0,0 +1,507 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <embb/mtapi/c/mtapi_io.h>
+#include <embb/base/c/memory_allocation.h>
+#include <embb/base/c/thread.h>
+#include <embb/base/c/atomic.h>
+#include <embb/base/c/internal/unused.h>
+
+#include <embb_mtapi_task_t.h>
+#include <embb_mtapi_action_t.h>
+#include <embb_mtapi_node_t.h>
+#include <embb_mtapi_job_t.h>
+#include <embb_mtapi_scheduler_t.h>
+#include <mtapi_status_t.h>
+
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <stdint.h>
+#include <string.h>
+
+/* a task waiting for a file descriptor, stored at the index of its task id.
+   state holds the tag of the waiting task plus one, or 0 if nobody is
+   waiting (task tags start at 0). the reactor and the cancel function race
+   for the wait by swapping the state against 0, so exactly one of them
+   completes the task. */
+struct embb_mtapi_io_wait_struct {
+  embb_atomic_int state;
+  mtapi_task_hndl_t task;
+  mtapi_io_request_t request;
+};
+
+typedef struct embb_mtapi_io_wait_struct embb_mtapi_io_wait_t;
+
+struct embb_mtapi_io_reactor_struct {
+  embb_thread_t thread;
+  int epoll_fd;
+  struct epoll_event * events;
+};
+
+typedef struct embb_mtapi_io_reactor_struct embb_mtapi_io_reactor_t;
+
+struct embb_mtapi_io_plugin_struct {
+  embb_atomic_int run;
+  mtapi_uint_t num_reactors;
+  int max_events;
+  embb_mtapi_io_reactor_t * reactors;
+  mtapi_uint_t max_waits;
+  embb_mtapi_io_wait_t * waits;
+};
+
+typedef struct embb_mtapi_io_plugin_struct embb_mtapi_io_plugin_t;
+
+static embb_mtapi_io_plugin_t embb_mtapi_io_plugin;
+
+struct embb_mtapi_io_action_struct {
+  mtapi_job_id_t continuation_job_id;
+};
+
+typedef struct embb_mtapi_io_action_struct embb_mtapi_io_action_t;
+
+static uint64_t embb_mtapi_io_encode_handle(mtapi_task_hndl_t task) {
+  return ((uint64_t)task.id << 32) | (uint64_t)(uint32_t)task.tag;
+}
+
+static int embb_mtapi_io_wait_state(mtapi_uint_t tag) {
+  int state = (int)(uint32_t)(tag + 1);
+  /* a wrapped tag must not look like an idle wait */
+  return (0 == state) ? 1 : state;
+}
+
+static mtapi_uint_t embb_mtapi_io_events_from_epoll(uint32_t events) {
+  mtapi_uint_t result = 0;
+  if (events & EPOLLIN) result |= MTAPI_IO_READABLE;
+  if (events & EPOLLOUT) result |= MTAPI_IO_WRITABLE;
+  if (events & EPOLLERR) result |= MTAPI_IO_ERROR;
+  if (events & (EPOLLHUP | EPOLLRDHUP)) result |= MTAPI_IO_HANGUP;
+  return result;
+}
+
+static embb_mtapi_io_reactor_t * embb_mtapi_io_reactor_for_fd(int fd) {
+  embb_mtapi_io_plugin_t * plugin = &embb_mtapi_io_plugin;
+  return &plugin->reactors[(mtapi_uint_t)fd % plugin->num_reactors];
+}
+
+static void embb_mtapi_io_finish_task(
+  embb_mtapi_task_t * local_task,
+  embb_mtapi_node_t * node,
+  mtapi_status_t error_code) {
+  mtapi_task_state_t next_state;
+
+  local_task->error_code = error_code;
+  if (MTAPI_SUCCESS == error_code) {
+    next_state = MTAPI_TASK_COMPLETED;
+  } else if (MTAPI_ERR_ACTION_CANCELLED == error_code) {
+    next_state = MTAPI_TASK_CANCELLED;
+  } else {
+    next_state = MTAPI_TASK_ERROR;
+  }
+  embb_mtapi_scheduler_finalize_task(local_task, node, next_state);
+}
+
+static void embb_mtapi_io_continuation_complete(
+  MTAPI_IN mtapi_task_hndl_t task,
+  MTAPI_OUT mtapi_status_t* status) {
+  mtapi_status_t local_status = MTAPI_ERR_UNKNOWN;
+
+  if (embb_mtapi_node_is_initialized()) {
+    embb_mtapi_node_t * node = embb_mtapi_node_get_instance();
+
+    if (embb_mtapi_task_pool_is_handle_valid(node->task_pool, task)) {
+      embb_mtapi_task_t * continuation =
+        embb_mtapi_task_pool_get_storage_for_handle(node->task_pool, task);
+      embb_mtapi_io_wait_t * wait =
+        (embb_mtapi_io_wait_t*)continuation->attributes.user_data;
+
+      if (embb_mtapi_task_pool_is_handle_valid(node->task_pool, wait->task)) {
+        embb_mtapi_task_t * io_task =
+          embb_mtapi_task_pool_get_storage_for_handle(
+            node->task_pool, wait->task);
+        /* the I/O task completes with the status of its continuation */
+        embb_mtapi_io_finish_task(io_task, node, continuation->error_code);
+        local_status = MTAPI_SUCCESS;
+      }
+    }
+  }
+
+  mtapi_status_set(status, local_status);
+}
+
+static void embb_mtapi_io_handle_ready(
+  embb_mtapi_io_reactor_t * reactor,
+  struct epoll_event * event) {
+  embb_mtapi_io_plugin_t * plugin = &embb_mtapi_io_plugin;
+  mtapi_uint_t id = (mtapi_uint_t)(event->data.u64 >> 32);
+  int state =
+    embb_mtapi_io_wait_state((mtapi_uint_t)(uint32_t)event->data.u64);
+  embb_mtapi_io_wait_t * wait;
+  embb_mtapi_node_t * node;
+  embb_mtapi_task_t * local_task;
+  mtapi_uint_t ready;
+
+  if (id >= plugin->max_waits || !embb_mtapi_node_is_initialized()) {
+    return;
+  }
+  wait = &plugin->waits[id];
+
+  /* the wait might have been canceled in the meantime */
+  if (!embb_atomic_compare_and_swap_int(&wait->state, &state, 0)) {
+    return;
+  }
+  epoll_ctl(reactor->epoll_fd, EPOLL_CTL_DEL, wait->request.fd, NULL);
+
+  node = embb_mtapi_node_get_instance();
+  if (!embb_mtapi_task_pool_is_handle_valid(node->task_pool, wait->task)) {
+    return;
+  }
+  local_task =
+    embb_mtapi_task_pool_get_storage_for_handle(node->task_pool, wait->task);
+  ready = embb_mtapi_io_events_from_epoll(event->events);
+
+  if (embb_mtapi_action_pool_is_handle_valid(
+    node->action_pool, local_task->action)) {
+    embb_mtapi_action_t * local_action =
+      embb_mtapi_action_pool_get_storage_for_handle(
+        node->action_pool, local_task->action);
+    embb_mtapi_io_action_t * io_action =
+      (embb_mtapi_io_action_t*)local_action->plugin_data;
+
+    if (MTAPI_IO_CONTINUATION_NONE != io_action->continuation_job_id) {
+      mtapi_status_t local_status = MTAPI_ERR_UNKNOWN;
+      mtapi_task_attributes_t task_attr;
+      mtapi_task_complete_function_t func =
+        embb_mtapi_io_continuation_complete;
+      void * func_void;
+      mtapi_boolean_t task_detached = MTAPI_TRUE;
+      mtapi_job_hndl_t job_hndl;
+
+      wait->request.events = ready;
+
+      mtapi_taskattr_init(&task_attr, &local_status);
+      mtapi_taskattr_set(&task_attr, MTAPI_TASK_USER_DATA,
+        (void*)wait, 0, &local_status);
+      mtapi_taskattr_set(&task_attr, MTAPI_TASK_DETACHED,
+        (void*)&task_detached, sizeof(mtapi_boolean_t), &local_status);
+      mtapi_taskattr_set(&task_attr, MTAPI_TASK_PRIORITY,
+        (void*)&local_task->attributes.priority, sizeof(mtapi_uint_t),
+        &local_status);
+      memcpy(&func_void, &func, sizeof(void*));
+      mtapi_taskattr_set(&task_attr, MTAPI_TASK_COMPLETE_FUNCTION,
+        func_void, 0, &local_status);
+
+      job_hndl = mtapi_job_get(io_action->continuation_job_id,
+        local_action->domain_id, &local_status);
+      if (MTAPI_SUCCESS == local_status) {
+        mtapi_task_start(
+          MTAPI_TASK_ID_NONE, job_hndl,
+          &wait->request, sizeof(mtapi_io_request_t),
+          local_task->result_buffer, local_task->result_size,
+          &task_attr, MTAPI_GROUP_NONE,
+          &local_status);
+      }
+      if (MTAPI_SUCCESS != local_status) {
+        embb_mtapi_io_finish_task(local_task, node, local_status);
+      }
+      /* otherwise the continuation completes the task */
+      return;
+    }
+  }
+
+  if (MTAPI_NULL != local_task->result_buffer &&
+    sizeof(mtapi_uint_t) == local_task->result_size) {
+    memcpy(local_task->result_buffer, &ready, sizeof(mtapi_uint_t));
+  }
+  embb_mtapi_io_finish_task(local_task, node, MTAPI_SUCCESS);
+}
+
+static int embb_mtapi_io_reactor_thread(void * args) {
+  embb_mtapi_io_plugin_t * plugin = &embb_mtapi_io_plugin;
+  embb_mtapi_io_reactor_t * reactor = (embb_mtapi_io_reactor_t*)args;
+  int count;
+  int ii;
+
+  while (embb_atomic_load_int(&plugin->run)) {
+    count = epoll_wait(reactor->epoll_fd, reactor->events,
+      plugin->max_events, 100);
+    /* handle all events of this wakeup in one go */
+    for (ii = 0; ii < count; ii++) {
+      embb_mtapi_io_handle_ready(reactor, &reactor->events[ii]);
+    }
+  }
+
+  return EMBB_SUCCESS;
+}
+
+static void embb_mtapi_io_reactors_finalize(mtapi_uint_t count) {
+  embb_mtapi_io_plugin_t * plugin = &embb_mtapi_io_plugin;
+  mtapi_uint_t ii;
+  int err;
+
+  embb_atomic_store_int(&plugin->run, 0);
+  for (ii = 0; ii < count; ii++) {
+    embb_thread_join(&plugin->reactors[ii].thread, &err);
+    close(plugin->reactors[ii].epoll_fd);
+    embb_free(plugin->reactors[ii].events);
+  }
+  embb_free(plugin->reactors);
+  plugin->reactors = NULL;
+}
+
+void mtapi_io_plugin_initialize(
+  MTAPI_IN mtapi_uint_t num_reactors,
+  MTAPI_IN mtapi_uint_t max_events,
+  MTAPI_OUT mtapi_status_t* status) {
+  embb_mtapi_io_plugin_t * plugin = &embb_mtapi_io_plugin;
+  embb_mtapi_node_t * node;
+  mtapi_uint_t ii;
+  int err;
+
+  mtapi_status_set(status, MTAPI_ERR_UNKNOWN);
+
+  if (!embb_mtapi_node_is_initialized()) {
+    mtapi_status_set(status, MTAPI_ERR_NODE_NOTINIT);
+    return;
+  }
+  if (0 == num_reactors || 0 == max_events) {
+    mtapi_status_set(status, MTAPI_ERR_PARAMETER);
+    return;
+  }
+  node = embb_mtapi_node_get_instance();
+
+  plugin->num_reactors = num_reactors;
+  plugin->max_events = (int)max_events;
+
+  /* one wait slot per task id */
+  plugin->max_waits = node->attributes.max_tasks + 1;
+  plugin->waits = (embb_mtapi_io_wait_t*)embb_alloc(
+    sizeof(embb_mtapi_io_wait_t) * plugin->max_waits);
+  if (NULL == plugin->waits) {
+    return;
+  }
+  for (ii = 0; ii < plugin->max_waits; ii++) {
+    embb_atomic_init_int(&plugin->waits[ii].state, 0);
+  }
+
+  plugin->reactors = (embb_mtapi_io_reactor_t*)embb_alloc(
+    sizeof(embb_mtapi_io_reactor_t) * num_reactors);
+  if (NULL == plugin->reactors) {
+    embb_free(plugin->waits);
+    plugin->waits = NULL;
+    return;
+  }
+
+  embb_atomic_init_int(&plugin->run, 1);
+
+  for (ii = 0; ii < num_reactors; ii++) {
+    embb_mtapi_io_reactor_t * reactor = &plugin->reactors[ii];
+    reactor->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    reactor->events = (struct epoll_event*)embb_alloc(
+      sizeof(struct epoll_event) * max_events);
+    err = EMBB_ERROR;
+    if (0 <= reactor->epoll_fd && NULL != reactor->events) {
+      err = embb_thread_create(
+        &reactor->thread, NULL, embb_mtapi_io_reactor_thread, reactor);
+    }
+    if (EMBB_SUCCESS != err) {
+      if (0 <= reactor->epoll_fd) {
+        close(reactor->epoll_fd);
+      }
+      embb_free(reactor->events);
+      embb_mtapi_io_reactors_finalize(ii);
+      embb_atomic_destroy_int(&plugin->run);
+      embb_free(plugin->waits);
+      plugin->waits = NULL;
+      return;
+    }
+  }
+
+  mtapi_status_set(status, MTAPI_SUCCESS);
+}
+
+void mtapi_io_plugin_finalize(
+  MTAPI_OUT mtapi_status_t* status) {
+  embb_mtapi_io_plugin_t * plugin = &embb_mtapi_io_plugin;
+  mtapi_uint_t ii;
+
+  if (NULL == plugin->reactors) {
+    mtapi_status_set(status, MTAPI_ERR_UNKNOWN);
+    return;
+  }
+
+  embb_mtapi_io_reactors_finalize(plugin->num_reactors);
+  embb_atomic_destroy_int(&plugin->run);
+
+  for (ii = 0; ii < plugin->max_waits; ii++) {
+    embb_atomic_destroy_int(&plugin->waits[ii].state);
+  }
+  embb_free(plugin->waits);
+  plugin->waits = NULL;
+  plugin->max_waits = 0;
+
+  mtapi_status_set(status, MTAPI_SUCCESS);
+}
+
+static void io_task_start(
+  MTAPI_IN mtapi_task_hndl_t task,
+  MTAPI_OUT mtapi_status_t* status) {
+  embb_mtapi_io_plugin_t * plugin = &embb_mtapi_io_plugin;
+  mtapi_status_t local_status = MTAPI_ERR_UNKNOWN;
+
+  if (embb_mtapi_node_is_initialized()) {
+    embb_mtapi_node_t * node = embb_mtapi_node_get_instance();
+
+    if (embb_mtapi_task_pool_is_handle_valid(node->task_pool, task) &&
+      task.id < plugin->max_waits) {
+      embb_mtapi_task_t * local_task =
+        embb_mtapi_task_pool_get_storage_for_handle(node->task_pool, task);
+
+      if (sizeof(mtapi_io_request_t) == local_task->arguments_size &&
+        MTAPI_NULL != local_task->arguments) {
+        embb_mtapi_io_wait_t * wait = &plugin->waits[task.id];
+        embb_mtapi_io_reactor_t * reactor;
+        struct epoll_event event;
+
+        wait->task = task;
+        memcpy(&wait->request, local_task->arguments,
+          sizeof(mtapi_io_request_t));
+        reactor = embb_mtapi_io_reactor_for_fd(wait->request.fd);
+
+        event.events = EPOLLONESHOT | EPOLLRDHUP;
+        if (wait->request.events & MTAPI_IO_READABLE) {
+          event.events |= EPOLLIN;
+        }
+        if (wait->request.events & MTAPI_IO_WRITABLE) {
+          event.events |= EPOLLOUT;
+        }
+        event.data.u64 = embb_mtapi_io_encode_handle(task);
+
+        embb_mtapi_task_set_state(local_task, MTAPI_TASK_RUNNING);
+        embb_atomic_store_int(
+          &wait->state, embb_mtapi_io_wait_state(task.tag));
+        if (0 == epoll_ctl(reactor->epoll_fd, EPOLL_CTL_ADD,
+          wait->request.fd, &event)) {
+          local_status = MTAPI_SUCCESS;
+        } else {
+          /* invalid descriptor or somebody is already waiting for it */
+          embb_atomic_store_int(&wait->state, 0);
+          local_status = MTAPI_ERR_PARAMETER;
+        }
+      } else {
+        local_status = MTAPI_ERR_PARAMETER;
+      }
+    }
+  }
+
+  mtapi_status_set(status, local_status);
+}
+
+static void io_task_cancel(
+  MTAPI_IN mtapi_task_hndl_t task,
+  MTAPI_OUT mtapi_status_t* status) {
+  embb_mtapi_io_plugin_t * plugin = &embb_mtapi_io_plugin;
+  mtapi_status_t local_status = MTAPI_ERR_UNKNOWN;
+
+  if (embb_mtapi_node_is_initialized()) {
+    embb_mtapi_node_t * node = embb_mtapi_node_get_instance();
+
+    if (embb_mtapi_task_pool_is_handle_valid(node->task_pool, task) &&
+      task.id < plugin->max_waits) {
+      embb_mtapi_task_t * local_task =
+        embb_mtapi_task_pool_get_storage_for_handle(node->task_pool, task);
+      embb_mtapi_io_wait_t * wait = &plugin->waits[task.id];
+      int state = embb_mtapi_io_wait_state(task.tag);
+
+      /* only a task still waiting for its descriptor can be canceled */
+      if (embb_atomic_compare_and_swap_int(&wait->state, &state, 0)) {
+        embb_mtapi_io_reactor_t * reactor =
+          embb_mtapi_io_reactor_for_fd(wait->request.fd);
+        epoll_ctl(reactor->epoll_fd, EPOLL_CTL_DEL, wait->request.fd, NULL);
+        embb_mtapi_io_finish_task(
+          local_task, node, MTAPI_ERR_ACTION_CANCELLED);
+        local_status = MTAPI_SUCCESS;
+      }
+    }
+  }
+
+  mtapi_status_set(status, local_status);
+}
+
+static void io_action_finalize(
+  MTAPI_IN mtapi_action_hndl_t action,
+  MTAPI_OUT mtapi_status_t* status) {
+  mtapi_status_t local_status = MTAPI_ERR_UNKNOWN;
+
+  if (embb_mtapi_node_is_initialized()) {
+    embb_mtapi_node_t * node = embb_mtapi_node_get_instance();
+    if (embb_mtapi_action_pool_is_handle_valid(node->action_pool, action)) {
+      embb_mtapi_action_t * local_action =
+        embb_mtapi_action_pool_get_storage_for_handle(
+          node->action_pool, action);
+
+      embb_free(local_action->plugin_data);
+      local_status = MTAPI_SUCCESS;
+    }
+  }
+
+  mtapi_status_set(status, local_status);
+}
+
+mtapi_action_hndl_t mtapi_io_action_create(
+  MTAPI_IN mtapi_job_id_t job_id,
+  MTAPI_IN mtapi_job_id_t continuation_job_id,
+  MTAPI_OUT mtapi_status_t* status) {
+  embb_mtapi_io_plugin_t * plugin = &embb_mtapi_io_plugin;
+  mtapi_status_t local_status = MTAPI_ERR_UNKNOWN;
+  mtapi_action_hndl_t action_hndl = { 0, EMBB_MTAPI_IDPOOL_INVALID_ID };
+  embb_mtapi_io_action_t * action;
+
+  if (NULL == plugin->reactors) {
+    mtapi_status_set(status, MTAPI_ERR_UNKNOWN);
+    return action_hndl;
+  }
+
+  action = (embb_mtapi_io_action_t*)embb_alloc(sizeof(embb_mtapi_io_action_t));
+  if (NULL != action) {
+    action->continuation_job_id = continuation_job_id;
+
+    action_hndl = mtapi_ext_plugin_action_create(
+      job_id,
+      io_task_start,
+      io_task_cancel,
+      io_action_finalize,
+      action,
+      NULL, 0, // no node local data
+      MTAPI_NULL,
+      &local_status);
+    if (MTAPI_SUCCESS != local_status) {
+      embb_free(action);
+    }
+  }
+
+  mtapi_status_set(status, local_status);
+  return action_hndl;
+}
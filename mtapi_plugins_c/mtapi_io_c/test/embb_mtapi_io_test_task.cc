@@ -0,0 +1,336 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <embb_mtapi_io_test_task.h>
+
+#include <embb/mtapi/c/mtapi_ext.h>
+#include <embb/mtapi/c/mtapi_io.h>
+#include <embb/base/c/internal/unused.h>
+
+#include <unistd.h>
+
+#define MTAPI_CHECK_STATUS(status) PT_ASSERT(MTAPI_SUCCESS == status)
+
+#define IO_DOMAIN 1
+#define IO_NODE 1
+#define IO_JOB 1
+#define IO_CONTINUATION_JOB 2
+
+#define IO_PIPES 16
+
+static void read_byte(
+  void const * arguments,
+  mtapi_size_t arguments_size,
+  void * result_buffer,
+  mtapi_size_t result_buffer_size,
+  void const * node_local_data,
+  mtapi_size_t node_local_data_size,
+  mtapi_task_context_t * context) {
+  EMBB_UNUSED(arguments_size);
+  EMBB_UNUSED(node_local_data);
+  EMBB_UNUSED(node_local_data_size);
+  mtapi_io_request_t const * request =
+    reinterpret_cast<mtapi_io_request_t const *>(arguments);
+  if (0 == (request->events & MTAPI_IO_READABLE) ||
+    1 != result_buffer_size ||
+    1 != read(request->fd, result_buffer, 1)) {
+    mtapi_context_status_set(context, MTAPI_ERR_ACTION_FAILED, MTAPI_NULL);
+  }
+}
+
+struct cancel_after_claim_struct {
+  mtapi_task_hndl_t task;
+  mtapi_status_t status;
+};
+
+static void cancel_io_task(
+  void const * arguments,
+  mtapi_size_t arguments_size,
+  void * result_buffer,
+  mtapi_size_t result_buffer_size,
+  void const * node_local_data,
+  mtapi_size_t node_local_data_size,
+  mtapi_task_context_t * context) {
+  EMBB_UNUSED(arguments);
+  EMBB_UNUSED(arguments_size);
+  EMBB_UNUSED(result_buffer);
+  EMBB_UNUSED(result_buffer_size);
+  EMBB_UNUSED(node_local_data_size);
+  EMBB_UNUSED(context);
+  cancel_after_claim_struct * data =
+    const_cast<cancel_after_claim_struct *>(
+      reinterpret_cast<cancel_after_claim_struct const *>(node_local_data));
+  // the reactor has claimed the wait before it starts the continuation, so
+  // this cancel races the completion of the I/O task and has to lose
+  mtapi_task_cancel(data->task, &data->status);
+}
+
+IoTaskTest::IoTaskTest() {
+  CreateUnit("mtapi io task test")
+    .Add(&IoTaskTest::TestBasic, this);
+}
+
+void IoTaskTest::TestBasic() {
+  mtapi_status_t status;
+
+  mtapi_initialize(
+    IO_DOMAIN,
+    IO_NODE,
+    MTAPI_DEFAULT_NODE_ATTRIBUTES,
+    MTAPI_NULL,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  mtapi_io_plugin_initialize(2, 16, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  // needs the first tasks of the node, which carry tag 0
+  TestCancelAfterClaim();
+  TestReady();
+  TestContinuation();
+  TestCancel();
+
+  mtapi_io_plugin_finalize(&status);
+  MTAPI_CHECK_STATUS(status);
+
+  mtapi_finalize(&status);
+  MTAPI_CHECK_STATUS(status);
+}
+
+void IoTaskTest::TestReady() {
+  mtapi_status_t status;
+  mtapi_action_hndl_t action;
+  mtapi_job_hndl_t job;
+  mtapi_task_hndl_t task[IO_PIPES];
+  mtapi_io_request_t request[IO_PIPES];
+  mtapi_uint_t ready[IO_PIPES];
+  int fds[IO_PIPES][2];
+
+  action = mtapi_io_action_create(
+    IO_JOB, MTAPI_IO_CONTINUATION_NONE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  job = mtapi_job_get(IO_JOB, IO_DOMAIN, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  for (int ii = 0; ii < IO_PIPES; ii++) {
+    PT_ASSERT_EQ(pipe(fds[ii]), 0);
+    request[ii].fd = fds[ii][0];
+    request[ii].events = MTAPI_IO_READABLE;
+    ready[ii] = 0;
+    task[ii] = mtapi_task_start(
+      MTAPI_TASK_ID_NONE, job,
+      &request[ii], sizeof(mtapi_io_request_t),
+      &ready[ii], sizeof(mtapi_uint_t),
+      MTAPI_DEFAULT_TASK_ATTRIBUTES, MTAPI_GROUP_NONE,
+      &status);
+    MTAPI_CHECK_STATUS(status);
+  }
+
+  // nothing was written yet, so no task may complete
+  mtapi_task_wait(task[0], 1, &status);
+  PT_ASSERT_EQ(status, MTAPI_TIMEOUT);
+
+  for (int ii = 0; ii < IO_PIPES; ii++) {
+    char value = static_cast<char>(ii);
+    PT_ASSERT_EQ(write(fds[ii][1], &value, 1), 1);
+  }
+
+  for (int ii = 0; ii < IO_PIPES; ii++) {
+    mtapi_task_wait(task[ii], MTAPI_INFINITE, &status);
+    MTAPI_CHECK_STATUS(status);
+    PT_EXPECT(0 != (ready[ii] & MTAPI_IO_READABLE));
+    close(fds[ii][0]);
+    close(fds[ii][1]);
+  }
+
+  mtapi_action_delete(action, MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+}
+
+void IoTaskTest::TestContinuation() {
+  mtapi_status_t status;
+  mtapi_action_hndl_t action, continuation_action;
+  mtapi_job_hndl_t job;
+  mtapi_task_hndl_t task[IO_PIPES];
+  mtapi_io_request_t request[IO_PIPES];
+  char result[IO_PIPES];
+  int fds[IO_PIPES][2];
+
+  continuation_action = mtapi_action_create(
+    IO_CONTINUATION_JOB, read_byte,
+    MTAPI_NULL, 0, MTAPI_DEFAULT_ACTION_ATTRIBUTES,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  action = mtapi_io_action_create(
+    IO_JOB, IO_CONTINUATION_JOB, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  job = mtapi_job_get(IO_JOB, IO_DOMAIN, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  for (int ii = 0; ii < IO_PIPES; ii++) {
+    PT_ASSERT_EQ(pipe(fds[ii]), 0);
+    request[ii].fd = fds[ii][0];
+    request[ii].events = MTAPI_IO_READABLE;
+    result[ii] = -1;
+    task[ii] = mtapi_task_start(
+      MTAPI_TASK_ID_NONE, job,
+      &request[ii], sizeof(mtapi_io_request_t),
+      &result[ii], 1,
+      MTAPI_DEFAULT_TASK_ATTRIBUTES, MTAPI_GROUP_NONE,
+      &status);
+    MTAPI_CHECK_STATUS(status);
+  }
+
+  for (int ii = IO_PIPES - 1; ii >= 0; ii--) {
+    char value = static_cast<char>(ii);
+    PT_ASSERT_EQ(write(fds[ii][1], &value, 1), 1);
+  }
+
+  for (int ii = 0; ii < IO_PIPES; ii++) {
+    mtapi_task_wait(task[ii], MTAPI_INFINITE, &status);
+    MTAPI_CHECK_STATUS(status);
+    PT_EXPECT_EQ(result[ii], static_cast<char>(ii));
+    close(fds[ii][0]);
+    close(fds[ii][1]);
+  }
+
+  mtapi_action_delete(action, MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  mtapi_action_delete(continuation_action, MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+}
+
+void IoTaskTest::TestCancel() {
+  mtapi_status_t status;
+  mtapi_action_hndl_t action;
+  mtapi_job_hndl_t job;
+  mtapi_task_hndl_t task;
+  mtapi_io_request_t request;
+  int fds[2];
+
+  action = mtapi_io_action_create(
+    IO_JOB, MTAPI_IO_CONTINUATION_NONE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  job = mtapi_job_get(IO_JOB, IO_DOMAIN, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  PT_ASSERT_EQ(pipe(fds), 0);
+  request.fd = fds[0];
+  request.events = MTAPI_IO_READABLE;
+  task = mtapi_task_start(
+    MTAPI_TASK_ID_NONE, job,
+    &request, sizeof(mtapi_io_request_t),
+    MTAPI_NULL, 0,
+    MTAPI_DEFAULT_TASK_ATTRIBUTES, MTAPI_GROUP_NONE,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  mtapi_task_wait(task, 1, &status);
+  PT_ASSERT_EQ(status, MTAPI_TIMEOUT);
+
+  mtapi_task_cancel(task, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  mtapi_task_wait(task, MTAPI_INFINITE, &status);
+  PT_ASSERT_EQ(status, MTAPI_ERR_ACTION_CANCELLED);
+
+  // the descriptor can be waited for again after cancellation
+  task = mtapi_task_start(
+    MTAPI_TASK_ID_NONE, job,
+    &request, sizeof(mtapi_io_request_t),
+    MTAPI_NULL, 0,
+    MTAPI_DEFAULT_TASK_ATTRIBUTES, MTAPI_GROUP_NONE,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  char value = 1;
+  PT_ASSERT_EQ(write(fds[1], &value, 1), 1);
+
+  mtapi_task_wait(task, MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  close(fds[0]);
+  close(fds[1]);
+
+  mtapi_action_delete(action, MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+}
+
+void IoTaskTest::TestCancelAfterClaim() {
+  mtapi_status_t status;
+  mtapi_action_hndl_t action, continuation_action;
+  mtapi_job_hndl_t job;
+  mtapi_io_request_t request;
+  cancel_after_claim_struct data = cancel_after_claim_struct();
+  int fds[2];
+
+  continuation_action = mtapi_action_create(
+    IO_CONTINUATION_JOB, cancel_io_task,
+    &data, sizeof(data), MTAPI_DEFAULT_ACTION_ATTRIBUTES,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  action = mtapi_io_action_create(
+    IO_JOB, IO_CONTINUATION_JOB, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  job = mtapi_job_get(IO_JOB, IO_DOMAIN, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  PT_ASSERT_EQ(pipe(fds), 0);
+  request.fd = fds[0];
+  request.events = MTAPI_IO_READABLE;
+  data.status = MTAPI_ERR_UNKNOWN;
+  data.task = mtapi_task_start(
+    MTAPI_TASK_ID_NONE, job,
+    &request, sizeof(mtapi_io_request_t),
+    MTAPI_NULL, 0,
+    MTAPI_DEFAULT_TASK_ATTRIBUTES, MTAPI_GROUP_NONE,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+  PT_ASSERT_EQ(data.task.tag, static_cast<mtapi_uint_t>(0));
+
+  char value = 1;
+  PT_ASSERT_EQ(write(fds[1], &value, 1), 1);
+
+  mtapi_task_wait(data.task, MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+  PT_EXPECT(MTAPI_SUCCESS != data.status);
+
+  close(fds[0]);
+  close(fds[1]);
+
+  mtapi_action_delete(action, MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  mtapi_action_delete(continuation_action, MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+}
@@ -0,0 +1,960 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Measures remote task throughput and latency of the MTAPI network plugin.
+//
+// By default a server and a client node share one process and talk over
+// loopback, with --server and --client they run in separate processes.
+// For every number of io threads and flush delay, the plugin is initialized
+// anew. For every combination of argument size, concurrency and number of
+// connections, the client then keeps the given number of echo tasks in flight
+// and reports one line of CSV or one JSON object. A server only uses the first
+// number of io threads and flush delay. The effect of coalescing small packets
+// shows with e.g. --sizes 100 --flush-delays 0,10,50,200. Large arguments
+// run fewer tasks, so that no configuration moves more than the given number
+// of argument bytes.
+//
+// With --servers, the client spreads its tasks over that many servers on
+// consecutive ports through one pooled action. Locally, the additional
+// servers are forked into processes of their own. Every server writes its
+// port into the first bytes of a result, and the balance reported is the
+// number of tasks of the least loaded server divided by that of the most
+// loaded one.
+//
+// With --transports tcp,unix, every configuration runs over loopback TCP and
+// over a unix domain socket, whose name is the given socket path followed by
+// the port. Forked servers serve one transport each, a server started with
+// --server only serves the first transport.
+//
+// With glibc, every server counts the allocations of its process and writes
+// the count next to its port, which yields the allocations per task on the
+// server side for arguments of at least 8 bytes. Locally, the first server
+// shares its process with the client, so run --server and --client apart to
+// count the server alone.
+//
+// With --large-every, every given task carries arguments and results of the
+// large size instead, which are streamed as they exceed the buffer size of
+// the plugin, e.g. --sizes 1024 --large-every 100 --max-bytes 1073741824 for
+// mixed 1 KB and 64 MB tasks. The peak resident set size of the process is
+// reported as the memory footprint, it only grows over the configurations
+// of one run.
+
+#include <embb/mtapi/c/mtapi.h>
+#include <embb/mtapi/c/mtapi_network.h>
+#include <embb/base/c/atomic.h>
+#include <embb/base/c/condition_variable.h>
+#include <embb/base/c/mutex.h>
+#include <embb/base/c/time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#define BENCHMARK_DOMAIN 1
+#define BENCHMARK_NODE 1
+#define BENCHMARK_REMOTE_JOB 1
+// one local job per number of connections, the first one is this
+#define BENCHMARK_LOCAL_JOB 2
+
+struct BenchmarkOptions {
+  enum Mode { kLocal, kServer, kClient };
+
+  Mode mode;
+  std::vector<std::string> transports;
+  std::string host;
+  std::string socket;
+  int port;
+  std::vector<int> sizes;
+  std::vector<int> concurrencies;
+  std::vector<int> connections;
+  int servers;
+  int tasks;
+  int warmup;
+  int max_bytes;
+  int large_size;
+  int large_every;
+  int buffer_size;
+  std::vector<int> io_threads;
+  std::vector<int> flush_delays;
+  int duration;
+  bool json;
+};
+
+struct BenchmarkResult {
+  char const * transport;
+  int io_threads;
+  int flush_delay;
+  int size;
+  int concurrency;
+  int connections;
+  int servers;
+  int tasks;
+  double bytes;
+  double seconds;
+  double balance;
+  double allocations;
+  double p50;
+  double p99;
+  double p999;
+  double cpu;
+  double peak_rss;
+};
+
+// tasks a server ran and its allocation counts seen first and last
+struct ServerCount {
+  int tasks;
+  unsigned int first_allocations;
+  unsigned int last_allocations;
+};
+
+// port of this server, passed to the echo action as node local data
+static int server_port;
+
+#ifdef __GLIBC__
+// counts the allocations of this process by replacing malloc, glibc
+// provides its own implementation under these names
+extern "C" {
+void * __libc_malloc(size_t size);
+void * __libc_calloc(size_t count, size_t size);
+void * __libc_realloc(void * pointer, size_t size);
+void __libc_free(void * pointer);
+}
+
+static EMBB_BASE_BASIC_TYPE_ATOMIC_4 allocations = 0;
+
+extern "C" void * malloc(size_t size) {
+  embb_internal__atomic_fetch_and_add_4(&allocations, 1);
+  return __libc_malloc(size);
+}
+
+extern "C" void * calloc(size_t count, size_t size) {
+  embb_internal__atomic_fetch_and_add_4(&allocations, 1);
+  return __libc_calloc(count, size);
+}
+
+extern "C" void * realloc(void * pointer, size_t size) {
+  embb_internal__atomic_fetch_and_add_4(&allocations, 1);
+  return __libc_realloc(pointer, size);
+}
+
+extern "C" void free(void * pointer) {
+  __libc_free(pointer);
+}
+
+static unsigned int allocation_count() {
+  return static_cast<unsigned int>(
+    embb_internal__atomic_load_4(&allocations));
+}
+#else
+static unsigned int allocation_count() {
+  return 0;
+}
+#endif
+
+// pipes of a forked server, it signals readiness on the first and serves
+// until the second one is closed
+static int server_ready_fd = -1;
+static int server_control_fd = -1;
+
+static void echo(
+  void const * arguments,
+  mtapi_size_t arguments_size,
+  void * result_buffer,
+  mtapi_size_t result_buffer_size,
+  void const * node_local_data,
+  mtapi_size_t /*node_local_data_size*/,
+  mtapi_task_context_t * /*context*/) {
+  memcpy(result_buffer, arguments,
+    std::min(arguments_size, result_buffer_size));
+  // tells the client which server ran the task and how often it allocated
+  if (sizeof(int) <= result_buffer_size) {
+    memcpy(result_buffer, node_local_data, sizeof(int));
+  }
+  if (sizeof(int) + sizeof(unsigned int) <= result_buffer_size) {
+    unsigned int count = allocation_count();
+    memcpy(static_cast<char*>(result_buffer) + sizeof(int), &count,
+      sizeof(count));
+  }
+}
+
+// monotonic wall clock time in microseconds
+static double wall_time() {
+#ifdef _WIN32
+  LARGE_INTEGER frequency;
+  LARGE_INTEGER counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return static_cast<double>(counter.QuadPart) * 1e6 /
+    static_cast<double>(frequency.QuadPart);
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<double>(now.tv_sec) * 1e6 +
+    static_cast<double>(now.tv_nsec) / 1e3;
+#endif
+}
+
+// user and system time used by this process in microseconds
+static double cpu_time() {
+#ifdef _WIN32
+  FILETIME creation, exit, kernel, user;
+  ULARGE_INTEGER kernel_time, user_time;
+  GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+  kernel_time.LowPart = kernel.dwLowDateTime;
+  kernel_time.HighPart = kernel.dwHighDateTime;
+  user_time.LowPart = user.dwLowDateTime;
+  user_time.HighPart = user.dwHighDateTime;
+  return static_cast<double>(kernel_time.QuadPart + user_time.QuadPart) / 10;
+#else
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return static_cast<double>(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) *
+    1e6 + static_cast<double>(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+#endif
+}
+
+// lets the io threads and workers serve for the given number of seconds
+static void serve(int seconds) {
+#ifndef _WIN32
+  if (0 <= server_control_fd) {
+    char byte = 1;
+    if (1 == write(server_ready_fd, &byte, 1)) {
+      while (0 < read(server_control_fd, &byte, 1)) {
+      }
+    }
+    return;
+  }
+#endif
+
+  embb_mutex_t mutex;
+  embb_condition_t condition;
+  embb_duration_t duration;
+  embb_time_t end, now;
+
+  embb_duration_set_seconds(&duration,
+    static_cast<unsigned long long>(seconds));
+  embb_time_in(&end, &duration);
+  embb_mutex_init(&mutex, EMBB_MUTEX_PLAIN);
+  embb_condition_init(&condition);
+  embb_mutex_lock(&mutex);
+  do {
+    embb_condition_wait_until(&condition, &mutex, &end);
+    embb_time_now(&now);
+  } while (0 > embb_time_compare(&now, &end));
+  embb_mutex_unlock(&mutex);
+  embb_condition_destroy(&condition);
+  embb_mutex_destroy(&mutex);
+}
+
+// peak resident set size of this process in megabytes, 0 if unknown
+static double peak_rss() {
+#ifdef _WIN32
+  return 0.0;
+#else
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  // bytes instead of kilobytes
+  return static_cast<double>(usage.ru_maxrss) / (1024.0 * 1024.0);
+#else
+  return static_cast<double>(usage.ru_maxrss) / 1024.0;
+#endif
+#endif
+}
+
+static double percentile(std::vector<double> const & sorted, double p) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  size_t index = static_cast<size_t>(p * static_cast<double>(sorted.size()));
+  if (index >= sorted.size()) {
+    index = sorted.size() - 1;
+  }
+  return sorted[index];
+}
+
+static bool parse_list(char const * text, std::vector<int> * list,
+  int min = 1) {
+  list->clear();
+  while (*text) {
+    char * end;
+    long value = strtol(text, &end, 10);
+    if (end == text || value < min) {
+      return false;
+    }
+    list->push_back(static_cast<int>(value));
+    text = (',' == *end) ? end + 1 : end;
+  }
+  return !list->empty();
+}
+
+static bool parse_transports(char const * text,
+  std::vector<std::string> * list) {
+  list->clear();
+  while (*text) {
+    char const * end = strchr(text, ',');
+    if (NULL == end) {
+      end = text + strlen(text);
+    }
+    std::string transport(text, end);
+#ifdef _WIN32
+    // unix domain sockets are not available
+    if ("tcp" != transport) {
+#else
+    if ("tcp" != transport && "unix" != transport) {
+#endif
+      return false;
+    }
+    list->push_back(transport);
+    text = (',' == *end) ? end + 1 : end;
+  }
+  return !list->empty();
+}
+
+// address of the server on the given port, as the plugin expects it
+static std::string server_address(
+  BenchmarkOptions const & options,
+  std::string const & transport,
+  int port) {
+  if ("unix" != transport) {
+    return options.host;
+  }
+  char suffix[16];
+  snprintf(suffix, sizeof(suffix), ".%d", port);
+  return "unix:" + options.socket + suffix;
+}
+
+static void usage(char const * name) {
+  fprintf(stderr,
+    "usage: %s [options]\n"
+    "  --server            only run the server node\n"
+    "  --client            only run the client node\n"
+    "  --transports LIST   tcp and/or unix (tcp)\n"
+    "  --host HOST         address to listen on or connect to"
+    " (127.0.0.1)\n"
+    "  --socket PATH       unix socket path prefix"
+    " (embb_mtapi_network_benchmark)\n"
+    "  --port PORT         port to listen on or connect to (12400)\n"
+    "  --sizes LIST        argument sizes in bytes"
+    " (16,4096,65536,4194304)\n"
+    "  --concurrency LIST  tasks kept in flight (1,16,64)\n"
+    "  --connections LIST  connections to each server (1,4,16,64)\n"
+    "  --servers N         servers on consecutive ports (1)\n"
+    "  --tasks N           measured tasks per configuration (10000)\n"
+    "  --warmup N          unmeasured tasks per configuration (1000)\n"
+    "  --max-bytes N       argument bytes per configuration at most"
+    " (268435456)\n"
+    "  --large-size N      argument size of large tasks in bytes (67108864)\n"
+    "  --large-every N     every N-th task is large, 0 for none (0)\n"
+    "  --buffer-size N     receive buffer size of the plugin (70000)\n"
+    "  --io-threads LIST   io threads of the plugin (1)\n"
+    "  --flush-delays LIST microseconds the plugin waits to coalesce packets"
+    " (0)\n"
+    "  --duration S        seconds a server runs (60)\n"
+    "  --json              print JSON instead of CSV\n",
+    name);
+}
+
+static bool parse_options(int argc, char ** argv, BenchmarkOptions * options) {
+  options->mode = BenchmarkOptions::kLocal;
+  parse_transports("tcp", &options->transports);
+  options->host = "127.0.0.1";
+  options->socket = "embb_mtapi_network_benchmark";
+  options->port = 12400;
+  parse_list("16,4096,65536,4194304", &options->sizes);
+  parse_list("1,16,64", &options->concurrencies);
+  parse_list("1,4,16,64", &options->connections);
+  options->servers = 1;
+  options->tasks = 10000;
+  options->warmup = 1000;
+  options->max_bytes = 268435456;
+  options->large_size = 67108864;
+  options->large_every = 0;
+  options->buffer_size = 70000;
+  parse_list("1", &options->io_threads);
+  parse_list("0", &options->flush_delays, 0);
+  options->duration = 60;
+  options->json = false;
+
+  for (int ii = 1; ii < argc; ii++) {
+    std::string option = argv[ii];
+    char const * value = (ii + 1 < argc) ? argv[ii + 1] : NULL;
+    bool ok = true;
+    if ("--server" == option) {
+      options->mode = BenchmarkOptions::kServer;
+      continue;
+    } else if ("--client" == option) {
+      options->mode = BenchmarkOptions::kClient;
+      continue;
+    } else if ("--json" == option) {
+      options->json = true;
+      continue;
+    } else if (NULL == value) {
+      ok = false;
+    } else if ("--transports" == option) {
+      ok = parse_transports(value, &options->transports);
+    } else if ("--host" == option) {
+      options->host = value;
+    } else if ("--socket" == option) {
+      options->socket = value;
+    } else if ("--port" == option) {
+      options->port = atoi(value);
+    } else if ("--sizes" == option) {
+      ok = parse_list(value, &options->sizes);
+    } else if ("--concurrency" == option) {
+      ok = parse_list(value, &options->concurrencies);
+    } else if ("--connections" == option) {
+      ok = parse_list(value, &options->connections);
+    } else if ("--servers" == option) {
+      options->servers = atoi(value);
+    } else if ("--tasks" == option) {
+      options->tasks = atoi(value);
+    } else if ("--warmup" == option) {
+      options->warmup = atoi(value);
+    } else if ("--max-bytes" == option) {
+      options->max_bytes = atoi(value);
+    } else if ("--large-size" == option) {
+      options->large_size = atoi(value);
+    } else if ("--large-every" == option) {
+      options->large_every = atoi(value);
+    } else if ("--buffer-size" == option) {
+      options->buffer_size = atoi(value);
+    } else if ("--io-threads" == option) {
+      ok = parse_list(value, &options->io_threads);
+    } else if ("--flush-delays" == option) {
+      ok = parse_list(value, &options->flush_delays, 0);
+    } else if ("--duration" == option) {
+      options->duration = atoi(value);
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      return false;
+    }
+    ii++;
+  }
+
+#ifdef _WIN32
+  // additional local servers are forked
+  if (BenchmarkOptions::kLocal == options->mode && 1 < options->servers) {
+    return false;
+  }
+#endif
+  return 0 < options->port && 0 < options->servers &&
+    options->port + options->servers <= 65536 &&
+    0 < options->tasks && 0 <= options->warmup && 0 < options->max_bytes &&
+    0 < options->large_size && 0 <= options->large_every &&
+    0 <= options->duration;
+}
+
+// keeps concurrency tasks in flight until count tasks completed, latencies
+// are taken when a task is waited for, which happens in start order. Every
+// large_every-th task uses large_size bytes, the buffers for their results
+// are reused once the task completed.
+static bool run_tasks(
+  mtapi_job_hndl_t job,
+  int size,
+  int large_size,
+  int large_every,
+  int concurrency,
+  int count,
+  std::vector<double> * latencies,
+  std::map<int, ServerCount> * served) {
+  std::vector<char> arguments(static_cast<size_t>(
+    (0 < large_every) ? std::max(size, large_size) : size), 'x');
+  std::vector<char> results(
+    static_cast<size_t>(size) * static_cast<size_t>(concurrency));
+  std::vector<mtapi_task_hndl_t> tasks(static_cast<size_t>(concurrency));
+  std::vector<double> starts(static_cast<size_t>(concurrency));
+  std::vector<int> sizes(static_cast<size_t>(concurrency));
+  std::vector<char*> slot_results(static_cast<size_t>(concurrency));
+  std::vector<char*> large_results;
+  std::vector<char*> free_large_results;
+  mtapi_status_t status;
+  int started = 0;
+  int completed = 0;
+  bool ok = true;
+
+  while (ok && completed < count) {
+    int slot = started % concurrency;
+    if (started < count && started - completed < concurrency) {
+      if (0 < large_every && large_every - 1 == started % large_every) {
+        if (free_large_results.empty()) {
+          large_results.push_back(new char[large_size]);
+          free_large_results.push_back(large_results.back());
+        }
+        sizes[slot] = large_size;
+        slot_results[slot] = free_large_results.back();
+        free_large_results.pop_back();
+      } else {
+        sizes[slot] = size;
+        slot_results[slot] =
+          &results[static_cast<size_t>(slot) * static_cast<size_t>(size)];
+      }
+      starts[slot] = wall_time();
+      tasks[slot] = mtapi_task_start(
+        MTAPI_TASK_ID_NONE, job,
+        &arguments[0], static_cast<mtapi_size_t>(sizes[slot]),
+        slot_results[slot], static_cast<mtapi_size_t>(sizes[slot]),
+        MTAPI_DEFAULT_TASK_ATTRIBUTES, MTAPI_GROUP_NONE, &status);
+      ok = (MTAPI_SUCCESS == status);
+      started++;
+    } else {
+      slot = completed % concurrency;
+      mtapi_task_wait(tasks[slot], MTAPI_INFINITE, &status);
+      ok = (MTAPI_SUCCESS == status);
+      if (NULL != latencies) {
+        latencies->push_back(wall_time() - starts[slot]);
+      }
+      char const * result = slot_results[slot];
+      if (ok && NULL != served &&
+        sizeof(int) <= static_cast<size_t>(sizes[slot])) {
+        int port;
+        memcpy(&port, result, sizeof(int));
+        ServerCount & count = (*served)[port];
+        if (sizeof(int) + sizeof(unsigned int) <=
+          static_cast<size_t>(sizes[slot])) {
+          memcpy(&count.last_allocations, result + sizeof(int),
+            sizeof(unsigned int));
+          if (0 == count.tasks) {
+            count.first_allocations = count.last_allocations;
+          }
+        }
+        count.tasks++;
+      }
+      if (sizes[slot] != size) {
+        free_large_results.push_back(slot_results[slot]);
+      }
+      completed++;
+    }
+  }
+
+  for (size_t ii = 0; ii < large_results.size(); ii++) {
+    delete[] large_results[ii];
+  }
+  return ok;
+}
+
+// argument bytes the given number of tasks move, counting large tasks
+static double task_bytes(BenchmarkOptions const & options, int tasks,
+  int size) {
+  int large = (0 < options.large_every) ? tasks / options.large_every : 0;
+  return static_cast<double>(size) * static_cast<double>(tasks - large) +
+    static_cast<double>(options.large_size) * static_cast<double>(large);
+}
+
+// limits the number of tasks, so that they move at most max_bytes arguments
+static int limit_tasks(BenchmarkOptions const & options, int tasks, int size) {
+  double average = task_bytes(options, tasks, size) / tasks;
+  return std::min(tasks, std::max(1,
+    static_cast<int>(static_cast<double>(options.max_bytes) / average)));
+}
+
+static bool run_configuration(
+  BenchmarkOptions const & options,
+  mtapi_job_id_t job_id,
+  int size,
+  int concurrency,
+  int connections,
+  BenchmarkResult * result) {
+  mtapi_status_t status;
+  std::vector<double> latencies;
+  std::map<int, ServerCount> served;
+
+  mtapi_job_hndl_t job = mtapi_job_get(job_id, BENCHMARK_DOMAIN, &status);
+
+  int warmup = limit_tasks(options, options.warmup, size);
+  int tasks = limit_tasks(options, options.tasks, size);
+  bool ok = (MTAPI_SUCCESS == status) &&
+    run_tasks(job, size, options.large_size, options.large_every,
+      concurrency, warmup, NULL, NULL);
+
+  latencies.reserve(static_cast<size_t>(tasks));
+  double wall_start = wall_time();
+  double cpu_start = cpu_time();
+  ok = ok && run_tasks(job, size, options.large_size, options.large_every,
+    concurrency, tasks, &latencies, &served);
+  double cpu = cpu_time() - cpu_start;
+  double wall = wall_time() - wall_start;
+
+  if (!ok) {
+    fprintf(stderr, "tasks failed\n");
+    return false;
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  result->size = size;
+  result->concurrency = concurrency;
+  result->connections = connections;
+  result->servers = options.servers;
+  // servers that ran no task count as least loaded
+  int least = (static_cast<int>(served.size()) < options.servers) ?
+    0 : tasks;
+  int most = 0;
+  // the allocations between the first and the last result of each server
+  // belong to one task less than that server ran
+  unsigned int allocations = 0;
+  int spans = 0;
+  for (std::map<int, ServerCount>::const_iterator it = served.begin();
+    it != served.end(); ++it) {
+    least = std::min(least, it->second.tasks);
+    most = std::max(most, it->second.tasks);
+    allocations +=
+      it->second.last_allocations - it->second.first_allocations;
+    spans += it->second.tasks - 1;
+  }
+  result->balance = (0 < most) ?
+    static_cast<double>(least) / static_cast<double>(most) : 0.0;
+  // -1 if the arguments are too small to carry the count
+  result->allocations = (sizeof(int) + sizeof(unsigned int) <=
+    static_cast<size_t>(size) && 0 < spans) ?
+    static_cast<double>(allocations) / static_cast<double>(spans) : -1.0;
+  result->tasks = tasks;
+  // arguments go out and the same amount of results comes back
+  result->bytes = 2.0 * task_bytes(options, tasks, size);
+  result->seconds = wall / 1e6;
+  result->p50 = percentile(latencies, 0.5);
+  result->p99 = percentile(latencies, 0.99);
+  result->p999 = percentile(latencies, 0.999);
+  result->cpu = cpu / tasks;
+  result->peak_rss = peak_rss();
+  return true;
+}
+
+static void print_result(
+  BenchmarkOptions const & options,
+  BenchmarkResult const & result,
+  bool first) {
+  double tasks_per_second = result.tasks / result.seconds;
+  double megabytes_per_second =
+    result.bytes / result.seconds / (1024.0 * 1024.0);
+  int large_size = (0 < options.large_every) ? options.large_size : 0;
+  char const * mode =
+    (BenchmarkOptions::kLocal == options.mode) ? "local" : "client";
+
+  if (options.json) {
+    printf("%s\n  {\"mode\": \"%s\", \"transport\": \"%s\", "
+      "\"io_threads\": %d, \"flush_delay_us\": %d, \"argument_size\": %d, "
+      "\"concurrency\": %d, \"connections\": %d, \"servers\": %d, "
+      "\"tasks\": %d, \"seconds\": %.6f, \"tasks_per_second\": %.1f, "
+      "\"megabytes_per_second\": %.3f, \"p50_us\": %.1f, "
+      "\"p99_us\": %.1f, \"p999_us\": %.1f, \"cpu_us_per_task\": %.2f, "
+      "\"balance\": %.3f, \"allocations_per_task\": %.2f, "
+      "\"large_size\": %d, \"large_every\": %d, \"peak_rss_mb\": %.1f}",
+      first ? "[" : ",", mode, result.transport, result.io_threads,
+      result.flush_delay, result.size, result.concurrency,
+      result.connections, result.servers, result.tasks, result.seconds,
+      tasks_per_second, megabytes_per_second, result.p50, result.p99,
+      result.p999, result.cpu, result.balance, result.allocations,
+      large_size, options.large_every, result.peak_rss);
+  } else {
+    if (first) {
+      printf("mode,transport,io_threads,flush_delay_us,argument_size,"
+        "concurrency,connections,servers,tasks,seconds,tasks_per_second,"
+        "megabytes_per_second,p50_us,p99_us,p999_us,cpu_us_per_task,"
+        "balance,allocations_per_task,large_size,large_every,peak_rss_mb\n");
+    }
+    printf("%s,%s,%d,%d,%d,%d,%d,%d,%d,%.6f,%.1f,%.3f,%.1f,%.1f,%.1f,%.2f,"
+      "%.3f,%.2f,%d,%d,%.1f\n",
+      mode, result.transport, result.io_threads, result.flush_delay,
+      result.size, result.concurrency, result.connections, result.servers,
+      result.tasks, result.seconds, tasks_per_second, megabytes_per_second,
+      result.p50, result.p99, result.p999, result.cpu, result.balance,
+      result.allocations, large_size, options.large_every, result.peak_rss);
+  }
+  fflush(stdout);
+}
+
+// initializes the plugin with the given transport, number of io threads and
+// flush delay and runs all configurations on it, or serves for the given
+// duration
+static bool run_plugin(
+  BenchmarkOptions const & options,
+  std::string const & transport,
+  int io_threads,
+  int flush_delay,
+  bool * first) {
+  mtapi_status_t status;
+  mtapi_network_plugin_attributes_t plugin_attr;
+  mtapi_action_hndl_t echo_action = { 0, 0 };
+  std::vector<mtapi_action_hndl_t> actions;
+  bool ok = true;
+
+  int total_connections = 0;
+  for (size_t ii = 0; ii < options.connections.size(); ii++) {
+    total_connections += options.connections[ii];
+  }
+
+  mtapi_network_pluginattr_init(&plugin_attr, &status);
+  mtapi_uint_t threads = static_cast<mtapi_uint_t>(io_threads);
+  mtapi_network_pluginattr_set(&plugin_attr, MTAPI_NETWORK_IO_THREADS,
+    &threads, MTAPI_NETWORK_IO_THREADS_SIZE, &status);
+  mtapi_uint_t delay = static_cast<mtapi_uint_t>(flush_delay);
+  mtapi_network_pluginattr_set(&plugin_attr, MTAPI_NETWORK_FLUSH_DELAY,
+    &delay, MTAPI_NETWORK_FLUSH_DELAY_SIZE, &status);
+  // a client only node listens on an ephemeral port it never uses, and on
+  // TCP, as it must not take the socket of the server
+  std::string address = (BenchmarkOptions::kClient == options.mode) ?
+    options.host : server_address(options, transport, options.port);
+  mtapi_network_plugin_initialize_with_attributes(
+    const_cast<char*>(address.c_str()),
+    static_cast<mtapi_uint16_t>(
+      (BenchmarkOptions::kClient == options.mode) ? 0 : options.port),
+    static_cast<mtapi_uint16_t>(total_connections + 16),
+    static_cast<mtapi_size_t>(options.buffer_size), &plugin_attr, &status);
+  if (MTAPI_SUCCESS != status) {
+    fprintf(stderr, "could not initialize the network plugin\n");
+    return false;
+  }
+
+  if (BenchmarkOptions::kClient != options.mode) {
+    server_port = options.port;
+    echo_action = mtapi_action_create(BENCHMARK_REMOTE_JOB, echo,
+      &server_port, sizeof(server_port), MTAPI_DEFAULT_ACTION_ATTRIBUTES,
+      &status);
+    ok = (MTAPI_SUCCESS == status);
+  }
+
+  if (ok && BenchmarkOptions::kServer == options.mode) {
+    if (0 > server_control_fd) {
+      fprintf(stderr, "serving on %s:%d for %d seconds\n",
+        address.c_str(), options.port, options.duration);
+    }
+    serve(options.duration);
+  } else if (ok) {
+    std::vector<std::string> hosts;
+    std::vector<mtapi_network_endpoint_t> endpoints(
+      static_cast<size_t>(options.servers));
+    for (int ii = 0; ii < options.servers; ii++) {
+      hosts.push_back(server_address(options, transport, options.port + ii));
+    }
+    for (int ii = 0; ii < options.servers; ii++) {
+      endpoints[ii].host = hosts[ii].c_str();
+      endpoints[ii].port = static_cast<mtapi_uint16_t>(options.port + ii);
+    }
+    for (size_t kk = 0; ok && kk < options.connections.size(); kk++) {
+      mtapi_action_hndl_t action = mtapi_network_action_create_pooled(
+        BENCHMARK_DOMAIN, static_cast<mtapi_job_id_t>(BENCHMARK_LOCAL_JOB + kk),
+        BENCHMARK_REMOTE_JOB, &endpoints[0],
+        static_cast<mtapi_uint_t>(options.servers),
+        static_cast<mtapi_uint_t>(options.connections[kk]), &status);
+      if (MTAPI_SUCCESS == status) {
+        actions.push_back(action);
+      } else {
+        fprintf(stderr, "could not connect to %s:%d\n",
+          hosts[0].c_str(), options.port);
+        ok = false;
+      }
+    }
+
+    for (size_t ii = 0; ok && ii < options.sizes.size(); ii++) {
+      for (size_t jj = 0; ok && jj < options.concurrencies.size(); jj++) {
+        for (size_t kk = 0; ok && kk < options.connections.size(); kk++) {
+          BenchmarkResult result;
+          ok = run_configuration(options,
+            static_cast<mtapi_job_id_t>(BENCHMARK_LOCAL_JOB + kk),
+            options.sizes[ii], options.concurrencies[jj],
+            options.connections[kk], &result);
+          if (ok) {
+            result.transport = transport.c_str();
+            result.io_threads = io_threads;
+            result.flush_delay = flush_delay;
+            print_result(options, result, *first);
+            *first = false;
+          }
+        }
+      }
+    }
+  }
+
+  for (size_t kk = 0; kk < actions.size(); kk++) {
+    mtapi_action_delete(actions[kk], MTAPI_INFINITE, &status);
+  }
+  if (BenchmarkOptions::kClient != options.mode) {
+    mtapi_action_delete(echo_action, MTAPI_INFINITE, &status);
+  }
+  mtapi_network_plugin_finalize(&status);
+
+  return ok;
+}
+
+static bool initialize_node(BenchmarkOptions const & options) {
+  mtapi_status_t status;
+  mtapi_node_attributes_t node_attr;
+
+  int max_concurrency = *std::max_element(
+    options.concurrencies.begin(), options.concurrencies.end());
+
+  // in-flight tasks use a task on the client and one on the server, and the
+  // main thread must not run tasks while it measures
+  mtapi_uint_t max_tasks =
+    static_cast<mtapi_uint_t>(std::max(1024, 4 * max_concurrency));
+  mtapi_nodeattr_init(&node_attr, &status);
+  mtapi_nodeattr_set(&node_attr, MTAPI_NODE_MAX_TASKS,
+    &max_tasks, MTAPI_NODE_MAX_TASKS_SIZE, &status);
+  mtapi_nodeattr_set(&node_attr, MTAPI_NODE_QUEUE_LIMIT,
+    &max_tasks, MTAPI_NODE_QUEUE_LIMIT_SIZE, &status);
+  mtapi_nodeattr_set(&node_attr, MTAPI_NODE_REUSE_MAIN_THREAD,
+    MTAPI_ATTRIBUTE_VALUE(MTAPI_FALSE), MTAPI_ATTRIBUTE_POINTER_AS_VALUE,
+    &status);
+  mtapi_initialize(BENCHMARK_DOMAIN, BENCHMARK_NODE, &node_attr, MTAPI_NULL,
+    &status);
+  if (MTAPI_SUCCESS != status) {
+    fprintf(stderr, "could not initialize MTAPI\n");
+    return false;
+  }
+  return true;
+}
+
+#ifndef _WIN32
+// forks a server on the given transport and port that serves until the
+// write end of the control pipe is closed, returns its process id once it is
+// ready or -1 on failure
+static pid_t fork_server(
+  BenchmarkOptions const & options,
+  std::string const & transport,
+  int port,
+  int const control[2]) {
+  int ready[2];
+  char byte;
+  if (0 != pipe(ready)) {
+    return -1;
+  }
+  pid_t server = fork();
+  if (0 == server) {
+    BenchmarkOptions server_options = options;
+    server_options.mode = BenchmarkOptions::kServer;
+    server_options.port = port;
+    server_ready_fd = ready[1];
+    server_control_fd = control[0];
+    close(ready[0]);
+    close(control[1]);
+    bool first = true;
+    bool ok = initialize_node(server_options) &&
+      run_plugin(server_options, transport, server_options.io_threads[0],
+        server_options.flush_delays[0], &first);
+    mtapi_finalize(MTAPI_NULL);
+    _exit(ok ? 0 : 1);
+  }
+  close(ready[1]);
+  if (0 < server && 1 != read(ready[0], &byte, 1)) {
+    waitpid(server, NULL, 0);
+    server = -1;
+  }
+  close(ready[0]);
+  return server;
+}
+#endif
+
+int main(int argc, char ** argv) {
+  BenchmarkOptions options;
+  mtapi_status_t status;
+  bool ok = true;
+  bool first = true;
+#ifndef _WIN32
+  std::vector<pid_t> servers;
+  int control[2] = { -1, -1 };
+#endif
+
+  if (!parse_options(argc, argv, &options)) {
+    usage(argv[0]);
+    return 1;
+  }
+
+#ifndef _WIN32
+  // the additional servers are forked before any thread is started
+  if (BenchmarkOptions::kLocal == options.mode && 1 < options.servers) {
+    ok = (0 == pipe(control));
+    for (size_t tt = 0; ok && tt < options.transports.size(); tt++) {
+      for (int ii = 1; ok && ii < options.servers; ii++) {
+        pid_t server = fork_server(options, options.transports[tt],
+          options.port + ii, control);
+        if (0 < server) {
+          servers.push_back(server);
+        } else {
+          fprintf(stderr, "could not start the %s server on port %d\n",
+            options.transports[tt].c_str(), options.port + ii);
+          ok = false;
+        }
+      }
+    }
+  }
+#endif
+
+  ok = ok && initialize_node(options);
+
+  // a server only runs the first plugin configuration
+  size_t transports_count = (BenchmarkOptions::kServer == options.mode) ?
+    1 : options.transports.size();
+  size_t io_threads_count = (BenchmarkOptions::kServer == options.mode) ?
+    1 : options.io_threads.size();
+  size_t flush_delays_count = (BenchmarkOptions::kServer == options.mode) ?
+    1 : options.flush_delays.size();
+  for (size_t tt = 0; ok && tt < transports_count; tt++) {
+    for (size_t ii = 0; ok && ii < io_threads_count; ii++) {
+      for (size_t jj = 0; ok && jj < flush_delays_count; jj++) {
+        ok = run_plugin(options, options.transports[tt],
+          options.io_threads[ii], options.flush_delays[jj], &first);
+      }
+    }
+  }
+  if (options.json && !first) {
+    printf("\n]\n");
+  }
+
+  mtapi_finalize(&status);
+
+#ifndef _WIN32
+  // closing the control pipe stops the forked servers
+  if (0 <= control[0]) {
+    close(control[0]);
+    close(control[1]);
+  }
+  for (size_t ii = 0; ii < servers.size(); ii++) {
+    int server_status = 0;
+    waitpid(servers[ii], &server_status, 0);
+    ok = ok && WIFEXITED(server_status) && 0 == WEXITSTATUS(server_status);
+  }
+#endif
+
+  return ok ? 0 : 1;
+}
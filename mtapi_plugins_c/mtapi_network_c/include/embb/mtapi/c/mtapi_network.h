@@ -45,6 +45,132 @@ extern "C" {
  */
 
 
+/**
+ * Network plugin attributes.
+ */
+enum mtapi_network_plugin_attributes_enum {
+  MTAPI_NETWORK_IO_THREADS,            /**< number of threads receiving
+                                            packets, connections are
+                                            distributed among them */
+  MTAPI_NETWORK_FLUSH_DELAY            /**< time in microseconds a sender
+                                            waits for more packets to send
+                                            them in one go */
+};
+
+/** size of the \a MTAPI_NETWORK_IO_THREADS attribute */
+#define MTAPI_NETWORK_IO_THREADS_SIZE sizeof(mtapi_uint_t)
+
+/** size of the \a MTAPI_NETWORK_FLUSH_DELAY attribute */
+#define MTAPI_NETWORK_FLUSH_DELAY_SIZE sizeof(mtapi_uint_t)
+
+/** default number of io threads */
+#define MTAPI_NETWORK_IO_THREADS_DEFAULT 1
+
+/** default flush delay, packets are sent right away */
+#define MTAPI_NETWORK_FLUSH_DELAY_DEFAULT 0
+
+/**
+ * Network plugin attributes.
+ *
+ * \ingroup C_MTAPI_NETWORK
+ */
+struct mtapi_network_plugin_attributes_struct {
+  mtapi_uint_t io_threads;             /**< stores MTAPI_NETWORK_IO_THREADS */
+  mtapi_uint_t flush_delay;            /**< stores MTAPI_NETWORK_FLUSH_DELAY */
+};
+
+/**
+ * Network plugin attributes type.
+ *
+ * \ingroup C_MTAPI_NETWORK
+ */
+typedef struct mtapi_network_plugin_attributes_struct
+  mtapi_network_plugin_attributes_t;
+
+/**
+ * This function initializes a network plugin attributes object.
+ *
+ * Calling mtapi_network_pluginattr_init() sets all attributes to their
+ * default values, see mtapi_network_pluginattr_set().
+ *
+ * On success, \c *status is set to \c MTAPI_SUCCESS. On error, \c *status is
+ * set to the appropriate error defined below.
+ * Error code             | Description
+ * ---------------------- | ---------------------------------------------------
+ * \c MTAPI_ERR_PARAMETER | Invalid attributes parameter.
+ *
+ * \see mtapi_network_pluginattr_set(),
+ *      mtapi_network_plugin_initialize_with_attributes()
+ *
+ * \notthreadsafe
+ * \memberof mtapi_network_plugin_attributes_struct
+ */
+void mtapi_network_pluginattr_init(
+  MTAPI_OUT mtapi_network_plugin_attributes_t* attributes,
+                                       /**< [out] Pointer to attributes */
+  MTAPI_OUT mtapi_status_t* status     /**< [out] Pointer to error code,
+                                            may be \c MTAPI_NULL */
+);
+
+/**
+ * This function sets network plugin attribute values in a network plugin
+ * attributes object.
+ *
+ * Supported attributes:
+ * <table>
+ *   <tr>
+ *     <th>Attribute num</th>
+ *     <th>Description</th>
+ *     <th>Data Type</th>
+ *     <th>Default</th>
+ *   </tr>
+ *   <tr>
+ *     <td>\c MTAPI_NETWORK_IO_THREADS</td>
+ *     <td>Number of threads receiving packets. Each thread owns a subset of
+ *         the connections and serves all of them that are ready on a
+ *         wakeup. Must be greater than 0.</td>
+ *     <td>\c mtapi_uint_t</td>
+ *     <td>1</td>
+ *   </tr>
+ *   <tr>
+ *     <td>\c MTAPI_NETWORK_FLUSH_DELAY</td>
+ *     <td>Time in microseconds a sender waits for concurrent senders on the
+ *         same connection, so their packets go out with a single system
+ *         call. Trades latency for throughput when many small tasks are
+ *         started or completed at a high rate. 0 sends right away, packets
+ *         queued meanwhile are still written together.</td>
+ *     <td>\c mtapi_uint_t</td>
+ *     <td>0</td>
+ *   </tr>
+ * </table>
+ *
+ * On success, \c *status is set to \c MTAPI_SUCCESS. On error, \c *status is
+ * set to the appropriate error defined below.
+ * Error code                 | Description
+ * -------------------------- | -----------------------------------------------
+ * \c MTAPI_ERR_PARAMETER     | Invalid attribute parameter.
+ * \c MTAPI_ERR_ATTR_NUM      | Unknown attribute number.
+ * \c MTAPI_ERR_ATTR_SIZE     | Incorrect attribute size.
+ *
+ * \see mtapi_network_pluginattr_init(),
+ *      mtapi_network_plugin_initialize_with_attributes()
+ *
+ * \notthreadsafe
+ * \memberof mtapi_network_plugin_attributes_struct
+ */
+void mtapi_network_pluginattr_set(
+  MTAPI_INOUT mtapi_network_plugin_attributes_t* attributes,
+                                       /**< [in, out] Pointer to attributes */
+  MTAPI_IN mtapi_uint_t attribute_num, /**< [in] Attribute id */
+  MTAPI_IN void* attribute,            /**< [in] Pointer to attribute value */
+  MTAPI_IN mtapi_size_t attribute_size,
+                                       /**< [in] Size of attribute value. may
+                                            be 0, attribute is interpreted as
+                                            value in that case */
+  MTAPI_OUT mtapi_status_t* status     /**< [out] Pointer to error code,
+                                            may be \c MTAPI_NULL */
+);
+
 /**
  * Initializes the MTAPI network environment on a previously initialized MTAPI
  * node.
@@ -57,10 +183,18 @@ extern "C" {
  * from a given node, unless mtapi_network_plugin_finalize() is called in
  * between.
  *
+ * Nodes on the same host may communicate over a unix domain socket instead
+ * of TCP/IP by giving a host of the form "unix:<path>", the port is ignored
+ * then. On Linux, a path starting with '@' names an abstract socket that
+ * does not appear in the file system. The socket file is removed by
+ * mtapi_network_plugin_finalize(). Unix domain sockets are not available on
+ * Windows.
+ *
  * On success, \c *status is set to \c MTAPI_SUCCESS. On error, \c *status is
  * set to the appropriate error defined below.
  * Error code                  | Description
  * --------------------------- | ----------------------------------------------
+ * \c MTAPI_ERR_PARAMETER      | \c buffer_size is too small.
  * \c MTAPI_ERR_UNKNOWN        | MTAPI network couldn't be initialized.
  *
  * \see mtapi_network_plugin_finalize()
@@ -77,10 +211,52 @@ void mtapi_network_plugin_initialize(
   MTAPI_IN mtapi_uint16_t max_connections,
                                        /**< [in] Maximum concurrent connections
                                             accepted by the plugin. */
-  MTAPI_IN mtapi_size_t buffer_size,   /**< [in] Capacity of the transfer
-                                            buffers, this should be chosen big
-                                            enough to hold argument and result
-                                            buffers.*/
+  MTAPI_IN mtapi_size_t buffer_size,   /**< [in] Capacity of the receive
+                                            buffers, at least 36 bytes.
+                                            Arguments and results that do not
+                                            fit are streamed, so this should
+                                            be chosen to hold typical packets
+                                            only.*/
+  MTAPI_OUT mtapi_status_t* status     /**< [out] Pointer to error code,
+                                            may be \c MTAPI_NULL */
+);
+
+/**
+ * Initializes the MTAPI network environment like
+ * mtapi_network_plugin_initialize(), using the given plugin attributes.
+ *
+ * If \c attributes is \c MTAPI_NULL, the default attributes are used.
+ *
+ * On success, \c *status is set to \c MTAPI_SUCCESS. On error, \c *status is
+ * set to the appropriate error defined below.
+ * Error code                  | Description
+ * --------------------------- | ----------------------------------------------
+ * \c MTAPI_ERR_PARAMETER      | Invalid attribute value or \c buffer_size.
+ * \c MTAPI_ERR_UNKNOWN        | MTAPI network couldn't be initialized.
+ *
+ * \see mtapi_network_plugin_initialize(), mtapi_network_pluginattr_set()
+ *
+ * \notthreadsafe
+ * \ingroup C_MTAPI_NETWORK
+ */
+void mtapi_network_plugin_initialize_with_attributes(
+  MTAPI_IN char * host,                /**< [in] The interface to listen on, if
+                                            MTAPI_NULL is given the plugin will
+                                            listen on all available
+                                            interfaces. */
+  MTAPI_IN mtapi_uint16_t port,        /**< [in] The port to listen on. */
+  MTAPI_IN mtapi_uint16_t max_connections,
+                                       /**< [in] Maximum concurrent connections
+                                            accepted by the plugin. */
+  MTAPI_IN mtapi_size_t buffer_size,   /**< [in] Capacity of the receive
+                                            buffers, at least 36 bytes.
+                                            Arguments and results that do not
+                                            fit are streamed, so this should
+                                            be chosen to hold typical packets
+                                            only.*/
+  MTAPI_IN mtapi_network_plugin_attributes_t* attributes,
+                                       /**< [in] Pointer to attributes,
+                                            may be \c MTAPI_NULL */
   MTAPI_OUT mtapi_status_t* status     /**< [out] Pointer to error code,
                                             may be \c MTAPI_NULL */
 );
@@ -145,6 +321,9 @@ void mtapi_network_plugin_finalize(
  * local data matches what he expects the remote action to use if invoked
  * through the network.
  *
+ * A remote node listening on a unix domain socket is reached by giving its
+ * "unix:<path>" address as \c host (see mtapi_network_plugin_initialize()).
+ *
  * On success, an action handle is returned and \c *status is set to
  * \c MTAPI_SUCCESS. On error, \c *status is set to the appropriate error
  * defined below. In the case where the action already exists, \c status will
@@ -199,6 +378,98 @@ mtapi_action_hndl_t mtapi_network_action_create(
                                             may be \c MTAPI_NULL */
 );
 
+/**
+ * Remote node a pooled network action connects to.
+ *
+ * \see mtapi_network_action_create_pooled()
+ *
+ * \ingroup C_MTAPI_NETWORK
+ */
+struct mtapi_network_endpoint_struct {
+  char const * host;                   /**< The host to connect to */
+  mtapi_uint16_t port;                 /**< The port the host is listening
+                                            on */
+};
+
+/**
+ * \see mtapi_network_endpoint_struct
+ *
+ * \ingroup C_MTAPI_NETWORK
+ */
+typedef struct mtapi_network_endpoint_struct mtapi_network_endpoint_t;
+
+/**
+ * This function creates a network action that distributes its tasks over
+ * several connections to one or more remote nodes.
+ *
+ * It behaves like mtapi_network_action_create(), but opens
+ * \c connections_per_endpoint connections to each of the \c endpoint_count
+ * given \c endpoints. Each task is sent over the connection with the fewest
+ * tasks still waiting for their results, so slow or busy nodes receive less
+ * work. Equally loaded connections take turns. All endpoints need to
+ * implement the same remote job.
+ *
+ * A connection that breaks is dropped and reestablished when a later task is
+ * started, at most once per second. Tasks that were running on a broken
+ * connection do not complete. Creation succeeds if at least one connection
+ * could be established, unreachable endpoints are retried later on.
+ *
+ * On success, an action handle is returned and \c *status is set to
+ * \c MTAPI_SUCCESS. On error, \c *status is set to the appropriate error
+ * defined below.
+ * <table>
+ *   <tr>
+ *     <th>Error code</th>
+ *     <th>Description</th>
+ *   </tr>
+ *   <tr>
+ *     <td>\c MTAPI_ERR_PARAMETER</td>
+ *     <td>\c endpoints is \c MTAPI_NULL, or \c endpoint_count or
+ *         \c connections_per_endpoint is zero.</td>
+ *   </tr>
+ *   <tr>
+ *     <td>\c MTAPI_ERR_JOB_INVALID</td>
+ *     <td>The \c job_id is not a valid job ID, i.e., no action was created for
+ *         that ID or the action has been deleted.</td>
+ *   </tr>
+ *   <tr>
+ *     <td>\c MTAPI_ERR_ACTION_LIMIT</td>
+ *     <td>Exceeded maximum number of actions allowed.</td>
+ *   </tr>
+ *   <tr>
+ *     <td>\c MTAPI_ERR_NODE_NOTINIT</td>
+ *     <td>The calling node is not initialized.</td>
+ *   </tr>
+ *   <tr>
+ *     <td>\c MTAPI_ERR_UNKNOWN</td>
+ *     <td>None of the remote nodes could be reached.</td>
+ *   </tr>
+ * </table>
+ *
+ * \see mtapi_network_action_create(), mtapi_action_delete()
+ *
+ * \returns Handle to newly created network action, invalid handle on error
+ * \threadsafe
+ * \ingroup C_MTAPI_NETWORK
+ */
+mtapi_action_hndl_t mtapi_network_action_create_pooled(
+  MTAPI_IN mtapi_domain_t domain_id,   /**< [in] The domain the action is
+                                            associated with */
+  MTAPI_IN mtapi_job_id_t local_job_id,
+                                       /**< [in] The ID of the local job */
+  MTAPI_IN mtapi_job_id_t remote_job_id,
+                                       /**< [in] The ID of the remote job */
+  MTAPI_IN mtapi_network_endpoint_t * endpoints,
+                                       /**< [in] The remote nodes */
+  MTAPI_IN mtapi_uint_t endpoint_count,
+                                       /**< [in] Number of remote nodes */
+  MTAPI_IN mtapi_uint_t connections_per_endpoint,
+                                       /**< [in] Connections to open to each
+                                            remote node */
+  MTAPI_OUT mtapi_status_t* status     /**< [out] Pointer to error code,
+                                            may be \c MTAPI_NULL */
+);
+
 
 #ifdef __cplusplus
 }
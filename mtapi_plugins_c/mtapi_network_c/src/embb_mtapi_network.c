@@ -33,8 +33,13 @@
 #include <embb/base/c/thread.h>
 #include <embb/base/c/atomic.h>
 #include <embb/base/c/mutex.h>
+#include <embb/base/c/condition_variable.h>
+#include <embb/base/c/duration.h>
+#include <embb/base/c/time.h>
 #include <embb/base/c/internal/unused.h>
 #include <embb_mtapi_network_socket.h>
+#include <embb_mtapi_network_poller.h>
+#include <embb_mtapi_network_pool.h>
 #include <embb_mtapi_network.h>
 
 #include <embb_mtapi_task_t.h>
@@ -78,73 +83,515 @@ enum embb_mtapi_network_operation_enum {
   EMBB_MTAPI_NETWORK_CANCEL_TASK = 0x04AFFE04
 };
 
-struct embb_mtapi_network_plugin_struct {
+struct embb_mtapi_network_io_thread_struct {
   embb_thread_t thread;
-  embb_mtapi_network_socket_t *sockets; // sockets[0] is the listening socket
-  int socket_count;
+  embb_mtapi_network_poller_t poller;
+  void ** ready;                       // connections ready on last wakeup
+};
+
+typedef struct embb_mtapi_network_io_thread_struct
+  embb_mtapi_network_io_thread_t;
+
+// largest header is the one of "start task"
+#define EMBB_MTAPI_NETWORK_MAX_HEADER_SIZE 36
+// packet sizes are sent as 32 bit integers
+#define EMBB_MTAPI_NETWORK_MAX_PAYLOAD_SIZE \
+  (0x7fffffff - EMBB_MTAPI_NETWORK_MAX_HEADER_SIZE)
+
+// maximum number of messages written by one system call
+#define EMBB_MTAPI_NETWORK_MAX_BATCH 32
+
+enum embb_mtapi_network_message_state_enum {
+  EMBB_MTAPI_NETWORK_MESSAGE_QUEUED,
+  EMBB_MTAPI_NETWORK_MESSAGE_SENT,
+  EMBB_MTAPI_NETWORK_MESSAGE_FAILED
+};
+
+/**
+ * A packet waiting to be sent. It lives on the stack of the sender, the
+ * payload is sent directly from the task's argument or result buffer.
+ */
+struct embb_mtapi_network_message_struct {
+  char header[EMBB_MTAPI_NETWORK_MAX_HEADER_SIZE];
+  int header_size;
+  void const * payload;
+  int payload_size;
+  int state;
+  struct embb_mtapi_network_message_struct * next;
+};
+
+typedef struct embb_mtapi_network_message_struct
+  embb_mtapi_network_message_t;
+
+/**
+ * A packet too big for the receive buffer. Its header is parsed from the
+ * receive buffer as usual, the rest is received right into its destination.
+ */
+struct embb_mtapi_network_stream_struct {
+  int32_t operation;                   // 0 if no packet is streamed
+  int remaining;                       // bytes still to be received
+  char * data;                         // where they go, NULL to skip them
+
+  // START_TASK, the task is started once its arguments are complete
+  struct embb_mtapi_network_task_struct * network_task;
+  // RETURN_RESULT, the task completes once its result is complete
+  mtapi_task_hndl_t task;
+  int32_t task_status;
+};
+
+typedef struct embb_mtapi_network_stream_struct embb_mtapi_network_stream_t;
+
+struct embb_mtapi_network_connection_struct {
+  embb_mtapi_network_socket_t socket;
+  embb_mtapi_network_io_thread_t * io_thread;
+  int slot;                            // index into the plugin's connections
+  embb_atomic_int reference_count;
+  embb_atomic_int closed;              // set once sending or receiving failed
+  embb_atomic_int outstanding;         // tasks started and not yet answered
+
+  // handles of the outstanding tasks, protected by task_mutex, they are
+  // failed once the connection is lost
+  embb_mutex_t task_mutex;
+  mtapi_task_hndl_t * tasks;
+  int task_count;
+  int task_capacity;
+  int tasks_failed;
+
+  // only used by the owning io thread
+  embb_mtapi_network_buffer_t recv_buffer;
+  embb_mtapi_network_stream_t stream;
+  // memory for remote tasks, allocated by the owning io thread
+  embb_mtapi_network_pool_t pool;
+
+  // send queue, protected by send_mutex
+  embb_mutex_t send_mutex;
+  embb_condition_t send_condition;
+  embb_mtapi_network_message_t * send_head;
+  embb_mtapi_network_message_t * send_tail;
+  int send_count;
+  int sending;
+};
+
+typedef struct embb_mtapi_network_connection_struct
+  embb_mtapi_network_connection_t;
+
+struct embb_mtapi_network_plugin_struct {
   embb_atomic_int run;
   mtapi_size_t buffer_size;
+  mtapi_uint_t flush_delay;
+  embb_duration_t flush_duration;
 
-  embb_mutex_t send_mutex;
-  embb_mtapi_network_buffer_t send_buffer;
+  embb_mtapi_network_socket_t listen_socket;
 
-  embb_mtapi_network_buffer_t recv_buffer;
+  mtapi_uint_t io_thread_count;
+  embb_mtapi_network_io_thread_t * io_threads;
+
+  // registered connections, slots of closed connections are reused,
+  // protected by connection_mutex
+  embb_mutex_t connection_mutex;
+  int max_connections;
+  embb_mtapi_network_connection_t ** connections;
+  int * free_slots;
+  int free_slot_count;
 };
 
 typedef struct embb_mtapi_network_plugin_struct embb_mtapi_network_plugin_t;
 
 static embb_mtapi_network_plugin_t embb_mtapi_network_plugin;
 
+// a lost connection of a network action is reestablished at most this often
+#define EMBB_MTAPI_NETWORK_RECONNECT_INTERVAL_MS 1000
+
+struct embb_mtapi_network_link_struct {
+  char * host;
+  mtapi_uint16_t port;
+  embb_mtapi_network_connection_t * connection; // NULL while disconnected
+  embb_time_t retry_time;
+};
+
+typedef struct embb_mtapi_network_link_struct embb_mtapi_network_link_t;
+
 struct embb_mtapi_network_action_struct {
   mtapi_domain_t domain_id;
   mtapi_job_id_t job_id;
 
-  char const * host;
-  mtapi_uint16_t port;
-  embb_mtapi_network_socket_t socket;
-
-  embb_mutex_t send_mutex;
-  embb_mtapi_network_buffer_t send_buffer;
+  // connections to all endpoints, protected by mutex
+  embb_mutex_t mutex;
+  mtapi_uint_t link_count;
+  embb_mtapi_network_link_t * links;
+  // link the next selection starts at, so ties go round robin
+  mtapi_uint_t next_link;
 };
 
 typedef struct embb_mtapi_network_action_struct embb_mtapi_network_action_t;
 
 struct embb_mtapi_network_task_struct {
-  embb_mtapi_network_socket_t socket;
+  embb_mtapi_network_connection_t * connection;
   int32_t remote_task_id;
   int32_t remote_task_tag;
+
+  int32_t domain_id;
+  int32_t job_id;
+  mtapi_uint_t priority;
+  int32_t results_size;
+  int32_t arguments_size;
 };
 
 typedef struct embb_mtapi_network_task_struct embb_mtapi_network_task_t;
 
+// a remote task's record is followed by its result and argument buffers
+#define EMBB_MTAPI_NETWORK_TASK_SIZE \
+  EMBB_MTAPI_NETWORK_POOL_ALIGN(sizeof(embb_mtapi_network_task_t))
+
+static embb_mtapi_network_connection_t * embb_mtapi_network_connection_create(
+  embb_mtapi_network_socket_t * socket) {
+  embb_mtapi_network_plugin_t * plugin = &embb_mtapi_network_plugin;
+  embb_mtapi_network_connection_t * connection =
+    (embb_mtapi_network_connection_t*)embb_alloc(
+      sizeof(embb_mtapi_network_connection_t));
+  int err;
+
+  if (NULL == connection) {
+    return NULL;
+  }
+
+  err = embb_mtapi_network_buffer_initialize(
+    &connection->recv_buffer, (int)plugin->buffer_size);
+  if (0 == err) {
+    embb_free(connection);
+    return NULL;
+  }
+
+  err = embb_mutex_init(&connection->send_mutex, EMBB_MUTEX_PLAIN);
+  if (EMBB_SUCCESS != err) {
+    embb_mtapi_network_buffer_finalize(&connection->recv_buffer);
+    embb_free(connection);
+    return NULL;
+  }
+
+  err = embb_condition_init(&connection->send_condition);
+  if (EMBB_SUCCESS != err) {
+    embb_mutex_destroy(&connection->send_mutex);
+    embb_mtapi_network_buffer_finalize(&connection->recv_buffer);
+    embb_free(connection);
+    return NULL;
+  }
+
+  err = embb_mutex_init(&connection->task_mutex, EMBB_MUTEX_PLAIN);
+  if (EMBB_SUCCESS != err) {
+    embb_condition_destroy(&connection->send_condition);
+    embb_mutex_destroy(&connection->send_mutex);
+    embb_mtapi_network_buffer_finalize(&connection->recv_buffer);
+    embb_free(connection);
+    return NULL;
+  }
+  connection->tasks = NULL;
+  connection->task_count = 0;
+  connection->task_capacity = 0;
+  connection->tasks_failed = 0;
+  connection->send_head = NULL;
+  connection->send_tail = NULL;
+  connection->send_count = 0;
+  connection->sending = 0;
+  connection->stream.operation = 0;
+  embb_mtapi_network_pool_initialize(&connection->pool);
+
+  connection->socket = *socket;
+  connection->io_thread = NULL;
+  connection->slot = -1;
+  embb_atomic_init_int(&connection->reference_count, 1);
+  embb_atomic_init_int(&connection->closed, 0);
+  embb_atomic_init_int(&connection->outstanding, 0);
+
+  return connection;
+}
+
+static void embb_mtapi_network_connection_acquire(
+  embb_mtapi_network_connection_t * connection) {
+  embb_atomic_fetch_and_add_int(&connection->reference_count, 1);
+}
+
+static void embb_mtapi_network_connection_release(
+  embb_mtapi_network_connection_t * connection) {
+  if (1 == embb_atomic_fetch_and_add_int(&connection->reference_count, -1)) {
+    embb_atomic_destroy_int(&connection->outstanding);
+    embb_atomic_destroy_int(&connection->closed);
+    embb_atomic_destroy_int(&connection->reference_count);
+    embb_mutex_destroy(&connection->task_mutex);
+    if (NULL != connection->tasks) {
+      embb_free(connection->tasks);
+    }
+    embb_condition_destroy(&connection->send_condition);
+    embb_mutex_destroy(&connection->send_mutex);
+    // arguments of a task that never started
+    if (EMBB_MTAPI_NETWORK_START_TASK == connection->stream.operation) {
+      embb_mtapi_network_pool_free(connection->stream.network_task);
+    }
+    embb_mtapi_network_pool_finalize(&connection->pool);
+    embb_mtapi_network_buffer_finalize(&connection->recv_buffer);
+    embb_mtapi_network_socket_finalize(&connection->socket);
+    embb_free(connection);
+  }
+}
+
+/**
+ * Hands the connection to one of the io threads (by slot). The plugin keeps
+ * a reference until the io thread finds the connection closed or the plugin
+ * is finalized, so io threads never see a connection vanish while they are
+ * receiving on it.
+ */
+static int embb_mtapi_network_connection_register(
+  embb_mtapi_network_connection_t * connection) {
+  embb_mtapi_network_plugin_t * plugin = &embb_mtapi_network_plugin;
+  int slot = -1;
+
+  embb_mutex_lock(&plugin->connection_mutex);
+  if (0 < plugin->free_slot_count) {
+    plugin->free_slot_count--;
+    slot = plugin->free_slots[plugin->free_slot_count];
+    embb_mtapi_network_connection_acquire(connection);
+    connection->slot = slot;
+    connection->io_thread =
+      &plugin->io_threads[(mtapi_uint_t)slot % plugin->io_thread_count];
+    plugin->connections[slot] = connection;
+  }
+  embb_mutex_unlock(&plugin->connection_mutex);
+
+  if (0 > slot) {
+    return 0;
+  }
+  return embb_mtapi_network_poller_add(
+    &connection->io_thread->poller, &connection->socket, connection);
+}
+
+/**
+ * Frees the slot of a connection the io thread stopped receiving on and
+ * drops the plugin's reference.
+ */
+static void embb_mtapi_network_connection_unregister(
+  embb_mtapi_network_connection_t * connection) {
+  embb_mtapi_network_plugin_t * plugin = &embb_mtapi_network_plugin;
+
+  embb_mutex_lock(&plugin->connection_mutex);
+  plugin->connections[connection->slot] = NULL;
+  plugin->free_slots[plugin->free_slot_count] = connection->slot;
+  plugin->free_slot_count++;
+  embb_mutex_unlock(&plugin->connection_mutex);
+  embb_mtapi_network_connection_release(connection);
+}
+
+/**
+ * Remembers a task started on the connection until its answer arrives.
+ * \returns 0 if the connection is lost already or on failure
+ */
+static int embb_mtapi_network_connection_track_task(
+  embb_mtapi_network_connection_t * connection,
+  mtapi_task_hndl_t task) {
+  mtapi_task_hndl_t * tasks;
+  int capacity;
+  int result = 0;
+
+  embb_mutex_lock(&connection->task_mutex);
+  if (!connection->tasks_failed) {
+    if (connection->task_count == connection->task_capacity) {
+      capacity = (0 == connection->task_capacity) ?
+        16 : connection->task_capacity * 2;
+      tasks = (mtapi_task_hndl_t*)embb_alloc(
+        sizeof(mtapi_task_hndl_t) * (size_t)capacity);
+      if (NULL != tasks) {
+        if (0 < connection->task_count) {
+          memcpy(tasks, connection->tasks,
+            sizeof(mtapi_task_hndl_t) * (size_t)connection->task_count);
+        }
+        if (NULL != connection->tasks) {
+          embb_free(connection->tasks);
+        }
+        connection->tasks = tasks;
+        connection->task_capacity = capacity;
+      }
+    }
+    if (connection->task_count < connection->task_capacity) {
+      connection->tasks[connection->task_count] = task;
+      connection->task_count++;
+      embb_atomic_fetch_and_add_int(&connection->outstanding, 1);
+      result = 1;
+    }
+  }
+  embb_mutex_unlock(&connection->task_mutex);
+
+  return result;
+}
+
+/**
+ * Forgets a task once its answer has arrived, whoever forgets it completes
+ * it.
+ * \returns 0 if the task was not outstanding on the connection
+ */
+static int embb_mtapi_network_connection_untrack_task(
+  embb_mtapi_network_connection_t * connection,
+  mtapi_task_hndl_t task) {
+  int result = 0;
+  int ii;
+
+  embb_mutex_lock(&connection->task_mutex);
+  for (ii = 0; ii < connection->task_count; ii++) {
+    if (connection->tasks[ii].id == task.id &&
+      connection->tasks[ii].tag == task.tag) {
+      connection->task_count--;
+      connection->tasks[ii] = connection->tasks[connection->task_count];
+      embb_atomic_fetch_and_add_int(&connection->outstanding, -1);
+      result = 1;
+      break;
+    }
+  }
+  embb_mutex_unlock(&connection->task_mutex);
+
+  return result;
+}
+
+static void embb_mtapi_network_message_initialize(
+  embb_mtapi_network_message_t * that,
+  embb_mtapi_network_buffer_t * header) {
+  that->header_size = 0;
+  that->payload = NULL;
+  that->payload_size = 0;
+  that->state = EMBB_MTAPI_NETWORK_MESSAGE_QUEUED;
+  that->next = NULL;
+  embb_mtapi_network_buffer_wrap(
+    header, that->header, EMBB_MTAPI_NETWORK_MAX_HEADER_SIZE);
+}
+
+/**
+ * Writes as many queued messages as possible with a single system call.
+ * Called with send_mutex held by the sender currently owning the socket.
+ */
+static void embb_mtapi_network_connection_flush(
+  embb_mtapi_network_connection_t * connection) {
+  embb_mtapi_network_socket_vector_t
+    vector[EMBB_MTAPI_NETWORK_MAX_BATCH * 2];
+  embb_mtapi_network_message_t * batch = connection->send_head;
+  embb_mtapi_network_message_t * message;
+  int count = 0;
+  size_t size = 0;
+  int state;
+
+  // detach up to EMBB_MTAPI_NETWORK_MAX_BATCH messages from the queue
+  message = batch;
+  while (NULL != message && count < EMBB_MTAPI_NETWORK_MAX_BATCH * 2) {
+    vector[count].data = message->header;
+    vector[count].size = (size_t)message->header_size;
+    count++;
+    vector[count].data = message->payload;
+    vector[count].size = (size_t)message->payload_size;
+    count++;
+    size += vector[count - 2].size + vector[count - 1].size;
+    connection->send_head = message->next;
+    connection->send_count--;
+    message = message->next;
+  }
+  if (NULL == connection->send_head) {
+    connection->send_tail = NULL;
+  }
+
+  embb_mutex_unlock(&connection->send_mutex);
+  state = (size == embb_mtapi_network_socket_sendvector(
+    &connection->socket, vector, count)) ?
+    EMBB_MTAPI_NETWORK_MESSAGE_SENT : EMBB_MTAPI_NETWORK_MESSAGE_FAILED;
+  if (EMBB_MTAPI_NETWORK_MESSAGE_FAILED == state) {
+    embb_atomic_store_int(&connection->closed, 1);
+  }
+  embb_mutex_lock(&connection->send_mutex);
+
+  // the owners may return as soon as the state is set
+  message = batch;
+  while (0 < count) {
+    embb_mtapi_network_message_t * next = message->next;
+    message->state = state;
+    message = next;
+    count -= 2;
+  }
+  embb_condition_notify_all(&connection->send_condition);
+}
+
+/**
+ * Queues the message and returns once it has been written. Whoever finds
+ * the connection idle writes the queue, including messages of concurrent
+ * senders, the others wait for their message to go out. With a flush delay
+ * the writer lingers up to that long so more messages can join the write.
+ * \returns 1 if the message was sent completely
+ */
+static int embb_mtapi_network_connection_send(
+  embb_mtapi_network_connection_t * connection,
+  embb_mtapi_network_message_t * message) {
+  embb_mtapi_network_plugin_t * plugin = &embb_mtapi_network_plugin;
+  int state;
+
+  embb_mutex_lock(&connection->send_mutex);
+  if (NULL == connection->send_tail) {
+    connection->send_head = message;
+  } else {
+    connection->send_tail->next = message;
+  }
+  connection->send_tail = message;
+  connection->send_count++;
+  if (EMBB_MTAPI_NETWORK_MAX_BATCH == connection->send_count) {
+    // a full batch, no need for the writer to wait any longer
+    embb_condition_notify_all(&connection->send_condition);
+  }
+
+  while (EMBB_MTAPI_NETWORK_MESSAGE_QUEUED == message->state) {
+    if (connection->sending) {
+      embb_condition_wait(&connection->send_condition,
+        &connection->send_mutex);
+    } else {
+      // flush wakes up the waiting senders, if there is anything left in
+      // the queue one of them takes over
+      connection->sending = 1;
+      if (0 < plugin->flush_delay &&
+        EMBB_MTAPI_NETWORK_MAX_BATCH > connection->send_count) {
+        embb_condition_wait_for(&connection->send_condition,
+          &connection->send_mutex, &plugin->flush_duration);
+      }
+      embb_mtapi_network_connection_flush(connection);
+      connection->sending = 0;
+    }
+  }
+  state = message->state;
+  embb_mutex_unlock(&connection->send_mutex);
+
+  return (EMBB_MTAPI_NETWORK_MESSAGE_SENT == state) ? 1 : 0;
+}
+
 static void embb_mtapi_network_return_failure(
+  embb_mtapi_network_connection_t * connection,
   int32_t remote_task_id,
   int32_t remote_task_tag,
-  mtapi_status_t status,
-  embb_mtapi_network_socket_t * socket,
-  embb_mtapi_network_buffer_t * buffer) {
-  embb_mtapi_network_buffer_clear(buffer);
+  mtapi_status_t status) {
+  embb_mtapi_network_message_t message;
+  embb_mtapi_network_buffer_t header;
+
+  embb_mtapi_network_message_initialize(&message, &header);
 
   // packet size
   embb_mtapi_network_buffer_push_back_int32(
-    buffer, 16);
+    &header, 16);
 
   // operation
   embb_mtapi_network_buffer_push_back_int32(
-    buffer, EMBB_MTAPI_NETWORK_RETURN_FAILURE);
+    &header, EMBB_MTAPI_NETWORK_RETURN_FAILURE);
 
   // task handle
   embb_mtapi_network_buffer_push_back_int32(
-    buffer, remote_task_id);
+    &header, remote_task_id);
   embb_mtapi_network_buffer_push_back_int32(
-    buffer, remote_task_tag);
+    &header, remote_task_tag);
 
   // status
   embb_mtapi_network_buffer_push_back_int32(
-    buffer, (int32_t)status);
+    &header, (int32_t)status);
 
-  embb_mtapi_network_socket_sendbuffer(
-    socket, buffer);
+  message.header_size = header.size;
+  embb_mtapi_network_connection_send(connection, &message);
 }
 
 static void embb_mtapi_network_task_complete(
@@ -166,89 +613,87 @@ static void embb_mtapi_network_task_complete(
           embb_mtapi_action_pool_get_storage_for_handle(
           node->action_pool, local_task->action);*/
 
-        embb_mtapi_network_plugin_t * plugin = &embb_mtapi_network_plugin;
         embb_mtapi_network_task_t * network_task =
           (embb_mtapi_network_task_t*)local_task->attributes.user_data;
-        embb_mtapi_network_buffer_t * send_buf = &plugin->send_buffer;
+        embb_mtapi_network_connection_t * connection =
+          network_task->connection;
 
         embb_atomic_memory_barrier();
         local_task->attributes.complete_func = NULL;
         embb_atomic_memory_barrier();
 
-        // serialize sending of results
-        embb_mutex_lock(&plugin->send_mutex);
-        embb_mtapi_network_buffer_clear(send_buf);
-
         if (local_task->error_code == MTAPI_SUCCESS) {
-          // actual counts bytes actually put into the buffer
+          embb_mtapi_network_message_t message;
+          embb_mtapi_network_buffer_t header;
+          // actual counts bytes actually put into the header
           int actual = 0;
-          // expected counts bytes we intended to put into the buffer
+          // expected counts bytes we intended to put into the packet
           int expected =
             4 +                               // operation
             4 + 4 +                           // remote task handle
             4 +                               // status
             4 + (int)local_task->result_size; // result buffer
 
-                                              // packet size
+          embb_mtapi_network_message_initialize(&message, &header);
+
+          // packet size
           actual += embb_mtapi_network_buffer_push_back_int32(
-            send_buf, expected);
+            &header, expected);
           expected += 4;
 
           // operation is "return result"
           actual += embb_mtapi_network_buffer_push_back_int32(
-            send_buf, EMBB_MTAPI_NETWORK_RETURN_RESULT);
+            &header, EMBB_MTAPI_NETWORK_RETURN_RESULT);
 
           // remote task id
           actual += embb_mtapi_network_buffer_push_back_int32(
-            send_buf, network_task->remote_task_id);
+            &header, network_task->remote_task_id);
           actual += embb_mtapi_network_buffer_push_back_int32(
-            send_buf, network_task->remote_task_tag);
+            &header, network_task->remote_task_tag);
 
           // status
           actual += embb_mtapi_network_buffer_push_back_int32(
-            send_buf, local_task->error_code);
+            &header, local_task->error_code);
 
-          // result size
+          // result size, the result itself is sent from the result buffer
           actual += embb_mtapi_network_buffer_push_back_int32(
-            send_buf, (int32_t)local_task->result_size);
-          actual += embb_mtapi_network_buffer_push_back_rawdata(
-            send_buf, (int32_t)local_task->result_size,
-            local_task->result_buffer);
-
-          if (expected == actual) {
-            int sent = embb_mtapi_network_socket_sendbuffer(
-              &network_task->socket, send_buf);
-            assert(sent == send_buf->size);
-            EMBB_UNUSED_IN_RELEASE(sent);
+            &header, (int32_t)local_task->result_size);
+          actual += (int)local_task->result_size;
+
+          // results too big for the receive buffer on the other side are
+          // streamed
+          if (expected == actual && local_task->result_size <=
+            EMBB_MTAPI_NETWORK_MAX_PAYLOAD_SIZE) {
+            message.header_size = header.size;
+            message.payload = local_task->result_buffer;
+            message.payload_size = (int)local_task->result_size;
+            embb_mtapi_network_connection_send(connection, &message);
           } else {
             embb_mtapi_network_return_failure(
+              connection,
               network_task->remote_task_id,
               network_task->remote_task_tag,
-              MTAPI_ERR_UNKNOWN,
-              &network_task->socket, send_buf);
+              MTAPI_ERR_UNKNOWN);
           }
         } else {
           embb_mtapi_network_return_failure(
+            connection,
             network_task->remote_task_id,
             network_task->remote_task_tag,
-            local_task->error_code,
-            &network_task->socket, send_buf);
+            local_task->error_code);
         }
 
-        // sending done
-        embb_mutex_unlock(&plugin->send_mutex);
-
-        // we allocated arguments and results on receive, so free them here
-        embb_free((void*)local_task->arguments);
-        embb_free(local_task->result_buffer);
-
         void * data = local_task->attributes.user_data;
 
         embb_atomic_memory_barrier();
         local_task->attributes.user_data = NULL;
         embb_atomic_memory_barrier();
 
-        embb_free(data);
+        // arguments and results were allocated along with the network task
+        // on receive, so this frees them all, the pool is part of the
+        // connection, so this has to happen before releasing it
+        embb_mtapi_network_pool_free(data);
+        embb_mtapi_network_connection_release(connection);
 
         local_status = MTAPI_SUCCESS;
       }
@@ -258,26 +703,71 @@ static void embb_mtapi_network_task_complete(
   mtapi_status_set(status, local_status);
 }
 
+static void embb_mtapi_network_start_task(
+  embb_mtapi_network_connection_t * connection,
+  embb_mtapi_network_task_t * network_task) {
+  mtapi_job_hndl_t job_hndl;
+  mtapi_task_attributes_t task_attr;
+  mtapi_task_complete_function_t func = embb_mtapi_network_task_complete;
+  void * func_void;
+  mtapi_status_t local_status = MTAPI_ERR_UNKNOWN;
+  char * results = (char*)network_task + EMBB_MTAPI_NETWORK_TASK_SIZE;
+  char * arguments =
+    results + EMBB_MTAPI_NETWORK_POOL_ALIGN(network_task->results_size);
+
+  // the task keeps the connection alive until its result is sent
+  network_task->connection = connection;
+  embb_mtapi_network_connection_acquire(connection);
+  mtapi_taskattr_init(&task_attr, &local_status);
+  assert(local_status == MTAPI_SUCCESS);
+  mtapi_taskattr_set(&task_attr, MTAPI_TASK_USER_DATA,
+    (void*)network_task, 0, &local_status);
+  assert(local_status == MTAPI_SUCCESS);
+  mtapi_boolean_t task_detached = MTAPI_TRUE;
+  mtapi_taskattr_set(&task_attr, MTAPI_TASK_DETACHED,
+    (void*)&task_detached, sizeof(mtapi_boolean_t), &local_status);
+  assert(local_status == MTAPI_SUCCESS);
+  mtapi_taskattr_set(&task_attr, MTAPI_TASK_PRIORITY,
+    (void*)&network_task->priority, sizeof(mtapi_uint_t), &local_status);
+  assert(local_status == MTAPI_SUCCESS);
+  memcpy(&func_void, &func, sizeof(void*));
+  mtapi_taskattr_set(&task_attr, MTAPI_TASK_COMPLETE_FUNCTION,
+    func_void, 0, &local_status);
+  assert(local_status == MTAPI_SUCCESS);
+  job_hndl = mtapi_job_get((mtapi_job_id_t)network_task->job_id,
+    (mtapi_domain_t)network_task->domain_id, &local_status);
+  if (local_status == MTAPI_SUCCESS) {
+    mtapi_task_start(
+      MTAPI_TASK_ID_NONE, job_hndl,
+      arguments, (mtapi_size_t)network_task->arguments_size,
+      results, (mtapi_size_t)network_task->results_size,
+      &task_attr, MTAPI_GROUP_NONE,
+      &local_status);
+  }
+  if (local_status != MTAPI_SUCCESS) {
+    embb_mtapi_network_return_failure(connection,
+      network_task->remote_task_id, network_task->remote_task_tag,
+      local_status);
+    embb_mtapi_network_pool_free(network_task);
+    embb_mtapi_network_connection_release(connection);
+  }
+}
+
 static mtapi_status_t embb_mtapi_network_handle_start_task(
-  embb_mtapi_network_socket_t * socket,
+  embb_mtapi_network_connection_t * connection,
   embb_mtapi_network_buffer_t * buffer,
   int packet_size) {
   int32_t domain_id;
   int32_t job_id;
   int32_t results_size;
-  void * results;
-  int err;
-  EMBB_UNUSED_IN_RELEASE(err);
-
   int32_t arguments_size;
   int32_t remote_task_id;
   int32_t remote_task_tag;
-  mtapi_uint_t priority = 0;
-  mtapi_job_hndl_t job_hndl;
-  mtapi_task_attributes_t task_attr;
-  void * arguments;
-  mtapi_task_complete_function_t func = embb_mtapi_network_task_complete;
-  void * func_void;
+  int32_t priority = 0;
+  char * arguments;
+  int available;
+  int err;
+  EMBB_UNUSED_IN_RELEASE(err);
   mtapi_status_t local_status = MTAPI_ERR_UNKNOWN;
 
   // check if we have at least 28 bytes
@@ -289,8 +779,7 @@ static mtapi_status_t embb_mtapi_network_handle_start_task(
     err = embb_mtapi_network_buffer_pop_front_int32(buffer, &job_id);
     assert(err == 4);
     // priority
-    err = embb_mtapi_network_buffer_pop_front_int32(
-      buffer, (int32_t*)&priority);
+    err = embb_mtapi_network_buffer_pop_front_int32(buffer, &priority);
     assert(err == 4);
     // remote task handle
     err = embb_mtapi_network_buffer_pop_front_int32(
@@ -307,90 +796,187 @@ static mtapi_status_t embb_mtapi_network_handle_start_task(
     err = embb_mtapi_network_buffer_pop_front_int32(buffer, &arguments_size);
     assert(err == 4);
 
-    embb_mtapi_network_task_t * network_task =
-      (embb_mtapi_network_task_t*)embb_alloc(
-        sizeof(embb_mtapi_network_task_t));
-
-    if (network_task == NULL) {
-      embb_mtapi_network_return_failure(
-        remote_task_id, remote_task_tag, MTAPI_ERR_UNKNOWN,
-        socket, buffer);
-      return MTAPI_ERR_UNKNOWN;
-    }
-    network_task->remote_task_id = remote_task_id;
-    network_task->remote_task_tag = remote_task_tag;
-
     // check packet_size again
-    if (packet_size == 28 + arguments_size) {
-      // allocate buffers
-      results = embb_alloc((size_t)results_size);
-      if (results == NULL) {
-        embb_free(network_task);
+    if (packet_size == 28 + arguments_size && 0 <= results_size) {
+      // the task record, results and arguments share one pooled block
+      embb_mtapi_network_task_t * network_task =
+        (embb_mtapi_network_task_t*)embb_mtapi_network_pool_allocate(
+          &connection->pool,
+          EMBB_MTAPI_NETWORK_TASK_SIZE +
+          EMBB_MTAPI_NETWORK_POOL_ALIGN(results_size) +
+          (size_t)arguments_size);
+      if (network_task == NULL) {
         embb_mtapi_network_return_failure(
-          remote_task_id, remote_task_tag, MTAPI_ERR_UNKNOWN,
-          socket, buffer);
+          connection, remote_task_id, remote_task_tag, MTAPI_ERR_UNKNOWN);
         return MTAPI_ERR_UNKNOWN;
       }
-      arguments = embb_alloc((size_t)arguments_size);
-      if (arguments == NULL) {
-        embb_free(network_task);
-        embb_free(results);
-        embb_mtapi_network_return_failure(
-          remote_task_id, remote_task_tag, MTAPI_ERR_UNKNOWN,
-          socket, buffer);
-        return MTAPI_ERR_UNKNOWN;
+      network_task->remote_task_id = remote_task_id;
+      network_task->remote_task_tag = remote_task_tag;
+      network_task->domain_id = domain_id;
+      network_task->job_id = job_id;
+      network_task->priority = (mtapi_uint_t)priority;
+      network_task->results_size = results_size;
+      network_task->arguments_size = arguments_size;
+      arguments = (char*)network_task + EMBB_MTAPI_NETWORK_TASK_SIZE +
+        EMBB_MTAPI_NETWORK_POOL_ALIGN(results_size);
+
+      // arguments, as far as they have arrived yet
+      available = buffer->size - buffer->position;
+      if (available > arguments_size) {
+        available = arguments_size;
       }
-
-      // arguments
       err = embb_mtapi_network_buffer_pop_front_rawdata(
-        buffer, arguments_size, arguments);
-      assert(err == arguments_size);
-
-      network_task->socket = *socket;
-      mtapi_taskattr_init(&task_attr, &local_status);
-      assert(local_status == MTAPI_SUCCESS);
-      mtapi_taskattr_set(&task_attr, MTAPI_TASK_USER_DATA,
-        (void*)network_task, 0, &local_status);
-      assert(local_status == MTAPI_SUCCESS);
-      mtapi_boolean_t task_detached = MTAPI_TRUE;
-      mtapi_taskattr_set(&task_attr, MTAPI_TASK_DETACHED,
-        (void*)&task_detached, sizeof(mtapi_boolean_t), &local_status);
-      assert(local_status == MTAPI_SUCCESS);
-      mtapi_taskattr_set(&task_attr, MTAPI_TASK_PRIORITY,
-        (void*)&priority, sizeof(mtapi_uint_t), &local_status);
-      assert(local_status == MTAPI_SUCCESS);
-      memcpy(&func_void, &func, sizeof(void*));
-      mtapi_taskattr_set(&task_attr, MTAPI_TASK_COMPLETE_FUNCTION,
-        func_void, 0, &local_status);
-      assert(local_status == MTAPI_SUCCESS);
-      job_hndl = mtapi_job_get((mtapi_job_id_t)job_id,
-        (mtapi_domain_t)domain_id, &local_status);
-      if (local_status == MTAPI_SUCCESS) {
-        mtapi_task_start(
-          MTAPI_TASK_ID_NONE, job_hndl,
-          arguments, (mtapi_size_t)arguments_size,
-          results, (mtapi_size_t)results_size,
-          &task_attr, MTAPI_GROUP_NONE,
-          &local_status);
-      }
-      if (local_status != MTAPI_SUCCESS) {
-        embb_free(network_task);
-        embb_free(arguments);
-        embb_free(results);
-        embb_mtapi_network_return_failure(
-          remote_task_id, remote_task_tag, local_status, socket, buffer);
+        buffer, available, arguments);
+      assert(err == available);
+
+      if (available == arguments_size) {
+        embb_mtapi_network_start_task(connection, network_task);
+      } else {
+        // the rest is received right into the arguments
+        connection->stream.data = arguments + available;
+        connection->stream.network_task = network_task;
       }
+      local_status = MTAPI_SUCCESS;
     } else {
-      embb_free(network_task);
       embb_mtapi_network_return_failure(
-        remote_task_id, remote_task_tag, local_status, socket, buffer);
+        connection, remote_task_id, remote_task_tag, local_status);
+    }
+  }
+
+  return local_status;
+}
+
+static void embb_mtapi_network_complete_task(
+  mtapi_task_hndl_t task,
+  int32_t task_status) {
+  embb_mtapi_node_t * node = embb_mtapi_node_get_instance();
+
+  if (embb_mtapi_task_pool_is_handle_valid(node->task_pool, task)) {
+    embb_mtapi_task_t * local_task =
+      embb_mtapi_task_pool_get_storage_for_handle(node->task_pool, task);
+
+    if (embb_mtapi_action_pool_is_handle_valid(
+      node->action_pool, local_task->action)) {
+      embb_mtapi_action_t * local_action =
+        embb_mtapi_action_pool_get_storage_for_handle(
+          node->action_pool, local_task->action);
+
+      local_task->error_code = (mtapi_status_t)task_status;
+      embb_atomic_store_int(&local_task->state, MTAPI_TASK_COMPLETED);
+      embb_atomic_fetch_and_add_int(&local_action->num_tasks,
+        -(int)local_task->attributes.num_instances);
+
+      /* is task associated with a group? */
+      if (embb_mtapi_group_pool_is_handle_valid(
+        node->group_pool, local_task->group)) {
+        embb_mtapi_group_t* local_group =
+          embb_mtapi_group_pool_get_storage_for_handle(
+            node->group_pool, local_task->group);
+        embb_mtapi_task_queue_push_back(
+          &local_group->queue, local_task);
+      }
+    }
+  }
+}
+
+/**
+ * Finishes a task that failed or was cancelled on the other side, or that
+ * never got an answer.
+ */
+static mtapi_status_t embb_mtapi_network_fail_task(
+  mtapi_task_hndl_t task,
+  int32_t task_status) {
+  mtapi_status_t local_status = MTAPI_ERR_UNKNOWN;
+
+  if (embb_mtapi_node_is_initialized()) {
+    embb_mtapi_node_t * node = embb_mtapi_node_get_instance();
+
+    if (embb_mtapi_task_pool_is_handle_valid(node->task_pool, task)) {
+      embb_mtapi_task_t * local_task =
+        embb_mtapi_task_pool_get_storage_for_handle(
+          node->task_pool, task);
+
+      if (embb_mtapi_action_pool_is_handle_valid(
+        node->action_pool, local_task->action)) {
+        embb_mtapi_action_t * local_action =
+          embb_mtapi_action_pool_get_storage_for_handle(
+            node->action_pool, local_task->action);
+
+        embb_atomic_fetch_and_add_int(&local_action->num_tasks,
+          -(int)local_task->attributes.num_instances);
+        local_task->error_code = (mtapi_status_t)task_status;
+        if (MTAPI_ERR_ACTION_CANCELLED == task_status) {
+          embb_atomic_store_int(&local_task->state, MTAPI_TASK_CANCELLED);
+        } else {
+          embb_atomic_store_int(&local_task->state, MTAPI_TASK_ERROR);
+        }
+
+        /* is task associated with a group? */
+        if (embb_mtapi_group_pool_is_handle_valid(
+          node->group_pool, local_task->group)) {
+          embb_mtapi_group_t* local_group =
+            embb_mtapi_group_pool_get_storage_for_handle(
+              node->group_pool, local_task->group);
+          embb_mtapi_task_queue_push_back(
+            &local_group->queue, local_task);
+        }
+
+        local_status = MTAPI_SUCCESS;
+      }
     }
   }
 
   return local_status;
 }
 
+/**
+ * Fails all tasks still waiting for their answer on a lost connection,
+ * tasks started on it from now on fail right away.
+ */
+static void embb_mtapi_network_connection_fail_tasks(
+  embb_mtapi_network_connection_t * connection) {
+  mtapi_task_hndl_t * tasks;
+  int count;
+  int ii;
+
+  embb_mutex_lock(&connection->task_mutex);
+  connection->tasks_failed = 1;
+  tasks = connection->tasks;
+  count = connection->task_count;
+  connection->tasks = NULL;
+  connection->task_count = 0;
+  connection->task_capacity = 0;
+  embb_atomic_store_int(&connection->outstanding, 0);
+  embb_mutex_unlock(&connection->task_mutex);
+
+  for (ii = 0; ii < count; ii++) {
+    embb_mtapi_network_fail_task(tasks[ii], MTAPI_ERR_ACTION_FAILED);
+  }
+  if (NULL != tasks) {
+    embb_free(tasks);
+  }
+}
+
+/**
+ * Fails everything waiting for data from a lost connection, including a
+ * result that was being streamed. Only called while nobody receives on
+ * the connection.
+ */
+static void embb_mtapi_network_connection_fail(
+  embb_mtapi_network_connection_t * connection) {
+  embb_mtapi_network_stream_t * stream = &connection->stream;
+
+  if (EMBB_MTAPI_NETWORK_RETURN_RESULT == stream->operation) {
+    if (NULL != stream->data) {
+      embb_mtapi_network_fail_task(stream->task, MTAPI_ERR_ACTION_FAILED);
+    }
+    stream->operation = 0;
+  }
+  embb_mtapi_network_connection_fail_tasks(connection);
+}
+
 static mtapi_status_t embb_mtapi_network_handle_return_result(
+  embb_mtapi_network_connection_t * connection,
   embb_mtapi_network_buffer_t * buffer,
   int packet_size) {
   int32_t task_status;
@@ -398,6 +984,7 @@ static mtapi_status_t embb_mtapi_network_handle_return_result(
   int32_t task_tag;
 
   int32_t results_size;
+  int available;
   int err;
   EMBB_UNUSED_IN_RELEASE(err);
   mtapi_status_t local_status = MTAPI_ERR_UNKNOWN;
@@ -427,40 +1014,36 @@ static mtapi_status_t embb_mtapi_network_handle_return_result(
         task.id = (mtapi_task_id_t)task_id;
         task.tag = (mtapi_uint_t)task_tag;
 
-        if (embb_mtapi_task_pool_is_handle_valid(node->task_pool, task)) {
+        // a task failed along with its connection gets no result
+        if (embb_mtapi_network_connection_untrack_task(connection, task) &&
+          embb_mtapi_task_pool_is_handle_valid(node->task_pool, task)) {
           embb_mtapi_task_t * local_task =
             embb_mtapi_task_pool_get_storage_for_handle(
               node->task_pool, task);
 
-          if (embb_mtapi_action_pool_is_handle_valid(
-            node->action_pool, local_task->action)) {
-            embb_mtapi_action_t * local_action =
-              embb_mtapi_action_pool_get_storage_for_handle(
-                node->action_pool, local_task->action);
-
-            /* not needed right now
-            embb_mtapi_network_action_t * network_action =
-            (embb_mtapi_network_action_t*)local_action->plugin_data;*/
+          // the result has to fit into the buffer given on task start
+          if (results_size > (int32_t)local_task->result_size) {
+            embb_mtapi_network_fail_task(task, MTAPI_ERR_RESULT_SIZE);
+          } else {
+            char * results = (char*)local_task->result_buffer;
 
+            // result, as far as it has arrived yet
+            available = buffer->size - buffer->position;
+            if (available > results_size) {
+              available = results_size;
+            }
             err = embb_mtapi_network_buffer_pop_front_rawdata(
-              buffer, results_size, local_task->result_buffer);
-            assert(err == results_size);
-
-            local_task->error_code = (mtapi_status_t)task_status;
-            embb_atomic_store_int(&local_task->state, MTAPI_TASK_COMPLETED);
-            embb_atomic_fetch_and_add_int(&local_action->num_tasks,
-              -(int)local_task->attributes.num_instances);
-
-            /* is task associated with a group? */
-            if (embb_mtapi_group_pool_is_handle_valid(
-              node->group_pool, local_task->group)) {
-              embb_mtapi_group_t* local_group =
-                embb_mtapi_group_pool_get_storage_for_handle(
-                  node->group_pool, local_task->group);
-              embb_mtapi_task_queue_push_back(
-                &local_group->queue, local_task);
+              buffer, available, results);
+            assert(err == available);
+
+            if (available == results_size) {
+              embb_mtapi_network_complete_task(task, task_status);
+            } else {
+              // the rest is received right into the result buffer
+              connection->stream.data = results + available;
+              connection->stream.task = task;
+              connection->stream.task_status = task_status;
             }
-
             local_status = MTAPI_SUCCESS;
           }
         }
@@ -472,68 +1055,35 @@ static mtapi_status_t embb_mtapi_network_handle_return_result(
 }
 
 static mtapi_status_t embb_mtapi_network_handle_return_failure(
+  embb_mtapi_network_connection_t * connection,
   embb_mtapi_network_buffer_t * buffer,
   int packet_size) {
   int32_t task_status;
   int32_t task_id;
   int32_t task_tag;
+  mtapi_task_hndl_t task;
 
   int err;
   EMBB_UNUSED_IN_RELEASE(err);
   mtapi_status_t local_status = MTAPI_ERR_UNKNOWN;
 
-  if (embb_mtapi_node_is_initialized()) {
-    embb_mtapi_node_t * node = embb_mtapi_node_get_instance();
-    mtapi_task_hndl_t task;
-
-    // do we have 12 bytes?
-    if (packet_size == 12) {
-      // local task id
-      err = embb_mtapi_network_buffer_pop_front_int32(buffer, &task_id);
-      assert(err == 4);
-      err = embb_mtapi_network_buffer_pop_front_int32(buffer, &task_tag);
-      assert(err == 4);
-      // task status
-      err = embb_mtapi_network_buffer_pop_front_int32(
-        buffer, &task_status);
-      assert(err == 4);
-
-      task.id = (mtapi_task_id_t)task_id;
-      task.tag = (mtapi_uint_t)task_tag;
-
-      if (embb_mtapi_task_pool_is_handle_valid(node->task_pool, task)) {
-        embb_mtapi_task_t * local_task =
-          embb_mtapi_task_pool_get_storage_for_handle(
-            node->task_pool, task);
-
-        if (embb_mtapi_action_pool_is_handle_valid(
-          node->action_pool, local_task->action)) {
-          embb_mtapi_action_t * local_action =
-            embb_mtapi_action_pool_get_storage_for_handle(
-              node->action_pool, local_task->action);
-
-          embb_atomic_fetch_and_add_int(&local_action->num_tasks,
-            -(int)local_task->attributes.num_instances);
-          local_task->error_code = (mtapi_status_t)task_status;
-          if (MTAPI_ERR_ACTION_CANCELLED == task_status) {
-            embb_atomic_store_int(&local_task->state, MTAPI_TASK_CANCELLED);
-          } else {
-            embb_atomic_store_int(&local_task->state, MTAPI_TASK_ERROR);
-          }
+  // do we have 12 bytes?
+  if (packet_size == 12) {
+    // local task id
+    err = embb_mtapi_network_buffer_pop_front_int32(buffer, &task_id);
+    assert(err == 4);
+    err = embb_mtapi_network_buffer_pop_front_int32(buffer, &task_tag);
+    assert(err == 4);
+    // task status
+    err = embb_mtapi_network_buffer_pop_front_int32(
+      buffer, &task_status);
+    assert(err == 4);
 
-          /* is task associated with a group? */
-          if (embb_mtapi_group_pool_is_handle_valid(
-            node->group_pool, local_task->group)) {
-            embb_mtapi_group_t* local_group =
-              embb_mtapi_group_pool_get_storage_for_handle(
-                node->group_pool, local_task->group);
-            embb_mtapi_task_queue_push_back(
-              &local_group->queue, local_task);
-          }
+    task.id = (mtapi_task_id_t)task_id;
+    task.tag = (mtapi_uint_t)task_tag;
 
-          local_status = MTAPI_SUCCESS;
-        }
-      }
+    if (embb_mtapi_network_connection_untrack_task(connection, task)) {
+      local_status = embb_mtapi_network_fail_task(task, task_status);
     }
   }
 
@@ -541,6 +1091,7 @@ static mtapi_status_t embb_mtapi_network_handle_return_failure(
 }
 
 static mtapi_status_t embb_mtapi_network_handle_cancel_task(
+  embb_mtapi_network_connection_t * connection,
   embb_mtapi_network_buffer_t * buffer,
   int packet_size) {
   mtapi_status_t local_status = MTAPI_ERR_UNKNOWN;
@@ -569,7 +1120,8 @@ static mtapi_status_t embb_mtapi_network_handle_cancel_task(
           embb_mtapi_network_task_t * network_task =
             (embb_mtapi_network_task_t*)task->attributes.user_data;
           // is this task the one matching the given remote task?
-          if (remote_task_id == network_task->remote_task_id &&
+          if (connection == network_task->connection &&
+            remote_task_id == network_task->remote_task_id &&
             remote_task_tag == network_task->remote_task_tag) {
             mtapi_task_cancel(task->handle, &local_status);
             break;
@@ -582,214 +1134,528 @@ static mtapi_status_t embb_mtapi_network_handle_cancel_task(
   return local_status;
 }
 
-static int embb_mtapi_network_thread(void * args) {
-  embb_mtapi_network_plugin_t * plugin = &embb_mtapi_network_plugin;
-  embb_mtapi_network_buffer_t * buffer = &plugin->recv_buffer;
+static void embb_mtapi_network_dispatch(
+  embb_mtapi_network_connection_t * connection,
+  embb_mtapi_network_buffer_t * buffer,
+  int32_t operation,
+  int packet_size) {
+  switch (operation) {
+  case EMBB_MTAPI_NETWORK_START_TASK:
+    embb_mtapi_network_handle_start_task(connection, buffer, packet_size);
+    break;
+  case EMBB_MTAPI_NETWORK_RETURN_RESULT:
+    embb_mtapi_network_handle_return_result(
+      connection, buffer, packet_size);
+    break;
+  case EMBB_MTAPI_NETWORK_RETURN_FAILURE:
+    embb_mtapi_network_handle_return_failure(
+      connection, buffer, packet_size);
+    break;
+  case EMBB_MTAPI_NETWORK_CANCEL_TASK:
+    embb_mtapi_network_handle_cancel_task(connection, buffer, packet_size);
+    break;
+  default:
+    // invalid, ignore
+    break;
+  }
+}
+
+/**
+ * Receives the next piece of a streamed packet and finishes the packet once
+ * it is complete.
+ * \returns 0 if the connection was closed
+ */
+static int embb_mtapi_network_connection_receive_stream(
+  embb_mtapi_network_connection_t * connection) {
+  embb_mtapi_network_stream_t * stream = &connection->stream;
+  embb_mtapi_network_buffer_t * buffer = &connection->recv_buffer;
+  char * data = stream->data;
+  int size = stream->remaining;
   int err;
 
-  EMBB_UNUSED(args);
+  if (NULL == data) {
+    // nobody wants the data, the receive buffer is empty while streaming
+    data = buffer->data;
+    if (size > buffer->capacity) {
+      size = buffer->capacity;
+    }
+  }
+  err = embb_mtapi_network_socket_recvdata(&connection->socket, data, size);
+  if (0 == err) {
+    return 0;
+  }
+  stream->remaining -= err;
+  if (NULL != stream->data) {
+    stream->data += err;
+  }
 
-  while (embb_atomic_load_int(&plugin->run)) {
-    err = embb_mtapi_network_socket_select(
-      plugin->sockets, plugin->socket_count, 100);
-    if (0 == err) {
-      // listening socket, accept connection
-      embb_mtapi_network_socket_t accept_socket;
-      err = embb_mtapi_network_socket_accept(
-        &plugin->sockets[0], &accept_socket);
-      if (0 < err) {
-        // add socket to socket list
-        plugin->sockets[plugin->socket_count] = accept_socket;
-        plugin->socket_count++;
+  if (0 == stream->remaining) {
+    if (NULL != stream->data) {
+      if (EMBB_MTAPI_NETWORK_START_TASK == stream->operation) {
+        embb_mtapi_network_start_task(connection, stream->network_task);
+      } else {
+        embb_mtapi_network_complete_task(stream->task, stream->task_status);
       }
-    } else if (0 < err) {
-      int32_t operation;
-      int32_t packet_size;
-      embb_mtapi_network_socket_t * socket = &plugin->sockets[err];
-
-      embb_mtapi_network_buffer_clear(buffer);
-
-      err = embb_mtapi_network_socket_recvbuffer_sized(
-        socket, buffer, 4);
-      if (err == 4) {
-        err = embb_mtapi_network_buffer_pop_front_int32(
-          buffer, &packet_size);
-        assert(err == 4);
-
-        embb_mtapi_network_buffer_clear(buffer);
-        err = embb_mtapi_network_socket_recvbuffer_sized(
-          socket, buffer, packet_size);
-        if (err == packet_size) {
-          err = embb_mtapi_network_buffer_pop_front_int32(
-            buffer, &operation);
-          assert(err == 4);
-          packet_size -= 4;
-
-          switch (operation) {
-          case EMBB_MTAPI_NETWORK_START_TASK:
-            embb_mtapi_network_handle_start_task(socket, buffer, packet_size);
-            break;
-          case EMBB_MTAPI_NETWORK_RETURN_RESULT:
-            embb_mtapi_network_handle_return_result(buffer, packet_size);
-            break;
-          case EMBB_MTAPI_NETWORK_RETURN_FAILURE:
-            embb_mtapi_network_handle_return_failure(buffer, packet_size);
-            break;
-          case EMBB_MTAPI_NETWORK_CANCEL_TASK:
-            embb_mtapi_network_handle_cancel_task(buffer, packet_size);
-            break;
-          default:
-            // invalid, ignore
-            break;
-          }
-        }
+    }
+    stream->operation = 0;
+  }
+
+  return 1;
+}
+
+/**
+ * Reads whatever is available and dispatches all complete packets, an
+ * incomplete packet at the end stays in the buffer for the next call.
+ * Packets too big for the buffer are streamed.
+ * \returns 0 if the connection was closed or is out of sync
+ */
+static int embb_mtapi_network_connection_receive(
+  embb_mtapi_network_connection_t * connection) {
+  embb_mtapi_network_buffer_t * buffer = &connection->recv_buffer;
+  embb_mtapi_network_stream_t * stream = &connection->stream;
+  int32_t operation;
+  int32_t packet_size;
+  int start;
+  int err;
+
+  if (0 != stream->operation) {
+    return embb_mtapi_network_connection_receive_stream(connection);
+  }
+
+  err = embb_mtapi_network_socket_recvbuffer_append(
+    &connection->socket, buffer);
+  if (0 == err) {
+    return 0;
+  }
+
+  while (buffer->size - buffer->position >= 4) {
+    start = buffer->position;
+    err = embb_mtapi_network_buffer_pop_front_int32(buffer, &packet_size);
+    assert(err == 4);
+    if (packet_size < 4) {
+      return 0;
+    }
+
+    if (packet_size > buffer->capacity - 4) {
+      // wait for the complete header, everything after it belongs to
+      // this packet
+      if (buffer->size - start < EMBB_MTAPI_NETWORK_MAX_HEADER_SIZE) {
+        buffer->position = start;
+        break;
+      }
+      err = embb_mtapi_network_buffer_pop_front_int32(buffer, &operation);
+      assert(err == 4);
+      if (EMBB_MTAPI_NETWORK_START_TASK != operation &&
+        EMBB_MTAPI_NETWORK_RETURN_RESULT != operation) {
+        return 0;
       }
 
-      embb_mtapi_network_buffer_clear(buffer);
+      // the handler consumes what has arrived and tells where the rest
+      // goes, if it does not the rest is skipped
+      stream->operation = operation;
+      stream->data = NULL;
+      stream->network_task = NULL;
+      embb_mtapi_network_dispatch(
+        connection, buffer, operation, packet_size - 4);
+      stream->remaining = start + 4 + packet_size - buffer->size;
+      buffer->position = buffer->size;
+      if (0 == stream->remaining) {
+        stream->operation = 0;
+      }
+      break;
+    }
+
+    if (buffer->size - buffer->position < packet_size) {
+      // not yet complete
+      buffer->position = start;
+      break;
+    }
+
+    err = embb_mtapi_network_buffer_pop_front_int32(buffer, &operation);
+    assert(err == 4);
+    embb_mtapi_network_dispatch(
+      connection, buffer, operation, packet_size - 4);
+
+    // skip whatever the handler did not consume
+    buffer->position = start + 4 + packet_size;
+  }
+
+  embb_mtapi_network_buffer_compact(buffer);
+
+  return 1;
+}
+
+static void embb_mtapi_network_accept(void) {
+  embb_mtapi_network_plugin_t * plugin = &embb_mtapi_network_plugin;
+  embb_mtapi_network_socket_t accept_socket;
+  embb_mtapi_network_connection_t * connection;
+  int err;
+
+  err = embb_mtapi_network_socket_accept(
+    &plugin->listen_socket, &accept_socket);
+  if (0 < err) {
+    connection = embb_mtapi_network_connection_create(&accept_socket);
+    if (NULL == connection) {
+      embb_mtapi_network_socket_finalize(&accept_socket);
+    } else {
+      // if there is no room left the socket is closed right away
+      embb_mtapi_network_connection_register(connection);
+      embb_mtapi_network_connection_release(connection);
+    }
+  }
+}
+
+static int embb_mtapi_network_thread(void * args) {
+  embb_mtapi_network_plugin_t * plugin = &embb_mtapi_network_plugin;
+  embb_mtapi_network_io_thread_t * io_thread =
+    (embb_mtapi_network_io_thread_t*)args;
+  int count;
+  int ii;
+
+  while (embb_atomic_load_int(&plugin->run)) {
+    count = embb_mtapi_network_poller_wait(&io_thread->poller, 100,
+      io_thread->ready, plugin->max_connections + 1);
+    // serve all connections that became ready in one go
+    for (ii = 0; ii < count; ii++) {
+      embb_mtapi_network_connection_t * connection =
+        (embb_mtapi_network_connection_t*)io_thread->ready[ii];
+      if (NULL == connection) {
+        // listening socket, accept connection
+        embb_mtapi_network_accept();
+      } else if (0 == embb_mtapi_network_connection_receive(connection)) {
+        // peer has gone away, the socket is closed once the last task
+        // using this connection has sent its result
+        embb_atomic_store_int(&connection->closed, 1);
+        embb_mtapi_network_poller_remove(
+          &io_thread->poller, &connection->socket);
+        embb_mtapi_network_connection_fail(connection);
+        embb_mtapi_network_connection_unregister(connection);
+      }
     }
   }
 
   return EMBB_SUCCESS;
 }
 
+static void embb_mtapi_network_io_threads_finalize(mtapi_uint_t count) {
+  embb_mtapi_network_plugin_t * plugin = &embb_mtapi_network_plugin;
+  mtapi_uint_t ii;
+  int err;
+
+  for (ii = 0; ii < count; ii++) {
+    embb_thread_join(&plugin->io_threads[ii].thread, &err);
+  }
+  for (ii = 0; ii < plugin->io_thread_count; ii++) {
+    embb_mtapi_network_poller_finalize(&plugin->io_threads[ii].poller);
+    embb_free(plugin->io_threads[ii].ready);
+  }
+  embb_free(plugin->io_threads);
+  plugin->io_threads = NULL;
+}
+
 void mtapi_network_plugin_initialize(
   MTAPI_IN char * host,
   MTAPI_IN mtapi_uint16_t port,
   MTAPI_IN mtapi_uint16_t max_connections,
   MTAPI_IN mtapi_size_t buffer_size,
   MTAPI_OUT mtapi_status_t* status) {
+  mtapi_network_plugin_initialize_with_attributes(
+    host, port, max_connections, buffer_size, MTAPI_NULL, status);
+}
+
+void mtapi_network_plugin_initialize_with_attributes(
+  MTAPI_IN char * host,
+  MTAPI_IN mtapi_uint16_t port,
+  MTAPI_IN mtapi_uint16_t max_connections,
+  MTAPI_IN mtapi_size_t buffer_size,
+  MTAPI_IN mtapi_network_plugin_attributes_t* attributes,
+  MTAPI_OUT mtapi_status_t* status) {
   embb_mtapi_network_plugin_t * plugin = &embb_mtapi_network_plugin;
+  mtapi_network_plugin_attributes_t default_attributes;
+  mtapi_uint_t ii;
+  int slot;
   int err;
 
   mtapi_status_set(status, MTAPI_ERR_UNKNOWN);
 
-  plugin->socket_count = 0;
-  plugin->buffer_size = 0;
-  plugin->sockets = NULL;
-
-  err = embb_mtapi_network_initialize();
-  if (0 == err) return;
-
-  embb_atomic_init_int(&plugin->run, 0);
-
-  err = embb_mtapi_network_buffer_initialize(
-    &plugin->recv_buffer, (int)buffer_size);
-  if (0 == err) {
-    embb_atomic_destroy_int(&plugin->run);
-    embb_mtapi_network_finalize();
-    return;
+  if (MTAPI_NULL == attributes) {
+    mtapi_network_pluginattr_init(&default_attributes, MTAPI_NULL);
+    attributes = &default_attributes;
   }
-
-  err = embb_mtapi_network_buffer_initialize(
-    &plugin->send_buffer, (int)buffer_size);
-  if (0 == err) {
-    embb_mtapi_network_buffer_finalize(&plugin->recv_buffer);
-    embb_atomic_destroy_int(&plugin->run);
-    embb_mtapi_network_finalize();
+  // a streamed packet's header has to fit into the receive buffer
+  if (0 == attributes->io_threads ||
+    EMBB_MTAPI_NETWORK_MAX_HEADER_SIZE > buffer_size) {
+    mtapi_status_set(status, MTAPI_ERR_PARAMETER);
     return;
   }
+  plugin->flush_delay = attributes->flush_delay;
+  if (0 < plugin->flush_delay) {
+    err = embb_duration_set_microseconds(
+      &plugin->flush_duration, attributes->flush_delay);
+    if (EMBB_SUCCESS != err) {
+      mtapi_status_set(status, MTAPI_ERR_PARAMETER);
+      return;
+    }
+  }
 
   plugin->buffer_size = buffer_size;
+  // max_connections connections (2 sockets each if local)
+  plugin->max_connections = max_connections * 2;
+  plugin->io_thread_count = attributes->io_threads;
 
-  // 1 listening socket and max_connections connections
-  // (2 sockets each if local)
-  plugin->sockets = (embb_mtapi_network_socket_t*)embb_alloc(
-    sizeof(embb_mtapi_network_socket_t) * (1 + max_connections * 2));
-  if (NULL == plugin->sockets) {
-    embb_mtapi_network_buffer_finalize(&plugin->send_buffer);
-    embb_mtapi_network_buffer_finalize(&plugin->recv_buffer);
-    plugin->buffer_size = 0;
-    embb_atomic_destroy_int(&plugin->run);
+  err = embb_mtapi_network_initialize();
+  if (0 == err) return;
+
+  // the free slots are kept right behind the connections
+  plugin->connections = (embb_mtapi_network_connection_t**)embb_alloc(
+    (sizeof(embb_mtapi_network_connection_t*) + sizeof(int)) *
+    (size_t)plugin->max_connections);
+  if (NULL == plugin->connections) {
     embb_mtapi_network_finalize();
     return;
   }
 
-  err = embb_mutex_init(&plugin->send_mutex, 0);
-  if (EMBB_SUCCESS != err) {
-    embb_free(plugin->sockets);
-    plugin->sockets = NULL;
-    embb_mtapi_network_buffer_finalize(&plugin->send_buffer);
-    embb_mtapi_network_buffer_finalize(&plugin->recv_buffer);
-    plugin->buffer_size = 0;
-    embb_atomic_destroy_int(&plugin->run);
+  plugin->io_threads = (embb_mtapi_network_io_thread_t*)embb_alloc(
+    sizeof(embb_mtapi_network_io_thread_t) * plugin->io_thread_count);
+  if (NULL == plugin->io_threads) {
+    embb_free(plugin->connections);
+    plugin->connections = NULL;
     embb_mtapi_network_finalize();
     return;
   }
 
-  err = embb_mtapi_network_socket_initialize(&plugin->sockets[0]);
-  if (0 == err) {
-    embb_mutex_destroy(&plugin->send_mutex);
-    embb_free(plugin->sockets);
-    plugin->sockets = NULL;
-    embb_mtapi_network_buffer_finalize(&plugin->send_buffer);
-    embb_mtapi_network_buffer_finalize(&plugin->recv_buffer);
-    plugin->buffer_size = 0;
-    embb_atomic_destroy_int(&plugin->run);
-    embb_mtapi_network_finalize();
-    return;
+  // every io thread may end up with all connections plus the listener
+  for (ii = 0; ii < plugin->io_thread_count; ii++) {
+    embb_mtapi_network_io_thread_t * io_thread = &plugin->io_threads[ii];
+    io_thread->ready = (void**)embb_alloc(
+      sizeof(void*) * (size_t)(plugin->max_connections + 1));
+    err = 0;
+    if (NULL != io_thread->ready) {
+      err = embb_mtapi_network_poller_initialize(
+        &io_thread->poller, plugin->max_connections + 1);
+      if (0 == err) {
+        embb_free(io_thread->ready);
+      }
+    }
+    if (0 == err) {
+      plugin->io_thread_count = ii;
+      embb_mtapi_network_io_threads_finalize(0);
+      embb_free(plugin->connections);
+      plugin->connections = NULL;
+      embb_mtapi_network_finalize();
+      return;
+    }
   }
-  plugin->socket_count = 1;
 
-  err = embb_mtapi_network_socket_bind_and_listen(
-    &plugin->sockets[0], host, port, max_connections);
+  err = embb_mtapi_network_socket_initialize(&plugin->listen_socket);
+  if (0 != err) {
+    err = embb_mtapi_network_socket_bind_and_listen(
+      &plugin->listen_socket, host, port, max_connections);
+    if (0 != err) {
+      // the first io thread accepts new connections
+      err = embb_mtapi_network_poller_add(
+        &plugin->io_threads[0].poller, &plugin->listen_socket, NULL);
+    }
+    if (0 == err) {
+      embb_mtapi_network_socket_unbind(&plugin->listen_socket);
+      embb_mtapi_network_socket_finalize(&plugin->listen_socket);
+    }
+  }
   if (0 == err) {
-    embb_mtapi_network_socket_finalize(&plugin->sockets[0]);
-    plugin->socket_count = 0;
-    embb_mutex_destroy(&plugin->send_mutex);
-    embb_free(plugin->sockets);
-    plugin->sockets = NULL;
-    embb_mtapi_network_buffer_finalize(&plugin->send_buffer);
-    embb_mtapi_network_buffer_finalize(&plugin->recv_buffer);
-    plugin->buffer_size = 0;
-    embb_atomic_destroy_int(&plugin->run);
+    embb_mtapi_network_io_threads_finalize(0);
+    embb_free(plugin->connections);
+    plugin->connections = NULL;
     embb_mtapi_network_finalize();
     return;
   }
 
-  embb_atomic_store_int(&plugin->run, 1);
-
-  err = embb_thread_create(
-    &plugin->thread, NULL, embb_mtapi_network_thread, NULL);
+  err = embb_mutex_init(&plugin->connection_mutex, EMBB_MUTEX_PLAIN);
   if (EMBB_SUCCESS != err) {
-    embb_atomic_store_int(&plugin->run, 0);
-    embb_mtapi_network_socket_finalize(&plugin->sockets[0]);
-    plugin->socket_count = 0;
-    embb_mutex_destroy(&plugin->send_mutex);
-    embb_free(plugin->sockets);
-    plugin->sockets = NULL;
-    embb_mtapi_network_buffer_finalize(&plugin->send_buffer);
-    embb_mtapi_network_buffer_finalize(&plugin->recv_buffer);
-    plugin->buffer_size = 0;
-    embb_atomic_destroy_int(&plugin->run);
+    embb_mtapi_network_io_threads_finalize(0);
+    embb_mtapi_network_socket_unbind(&plugin->listen_socket);
+    embb_mtapi_network_socket_finalize(&plugin->listen_socket);
+    embb_free(plugin->connections);
+    plugin->connections = NULL;
     embb_mtapi_network_finalize();
     return;
   }
+  // all slots are free, the lowest is used first
+  plugin->free_slots = (int*)(plugin->connections + plugin->max_connections);
+  plugin->free_slot_count = plugin->max_connections;
+  for (slot = 0; slot < plugin->max_connections; slot++) {
+    plugin->connections[slot] = NULL;
+    plugin->free_slots[slot] = plugin->max_connections - 1 - slot;
+  }
+  embb_atomic_init_int(&plugin->run, 1);
+
+  for (ii = 0; ii < plugin->io_thread_count; ii++) {
+    err = embb_thread_create(&plugin->io_threads[ii].thread, NULL,
+      embb_mtapi_network_thread, &plugin->io_threads[ii]);
+    if (EMBB_SUCCESS != err) {
+      embb_atomic_store_int(&plugin->run, 0);
+      embb_mtapi_network_io_threads_finalize(ii);
+      embb_atomic_destroy_int(&plugin->run);
+      embb_mutex_destroy(&plugin->connection_mutex);
+      embb_mtapi_network_socket_unbind(&plugin->listen_socket);
+      embb_mtapi_network_socket_finalize(&plugin->listen_socket);
+      embb_free(plugin->connections);
+      plugin->connections = NULL;
+      embb_mtapi_network_finalize();
+      return;
+    }
+  }
 
   mtapi_status_set(status, MTAPI_SUCCESS);
 }
 
 void mtapi_network_plugin_finalize(
   MTAPI_OUT mtapi_status_t* status) {
-  mtapi_status_t local_status = MTAPI_SUCCESS;
   embb_mtapi_network_plugin_t * plugin = &embb_mtapi_network_plugin;
-  int err;
+  int slot;
+
+  if (NULL == plugin->io_threads) {
+    mtapi_status_set(status, MTAPI_ERR_UNKNOWN);
+    return;
+  }
 
   embb_atomic_store_int(&plugin->run, 0);
-  embb_thread_join(&plugin->thread, &err);
+  embb_mtapi_network_io_threads_finalize(plugin->io_thread_count);
+  embb_atomic_destroy_int(&plugin->run);
 
-  embb_mutex_destroy(&plugin->send_mutex);
-  embb_mtapi_network_buffer_finalize(&plugin->send_buffer);
+  // drop the plugin's references, connections still used by network
+  // actions or running tasks stay alive until those are done
+  for (slot = 0; slot < plugin->max_connections; slot++) {
+    if (NULL != plugin->connections[slot]) {
+      // nobody receives the answers anymore
+      embb_mtapi_network_connection_fail(plugin->connections[slot]);
+      plugin->connections[slot]->io_thread = NULL;
+      embb_mtapi_network_connection_release(plugin->connections[slot]);
+    }
+  }
+  embb_mutex_destroy(&plugin->connection_mutex);
+  embb_free(plugin->connections);
+  plugin->connections = NULL;
 
-  embb_mtapi_network_buffer_finalize(&plugin->recv_buffer);
+  embb_mtapi_network_socket_unbind(&plugin->listen_socket);
+  embb_mtapi_network_socket_finalize(&plugin->listen_socket);
 
-  embb_mtapi_network_socket_finalize(&plugin->sockets[0]);
-  embb_free(plugin->sockets);
+  embb_mtapi_network_finalize();
 
-  embb_atomic_destroy_int(&plugin->run);
+  mtapi_status_set(status, MTAPI_SUCCESS);
+}
 
-  embb_mtapi_network_finalize();
+static int embb_mtapi_network_link_connect(
+  embb_mtapi_network_link_t * link) {
+  embb_mtapi_network_socket_t socket;
+  embb_mtapi_network_connection_t * connection = NULL;
+  int err;
 
-  mtapi_status_set(status, local_status);
+  err = embb_mtapi_network_socket_initialize(&socket);
+  if (0 != err) {
+    err = embb_mtapi_network_socket_connect(&socket, link->host, link->port);
+    if (0 != err) {
+      connection = embb_mtapi_network_connection_create(&socket);
+    }
+    if (NULL == connection) {
+      embb_mtapi_network_socket_finalize(&socket);
+    }
+  }
+
+  if (NULL != connection) {
+    // results come back on the same connection
+    err = embb_mtapi_network_connection_register(connection);
+    if (0 != err) {
+      link->connection = connection;
+      return 1;
+    }
+    embb_mtapi_network_connection_release(connection);
+  }
+
+  return 0;
+}
+
+static void embb_mtapi_network_link_disconnect(
+  embb_mtapi_network_link_t * link) {
+  embb_mtapi_network_connection_t * connection = link->connection;
+
+  if (NULL != connection) {
+    // senders and the io thread may still use the socket, the io thread
+    // sees the connection closed and stops receiving, the handle is closed
+    // once the last reference is gone
+    embb_mtapi_network_socket_shutdown(&connection->socket);
+    // answers to tasks in flight will not arrive anymore
+    embb_mtapi_network_connection_fail_tasks(connection);
+    embb_mtapi_network_connection_release(connection);
+    link->connection = NULL;
+  }
+}
+
+static void embb_mtapi_network_action_destroy(
+  embb_mtapi_network_action_t * action) {
+  mtapi_uint_t ii;
+
+  for (ii = 0; ii < action->link_count; ii++) {
+    embb_mtapi_network_link_disconnect(&action->links[ii]);
+    embb_free(action->links[ii].host);
+  }
+  embb_free(action->links);
+  embb_mutex_destroy(&action->mutex);
+  embb_free(action);
+}
+
+// Picks the live connection with the fewest outstanding tasks, replacing
+// lost connections on the way. Among equally loaded connections, the one
+// after the previously picked one wins, otherwise tasks that are started one
+// at a time would all go to the first endpoint. The returned connection has
+// to be released by the caller, NULL is returned if no endpoint is reachable.
+static embb_mtapi_network_connection_t *
+  embb_mtapi_network_action_select_connection(
+    embb_mtapi_network_action_t * action) {
+  embb_mtapi_network_connection_t * best = NULL;
+  embb_mtapi_network_link_t * link;
+  embb_duration_t interval;
+  embb_time_t now;
+  mtapi_uint_t best_index = 0;
+  int best_outstanding = 0;
+  int outstanding;
+  mtapi_uint_t ii;
+  mtapi_uint_t index;
+
+  embb_time_now(&now);
+  embb_mutex_lock(&action->mutex);
+  for (ii = 0; ii < action->link_count; ii++) {
+    index = (action->next_link + ii) % action->link_count;
+    link = &action->links[index];
+    if (NULL != link->connection &&
+      embb_atomic_load_int(&link->connection->closed)) {
+      embb_mtapi_network_link_disconnect(link);
+      link->retry_time = now;
+    }
+    if (NULL == link->connection &&
+      0 <= embb_time_compare(&now, &link->retry_time)) {
+      if (0 == embb_mtapi_network_link_connect(link)) {
+        // do not hammer an unreachable endpoint
+        embb_duration_set_milliseconds(
+          &interval, EMBB_MTAPI_NETWORK_RECONNECT_INTERVAL_MS);
+        embb_time_in(&link->retry_time, &interval);
+      }
+    }
+    if (NULL != link->connection) {
+      outstanding = embb_atomic_load_int(&link->connection->outstanding);
+      if (NULL == best || outstanding < best_outstanding) {
+        best = link->connection;
+        best_index = index;
+        best_outstanding = outstanding;
+      }
+    }
+  }
+  if (NULL != best) {
+    embb_mtapi_network_connection_acquire(best);
+    action->next_link = (best_index + 1) % action->link_count;
+  }
+  embb_mutex_unlock(&action->mutex);
+
+  return best;
 }
 
 static void network_task_start(
@@ -813,15 +1679,14 @@ static void network_task_start(
 
         embb_mtapi_network_action_t * network_action =
           (embb_mtapi_network_action_t*)local_action->plugin_data;
-        embb_mtapi_network_buffer_t * send_buf = &network_action->send_buffer;
+        embb_mtapi_network_message_t message;
+        embb_mtapi_network_buffer_t header;
 
-        // serialize sending
-        embb_mutex_lock(&network_action->send_mutex);
-        embb_mtapi_network_buffer_clear(send_buf);
+        embb_mtapi_network_message_initialize(&message, &header);
 
-        // actual counts bytes actually put into the buffer
+        // actual counts bytes actually put into the packet
         int actual = 0;
-        // expected counts bytes we intended to put into the buffer
+        // expected counts bytes we intended to put into the packet
         int expected =
           4 +                                  // operation
           4 +                                  // domain_id
@@ -833,59 +1698,72 @@ static void network_task_start(
 
         // packet size
         actual += embb_mtapi_network_buffer_push_back_int32(
-          send_buf, (int32_t)expected);
+          &header, (int32_t)expected);
         expected += 4;
 
         // operation is "start task"
         actual += embb_mtapi_network_buffer_push_back_int32(
-          send_buf, EMBB_MTAPI_NETWORK_START_TASK);
+          &header, EMBB_MTAPI_NETWORK_START_TASK);
 
         // domain_id
         actual += embb_mtapi_network_buffer_push_back_int32(
-          send_buf, (int32_t)network_action->domain_id);
+          &header, (int32_t)network_action->domain_id);
 
         // job_id
         actual += embb_mtapi_network_buffer_push_back_int32(
-          send_buf, (int32_t)network_action->job_id);
+          &header, (int32_t)network_action->job_id);
 
         // priority
         actual += embb_mtapi_network_buffer_push_back_int32(
-          send_buf, (int32_t)local_task->attributes.priority);
+          &header, (int32_t)local_task->attributes.priority);
 
         // task handle
         actual += embb_mtapi_network_buffer_push_back_int32(
-          send_buf, (int32_t)local_task->handle.id);
+          &header, (int32_t)local_task->handle.id);
         actual += embb_mtapi_network_buffer_push_back_int32(
-          send_buf, (int32_t)local_task->handle.tag);
+          &header, (int32_t)local_task->handle.tag);
 
         // result size
         actual += embb_mtapi_network_buffer_push_back_int32(
-          send_buf, (int32_t)local_task->result_size);
+          &header, (int32_t)local_task->result_size);
 
         // arguments buffer
         actual += embb_mtapi_network_buffer_push_back_int32(
-          send_buf, (int32_t)local_task->arguments_size);
-        actual += embb_mtapi_network_buffer_push_back_rawdata(
-          send_buf, (int32_t)local_task->arguments_size, local_task->arguments);
-
-        // check if everything fit into the buffer
-        if (actual == expected) {
+          &header, (int32_t)local_task->arguments_size);
+        // the arguments are sent right from the task's argument buffer
+        actual += (int)local_task->arguments_size;
+
+        // arguments too big for the receive buffer on the other side are
+        // streamed
+        embb_mtapi_network_connection_t * connection = NULL;
+        if (actual == expected && local_task->arguments_size <=
+          EMBB_MTAPI_NETWORK_MAX_PAYLOAD_SIZE) {
+          connection =
+            embb_mtapi_network_action_select_connection(network_action);
+        }
+        if (NULL != connection) {
+          message.header_size = header.size;
+          message.payload = local_task->arguments;
+          message.payload_size = (int)local_task->arguments_size;
           embb_atomic_store_int(&local_task->state, MTAPI_TASK_RUNNING);
-          int sent = embb_mtapi_network_socket_sendbuffer(
-            &network_action->socket, send_buf);
-          // was everything sent?
-          if (sent == send_buf->size) {
+          // from now on the task fails if the connection is lost
+          if (!embb_mtapi_network_connection_track_task(connection, task)) {
+            embb_atomic_store_int(&local_task->state, MTAPI_TASK_ERROR);
+          } else if (embb_mtapi_network_connection_send(
+            connection, &message)) {
             // we've done it, success!
             mtapi_status_set(status, MTAPI_SUCCESS);
-          } else {
+          } else if (embb_mtapi_network_connection_untrack_task(
+            connection, task)) {
             // could not send the whole task, this will fail on the remote side,
             // so we can safely assume that the task is in error
             embb_atomic_store_int(&local_task->state, MTAPI_TASK_ERROR);
+          } else {
+            // the lost connection has failed the task already
+            mtapi_status_set(status, MTAPI_SUCCESS);
           }
+          embb_mtapi_network_connection_release(connection);
         }
-
-        embb_mtapi_network_buffer_clear(send_buf);
-        embb_mutex_unlock(&network_action->send_mutex);
       }
     }
   }
@@ -912,40 +1790,57 @@ static void network_task_cancel(
 
         embb_mtapi_network_action_t * network_action =
           (embb_mtapi_network_action_t*)local_action->plugin_data;
-        embb_mtapi_network_buffer_t * send_buf = &network_action->send_buffer;
+        embb_mtapi_network_connection_t * connection;
+        embb_mtapi_network_message_t message;
+        mtapi_uint_t ii;
+        int sent = 0;
+        embb_mtapi_network_buffer_t header;
 
-        // serialize sending
-        embb_mutex_lock(&network_action->send_mutex);
-        embb_mtapi_network_buffer_clear(send_buf);
+        embb_mtapi_network_message_initialize(&message, &header);
 
-        // actual counts bytes actually put into the buffer
+        // actual counts bytes actually put into the packet
         int actual = 0;
-        // expected counts bytes we intended to put into the buffer
+        // expected counts bytes we intended to put into the packet
         int expected =
           4 +    // operation
           4 + 4; // task handle
 
         // packet size
         actual += embb_mtapi_network_buffer_push_back_int32(
-          send_buf, (int32_t)expected);
+          &header, (int32_t)expected);
         expected += 4;
 
         // operation is "cancel task"
         actual += embb_mtapi_network_buffer_push_back_int32(
-          send_buf, EMBB_MTAPI_NETWORK_CANCEL_TASK);
+          &header, EMBB_MTAPI_NETWORK_CANCEL_TASK);
 
         // task handle
         actual += embb_mtapi_network_buffer_push_back_int32(
-          send_buf, (int32_t)local_task->handle.id);
+          &header, (int32_t)local_task->handle.id);
         actual += embb_mtapi_network_buffer_push_back_int32(
-          send_buf, (int32_t)local_task->handle.tag);
+          &header, (int32_t)local_task->handle.tag);
 
-        // check if everything fit into the buffer
+        // check if everything fit into the header
         if (actual == expected) {
-          int sent = embb_mtapi_network_socket_sendbuffer(
-            &network_action->socket, send_buf);
+          message.header_size = header.size;
+          // the task may run on any of the endpoints, the remote side only
+          // cancels it on the connection it was started on
+          for (ii = 0; ii < network_action->link_count; ii++) {
+            embb_mutex_lock(&network_action->mutex);
+            connection = network_action->links[ii].connection;
+            if (NULL != connection) {
+              embb_mtapi_network_connection_acquire(connection);
+            }
+            embb_mutex_unlock(&network_action->mutex);
+            if (NULL != connection) {
+              message.state = EMBB_MTAPI_NETWORK_MESSAGE_QUEUED;
+              message.next = NULL;
+              sent |= embb_mtapi_network_connection_send(connection, &message);
+              embb_mtapi_network_connection_release(connection);
+            }
+          }
           // was everything sent?
-          if (sent == send_buf->size) {
+          if (sent) {
             // we've done it, success!
             mtapi_status_set(status, MTAPI_SUCCESS);
           } else {
@@ -954,9 +1849,6 @@ static void network_task_cancel(
         } else {
           embb_atomic_store_int(&local_task->state, MTAPI_TASK_ERROR);
         }
-
-        embb_mtapi_network_buffer_clear(send_buf);
-        embb_mutex_unlock(&network_action->send_mutex);
       }
     }
   }
@@ -977,11 +1869,7 @@ static void network_action_finalize(
       embb_mtapi_network_action_t * network_action =
         (embb_mtapi_network_action_t *)local_action->plugin_data;
 
-      embb_mutex_destroy(&network_action->send_mutex);
-      embb_mtapi_network_buffer_finalize(&network_action->send_buffer);
-      embb_mtapi_network_socket_finalize(&network_action->socket);
-
-      embb_free(network_action);
+      embb_mtapi_network_action_destroy(network_action);
       local_status = MTAPI_SUCCESS;
     }
   }
@@ -989,63 +1877,102 @@ static void network_action_finalize(
   mtapi_status_set(status, local_status);
 }
 
-mtapi_action_hndl_t mtapi_network_action_create(
+mtapi_action_hndl_t mtapi_network_action_create_pooled(
   MTAPI_IN mtapi_domain_t domain_id,
   MTAPI_IN mtapi_job_id_t local_job_id,
   MTAPI_IN mtapi_job_id_t remote_job_id,
-  MTAPI_IN char * host,
-  MTAPI_IN mtapi_uint16_t port,
+  MTAPI_IN mtapi_network_endpoint_t * endpoints,
+  MTAPI_IN mtapi_uint_t endpoint_count,
+  MTAPI_IN mtapi_uint_t connections_per_endpoint,
   MTAPI_OUT mtapi_status_t* status) {
   mtapi_status_t local_status = MTAPI_ERR_UNKNOWN;
-  embb_mtapi_network_plugin_t * plugin = &embb_mtapi_network_plugin;
-  embb_mtapi_network_action_t * action =
-    (embb_mtapi_network_action_t*)embb_alloc(
-      sizeof(embb_mtapi_network_action_t));
+  embb_mtapi_network_action_t * action;
+  embb_mtapi_network_link_t * link;
   mtapi_action_hndl_t action_hndl = { 0, 0 };
-  int err;
+  size_t host_size;
+  mtapi_uint_t ii;
+  int connected = 0;
+
+  if (NULL == endpoints || 0 == endpoint_count ||
+    0 == connections_per_endpoint) {
+    mtapi_status_set(status, MTAPI_ERR_PARAMETER);
+    return action_hndl;
+  }
 
-  if (NULL != action) {
-    action->domain_id = domain_id;
-    action->job_id = remote_job_id;
+  action = (embb_mtapi_network_action_t*)embb_alloc(
+    sizeof(embb_mtapi_network_action_t));
+  if (NULL == action) {
+    mtapi_status_set(status, local_status);
+    return action_hndl;
+  }
+  action->domain_id = domain_id;
+  action->job_id = remote_job_id;
+  action->link_count = 0;
+  action->next_link = 0;
+  action->links = (embb_mtapi_network_link_t*)embb_alloc(
+    sizeof(embb_mtapi_network_link_t) *
+    endpoint_count * connections_per_endpoint);
+  if (NULL == action->links) {
+    embb_free(action);
+    mtapi_status_set(status, local_status);
+    return action_hndl;
+  }
+  if (EMBB_SUCCESS != embb_mutex_init(&action->mutex, EMBB_MUTEX_PLAIN)) {
+    embb_free(action->links);
+    embb_free(action);
+    mtapi_status_set(status, local_status);
+    return action_hndl;
+  }
 
-    err = embb_mtapi_network_buffer_initialize(
-      &action->send_buffer, (int)plugin->buffer_size);
-    if (0 != err) {
-      err = embb_mutex_init(&action->send_mutex, 0);
-      if (EMBB_SUCCESS == err) {
-        action->host = host;
-        action->port = port;
-        embb_mtapi_network_socket_initialize(&action->socket);
-        err = embb_mtapi_network_socket_connect(&action->socket, host, port);
-        if (0 != err) {
-          // store socket for select
-          plugin->sockets[plugin->socket_count] = action->socket;
-          plugin->socket_count++;
-
-          action_hndl = mtapi_ext_plugin_action_create(
-            local_job_id,
-            network_task_start,
-            network_task_cancel,
-            network_action_finalize,
-            action,
-            NULL, 0, // no node local data obviously
-            MTAPI_NULL,
-            &local_status);
-        } else {
-          embb_mutex_destroy(&action->send_mutex);
-          embb_mtapi_network_socket_finalize(&action->socket);
-          embb_mtapi_network_buffer_finalize(&action->send_buffer);
-          embb_free(action);
-        }
-      } else {
-        embb_mtapi_network_buffer_finalize(&action->send_buffer);
-        embb_free(action);
-      }
-    } else {
-      embb_free(action);
+  for (ii = 0; ii < endpoint_count * connections_per_endpoint; ii++) {
+    mtapi_network_endpoint_t const * endpoint =
+      &endpoints[ii / connections_per_endpoint];
+    link = &action->links[ii];
+    link->port = endpoint->port;
+    link->connection = NULL;
+    embb_time_now(&link->retry_time);
+    host_size = strlen(endpoint->host) + 1;
+    link->host = (char*)embb_alloc(host_size);
+    if (NULL == link->host) {
+      break;
     }
+    memcpy(link->host, endpoint->host, host_size);
+    action->link_count++;
+    // unreachable endpoints are retried when tasks are started
+    connected |= embb_mtapi_network_link_connect(link);
+  }
+
+  if (action->link_count == endpoint_count * connections_per_endpoint &&
+    connected) {
+    action_hndl = mtapi_ext_plugin_action_create(
+      local_job_id,
+      network_task_start,
+      network_task_cancel,
+      network_action_finalize,
+      action,
+      NULL, 0, // no node local data obviously
+      MTAPI_NULL,
+      &local_status);
+  }
+  if (MTAPI_SUCCESS != local_status) {
+    embb_mtapi_network_action_destroy(action);
   }
 
   mtapi_status_set(status, local_status);
   return action_hndl;
 }
+
+mtapi_action_hndl_t mtapi_network_action_create(
+  MTAPI_IN mtapi_domain_t domain_id,
+  MTAPI_IN mtapi_job_id_t local_job_id,
+  MTAPI_IN mtapi_job_id_t remote_job_id,
+  MTAPI_IN char * host,
+  MTAPI_IN mtapi_uint16_t port,
+  MTAPI_OUT mtapi_status_t* status) {
+  mtapi_network_endpoint_t endpoint;
+
+  endpoint.host = host;
+  endpoint.port = port;
+  return mtapi_network_action_create_pooled(domain_id,
+    local_job_id, remote_job_id, &endpoint, 1, 1, status);
+}
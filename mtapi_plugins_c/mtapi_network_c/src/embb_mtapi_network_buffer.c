@@ -44,6 +44,16 @@ int embb_mtapi_network_buffer_initialize(
   return result;
 }
 
+void embb_mtapi_network_buffer_wrap(
+  embb_mtapi_network_buffer_t * that,
+  void * data,
+  int capacity) {
+  that->position = 0;
+  that->size = 0;
+  that->capacity = capacity;
+  that->data = (char*)data;
+}
+
 void embb_mtapi_network_buffer_finalize(
   embb_mtapi_network_buffer_t * that) {
   that->position = 0;
@@ -61,6 +71,16 @@ void embb_mtapi_network_buffer_clear(
   that->size = 0;
 }
 
+void embb_mtapi_network_buffer_compact(
+  embb_mtapi_network_buffer_t * that) {
+  if (0 < that->position) {
+    memmove(that->data, that->data + that->position,
+      (size_t)(that->size - that->position));
+    that->size -= that->position;
+    that->position = 0;
+  }
+}
+
 int embb_mtapi_network_buffer_push_back_int8(
   embb_mtapi_network_buffer_t * that,
   int8_t value) {
@@ -48,6 +48,16 @@ int embb_mtapi_network_buffer_initialize(
   int capacity
 );
 
+/**
+ * Uses \c data as storage, e.g. for a small header on the stack. The buffer
+ * does not own the memory, so it must not be finalized.
+ */
+void embb_mtapi_network_buffer_wrap(
+  embb_mtapi_network_buffer_t * that,
+  void * data,
+  int capacity
+);
+
 void embb_mtapi_network_buffer_finalize(
   embb_mtapi_network_buffer_t * that
 );
@@ -56,6 +66,13 @@ void embb_mtapi_network_buffer_clear(
   embb_mtapi_network_buffer_t * that
 );
 
+/**
+ * Drops the data already popped and moves the rest to the front.
+ */
+void embb_mtapi_network_buffer_compact(
+  embb_mtapi_network_buffer_t * that
+);
+
 int embb_mtapi_network_buffer_push_back_int8(
   embb_mtapi_network_buffer_t * that,
   int8_t value
@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <embb_mtapi_network_poller.h>
+#include <embb/base/c/memory_allocation.h>
+#include <embb/base/c/internal/config.h>
+
+#ifdef EMBB_MTAPI_NETWORK_POLLER_EPOLL
+
+#include <unistd.h>
+
+int embb_mtapi_network_poller_initialize(
+  embb_mtapi_network_poller_t * that,
+  int capacity) {
+  that->capacity = capacity;
+  that->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (0 > that->epoll_fd) {
+    return 0;
+  }
+  that->events = (struct epoll_event*)embb_alloc(
+    sizeof(struct epoll_event) * (size_t)capacity);
+  if (NULL == that->events) {
+    close(that->epoll_fd);
+    that->epoll_fd = -1;
+    return 0;
+  }
+  return 1;
+}
+
+void embb_mtapi_network_poller_finalize(
+  embb_mtapi_network_poller_t * that) {
+  if (0 <= that->epoll_fd) {
+    close(that->epoll_fd);
+    that->epoll_fd = -1;
+  }
+  if (NULL != that->events) {
+    embb_free(that->events);
+    that->events = NULL;
+  }
+  that->capacity = 0;
+}
+
+int embb_mtapi_network_poller_add(
+  embb_mtapi_network_poller_t * that,
+  embb_mtapi_network_socket_t * socket,
+  void * user_data) {
+  struct epoll_event event;
+  event.events = EPOLLIN;
+  event.data.ptr = user_data;
+  if (0 != epoll_ctl(that->epoll_fd, EPOLL_CTL_ADD, socket->handle, &event)) {
+    return 0;
+  }
+  return 1;
+}
+
+int embb_mtapi_network_poller_remove(
+  embb_mtapi_network_poller_t * that,
+  embb_mtapi_network_socket_t * socket) {
+  if (0 != epoll_ctl(that->epoll_fd, EPOLL_CTL_DEL, socket->handle, NULL)) {
+    return 0;
+  }
+  return 1;
+}
+
+int embb_mtapi_network_poller_wait(
+  embb_mtapi_network_poller_t * that,
+  int timeout,
+  void ** ready,
+  int max_ready) {
+  int count;
+  int ii;
+
+  if (max_ready > that->capacity) {
+    max_ready = that->capacity;
+  }
+  count = epoll_wait(that->epoll_fd, that->events, max_ready, timeout);
+  if (0 > count) {
+    // interrupted or error, treat like a timeout
+    return 0;
+  }
+  for (ii = 0; ii < count; ii++) {
+    ready[ii] = that->events[ii].data.ptr;
+  }
+  return count;
+}
+
+#else // EMBB_MTAPI_NETWORK_POLLER_EPOLL
+
+#ifdef _WIN32
+#include <WinSock2.h>
+#else
+#define SOCKET_ERROR -1
+#include <sys/time.h>
+#include <sys/select.h>
+#include <unistd.h>
+#endif
+
+int embb_mtapi_network_poller_initialize(
+  embb_mtapi_network_poller_t * that,
+  int capacity) {
+  // select() cannot handle more than FD_SETSIZE sockets
+  if (capacity > FD_SETSIZE) {
+    capacity = FD_SETSIZE;
+  }
+  that->capacity = capacity;
+  that->count = 0;
+  that->sockets = (embb_mtapi_network_socket_t*)embb_alloc(
+    sizeof(embb_mtapi_network_socket_t) * (size_t)capacity * 2);
+  that->user_data = (void**)embb_alloc(
+    sizeof(void*) * (size_t)capacity * 2);
+  if (NULL == that->sockets || NULL == that->user_data ||
+    EMBB_SUCCESS != embb_mutex_init(&that->mutex, EMBB_MUTEX_PLAIN)) {
+    if (NULL != that->sockets) embb_free(that->sockets);
+    if (NULL != that->user_data) embb_free(that->user_data);
+    that->sockets = NULL;
+    that->user_data = NULL;
+    return 0;
+  }
+  // the second half is a snapshot used while waiting without the lock
+  that->wait_sockets = that->sockets + capacity;
+  that->wait_user_data = that->user_data + capacity;
+  return 1;
+}
+
+void embb_mtapi_network_poller_finalize(
+  embb_mtapi_network_poller_t * that) {
+  if (NULL != that->sockets) {
+    embb_mutex_destroy(&that->mutex);
+    embb_free(that->sockets);
+    embb_free(that->user_data);
+    that->sockets = NULL;
+    that->user_data = NULL;
+  }
+  that->count = 0;
+  that->capacity = 0;
+}
+
+int embb_mtapi_network_poller_add(
+  embb_mtapi_network_poller_t * that,
+  embb_mtapi_network_socket_t * socket,
+  void * user_data) {
+  int result = 0;
+  embb_mutex_lock(&that->mutex);
+  if (that->count < that->capacity) {
+    that->sockets[that->count] = *socket;
+    that->user_data[that->count] = user_data;
+    that->count++;
+    result = 1;
+  }
+  embb_mutex_unlock(&that->mutex);
+  return result;
+}
+
+int embb_mtapi_network_poller_remove(
+  embb_mtapi_network_poller_t * that,
+  embb_mtapi_network_socket_t * socket) {
+  int result = 0;
+  int ii;
+  embb_mutex_lock(&that->mutex);
+  for (ii = 0; ii < that->count; ii++) {
+    if (that->sockets[ii].handle == socket->handle) {
+      that->count--;
+      that->sockets[ii] = that->sockets[that->count];
+      that->user_data[ii] = that->user_data[that->count];
+      result = 1;
+      break;
+    }
+  }
+  embb_mutex_unlock(&that->mutex);
+  return result;
+}
+
+int embb_mtapi_network_poller_wait(
+  embb_mtapi_network_poller_t * that,
+  int timeout,
+  void ** ready,
+  int max_ready) {
+  fd_set read_set;
+  embb_mtapi_network_socket_t max_fd = { 0 };
+  struct timeval tv;
+  int count;
+  int ready_count = 0;
+  int err;
+  int ii;
+
+  embb_mutex_lock(&that->mutex);
+  count = that->count;
+  for (ii = 0; ii < count; ii++) {
+    that->wait_sockets[ii] = that->sockets[ii];
+    that->wait_user_data[ii] = that->user_data[ii];
+  }
+  embb_mutex_unlock(&that->mutex);
+
+  FD_ZERO(&read_set);
+  for (ii = 0; ii < count; ii++) {
+#ifdef EMBB_PLATFORM_COMPILER_MSVC
+#pragma warning(push)
+#pragma warning(disable: 4548)
+#endif
+    FD_SET(that->wait_sockets[ii].handle, &read_set);
+#ifdef EMBB_PLATFORM_COMPILER_MSVC
+#pragma warning(pop)
+#endif
+    if (that->wait_sockets[ii].handle > max_fd.handle)
+      max_fd.handle = that->wait_sockets[ii].handle;
+  }
+
+  tv.tv_sec = timeout / 1000;
+  tv.tv_usec = (timeout % 1000) * 1000;
+  err = select((int)max_fd.handle + 1, &read_set, NULL, NULL,
+    (timeout >= 0) ? &tv : NULL);
+  if (0 == err || SOCKET_ERROR == err) {
+    return 0;
+  }
+
+  for (ii = 0; ii < count && ready_count < max_ready; ii++) {
+    if (FD_ISSET(that->wait_sockets[ii].handle, &read_set)) {
+      ready[ready_count] = that->wait_user_data[ii];
+      ready_count++;
+    }
+  }
+
+  return ready_count;
+}
+
+#endif // EMBB_MTAPI_NETWORK_POLLER_EPOLL
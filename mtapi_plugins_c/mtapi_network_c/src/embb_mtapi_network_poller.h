@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MTAPI_PLUGINS_C_MTAPI_NETWORK_C_SRC_EMBB_MTAPI_NETWORK_POLLER_H_
+#define MTAPI_PLUGINS_C_MTAPI_NETWORK_C_SRC_EMBB_MTAPI_NETWORK_POLLER_H_
+
+#include <embb_mtapi_network_socket.h>
+#include <embb/base/c/mutex.h>
+
+#if defined(__linux__)
+#define EMBB_MTAPI_NETWORK_POLLER_EPOLL
+#include <sys/epoll.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * Waits for a set of sockets to become readable.
+ *
+ * Uses epoll on Linux, so the number of sockets is only bounded by the
+ * given capacity. Elsewhere it falls back to select() and is bounded by
+ * FD_SETSIZE.
+ */
+struct embb_mtapi_network_poller_struct {
+  int capacity;
+#ifdef EMBB_MTAPI_NETWORK_POLLER_EPOLL
+  int epoll_fd;
+  struct epoll_event * events;
+#else
+  embb_mutex_t mutex;
+  int count;
+  embb_mtapi_network_socket_t * sockets;
+  void ** user_data;
+  embb_mtapi_network_socket_t * wait_sockets;
+  void ** wait_user_data;
+#endif
+};
+
+typedef struct embb_mtapi_network_poller_struct embb_mtapi_network_poller_t;
+
+int embb_mtapi_network_poller_initialize(
+  embb_mtapi_network_poller_t * that,
+  int capacity
+);
+
+void embb_mtapi_network_poller_finalize(
+  embb_mtapi_network_poller_t * that
+);
+
+/**
+ * Adds a socket, \c user_data is reported by
+ * embb_mtapi_network_poller_wait() when the socket becomes readable.
+ * May be called concurrently to embb_mtapi_network_poller_wait().
+ */
+int embb_mtapi_network_poller_add(
+  embb_mtapi_network_poller_t * that,
+  embb_mtapi_network_socket_t * socket,
+  void * user_data
+);
+
+int embb_mtapi_network_poller_remove(
+  embb_mtapi_network_poller_t * that,
+  embb_mtapi_network_socket_t * socket
+);
+
+/**
+ * Waits up to \c timeout milliseconds and stores the user data of all
+ * readable sockets in \c ready.
+ * \returns the number of readable sockets, 0 on timeout or error
+ */
+int embb_mtapi_network_poller_wait(
+  embb_mtapi_network_poller_t * that,
+  int timeout,
+  void ** ready,
+  int max_ready
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MTAPI_PLUGINS_C_MTAPI_NETWORK_C_SRC_EMBB_MTAPI_NETWORK_POLLER_H_
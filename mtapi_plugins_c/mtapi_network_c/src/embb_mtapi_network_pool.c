@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <assert.h>
+
+#include <embb_mtapi_network_pool.h>
+#include <embb/base/c/memory_allocation.h>
+
+/**
+ * Precedes every block handed out by the pool.
+ */
+struct embb_mtapi_network_pool_header_struct {
+  embb_mtapi_network_pool_t * pool;
+  int size_class;                      // -1 for blocks bigger than all classes
+  struct embb_mtapi_network_pool_header_struct * next;
+};
+
+typedef struct embb_mtapi_network_pool_header_struct
+  embb_mtapi_network_pool_header_t;
+
+#define EMBB_MTAPI_NETWORK_POOL_HEADER_SIZE \
+  EMBB_MTAPI_NETWORK_POOL_ALIGN(sizeof(embb_mtapi_network_pool_header_t))
+
+static void embb_mtapi_network_pool_free_list(
+  embb_mtapi_network_pool_header_t * header) {
+  while (NULL != header) {
+    embb_mtapi_network_pool_header_t * next = header->next;
+    embb_free(header);
+    header = next;
+  }
+}
+
+void embb_mtapi_network_pool_initialize(
+  embb_mtapi_network_pool_t * that) {
+  int ii;
+
+  for (ii = 0; ii < EMBB_MTAPI_NETWORK_POOL_CLASSES; ii++) {
+    that->classes[ii].local = NULL;
+    embb_atomic_init_uintptr_t(&that->classes[ii].returned, 0);
+    embb_atomic_init_int(&that->classes[ii].cached, 0);
+  }
+}
+
+void embb_mtapi_network_pool_finalize(
+  embb_mtapi_network_pool_t * that) {
+  int ii;
+
+  for (ii = 0; ii < EMBB_MTAPI_NETWORK_POOL_CLASSES; ii++) {
+    embb_mtapi_network_pool_class_t * size_class = &that->classes[ii];
+    embb_mtapi_network_pool_free_list(
+      (embb_mtapi_network_pool_header_t*)size_class->local);
+    embb_mtapi_network_pool_free_list(
+      (embb_mtapi_network_pool_header_t*)embb_atomic_load_uintptr_t(
+        &size_class->returned));
+    size_class->local = NULL;
+    embb_atomic_destroy_int(&size_class->cached);
+    embb_atomic_destroy_uintptr_t(&size_class->returned);
+  }
+}
+
+void * embb_mtapi_network_pool_allocate(
+  embb_mtapi_network_pool_t * that,
+  size_t size) {
+  embb_mtapi_network_pool_header_t * header = NULL;
+  size_t total = size + EMBB_MTAPI_NETWORK_POOL_HEADER_SIZE;
+  size_t class_size = EMBB_MTAPI_NETWORK_POOL_MIN_SIZE;
+  int ii = 0;
+
+  while (ii < EMBB_MTAPI_NETWORK_POOL_CLASSES && class_size < total) {
+    class_size <<= 1;
+    ii++;
+  }
+
+  if (ii < EMBB_MTAPI_NETWORK_POOL_CLASSES) {
+    embb_mtapi_network_pool_class_t * size_class = &that->classes[ii];
+    if (NULL == size_class->local) {
+      // take everything the other threads returned in one go
+      size_class->local = (void*)embb_atomic_swap_uintptr_t(
+        &size_class->returned, 0);
+    }
+    header = (embb_mtapi_network_pool_header_t*)size_class->local;
+    if (NULL != header) {
+      size_class->local = header->next;
+      embb_atomic_fetch_and_add_int(&size_class->cached, -1);
+    } else {
+      header = (embb_mtapi_network_pool_header_t*)embb_alloc(class_size);
+    }
+  } else {
+    ii = -1;
+    header = (embb_mtapi_network_pool_header_t*)embb_alloc(total);
+  }
+
+  if (NULL == header) {
+    return NULL;
+  }
+  header->pool = that;
+  header->size_class = ii;
+  header->next = NULL;
+  return (char*)header + EMBB_MTAPI_NETWORK_POOL_HEADER_SIZE;
+}
+
+void embb_mtapi_network_pool_free(
+  void * block) {
+  embb_mtapi_network_pool_header_t * header;
+  embb_mtapi_network_pool_class_t * size_class;
+  uintptr_t head;
+
+  if (NULL == block) {
+    return;
+  }
+  header = (embb_mtapi_network_pool_header_t*)
+    ((char*)block - EMBB_MTAPI_NETWORK_POOL_HEADER_SIZE);
+  if (0 > header->size_class) {
+    embb_free(header);
+    return;
+  }
+
+  assert(header->size_class < EMBB_MTAPI_NETWORK_POOL_CLASSES);
+  size_class = &header->pool->classes[header->size_class];
+  if (EMBB_MTAPI_NETWORK_POOL_MAX_CACHED <=
+    embb_atomic_fetch_and_add_int(&size_class->cached, 1)) {
+    // enough blocks of this size around already
+    embb_atomic_fetch_and_add_int(&size_class->cached, -1);
+    embb_free(header);
+    return;
+  }
+
+  head = embb_atomic_load_uintptr_t(&size_class->returned);
+  do {
+    header->next = (embb_mtapi_network_pool_header_t*)head;
+  } while (!embb_atomic_compare_and_swap_uintptr_t(
+    &size_class->returned, &head, (uintptr_t)header));
+}
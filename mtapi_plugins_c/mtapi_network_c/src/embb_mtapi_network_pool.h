@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MTAPI_PLUGINS_C_MTAPI_NETWORK_C_SRC_EMBB_MTAPI_NETWORK_POOL_H_
+#define MTAPI_PLUGINS_C_MTAPI_NETWORK_C_SRC_EMBB_MTAPI_NETWORK_POOL_H_
+
+#include <stddef.h>
+#include <embb/base/c/atomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+// size classes range from 64 bytes to 128 kilobytes, bigger blocks are
+// allocated and freed directly
+#define EMBB_MTAPI_NETWORK_POOL_CLASSES 12
+#define EMBB_MTAPI_NETWORK_POOL_MIN_SIZE 64
+// free blocks kept per size class
+#define EMBB_MTAPI_NETWORK_POOL_MAX_CACHED 32
+
+// rounds a size up so that what follows it stays suitably aligned
+#define EMBB_MTAPI_NETWORK_POOL_ALIGN(size) \
+  (((size_t)(size) + 15) & ~(size_t)15)
+
+struct embb_mtapi_network_pool_class_struct {
+  void * local;                        // free blocks, used by the owner only
+  embb_atomic_uintptr_t returned;      // free blocks handed back by others
+  embb_atomic_int cached;              // blocks in both lists
+};
+
+typedef struct embb_mtapi_network_pool_class_struct
+  embb_mtapi_network_pool_class_t;
+
+/**
+ * Caches memory blocks in power-of-two size classes.
+ *
+ * Blocks are allocated by a single owner thread but may be freed by any
+ * thread. Freed blocks are pushed onto a lock-free stack, the owner takes
+ * the whole stack at once when it runs out of blocks, so there is never more
+ * than one thread popping.
+ */
+struct embb_mtapi_network_pool_struct {
+  embb_mtapi_network_pool_class_t classes[EMBB_MTAPI_NETWORK_POOL_CLASSES];
+};
+
+typedef struct embb_mtapi_network_pool_struct embb_mtapi_network_pool_t;
+
+void embb_mtapi_network_pool_initialize(
+  embb_mtapi_network_pool_t * that
+);
+
+/**
+ * Frees all cached blocks, blocks still in use must not be freed afterwards.
+ */
+void embb_mtapi_network_pool_finalize(
+  embb_mtapi_network_pool_t * that
+);
+
+/**
+ * Allocates a block of at least \c size bytes, must only be called by the
+ * thread owning the pool.
+ * \returns the block, NULL on failure
+ */
+void * embb_mtapi_network_pool_allocate(
+  embb_mtapi_network_pool_t * that,
+  size_t size
+);
+
+/**
+ * Returns a block to the pool it was allocated from, may be called by any
+ * thread.
+ */
+void embb_mtapi_network_pool_free(
+  void * block
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MTAPI_PLUGINS_C_MTAPI_NETWORK_C_SRC_EMBB_MTAPI_NETWORK_POOL_H_
@@ -28,6 +28,9 @@
 
 #include <embb_mtapi_network_socket.h>
 #include <embb/base/c/internal/config.h>
+#include <embb/base/c/internal/unused.h>
+#include <stddef.h>
+#include <limits.h>
 #include <string.h>
 #ifdef _WIN32
 #include <WinSock2.h>
@@ -37,13 +40,126 @@
 #include <sys/time.h>
 #include <sys/select.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <sys/stat.h>
 #include <sys/ioctl.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <errno.h>
 #endif
 
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// maximum number of pieces handed to the kernel at once
+#define EMBB_MTAPI_NETWORK_SOCKET_MAX_VECTOR 64
+
+// hosts starting with this prefix name a unix domain socket
+#define EMBB_MTAPI_NETWORK_SOCKET_LOCAL_SCHEME "unix:"
+#define EMBB_MTAPI_NETWORK_SOCKET_LOCAL_SCHEME_LENGTH 5
+
+int embb_mtapi_network_socket_is_local(
+  char const * host) {
+  return (NULL != host &&
+    0 == strncmp(host, EMBB_MTAPI_NETWORK_SOCKET_LOCAL_SCHEME,
+      EMBB_MTAPI_NETWORK_SOCKET_LOCAL_SCHEME_LENGTH)) ? 1 : 0;
+}
+
+#ifndef _WIN32
+/**
+ * Fills in the address of a unix domain socket, a path name following the
+ * scheme or, on Linux, an abstract name if the path starts with '@'.
+ * \returns the size of the address, 0 if the path does not fit
+ */
+static socklen_t embb_mtapi_network_socket_local_address(
+  char const * host,
+  struct sockaddr_un * addr) {
+  char const * path = host + EMBB_MTAPI_NETWORK_SOCKET_LOCAL_SCHEME_LENGTH;
+  size_t length = strlen(path);
+
+  if (0 == length || length >= sizeof(addr->sun_path)) {
+    return 0;
+  }
+  memset(addr, 0, sizeof(*addr));
+  addr->sun_family = AF_UNIX;
+  memcpy(addr->sun_path, path, length);
+#ifdef __linux__
+  if ('@' == path[0]) {
+    addr->sun_path[0] = '\0';
+    return (socklen_t)(offsetof(struct sockaddr_un, sun_path) + length);
+  }
+#endif
+  return (socklen_t)sizeof(*addr);
+}
+
+/**
+ * Sockets start out as TCP sockets, this replaces the handle by a unix
+ * domain socket once a local address is used.
+ */
+static int embb_mtapi_network_socket_make_local(
+  embb_mtapi_network_socket_t * that) {
+  int handle = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (INVALID_SOCKET == handle) {
+    return 0;
+  }
+  embb_mtapi_network_socket_finalize(that);
+  that->handle = handle;
+  return 1;
+}
+
+/**
+ * Makes room for binding to a named unix domain socket. A socket file left
+ * behind by a previous run that crashed is removed, anything else found at
+ * the path is left alone.
+ * \returns 0 with errno set to EADDRINUSE if the path is taken
+ */
+static int embb_mtapi_network_socket_remove_stale(
+  struct sockaddr_un const * addr,
+  socklen_t addr_size) {
+  struct stat info;
+  int probe;
+  int stale;
+
+  if (0 != lstat(addr->sun_path, &info)) {
+    // nothing there, or bind() will tell what is wrong
+    return 1;
+  }
+  stale = 0;
+  if (S_ISSOCK(info.st_mode)) {
+    // nobody is listening on a stale socket
+    probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (INVALID_SOCKET != probe) {
+      if (SOCKET_ERROR == connect(probe, (struct sockaddr const *)addr,
+        addr_size) && ECONNREFUSED == errno) {
+        stale = 1;
+      }
+      close(probe);
+    }
+  }
+  if (!stale || 0 != unlink(addr->sun_path)) {
+    errno = EADDRINUSE;
+    return 0;
+  }
+  return 1;
+}
+#endif
+
+/**
+ * Packets are coalesced by the sender already, so Nagle's algorithm only
+ * holds back the last small packet of a burst until the peer's delayed
+ * acknowledgement arrives. Fails harmlessly for unix domain sockets.
+ */
+static void embb_mtapi_network_socket_set_nodelay(
+  embb_mtapi_network_socket_t * that) {
+  int flag = 1;
+  setsockopt(that->handle, IPPROTO_TCP, TCP_NODELAY,
+    (char const *)&flag, sizeof(flag));
+}
+
 int embb_mtapi_network_socket_initialize(
   embb_mtapi_network_socket_t * that) {
   that->handle = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
@@ -66,6 +182,17 @@ void embb_mtapi_network_socket_finalize(
   }
 }
 
+void embb_mtapi_network_socket_shutdown(
+  embb_mtapi_network_socket_t * that) {
+  if (INVALID_SOCKET != that->handle) {
+#ifdef _WIN32
+    shutdown(that->handle, SD_BOTH);
+#else
+    shutdown(that->handle, SHUT_RDWR);
+#endif
+  }
+}
+
 int embb_mtapi_network_socket_bind_and_listen(
   embb_mtapi_network_socket_t * that,
   char const * host,
@@ -73,6 +200,32 @@ int embb_mtapi_network_socket_bind_and_listen(
   uint16_t max_connections) {
   struct sockaddr_in in_addr;
 
+  if (embb_mtapi_network_socket_is_local(host)) {
+#ifdef _WIN32
+    return 0;
+#else
+    struct sockaddr_un un_addr;
+    socklen_t un_size = embb_mtapi_network_socket_local_address(
+      host, &un_addr);
+    if (0 == un_size || !embb_mtapi_network_socket_make_local(that)) {
+      return 0;
+    }
+    // only named sockets leave a file behind
+    if ('\0' != un_addr.sun_path[0] &&
+      !embb_mtapi_network_socket_remove_stale(&un_addr, un_size)) {
+      return 0;
+    }
+    if (SOCKET_ERROR == bind(that->handle, (struct sockaddr *)&un_addr,
+      un_size)) {
+      return 0;
+    }
+    if (SOCKET_ERROR == listen(that->handle, max_connections)) {
+      return 0;
+    }
+    return 1;
+#endif
+  }
+
   // bind & listen
   memset(&in_addr, 0, sizeof(in_addr));
   in_addr.sin_family = AF_INET;
@@ -80,6 +233,14 @@ int embb_mtapi_network_socket_bind_and_listen(
     htonl(INADDR_ANY) : inet_addr(host);
   in_addr.sin_port = htons(port);
 
+#ifndef _WIN32
+  // a node that is restarted has to be reachable on its port again right
+  // away, even while connections of its previous run are in TIME_WAIT
+  int reuse = 1;
+  setsockopt(that->handle, SOL_SOCKET, SO_REUSEADDR,
+    (char const *)&reuse, sizeof(reuse));
+#endif
+
   if (SOCKET_ERROR == bind(that->handle, (struct sockaddr *) &in_addr,
     sizeof(in_addr))) {
     return 0;
@@ -92,6 +253,24 @@ int embb_mtapi_network_socket_bind_and_listen(
   return 1;
 }
 
+void embb_mtapi_network_socket_unbind(
+  embb_mtapi_network_socket_t * that) {
+#ifdef _WIN32
+  EMBB_UNUSED(that);
+#else
+  struct sockaddr_un addr;
+  socklen_t addr_size = sizeof(addr);
+
+  // only named unix domain sockets leave a file behind
+  memset(&addr, 0, sizeof(addr));
+  if (INVALID_SOCKET != that->handle &&
+    0 == getsockname(that->handle, (struct sockaddr *)&addr, &addr_size) &&
+    AF_UNIX == addr.sun_family && '\0' != addr.sun_path[0]) {
+    unlink(addr.sun_path);
+  }
+#endif
+}
+
 int embb_mtapi_network_socket_accept(
   embb_mtapi_network_socket_t * that,
   embb_mtapi_network_socket_t * sock) {
@@ -99,6 +278,7 @@ int embb_mtapi_network_socket_accept(
   if (INVALID_SOCKET == sock->handle) {
     return 0;
   } else {
+    embb_mtapi_network_socket_set_nodelay(sock);
     return 1;
   }
 }
@@ -107,15 +287,32 @@ int embb_mtapi_network_socket_connect(
   embb_mtapi_network_socket_t * that,
   const char * host,
   uint16_t port) {
-  struct sockaddr_in addr;
+  struct sockaddr_in in_addr;
+  struct sockaddr * addr = (struct sockaddr *)&in_addr;
+  int addr_size = (int)sizeof(in_addr);
+#ifndef _WIN32
+  struct sockaddr_un un_addr;
+#endif
 
-  memset(&addr, 0, sizeof(addr));
-  addr.sin_family = AF_INET;
-  addr.sin_addr.s_addr = inet_addr(host);
-  addr.sin_port = htons(port);
+  if (embb_mtapi_network_socket_is_local(host)) {
+#ifdef _WIN32
+    return 0;
+#else
+    // the port is meaningless for unix domain sockets
+    addr_size = (int)embb_mtapi_network_socket_local_address(host, &un_addr);
+    if (0 == addr_size || !embb_mtapi_network_socket_make_local(that)) {
+      return 0;
+    }
+    addr = (struct sockaddr *)&un_addr;
+#endif
+  } else {
+    memset(&in_addr, 0, sizeof(in_addr));
+    in_addr.sin_family = AF_INET;
+    in_addr.sin_addr.s_addr = inet_addr(host);
+    in_addr.sin_port = htons(port);
+  }
 
-  if (SOCKET_ERROR == connect(that->handle, (struct sockaddr *)&addr,
-    sizeof(addr))) {
+  if (SOCKET_ERROR == connect(that->handle, addr, addr_size)) {
 #ifdef _WIN32
     int err = WSAGetLastError();
     if (WSAEWOULDBLOCK != err)
@@ -125,6 +322,7 @@ int embb_mtapi_network_socket_connect(
       return 0;
   }
 
+  embb_mtapi_network_socket_set_nodelay(that);
   return 1;
 }
 
@@ -197,6 +395,98 @@ int embb_mtapi_network_socket_sendbuffer(
   }
 }
 
+size_t embb_mtapi_network_socket_sendvector(
+  embb_mtapi_network_socket_t * that,
+  embb_mtapi_network_socket_vector_t * vector,
+  int count) {
+#ifdef _WIN32
+  WSABUF chunks[EMBB_MTAPI_NETWORK_SOCKET_MAX_VECTOR];
+  DWORD sent;
+#else
+  struct iovec chunks[EMBB_MTAPI_NETWORK_SOCKET_MAX_VECTOR];
+  struct msghdr msg;
+  ssize_t sent;
+#endif
+  size_t total = 0;
+  size_t done;
+  size_t left;
+  int first = 0;
+  size_t offset = 0;  // bytes of vector[first] already sent
+
+  while (first < count) {
+    int chunk_count = 0;
+    int ii;
+
+    for (ii = first;
+      ii < count && chunk_count < EMBB_MTAPI_NETWORK_SOCKET_MAX_VECTOR;
+      ii++) {
+      char * data = (char*)vector[ii].data;
+      size_t size = vector[ii].size;
+      if (ii == first) {
+        data += offset;
+        size -= offset;
+      }
+      if (0 < size) {
+#ifdef _WIN32
+        // larger pieces go out in several calls
+        if (size > ULONG_MAX) {
+          size = ULONG_MAX;
+        }
+        chunks[chunk_count].buf = data;
+        chunks[chunk_count].len = (ULONG)size;
+#else
+        chunks[chunk_count].iov_base = data;
+        chunks[chunk_count].iov_len = size;
+#endif
+        chunk_count++;
+      }
+    }
+    if (0 == chunk_count) {
+      break;
+    }
+
+#ifdef _WIN32
+    if (0 != WSASend(that->handle, chunks, (DWORD)chunk_count, &sent, 0,
+      NULL, NULL)) {
+      return 0;
+    }
+#else
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = chunks;
+    msg.msg_iovlen = (size_t)chunk_count;
+    sent = sendmsg(that->handle, &msg, MSG_NOSIGNAL);
+    if (0 >= sent) {
+      if (0 > sent && EINTR == errno) {
+        continue;
+      }
+      return 0;
+    }
+#endif
+    done = (size_t)sent;
+    total += done;
+
+    // skip everything that went out completely
+    while (first < count && 0 < done) {
+      left = vector[first].size - offset;
+      if (done >= left) {
+        done -= left;
+        first++;
+        offset = 0;
+      } else {
+        offset += done;
+        done = 0;
+      }
+    }
+    // and empty pieces at the end
+    while (first < count && vector[first].size == offset) {
+      first++;
+      offset = 0;
+    }
+  }
+
+  return total;
+}
+
 int embb_mtapi_network_socket_recvbuffer_sized(
   embb_mtapi_network_socket_t * that,
   embb_mtapi_network_buffer_t * buffer,
@@ -240,6 +530,44 @@ int embb_mtapi_network_socket_recvbuffer_sized(
   return buffer->size;
 }
 
+int embb_mtapi_network_socket_recvbuffer_append(
+  embb_mtapi_network_socket_t * that,
+  embb_mtapi_network_buffer_t * buffer) {
+  int err;
+  if (buffer->size >= buffer->capacity)
+    return 0;
+  err = recv(that->handle, buffer->data + buffer->size,
+    buffer->capacity - buffer->size, 0);
+#ifndef _WIN32
+  while (0 > err && EINTR == errno) {
+    err = recv(that->handle, buffer->data + buffer->size,
+      buffer->capacity - buffer->size, 0);
+  }
+#endif
+  if (0 >= err)
+    return 0;
+  buffer->size += err;
+  return err;
+}
+
+int embb_mtapi_network_socket_recvdata(
+  embb_mtapi_network_socket_t * that,
+  void * data,
+  int size) {
+  int err;
+  if (0 >= size)
+    return 0;
+  err = recv(that->handle, (char*)data, size, 0);
+#ifndef _WIN32
+  while (0 > err && EINTR == errno) {
+    err = recv(that->handle, (char*)data, size, 0);
+  }
+#endif
+  if (0 >= err)
+    return 0;
+  return err;
+}
+
 int embb_mtapi_network_socket_recvbuffer(
   embb_mtapi_network_socket_t * that,
   embb_mtapi_network_buffer_t * buffer) {
@@ -27,6 +27,7 @@
 #ifndef MTAPI_PLUGINS_C_MTAPI_NETWORK_C_SRC_EMBB_MTAPI_NETWORK_SOCKET_H_
 #define MTAPI_PLUGINS_C_MTAPI_NETWORK_C_SRC_EMBB_MTAPI_NETWORK_SOCKET_H_
 
+#include <stddef.h>
 #include <stdint.h>
 #include <embb_mtapi_network_buffer.h>
 
@@ -49,6 +50,26 @@ struct embb_mtapi_network_socket_struct {
 
 typedef struct embb_mtapi_network_socket_struct embb_mtapi_network_socket_t;
 
+/**
+ * One piece of data for embb_mtapi_network_socket_sendvector().
+ */
+struct embb_mtapi_network_socket_vector_struct {
+  void const * data;
+  size_t size;
+};
+
+typedef struct embb_mtapi_network_socket_vector_struct
+  embb_mtapi_network_socket_vector_t;
+
+/**
+ * Checks whether the host names a unix domain socket, i.e. has the form
+ * "unix:<path>" instead of an IPv4 address.
+ * \returns 1 for unix domain socket addresses, 0 otherwise
+ */
+int embb_mtapi_network_socket_is_local(
+  char const * host
+);
+
 int embb_mtapi_network_socket_initialize(
   embb_mtapi_network_socket_t * that
 );
@@ -57,6 +78,15 @@ void embb_mtapi_network_socket_finalize(
   embb_mtapi_network_socket_t * that
 );
 
+/**
+ * Shuts down both directions without closing the handle, so threads still
+ * using the socket fail or see the connection closed instead of working on
+ * a handle that may have been reused meanwhile.
+ */
+void embb_mtapi_network_socket_shutdown(
+  embb_mtapi_network_socket_t * that
+);
+
 int embb_mtapi_network_socket_bind_and_listen(
   embb_mtapi_network_socket_t * that,
   char const * host,
@@ -64,6 +94,13 @@ int embb_mtapi_network_socket_bind_and_listen(
   uint16_t max_connections
 );
 
+/**
+ * Removes the socket file a listening unix domain socket was bound to.
+ */
+void embb_mtapi_network_socket_unbind(
+  embb_mtapi_network_socket_t * that
+);
+
 int embb_mtapi_network_socket_accept(
   embb_mtapi_network_socket_t * that,
   embb_mtapi_network_socket_t * sock
@@ -86,11 +123,45 @@ int embb_mtapi_network_socket_sendbuffer(
   embb_mtapi_network_buffer_t * buffer
 );
 
+/**
+ * Sends all given pieces of data in order, handing them to the kernel with
+ * as few system calls as possible and without copying them.
+ * \returns the number of bytes sent, 0 on failure
+ */
+size_t embb_mtapi_network_socket_sendvector(
+  embb_mtapi_network_socket_t * that,
+  embb_mtapi_network_socket_vector_t * vector,
+  int count
+);
+
 int embb_mtapi_network_socket_recvbuffer(
   embb_mtapi_network_socket_t * that,
   embb_mtapi_network_buffer_t * buffer
 );
 
+/**
+ * Receives what is available, at most until the buffer is full, and appends
+ * it to the data already in the buffer. Blocks only if nothing is available.
+ * \returns the number of bytes received, 0 if the connection was closed or
+ *          on failure
+ */
+int embb_mtapi_network_socket_recvbuffer_append(
+  embb_mtapi_network_socket_t * that,
+  embb_mtapi_network_buffer_t * buffer
+);
+
+/**
+ * Receives what is available, at most \c size bytes, straight into
+ * \c data. Blocks only if nothing is available.
+ * \returns the number of bytes received, 0 if the connection was closed or
+ *          on failure
+ */
+int embb_mtapi_network_socket_recvdata(
+  embb_mtapi_network_socket_t * that,
+  void * data,
+  int size
+);
+
 int embb_mtapi_network_socket_recvbuffer_sized(
   embb_mtapi_network_socket_t * that,
   embb_mtapi_network_buffer_t * buffer,
@@ -62,6 +62,16 @@ void NetworkBufferTest::TestBasic() {
   PT_EXPECT(err == 2);
   PT_EXPECT(val16 == -2);
 
+  // only the unread int8 is left after compacting
+  err = embb_mtapi_network_buffer_push_back_int8(&buffer, -3);
+  PT_EXPECT(err == 1);
+  embb_mtapi_network_buffer_compact(&buffer);
+  PT_EXPECT(buffer.position == 0);
+  PT_EXPECT(buffer.size == 1);
+  err = embb_mtapi_network_buffer_pop_front_int8(&buffer, &val8);
+  PT_EXPECT(err == 1);
+  PT_EXPECT(val8 == -3);
+
   embb_mtapi_network_buffer_finalize(&buffer);
 
   PT_EXPECT(embb_get_bytes_allocated() == 0);
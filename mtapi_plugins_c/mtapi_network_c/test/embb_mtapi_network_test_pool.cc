@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <embb_mtapi_network_test_pool.h>
+
+#include <embb_mtapi_network_pool.h>
+
+#include <embb/base/c/thread.h>
+
+#include <string.h>
+
+#define POOL_TEST_THREADS 4
+#define POOL_TEST_BLOCKS 16
+
+struct pool_test_chunk_struct {
+  void * blocks[POOL_TEST_BLOCKS];
+};
+
+static int pool_test_free(void * arg) {
+  pool_test_chunk_struct * chunk = static_cast<pool_test_chunk_struct*>(arg);
+  for (int ii = 0; ii < POOL_TEST_BLOCKS; ii++) {
+    embb_mtapi_network_pool_free(chunk->blocks[ii]);
+  }
+  return 0;
+}
+
+NetworkPoolTest::NetworkPoolTest() {
+  CreateUnit("mtapi network pool test")
+    .Add(&NetworkPoolTest::TestBasic, this)
+    .Add(&NetworkPoolTest::TestReturn, this);
+}
+
+void NetworkPoolTest::TestBasic() {
+  embb_mtapi_network_pool_t pool;
+
+  embb_mtapi_network_pool_initialize(&pool);
+
+  // freed blocks are handed out again for the same size class
+  void * block = embb_mtapi_network_pool_allocate(&pool, 60);
+  PT_ASSERT(NULL != block);
+  memset(block, 0xff, 60);
+  embb_mtapi_network_pool_free(block);
+  void * again = embb_mtapi_network_pool_allocate(&pool, 50);
+  PT_EXPECT_EQ(again, block);
+
+  // but not for a different one
+  void * other = embb_mtapi_network_pool_allocate(&pool, 1000);
+  PT_ASSERT(NULL != other);
+  PT_EXPECT(other != block);
+  memset(other, 0xff, 1000);
+
+  // blocks beyond the largest size class bypass the pool
+  void * big = embb_mtapi_network_pool_allocate(&pool, 1024 * 1024);
+  PT_ASSERT(NULL != big);
+  memset(big, 0xff, 1024 * 1024);
+
+  embb_mtapi_network_pool_free(big);
+  embb_mtapi_network_pool_free(other);
+  embb_mtapi_network_pool_free(again);
+  embb_mtapi_network_pool_free(NULL);
+
+  embb_mtapi_network_pool_finalize(&pool);
+}
+
+void NetworkPoolTest::TestReturn() {
+  embb_mtapi_network_pool_t pool;
+  pool_test_chunk_struct chunks[POOL_TEST_THREADS];
+  embb_thread_t threads[POOL_TEST_THREADS];
+  int result;
+
+  embb_mtapi_network_pool_initialize(&pool);
+
+  for (int round = 0; round < 100; round++) {
+    for (int ii = 0; ii < POOL_TEST_THREADS; ii++) {
+      for (int jj = 0; jj < POOL_TEST_BLOCKS; jj++) {
+        chunks[ii].blocks[jj] =
+          embb_mtapi_network_pool_allocate(&pool, 256);
+        PT_ASSERT(NULL != chunks[ii].blocks[jj]);
+        memset(chunks[ii].blocks[jj], ii, 256);
+      }
+    }
+
+    // other threads hand the blocks back concurrently
+    for (int ii = 0; ii < POOL_TEST_THREADS; ii++) {
+      PT_ASSERT(EMBB_SUCCESS == embb_thread_create(
+        &threads[ii], NULL, pool_test_free, &chunks[ii]));
+    }
+    for (int ii = 0; ii < POOL_TEST_THREADS; ii++) {
+      embb_thread_join(&threads[ii], &result);
+    }
+  }
+
+  embb_mtapi_network_pool_finalize(&pool);
+}
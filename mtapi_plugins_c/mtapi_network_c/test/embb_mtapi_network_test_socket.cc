@@ -28,13 +28,42 @@
 
 #include <embb_mtapi_network.h>
 #include <embb_mtapi_network_socket.h>
+#include <embb_mtapi_network_poller.h>
 
 #include <embb/base/c/memory_allocation.h>
+#include <embb/base/c/thread.h>
+
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+
+static const int kPayload = 1024 * 1024;
+
+struct ReceiveArgs {
+  embb_mtapi_network_socket_t * socket;
+  embb_mtapi_network_buffer_t * buffer;
+  int received;
+};
+
+static int ReceiveThread(void * args) {
+  ReceiveArgs * receive = static_cast<ReceiveArgs*>(args);
+  receive->received = embb_mtapi_network_socket_recvbuffer_sized(
+    receive->socket, receive->buffer, kPayload + 8);
+  return EMBB_SUCCESS;
+}
 
 
 NetworkSocketTest::NetworkSocketTest() {
   CreateUnit("mtapi network socket test").Add(
     &NetworkSocketTest::TestBasic, this);
+  CreateUnit("mtapi network poller test").Add(
+    &NetworkSocketTest::TestPoller, this);
+  CreateUnit("mtapi network send vector test").Add(
+    &NetworkSocketTest::TestSendVector, this);
+#ifndef _WIN32
+  CreateUnit("mtapi network local socket path test").Add(
+    &NetworkSocketTest::TestLocalPath, this);
+#endif
 }
 
 void NetworkSocketTest::TestBasic() {
@@ -104,3 +133,239 @@ void NetworkSocketTest::TestBasic() {
 
   PT_EXPECT(embb_get_bytes_allocated() == 0);
 }
+
+void NetworkSocketTest::TestPoller() {
+  const int kSockets = 4;
+  int err;
+  embb_mtapi_network_socket_t server_sock;
+  embb_mtapi_network_socket_t accept_sock[kSockets];
+  embb_mtapi_network_socket_t client_sock[kSockets];
+  embb_mtapi_network_buffer_t send_buffer;
+  embb_mtapi_network_poller_t poller;
+  void * ready[kSockets];
+
+  embb_mtapi_network_buffer_initialize(&send_buffer, 4);
+
+  err = embb_mtapi_network_initialize();
+  PT_EXPECT(err != 0);
+
+  err = embb_mtapi_network_socket_initialize(&server_sock);
+  PT_EXPECT(err != 0);
+  uint16_t port = 4800;
+  do {
+    port++;
+    err = embb_mtapi_network_socket_bind_and_listen(
+      &server_sock, "127.0.0.1", port, kSockets);
+  } while (err == 0 && port < 4900);
+  PT_EXPECT(err != 0);
+
+  err = embb_mtapi_network_poller_initialize(&poller, kSockets);
+  PT_EXPECT(err != 0);
+
+  for (int ii = 0; ii < kSockets; ii++) {
+    err = embb_mtapi_network_socket_initialize(&client_sock[ii]);
+    PT_EXPECT(err != 0);
+    err = embb_mtapi_network_socket_connect(
+      &client_sock[ii], "127.0.0.1", port);
+    PT_EXPECT(err != 0);
+    err = embb_mtapi_network_socket_accept(&server_sock, &accept_sock[ii]);
+    PT_EXPECT(err != 0);
+    err = embb_mtapi_network_poller_add(
+      &poller, &accept_sock[ii], &accept_sock[ii]);
+    PT_EXPECT(err != 0);
+  }
+
+  // nothing sent yet
+  err = embb_mtapi_network_poller_wait(&poller, 1, ready, kSockets);
+  PT_EXPECT_EQ(err, 0);
+
+  // make every other socket readable, all of them have to be reported
+  err = embb_mtapi_network_buffer_push_back_int32(&send_buffer, 0x12345678);
+  PT_EXPECT(err == 4);
+  for (int ii = 0; ii < kSockets; ii += 2) {
+    err = embb_mtapi_network_socket_sendbuffer(&client_sock[ii], &send_buffer);
+    PT_EXPECT(err == 4);
+  }
+
+  int count = 0;
+  bool seen[kSockets] = { false };
+  while (count < kSockets / 2) {
+    err = embb_mtapi_network_poller_wait(&poller, 100, ready, kSockets);
+    for (int jj = 0; jj < err; jj++) {
+      int index = static_cast<int>(
+        static_cast<embb_mtapi_network_socket_t*>(ready[jj]) - accept_sock);
+      PT_EXPECT_EQ(index % 2, 0);
+      if (!seen[index]) {
+        seen[index] = true;
+        count++;
+      }
+    }
+  }
+
+  // removed sockets are no longer reported
+  for (int ii = 0; ii < kSockets; ii += 2) {
+    err = embb_mtapi_network_poller_remove(&poller, &accept_sock[ii]);
+    PT_EXPECT(err != 0);
+  }
+  err = embb_mtapi_network_poller_wait(&poller, 1, ready, kSockets);
+  PT_EXPECT_EQ(err, 0);
+
+  embb_mtapi_network_poller_finalize(&poller);
+
+  for (int ii = 0; ii < kSockets; ii++) {
+    embb_mtapi_network_socket_finalize(&accept_sock[ii]);
+    embb_mtapi_network_socket_finalize(&client_sock[ii]);
+  }
+  embb_mtapi_network_socket_finalize(&server_sock);
+
+  embb_mtapi_network_buffer_finalize(&send_buffer);
+
+  embb_mtapi_network_finalize();
+
+  PT_EXPECT(embb_get_bytes_allocated() == 0);
+}
+
+void NetworkSocketTest::TestSendVector() {
+  int err;
+  embb_mtapi_network_socket_t server_sock;
+  embb_mtapi_network_socket_t accept_sock;
+  embb_mtapi_network_socket_t client_sock;
+  embb_mtapi_network_buffer_t recv_buffer;
+  embb_mtapi_network_buffer_t header;
+  char header_data[8];
+
+  // big enough to need several system calls
+  char * payload = static_cast<char*>(embb_alloc(kPayload));
+  PT_ASSERT(payload != NULL);
+  for (int ii = 0; ii < kPayload; ii++) {
+    payload[ii] = static_cast<char>(ii);
+  }
+
+  embb_mtapi_network_buffer_initialize(&recv_buffer, kPayload + 8);
+  embb_mtapi_network_buffer_wrap(&header, header_data, 8);
+  err = embb_mtapi_network_buffer_push_back_int32(&header, 0x12345678);
+  PT_EXPECT(err == 4);
+  err = embb_mtapi_network_buffer_push_back_int32(&header, kPayload);
+  PT_EXPECT(err == 4);
+  err = embb_mtapi_network_buffer_push_back_int32(&header, 0);
+  PT_EXPECT(err == 0);
+
+  err = embb_mtapi_network_initialize();
+  PT_EXPECT(err != 0);
+
+  err = embb_mtapi_network_socket_initialize(&server_sock);
+  PT_EXPECT(err != 0);
+  uint16_t port = 4900;
+  do {
+    port++;
+    err = embb_mtapi_network_socket_bind_and_listen(
+      &server_sock, "127.0.0.1", port, 1);
+  } while (err == 0 && port < 5000);
+  PT_EXPECT(err != 0);
+
+  err = embb_mtapi_network_socket_initialize(&client_sock);
+  PT_EXPECT(err != 0);
+  err = embb_mtapi_network_socket_connect(&client_sock, "127.0.0.1", port);
+  PT_EXPECT(err != 0);
+  err = embb_mtapi_network_socket_accept(&server_sock, &accept_sock);
+  PT_EXPECT(err != 0);
+
+  // empty pieces are skipped
+  embb_mtapi_network_socket_vector_t vector[3];
+  vector[0].data = header.data;
+  vector[0].size = static_cast<size_t>(header.size);
+  vector[1].data = NULL;
+  vector[1].size = 0;
+  vector[2].data = payload;
+  vector[2].size = static_cast<size_t>(kPayload);
+
+  ReceiveArgs receive = { &accept_sock, &recv_buffer, 0 };
+  embb_thread_t thread;
+  err = embb_thread_create(&thread, NULL, ReceiveThread, &receive);
+  PT_ASSERT_EQ(err, EMBB_SUCCESS);
+
+  size_t sent = embb_mtapi_network_socket_sendvector(&client_sock, vector, 3);
+  PT_EXPECT_EQ(sent, static_cast<size_t>(kPayload + 8));
+
+  embb_thread_join(&thread, &err);
+  PT_EXPECT_EQ(receive.received, kPayload + 8);
+
+  int32_t value = 0;
+  embb_mtapi_network_buffer_pop_front_int32(&recv_buffer, &value);
+  PT_EXPECT_EQ(value, 0x12345678);
+  embb_mtapi_network_buffer_pop_front_int32(&recv_buffer, &value);
+  PT_EXPECT_EQ(value, kPayload);
+  PT_EXPECT(0 == memcmp(recv_buffer.data + 8, payload, kPayload));
+
+  embb_mtapi_network_socket_finalize(&accept_sock);
+  embb_mtapi_network_socket_finalize(&client_sock);
+  embb_mtapi_network_socket_finalize(&server_sock);
+
+  embb_mtapi_network_buffer_finalize(&recv_buffer);
+  embb_free(payload);
+
+  embb_mtapi_network_finalize();
+
+  PT_EXPECT(embb_get_bytes_allocated() == 0);
+}
+
+void NetworkSocketTest::TestLocalPath() {
+  const char * kFile = "embb_mtapi_network_test_path.sock";
+  const char * kHost = "unix:embb_mtapi_network_test_path.sock";
+  int err;
+  embb_mtapi_network_socket_t server_sock;
+  embb_mtapi_network_socket_t other_sock;
+  embb_mtapi_network_socket_t client_sock;
+
+  err = embb_mtapi_network_initialize();
+  PT_EXPECT(err != 0);
+
+  // a file that is no socket is left alone
+  FILE * file = fopen(kFile, "w");
+  PT_ASSERT(file != NULL);
+  fclose(file);
+  err = embb_mtapi_network_socket_initialize(&other_sock);
+  PT_EXPECT(err != 0);
+  errno = 0;
+  err = embb_mtapi_network_socket_bind_and_listen(&other_sock, kHost, 0, 1);
+  PT_EXPECT_EQ(err, 0);
+  PT_EXPECT_EQ(errno, EADDRINUSE);
+  embb_mtapi_network_socket_finalize(&other_sock);
+  file = fopen(kFile, "r");
+  PT_EXPECT(file != NULL);
+  if (NULL != file) {
+    fclose(file);
+  }
+  remove(kFile);
+
+  // neither is the socket of a server that is still running
+  err = embb_mtapi_network_socket_initialize(&server_sock);
+  PT_EXPECT(err != 0);
+  err = embb_mtapi_network_socket_bind_and_listen(&server_sock, kHost, 0, 1);
+  PT_EXPECT(err != 0);
+  err = embb_mtapi_network_socket_initialize(&other_sock);
+  PT_EXPECT(err != 0);
+  errno = 0;
+  err = embb_mtapi_network_socket_bind_and_listen(&other_sock, kHost, 0, 1);
+  PT_EXPECT_EQ(err, 0);
+  PT_EXPECT_EQ(errno, EADDRINUSE);
+  embb_mtapi_network_socket_finalize(&other_sock);
+  err = embb_mtapi_network_socket_initialize(&client_sock);
+  PT_EXPECT(err != 0);
+  err = embb_mtapi_network_socket_connect(&client_sock, kHost, 0);
+  PT_EXPECT(err != 0);
+  embb_mtapi_network_socket_finalize(&client_sock);
+
+  // the socket file of a server that went away without unbinding is stale
+  embb_mtapi_network_socket_finalize(&server_sock);
+  err = embb_mtapi_network_socket_initialize(&server_sock);
+  PT_EXPECT(err != 0);
+  err = embb_mtapi_network_socket_bind_and_listen(&server_sock, kHost, 0, 1);
+  PT_EXPECT(err != 0);
+  embb_mtapi_network_socket_unbind(&server_sock);
+  embb_mtapi_network_socket_finalize(&server_sock);
+
+  embb_mtapi_network_finalize();
+
+  PT_EXPECT(embb_get_bytes_allocated() == 0);
+}
@@ -35,6 +35,9 @@ class NetworkSocketTest : public partest::TestCase {
 
  private:
   void TestBasic();
+  void TestPoller();
+  void TestSendVector();
+  void TestLocalPath();
 };
 
 #endif // MTAPI_PLUGINS_C_MTAPI_NETWORK_C_TEST_EMBB_MTAPI_NETWORK_TEST_SOCKET_H_
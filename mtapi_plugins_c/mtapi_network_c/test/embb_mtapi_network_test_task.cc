@@ -26,8 +26,11 @@
 
 #include <embb_mtapi_network_test_task.h>
 
+#include <embb_mtapi_network_socket.h>
+
 #include <embb/mtapi/c/mtapi_ext.h>
 #include <embb/mtapi/c/mtapi_network.h>
+#include <embb/base/c/thread.h>
 #include <embb/base/c/internal/unused.h>
 
 
@@ -118,6 +121,15 @@ void NetworkTaskTest::TestBasic() {
 
   TestSimple();
   TestCancel();
+  TestIoThreads();
+  TestFlushDelay();
+  TestPooled();
+#ifndef _WIN32
+  TestLocal();
+#endif
+  TestStreaming();
+  TestReconnect();
+  TestServerLost();
 
   mtapi_finalize(&status);
   MTAPI_CHECK_STATUS(status);
@@ -253,3 +265,597 @@ void NetworkTaskTest::TestCancel() {
   mtapi_network_plugin_finalize(&status);
   MTAPI_CHECK_STATUS(status);
 }
+
+void NetworkTaskTest::TestIoThreads() {
+  const int kElements = 16;
+  const int kActions = 4;
+  const int kTasks = 32;
+  mtapi_status_t status;
+  mtapi_job_hndl_t job;
+  mtapi_task_hndl_t task[kTasks];
+  mtapi_action_hndl_t network_action[kActions], local_action;
+  mtapi_network_plugin_attributes_t plugin_attr;
+
+  float arguments[kElements * 2];
+  float results[kTasks][kElements];
+
+  for (int ii = 0; ii < kElements; ii++) {
+    arguments[ii] = static_cast<float>(ii);
+    arguments[ii + kElements] = static_cast<float>(ii);
+  }
+
+  mtapi_network_pluginattr_init(&plugin_attr, &status);
+  MTAPI_CHECK_STATUS(status);
+  mtapi_network_pluginattr_set(&plugin_attr, MTAPI_NETWORK_IO_THREADS,
+    MTAPI_ATTRIBUTE_VALUE(0), MTAPI_ATTRIBUTE_POINTER_AS_VALUE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  // zero io threads are rejected
+  mtapi_network_plugin_initialize_with_attributes("127.0.0.1", 12347,
+    kActions, kElements * 4 * 3 + 32, &plugin_attr, &status);
+  PT_EXPECT_EQ(status, MTAPI_ERR_PARAMETER);
+
+  mtapi_network_pluginattr_set(&plugin_attr, MTAPI_NETWORK_IO_THREADS,
+    MTAPI_ATTRIBUTE_VALUE(3), MTAPI_ATTRIBUTE_POINTER_AS_VALUE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  mtapi_network_plugin_initialize_with_attributes("127.0.0.1", 12347,
+    kActions, kElements * 4 * 3 + 32, &plugin_attr, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  float node_remote = 1.0f;
+  local_action = mtapi_action_create(
+    NETWORK_REMOTE_JOB,
+    test,
+    &node_remote, sizeof(float),
+    MTAPI_DEFAULT_ACTION_ATTRIBUTES,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  // every network action has its own connection, so the connections are
+  // spread over all io threads on both ends
+  for (int ii = 0; ii < kActions; ii++) {
+    network_action[ii] = mtapi_network_action_create(
+      NETWORK_DOMAIN,
+      NETWORK_LOCAL_JOB,
+      NETWORK_REMOTE_JOB,
+      "127.0.0.1", 12347,
+      &status);
+    MTAPI_CHECK_STATUS(status);
+  }
+
+  status = MTAPI_ERR_UNKNOWN;
+  job = mtapi_job_get(NETWORK_LOCAL_JOB, NETWORK_DOMAIN, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  for (int ii = 0; ii < kTasks; ii++) {
+    task[ii] = mtapi_task_start(
+      MTAPI_TASK_ID_NONE,
+      job,
+      arguments, kElements * 2 * sizeof(float),
+      results[ii], kElements*sizeof(float),
+      MTAPI_DEFAULT_TASK_ATTRIBUTES,
+      MTAPI_GROUP_NONE,
+      &status);
+    MTAPI_CHECK_STATUS(status);
+  }
+
+  for (int ii = 0; ii < kTasks; ii++) {
+    mtapi_task_wait(task[ii], MTAPI_INFINITE, &status);
+    MTAPI_CHECK_STATUS(status);
+    for (int jj = 0; jj < kElements; jj++) {
+      PT_EXPECT_EQ(results[ii][jj], jj * 2 + 1);
+    }
+  }
+
+  for (int ii = 0; ii < kActions; ii++) {
+    mtapi_action_delete(network_action[ii], MTAPI_INFINITE, &status);
+    MTAPI_CHECK_STATUS(status);
+  }
+
+  mtapi_action_delete(local_action, MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  mtapi_network_plugin_finalize(&status);
+  MTAPI_CHECK_STATUS(status);
+}
+
+void NetworkTaskTest::TestFlushDelay() {
+  const int kTasks = 64;
+  mtapi_status_t status;
+  mtapi_job_hndl_t job;
+  mtapi_task_hndl_t task[kTasks];
+  mtapi_action_hndl_t network_action, local_action;
+  mtapi_network_plugin_attributes_t plugin_attr;
+
+  float arguments[kTasks][2];
+  float results[kTasks];
+
+  mtapi_network_pluginattr_init(&plugin_attr, &status);
+  MTAPI_CHECK_STATUS(status);
+  mtapi_network_pluginattr_set(&plugin_attr, MTAPI_NETWORK_FLUSH_DELAY,
+    MTAPI_ATTRIBUTE_VALUE(200), MTAPI_ATTRIBUTE_POINTER_AS_VALUE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  mtapi_network_plugin_initialize_with_attributes("127.0.0.1", 12348, 5,
+    4 * 3 + 32, &plugin_attr, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  float node_remote = 1.0f;
+  local_action = mtapi_action_create(
+    NETWORK_REMOTE_JOB,
+    test,
+    &node_remote, sizeof(float),
+    MTAPI_DEFAULT_ACTION_ATTRIBUTES,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  network_action = mtapi_network_action_create(
+    NETWORK_DOMAIN,
+    NETWORK_LOCAL_JOB,
+    NETWORK_REMOTE_JOB,
+    "127.0.0.1", 12348,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  job = mtapi_job_get(NETWORK_LOCAL_JOB, NETWORK_DOMAIN, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  // lots of tiny tasks on one connection, several of them end up in one
+  // write and are parsed from one read on the other side
+  for (int ii = 0; ii < kTasks; ii++) {
+    arguments[ii][0] = static_cast<float>(ii);
+    arguments[ii][1] = static_cast<float>(ii);
+    task[ii] = mtapi_task_start(
+      MTAPI_TASK_ID_NONE,
+      job,
+      arguments[ii], 2 * sizeof(float),
+      &results[ii], sizeof(float),
+      MTAPI_DEFAULT_TASK_ATTRIBUTES,
+      MTAPI_GROUP_NONE,
+      &status);
+    MTAPI_CHECK_STATUS(status);
+  }
+
+  for (int ii = 0; ii < kTasks; ii++) {
+    mtapi_task_wait(task[ii], MTAPI_INFINITE, &status);
+    MTAPI_CHECK_STATUS(status);
+    PT_EXPECT_EQ(results[ii], ii * 2 + 1);
+  }
+
+  mtapi_action_delete(network_action, MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  mtapi_action_delete(local_action, MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  mtapi_network_plugin_finalize(&status);
+  MTAPI_CHECK_STATUS(status);
+}
+
+void NetworkTaskTest::TestPooled() {
+  const int kTasks = 256;
+  mtapi_status_t status;
+  mtapi_job_hndl_t job;
+  mtapi_task_hndl_t task[kTasks];
+  mtapi_action_hndl_t network_action, local_action;
+  mtapi_network_endpoint_t endpoints[3];
+
+  float arguments[kTasks][2];
+  float results[kTasks];
+
+  mtapi_network_plugin_initialize("127.0.0.1", 12349, 10,
+    4 * 3 + 32, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  float node_remote = 1.0f;
+  local_action = mtapi_action_create(
+    NETWORK_REMOTE_JOB,
+    test,
+    &node_remote, sizeof(float),
+    MTAPI_DEFAULT_ACTION_ATTRIBUTES,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  // the first two endpoints lead to the same node, nobody listens on the
+  // third one
+  endpoints[0].host = "127.0.0.1";
+  endpoints[0].port = 12349;
+  endpoints[1].host = "127.0.0.1";
+  endpoints[1].port = 12349;
+  endpoints[2].host = "127.0.0.1";
+  endpoints[2].port = 12350;
+
+  network_action = mtapi_network_action_create_pooled(
+    NETWORK_DOMAIN,
+    NETWORK_LOCAL_JOB,
+    NETWORK_REMOTE_JOB,
+    MTAPI_NULL, 2, 2,
+    &status);
+  PT_EXPECT_EQ(status, MTAPI_ERR_PARAMETER);
+
+  network_action = mtapi_network_action_create_pooled(
+    NETWORK_DOMAIN,
+    NETWORK_LOCAL_JOB,
+    NETWORK_REMOTE_JOB,
+    endpoints, 3, 0,
+    &status);
+  PT_EXPECT_EQ(status, MTAPI_ERR_PARAMETER);
+
+  network_action = mtapi_network_action_create_pooled(
+    NETWORK_DOMAIN,
+    NETWORK_LOCAL_JOB,
+    NETWORK_REMOTE_JOB,
+    &endpoints[2], 1, 2,
+    &status);
+  PT_EXPECT_EQ(status, MTAPI_ERR_UNKNOWN);
+
+  network_action = mtapi_network_action_create_pooled(
+    NETWORK_DOMAIN,
+    NETWORK_LOCAL_JOB,
+    NETWORK_REMOTE_JOB,
+    endpoints, 3, 2,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  job = mtapi_job_get(NETWORK_LOCAL_JOB, NETWORK_DOMAIN, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  // tasks are spread over all connections that could be established
+  for (int ii = 0; ii < kTasks; ii++) {
+    arguments[ii][0] = static_cast<float>(ii);
+    arguments[ii][1] = static_cast<float>(ii);
+    task[ii] = mtapi_task_start(
+      MTAPI_TASK_ID_NONE,
+      job,
+      arguments[ii], 2 * sizeof(float),
+      &results[ii], sizeof(float),
+      MTAPI_DEFAULT_TASK_ATTRIBUTES,
+      MTAPI_GROUP_NONE,
+      &status);
+    MTAPI_CHECK_STATUS(status);
+  }
+
+  for (int ii = 0; ii < kTasks; ii++) {
+    mtapi_task_wait(task[ii], MTAPI_INFINITE, &status);
+    MTAPI_CHECK_STATUS(status);
+    PT_EXPECT_EQ(results[ii], ii * 2 + 1);
+  }
+
+  mtapi_action_delete(network_action, MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  mtapi_action_delete(local_action, MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  mtapi_network_plugin_finalize(&status);
+  MTAPI_CHECK_STATUS(status);
+}
+
+void NetworkTaskTest::TestLocal() {
+  const int kTasks = 64;
+  mtapi_status_t status;
+  mtapi_job_hndl_t job;
+  mtapi_task_hndl_t task[kTasks];
+  mtapi_action_hndl_t network_action, local_action;
+
+  float arguments[kTasks][2];
+  float results[kTasks];
+
+  // same protocol, but over a unix domain socket
+  mtapi_network_plugin_initialize("unix:embb_mtapi_network_test.sock", 0, 5,
+    4 * 3 + 32, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  float node_remote = 1.0f;
+  local_action = mtapi_action_create(
+    NETWORK_REMOTE_JOB,
+    test,
+    &node_remote, sizeof(float),
+    MTAPI_DEFAULT_ACTION_ATTRIBUTES,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  network_action = mtapi_network_action_create(
+    NETWORK_DOMAIN,
+    NETWORK_LOCAL_JOB,
+    NETWORK_REMOTE_JOB,
+    "unix:embb_mtapi_network_test.sock", 0,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  job = mtapi_job_get(NETWORK_LOCAL_JOB, NETWORK_DOMAIN, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  for (int ii = 0; ii < kTasks; ii++) {
+    arguments[ii][0] = static_cast<float>(ii);
+    arguments[ii][1] = static_cast<float>(ii);
+    task[ii] = mtapi_task_start(
+      MTAPI_TASK_ID_NONE,
+      job,
+      arguments[ii], 2 * sizeof(float),
+      &results[ii], sizeof(float),
+      MTAPI_DEFAULT_TASK_ATTRIBUTES,
+      MTAPI_GROUP_NONE,
+      &status);
+    MTAPI_CHECK_STATUS(status);
+  }
+
+  for (int ii = 0; ii < kTasks; ii++) {
+    mtapi_task_wait(task[ii], MTAPI_INFINITE, &status);
+    MTAPI_CHECK_STATUS(status);
+    PT_EXPECT_EQ(results[ii], ii * 2 + 1);
+  }
+
+  mtapi_action_delete(network_action, MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  mtapi_action_delete(local_action, MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  mtapi_network_plugin_finalize(&status);
+  MTAPI_CHECK_STATUS(status);
+
+  // the socket file is gone, so nobody can connect anymore
+  network_action = mtapi_network_action_create(
+    NETWORK_DOMAIN,
+    NETWORK_LOCAL_JOB,
+    NETWORK_REMOTE_JOB,
+    "unix:embb_mtapi_network_test.sock", 0,
+    &status);
+  PT_EXPECT_EQ(status, MTAPI_ERR_UNKNOWN);
+}
+
+void NetworkTaskTest::TestStreaming() {
+  const int kSmallTasks = 32;
+  const int kLargeTasks = 2;
+  const int kLargeElements = 1024 * 1024;
+  mtapi_status_t status;
+  mtapi_job_hndl_t job;
+  mtapi_task_hndl_t small_task[kSmallTasks];
+  mtapi_task_hndl_t large_task[kLargeTasks];
+  mtapi_action_hndl_t network_action, local_action;
+
+  float small_arguments[kSmallTasks][2];
+  float small_results[kSmallTasks];
+  float * large_arguments[kLargeTasks];
+  float * large_results[kLargeTasks];
+
+  // the header of a streamed packet has to fit
+  mtapi_network_plugin_initialize("127.0.0.1", 12351, 5, 16, &status);
+  PT_EXPECT_EQ(status, MTAPI_ERR_PARAMETER);
+
+  // the receive buffers are much smaller than the large tasks' arguments
+  // and results
+  mtapi_network_plugin_initialize("127.0.0.1", 12351, 5, 1024, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  float node_remote = 1.0f;
+  local_action = mtapi_action_create(
+    NETWORK_REMOTE_JOB,
+    test,
+    &node_remote, sizeof(float),
+    MTAPI_DEFAULT_ACTION_ATTRIBUTES,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  network_action = mtapi_network_action_create(
+    NETWORK_DOMAIN,
+    NETWORK_LOCAL_JOB,
+    NETWORK_REMOTE_JOB,
+    "127.0.0.1", 12351,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  job = mtapi_job_get(NETWORK_LOCAL_JOB, NETWORK_DOMAIN, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  for (int ii = 0; ii < kLargeTasks; ii++) {
+    large_arguments[ii] = new float[kLargeElements * 2];
+    large_results[ii] = new float[kLargeElements];
+    for (int jj = 0; jj < kLargeElements; jj++) {
+      large_arguments[ii][jj] = static_cast<float>(jj % 1000);
+      large_arguments[ii][kLargeElements + jj] = static_cast<float>(ii);
+      large_results[ii][jj] = 0.0f;
+    }
+  }
+
+  // small and large tasks mixed on one connection
+  for (int ii = 0; ii < kSmallTasks; ii++) {
+    if (0 == ii % (kSmallTasks / kLargeTasks)) {
+      int kk = ii / (kSmallTasks / kLargeTasks);
+      large_task[kk] = mtapi_task_start(
+        MTAPI_TASK_ID_NONE,
+        job,
+        large_arguments[kk], kLargeElements * 2 * sizeof(float),
+        large_results[kk], kLargeElements * sizeof(float),
+        MTAPI_DEFAULT_TASK_ATTRIBUTES,
+        MTAPI_GROUP_NONE,
+        &status);
+      MTAPI_CHECK_STATUS(status);
+    }
+    small_arguments[ii][0] = static_cast<float>(ii);
+    small_arguments[ii][1] = static_cast<float>(ii);
+    small_task[ii] = mtapi_task_start(
+      MTAPI_TASK_ID_NONE,
+      job,
+      small_arguments[ii], 2 * sizeof(float),
+      &small_results[ii], sizeof(float),
+      MTAPI_DEFAULT_TASK_ATTRIBUTES,
+      MTAPI_GROUP_NONE,
+      &status);
+    MTAPI_CHECK_STATUS(status);
+  }
+
+  for (int ii = 0; ii < kSmallTasks; ii++) {
+    mtapi_task_wait(small_task[ii], MTAPI_INFINITE, &status);
+    MTAPI_CHECK_STATUS(status);
+    PT_EXPECT_EQ(small_results[ii], ii * 2 + 1);
+  }
+
+  for (int ii = 0; ii < kLargeTasks; ii++) {
+    mtapi_task_wait(large_task[ii], MTAPI_INFINITE, &status);
+    MTAPI_CHECK_STATUS(status);
+    for (int jj = 0; jj < kLargeElements; jj++) {
+      if (large_results[ii][jj] != (jj % 1000) + ii + 1) {
+        PT_EXPECT_EQ(large_results[ii][jj], (jj % 1000) + ii + 1);
+        break;
+      }
+    }
+    delete[] large_arguments[ii];
+    delete[] large_results[ii];
+  }
+
+  mtapi_action_delete(network_action, MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  mtapi_action_delete(local_action, MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  mtapi_network_plugin_finalize(&status);
+  MTAPI_CHECK_STATUS(status);
+}
+
+void NetworkTaskTest::TestReconnect() {
+  const int kRounds = 8;
+  const int kAttempts = 10000;
+  mtapi_status_t status;
+  mtapi_job_hndl_t job;
+  mtapi_task_hndl_t task;
+  mtapi_action_hndl_t network_action, local_action;
+
+  float arguments[2] = { 1.0f, 2.0f };
+  float result;
+
+  // room for a single connection, i.e. both of its ends
+  mtapi_network_plugin_initialize("127.0.0.1", 12352, 1,
+    4 * 3 + 32, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  float node_remote = 1.0f;
+  local_action = mtapi_action_create(
+    NETWORK_REMOTE_JOB,
+    test,
+    &node_remote, sizeof(float),
+    MTAPI_DEFAULT_ACTION_ATTRIBUTES,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  // closed connections give their slots back, the io threads notice the
+  // close a moment later
+  for (int ii = 0; ii < kRounds; ii++) {
+    status = MTAPI_ERR_UNKNOWN;
+    for (int jj = 0; jj < kAttempts && MTAPI_SUCCESS != status; jj++) {
+      network_action = mtapi_network_action_create(
+        NETWORK_DOMAIN,
+        NETWORK_LOCAL_JOB,
+        NETWORK_REMOTE_JOB,
+        "127.0.0.1", 12352,
+        &status);
+      if (MTAPI_SUCCESS != status) {
+        embb_thread_yield();
+      }
+    }
+    MTAPI_CHECK_STATUS(status);
+
+    status = MTAPI_ERR_UNKNOWN;
+    job = mtapi_job_get(NETWORK_LOCAL_JOB, NETWORK_DOMAIN, &status);
+    MTAPI_CHECK_STATUS(status);
+
+    task = mtapi_task_start(
+      MTAPI_TASK_ID_NONE,
+      job,
+      arguments, 2 * sizeof(float),
+      &result, sizeof(float),
+      MTAPI_DEFAULT_TASK_ATTRIBUTES,
+      MTAPI_GROUP_NONE,
+      &status);
+    MTAPI_CHECK_STATUS(status);
+
+    mtapi_task_wait(task, MTAPI_INFINITE, &status);
+    MTAPI_CHECK_STATUS(status);
+    PT_EXPECT_EQ(result, 4.0f);
+
+    mtapi_action_delete(network_action, MTAPI_INFINITE, &status);
+    MTAPI_CHECK_STATUS(status);
+  }
+
+  mtapi_action_delete(local_action, MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  mtapi_network_plugin_finalize(&status);
+  MTAPI_CHECK_STATUS(status);
+}
+
+void NetworkTaskTest::TestServerLost() {
+  mtapi_status_t status;
+  mtapi_job_hndl_t job;
+  mtapi_task_hndl_t task;
+  mtapi_action_hndl_t network_action;
+  embb_mtapi_network_socket_t server_sock;
+  embb_mtapi_network_socket_t accept_sock;
+  embb_mtapi_network_buffer_t recv_buffer;
+  int err;
+
+  float arguments[2] = { 1.0f, 2.0f };
+  float result;
+
+  mtapi_network_plugin_initialize("127.0.0.1", 12353, 5,
+    4 * 3 + 32, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  // a server that goes away while it is working on the task
+  err = embb_mtapi_network_socket_initialize(&server_sock);
+  PT_ASSERT(err != 0);
+  err = embb_mtapi_network_socket_bind_and_listen(
+    &server_sock, "127.0.0.1", 12354, 1);
+  PT_ASSERT(err != 0);
+  err = embb_mtapi_network_buffer_initialize(&recv_buffer, 64);
+  PT_ASSERT(err != 0);
+
+  network_action = mtapi_network_action_create(
+    NETWORK_DOMAIN,
+    NETWORK_LOCAL_JOB,
+    NETWORK_REMOTE_JOB,
+    "127.0.0.1", 12354,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  status = MTAPI_ERR_UNKNOWN;
+  job = mtapi_job_get(NETWORK_LOCAL_JOB, NETWORK_DOMAIN, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  task = mtapi_task_start(
+    MTAPI_TASK_ID_NONE,
+    job,
+    arguments, 2 * sizeof(float),
+    &result, sizeof(float),
+    MTAPI_DEFAULT_TASK_ATTRIBUTES,
+    MTAPI_GROUP_NONE,
+    &status);
+  MTAPI_CHECK_STATUS(status);
+
+  err = embb_mtapi_network_socket_accept(&server_sock, &accept_sock);
+  PT_ASSERT(err != 0);
+  err = embb_mtapi_network_socket_recvbuffer_append(
+    &accept_sock, &recv_buffer);
+  PT_EXPECT(err > 0);
+  embb_mtapi_network_socket_finalize(&accept_sock);
+
+  // no answer will come, the task fails instead of waiting forever
+  mtapi_task_wait(task, 10000, &status);
+  PT_EXPECT_EQ(status, MTAPI_ERR_ACTION_FAILED);
+
+  mtapi_action_delete(network_action, MTAPI_INFINITE, &status);
+  MTAPI_CHECK_STATUS(status);
+
+  embb_mtapi_network_buffer_finalize(&recv_buffer);
+  embb_mtapi_network_socket_finalize(&server_sock);
+
+  mtapi_network_plugin_finalize(&status);
+  MTAPI_CHECK_STATUS(status);
+}
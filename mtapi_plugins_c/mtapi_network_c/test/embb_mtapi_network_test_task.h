@@ -38,6 +38,13 @@ class NetworkTaskTest : public partest::TestCase {
 
   void TestSimple();
   void TestCancel();
+  void TestIoThreads();
+  void TestFlushDelay();
+  void TestPooled();
+  void TestLocal();
+  void TestStreaming();
+  void TestReconnect();
+  void TestServerLost();
 };
 
 #endif // MTAPI_PLUGINS_C_MTAPI_NETWORK_C_TEST_EMBB_MTAPI_NETWORK_TEST_TASK_H_
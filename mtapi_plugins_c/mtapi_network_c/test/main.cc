@@ -27,6 +27,7 @@
 #include <partest/partest.h>
 
 #include <embb_mtapi_network_test_buffer.h>
+#include <embb_mtapi_network_test_pool.h>
 #include <embb_mtapi_network_test_socket.h>
 #include <embb_mtapi_network_test_task.h>
 
@@ -34,6 +35,7 @@
 
 PT_MAIN("MTAPI NETWORK") {
   PT_RUN(NetworkBufferTest);
+  PT_RUN(NetworkPoolTest);
   PT_RUN(NetworkSocketTest);
   PT_RUN(NetworkTaskTest);
 }
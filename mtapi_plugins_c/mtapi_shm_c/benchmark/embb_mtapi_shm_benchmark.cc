@@ -0,0 +1,464 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+// Compares the MTAPI shared memory plugin with the network plugin on
+// loopback.
+//
+// The benchmark forks a server process whose node offers an echo action over
+// both plugins. The client node in the original process then keeps the given
+// number of echo tasks in flight through either plugin. For every plugin,
+// argument size and concurrency, it reports the throughput and the latency
+// percentiles of the tasks as one line of CSV or one JSON object.
+
+#include <embb/mtapi/c/mtapi.h>
+#include <embb/mtapi/c/mtapi_network.h>
+#include <embb/mtapi/c/mtapi_shm.h>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#define BENCHMARK_DOMAIN 1
+#define BENCHMARK_CLIENT_NODE 1
+#define BENCHMARK_SERVER_NODE 2
+#define BENCHMARK_REMOTE_JOB 1
+#define BENCHMARK_SHM_JOB 2
+#define BENCHMARK_NETWORK_JOB 3
+
+struct BenchmarkOptions {
+  std::vector<int> sizes;
+  std::vector<int> concurrencies;
+  int port;
+  int tasks;
+  int warmup;
+  bool json;
+};
+
+struct BenchmarkResult {
+  char const * plugin;
+  int size;
+  int concurrency;
+  int tasks;
+  double seconds;
+  double p50;
+  double p99;
+  double p999;
+};
+
+static void echo(
+  void const * arguments,
+  mtapi_size_t arguments_size,
+  void * result_buffer,
+  mtapi_size_t result_buffer_size,
+  void const * /*node_local_data*/,
+  mtapi_size_t /*node_local_data_size*/,
+  mtapi_task_context_t * /*context*/) {
+  memcpy(result_buffer, arguments,
+    std::min(arguments_size, result_buffer_size));
+}
+
+// monotonic wall clock time in microseconds
+static double wall_time() {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return static_cast<double>(now.tv_sec) * 1e6 +
+    static_cast<double>(now.tv_nsec) / 1e3;
+}
+
+static double percentile(std::vector<double> const & sorted, double p) {
+  if (sorted.empty()) {
+    return 0.0;
+  }
+  size_t index = static_cast<size_t>(p * static_cast<double>(sorted.size()));
+  if (index >= sorted.size()) {
+    index = sorted.size() - 1;
+  }
+  return sorted[index];
+}
+
+static bool parse_list(char const * text, std::vector<int> * list) {
+  list->clear();
+  while (*text) {
+    char * end;
+    long value = strtol(text, &end, 10);
+    if (end == text || value <= 0) {
+      return false;
+    }
+    list->push_back(static_cast<int>(value));
+    text = (',' == *end) ? end + 1 : end;
+  }
+  return !list->empty();
+}
+
+static void usage(char const * name) {
+  fprintf(stderr,
+    "usage: %s [options]\n"
+    "  --sizes LIST        argument sizes in bytes (16,1024,65536)\n"
+    "  --concurrency LIST  tasks kept in flight (1,16)\n"
+    "  --port PORT         loopback port of the network plugin (12410)\n"
+    "  --tasks N           measured tasks per configuration (10000)\n"
+    "  --warmup N          unmeasured tasks per configuration (1000)\n"
+    "  --json              print JSON instead of CSV\n",
+    name);
+}
+
+static bool parse_options(int argc, char ** argv, BenchmarkOptions * options) {
+  parse_list("16,1024,65536", &options->sizes);
+  parse_list("1,16", &options->concurrencies);
+  options->port = 12410;
+  options->tasks = 10000;
+  options->warmup = 1000;
+  options->json = false;
+
+  for (int ii = 1; ii < argc; ii++) {
+    std::string option = argv[ii];
+    char const * value = (ii + 1 < argc) ? argv[ii + 1] : NULL;
+    bool ok = true;
+    if ("--json" == option) {
+      options->json = true;
+      continue;
+    } else if (NULL == value) {
+      ok = false;
+    } else if ("--sizes" == option) {
+      ok = parse_list(value, &options->sizes);
+    } else if ("--concurrency" == option) {
+      ok = parse_list(value, &options->concurrencies);
+    } else if ("--port" == option) {
+      options->port = atoi(value);
+    } else if ("--tasks" == option) {
+      options->tasks = atoi(value);
+    } else if ("--warmup" == option) {
+      options->warmup = atoi(value);
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      return false;
+    }
+    ii++;
+  }
+
+  return 0 < options->port && options->port < 65536 &&
+    0 < options->tasks && 0 <= options->warmup;
+}
+
+// initializes a node that neither reuses the main thread nor runs out of
+// tasks with the given number in flight
+static bool initialize_node(mtapi_node_t node_id, int max_concurrency) {
+  mtapi_status_t status;
+  mtapi_node_attributes_t node_attr;
+  mtapi_uint_t max_tasks =
+    static_cast<mtapi_uint_t>(std::max(1024, 4 * max_concurrency));
+
+  mtapi_nodeattr_init(&node_attr, &status);
+  mtapi_nodeattr_set(&node_attr, MTAPI_NODE_MAX_TASKS,
+    &max_tasks, MTAPI_NODE_MAX_TASKS_SIZE, &status);
+  mtapi_nodeattr_set(&node_attr, MTAPI_NODE_QUEUE_LIMIT,
+    &max_tasks, MTAPI_NODE_QUEUE_LIMIT_SIZE, &status);
+  mtapi_nodeattr_set(&node_attr, MTAPI_NODE_REUSE_MAIN_THREAD,
+    MTAPI_ATTRIBUTE_VALUE(MTAPI_FALSE), MTAPI_ATTRIBUTE_POINTER_AS_VALUE,
+    &status);
+  mtapi_initialize(BENCHMARK_DOMAIN, node_id, &node_attr, MTAPI_NULL,
+    &status);
+  return MTAPI_SUCCESS == status;
+}
+
+// serves echo tasks over both plugins until the client closes the control
+// pipe, signals readiness by writing to the ready pipe
+static int serve(
+  BenchmarkOptions const & options,
+  std::string const & name,
+  size_t buffer_size,
+  int ready_fd,
+  int control_fd) {
+  mtapi_status_t status;
+  int max_concurrency = *std::max_element(
+    options.concurrencies.begin(), options.concurrencies.end());
+  char byte = 1;
+
+  if (!initialize_node(BENCHMARK_SERVER_NODE, max_concurrency)) {
+    return 1;
+  }
+  mtapi_network_plugin_initialize(const_cast<char*>("127.0.0.1"),
+    static_cast<mtapi_uint16_t>(options.port), 4,
+    static_cast<mtapi_size_t>(buffer_size), &status);
+  bool ok = (MTAPI_SUCCESS == status);
+  // the server starts no remote tasks, a single transfer slot suffices
+  mtapi_shm_plugin_initialize(const_cast<char*>(name.c_str()), 1024, 1,
+    static_cast<mtapi_size_t>(buffer_size), &status);
+  ok = ok && (MTAPI_SUCCESS == status);
+  mtapi_action_hndl_t action = mtapi_action_create(BENCHMARK_REMOTE_JOB, echo,
+    MTAPI_NULL, 0, MTAPI_DEFAULT_ACTION_ATTRIBUTES, &status);
+  ok = ok && (MTAPI_SUCCESS == status);
+
+  if (ok && 1 == write(ready_fd, &byte, 1)) {
+    // returns when the client is done
+    while (0 < read(control_fd, &byte, 1)) {
+    }
+  }
+
+  mtapi_action_delete(action, MTAPI_INFINITE, &status);
+  mtapi_shm_plugin_finalize(&status);
+  mtapi_network_plugin_finalize(&status);
+  mtapi_finalize(&status);
+  return ok ? 0 : 1;
+}
+
+// keeps concurrency tasks in flight until count tasks completed, latencies
+// are taken when a task is waited for, which happens in start order
+static bool run_tasks(
+  mtapi_job_hndl_t job,
+  int size,
+  int concurrency,
+  int count,
+  std::vector<double> * latencies) {
+  std::vector<char> arguments(static_cast<size_t>(size), 'x');
+  std::vector<char> results(
+    static_cast<size_t>(size) * static_cast<size_t>(concurrency));
+  std::vector<mtapi_task_hndl_t> tasks(static_cast<size_t>(concurrency));
+  std::vector<double> starts(static_cast<size_t>(concurrency));
+  mtapi_status_t status;
+  int started = 0;
+  int completed = 0;
+
+  while (completed < count) {
+    int slot = started % concurrency;
+    if (started < count && started - completed < concurrency) {
+      starts[slot] = wall_time();
+      tasks[slot] = mtapi_task_start(
+        MTAPI_TASK_ID_NONE, job,
+        &arguments[0], static_cast<mtapi_size_t>(size),
+        &results[static_cast<size_t>(slot) * static_cast<size_t>(size)],
+        static_cast<mtapi_size_t>(size),
+        MTAPI_DEFAULT_TASK_ATTRIBUTES, MTAPI_GROUP_NONE, &status);
+      if (MTAPI_SUCCESS != status) {
+        return false;
+      }
+      started++;
+    } else {
+      slot = completed % concurrency;
+      mtapi_task_wait(tasks[slot], MTAPI_INFINITE, &status);
+      if (MTAPI_SUCCESS != status) {
+        return false;
+      }
+      if (NULL != latencies) {
+        latencies->push_back(wall_time() - starts[slot]);
+      }
+      completed++;
+    }
+  }
+
+  return true;
+}
+
+static bool run_configuration(
+  BenchmarkOptions const & options,
+  mtapi_job_id_t job_id,
+  int size,
+  int concurrency,
+  BenchmarkResult * result) {
+  mtapi_status_t status;
+  std::vector<double> latencies;
+
+  mtapi_job_hndl_t job = mtapi_job_get(job_id, BENCHMARK_DOMAIN, &status);
+
+  bool ok = (MTAPI_SUCCESS == status) &&
+    run_tasks(job, size, concurrency, options.warmup, NULL);
+
+  latencies.reserve(static_cast<size_t>(options.tasks));
+  double start = wall_time();
+  ok = ok && run_tasks(job, size, concurrency, options.tasks, &latencies);
+  double wall = wall_time() - start;
+
+  if (!ok) {
+    fprintf(stderr, "tasks failed\n");
+    return false;
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  result->plugin = (BENCHMARK_SHM_JOB == job_id) ? "shm" : "network";
+  result->size = size;
+  result->concurrency = concurrency;
+  result->tasks = options.tasks;
+  result->seconds = wall / 1e6;
+  result->p50 = percentile(latencies, 0.5);
+  result->p99 = percentile(latencies, 0.99);
+  result->p999 = percentile(latencies, 0.999);
+  return true;
+}
+
+static void print_result(
+  BenchmarkOptions const & options,
+  BenchmarkResult const & result,
+  bool first) {
+  double tasks_per_second = result.tasks / result.seconds;
+  // arguments go out and the same amount of results comes back
+  double megabytes_per_second =
+    2.0 * result.size * tasks_per_second / (1024.0 * 1024.0);
+
+  if (options.json) {
+    printf("%s\n  {\"plugin\": \"%s\", \"argument_size\": %d, "
+      "\"concurrency\": %d, \"tasks\": %d, \"seconds\": %.6f, "
+      "\"tasks_per_second\": %.1f, \"megabytes_per_second\": %.3f, "
+      "\"p50_us\": %.1f, \"p99_us\": %.1f, \"p999_us\": %.1f}",
+      first ? "[" : ",", result.plugin, result.size, result.concurrency,
+      result.tasks, result.seconds, tasks_per_second, megabytes_per_second,
+      result.p50, result.p99, result.p999);
+  } else {
+    if (first) {
+      printf("plugin,argument_size,concurrency,tasks,seconds,"
+        "tasks_per_second,megabytes_per_second,p50_us,p99_us,p999_us\n");
+    }
+    printf("%s,%d,%d,%d,%.6f,%.1f,%.3f,%.1f,%.1f,%.1f\n",
+      result.plugin, result.size, result.concurrency, result.tasks,
+      result.seconds, tasks_per_second, megabytes_per_second,
+      result.p50, result.p99, result.p999);
+  }
+  fflush(stdout);
+}
+
+int main(int argc, char ** argv) {
+  BenchmarkOptions options;
+  mtapi_status_t status;
+  std::vector<mtapi_action_hndl_t> actions;
+  int ready[2];
+  int control[2];
+  char byte;
+  char name[32];
+
+  if (!parse_options(argc, argv, &options)) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  int max_size = *std::max_element(
+    options.sizes.begin(), options.sizes.end());
+  int max_concurrency = *std::max_element(
+    options.concurrencies.begin(), options.concurrencies.end());
+  // arguments and results share a transfer slot of the shared memory plugin
+  // and the network plugin needs room for its message header
+  size_t buffer_size = 2 * static_cast<size_t>(max_size) + 256;
+
+  // the server is forked before any thread is started in this process
+  if (0 != pipe(ready) || 0 != pipe(control)) {
+    fprintf(stderr, "could not create pipes\n");
+    return 1;
+  }
+  pid_t server = fork();
+  if (0 > server) {
+    fprintf(stderr, "could not fork the server\n");
+    return 1;
+  }
+  snprintf(name, sizeof(name), "embb_shm_bench_%d",
+    static_cast<int>(0 == server ? getpid() : server));
+  if (0 == server) {
+    close(ready[0]);
+    close(control[1]);
+    int result = serve(options, name, buffer_size, ready[1], control[0]);
+    _exit(result);
+  }
+  close(ready[1]);
+  close(control[0]);
+  bool ok = (1 == read(ready[0], &byte, 1));
+  if (!ok) {
+    fprintf(stderr, "could not start the server\n");
+  }
+
+  ok = ok && initialize_node(BENCHMARK_CLIENT_NODE, max_concurrency);
+  if (ok) {
+    char client_name[32];
+    snprintf(client_name, sizeof(client_name), "embb_shm_bench_%d",
+      static_cast<int>(getpid()));
+    mtapi_shm_plugin_initialize(client_name, 1024,
+      static_cast<mtapi_uint_t>(max_concurrency),
+      static_cast<mtapi_size_t>(buffer_size), &status);
+    ok = (MTAPI_SUCCESS == status);
+    // a client only node listens on an ephemeral port it never uses
+    mtapi_network_plugin_initialize(const_cast<char*>("127.0.0.1"), 0, 4,
+      static_cast<mtapi_size_t>(buffer_size), &status);
+    ok = ok && (MTAPI_SUCCESS == status);
+    if (!ok) {
+      fprintf(stderr, "could not initialize the plugins\n");
+    }
+  }
+  if (ok) {
+    actions.push_back(mtapi_shm_action_create(BENCHMARK_DOMAIN,
+      BENCHMARK_SHM_JOB, BENCHMARK_REMOTE_JOB, name, &status));
+    ok = (MTAPI_SUCCESS == status);
+    actions.push_back(mtapi_network_action_create(BENCHMARK_DOMAIN,
+      BENCHMARK_NETWORK_JOB, BENCHMARK_REMOTE_JOB,
+      const_cast<char*>("127.0.0.1"),
+      static_cast<mtapi_uint16_t>(options.port), &status));
+    ok = ok && (MTAPI_SUCCESS == status);
+    if (!ok) {
+      fprintf(stderr, "could not connect to the server\n");
+    }
+  }
+
+  bool first = true;
+  for (size_t ii = 0; ok && ii < options.sizes.size(); ii++) {
+    for (size_t jj = 0; ok && jj < options.concurrencies.size(); jj++) {
+      for (mtapi_job_id_t job_id = BENCHMARK_SHM_JOB;
+        ok && job_id <= BENCHMARK_NETWORK_JOB; job_id++) {
+        BenchmarkResult result;
+        ok = run_configuration(options, job_id,
+          options.sizes[ii], options.concurrencies[jj], &result);
+        if (ok) {
+          print_result(options, result, first);
+          first = false;
+        }
+      }
+    }
+  }
+  if (options.json && !first) {
+    printf("\n]\n");
+  }
+
+  for (size_t kk = 0; kk < actions.size(); kk++) {
+    mtapi_action_delete(actions[kk], MTAPI_INFINITE, &status);
+  }
+  mtapi_network_plugin_finalize(&status);
+  mtapi_shm_plugin_finalize(&status);
+  mtapi_finalize(&status);
+
+  // closing the control pipe stops the server
+  close(control[1]);
+  int server_status = 0;
+  waitpid(server, &server_status, 0);
+  close(ready[0]);
+
+  return (ok && WIFEXITED(server_status) &&
+    0 == WEXITSTATUS(server_status)) ? 0 : 1;
+}
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef EMBB_MTAPI_C_MTAPI_SHM_H_
+#define EMBB_MTAPI_C_MTAPI_SHM_H_
+
+
+#include <embb/mtapi/c/mtapi_ext.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * \defgroup C_MTAPI_SHM MTAPI Shared Memory Plugin
+ *
+ * \ingroup C_MTAPI_EXT
+ *
+ * Provides functionality to distribute tasks across nodes running on the
+ * same host using POSIX shared memory.
+ *
+ * Every node owns a named shared memory segment holding a message queue and
+ * a number of transfer slots. A node starting a remote task copies the
+ * arguments into one of its own slots and posts a message into the queue of
+ * the remote node. The remote node executes the task directly on the
+ * arguments in shared memory and writes the results into the same slot, so
+ * no data is copied besides from and to the user supplied buffers. Messages
+ * for task start, results, failures and cancellation follow the protocol of
+ * the network plugin (see \ref C_MTAPI_NETWORK).
+ */
+
+
+/**
+ * Initializes the MTAPI shared memory environment on a previously initialized
+ * MTAPI node.
+ *
+ * It must be called on all nodes using the MTAPI shared memory plugin.
+ *
+ * Application software using MTAPI shared memory must call
+ * mtapi_shm_plugin_initialize() once per node. It is an error to call
+ * mtapi_shm_plugin_initialize() multiple times from a given node, unless
+ * mtapi_shm_plugin_finalize() is called in between.
+ *
+ * On success, \c *status is set to \c MTAPI_SUCCESS. On error, \c *status is
+ * set to the appropriate error defined below.
+ * Error code                  | Description
+ * --------------------------- | ----------------------------------------------
+ * \c MTAPI_ERR_NODE_NOTINIT   | The calling node is not initialized.
+ * \c MTAPI_ERR_PARAMETER      | Invalid name, queue capacity or slot count.
+ * \c MTAPI_ERR_UNKNOWN        | The segment couldn't be created.
+ *
+ * \see mtapi_shm_plugin_finalize()
+ *
+ * \notthreadsafe
+ * \ingroup C_MTAPI_SHM
+ */
+void mtapi_shm_plugin_initialize(
+  MTAPI_IN char * name,                /**< [in] Name of the segment of this
+                                            node, other nodes refer to this
+                                            node by it. At most 30 characters
+                                            without slashes. */
+  MTAPI_IN mtapi_uint_t queue_capacity,
+                                       /**< [in] Number of messages the
+                                            segment can queue, must be a power
+                                            of 2. */
+  MTAPI_IN mtapi_uint_t max_transfers, /**< [in] Maximum number of tasks this
+                                            node may have in flight on remote
+                                            nodes at once. */
+  MTAPI_IN mtapi_size_t buffer_size,   /**< [in] Capacity of each transfer
+                                            slot, this should be chosen big
+                                            enough to hold argument and result
+                                            buffers.*/
+  MTAPI_OUT mtapi_status_t* status     /**< [out] Pointer to error code,
+                                            may be \c MTAPI_NULL */
+);
+
+/**
+ * Finalizes the MTAPI shared memory environment on the local MTAPI node.
+ *
+ * It has to be called by each node using MTAPI shared memory. It is an error
+ * to call mtapi_shm_plugin_finalize() without first calling
+ * mtapi_shm_plugin_initialize().
+ *
+ * The segment of the node is removed, remote nodes can no longer start tasks
+ * on it afterwards.
+ *
+ * On success, \c *status is set to \c MTAPI_SUCCESS. On error, \c *status is
+ * set to the appropriate error defined below.
+ * Error code                    | Description
+ * ----------------------------- | --------------------------------------------
+ * \c MTAPI_ERR_UNKNOWN          | MTAPI shared memory couldn't be finalized.
+ *
+ * \see mtapi_shm_plugin_initialize()
+ *
+ * \notthreadsafe
+ * \ingroup C_MTAPI_SHM
+ */
+void mtapi_shm_plugin_finalize(
+  MTAPI_OUT mtapi_status_t* status     /**< [out] Pointer to error code,
+                                            may be \c MTAPI_NULL */
+);
+
+/**
+ * This function creates a shared memory action.
+ *
+ * It is called on the node where the user wants to execute an action on a
+ * remote node on the same host where the actual action is implemented. A
+ * shared memory action contains a reference to a local job, a remote job and
+ * a remote domain as well as the name of the remote node's segment.
+ * After a shared memory action is created, it is referenced by the
+ * application using a node-local handle of type \c mtapi_action_hndl_t, or
+ * indirectly through a node-local job handle of type \c mtapi_job_hndl_t. A
+ * shared memory action's life-cycle begins with mtapi_shm_action_create(),
+ * and ends when mtapi_action_delete() or mtapi_finalize() is called.
+ *
+ * A shared memory action defines no node local data, instead the node local
+ * data of the remote action is used.
+ *
+ * Tasks started on a shared memory action fail with \c MTAPI_ERR_ARG_SIZE if
+ * their arguments and results do not fit into a transfer slot together.
+ *
+ * On success, an action handle is returned and \c *status is set to
+ * \c MTAPI_SUCCESS. On error, \c *status is set to the appropriate error
+ * defined below. In the case where the action already exists, \c status will
+ * be set to \c MTAPI_ERR_ACTION_EXISTS and the handle returned will not be a
+ * valid handle.
+ * <table>
+ *   <tr>
+ *     <th>Error code</th>
+ *     <th>Description</th>
+ *   </tr>
+ *   <tr>
+ *     <td>\c MTAPI_ERR_JOB_INVALID</td>
+ *     <td>The \c job_id is not a valid job ID, i.e., no action was created for
+ *         that ID or the action has been deleted.</td>
+ *   </tr>
+ *   <tr>
+ *     <td>\c MTAPI_ERR_ACTION_EXISTS</td>
+ *     <td>This action is already created.</td>
+ *   </tr>
+ *   <tr>
+ *     <td>\c MTAPI_ERR_ACTION_LIMIT</td>
+ *     <td>Exceeded maximum number of actions allowed.</td>
+ *   </tr>
+ *   <tr>
+ *     <td>\c MTAPI_ERR_NODE_NOTINIT</td>
+ *     <td>The calling node is not initialized.</td>
+ *   </tr>
+ *   <tr>
+ *     <td>\c MTAPI_ERR_UNKNOWN</td>
+ *     <td>The segment of the remote node could not be opened or the plugin
+ *         is not initialized.</td>
+ *   </tr>
+ * </table>
+ *
+ * \see mtapi_action_delete(), mtapi_finalize()
+ *
+ * \returns Handle to newly created shared memory action, invalid handle on
+ *          error
+ * \threadsafe
+ * \ingroup C_MTAPI_SHM
+ */
+mtapi_action_hndl_t mtapi_shm_action_create(
+  MTAPI_IN mtapi_domain_t domain_id,   /**< [in] The domain the action is
+                                            associated with */
+  MTAPI_IN mtapi_job_id_t local_job_id,
+                                       /**< [in] The ID of the local job */
+  MTAPI_IN mtapi_job_id_t remote_job_id,
+                                       /**< [in] The ID of the remote job */
+  MTAPI_IN char * name,                /**< [in] Name of the remote node's
+                                            segment */
+  MTAPI_OUT mtapi_status_t* status     /**< [out] Pointer to error code,
+                                            may be \c MTAPI_NULL */
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif // EMBB_MTAPI_C_MTAPI_SHM_H_
@@ -0,0 +1,713 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include <embb/mtapi/c/mtapi_shm.h>
+#include <embb/base/c/memory_allocation.h>
+#include <embb/base/c/thread.h>
+#include <embb/base/c/atomic.h>
+#include <embb/base/c/internal/unused.h>
+
+#include <embb_mtapi_shm_segment.h>
+
+#include <embb_mtapi_task_t.h>
+#include <embb_mtapi_action_t.h>
+#include <embb_mtapi_node_t.h>
+#include <embb_mtapi_id_pool_t.h>
+#include <embb_mtapi_scheduler_t.h>
+#include <mtapi_status_t.h>
+
+#define EMBB_MTAPI_SHM_START_TASK    0x01AFFE01
+#define EMBB_MTAPI_SHM_RETURN_RESULT 0x02AFFE02
+#define EMBB_MTAPI_SHM_RETURN_FAILURE 0x03AFFE03
+#define EMBB_MTAPI_SHM_CANCEL_TASK   0x04AFFE04
+
+/* results follow the arguments in a slot at this alignment */
+#define EMBB_MTAPI_SHM_RESULT_ALIGNMENT 16
+
+/* a node that sent us tasks, its segment holds their arguments and results
+   and receives our replies. a restarted node gets a new peer, the old one
+   stays mapped until the last task running on its slots has finished. */
+struct embb_mtapi_shm_peer_struct {
+  embb_mtapi_shm_segment_t segment;
+  /* held by the list of peers and by every task started for the peer */
+  embb_atomic_int references;
+  struct embb_mtapi_shm_peer_struct * next;
+};
+
+typedef struct embb_mtapi_shm_peer_struct embb_mtapi_shm_peer_t;
+
+struct embb_mtapi_shm_plugin_struct {
+  embb_thread_t thread;
+  embb_atomic_int run;
+  embb_mtapi_shm_segment_t segment;
+  embb_mtapi_id_pool_t slot_pool;
+  embb_mtapi_shm_peer_t * peers;
+};
+
+typedef struct embb_mtapi_shm_plugin_struct embb_mtapi_shm_plugin_t;
+
+static embb_mtapi_shm_plugin_t embb_mtapi_shm_plugin;
+
+struct embb_mtapi_shm_action_struct {
+  mtapi_domain_t domain_id;
+  mtapi_job_id_t job_id;
+  embb_mtapi_shm_segment_t segment;
+};
+
+typedef struct embb_mtapi_shm_action_struct embb_mtapi_shm_action_t;
+
+struct embb_mtapi_shm_task_struct {
+  embb_mtapi_shm_peer_t * peer;
+  int32_t remote_task_id;
+  int32_t remote_task_tag;
+  uint32_t slot;
+};
+
+typedef struct embb_mtapi_shm_task_struct embb_mtapi_shm_task_t;
+
+static uint32_t embb_mtapi_shm_results_offset(uint32_t arguments_size) {
+  return (arguments_size + EMBB_MTAPI_SHM_RESULT_ALIGNMENT - 1) &
+    ~(uint32_t)(EMBB_MTAPI_SHM_RESULT_ALIGNMENT - 1);
+}
+
+static int embb_mtapi_shm_send(
+  embb_mtapi_shm_segment_t * segment,
+  embb_mtapi_shm_message_t const * message) {
+  /* the receiver drains its queue continuously, so a full queue is only a
+     temporary condition unless the receiver went away */
+  while (!embb_mtapi_shm_segment_push(segment, message)) {
+    if (!embb_mtapi_shm_segment_is_valid(segment)) {
+      return 0;
+    }
+    embb_thread_yield();
+  }
+  return 1;
+}
+
+static embb_mtapi_shm_peer_t * embb_mtapi_shm_peer_new(char const * name) {
+  char peer_name[EMBB_MTAPI_SHM_NAME_LENGTH];
+  embb_mtapi_shm_peer_t * peer =
+    (embb_mtapi_shm_peer_t*)embb_alloc(sizeof(embb_mtapi_shm_peer_t));
+
+  if (NULL == peer) {
+    return NULL;
+  }
+  memcpy(peer_name, name, EMBB_MTAPI_SHM_NAME_LENGTH);
+  peer_name[EMBB_MTAPI_SHM_NAME_LENGTH - 1] = '\0';
+  if (!embb_mtapi_shm_segment_open(&peer->segment, peer_name)) {
+    embb_free(peer);
+    return NULL;
+  }
+  embb_atomic_init_int(&peer->references, 1);
+  peer->next = NULL;
+
+  return peer;
+}
+
+static void embb_mtapi_shm_peer_release(embb_mtapi_shm_peer_t * peer) {
+  if (1 == embb_atomic_fetch_and_add_int(&peer->references, -1)) {
+    embb_mtapi_shm_segment_close(&peer->segment);
+    embb_atomic_destroy_int(&peer->references);
+    embb_free(peer);
+  }
+}
+
+static void embb_mtapi_shm_return_failure(
+  embb_mtapi_shm_peer_t * peer,
+  int32_t remote_task_id,
+  int32_t remote_task_tag,
+  uint32_t slot,
+  mtapi_status_t status) {
+  embb_mtapi_shm_plugin_t * plugin = &embb_mtapi_shm_plugin;
+  embb_mtapi_shm_message_t message;
+
+  memset(&message, 0, sizeof(message));
+  message.operation = EMBB_MTAPI_SHM_RETURN_FAILURE;
+  message.task_id = remote_task_id;
+  message.task_tag = remote_task_tag;
+  message.status = (int32_t)status;
+  message.slot = slot;
+  memcpy(message.sender, plugin->segment.name, EMBB_MTAPI_SHM_NAME_LENGTH);
+
+  embb_mtapi_shm_send(&peer->segment, &message);
+}
+
+static void embb_mtapi_shm_finish_task(
+  embb_mtapi_task_t * local_task,
+  embb_mtapi_node_t * node,
+  mtapi_status_t error_code) {
+  mtapi_task_state_t next_state;
+
+  local_task->error_code = error_code;
+  if (MTAPI_SUCCESS == error_code) {
+    next_state = MTAPI_TASK_COMPLETED;
+  } else if (MTAPI_ERR_ACTION_CANCELLED == error_code) {
+    next_state = MTAPI_TASK_CANCELLED;
+  } else {
+    next_state = MTAPI_TASK_ERROR;
+  }
+  embb_mtapi_scheduler_finalize_task(local_task, node, next_state);
+}
+
+static void embb_mtapi_shm_task_complete(
+  MTAPI_IN mtapi_task_hndl_t task,
+  MTAPI_OUT mtapi_status_t* status) {
+  mtapi_status_t local_status = MTAPI_ERR_UNKNOWN;
+
+  if (embb_mtapi_node_is_initialized()) {
+    embb_mtapi_node_t * node = embb_mtapi_node_get_instance();
+
+    if (embb_mtapi_task_pool_is_handle_valid(node->task_pool, task)) {
+      embb_mtapi_task_t * local_task =
+        embb_mtapi_task_pool_get_storage_for_handle(node->task_pool, task);
+      embb_mtapi_shm_plugin_t * plugin = &embb_mtapi_shm_plugin;
+      embb_mtapi_shm_task_t * shm_task =
+        (embb_mtapi_shm_task_t*)local_task->attributes.user_data;
+      embb_mtapi_shm_message_t message;
+
+      embb_atomic_memory_barrier();
+      local_task->attributes.complete_func = NULL;
+      embb_atomic_memory_barrier();
+
+      /* the results are already in the slot of the sender, so only the
+         outcome has to be reported */
+      memset(&message, 0, sizeof(message));
+      if (MTAPI_SUCCESS == local_task->error_code) {
+        message.operation = EMBB_MTAPI_SHM_RETURN_RESULT;
+      } else {
+        message.operation = EMBB_MTAPI_SHM_RETURN_FAILURE;
+      }
+      message.task_id = shm_task->remote_task_id;
+      message.task_tag = shm_task->remote_task_tag;
+      message.status = (int32_t)local_task->error_code;
+      message.slot = shm_task->slot;
+      memcpy(message.sender, plugin->segment.name,
+        EMBB_MTAPI_SHM_NAME_LENGTH);
+      embb_mtapi_shm_send(&shm_task->peer->segment, &message);
+
+      embb_atomic_memory_barrier();
+      local_task->attributes.user_data = NULL;
+      embb_atomic_memory_barrier();
+
+      /* the slots of the peer are no longer used by this task */
+      embb_mtapi_shm_peer_release(shm_task->peer);
+      embb_free(shm_task);
+
+      local_status = MTAPI_SUCCESS;
+    }
+  }
+
+  mtapi_status_set(status, local_status);
+}
+
+static embb_mtapi_shm_peer_t * embb_mtapi_shm_get_peer(char const * name) {
+  embb_mtapi_shm_plugin_t * plugin = &embb_mtapi_shm_plugin;
+  embb_mtapi_shm_peer_t ** link;
+  embb_mtapi_shm_peer_t * peer;
+
+  /* the list of peers is only touched by the receiver thread, no locking
+     needed */
+  for (link = &plugin->peers; NULL != *link; link = &(*link)->next) {
+    peer = *link;
+    if (0 == strncmp(peer->segment.name, name, EMBB_MTAPI_SHM_NAME_LENGTH)) {
+      if (embb_mtapi_shm_segment_is_valid(&peer->segment)) {
+        return peer;
+      }
+      /* the peer was restarted. tasks of the old incarnation may still
+         work on its slots, so the old mapping is left to them and the new
+         segment is mapped separately */
+      *link = peer->next;
+      embb_mtapi_shm_peer_release(peer);
+      break;
+    }
+  }
+
+  peer = embb_mtapi_shm_peer_new(name);
+  if (NULL != peer) {
+    peer->next = plugin->peers;
+    plugin->peers = peer;
+  }
+
+  return peer;
+}
+
+static mtapi_status_t embb_mtapi_shm_handle_start_task(
+  embb_mtapi_shm_message_t * message) {
+  embb_mtapi_shm_peer_t * peer;
+  embb_mtapi_shm_task_t * shm_task;
+  char * slot;
+  void * arguments = MTAPI_NULL;
+  void * results = MTAPI_NULL;
+  uint32_t results_offset;
+  mtapi_uint_t priority = (mtapi_uint_t)message->priority;
+  mtapi_boolean_t task_detached = MTAPI_TRUE;
+  mtapi_job_hndl_t job_hndl;
+  mtapi_task_attributes_t task_attr;
+  mtapi_task_complete_function_t func = embb_mtapi_shm_task_complete;
+  void * func_void;
+  mtapi_status_t local_status = MTAPI_ERR_UNKNOWN;
+
+  peer = embb_mtapi_shm_get_peer(message->sender);
+  if (NULL == peer) {
+    /* nobody to answer to */
+    return MTAPI_ERR_UNKNOWN;
+  }
+
+  /* arguments and results have to lie within the given slot */
+  slot = (char*)embb_mtapi_shm_segment_get_slot(
+    &peer->segment, message->slot);
+  results_offset = embb_mtapi_shm_results_offset(message->arguments_size);
+  if (NULL == slot || message->arguments_size > results_offset ||
+    peer->segment.header->slot_size < results_offset ||
+    peer->segment.header->slot_size - results_offset <
+      message->results_size) {
+    embb_mtapi_shm_return_failure(peer,
+      message->task_id, message->task_tag, message->slot,
+      MTAPI_ERR_ARG_SIZE);
+    return MTAPI_ERR_ARG_SIZE;
+  }
+  if (0 < message->arguments_size) {
+    arguments = slot;
+  }
+  if (0 < message->results_size) {
+    results = slot + results_offset;
+  }
+
+  shm_task = (embb_mtapi_shm_task_t*)embb_alloc(
+    sizeof(embb_mtapi_shm_task_t));
+  if (NULL == shm_task) {
+    embb_mtapi_shm_return_failure(peer,
+      message->task_id, message->task_tag, message->slot,
+      MTAPI_ERR_UNKNOWN);
+    return MTAPI_ERR_UNKNOWN;
+  }
+  shm_task->peer = peer;
+  embb_atomic_fetch_and_add_int(&peer->references, 1);
+  shm_task->remote_task_id = message->task_id;
+  shm_task->remote_task_tag = message->task_tag;
+  shm_task->slot = message->slot;
+
+  mtapi_taskattr_init(&task_attr, &local_status);
+  assert(local_status == MTAPI_SUCCESS);
+  mtapi_taskattr_set(&task_attr, MTAPI_TASK_USER_DATA,
+    (void*)shm_task, 0, &local_status);
+  assert(local_status == MTAPI_SUCCESS);
+  mtapi_taskattr_set(&task_attr, MTAPI_TASK_DETACHED,
+    (void*)&task_detached, sizeof(mtapi_boolean_t), &local_status);
+  assert(local_status == MTAPI_SUCCESS);
+  mtapi_taskattr_set(&task_attr, MTAPI_TASK_PRIORITY,
+    (void*)&priority, sizeof(mtapi_uint_t), &local_status);
+  assert(local_status == MTAPI_SUCCESS);
+  memcpy(&func_void, &func, sizeof(void*));
+  mtapi_taskattr_set(&task_attr, MTAPI_TASK_COMPLETE_FUNCTION,
+    func_void, 0, &local_status);
+  assert(local_status == MTAPI_SUCCESS);
+  job_hndl = mtapi_job_get((mtapi_job_id_t)message->job_id,
+    (mtapi_domain_t)message->domain_id, &local_status);
+  if (local_status == MTAPI_SUCCESS) {
+    /* the task works on the buffers in shared memory directly */
+    mtapi_task_start(
+      MTAPI_TASK_ID_NONE, job_hndl,
+      arguments, (mtapi_size_t)message->arguments_size,
+      results, (mtapi_size_t)message->results_size,
+      &task_attr, MTAPI_GROUP_NONE,
+      &local_status);
+  }
+  if (local_status != MTAPI_SUCCESS) {
+    embb_mtapi_shm_peer_release(peer);
+    embb_free(shm_task);
+    embb_mtapi_shm_return_failure(peer,
+      message->task_id, message->task_tag, message->slot, local_status);
+  }
+
+  return local_status;
+}
+
+static mtapi_status_t embb_mtapi_shm_handle_return(
+  embb_mtapi_shm_message_t * message) {
+  embb_mtapi_shm_plugin_t * plugin = &embb_mtapi_shm_plugin;
+  char * slot = (char*)embb_mtapi_shm_segment_get_slot(
+    &plugin->segment, message->slot);
+  mtapi_status_t local_status = MTAPI_ERR_UNKNOWN;
+
+  if (embb_mtapi_node_is_initialized()) {
+    embb_mtapi_node_t * node = embb_mtapi_node_get_instance();
+    mtapi_task_hndl_t task;
+
+    task.id = (mtapi_task_id_t)message->task_id;
+    task.tag = (mtapi_uint_t)message->task_tag;
+
+    if (embb_mtapi_task_pool_is_handle_valid(node->task_pool, task)) {
+      embb_mtapi_task_t * local_task =
+        embb_mtapi_task_pool_get_storage_for_handle(node->task_pool, task);
+      mtapi_status_t task_status = (mtapi_status_t)message->status;
+
+      if (NULL == slot) {
+        task_status = MTAPI_ERR_UNKNOWN;
+      } else if (EMBB_MTAPI_SHM_RETURN_RESULT == message->operation &&
+        0 < local_task->result_size) {
+        memcpy(local_task->result_buffer,
+          slot + embb_mtapi_shm_results_offset(
+            (uint32_t)local_task->arguments_size),
+          local_task->result_size);
+      }
+
+      embb_mtapi_shm_finish_task(local_task, node, task_status);
+      local_status = MTAPI_SUCCESS;
+    }
+  }
+
+  /* the slot is free again once the remote node is done with it */
+  if (NULL != slot) {
+    embb_mtapi_id_pool_deallocate(&plugin->slot_pool, message->slot + 1);
+  }
+
+  return local_status;
+}
+
+static mtapi_status_t embb_mtapi_shm_handle_cancel_task(
+  embb_mtapi_shm_message_t * message) {
+  mtapi_status_t local_status = MTAPI_ERR_UNKNOWN;
+
+  if (embb_mtapi_node_is_initialized()) {
+    embb_mtapi_node_t * node = embb_mtapi_node_get_instance();
+    mtapi_uint_t ii;
+
+    // search for task to cancel
+    for (ii = 1; ii <= node->attributes.max_tasks; ii++) {
+      embb_mtapi_task_t * task = &node->task_pool->storage[ii];
+      // is this our task?
+      if (embb_mtapi_shm_task_complete == task->attributes.complete_func) {
+        embb_mtapi_shm_task_t * shm_task =
+          (embb_mtapi_shm_task_t*)task->attributes.user_data;
+        // is this task the one matching the given remote task?
+        if (NULL != shm_task &&
+          message->task_id == shm_task->remote_task_id &&
+          message->task_tag == shm_task->remote_task_tag &&
+          0 == strncmp(message->sender, shm_task->peer->segment.name,
+            EMBB_MTAPI_SHM_NAME_LENGTH)) {
+          mtapi_task_cancel(task->handle, &local_status);
+          break;
+        }
+      }
+    }
+  }
+
+  return local_status;
+}
+
+static int embb_mtapi_shm_thread(void * args) {
+  embb_mtapi_shm_plugin_t * plugin = &embb_mtapi_shm_plugin;
+  embb_mtapi_shm_message_t message;
+
+  EMBB_UNUSED(args);
+
+  while (embb_atomic_load_int(&plugin->run)) {
+    if (!embb_mtapi_shm_segment_pop(&plugin->segment, &message)) {
+      /* queue is empty, sleep until somebody posts */
+      embb_mtapi_shm_segment_wait(&plugin->segment, 100);
+      continue;
+    }
+
+    message.sender[EMBB_MTAPI_SHM_NAME_LENGTH - 1] = '\0';
+    switch (message.operation) {
+    case EMBB_MTAPI_SHM_START_TASK:
+      embb_mtapi_shm_handle_start_task(&message);
+      break;
+    case EMBB_MTAPI_SHM_RETURN_RESULT:
+    case EMBB_MTAPI_SHM_RETURN_FAILURE:
+      embb_mtapi_shm_handle_return(&message);
+      break;
+    case EMBB_MTAPI_SHM_CANCEL_TASK:
+      embb_mtapi_shm_handle_cancel_task(&message);
+      break;
+    default:
+      // invalid, ignore
+      break;
+    }
+  }
+
+  return EMBB_SUCCESS;
+}
+
+void mtapi_shm_plugin_initialize(
+  MTAPI_IN char * name,
+  MTAPI_IN mtapi_uint_t queue_capacity,
+  MTAPI_IN mtapi_uint_t max_transfers,
+  MTAPI_IN mtapi_size_t buffer_size,
+  MTAPI_OUT mtapi_status_t* status) {
+  embb_mtapi_shm_plugin_t * plugin = &embb_mtapi_shm_plugin;
+  int err;
+
+  mtapi_status_set(status, MTAPI_ERR_UNKNOWN);
+
+  if (!embb_mtapi_node_is_initialized()) {
+    mtapi_status_set(status, MTAPI_ERR_NODE_NOTINIT);
+    return;
+  }
+  if (MTAPI_NULL == name || 0 == max_transfers ||
+    0 == buffer_size || (mtapi_size_t)UINT32_MAX < buffer_size ||
+    2 > queue_capacity || 0 != (queue_capacity & (queue_capacity - 1))) {
+    mtapi_status_set(status, MTAPI_ERR_PARAMETER);
+    return;
+  }
+
+  plugin->peers = NULL;
+
+  err = embb_mtapi_shm_segment_create(&plugin->segment, name,
+    (uint32_t)queue_capacity, (uint32_t)max_transfers, (uint32_t)buffer_size);
+  if (!err) {
+    return;
+  }
+
+  /* slot ids are handed out starting at 1, slot indices start at 0 */
+  embb_mtapi_id_pool_initialize(&plugin->slot_pool, max_transfers);
+
+  embb_atomic_init_int(&plugin->run, 1);
+
+  err = embb_thread_create(&plugin->thread, NULL, embb_mtapi_shm_thread, NULL);
+  if (EMBB_SUCCESS != err) {
+    embb_atomic_destroy_int(&plugin->run);
+    embb_mtapi_id_pool_finalize(&plugin->slot_pool);
+    embb_mtapi_shm_segment_close(&plugin->segment);
+    return;
+  }
+
+  mtapi_status_set(status, MTAPI_SUCCESS);
+}
+
+void mtapi_shm_plugin_finalize(
+  MTAPI_OUT mtapi_status_t* status) {
+  embb_mtapi_shm_plugin_t * plugin = &embb_mtapi_shm_plugin;
+  int err;
+
+  if (NULL == plugin->segment.header) {
+    mtapi_status_set(status, MTAPI_ERR_UNKNOWN);
+    return;
+  }
+
+  embb_atomic_store_int(&plugin->run, 0);
+  embb_thread_join(&plugin->thread, &err);
+  embb_atomic_destroy_int(&plugin->run);
+
+  while (NULL != plugin->peers) {
+    embb_mtapi_shm_peer_t * peer = plugin->peers;
+    plugin->peers = peer->next;
+    embb_mtapi_shm_peer_release(peer);
+  }
+
+  embb_mtapi_id_pool_finalize(&plugin->slot_pool);
+  embb_mtapi_shm_segment_close(&plugin->segment);
+
+  mtapi_status_set(status, MTAPI_SUCCESS);
+}
+
+static void shm_task_start(
+  MTAPI_IN mtapi_task_hndl_t task,
+  MTAPI_OUT mtapi_status_t* status) {
+  embb_mtapi_shm_plugin_t * plugin = &embb_mtapi_shm_plugin;
+  mtapi_status_t local_status = MTAPI_ERR_UNKNOWN;
+
+  if (embb_mtapi_node_is_initialized()) {
+    embb_mtapi_node_t * node = embb_mtapi_node_get_instance();
+
+    if (embb_mtapi_task_pool_is_handle_valid(node->task_pool, task)) {
+      embb_mtapi_task_t * local_task =
+        embb_mtapi_task_pool_get_storage_for_handle(node->task_pool, task);
+
+      if (embb_mtapi_action_pool_is_handle_valid(
+        node->action_pool, local_task->action)) {
+        embb_mtapi_action_t * local_action =
+          embb_mtapi_action_pool_get_storage_for_handle(
+            node->action_pool, local_task->action);
+        embb_mtapi_shm_action_t * shm_action =
+          (embb_mtapi_shm_action_t*)local_action->plugin_data;
+        uint32_t slot_size = plugin->segment.header->slot_size;
+        uint32_t results_offset = embb_mtapi_shm_results_offset(
+          (uint32_t)local_task->arguments_size);
+        mtapi_uint_t slot_id;
+
+        if (slot_size < results_offset ||
+          slot_size - results_offset < local_task->result_size) {
+          local_status = MTAPI_ERR_ARG_SIZE;
+        } else {
+          slot_id = embb_mtapi_id_pool_allocate(&plugin->slot_pool);
+          if (EMBB_MTAPI_IDPOOL_INVALID_ID == slot_id) {
+            local_status = MTAPI_ERR_TASK_LIMIT;
+          } else {
+            embb_mtapi_shm_message_t message;
+            uint32_t slot = (uint32_t)slot_id - 1;
+
+            /* the only copy of the arguments on their way to the remote
+               node */
+            if (0 < local_task->arguments_size) {
+              memcpy(embb_mtapi_shm_segment_get_slot(&plugin->segment, slot),
+                local_task->arguments, local_task->arguments_size);
+            }
+
+            memset(&message, 0, sizeof(message));
+            message.operation = EMBB_MTAPI_SHM_START_TASK;
+            message.domain_id = (int32_t)shm_action->domain_id;
+            message.job_id = (int32_t)shm_action->job_id;
+            message.priority = (int32_t)local_task->attributes.priority;
+            message.task_id = (int32_t)local_task->handle.id;
+            message.task_tag = (int32_t)local_task->handle.tag;
+            message.slot = slot;
+            message.arguments_size = (uint32_t)local_task->arguments_size;
+            message.results_size = (uint32_t)local_task->result_size;
+            memcpy(message.sender, plugin->segment.name,
+              EMBB_MTAPI_SHM_NAME_LENGTH);
+
+            /* the reply may arrive before we return from sending */
+            embb_mtapi_task_set_state(local_task, MTAPI_TASK_RUNNING);
+            if (embb_mtapi_shm_send(&shm_action->segment, &message)) {
+              local_status = MTAPI_SUCCESS;
+            } else {
+              embb_mtapi_id_pool_deallocate(&plugin->slot_pool, slot_id);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  mtapi_status_set(status, local_status);
+}
+
+static void shm_task_cancel(
+  MTAPI_IN mtapi_task_hndl_t task,
+  MTAPI_OUT mtapi_status_t* status) {
+  embb_mtapi_shm_plugin_t * plugin = &embb_mtapi_shm_plugin;
+  mtapi_status_t local_status = MTAPI_ERR_UNKNOWN;
+
+  if (embb_mtapi_node_is_initialized()) {
+    embb_mtapi_node_t * node = embb_mtapi_node_get_instance();
+
+    if (embb_mtapi_task_pool_is_handle_valid(node->task_pool, task)) {
+      embb_mtapi_task_t * local_task =
+        embb_mtapi_task_pool_get_storage_for_handle(node->task_pool, task);
+
+      if (embb_mtapi_action_pool_is_handle_valid(
+        node->action_pool, local_task->action)) {
+        embb_mtapi_action_t * local_action =
+          embb_mtapi_action_pool_get_storage_for_handle(
+            node->action_pool, local_task->action);
+        embb_mtapi_shm_action_t * shm_action =
+          (embb_mtapi_shm_action_t*)local_action->plugin_data;
+        embb_mtapi_shm_message_t message;
+
+        /* the task completes once the remote node reports the
+           cancellation */
+        memset(&message, 0, sizeof(message));
+        message.operation = EMBB_MTAPI_SHM_CANCEL_TASK;
+        message.task_id = (int32_t)local_task->handle.id;
+        message.task_tag = (int32_t)local_task->handle.tag;
+        memcpy(message.sender, plugin->segment.name,
+          EMBB_MTAPI_SHM_NAME_LENGTH);
+
+        if (embb_mtapi_shm_send(&shm_action->segment, &message)) {
+          local_status = MTAPI_SUCCESS;
+        } else {
+          embb_atomic_store_int(&local_task->state, MTAPI_TASK_ERROR);
+        }
+      }
+    }
+  }
+
+  mtapi_status_set(status, local_status);
+}
+
+static void shm_action_finalize(
+  MTAPI_IN mtapi_action_hndl_t action,
+  MTAPI_OUT mtapi_status_t* status) {
+  mtapi_status_t local_status = MTAPI_ERR_UNKNOWN;
+
+  if (embb_mtapi_node_is_initialized()) {
+    embb_mtapi_node_t * node = embb_mtapi_node_get_instance();
+    if (embb_mtapi_action_pool_is_handle_valid(node->action_pool, action)) {
+      embb_mtapi_action_t * local_action =
+        embb_mtapi_action_pool_get_storage_for_handle(
+          node->action_pool, action);
+      embb_mtapi_shm_action_t * shm_action =
+        (embb_mtapi_shm_action_t*)local_action->plugin_data;
+
+      embb_mtapi_shm_segment_close(&shm_action->segment);
+
+      embb_free(shm_action);
+      local_status = MTAPI_SUCCESS;
+    }
+  }
+
+  mtapi_status_set(status, local_status);
+}
+
+mtapi_action_hndl_t mtapi_shm_action_create(
+  MTAPI_IN mtapi_domain_t domain_id,
+  MTAPI_IN mtapi_job_id_t local_job_id,
+  MTAPI_IN mtapi_job_id_t remote_job_id,
+  MTAPI_IN char * name,
+  MTAPI_OUT mtapi_status_t* status) {
+  embb_mtapi_shm_plugin_t * plugin = &embb_mtapi_shm_plugin;
+  mtapi_status_t local_status = MTAPI_ERR_UNKNOWN;
+  mtapi_action_hndl_t action_hndl = { 0, EMBB_MTAPI_IDPOOL_INVALID_ID };
+  embb_mtapi_shm_action_t * action;
+
+  if (NULL == plugin->segment.header || MTAPI_NULL == name) {
+    mtapi_status_set(status, MTAPI_ERR_UNKNOWN);
+    return action_hndl;
+  }
+
+  action = (embb_mtapi_shm_action_t*)embb_alloc(
+    sizeof(embb_mtapi_shm_action_t));
+  if (NULL != action) {
+    action->domain_id = domain_id;
+    action->job_id = remote_job_id;
+
+    if (embb_mtapi_shm_segment_open(&action->segment, name)) {
+      action_hndl = mtapi_ext_plugin_action_create(
+        local_job_id,
+        shm_task_start,
+        shm_task_cancel,
+        shm_action_finalize,
+        action,
+        NULL, 0, // no node local data
+        MTAPI_NULL,
+        &local_status);
+      if (MTAPI_SUCCESS != local_status) {
+        embb_mtapi_shm_segment_close(&action->segment);
+        embb_free(action);
+      }
+    } else {
+      embb_free(action);
+    }
+  }
+
+  mtapi_status_set(status, local_status);
+  return action_hndl;
+}
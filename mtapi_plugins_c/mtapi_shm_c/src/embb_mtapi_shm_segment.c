@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <embb_mtapi_shm_segment.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define EMBB_MTAPI_SHM_MAGIC 0x5348AFFE
+
+static size_t embb_mtapi_shm_segment_round_up(size_t size) {
+  return (size + EMBB_PLATFORM_CACHE_LINE_SIZE - 1) &
+    ~(size_t)(EMBB_PLATFORM_CACHE_LINE_SIZE - 1);
+}
+
+static int embb_mtapi_shm_segment_get_path(
+  char * path,
+  char const * name) {
+  /* shm_open expects a single leading slash */
+  int length = snprintf(path, EMBB_MTAPI_SHM_NAME_LENGTH + 1, "/%s", name);
+  return 1 < length && EMBB_MTAPI_SHM_NAME_LENGTH > length &&
+    NULL == strchr(name, '/');
+}
+
+static void embb_mtapi_shm_segment_attach(
+  embb_mtapi_shm_segment_t * that,
+  char const * name,
+  void * address,
+  size_t size) {
+  strncpy(that->name, name, EMBB_MTAPI_SHM_NAME_LENGTH - 1);
+  that->name[EMBB_MTAPI_SHM_NAME_LENGTH - 1] = '\0';
+  that->size = size;
+  that->header = (embb_mtapi_shm_header_t*)address;
+  that->queue = (embb_mtapi_shm_cell_t*)
+    ((char*)address + that->header->queue_offset);
+  that->slots = (char*)address + that->header->slots_offset;
+}
+
+int embb_mtapi_shm_segment_create(
+  embb_mtapi_shm_segment_t * that,
+  char const * name,
+  uint32_t queue_capacity,
+  uint32_t slot_count,
+  uint32_t slot_size) {
+  char path[EMBB_MTAPI_SHM_NAME_LENGTH + 1];
+  embb_mtapi_shm_header_t * header;
+  size_t queue_offset;
+  size_t slots_offset;
+  size_t size;
+  void * address;
+  uint32_t ii;
+  int fd;
+
+  that->header = NULL;
+
+  /* the queue indexes by masking, so its capacity has to be a power of 2 */
+  if (2 > queue_capacity || 0 != (queue_capacity & (queue_capacity - 1)) ||
+    0 == slot_count || 0 == slot_size ||
+    !embb_mtapi_shm_segment_get_path(path, name)) {
+    return 0;
+  }
+
+  slot_size = (uint32_t)embb_mtapi_shm_segment_round_up(slot_size);
+  queue_offset = embb_mtapi_shm_segment_round_up(
+    sizeof(embb_mtapi_shm_header_t));
+  slots_offset = queue_offset + embb_mtapi_shm_segment_round_up(
+    sizeof(embb_mtapi_shm_cell_t) * queue_capacity);
+  size = slots_offset + (size_t)slot_count * slot_size;
+
+  fd = shm_open(path, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+  if (0 > fd) {
+    return 0;
+  }
+  if (0 != ftruncate(fd, (off_t)size)) {
+    close(fd);
+    shm_unlink(path);
+    return 0;
+  }
+  address = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (MAP_FAILED == address) {
+    shm_unlink(path);
+    return 0;
+  }
+
+  header = (embb_mtapi_shm_header_t*)address;
+  header->queue_capacity = queue_capacity;
+  header->slot_count = slot_count;
+  header->slot_size = slot_size;
+  header->queue_offset = queue_offset;
+  header->slots_offset = slots_offset;
+  header->size = size;
+  if (0 != sem_init(&header->signal, 1, 0)) {
+    munmap(address, size);
+    shm_unlink(path);
+    return 0;
+  }
+  embb_atomic_init_unsigned_int(&header->enqueue_position, 0);
+  embb_atomic_init_unsigned_int(&header->dequeue_position, 0);
+
+  embb_mtapi_shm_segment_attach(that, name, address, size);
+  for (ii = 0; ii < queue_capacity; ii++) {
+    embb_atomic_init_unsigned_int(&that->queue[ii].sequence, ii);
+  }
+  that->is_owner = 1;
+
+  /* other processes may open the segment once the magic is visible */
+  embb_atomic_memory_barrier();
+  header->magic = EMBB_MTAPI_SHM_MAGIC;
+
+  return 1;
+}
+
+int embb_mtapi_shm_segment_open(
+  embb_mtapi_shm_segment_t * that,
+  char const * name) {
+  char path[EMBB_MTAPI_SHM_NAME_LENGTH + 1];
+  embb_mtapi_shm_header_t * header;
+  struct stat info;
+  void * address;
+  int fd;
+
+  that->header = NULL;
+
+  if (!embb_mtapi_shm_segment_get_path(path, name)) {
+    return 0;
+  }
+
+  fd = shm_open(path, O_RDWR, 0);
+  if (0 > fd) {
+    return 0;
+  }
+  if (0 != fstat(fd, &info) ||
+    sizeof(embb_mtapi_shm_header_t) > (size_t)info.st_size) {
+    close(fd);
+    return 0;
+  }
+  address = mmap(NULL, (size_t)info.st_size, PROT_READ | PROT_WRITE,
+    MAP_SHARED, fd, 0);
+  close(fd);
+  if (MAP_FAILED == address) {
+    return 0;
+  }
+
+  header = (embb_mtapi_shm_header_t*)address;
+  if (EMBB_MTAPI_SHM_MAGIC != header->magic ||
+    (uint64_t)info.st_size != header->size) {
+    munmap(address, (size_t)info.st_size);
+    return 0;
+  }
+  embb_atomic_memory_barrier();
+
+  embb_mtapi_shm_segment_attach(that, name, address, (size_t)info.st_size);
+  that->is_owner = 0;
+
+  return 1;
+}
+
+void embb_mtapi_shm_segment_close(
+  embb_mtapi_shm_segment_t * that) {
+  if (NULL == that->header) {
+    return;
+  }
+
+  if (that->is_owner) {
+    char path[EMBB_MTAPI_SHM_NAME_LENGTH + 1];
+    uint32_t ii;
+
+    /* processes still holding a mapping keep it valid, but cannot find the
+       segment by name anymore */
+    embb_mtapi_shm_segment_get_path(path, that->name);
+    shm_unlink(path);
+
+    that->header->magic = 0;
+    for (ii = 0; ii < that->header->queue_capacity; ii++) {
+      embb_atomic_destroy_unsigned_int(&that->queue[ii].sequence);
+    }
+    embb_atomic_destroy_unsigned_int(&that->header->dequeue_position);
+    embb_atomic_destroy_unsigned_int(&that->header->enqueue_position);
+    sem_destroy(&that->header->signal);
+  }
+
+  munmap(that->header, that->size);
+  that->header = NULL;
+  that->queue = NULL;
+  that->slots = NULL;
+  that->size = 0;
+}
+
+int embb_mtapi_shm_segment_is_valid(
+  embb_mtapi_shm_segment_t * that) {
+  /* the owner clears the magic when closing the segment */
+  return EMBB_MTAPI_SHM_MAGIC == that->header->magic;
+}
+
+void * embb_mtapi_shm_segment_get_slot(
+  embb_mtapi_shm_segment_t * that,
+  uint32_t slot) {
+  if (slot >= that->header->slot_count) {
+    return NULL;
+  }
+  return that->slots + (size_t)slot * that->header->slot_size;
+}
+
+int embb_mtapi_shm_segment_push(
+  embb_mtapi_shm_segment_t * that,
+  embb_mtapi_shm_message_t const * message) {
+  embb_mtapi_shm_header_t * header = that->header;
+  uint32_t mask = header->queue_capacity - 1;
+  unsigned int position =
+    embb_atomic_load_unsigned_int(&header->enqueue_position);
+  embb_mtapi_shm_cell_t * cell;
+
+  /* bounded multi-producer queue, producers claim a cell by advancing the
+     enqueue position and publish it by advancing the cell's sequence */
+  for (;;) {
+    unsigned int sequence;
+    int difference;
+
+    cell = &that->queue[position & mask];
+    sequence = embb_atomic_load_unsigned_int(&cell->sequence);
+    difference = (int)(sequence - position);
+    if (0 == difference) {
+      if (embb_atomic_compare_and_swap_unsigned_int(
+        &header->enqueue_position, &position, position + 1)) {
+        break;
+      }
+    } else if (0 > difference) {
+      /* the consumer has not yet freed this cell, queue is full */
+      return 0;
+    } else {
+      position = embb_atomic_load_unsigned_int(&header->enqueue_position);
+    }
+  }
+
+  memcpy(&cell->message, message, sizeof(embb_mtapi_shm_message_t));
+  embb_atomic_store_unsigned_int(&cell->sequence, position + 1);
+  sem_post(&header->signal);
+
+  return 1;
+}
+
+int embb_mtapi_shm_segment_pop(
+  embb_mtapi_shm_segment_t * that,
+  embb_mtapi_shm_message_t * message) {
+  embb_mtapi_shm_header_t * header = that->header;
+  /* there is only one consumer, the owner of the segment */
+  unsigned int position =
+    embb_atomic_load_unsigned_int(&header->dequeue_position);
+  embb_mtapi_shm_cell_t * cell =
+    &that->queue[position & (header->queue_capacity - 1)];
+
+  if (embb_atomic_load_unsigned_int(&cell->sequence) != position + 1) {
+    return 0;
+  }
+
+  memcpy(message, &cell->message, sizeof(embb_mtapi_shm_message_t));
+  embb_atomic_store_unsigned_int(&cell->sequence,
+    position + header->queue_capacity);
+  embb_atomic_store_unsigned_int(&header->dequeue_position, position + 1);
+
+  return 1;
+}
+
+int embb_mtapi_shm_segment_wait(
+  embb_mtapi_shm_segment_t * that,
+  int timeout_ms) {
+  struct timespec deadline;
+
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  deadline.tv_sec += timeout_ms / 1000;
+  deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+  if (1000000000L <= deadline.tv_nsec) {
+    deadline.tv_sec++;
+    deadline.tv_nsec -= 1000000000L;
+  }
+
+  while (0 != sem_timedwait(&that->header->signal, &deadline)) {
+    if (EINTR != errno) {
+      return 0;
+    }
+  }
+  return 1;
+}
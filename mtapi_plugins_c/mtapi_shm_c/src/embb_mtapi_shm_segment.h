@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MTAPI_PLUGINS_C_MTAPI_SHM_C_SRC_EMBB_MTAPI_SHM_SEGMENT_H_
+#define MTAPI_PLUGINS_C_MTAPI_SHM_C_SRC_EMBB_MTAPI_SHM_SEGMENT_H_
+
+#include <embb/base/c/atomic.h>
+#include <embb/base/c/internal/config.h>
+
+#include <semaphore.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#define EMBB_MTAPI_SHM_NAME_LENGTH 32
+
+/* a message as it is passed between nodes. arguments and results are not
+   part of the message, they reside in the given slot of the sender's
+   segment. */
+struct embb_mtapi_shm_message_struct {
+  int32_t operation;
+  int32_t domain_id;
+  int32_t job_id;
+  int32_t priority;
+  int32_t task_id;
+  int32_t task_tag;
+  int32_t status;
+  uint32_t slot;
+  uint32_t arguments_size;
+  uint32_t results_size;
+  char sender[EMBB_MTAPI_SHM_NAME_LENGTH];
+};
+
+typedef struct embb_mtapi_shm_message_struct embb_mtapi_shm_message_t;
+
+/* an entry of the message queue, sequence tells producers and the consumer
+   whether the entry is free or holds a message of the current lap */
+struct embb_mtapi_shm_cell_struct {
+  embb_atomic_unsigned_int sequence;
+  embb_mtapi_shm_message_t message;
+};
+
+typedef struct embb_mtapi_shm_cell_struct embb_mtapi_shm_cell_t;
+
+/* lives at the start of every segment, all offsets are relative to it so
+   the segment may be mapped at different addresses by different processes */
+struct embb_mtapi_shm_header_struct {
+  uint32_t magic;
+  uint32_t queue_capacity;
+  uint32_t slot_count;
+  uint32_t slot_size;
+  uint64_t queue_offset;
+  uint64_t slots_offset;
+  uint64_t size;
+  sem_t signal;
+  char padding0[EMBB_PLATFORM_CACHE_LINE_SIZE];
+  embb_atomic_unsigned_int enqueue_position;
+  char padding1[EMBB_PLATFORM_CACHE_LINE_SIZE];
+  embb_atomic_unsigned_int dequeue_position;
+  char padding2[EMBB_PLATFORM_CACHE_LINE_SIZE];
+};
+
+typedef struct embb_mtapi_shm_header_struct embb_mtapi_shm_header_t;
+
+/* process local view of a segment */
+struct embb_mtapi_shm_segment_struct {
+  char name[EMBB_MTAPI_SHM_NAME_LENGTH];
+  int is_owner;
+  size_t size;
+  embb_mtapi_shm_header_t * header;
+  embb_mtapi_shm_cell_t * queue;
+  char * slots;
+};
+
+typedef struct embb_mtapi_shm_segment_struct embb_mtapi_shm_segment_t;
+
+int embb_mtapi_shm_segment_create(
+  embb_mtapi_shm_segment_t * that,
+  char const * name,
+  uint32_t queue_capacity,
+  uint32_t slot_count,
+  uint32_t slot_size
+);
+
+int embb_mtapi_shm_segment_open(
+  embb_mtapi_shm_segment_t * that,
+  char const * name
+);
+
+void embb_mtapi_shm_segment_close(
+  embb_mtapi_shm_segment_t * that
+);
+
+int embb_mtapi_shm_segment_is_valid(
+  embb_mtapi_shm_segment_t * that
+);
+
+void * embb_mtapi_shm_segment_get_slot(
+  embb_mtapi_shm_segment_t * that,
+  uint32_t slot
+);
+
+int embb_mtapi_shm_segment_push(
+  embb_mtapi_shm_segment_t * that,
+  embb_mtapi_shm_message_t const * message
+);
+
+int embb_mtapi_shm_segment_pop(
+  embb_mtapi_shm_segment_t * that,
+  embb_mtapi_shm_message_t * message
+);
+
+int embb_mtapi_shm_segment_wait(
+  embb_mtapi_shm_segment_t * that,
+  int timeout_ms
+);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MTAPI_PLUGINS_C_MTAPI_SHM_C_SRC_EMBB_MTAPI_SHM_SEGMENT_H_
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2014-2017, Siemens AG. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice,
+ * this list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ * this list of conditions and the following disclaimer in the documentation
+ * and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <embb_mtapi_shm_test_segment.h>
+
+#include <embb_mtapi_shm_segment.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+
+ShmSegmentTest::ShmSegmentTest() {
+  CreateUnit("mtapi shm segment test").Add(
+    &ShmSegmentTest::TestBasic, this);
+}
+
+void ShmSegmentTest::TestBasic() {
+  embb_mtapi_shm_segment_t owner;
+  embb_mtapi_shm_segment_t user;
+  embb_mtapi_shm_message_t message;
+  char name[EMBB_MTAPI_SHM_NAME_LENGTH];
+  int err;
+
+  snprintf(name, sizeof(name), "embb_shm_test_%d", static_cast<int>(getpid()));
+
+  // capacity has to be a power of 2
+  err = embb_mtapi_shm_segment_create(&owner, name, 3, 2, 100);
+  PT_EXPECT(err == 0);
+  // names must not contain slashes
+  err = embb_mtapi_shm_segment_create(&owner, "embb/shm", 4, 2, 100);
+  PT_EXPECT(err == 0);
+
+  err = embb_mtapi_shm_segment_create(&owner, name, 4, 2, 100);
+  PT_ASSERT(err == 1);
+  // the name is taken now
+  err = embb_mtapi_shm_segment_create(&user, name, 4, 2, 100);
+  PT_EXPECT(err == 0);
+
+  err = embb_mtapi_shm_segment_open(&user, name);
+  PT_ASSERT(err == 1);
+  PT_EXPECT(embb_mtapi_shm_segment_is_valid(&user) == 1);
+
+  // slots are shared and at least as big as requested
+  PT_EXPECT(owner.header->slot_size >= 100);
+  PT_EXPECT(embb_mtapi_shm_segment_get_slot(&user, 2) == NULL);
+  memcpy(embb_mtapi_shm_segment_get_slot(&user, 1), "shared", 7);
+  PT_EXPECT(strcmp(static_cast<char*>(
+    embb_mtapi_shm_segment_get_slot(&owner, 1)), "shared") == 0);
+
+  // fill the queue through the second mapping, wrapping around twice
+  memset(&message, 0, sizeof(message));
+  for (int lap = 0; lap < 3; lap++) {
+    for (int ii = 0; ii < 4; ii++) {
+      message.task_id = lap * 4 + ii;
+      err = embb_mtapi_shm_segment_push(&user, &message);
+      PT_EXPECT(err == 1);
+    }
+    err = embb_mtapi_shm_segment_push(&user, &message);
+    PT_EXPECT(err == 0);
+
+    for (int ii = 0; ii < 4; ii++) {
+      err = embb_mtapi_shm_segment_wait(&owner, 0);
+      PT_EXPECT(err == 1);
+      err = embb_mtapi_shm_segment_pop(&owner, &message);
+      PT_EXPECT(err == 1);
+      PT_EXPECT(message.task_id == lap * 4 + ii);
+    }
+    err = embb_mtapi_shm_segment_pop(&owner, &message);
+    PT_EXPECT(err == 0);
+    err = embb_mtapi_shm_segment_wait(&owner, 1);
+    PT_EXPECT(err == 0);
+  }
+
+  embb_mtapi_shm_segment_close(&owner);
+  // the mapping stays, but the segment is gone
+  PT_EXPECT(embb_mtapi_shm_segment_is_valid(&user) == 0);
+  embb_mtapi_shm_segment_close(&user);
+
+  err = embb_mtapi_shm_segment_open(&user, name);
+  PT_EXPECT(err == 0);
+}